@@ -0,0 +1,619 @@
+#include "app/flight_system.h"
+
+#if SKYGUARD_HAS_APRS
+#include "aprs/aprs_format.h"
+#endif
+
+namespace skyguard::app {
+
+namespace {
+
+using diag::LatencyPath;
+using diag::LatencyStage;
+using records::CutAck;
+using records::CutCommand;
+using records::PerfConfig;
+using records::PerfCounters;
+using records::SelfTestReport;
+using records::StateSnapshot;
+
+constexpr uint32_t kFreefallMg2 = 300u * 300u;
+constexpr uint8_t kFreefallSamples = 5;
+
+constexpr uint32_t kTickBudgetUs = 2000;
+
+uint16_t record_size(uint8_t type) {
+  switch (type) {
+    case PerfCounters::kId:
+      return PerfCounters::kEncodedSize;
+    case SelfTestReport::kId:
+      return SelfTestReport::kEncodedSize;
+    case CutAck::kId:
+      return CutAck::kEncodedSize;
+    default:
+      return StateSnapshot::kEncodedSize;
+  }
+}
+
+uint8_t record_version(uint8_t type) {
+  switch (type) {
+    case PerfCounters::kId:
+      return PerfCounters::kVersion;
+    case SelfTestReport::kId:
+      return SelfTestReport::kVersion;
+    case CutAck::kId:
+      return CutAck::kVersion;
+    default:
+      return StateSnapshot::kVersion;
+  }
+}
+
+static_assert(PerfCounters::kEncodedSize <= kTelemetryBlockSize &&
+                  SelfTestReport::kEncodedSize <= kTelemetryBlockSize &&
+                  CutAck::kEncodedSize <= kTelemetryBlockSize &&
+                  StateSnapshot::kEncodedSize <= kTelemetryBlockSize,
+              "records fit a telemetry block");
+
+template <class T>
+T since_frame(uint32_t t_us, uint32_t rx_us) {
+  uint32_t d = t_us - rx_us;
+  return d > static_cast<T>(~T{0}) ? static_cast<T>(~T{0}) : static_cast<T>(d);
+}
+
+int32_t read_le32(const uint8_t* p) {
+  return static_cast<int32_t>(static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 |
+                              static_cast<uint32_t>(p[2]) << 16 |
+                              static_cast<uint32_t>(p[3]) << 24);
+}
+
+}  // namespace
+
+FlightSystem::FlightSystem(const FlightPorts& ports)
+    : ports_(ports),
+      router_({router_send, nullptr, router_dropped, router_retired, this}),
+      burn_(ports_.burn, ports_.burn_timing),
+      cut_path_(ports_.cut, burn_, ports_.clock_us)
+#if SKYGUARD_HAS_APRS
+      ,
+      afsk_streamer_(afsk_, ports_.afsk, afsk_dma_, kAprsDmaHalf)
+#endif
+{
+  for (int8_t& i : link_index_) i = -1;
+  for (Pending& p : pending_) p.block = -1;
+#if SKYGUARD_HAS_LORA
+  add_link(LinkKind::kLora, {"lora", 0, 800, 4000});
+#endif
+#if SKYGUARD_HAS_APRS
+  afsk_.init(ports_.afsk_sample_rate, ports_.afsk_out_max);
+  add_link(LinkKind::kAprs, {"aprs", 0, 1000, 0});
+#endif
+#if SKYGUARD_HAS_IRIDIUM
+  add_link(LinkKind::kIridium, {"iridium", 150000, 20000, 60000});
+#endif
+  vault_enabled_ = ports_.vault.program && vault_.begin(ports_.vault);
+  if (vault_enabled_) {
+    if (ports_.vault_budget) vault_.set_payload_budget(ports_.vault_budget);
+    recover_checkpoint();
+    save_checkpoint();
+  }
+}
+
+void FlightSystem::recover_checkpoint() {
+  // The checkpoint is the first entry of a record whose budget allowed it.
+  uint8_t head[storage::kVaultEntryHeader];
+  uint8_t cp[StateSnapshot::kEncodedSize];
+  if (!vault_.read_record(0, head, sizeof(head))) return;
+  uint16_t len = static_cast<uint16_t>(head[2] | head[3] << 8);
+  if (head[0] != StateSnapshot::kId || len == 0 || len > sizeof(cp) ||
+      len != StateSnapshot::encoded_size(head[1]) ||
+      !vault_.read_record(storage::kVaultEntryHeader, cp, len)) {
+    return;
+  }
+  state_.lat_e7 = read_le32(cp + StateSnapshot::kOffset_lat_e7);
+  state_.lon_e7 = read_le32(cp + StateSnapshot::kOffset_lon_e7);
+  state_.alt_mm = read_le32(cp + StateSnapshot::kOffset_alt_mm);
+  state_.state = cp[StateSnapshot::kOffset_state];
+  state_.flags = kFlagGpsStale;
+  recovered_ = true;
+}
+
+void FlightSystem::save_checkpoint() {
+  uint8_t next = checkpoint_index_.load() ^ 1;
+  state_.encode(checkpoint_[next], sizeof(checkpoint_[next]));
+  checkpoint_index_.store(next);
+}
+
+bool FlightSystem::on_supply_warning() {
+  return vault_enabled_ && vault_.on_brownout({vault_collect, this});
+}
+
+size_t FlightSystem::vault_collect(void* ctx, storage::VaultSpan* spans, size_t max,
+                                   uint32_t budget) {
+  auto* self = static_cast<FlightSystem*>(ctx);
+  size_t n = 0;
+  uint32_t used = 0;
+  if (max > 0 && storage::kVaultEntryHeader + StateSnapshot::kEncodedSize <= budget) {
+    spans[n++] = {StateSnapshot::kId, StateSnapshot::kVersion,
+                  self->checkpoint_[self->checkpoint_index_.load()],
+                  static_cast<uint16_t>(StateSnapshot::kEncodedSize)};
+    used = storage::kVaultEntryHeader + StateSnapshot::kEncodedSize;
+  }
+  const storage::VaultSource& log = self->ports_.vault_log;
+  if (log.collect && n < max) n += log.collect(log.ctx, spans + n, max - n, budget - used);
+  return n;
+}
+
+#if SKYGUARD_HAS_ADSB
+void FlightSystem::on_adsb_bytes(const uint8_t* data, size_t n, uint32_t now_ms) {
+  traffic::AdsbReport r;
+  for (size_t i = 0; i < n; ++i) {
+    if (adsb_parser_.push(data[i], &r)) traffic_.update(r, now_ms);
+  }
+}
+
+bool FlightSystem::airspace_clear(uint32_t now_ms, uint32_t* nearest_m) const {
+  if (nearest_m) *nearest_m = traffic::kNoTraffic;
+  if ((state_.flags & kFlagGpsStale) || !state_.fix) return false;
+  traffic::AirspaceQuery q{state_.lat_e7, state_.lon_e7, kTrafficClearRadiusM, INT32_MIN,
+                           state_.alt_mm / 1000 + kTrafficClearAboveM};
+  return traffic_.clear(q, now_ms, nearest_m);
+}
+#endif
+
+void FlightSystem::add_link(LinkKind kind, const telemetry::LinkConfig& cfg) {
+  link_index_[static_cast<size_t>(kind)] = static_cast<int8_t>(router_.add_link(cfg));
+}
+
+void FlightSystem::on_gps_fix(uint8_t receiver, const GpsFix& fix) {
+  if (receiver >= SKYGUARD_GPS_COUNT) return;
+  gps_[receiver] = fix;
+  gps_parse_us_[receiver] = now_us();
+  gps_valid_[receiver] = fix.fix >= 2;
+}
+
+#if SKYGUARD_HAS_IMU
+void FlightSystem::on_imu_sample(const ImuSample& s) {
+  uint32_t mag2 = 0;
+  for (int16_t a : s.accel_mg) mag2 += static_cast<uint32_t>(a * a);
+  if (mag2 < kFreefallMg2) {
+    if (freefall_run_ < kFreefallSamples) ++freefall_run_;
+  } else {
+    freefall_run_ = 0;
+  }
+  if (freefall_run_ >= kFreefallSamples) {
+    state_.flags |= kFlagFreefall;
+  } else {
+    state_.flags &= static_cast<uint16_t>(~kFlagFreefall);
+  }
+}
+#endif
+
+void FlightSystem::update_position(uint32_t now_ms) {
+  int best = -1;
+  for (int i = 0; i < SKYGUARD_GPS_COUNT; ++i) {
+    if (!gps_valid_[i] || now_ms - gps_[i].time_ms > kGpsStaleMs) continue;
+    if (best < 0 || gps_[i].fix > gps_[best].fix ||
+        (gps_[i].fix == gps_[best].fix && gps_[i].sats > gps_[best].sats)) {
+      best = i;
+    }
+  }
+  state_.time_ms = now_ms;
+  if (best < 0) {
+    state_.flags |= kFlagGpsStale;
+    state_.fix = 0;
+    return;
+  }
+  const GpsFix& f = gps_[best];
+  state_.flags &= static_cast<uint16_t>(~kFlagGpsStale);
+  fix_time_ms_ = f.time_ms;
+  fix_valid_us_ = f.valid_us;
+  fix_frame_us_ = f.frame_us;
+  fix_parse_us_ = gps_parse_us_[best];
+  state_.lat_e7 = f.lat_e7;
+  state_.lon_e7 = f.lon_e7;
+  state_.alt_mm = f.alt_mm;
+  for (int k = 0; k < 3; ++k) state_.vel_cm_s[k] = f.vel_cm_s[k];
+  state_.fix = f.fix;
+  state_.sats = f.sats;
+}
+
+FlightSystem::Pending* FlightSystem::find_pending(uint16_t msg_id) {
+  for (Pending& p : pending_) {
+    if (p.block >= 0 && p.id == msg_id) return &p;
+  }
+  return nullptr;
+}
+
+void FlightSystem::release_pending(uint16_t msg_id) {
+  if (Pending* p = find_pending(msg_id)) {
+    pool_.release(p->block);
+    p->block = -1;
+  }
+}
+
+FlightSystem::Pending* FlightSystem::claim_pending(uint8_t type) {
+  for (Pending& p : pending_) {
+    if (p.block >= 0) continue;
+    int block = pool_.acquire();
+    if (block < 0) return nullptr;
+    p.id = next_msg_id_++;
+    p.type = type;
+    p.block = static_cast<int8_t>(block);
+    return &p;
+  }
+  return nullptr;
+}
+
+bool FlightSystem::submit_pending(Pending* p, uint32_t deadline_ms, uint8_t link_mask,
+                                  uint32_t now_ms, telemetry::Urgency urgency) {
+  if (router_.submit(p->id, urgency, deadline_ms, now_ms, link_mask)) {
+    return true;
+  }
+  pool_.release(p->block);
+  p->block = -1;
+  return false;
+}
+
+void FlightSystem::note_termination_event(uint32_t now_ms) {
+  track_event_until_ms_ = now_ms + kTrackEventHoldMs;
+  track_flush_ = true;
+}
+
+void FlightSystem::enqueue_track(const telemetry::TrackPoint& p, uint32_t now_ms) {
+  if (track_count_ == kTrackQueue) {
+    // Oldest first out: the ground interpolates across the gap.
+    track_head_ = static_cast<uint8_t>((track_head_ + 1) % kTrackQueue);
+    --track_count_;
+    ++track_overflows_;
+  }
+  track_queue_[(track_head_ + track_count_) % kTrackQueue] = p;
+  ++track_count_;
+  last_track_ms_ = now_ms;
+}
+
+void FlightSystem::update_track(uint32_t now_ms) {
+  if (state_.flags & kFlagFreefall) track_event_until_ms_ = now_ms + kTrackEventHoldMs;
+  telemetry::TrackPoint p;
+  if (state_.fix == 0) {
+    // Lost the fix: report where the held stretch ended.
+    if (track_.holding() && track_.flush(&p)) enqueue_track(p, now_ms);
+    return;
+  }
+  if (!track_fed_ || fix_time_ms_ != track_fix_ms_) {
+    track_fed_ = true;
+    track_fix_ms_ = fix_time_ms_;
+    track_fix_kind_ = state_.fix;
+    bool event = static_cast<int32_t>(track_event_until_ms_ - now_ms) > 0;
+    telemetry::TrackTolerance tol = telemetry::track_tolerance(track_schedule_, fence_margin_m_,
+                                                               event);
+    if (track_.push({fix_time_ms_, state_.lat_e7, state_.lon_e7, state_.alt_mm}, tol, &p)) {
+      enqueue_track(p, now_ms);
+    }
+  }
+  if ((track_flush_ || now_ms - last_track_ms_ >= kTrackHeartbeatMs) && track_.flush(&p)) {
+    enqueue_track(p, now_ms);
+  }
+  track_flush_ = false;
+}
+
+void FlightSystem::queue_telemetry(uint32_t now_ms) {
+  while (track_count_ > 0) {
+    Pending* p = claim_pending(StateSnapshot::kId);
+    if (!p) return;  // earlier reports still in flight; try next tick
+    // The reported point's time and position; the rest is current.
+    const telemetry::TrackPoint& t = track_queue_[track_head_];
+    StateSnapshot rec = state_;
+    rec.time_ms = t.time_ms;
+    rec.lat_e7 = t.lat_e7;
+    rec.lon_e7 = t.lon_e7;
+    rec.alt_mm = t.alt_mm;
+    if (rec.fix == 0) rec.fix = track_fix_kind_;  // flushed as the GPS went stale
+    rec.encode(pool_.data(p->block), pool_.block_size());
+    // APRS carries no time, so the ground could not place the point.
+    if (!submit_pending(p, 2 * kTelemetryPeriodMs, non_aprs_mask(), now_ms)) return;
+    track_head_ = static_cast<uint8_t>((track_head_ + 1) % kTrackQueue);
+    --track_count_;
+  }
+#if SKYGUARD_HAS_APRS
+  if (state_.fix == 0 || (aprs_beaconed_ && now_ms - last_aprs_ms_ < kTelemetryPeriodMs)) return;
+  Pending* p = claim_pending(StateSnapshot::kId);
+  if (!p) return;
+  state_.encode(pool_.data(p->block), pool_.block_size());
+  uint8_t aprs_mask = static_cast<uint8_t>(1u << link_index_[static_cast<size_t>(LinkKind::kAprs)]);
+  if (!submit_pending(p, kTelemetryPeriodMs, aprs_mask, now_ms)) return;
+  last_aprs_ms_ = now_ms;
+  aprs_beaconed_ = true;
+#endif
+}
+
+void FlightSystem::queue_perf(uint32_t now_ms) {
+  uint32_t period_ms = static_cast<uint32_t>(perf_period_s_) * 1000;
+  if (period_ms == 0 || now_ms - last_perf_ms_ < period_ms) return;
+  Pending* p = claim_pending(PerfCounters::kId);
+  if (!p) return;
+  PerfCounters rec;
+  perf_.snapshot(now_ms, pool_, &rec);
+  rec.encode(pool_.data(p->block), pool_.block_size());
+  last_perf_ms_ = now_ms;
+  submit_pending(p, period_ms, non_aprs_mask(), now_ms);
+}
+
+void FlightSystem::trace_fix() {
+  // One boundary trace per fix, from its arrival; a cut's trace stays open
+  // until the burn outcome.
+  bool burn_open = latency_.active(LatencyPath::kBoundary) &&
+                   latency_.last_stage(LatencyPath::kBoundary) ==
+                       static_cast<int>(LatencyStage::kActuatorEnable);
+  if (!ports_.clock_us || state_.fix == 0 || burn_open ||
+      (traced_fix_ && fix_time_ms_ == traced_fix_ms_)) {
+    return;
+  }
+  traced_fix_ = true;
+  traced_fix_ms_ = fix_time_ms_;
+  // From the fix's validity through its sentence and decode. A stamp the
+  // driver did not supply skips its stage rather than marking it at zero.
+  uint32_t start = fix_valid_us_ ? fix_valid_us_ : fix_frame_us_ ? fix_frame_us_ : fix_parse_us_;
+  latency_.begin(LatencyPath::kBoundary, start);
+  if (fix_frame_us_) {
+    if (fix_valid_us_) latency_.mark(LatencyPath::kBoundary, LatencyStage::kSample, fix_frame_us_);
+    latency_.mark(LatencyPath::kBoundary, LatencyStage::kParse, fix_parse_us_);
+  }
+  latency_.mark(LatencyPath::kBoundary, LatencyStage::kFuse, fuse_us_);
+}
+
+void FlightSystem::rule_inputs(uint32_t now_ms, termination::RuleInputs* in) const {
+  in->time_ms = now_ms;
+  in->cut_command = remote_cut_;
+  in->fence_margin_m = fence_margin_m_;
+  in->alt_m = state_.alt_mm / 1000;
+  in->fix_age_ms = now_ms - fix_time_ms_;
+  in->freefall = state_.flags & kFlagFreefall;
+#if SKYGUARD_HAS_ADSB
+  in->airspace_clear = airspace_clear(now_ms, &in->traffic_m);
+#else
+  in->airspace_clear = false;
+  in->traffic_m = UINT32_MAX;
+#endif
+}
+
+void FlightSystem::on_rules(uint32_t evaluated_us, bool cut) {
+  uint32_t decide_us = now_us();
+  if (cut && !burn_.fired() && ports_.clock_us && !latency_.active(LatencyPath::kBoundary)) {
+    // Decided by time (a hold expiring, a timeout) on an already traced
+    // fix: the trace starts from this tick's state.
+    latency_.begin(LatencyPath::kBoundary, fuse_us_);
+  }
+  latency_.mark(LatencyPath::kBoundary, LatencyStage::kRule, evaluated_us);
+  latency_.mark(LatencyPath::kBoundary, LatencyStage::kDecide, decide_us);
+  // The burn channel is on once fire() returns.
+  if (cut && burn_.fire(decide_us)) {
+    latency_.mark(LatencyPath::kBoundary, LatencyStage::kActuatorEnable, now_us());
+  } else if (latency_.active(LatencyPath::kBoundary)) {
+    latency_.end_without_action(LatencyPath::kBoundary);
+  }
+}
+
+void FlightSystem::trace_burn() {
+  for (size_t i = 0; i < static_cast<size_t>(LatencyPath::kCount); ++i) {
+    LatencyPath p = static_cast<LatencyPath>(i);
+    if (!latency_.active(p) ||
+        latency_.last_stage(p) != static_cast<int>(LatencyStage::kActuatorEnable)) {
+      continue;
+    }
+    if (burn_.current_seen()) {
+      latency_.mark(p, LatencyStage::kCurrentDetected, burn_.current_us());
+    } else if (burn_.state() != termination::BurnState::kBurning) {
+      latency_.end_without_action(p);
+    }
+  }
+}
+
+void FlightSystem::poll_cut(uint32_t now_ms) {
+  termination::CutEvent e;
+  while (cut_path_.take(&e)) {
+    if (ports_.cut_log.write) ports_.cut_log.write(ports_.cut_log.ctx, e, cut_path_.last_counter());
+    if (e.result == termination::CutResult::kAccepted && ports_.clock_us) {
+      // Stamped in the receive interrupt; traced here, in task context.
+      latency_.begin(LatencyPath::kCommand, e.rx_us);
+      latency_.mark(LatencyPath::kCommand, LatencyStage::kParse, e.auth_us);
+      latency_.mark(LatencyPath::kCommand, LatencyStage::kActuatorEnable, e.gate_us);
+    }
+    if (e.result == termination::CutResult::kAccepted ||
+        e.result == termination::CutResult::kAlreadyFired) {
+      if (!remote_cut_) note_termination_event(now_ms);
+      remote_cut_ = true;
+    }
+    if (cut_ack_count_ == termination::kCutEventQueue) continue;  // ground retries
+    cut_acks_[cut_ack_count_] = e;
+    cut_ack_since_ms_[cut_ack_count_] = now_ms;
+    ++cut_ack_count_;
+  }
+  uint8_t kept = 0;
+  for (uint8_t i = 0; i < cut_ack_count_; ++i) {
+    // The command that fired waits for current, or for the sequencer to
+    // give up, so its ACK carries the outcome.
+    bool outcome_open = cut_acks_[i].result == termination::CutResult::kAccepted &&
+                        burn_.state() == termination::BurnState::kBurning &&
+                        !burn_.current_seen() &&
+                        now_ms - cut_ack_since_ms_[i] < kCutAckHoldMs;
+    if (outcome_open || !send_cut_ack(cut_acks_[i], now_ms)) {
+      cut_acks_[kept] = cut_acks_[i];
+      cut_ack_since_ms_[kept] = cut_ack_since_ms_[i];
+      ++kept;
+    }
+  }
+  cut_ack_count_ = kept;
+}
+
+bool FlightSystem::send_cut_ack(const termination::CutEvent& e, uint32_t now_ms) {
+  Pending* p = claim_pending(CutAck::kId);
+  if (!p) return false;
+  CutAck rec{};
+  rec.time_ms = now_ms;
+  rec.counter = e.counter;
+  rec.result = static_cast<uint8_t>(e.result);
+  rec.burn_state = static_cast<uint8_t>(burn_.state());
+  rec.auth_us = since_frame<uint16_t>(e.auth_us, e.rx_us);
+  if (e.result == termination::CutResult::kAccepted) {
+    rec.gate_us = since_frame<uint16_t>(burn_.fire_us(), e.rx_us);
+    if (burn_.current_seen()) rec.current_us = since_frame<uint32_t>(burn_.current_us(), e.rx_us);
+  }
+  rec.encode(pool_.data(p->block), pool_.block_size());
+  return submit_pending(p, 2 * kTelemetryPeriodMs, non_aprs_mask(), now_ms,
+                        telemetry::Urgency::kTermination);
+}
+
+uint8_t FlightSystem::non_aprs_mask() const {
+  uint8_t mask = 0xFF;
+  int8_t aprs = link_index_[static_cast<size_t>(LinkKind::kAprs)];
+  if (aprs >= 0) mask = static_cast<uint8_t>(mask & ~(1u << aprs));
+  return mask;
+}
+
+bool FlightSystem::send_self_test(const SelfTestReport& report, uint32_t now_ms) {
+  Pending* p = claim_pending(SelfTestReport::kId);
+  if (!p) return false;
+  report.encode(pool_.data(p->block), pool_.block_size());
+  return submit_pending(p, 2 * kTelemetryPeriodMs, non_aprs_mask(), now_ms);
+}
+
+void FlightSystem::on_uplink(uint8_t type, const uint8_t* payload, size_t len,
+                             uint32_t rx_us) {
+  if (type == CutCommand::kId) {
+    cut_path_.on_frame(payload, len, rx_us);
+    return;
+  }
+  if (type != PerfConfig::kId) return;
+  if (len < PerfConfig::kOffset_period_s + 2u) return;
+  const uint8_t* v = payload + PerfConfig::kOffset_period_s;
+  perf_period_s_ = static_cast<uint16_t>(v[0] | v[1] << 8);
+}
+
+bool FlightSystem::router_send(void* ctx, uint8_t link, uint16_t msg_id) {
+  auto* self = static_cast<FlightSystem*>(ctx);
+  Pending* p = self->find_pending(msg_id);
+  if (!p) return false;
+#if SKYGUARD_HAS_APRS
+  if (link == self->link_index_[static_cast<size_t>(LinkKind::kAprs)]) {
+    return self->send_aprs(*p);
+  }
+#endif
+  return self->send_frame(link, *p);
+}
+
+void FlightSystem::router_retired(void* ctx, uint16_t msg_id) {
+  // Not on delivery: a CutAck is still going out on the other links.
+  static_cast<FlightSystem*>(ctx)->release_pending(msg_id);
+}
+
+void FlightSystem::router_dropped(void* ctx, uint16_t msg_id) {
+  static_cast<FlightSystem*>(ctx)->release_pending(msg_id);
+}
+
+bool FlightSystem::send_frame(uint8_t link, const Pending& p) {
+  const telemetry::SgTxPort* port = nullptr;
+#if SKYGUARD_HAS_LORA
+  if (link == link_index_[static_cast<size_t>(LinkKind::kLora)]) port = &ports_.lora;
+#endif
+#if SKYGUARD_HAS_IRIDIUM
+  if (link == link_index_[static_cast<size_t>(LinkKind::kIridium)]) port = &ports_.iridium;
+#endif
+  if (!port) return false;
+  telemetry::SgFrame& f = frames_[link];
+  f.begin(p.type, record_version(p.type), p.id);
+  f.add_pooled(pool_, p.block, record_size(p.type));
+  f.finish();
+  if (!port->submit(port->ctx, f)) {
+    f.release();
+    return false;
+  }
+  in_flight_[link] = p.id;
+  return true;
+}
+
+void FlightSystem::on_link_tx_done(LinkKind kind, bool ok, uint32_t now_ms) {
+  int8_t link = link_index_[static_cast<size_t>(kind)];
+  if (link < 0) return;
+  frames_[link].release();
+  if (!ok) perf_.radio_retry();
+  router_.on_tx_done(static_cast<uint8_t>(link), in_flight_[link], ok, now_ms);
+}
+
+void FlightSystem::on_link_ack(LinkKind kind, uint16_t msg_id, uint32_t now_ms) {
+  int8_t link = link_index_[static_cast<size_t>(kind)];
+  if (link >= 0) router_.on_ack(static_cast<uint8_t>(link), msg_id, now_ms);
+}
+
+#if SKYGUARD_HAS_APRS
+bool FlightSystem::send_aprs(const Pending& p) {
+  if (p.type != StateSnapshot::kId || afsk_streamer_.busy()) return false;
+  const uint8_t* rec = pool_.data(p.block);
+  aprs::AprsPosition pos{};
+  pos.lat_e7 = read_le32(rec + StateSnapshot::kOffset_lat_e7);
+  pos.lon_e7 = read_le32(rec + StateSnapshot::kOffset_lon_e7);
+  pos.altitude_m = read_le32(rec + StateSnapshot::kOffset_alt_mm) / 1000;
+  char info[64];
+  size_t info_len = aprs::aprs_format_position(pos, info, sizeof(info));
+
+  static const aprs::Ax25Address kDest{"APZSKY", 0};
+  static const aprs::Ax25Address kPath[] = {{"WIDE2", 1}};
+  uint8_t frame[aprs::kAx25MaxFrameLen];
+  size_t frame_len = aprs::ax25_build_ui_frame(kDest, ports_.aprs_source, kPath, 1,
+                                               reinterpret_cast<const uint8_t*>(info),
+                                               info_len, frame, sizeof(frame));
+  size_t n = frame_len ? aprs::ax25_encode_hdlc(frame, frame_len, kAprsPreambleFlags,
+                                                kAprsTailFlags, aprs_symbols_,
+                                                sizeof(aprs_symbols_) * 8)
+                       : 0;
+  if (n == 0 || !afsk_streamer_.transmit(aprs_symbols_, n)) return false;
+  in_flight_[link_index_[static_cast<size_t>(LinkKind::kAprs)]] = p.id;
+  aprs_was_busy_ = true;
+  return true;
+}
+
+void FlightSystem::poll_aprs(uint32_t now_ms) {
+  if (!aprs_was_busy_ || afsk_streamer_.busy()) return;
+  aprs_was_busy_ = false;
+  uint8_t link = static_cast<uint8_t>(link_index_[static_cast<size_t>(LinkKind::kAprs)]);
+  router_.on_tx_done(link, in_flight_[link], true, now_ms);
+}
+#endif
+
+void FlightSystem::tick(uint32_t now_ms) {
+  uint32_t t0 = now_us();
+  update_position(now_ms);
+  fuse_us_ = now_us();
+  trace_fix();
+#if SKYGUARD_HAS_ADSB
+  if (state_.fix) {
+    if (!traffic_reference_set_) {
+      traffic_.set_reference(state_.lat_e7);
+      traffic_reference_set_ = true;
+    }
+    traffic_.set_focus(state_.lat_e7, state_.lon_e7);
+  }
+  if (now_ms - last_traffic_expire_ms_ >= kTrafficExpirePeriodMs) {
+    traffic_.expire(now_ms);
+    last_traffic_expire_ms_ = now_ms;
+  }
+#endif
+  poll_cut(now_ms);  // ahead of the reports, for the first free block
+  trace_burn();
+  update_track(now_ms);
+  queue_telemetry(now_ms);
+  queue_perf(now_ms);
+#if SKYGUARD_HAS_APRS
+  poll_aprs(now_ms);
+#endif
+  router_.tick(now_ms);
+  perf_.queue_depth(diag::PerfQueue::kRouter, static_cast<uint32_t>(router_.queued()));
+  if (vault_enabled_) {
+    vault_.service();  // one blank check or sector erase towards re-arming
+    save_checkpoint();
+  }
+  if (ports_.clock_us) {
+    perf_.task_run(diag::PerfTask::kTick, ports_.clock_us() - t0, kTickBudgetUs);
+  }
+}
+
+}  // namespace skyguard::app
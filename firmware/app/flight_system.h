@@ -0,0 +1,344 @@
+// Composition root for the flight firmware: owns the subsystems present in
+// the build profile and services them from one periodic tick.
+//
+// Subsystems absent from the profile are compiled out of this class, so
+// their state, buffers and per-tick work disappear with them. Platform code
+// supplies the radio/DMA ports, forwards driver events and calls tick().
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+#include "config/build_profile.h"
+#include "diag/latency_trace.h"
+#include "diag/perf_counters.h"
+#include "generated/records.h"
+#include "storage/brownout_vault.h"
+#include "telemetry/buffer_pool.h"
+#include "telemetry/link_router.h"
+#include "telemetry/sg_frame.h"
+#include "telemetry/track_compressor.h"
+#include "termination/burn_sequencer.h"
+#include "termination/cut_fast_path.h"
+#include "termination/termination_engine.h"
+
+#if SKYGUARD_HAS_APRS
+#include "aprs/afsk.h"
+#include "aprs/ax25.h"
+#endif
+
+#if SKYGUARD_HAS_ADSB
+#include "traffic/sbs_parser.h"
+#include "traffic/track_table.h"
+#endif
+
+namespace skyguard::app {
+
+constexpr uint32_t kTelemetryPeriodMs = 60000;  // APRS beacon; report deadlines
+constexpr uint16_t kPerfPeriodS = 600;  // default; PerfConfig changes it in flight
+constexpr uint32_t kGpsStaleMs = 3000;
+constexpr uint8_t kTelemetryBlocks = 4;
+constexpr uint16_t kTelemetryBlockSize = 64;
+// Positions go out when the track bends past tolerance (TrackCompressor),
+// and at least this often while there is a fix.
+constexpr uint32_t kTrackHeartbeatMs = 300000;
+// Reports stay tight for this long after freefall or a termination event.
+constexpr uint32_t kTrackEventHoldMs = 120000;
+constexpr uint8_t kTrackQueue = 8;  // reported points waiting for a block
+// A CutAck waits this long for the burn outcome (current, or failover to
+// channel B and its timeout) before going out with what is known.
+constexpr uint32_t kCutAckHoldMs = 200;
+
+#if SKYGUARD_HAS_ADSB
+// "Clear airspace": no traffic within this radius, from the ground up to
+// this far above the balloon (a cut payload falls through everything
+// below it).
+constexpr uint32_t kTrafficClearRadiusM = 5000;
+constexpr int32_t kTrafficClearAboveM = 1000;
+constexpr uint32_t kTrafficExpirePeriodMs = 1000;
+#endif
+
+#if SKYGUARD_HAS_APRS
+constexpr size_t kAprsDmaHalf = 128;
+constexpr uint16_t kAprsPreambleFlags = 32;
+constexpr uint16_t kAprsTailFlags = 4;
+#endif
+
+/// State snapshot flag bits.
+constexpr uint16_t kFlagFreefall = 1u << 0;
+constexpr uint16_t kFlagGpsStale = 1u << 1;
+
+enum class LinkKind : uint8_t { kLora, kIridium, kAprs, kCount };
+
+struct GpsFix {
+  uint32_t time_ms;  // local time the fix was received
+  int32_t lat_e7;
+  int32_t lon_e7;
+  int32_t alt_mm;
+  int16_t vel_cm_s[3];  // north, east, down
+  uint8_t fix;          // 0 none, 2 2D, 3 3D
+  uint8_t sats;
+  /// clock_us at the fix's time of validity (the receiver's PPS edge) and
+  /// at the end of its last sentence, as the driver stamped them; 0 if
+  /// unknown. They start the boundary latency trace.
+  uint32_t valid_us;
+  uint32_t frame_us;
+};
+
+#if SKYGUARD_HAS_IMU
+struct ImuSample {
+  uint32_t time_ms;
+  int16_t accel_mg[3];
+};
+#endif
+
+struct FlightPorts {
+  /// Optional free-running microsecond clock; times tick() for PerfCounters,
+  /// the remote cut path for CutAck and the stages behind latency().
+  uint32_t (*clock_us)();
+  /// Burn gates and the arm input. A remote cut drives the gates from the
+  /// receive interrupt, so burn.gate must be interrupt-safe.
+  termination::BurnPort burn;
+  termination::BurnTiming burn_timing;
+  /// Unit id, key and the last accepted counter from config flash.
+  termination::CutConfig cut;
+  /// Optional (write null): logs cut events and persists the counter.
+  termination::CutEventSink cut_log;
+  /// Optional (write null): internal flash slots for the brown-out vault
+  /// (storage::vault_flash_of() over board::ConfigFlash), and the payload
+  /// cap whose flush fits the holdup time (BrownoutVault::budget_for_us();
+  /// 0: the whole slot).
+  storage::VaultFlash vault;
+  uint32_t vault_budget;
+  /// Optional (write null): the platform's staged log, saved after the
+  /// checkpoint on a supply warning.
+  storage::VaultSource vault_log;
+#if SKYGUARD_HAS_LORA
+  telemetry::SgTxPort lora;
+#endif
+#if SKYGUARD_HAS_IRIDIUM
+  telemetry::SgTxPort iridium;
+#endif
+#if SKYGUARD_HAS_APRS
+  aprs::AfskDmaPort afsk;
+  uint32_t afsk_sample_rate;
+  uint16_t afsk_out_max;
+  aprs::Ax25Address aprs_source;
+#endif
+};
+
+class FlightSystem {
+ public:
+  explicit FlightSystem(const FlightPorts& ports);
+  FlightSystem(const FlightSystem&) = delete;
+  FlightSystem& operator=(const FlightSystem&) = delete;
+
+  /// A decoded fix; the call time is its parse stamp in latency().
+  void on_gps_fix(uint8_t receiver, const GpsFix& fix);
+#if SKYGUARD_HAS_IMU
+  void on_imu_sample(const ImuSample& s);
+#endif
+#if SKYGUARD_HAS_ADSB
+  /// Bytes drained from the ADS-B receiver's UART (SBS-1 text).
+  void on_adsb_bytes(const uint8_t* data, size_t n, uint32_t now_ms);
+  /// Rule input: no current track within kTrafficClearRadiusM, up to
+  /// kTrafficClearAboveM above the current position. False while the GPS
+  /// is stale. `nearest_m` as for traffic::TrackTable::clear().
+  bool airspace_clear(uint32_t now_ms, uint32_t* nearest_m = nullptr) const;
+  const traffic::TrackTable& traffic() const { return traffic_; }
+#endif
+  /// Radio driver events for the SgTxPort links (LoRa, Iridium).
+  void on_link_tx_done(LinkKind link, bool ok, uint32_t now_ms);
+  void on_link_ack(LinkKind link, uint16_t msg_id, uint32_t now_ms);
+  /// A decoded uplink record (`type` is its schema id). Unknown types are
+  /// ignored. A CutCommand arriving here (a link decoded in task context)
+  /// takes the same path as one from a receive interrupt; `rx_us` is the
+  /// end of its frame on clock_us, as the driver stamped it, so the CutAck
+  /// latencies do not include the wait for this call.
+  void on_uplink(uint8_t type, const uint8_t* payload, size_t len, uint32_t rx_us);
+  /// For the radio and modem receive interrupts: a CutCommand frame that
+  /// passed its CRC goes straight to cut_path().on_frame().
+  termination::CutFastPath& cut_path() { return cut_path_; }
+  /// A burn current sample, from one context (the current ADC's
+  /// conversion interrupt or a task polling it, ideally every millisecond).
+  void on_burn_current(uint32_t t_us, uint16_t current_ma) { burn_.service(t_us, current_ma); }
+  /// The burn actuator. A cut decided by the rule engine goes through
+  /// on_rules(), which calls fire().
+  termination::BurnSequencer& burn() { return burn_; }
+  /// The rule engine's verdict after tick(): `evaluated_us` is the clock
+  /// when evaluate() returned. A cut fires the burn sequencer; every call
+  /// closes the boundary trace of the fix it judged.
+  void on_rules(uint32_t evaluated_us, bool cut);
+  /// Rule input: an authenticated cut command has been received.
+  bool remote_cut() const { return remote_cut_; }
+  /// Fills the rule inputs this class owns, after tick(): time, remote cut,
+  /// fence margin, altitude, fix age, freefall, and with ADS-B the airspace
+  /// (airspace_clear() around the current position). The platform sets
+  /// armed, flight time, link silence and battery.
+  void rule_inputs(uint32_t now_ms, termination::RuleInputs* in) const;
+  /// Queues a finished diag::SelfTest run for LoRa/Iridium. Returns false
+  /// if no telemetry block is free.
+  bool send_self_test(const records::SelfTestReport& report, uint32_t now_ms);
+
+  /// Margin from geofence::FenceSet::margin_m() (negative outside); position
+  /// reports tighten as it shrinks. Without a fence, reports stay at cruise
+  /// tolerance. termination::kFenceMarginUnknown (margin_m() was NaN) keeps
+  /// them tight.
+  void set_fence_margin(int32_t margin_m) { fence_margin_m_ = margin_m; }
+  /// A termination condition or the decision changed: the next tick
+  /// reports the current position, and reports stay tight for
+  /// kTrackEventHoldMs.
+  void note_termination_event(uint32_t now_ms);
+
+#if SKYGUARD_HAS_APRS
+  /// For the DMA half/full-transfer interrupt handlers.
+  aprs::AfskDmaStreamer& afsk_streamer() { return afsk_streamer_; }
+#endif
+
+  void tick(uint32_t now_ms);
+
+  /// For the supply monitor's warning interrupt (hal::SupplyMonitor): saves
+  /// the StateSnapshot of the last tick, then vault_log's spans, to the
+  /// vault. Returns true if a record was committed.
+  bool on_supply_warning();
+  /// After a boot, the vault's record holds what the last warning saved;
+  /// the platform re-stages its log entries from it.
+  const storage::BrownoutVault& vault() const { return vault_; }
+  /// The vault's checkpoint was restored at boot: state() starts at the last
+  /// saved position, flagged GPS stale until a fix arrives.
+  bool recovered() const { return recovered_; }
+
+  const records::StateSnapshot& state() const { return state_; }
+  const telemetry::LinkRouter& router() const { return router_; }
+  const telemetry::BufferPool& pool() const { return pool_; }
+  /// Drivers report ISR latency, queue depths, flash timing and energy here.
+  diag::PerfMonitor& perf() { return perf_; }
+  /// Termination-path stage latencies, stamped with clock_us: a boundary
+  /// trace per fix (arrival, fused, rules, decision, gate, current) and a
+  /// command trace per accepted remote cut (frame end, authenticated, gate,
+  /// current). Empty without a clock.
+  const diag::LatencyTracer& latency() const { return latency_; }
+  uint16_t perf_period_s() const { return perf_period_s_; }
+  const telemetry::TrackCompressor& track() const { return track_; }
+  /// Reported points dropped because kTrackQueue was full.
+  uint32_t track_overflows() const { return track_overflows_; }
+
+ private:
+  struct Pending {
+    uint16_t id;
+    uint8_t type;  // schema record id of the block contents
+    int8_t block;  // -1: slot free
+  };
+
+  static bool router_send(void* ctx, uint8_t link, uint16_t msg_id);
+  static void router_dropped(void* ctx, uint16_t msg_id);
+  static void router_retired(void* ctx, uint16_t msg_id);
+  static size_t vault_collect(void* ctx, storage::VaultSpan* spans, size_t max,
+                              uint32_t budget);
+
+  void add_link(LinkKind kind, const telemetry::LinkConfig& cfg);
+  Pending* find_pending(uint16_t msg_id);
+  Pending* claim_pending(uint8_t type);
+  bool submit_pending(Pending* p, uint32_t deadline_ms, uint8_t link_mask, uint32_t now_ms,
+                      telemetry::Urgency urgency = telemetry::Urgency::kRoutine);
+  void release_pending(uint16_t msg_id);
+  void update_position(uint32_t now_ms);
+  void update_track(uint32_t now_ms);
+  void enqueue_track(const telemetry::TrackPoint& p, uint32_t now_ms);
+  void queue_telemetry(uint32_t now_ms);
+  void queue_perf(uint32_t now_ms);
+  void poll_cut(uint32_t now_ms);
+  void trace_fix();
+  void trace_burn();
+  void recover_checkpoint();
+  void save_checkpoint();
+  uint32_t now_us() const { return ports_.clock_us ? ports_.clock_us() : 0; }
+  bool send_cut_ack(const termination::CutEvent& e, uint32_t now_ms);
+  /// Links other than APRS, which carries positions only.
+  uint8_t non_aprs_mask() const;
+  bool send_frame(uint8_t link, const Pending& p);
+#if SKYGUARD_HAS_APRS
+  bool send_aprs(const Pending& p);
+  void poll_aprs(uint32_t now_ms);
+#endif
+
+  FlightPorts ports_;
+  telemetry::LinkRouter router_;
+  telemetry::StaticBufferPool<kTelemetryBlockSize, kTelemetryBlocks> pool_;
+  telemetry::SgFrame frames_[telemetry::kMaxLinks];
+  uint16_t in_flight_[telemetry::kMaxLinks] = {};
+  int8_t link_index_[static_cast<size_t>(LinkKind::kCount)];
+  Pending pending_[kTelemetryBlocks];
+  uint16_t next_msg_id_ = 1;
+  telemetry::TrackCompressor track_;
+  telemetry::TrackToleranceSchedule track_schedule_;
+  telemetry::TrackPoint track_queue_[kTrackQueue] = {};
+  uint8_t track_head_ = 0;
+  uint8_t track_count_ = 0;
+  uint32_t track_overflows_ = 0;
+  uint32_t last_track_ms_ = 0;  // last report queued
+  uint32_t track_fix_ms_ = 0;   // last fix fed to track_
+  uint8_t track_fix_kind_ = 0;  // and its fix type
+  bool track_fed_ = false;
+  uint32_t track_event_until_ms_ = 0;
+  bool track_flush_ = false;
+  int32_t fence_margin_m_ = INT32_MAX;
+  diag::PerfMonitor perf_;
+  uint16_t perf_period_s_ = kPerfPeriodS;
+  uint32_t last_perf_ms_ = 0;
+  diag::LatencyTracer latency_;
+  uint32_t fuse_us_ = 0;       // clock when this tick's state was fused
+  uint32_t traced_fix_ms_ = 0;  // fix_time_ms_ of the last boundary trace
+  bool traced_fix_ = false;
+  termination::BurnSequencer burn_;
+  termination::CutFastPath cut_path_;
+  // Acknowledgements waiting for the burn outcome or a telemetry block.
+  termination::CutEvent cut_acks_[termination::kCutEventQueue] = {};
+  uint32_t cut_ack_since_ms_[termination::kCutEventQueue] = {};
+  uint8_t cut_ack_count_ = 0;
+  bool remote_cut_ = false;
+  storage::BrownoutVault vault_;
+  bool vault_enabled_ = false;  // ports.vault given and valid
+  // StateSnapshots encoded after each tick; the warning interrupt saves the
+  // one last completed.
+  uint8_t checkpoint_[2][records::StateSnapshot::kEncodedSize] = {};
+  std::atomic<uint8_t> checkpoint_index_{0};
+  bool recovered_ = false;
+
+  GpsFix gps_[SKYGUARD_GPS_COUNT] = {};
+  uint32_t gps_parse_us_[SKYGUARD_GPS_COUNT] = {};  // on_gps_fix() on clock_us
+  bool gps_valid_[SKYGUARD_GPS_COUNT] = {};
+  records::StateSnapshot state_ = {};
+  uint32_t fix_time_ms_ = 0;  // receive time of the fix in state_
+  uint32_t fix_valid_us_ = 0;  // and its clock_us stamps
+  uint32_t fix_frame_us_ = 0;
+  uint32_t fix_parse_us_ = 0;
+
+#if SKYGUARD_HAS_IMU
+  uint8_t freefall_run_ = 0;
+#endif
+
+#if SKYGUARD_HAS_ADSB
+  traffic::SbsParser adsb_parser_;
+  traffic::TrackTable traffic_;
+  bool traffic_reference_set_ = false;
+  uint32_t last_traffic_expire_ms_ = 0;
+#endif
+
+#if SKYGUARD_HAS_APRS
+  aprs::AfskModulator afsk_;
+  uint16_t afsk_dma_[2 * kAprsDmaHalf] = {};
+  aprs::AfskDmaStreamer afsk_streamer_;
+  uint8_t aprs_symbols_[(aprs::ax25_hdlc_max_symbols(
+                             aprs::kAx25MaxFrameLen, kAprsPreambleFlags + kAprsTailFlags) +
+                         7) /
+                        8] = {};
+  bool aprs_was_busy_ = false;
+  uint32_t last_aprs_ms_ = 0;  // position beacon
+  bool aprs_beaconed_ = false;
+#endif
+};
+
+}  // namespace skyguard::app
@@ -0,0 +1,118 @@
+#include "aprs/afsk.h"
+
+#include "config/build_profile.h"
+
+#if SKYGUARD_HAS_APRS
+
+namespace skyguard::aprs {
+
+namespace {
+
+struct SineTable {
+  int16_t v[kAfskTableSize];
+};
+
+// Taylor series is plenty for 16-bit output once reduced to [-pi, pi].
+constexpr double const_sin(double x) {
+  constexpr double kPi = 3.14159265358979323846;
+  while (x > kPi) x -= 2 * kPi;
+  while (x < -kPi) x += 2 * kPi;
+  double term = x;
+  double sum = x;
+  for (int n = 1; n < 12; ++n) {
+    term *= -x * x / ((2 * n) * (2 * n + 1));
+    sum += term;
+  }
+  return sum;
+}
+
+constexpr SineTable make_sine_table() {
+  constexpr double kPi = 3.14159265358979323846;
+  SineTable t{};
+  for (size_t i = 0; i < kAfskTableSize; ++i) {
+    double s = const_sin(2 * kPi * static_cast<double>(i) / kAfskTableSize);
+    double scaled = s * 32767.0;
+    t.v[i] = static_cast<int16_t>(scaled < 0 ? scaled - 0.5 : scaled + 0.5);
+  }
+  return t;
+}
+
+constexpr SineTable kSine = make_sine_table();
+
+uint32_t phase_increment(uint32_t freq, uint32_t sample_rate) {
+  return static_cast<uint32_t>((static_cast<uint64_t>(freq) << 32) / sample_rate);
+}
+
+}  // namespace
+
+void AfskModulator::init(uint32_t sample_rate, uint16_t out_max) {
+  sample_rate_ = sample_rate;
+  inc_mark_ = phase_increment(kAfskMarkHz, sample_rate);
+  inc_space_ = phase_increment(kAfskSpaceHz, sample_rate);
+  idle_ = static_cast<uint16_t>(out_max / 2);
+  int32_t half = out_max / 2;
+  for (size_t i = 0; i < kAfskTableSize; ++i) {
+    table_[i] = static_cast<uint16_t>(idle_ + (kSine.v[i] * half) / 32768);
+  }
+  symbols_ = nullptr;
+  n_symbols_ = 0;
+  symbol_ = 0;
+}
+
+void AfskModulator::start(const uint8_t* symbols, size_t n_symbols) {
+  symbols_ = symbols;
+  n_symbols_ = n_symbols;
+  symbol_ = 0;
+  phase_ = 0;
+  bit_clock_ = 0;
+  if (n_symbols_ > 0) inc_ = (symbols_[0] & 1) ? inc_mark_ : inc_space_;
+}
+
+size_t AfskModulator::fill(uint16_t* dst, size_t n) {
+  size_t i = 0;
+  while (i < n && symbol_ < n_symbols_) {
+    dst[i++] = table_[phase_ >> 24];
+    phase_ += inc_;
+    bit_clock_ += kAfskBaud;
+    if (bit_clock_ >= sample_rate_) {
+      bit_clock_ -= sample_rate_;
+      if (++symbol_ < n_symbols_) {
+        // Phase is continuous across symbols; only the increment changes.
+        inc_ = (symbols_[symbol_ >> 3] >> (symbol_ & 7)) & 1 ? inc_mark_
+                                                              : inc_space_;
+      }
+    }
+  }
+  size_t modulated = i;
+  while (i < n) dst[i++] = idle_;
+  return modulated;
+}
+
+bool AfskDmaStreamer::transmit(const uint8_t* symbols, size_t n_symbols) {
+  if (busy_) return false;
+  mod_.start(symbols, n_symbols);
+  mod_.fill(buf_, half_len_);
+  mod_.fill(buf_ + half_len_, half_len_);
+  drain_halves_ = 0;
+  busy_ = true;
+  port_.start_circular(port_.ctx, buf_, 2 * half_len_);
+  return true;
+}
+
+void AfskDmaStreamer::refill(int half) {
+  if (!busy_) return;
+  if (mod_.done()) {
+    // The two halves still queued may hold the tail of the packet; stop
+    // once both have played out as idle.
+    if (++drain_halves_ >= 2) {
+      port_.stop(port_.ctx);
+      busy_ = false;
+      return;
+    }
+  }
+  mod_.fill(buf_ + half * half_len_, half_len_);
+}
+
+}  // namespace skyguard::aprs
+
+#endif  // SKYGUARD_HAS_APRS
@@ -0,0 +1,88 @@
+// Bell 202 (1200 baud, 1200/2200 Hz) AFSK sample generation.
+//
+// The modulator is a phase accumulator over a 256-entry sine table scaled
+// once at init to the output peripheral's range, so producing a sample is an
+// add, a shift and a load. AfskDmaStreamer drives a circular DMA buffer from
+// its half/full-transfer interrupts; the CPU only wakes to refill half a
+// buffer at a time while a packet is on air.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace skyguard::aprs {
+
+constexpr uint32_t kAfskBaud = 1200;
+constexpr uint32_t kAfskMarkHz = 1200;
+constexpr uint32_t kAfskSpaceHz = 2200;
+constexpr size_t kAfskTableSize = 256;
+
+class AfskModulator {
+ public:
+  /// `sample_rate` in Hz; samples swing between 0 and `out_max` (e.g. 4095
+  /// for a 12-bit DAC or the PWM period). Output is mid-scale when idle.
+  void init(uint32_t sample_rate, uint16_t out_max);
+
+  /// Starts sending `n_symbols` packed tone symbols (see ax25_encode_hdlc).
+  /// `symbols` must stay valid until done() returns true.
+  void start(const uint8_t* symbols, size_t n_symbols);
+
+  /// Writes up to `n` samples; pads with mid-scale after the last symbol.
+  /// Returns the number of samples that carried modulation.
+  size_t fill(uint16_t* dst, size_t n);
+
+  bool done() const { return symbol_ >= n_symbols_; }
+  uint16_t idle_level() const { return idle_; }
+  uint32_t sample_rate() const { return sample_rate_; }
+
+ private:
+  uint16_t table_[kAfskTableSize] = {};
+  uint32_t sample_rate_ = 0;
+  uint32_t inc_mark_ = 0;
+  uint32_t inc_space_ = 0;
+  uint16_t idle_ = 0;
+
+  const uint8_t* symbols_ = nullptr;
+  size_t n_symbols_ = 0;
+  size_t symbol_ = 0;
+  uint32_t phase_ = 0;
+  uint32_t bit_clock_ = 0;  // advances by kAfskBaud per sample
+  uint32_t inc_ = 0;
+};
+
+/// Platform hooks for a circular, half-transfer-interrupting DMA channel
+/// feeding a DAC or PWM compare register.
+struct AfskDmaPort {
+  void (*start_circular)(void* ctx, const uint16_t* buf, size_t n_samples);
+  void (*stop)(void* ctx);
+  void* ctx;
+};
+
+class AfskDmaStreamer {
+ public:
+  /// `buf` holds two halves of `half_len` samples each.
+  AfskDmaStreamer(AfskModulator& mod, const AfskDmaPort& port, uint16_t* buf,
+                  size_t half_len)
+      : mod_(mod), port_(port), buf_(buf), half_len_(half_len) {}
+
+  /// Primes both halves and starts the DMA. Returns false if already busy.
+  bool transmit(const uint8_t* symbols, size_t n_symbols);
+
+  /// Call from the DMA half-transfer and transfer-complete interrupts.
+  void on_half_transfer() { refill(0); }
+  void on_transfer_complete() { refill(1); }
+
+  bool busy() const { return busy_; }
+
+ private:
+  void refill(int half);
+
+  AfskModulator& mod_;
+  AfskDmaPort port_;
+  uint16_t* buf_;
+  size_t half_len_;
+  volatile bool busy_ = false;
+  uint8_t drain_halves_ = 0;
+};
+
+}  // namespace skyguard::aprs
@@ -0,0 +1,120 @@
+#include "aprs/aprs_format.h"
+
+#include "config/build_profile.h"
+
+#if SKYGUARD_HAS_APRS
+
+namespace skyguard::aprs {
+
+namespace {
+
+class Out {
+ public:
+  Out(char* buf, size_t cap) : buf_(buf), cap_(cap) {}
+
+  void put(char c) {
+    if (n_ + 1 < cap_) {
+      buf_[n_] = c;
+    } else {
+      overflow_ = true;
+    }
+    ++n_;
+  }
+
+  void put_str(const char* s) {
+    while (*s) put(*s++);
+  }
+
+  // Zero-padded unsigned decimal of exactly `width` digits.
+  void put_uint(uint32_t v, int width) {
+    char tmp[10];
+    for (int i = width - 1; i >= 0; --i) {
+      tmp[i] = static_cast<char>('0' + v % 10);
+      v /= 10;
+    }
+    for (int i = 0; i < width; ++i) put(tmp[i]);
+  }
+
+  size_t finish() {
+    if (overflow_ || cap_ == 0) return 0;
+    buf_[n_] = '\0';
+    return n_;
+  }
+
+ private:
+  char* buf_;
+  size_t cap_;
+  size_t n_ = 0;
+  bool overflow_ = false;
+};
+
+// Writes DDMM.mm or DDDMM.mm for an absolute coordinate in 1e-7 degrees.
+void put_ddmm(Out& o, uint32_t abs_e7, int deg_width) {
+  uint32_t deg = abs_e7 / 10000000u;
+  // Hundredths of a minute: fraction * 60 * 100, rounded.
+  uint64_t frac = abs_e7 % 10000000u;
+  uint32_t hmin = static_cast<uint32_t>((frac * 6000u + 5000000u) / 10000000u);
+  if (hmin >= 6000) {
+    hmin -= 6000;
+    ++deg;
+  }
+  o.put_uint(deg, deg_width);
+  o.put_uint(hmin / 100, 2);
+  o.put('.');
+  o.put_uint(hmin % 100, 2);
+}
+
+uint32_t abs_u32(int32_t v) {
+  return v < 0 ? 0u - static_cast<uint32_t>(v) : static_cast<uint32_t>(v);
+}
+
+}  // namespace
+
+size_t aprs_format_position(const AprsPosition& pos, char* out, size_t cap) {
+  Out o(out, cap);
+  if (pos.has_time) {
+    o.put('/');
+    o.put_uint(pos.hour, 2);
+    o.put_uint(pos.minute, 2);
+    o.put_uint(pos.second, 2);
+    o.put('h');
+  } else {
+    o.put('!');
+  }
+  put_ddmm(o, abs_u32(pos.lat_e7), 2);
+  o.put(pos.lat_e7 < 0 ? 'S' : 'N');
+  o.put(kBalloonSymbolTable);
+  put_ddmm(o, abs_u32(pos.lon_e7), 3);
+  o.put(pos.lon_e7 < 0 ? 'W' : 'E');
+  o.put(kBalloonSymbol);
+
+  // /A= is in feet, six digits, negative values are clamped to zero.
+  int64_t feet = pos.altitude_m > 0
+                     ? (static_cast<int64_t>(pos.altitude_m) * 10000 + 1524) / 3048
+                     : 0;
+  if (feet > 999999) feet = 999999;
+  o.put_str("/A=");
+  o.put_uint(static_cast<uint32_t>(feet), 6);
+  if (pos.comment && *pos.comment) {
+    o.put(' ');
+    o.put_str(pos.comment);
+  }
+  return o.finish();
+}
+
+size_t aprs_format_telemetry(const AprsTelemetry& t, char* out, size_t cap) {
+  Out o(out, cap);
+  o.put_str("T#");
+  o.put_uint(t.sequence % 1000, 3);
+  for (uint8_t a : t.analog) {
+    o.put(',');
+    o.put_uint(a, 3);
+  }
+  o.put(',');
+  for (int b = 7; b >= 0; --b) o.put((t.digital >> b) & 1 ? '1' : '0');
+  return o.finish();
+}
+
+}  // namespace skyguard::aprs
+
+#endif  // SKYGUARD_HAS_APRS
@@ -0,0 +1,37 @@
+// APRS information-field formatting for position and telemetry beacons.
+//
+// Output is plain ASCII written into a caller buffer, suitable as the info
+// field of ax25_build_ui_frame(). Formatting uses integer arithmetic only.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace skyguard::aprs {
+
+constexpr char kBalloonSymbolTable = '/';
+constexpr char kBalloonSymbol = 'O';
+
+struct AprsPosition {
+  int32_t lat_e7;         // degrees * 1e7, north positive
+  int32_t lon_e7;         // degrees * 1e7, east positive
+  int32_t altitude_m;     // metres above MSL
+  bool has_time;          // emit a /HHMMSSh timestamp
+  uint8_t hour, minute, second;  // UTC
+  const char* comment;    // optional, may be nullptr
+};
+
+struct AprsTelemetry {
+  uint16_t sequence;  // 0..999
+  uint8_t analog[5];
+  uint8_t digital;    // bit 7 is sent first
+};
+
+/// Formats an uncompressed position report with altitude extension.
+/// Returns the length written (without NUL), or 0 if `cap` is too small.
+size_t aprs_format_position(const AprsPosition& pos, char* out, size_t cap);
+
+/// Formats a "T#" telemetry report. Returns the length or 0 on overflow.
+size_t aprs_format_telemetry(const AprsTelemetry& t, char* out, size_t cap);
+
+}  // namespace skyguard::aprs
@@ -0,0 +1,127 @@
+#include "aprs/ax25.h"
+
+#include <string.h>
+
+#include "config/build_profile.h"
+#include "util/crc16.h"
+
+#if SKYGUARD_HAS_APRS
+
+namespace skyguard::aprs {
+
+namespace {
+
+constexpr uint8_t kHdlcFlag = 0x7E;
+
+bool encode_address(const Ax25Address& a, bool last, uint8_t* out) {
+  size_t n = strlen(a.callsign);
+  if (n == 0 || n > kAx25CallsignLen || a.ssid > 15) return false;
+  for (size_t i = 0; i < kAx25CallsignLen; ++i) {
+    char c = i < n ? a.callsign[i] : ' ';
+    out[i] = static_cast<uint8_t>(c << 1);
+  }
+  out[6] = static_cast<uint8_t>(0x60 | (a.ssid << 1) | (last ? 1 : 0));
+  return true;
+}
+
+class SymbolWriter {
+ public:
+  SymbolWriter(uint8_t* out, size_t cap) : out_(out), cap_(cap) {}
+
+  bool put_bit(bool bit) {
+    // NRZI: a 0 toggles the tone, a 1 keeps it.
+    if (!bit) tone_ = !tone_;
+    if (n_ >= cap_) return false;
+    uint8_t mask = static_cast<uint8_t>(1u << (n_ & 7));
+    if (tone_) {
+      out_[n_ >> 3] |= mask;
+    } else {
+      out_[n_ >> 3] &= static_cast<uint8_t>(~mask);
+    }
+    ++n_;
+    return true;
+  }
+
+  bool put_flag() {
+    for (int b = 0; b < 8; ++b) {
+      if (!put_bit((kHdlcFlag >> b) & 1)) return false;
+    }
+    ones_ = 0;
+    return true;
+  }
+
+  bool put_data_byte(uint8_t byte) {
+    for (int b = 0; b < 8; ++b) {
+      bool bit = (byte >> b) & 1;
+      if (!put_bit(bit)) return false;
+      if (bit) {
+        if (++ones_ == 5) {
+          if (!put_bit(false)) return false;
+          ones_ = 0;
+        }
+      } else {
+        ones_ = 0;
+      }
+    }
+    return true;
+  }
+
+  size_t count() const { return n_; }
+
+ private:
+  uint8_t* out_;
+  size_t cap_;
+  size_t n_ = 0;
+  uint8_t ones_ = 0;
+  bool tone_ = true;  // idle on mark
+};
+
+}  // namespace
+
+size_t ax25_build_ui_frame(const Ax25Address& dest, const Ax25Address& src,
+                           const Ax25Address* digis, size_t n_digis,
+                           const uint8_t* info, size_t info_len, uint8_t* out,
+                           size_t out_cap) {
+  if (n_digis > kAx25MaxDigipeaters || info_len > kAx25MaxInfoLen) return 0;
+  size_t len = 7 * (2 + n_digis) + 2 + info_len + 2;
+  if (len > out_cap) return 0;
+
+  uint8_t* p = out;
+  if (!encode_address(dest, false, p)) return 0;
+  p += 7;
+  if (!encode_address(src, n_digis == 0, p)) return 0;
+  p += 7;
+  for (size_t i = 0; i < n_digis; ++i) {
+    if (!encode_address(digis[i], i + 1 == n_digis, p)) return 0;
+    p += 7;
+  }
+  *p++ = 0x03;  // UI
+  *p++ = 0xF0;  // no layer 3
+  if (info_len > 0) memcpy(p, info, info_len);
+  p += info_len;
+
+  uint16_t fcs = crc16_x25(out, static_cast<size_t>(p - out));
+  *p++ = static_cast<uint8_t>(fcs & 0xFF);
+  *p++ = static_cast<uint8_t>(fcs >> 8);
+  return len;
+}
+
+size_t ax25_encode_hdlc(const uint8_t* frame, size_t frame_len,
+                        uint16_t preamble_flags, uint16_t tail_flags,
+                        uint8_t* symbols, size_t symbol_cap) {
+  SymbolWriter w(symbols, symbol_cap);
+  for (uint16_t i = 0; i < preamble_flags; ++i) {
+    if (!w.put_flag()) return 0;
+  }
+  for (size_t i = 0; i < frame_len; ++i) {
+    if (!w.put_data_byte(frame[i])) return 0;
+  }
+  for (uint16_t i = 0; i < tail_flags; ++i) {
+    if (!w.put_flag()) return 0;
+  }
+  return w.count();
+}
+
+}  // namespace skyguard::aprs
+
+#endif  // SKYGUARD_HAS_APRS
@@ -0,0 +1,48 @@
+// AX.25 UI frame construction and HDLC line encoding for APRS beacons.
+//
+// Frames are built into caller-owned buffers; nothing here allocates. The
+// HDLC encoder turns a finished frame into a packed stream of tone symbols
+// (flags, bit stuffing and NRZI already applied) so the AFSK modulator only
+// has to map symbols to samples while the DMA is running.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace skyguard::aprs {
+
+constexpr size_t kAx25CallsignLen = 6;
+constexpr size_t kAx25MaxDigipeaters = 2;
+constexpr size_t kAx25MaxInfoLen = 256;
+// dest + src + digis (7 bytes each), control, PID, info, FCS.
+constexpr size_t kAx25MaxFrameLen =
+    7 * (2 + kAx25MaxDigipeaters) + 2 + kAx25MaxInfoLen + 2;
+
+struct Ax25Address {
+  char callsign[kAx25CallsignLen + 1];  // NUL-terminated, upper case
+  uint8_t ssid;                         // 0..15
+};
+
+/// Builds a UI frame (control 0x03, PID 0xF0) including the CRC-16/X.25 FCS.
+/// Returns the frame length, or 0 if an argument is invalid or `out_cap`
+/// is too small.
+size_t ax25_build_ui_frame(const Ax25Address& dest, const Ax25Address& src,
+                           const Ax25Address* digis, size_t n_digis,
+                           const uint8_t* info, size_t info_len, uint8_t* out,
+                           size_t out_cap);
+
+/// Worst-case number of tone symbols produced by ax25_encode_hdlc().
+constexpr size_t ax25_hdlc_max_symbols(size_t frame_len, size_t flags) {
+  // One stuffed bit per five data bits, rounded up.
+  return flags * 8 + frame_len * 8 + (frame_len * 8 + 4) / 5;
+}
+
+/// HDLC-encodes `frame` as `preamble_flags` opening flags, the bit-stuffed
+/// frame LSB first, and `tail_flags` closing flags, then applies NRZI.
+/// Symbols are packed LSB first into `symbols`; a 1 is mark (1200 Hz) and a
+/// 0 is space (2200 Hz). Returns the number of symbols, or 0 on overflow.
+size_t ax25_encode_hdlc(const uint8_t* frame, size_t frame_len,
+                        uint16_t preamble_flags, uint16_t tail_flags,
+                        uint8_t* symbols, size_t symbol_cap);
+
+}  // namespace skyguard::aprs
@@ -0,0 +1,54 @@
+// Compile-time subsystem selection.
+//
+// Define one SKYGUARD_PROFILE_<NAME> (see config/profiles/) or point
+// SKYGUARD_PROFILE_HEADER at a custom profile; the default is "full". Code
+// for an absent subsystem is removed with #if on the SKYGUARD_HAS_* macros
+// so its drivers, buffers, tasks and rule inputs cost no flash or RAM.
+// The same values are available as constexpr in skyguard::profile for use
+// in ordinary expressions.
+#pragma once
+
+#include <stddef.h>
+
+#if defined(SKYGUARD_PROFILE_HEADER)
+#include SKYGUARD_PROFILE_HEADER
+#elif defined(SKYGUARD_PROFILE_LORA_ONLY)
+#include "config/profiles/lora_only.h"
+#elif defined(SKYGUARD_PROFILE_IRIDIUM_ONLY)
+#include "config/profiles/iridium_only.h"
+#elif defined(SKYGUARD_PROFILE_DUAL_GPS)
+#include "config/profiles/dual_gps.h"
+#elif defined(SKYGUARD_PROFILE_NO_IMU)
+#include "config/profiles/no_imu.h"
+#else
+#include "config/profiles/full.h"
+#endif
+
+#if !defined(SKYGUARD_HAS_LORA) || !defined(SKYGUARD_HAS_IRIDIUM) ||   \
+    !defined(SKYGUARD_HAS_APRS) || !defined(SKYGUARD_GPS_COUNT) || \
+    !defined(SKYGUARD_HAS_IMU) || !defined(SKYGUARD_HAS_ADSB)
+#error "Build profile must define every SKYGUARD_HAS_* option and SKYGUARD_GPS_COUNT"
+#endif
+
+#define SKYGUARD_RADIO_LINK_COUNT \
+  (SKYGUARD_HAS_LORA + SKYGUARD_HAS_IRIDIUM + SKYGUARD_HAS_APRS)
+
+#if SKYGUARD_RADIO_LINK_COUNT == 0
+#error "A flight termination unit needs at least one radio link"
+#endif
+#if SKYGUARD_GPS_COUNT < 1 || SKYGUARD_GPS_COUNT > 2
+#error "SKYGUARD_GPS_COUNT must be 1 or 2"
+#endif
+
+namespace skyguard::profile {
+
+constexpr const char* kName = SKYGUARD_PROFILE_NAME;
+constexpr bool kHasLora = SKYGUARD_HAS_LORA;
+constexpr bool kHasIridium = SKYGUARD_HAS_IRIDIUM;
+constexpr bool kHasAprs = SKYGUARD_HAS_APRS;
+constexpr bool kHasImu = SKYGUARD_HAS_IMU;
+constexpr bool kHasAdsb = SKYGUARD_HAS_ADSB;
+constexpr size_t kGpsCount = SKYGUARD_GPS_COUNT;
+constexpr size_t kRadioLinkCount = SKYGUARD_RADIO_LINK_COUNT;
+
+}  // namespace skyguard::profile
@@ -0,0 +1,10 @@
+// Iridium and LoRa with redundant GPS receivers, IMU.
+#pragma once
+
+#define SKYGUARD_PROFILE_NAME "dual_gps"
+#define SKYGUARD_HAS_LORA 1
+#define SKYGUARD_HAS_IRIDIUM 1
+#define SKYGUARD_HAS_APRS 0
+#define SKYGUARD_GPS_COUNT 2
+#define SKYGUARD_HAS_IMU 1
+#define SKYGUARD_HAS_ADSB 0
@@ -0,0 +1,10 @@
+// Every subsystem: LoRa, Iridium and APRS, one GPS, IMU, ADS-B receiver.
+#pragma once
+
+#define SKYGUARD_PROFILE_NAME "full"
+#define SKYGUARD_HAS_LORA 1
+#define SKYGUARD_HAS_IRIDIUM 1
+#define SKYGUARD_HAS_APRS 1
+#define SKYGUARD_GPS_COUNT 1
+#define SKYGUARD_HAS_IMU 1
+#define SKYGUARD_HAS_ADSB 1
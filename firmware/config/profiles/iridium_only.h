@@ -0,0 +1,10 @@
+// Iridium SBD only, one GPS, IMU.
+#pragma once
+
+#define SKYGUARD_PROFILE_NAME "iridium_only"
+#define SKYGUARD_HAS_LORA 0
+#define SKYGUARD_HAS_IRIDIUM 1
+#define SKYGUARD_HAS_APRS 0
+#define SKYGUARD_GPS_COUNT 1
+#define SKYGUARD_HAS_IMU 1
+#define SKYGUARD_HAS_ADSB 0
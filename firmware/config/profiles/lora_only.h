@@ -0,0 +1,10 @@
+// LoRa downlink only, one GPS, no IMU.
+#pragma once
+
+#define SKYGUARD_PROFILE_NAME "lora_only"
+#define SKYGUARD_HAS_LORA 1
+#define SKYGUARD_HAS_IRIDIUM 0
+#define SKYGUARD_HAS_APRS 0
+#define SKYGUARD_GPS_COUNT 1
+#define SKYGUARD_HAS_IMU 0
+#define SKYGUARD_HAS_ADSB 0
@@ -0,0 +1,10 @@
+// All radios, one GPS, no IMU.
+#pragma once
+
+#define SKYGUARD_PROFILE_NAME "no_imu"
+#define SKYGUARD_HAS_LORA 1
+#define SKYGUARD_HAS_IRIDIUM 1
+#define SKYGUARD_HAS_APRS 1
+#define SKYGUARD_GPS_COUNT 1
+#define SKYGUARD_HAS_IMU 0
+#define SKYGUARD_HAS_ADSB 0
@@ -0,0 +1,68 @@
+// Single-producer, single-consumer byte ring.
+//
+// One side may run in interrupt context: the producer only moves head_ and
+// the consumer only moves tail_. The consumer can take the readable bytes
+// as contiguous spans to hand straight to a DMA transfer.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+namespace skyguard::console {
+
+template <size_t N>
+class ByteRing {
+  static_assert(N && (N & (N - 1)) == 0, "ring size must be a power of two");
+
+ public:
+  size_t size() const {
+    return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+  }
+  size_t space() const { return N - size(); }
+  static constexpr size_t capacity() { return N; }
+
+  /// Producer: copies up to `n` bytes; returns the number accepted.
+  size_t write(const uint8_t* data, size_t n) {
+    uint32_t head = head_.load(std::memory_order_relaxed);
+    size_t free = N - (head - tail_.load(std::memory_order_acquire));
+    if (n > free) n = free;
+    for (size_t i = 0; i < n; ++i) buf_[(head + i) & (N - 1)] = data[i];
+    head_.store(head + static_cast<uint32_t>(n), std::memory_order_release);
+    return n;
+  }
+
+  /// Consumer: the longest readable span starting at the tail.
+  size_t peek(const uint8_t** data) const {
+    uint32_t tail = tail_.load(std::memory_order_relaxed);
+    size_t avail = head_.load(std::memory_order_acquire) - tail;
+    size_t to_end = N - (tail & (N - 1));
+    *data = buf_ + (tail & (N - 1));
+    return avail < to_end ? avail : to_end;
+  }
+  void consume(size_t n) {
+    tail_.store(tail_.load(std::memory_order_relaxed) + static_cast<uint32_t>(n),
+                std::memory_order_release);
+  }
+  size_t read(uint8_t* out, size_t n) {
+    size_t got = 0;
+    while (got < n) {
+      const uint8_t* p;
+      size_t k = peek(&p);
+      if (k == 0) break;
+      if (k > n - got) k = n - got;
+      for (size_t i = 0; i < k; ++i) out[got + i] = p[i];
+      consume(k);
+      got += k;
+    }
+    return got;
+  }
+
+ private:
+  uint8_t buf_[N] = {};
+  std::atomic<uint32_t> head_{0};
+  std::atomic<uint32_t> tail_{0};
+};
+
+}  // namespace skyguard::console
@@ -0,0 +1,326 @@
+#include "console/console.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace skyguard::console {
+
+namespace {
+
+constexpr uint8_t kCtrlC = 0x03;
+constexpr uint8_t kBackspace = 0x08;
+constexpr uint8_t kDelete = 0x7F;
+
+}  // namespace
+
+// Built-ins come first in `help` and cannot be overridden.
+const ConsoleCommand Console::kBuiltins[] = {
+    {"help", "list commands", Console::cmd_help, nullptr},
+    {"get", "get [name]: show parameters", Console::cmd_get, nullptr},
+    {"set", "set <name> <value>: apply, or stage inside a batch", Console::cmd_set, nullptr},
+    {"begin", "start a batch of sets", Console::cmd_begin, nullptr},
+    {"commit", "apply the batch, or nothing if any line failed", Console::cmd_commit, nullptr},
+    {"abort", "discard the batch", Console::cmd_abort, nullptr},
+};
+const size_t Console::kBuiltinCount = sizeof(kBuiltins) / sizeof(kBuiltins[0]);
+
+bool Console::add_command(const ConsoleCommand& cmd) {
+  if (n_commands_ >= kConsoleMaxCommands) return false;
+  commands_[n_commands_++] = cmd;
+  return true;
+}
+
+bool Console::add_param(const ConsoleParam& param) {
+  if (n_params_ >= kConsoleMaxParams || param.min > param.max) return false;
+  params_[n_params_++] = param;
+  return true;
+}
+
+void Console::set_commit_hook(void (*hook)(void* ctx), void* ctx) {
+  commit_hook_ = hook;
+  commit_ctx_ = ctx;
+}
+
+void Console::on_rx(const uint8_t* data, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    if (data[i] == kCtrlC) cancel_.store(true, std::memory_order_relaxed);
+  }
+  size_t took = rx_ring_.write(data, n);
+  stats_.rx_overflow += static_cast<uint32_t>(n - took);
+}
+
+void Console::on_tx_done(size_t n) {
+  tx_ring_.consume(n);
+  start_tx();
+}
+
+void Console::start_tx() {
+  const uint8_t* p;
+  size_t n = tx_ring_.peek(&p);
+  if (n == 0 || !tx_.start(tx_.ctx, p, n)) tx_busy_.store(false, std::memory_order_release);
+}
+
+void Console::kick_tx() {
+  // A completion that found the ring empty just before new output was
+  // queued leaves it for the next poll.
+  if (tx_ring_.size() == 0 || tx_busy_.exchange(true, std::memory_order_acq_rel)) return;
+  start_tx();
+}
+
+bool Console::put(const char* s, size_t n) {
+  if (tx_ring_.space() < n) {
+    ++stats_.tx_dropped;
+    return false;
+  }
+  tx_ring_.write(reinterpret_cast<const uint8_t*>(s), n);
+  return true;
+}
+
+bool Console::print(const char* s) { return put(s, strlen(s)); }
+
+bool Console::printf(const char* fmt, ...) {
+  char buf[kConsoleLineMax + 32];
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+  va_end(ap);
+  if (n < 0) return false;
+  size_t len = static_cast<size_t>(n) < sizeof(buf) ? static_cast<size_t>(n) : sizeof(buf) - 1;
+  return put(buf, len);
+}
+
+void Console::poll() {
+  kick_tx();
+  if (cancel_.exchange(false, std::memory_order_relaxed)) {
+    if (stream_) print("^C\r\nerr cancelled\r\n");
+    stream_ = nullptr;
+    line_len_ = 0;
+    line_overflow_ = false;
+  }
+  if (stream_) {
+    step();
+  } else {
+    uint8_t c;
+    for (size_t budget = kConsoleRxBudget; budget && rx_ring_.read(&c, 1); --budget) {
+      if (take_byte(c)) {
+        execute();
+        break;  // one command per poll
+      }
+    }
+  }
+  kick_tx();
+}
+
+// Returns true when a complete line is ready.
+bool Console::take_byte(uint8_t c) {
+  bool cr_lf = last_cr_ && c == '\n';
+  last_cr_ = c == '\r';
+  if (cr_lf || c == kCtrlC) return false;
+  if (c == '\r' || c == '\n') {
+    if (echo_) print("\r\n");
+    return true;
+  }
+  if (c == kBackspace || c == kDelete) {
+    if (line_len_ && !line_overflow_) {
+      --line_len_;
+      if (echo_) print("\b \b");
+    }
+    return false;
+  }
+  if (c < ' ') return false;
+  if (line_len_ >= kConsoleLineMax) {
+    line_overflow_ = true;
+    return false;
+  }
+  line_[line_len_++] = static_cast<char>(c);
+  if (echo_) put(reinterpret_cast<const char*>(&c), 1);
+  return false;
+}
+
+void Console::execute() {
+  size_t len = line_len_;
+  bool overflow = line_overflow_;
+  line_len_ = 0;
+  line_overflow_ = false;
+  if (overflow) {
+    ++stats_.long_lines;
+    print("err line too long\r\n");
+    finish(CmdResult::kError);
+    return;
+  }
+  line_[len] = '\0';
+
+  size_t argc = 0;
+  for (char* p = line_; *p;) {
+    while (*p == ' ' || *p == '\t') *p++ = '\0';
+    if (!*p) break;
+    if (*p == '#') break;  // comment, for scripts
+    if (argc == kConsoleMaxArgs) {
+      print("err too many arguments\r\n");
+      finish(CmdResult::kError);
+      return;
+    }
+    argv_[argc++] = p;
+    while (*p && *p != ' ' && *p != '\t') ++p;
+  }
+  if (argc == 0) {
+    if (echo_) print("> ");
+    return;
+  }
+
+  const ConsoleCommand* cmd = nullptr;
+  for (const ConsoleCommand& c : kBuiltins) {
+    if (strcmp(c.name, argv_[0]) == 0) cmd = &c;
+  }
+  for (size_t i = 0; !cmd && i < n_commands_; ++i) {
+    if (strcmp(commands_[i].name, argv_[0]) == 0) cmd = &commands_[i];
+  }
+  ++stats_.commands;
+  if (!cmd) {
+    printf("err unknown command %s\r\n", argv_[0]);
+    finish(CmdResult::kError);
+    return;
+  }
+  call_ = CmdCall{argc, argv_, 0};
+  stream_ = cmd;
+  step();
+}
+
+void Console::step() {
+  // Streaming steps wait until a full line fits.
+  if (call_.cursor && tx_ring_.space() < kConsoleLineMax + 2) return;
+  CmdResult r = stream_->fn(stream_->ctx ? stream_->ctx : this, *this, call_);
+  if (r == CmdResult::kMore) {
+    ++call_.cursor;
+    return;
+  }
+  stream_ = nullptr;
+  finish(r);
+}
+
+void Console::finish(CmdResult r) {
+  if (r == CmdResult::kError) {
+    ++stats_.errors;
+    if (batch_) batch_failed_ = true;
+  }
+  if (echo_) print(batch_ ? "batch> " : "> ");
+}
+
+int Console::find_param(const char* name) const {
+  for (size_t i = 0; i < n_params_; ++i) {
+    if (strcmp(params_[i].name, name) == 0) return static_cast<int>(i);
+  }
+  return -1;
+}
+
+bool Console::parse_value(const ConsoleParam& p, const char* text, int32_t* out) {
+  char* end;
+  long v = strtol(text, &end, 0);
+  if (end == text || *end || v < p.min || v > p.max) {
+    printf("err %s must be %ld..%ld\r\n", p.name, static_cast<long>(p.min),
+           static_cast<long>(p.max));
+    return false;
+  }
+  *out = static_cast<int32_t>(v);
+  return true;
+}
+
+CmdResult Console::cmd_help(void*, Console& con, CmdCall& call) {
+  size_t i = call.cursor;
+  if (i < kBuiltinCount + con.n_commands_) {
+    const ConsoleCommand& c = i < kBuiltinCount ? kBuiltins[i] : con.commands_[i - kBuiltinCount];
+    con.printf("  %-8s %s\r\n", c.name, c.help);
+    return CmdResult::kMore;
+  }
+  con.print("ok\r\n");
+  return CmdResult::kDone;
+}
+
+CmdResult Console::cmd_get(void*, Console& con, CmdCall& call) {
+  if (call.argc > 1) {
+    int i = con.find_param(call.argv[1]);
+    if (i < 0) {
+      con.printf("err no parameter %s\r\n", call.argv[1]);
+      return CmdResult::kError;
+    }
+    con.printf("ok %s %ld\r\n", call.argv[1], static_cast<long>(*con.params_[i].value));
+    return CmdResult::kDone;
+  }
+  if (call.cursor < con.n_params_) {
+    const ConsoleParam& p = con.params_[call.cursor];
+    con.printf("  %-16s %ld (%ld..%ld)\r\n", p.name, static_cast<long>(*p.value),
+               static_cast<long>(p.min), static_cast<long>(p.max));
+    return CmdResult::kMore;
+  }
+  con.print("ok\r\n");
+  return CmdResult::kDone;
+}
+
+CmdResult Console::cmd_set(void*, Console& con, CmdCall& call) {
+  if (call.argc != 3) {
+    con.print("err usage: set <name> <value>\r\n");
+    return CmdResult::kError;
+  }
+  int i = con.find_param(call.argv[1]);
+  if (i < 0) {
+    con.printf("err no parameter %s\r\n", call.argv[1]);
+    return CmdResult::kError;
+  }
+  int32_t v;
+  if (!con.parse_value(con.params_[i], call.argv[2], &v)) return CmdResult::kError;
+  if (!con.batch_) {
+    *con.params_[i].value = v;
+    if (con.commit_hook_) con.commit_hook_(con.commit_ctx_);
+    con.printf("ok %s %ld\r\n", call.argv[1], static_cast<long>(v));
+    return CmdResult::kDone;
+  }
+  size_t k = 0;
+  while (k < con.n_staged_ && con.staged_[k].param != i) ++k;
+  con.staged_[k] = {static_cast<uint8_t>(i), v};
+  if (k == con.n_staged_) ++con.n_staged_;
+  con.printf("ok staged %s %ld\r\n", call.argv[1], static_cast<long>(v));
+  return CmdResult::kDone;
+}
+
+CmdResult Console::cmd_begin(void*, Console& con, CmdCall&) {
+  if (con.batch_) {
+    con.print("err batch already open\r\n");
+    return CmdResult::kError;
+  }
+  con.batch_ = true;
+  con.batch_failed_ = false;
+  con.n_staged_ = 0;
+  con.print("ok batch\r\n");
+  return CmdResult::kDone;
+}
+
+CmdResult Console::cmd_commit(void*, Console& con, CmdCall&) {
+  if (!con.batch_) {
+    con.print("err no batch\r\n");
+    return CmdResult::kError;
+  }
+  con.batch_ = false;
+  if (con.batch_failed_) {
+    con.n_staged_ = 0;
+    con.print("err batch had errors, nothing applied\r\n");
+    return CmdResult::kError;
+  }
+  for (size_t k = 0; k < con.n_staged_; ++k) {
+    *con.params_[con.staged_[k].param].value = con.staged_[k].value;
+  }
+  if (con.n_staged_ && con.commit_hook_) con.commit_hook_(con.commit_ctx_);
+  ++con.stats_.commits;
+  con.printf("ok committed %u\r\n", static_cast<unsigned>(con.n_staged_));
+  con.n_staged_ = 0;
+  return CmdResult::kDone;
+}
+
+CmdResult Console::cmd_abort(void*, Console& con, CmdCall&) {
+  con.batch_ = false;
+  con.n_staged_ = 0;
+  con.print("ok aborted\r\n");
+  return CmdResult::kDone;
+}
+
+}  // namespace skyguard::console
@@ -0,0 +1,170 @@
+// Serial console for bench and pad operations that never stalls the caller.
+//
+// Receive bytes arrive from the UART interrupt into a ring; poll() parses a
+// bounded number of them per call and runs at most one command step. Output
+// goes into a bounded ring drained by DMA through ConsoleTxPort; a line that
+// does not fit is dropped and counted rather than waited for. Commands that
+// produce long output return CmdResult::kMore and are called again on later
+// polls, once the ring has room for another line; input waits meanwhile.
+// Ctrl-C cancels a streaming command and clears the input line.
+//
+// Configuration is a table of named integer parameters. `set` applies one
+// immediately; between `begin` and `commit` sets are validated and staged,
+// and commit applies the whole batch at once, or nothing if any line of the
+// batch failed. Because poll() runs from the main loop, flight code never
+// sees a half-applied batch.
+//
+// Wire protocol: every command answers "ok ..." or "err ..." as its last
+// line, so scripts can be checked line by line; lines end in CR LF. With
+// echo on (interactive use) input is echoed and a "> " prompt follows each
+// command.
+#pragma once
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+#include "console/byte_ring.h"
+
+namespace skyguard::console {
+
+constexpr size_t kConsoleRxSize = 256;
+constexpr size_t kConsoleTxSize = 1024;
+constexpr size_t kConsoleLineMax = 96;
+constexpr size_t kConsoleMaxArgs = 8;
+constexpr size_t kConsoleMaxCommands = 16;
+constexpr size_t kConsoleMaxParams = 16;
+constexpr size_t kConsoleRxBudget = 64;  // input bytes parsed per poll()
+
+struct ConsoleTxPort {
+  /// Starts a DMA transfer of `n` bytes; the driver reports completion with
+  /// Console::on_tx_done(). Returns false if it could not start.
+  bool (*start)(void* ctx, const uint8_t* data, size_t n);
+  void* ctx;
+};
+
+enum class CmdResult : uint8_t { kDone, kMore, kError };
+
+struct CmdCall {
+  size_t argc;
+  const char* const* argv;  // argv[0] is the command name
+  uint32_t cursor;          // 0 on the first call, kept across kMore calls
+};
+
+class Console;
+
+/// A streaming step (kMore) should print at most one line.
+using CommandFn = CmdResult (*)(void* ctx, Console& con, CmdCall& call);
+
+struct ConsoleCommand {
+  const char* name;
+  const char* help;
+  CommandFn fn;
+  void* ctx;
+};
+
+struct ConsoleParam {
+  const char* name;
+  int32_t min;
+  int32_t max;
+  int32_t* value;
+};
+
+struct ConsoleStats {
+  uint32_t commands;
+  uint32_t errors;
+  uint32_t rx_overflow;    // bytes lost because the receive ring was full
+  uint32_t tx_dropped;     // output lines that did not fit
+  uint32_t long_lines;     // input lines over kConsoleLineMax
+  uint32_t commits;
+};
+
+class Console {
+ public:
+  explicit Console(const ConsoleTxPort& tx) : tx_(tx) {}
+  Console(const Console&) = delete;
+  Console& operator=(const Console&) = delete;
+
+  bool add_command(const ConsoleCommand& cmd);
+  bool add_param(const ConsoleParam& param);
+  /// Called after values are applied (an immediate set or a commit).
+  void set_commit_hook(void (*hook)(void* ctx), void* ctx);
+  void set_echo(bool on) { echo_ = on; }
+
+  /// UART receive interrupt: new input bytes.
+  void on_rx(const uint8_t* data, size_t n);
+  /// TX DMA interrupt: the transfer finished after `n` bytes.
+  void on_tx_done(size_t n);
+
+  /// Main loop: bounded input parsing or one command step, and keeps the
+  /// TX DMA going.
+  void poll();
+
+  /// Queue output; all or nothing.
+  bool print(const char* s);
+  bool printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+  size_t tx_space() const { return tx_ring_.space(); }
+  size_t tx_pending() const { return tx_ring_.size(); }
+
+  bool streaming() const { return stream_ != nullptr; }
+  bool in_batch() const { return batch_; }
+  const ConsoleStats& stats() const { return stats_; }
+
+ private:
+  struct Staged {
+    uint8_t param;
+    int32_t value;
+  };
+
+  bool put(const char* s, size_t n);
+  void kick_tx();
+  void start_tx();
+  bool take_byte(uint8_t c);
+  void execute();
+  void step();
+  void finish(CmdResult r);
+  int find_param(const char* name) const;
+  bool parse_value(const ConsoleParam& p, const char* text, int32_t* out);
+
+  static const ConsoleCommand kBuiltins[];
+  static const size_t kBuiltinCount;
+
+  static CmdResult cmd_help(void* ctx, Console& con, CmdCall& call);
+  static CmdResult cmd_get(void* ctx, Console& con, CmdCall& call);
+  static CmdResult cmd_set(void* ctx, Console& con, CmdCall& call);
+  static CmdResult cmd_begin(void* ctx, Console& con, CmdCall& call);
+  static CmdResult cmd_commit(void* ctx, Console& con, CmdCall& call);
+  static CmdResult cmd_abort(void* ctx, Console& con, CmdCall& call);
+
+  ConsoleTxPort tx_;
+  ByteRing<kConsoleRxSize> rx_ring_;
+  ByteRing<kConsoleTxSize> tx_ring_;
+  std::atomic<bool> tx_busy_{false};
+  std::atomic<bool> cancel_{false};
+
+  char line_[kConsoleLineMax + 1] = {};
+  size_t line_len_ = 0;
+  bool line_overflow_ = false;
+  bool last_cr_ = false;
+  const char* argv_[kConsoleMaxArgs] = {};
+  CmdCall call_ = {};
+  const ConsoleCommand* stream_ = nullptr;
+  bool echo_ = false;
+
+  ConsoleCommand commands_[kConsoleMaxCommands] = {};
+  size_t n_commands_ = 0;
+  ConsoleParam params_[kConsoleMaxParams] = {};
+  size_t n_params_ = 0;
+  Staged staged_[kConsoleMaxParams] = {};
+  size_t n_staged_ = 0;
+  bool batch_ = false;
+  bool batch_failed_ = false;
+  void (*commit_hook_)(void* ctx) = nullptr;
+  void* commit_ctx_ = nullptr;
+
+  ConsoleStats stats_ = {};
+};
+
+}  // namespace skyguard::console
@@ -0,0 +1,77 @@
+#include "diag/latency_histogram.h"
+
+namespace skyguard::diag {
+
+namespace {
+int floor_log2(uint32_t v) { return 31 - __builtin_clz(v); }
+}  // namespace
+
+size_t LatencyHistogram::bucket_of(uint32_t us) {
+  if (us < 2 * kSub) return us;
+  // Octaves from 2^(kSubBits+1) upwards, split by the bits below the
+  // leading one.
+  int octave = floor_log2(us);
+  uint32_t sub = (us >> (octave - kSubBits)) & (kSub - 1);
+  size_t b = 2 * kSub + static_cast<size_t>(octave - kSubBits - 1) * kSub + sub;
+  return b < kBuckets ? b : kBuckets - 1;
+}
+
+uint32_t LatencyHistogram::bucket_upper_us(size_t bucket) {
+  if (bucket < 2 * kSub) return static_cast<uint32_t>(bucket);
+  if (bucket >= kBuckets - 1) return UINT32_MAX;
+  int octave = static_cast<int>((bucket - 2 * kSub) / kSub) + kSubBits + 1;
+  uint32_t sub = static_cast<uint32_t>((bucket - 2 * kSub) % kSub);
+  uint32_t width = 1u << (octave - kSubBits);
+  return (1u << octave) + sub * width + width - 1;
+}
+
+void LatencyHistogram::add(uint32_t us) {
+  uint16_t& b = buckets_[bucket_of(us)];
+  if (b == UINT16_MAX) {
+    for (uint16_t& h : buckets_) h = static_cast<uint16_t>((h + 1u) / 2);
+  }
+  ++b;
+  if (count_ != UINT32_MAX) ++count_;
+  sum_ += us;
+  if (us < min_) min_ = us;
+  if (us > max_) max_ = us;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+  uint32_t top = 0;
+  for (size_t i = 0; i < kBuckets; ++i) {
+    uint32_t n = static_cast<uint32_t>(buckets_[i]) + other.buckets_[i];
+    if (n > top) top = n;
+  }
+  int shift = 0;
+  while ((top >> shift) > UINT16_MAX) ++shift;
+  for (size_t i = 0; i < kBuckets; ++i) {
+    uint32_t n = static_cast<uint32_t>(buckets_[i]) + other.buckets_[i];
+    buckets_[i] = static_cast<uint16_t>((n + (1u << shift) - 1) >> shift);
+  }
+  count_ = other.count_ > UINT32_MAX - count_ ? UINT32_MAX : count_ + other.count_;
+  sum_ += other.sum_;
+  if (other.min_ < min_) min_ = other.min_;
+  if (other.max_ > max_) max_ = other.max_;
+}
+
+void LatencyHistogram::clear() { *this = LatencyHistogram{}; }
+
+uint32_t LatencyHistogram::percentile_us(uint16_t permille) const {
+  uint32_t total = 0;
+  for (uint16_t b : buckets_) total += b;
+  if (total == 0) return 0;
+  uint32_t rank = static_cast<uint32_t>((static_cast<uint64_t>(total) * permille + 999) / 1000);
+  if (rank == 0) rank = 1;
+  uint32_t seen = 0;
+  for (size_t i = 0; i < kBuckets; ++i) {
+    seen += buckets_[i];
+    if (seen >= rank) {
+      uint32_t upper = bucket_upper_us(i);
+      return upper < max_ ? upper : max_;
+    }
+  }
+  return max_;
+}
+
+}  // namespace skyguard::diag
@@ -0,0 +1,46 @@
+// Log-linear latency histogram in microseconds.
+//
+// Four buckets per octave up to ~67 s: a reported percentile is the upper
+// edge of its bucket (clamped to the maximum seen), so it never understates
+// the true value and overstates it by at most 25% (exact below 8 us).
+// When a bucket fills, every bucket is halved (rounding up), so over a long
+// flight the percentiles keep the shape of the distribution instead of
+// being skewed by saturated buckets. count() stays the lifetime total.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace skyguard::diag {
+
+class LatencyHistogram {
+ public:
+  static constexpr int kSubBits = 2;
+  static constexpr uint32_t kSub = 1u << kSubBits;
+  static constexpr size_t kBuckets = 2 * kSub + (26 - kSubBits - 1) * kSub;
+
+  void add(uint32_t us);
+  /// Adds `other`'s samples (another run or unit), halving as add() does.
+  void merge(const LatencyHistogram& other);
+  void clear();
+
+  uint32_t count() const { return count_; }
+  uint32_t min_us() const { return count_ ? min_ : 0; }
+  uint32_t max_us() const { return max_; }
+  uint64_t sum_us() const { return sum_; }
+
+  /// Upper bound on the `permille`/1000 quantile (e.g. 990 for p99).
+  uint32_t percentile_us(uint16_t permille) const;
+
+  static size_t bucket_of(uint32_t us);
+  static uint32_t bucket_upper_us(size_t bucket);
+
+ private:
+  uint16_t buckets_[kBuckets] = {};  // halved together when one fills
+  uint32_t count_ = 0;
+  uint32_t min_ = UINT32_MAX;
+  uint32_t max_ = 0;
+  uint64_t sum_ = 0;
+};
+
+}  // namespace skyguard::diag
@@ -0,0 +1,95 @@
+#include "diag/latency_trace.h"
+
+#include <stdio.h>
+
+namespace skyguard::diag {
+
+const char* latency_stage_name(LatencyStage s) {
+  switch (s) {
+    case LatencyStage::kSample: return "sample";
+    case LatencyStage::kParse: return "parse";
+    case LatencyStage::kFuse: return "fuse";
+    case LatencyStage::kRule: return "rule";
+    case LatencyStage::kDecide: return "decide";
+    case LatencyStage::kActuatorEnable: return "actuator";
+    case LatencyStage::kCurrentDetected: return "current";
+    case LatencyStage::kCount: break;
+  }
+  return "?";
+}
+
+const char* latency_path_name(LatencyPath p) {
+  switch (p) {
+    case LatencyPath::kBoundary: return "boundary";
+    case LatencyPath::kCommand: return "command";
+    case LatencyPath::kCount: break;
+  }
+  return "?";
+}
+
+void LatencyTracer::begin(LatencyPath path, uint32_t t_us) {
+  Trace& tr = traces_[static_cast<size_t>(path)];
+  tr.start_us = t_us;
+  tr.last_us = t_us;
+  tr.last_stage = -1;
+  tr.active = true;
+}
+
+void LatencyTracer::mark(LatencyPath path, LatencyStage stage, uint32_t t_us) {
+  Trace& tr = traces_[static_cast<size_t>(path)];
+  int8_t s = static_cast<int8_t>(stage);
+  if (!tr.active || s <= tr.last_stage) return;  // out of order: ignore
+  stages_[static_cast<size_t>(s)].add(t_us - tr.last_us);
+  tr.last_us = t_us;
+  tr.last_stage = s;
+  if (stage == LatencyStage::kCurrentDetected) {
+    e2e_[static_cast<size_t>(path)].add(t_us - tr.start_us);
+    tr.active = false;
+  }
+}
+
+void LatencyTracer::end_without_action(LatencyPath path) {
+  traces_[static_cast<size_t>(path)].active = false;
+}
+
+bool LatencyTracer::within_budget(const LatencyBudget& budget) const {
+  for (size_t p = 0; p < static_cast<size_t>(LatencyPath::kCount); ++p) {
+    if (e2e_[p].count() && e2e_[p].percentile_us(990) > budget.p99_us[p]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+size_t LatencyTracer::format_report(char* out, size_t cap) const {
+  size_t n = 0;
+  auto line = [&](const char* name, const LatencyHistogram& h) {
+    if (n >= cap) return;
+    int w = snprintf(out + n, cap - n, "%-10s n=%-6lu p50=%-8lu p99=%-8lu max=%lu\n",
+                     name, static_cast<unsigned long>(h.count()),
+                     static_cast<unsigned long>(h.percentile_us(500)),
+                     static_cast<unsigned long>(h.percentile_us(990)),
+                     static_cast<unsigned long>(h.max_us()));
+    if (w > 0) n += static_cast<size_t>(w);
+  };
+  for (size_t s = 0; s < static_cast<size_t>(LatencyStage::kCount); ++s) {
+    line(latency_stage_name(static_cast<LatencyStage>(s)), stages_[s]);
+  }
+  for (size_t p = 0; p < static_cast<size_t>(LatencyPath::kCount); ++p) {
+    line(latency_path_name(static_cast<LatencyPath>(p)), e2e_[p]);
+  }
+  return n < cap ? n : cap ? cap - 1 : 0;
+}
+
+void LatencyTracer::merge(const LatencyTracer& other) {
+  for (size_t s = 0; s < static_cast<size_t>(LatencyStage::kCount); ++s) {
+    stages_[s].merge(other.stages_[s]);
+  }
+  for (size_t p = 0; p < static_cast<size_t>(LatencyPath::kCount); ++p) {
+    e2e_[p].merge(other.e2e_[p]);
+  }
+}
+
+void LatencyTracer::clear() { *this = LatencyTracer{}; }
+
+}  // namespace skyguard::diag
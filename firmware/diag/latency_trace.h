@@ -0,0 +1,90 @@
+// Stage timestamps along the termination path, from the triggering input to
+// current flowing in the burn wire.
+//
+// Two paths are traced. kBoundary starts at the time of validity of the fix
+// that crossed a limit and passes through the rule stages; kCommand
+// starts when a cut command frame finishes arriving, and the receive
+// interrupt's fast path goes from kParse (authenticated) to the gate. Each
+// stage records its delta from the previous marked stage, so the
+// per-stage histograms add up to the end-to-end one.
+//
+// Most ticks end at kDecide with no cut; end_without_action() keeps those
+// stage samples, which is what gives a useful distribution for the early
+// stages on a device that cuts once per flight. Each path has its own
+// trace in flight, so a command can be traced while a boundary trace waits
+// for current. Calls come from one context; an ISR that detects current
+// should hand the timestamp to the owning task rather than call mark()
+// itself. app::FlightSystem stamps the real stages into latency().
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "diag/latency_histogram.h"
+
+namespace skyguard::diag {
+
+enum class LatencyPath : uint8_t { kBoundary, kCommand, kCount };
+
+enum class LatencyStage : uint8_t {
+  kSample,           // input delivered (the fix's last sentence ended)
+  kParse,            // decoded into engineering units
+  kFuse,             // state estimate updated
+  kRule,             // termination rules evaluated
+  kDecide,           // cut decision latched
+  kActuatorEnable,   // burn channel switched on
+  kCurrentDetected,  // burn current seen by the sense ADC
+  kCount
+};
+
+const char* latency_stage_name(LatencyStage s);
+const char* latency_path_name(LatencyPath p);
+
+struct LatencyBudget {
+  uint32_t p99_us[static_cast<size_t>(LatencyPath::kCount)];
+};
+
+class LatencyTracer {
+ public:
+  /// Starts a trace on `path`, replacing one still in flight there.
+  void begin(LatencyPath path, uint32_t t_us);
+  void mark(LatencyPath path, LatencyStage stage, uint32_t t_us);
+  /// Closes a trace that stopped without current (at kDecide without a
+  /// cut, or a burn that never drew current).
+  void end_without_action(LatencyPath path);
+
+  const LatencyHistogram& stage(LatencyStage s) const {
+    return stages_[static_cast<size_t>(s)];
+  }
+  const LatencyHistogram& end_to_end(LatencyPath p) const {
+    return e2e_[static_cast<size_t>(p)];
+  }
+  bool active(LatencyPath p) const { return traces_[static_cast<size_t>(p)].active; }
+  /// The last stage marked on `p`'s trace, or -1.
+  int last_stage(LatencyPath p) const { return traces_[static_cast<size_t>(p)].last_stage; }
+
+  /// True if every path with samples has p99 within its budget.
+  bool within_budget(const LatencyBudget& budget) const;
+
+  /// Writes a plain-text table (one line per stage and path) for the
+  /// console. Returns the length written.
+  size_t format_report(char* out, size_t cap) const;
+
+  /// Adds `other`'s histograms; traces in flight are not carried over.
+  void merge(const LatencyTracer& other);
+  void clear();
+
+ private:
+  struct Trace {
+    uint32_t start_us = 0;
+    uint32_t last_us = 0;
+    int8_t last_stage = -1;
+    bool active = false;
+  };
+
+  LatencyHistogram stages_[static_cast<size_t>(LatencyStage::kCount)];
+  LatencyHistogram e2e_[static_cast<size_t>(LatencyPath::kCount)];
+  Trace traces_[static_cast<size_t>(LatencyPath::kCount)];
+};
+
+}  // namespace skyguard::diag
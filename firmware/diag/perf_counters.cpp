@@ -0,0 +1,84 @@
+#include "diag/perf_counters.h"
+
+namespace skyguard::diag {
+
+namespace {
+
+using records::PerfCounters;
+
+static_assert(sizeof(PerfCounters::task_cpu_permille) / 2 ==
+                  static_cast<size_t>(PerfTask::kCount) &&
+              sizeof(PerfCounters::task_deadline_misses) ==
+                  static_cast<size_t>(PerfTask::kCount) &&
+              sizeof(PerfCounters::queue_high_water) == static_cast<size_t>(PerfQueue::kCount) &&
+              sizeof(PerfCounters::isr_latency_max_us) / 2 ==
+                  static_cast<size_t>(PerfIsr::kCount) &&
+              sizeof(PerfCounters::energy_j10) / 2 == static_cast<size_t>(PerfRail::kCount),
+              "PerfCounters arrays match the counter enums");
+
+uint16_t sat16(uint64_t v) { return v > UINT16_MAX ? UINT16_MAX : static_cast<uint16_t>(v); }
+uint8_t sat8(uint32_t v) { return v > UINT8_MAX ? UINT8_MAX : static_cast<uint8_t>(v); }
+
+template <class T>
+void raise_to(std::atomic<T>& slot, T v) {
+  T cur = slot.load(std::memory_order_relaxed);
+  while (v > cur && !slot.compare_exchange_weak(cur, v, std::memory_order_relaxed)) {
+  }
+}
+
+}  // namespace
+
+void PerfMonitor::task_run(PerfTask task, uint32_t elapsed_us, uint32_t budget_us) {
+  size_t t = static_cast<size_t>(task);
+  task_us_[t] = elapsed_us > UINT32_MAX - task_us_[t] ? UINT32_MAX : task_us_[t] + elapsed_us;
+  if (budget_us && elapsed_us > budget_us && task_misses_[t] != UINT16_MAX) ++task_misses_[t];
+}
+
+void PerfMonitor::queue_depth(PerfQueue queue, uint32_t depth) {
+  raise_to(queue_high_[static_cast<size_t>(queue)], sat8(depth));
+}
+
+void PerfMonitor::flash_write(uint32_t us) { flash_.add(us); }
+
+void PerfMonitor::isr_latency(PerfIsr isr, uint32_t us) {
+  raise_to(isr_max_us_[static_cast<size_t>(isr)], sat16(us));
+}
+
+void PerfMonitor::energy(PerfRail rail, uint32_t microjoules) {
+  uint32_t& e = energy_uj_[static_cast<size_t>(rail)];
+  e = microjoules > UINT32_MAX - e ? UINT32_MAX : e + microjoules;
+}
+
+void PerfMonitor::snapshot(uint32_t now_ms, const telemetry::BufferPool& pool,
+                           PerfCounters* out) {
+  uint32_t window_ms = now_ms - window_start_ms_;
+  out->time_ms = now_ms;
+  out->window_s = sat16((window_ms + 500) / 1000);
+  for (size_t t = 0; t < kTasks; ++t) {
+    out->task_cpu_permille[t] =
+        window_ms ? sat16(static_cast<uint64_t>(task_us_[t]) / window_ms) : 0;
+    out->task_deadline_misses[t] = sat8(task_misses_[t]);
+    task_us_[t] = 0;
+    task_misses_[t] = 0;
+  }
+  for (size_t q = 0; q < kQueues; ++q) {
+    out->queue_high_water[q] = queue_high_[q].exchange(0, std::memory_order_relaxed);
+  }
+  out->pool_high_water = pool.high_water();
+  out->pool_exhausted = sat8(pool.exhausted() - pool_exhausted_base_);
+  pool_exhausted_base_ = pool.exhausted();
+  out->flash_write_p99_us = sat16(flash_.percentile_us(990));
+  out->flash_write_max_us = sat16(flash_.max_us());
+  flash_.clear();
+  out->radio_retries = radio_retries_.exchange(0, std::memory_order_relaxed);
+  for (size_t i = 0; i < kIsrs; ++i) {
+    out->isr_latency_max_us[i] = isr_max_us_[i].exchange(0, std::memory_order_relaxed);
+  }
+  for (size_t r = 0; r < kRails; ++r) {
+    out->energy_j10[r] = sat16((energy_uj_[r] + 50000) / 100000);
+    energy_uj_[r] = 0;
+  }
+  window_start_ms_ = now_ms;
+}
+
+}  // namespace skyguard::diag
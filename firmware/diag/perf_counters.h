@@ -0,0 +1,59 @@
+// In-flight performance counters, downlinked as records::PerfCounters.
+//
+// Drivers and tasks report into one PerfMonitor as they run; snapshot()
+// condenses the window since the previous snapshot into the 52-byte record
+// and starts the next window. Per-window values (CPU share, misses, maxima,
+// energy) reset at each snapshot; the pool high-water mark is since boot.
+// The ISR and queue entry points may be called from interrupt context.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+#include "diag/latency_histogram.h"
+#include "generated/records.h"
+#include "telemetry/buffer_pool.h"
+
+namespace skyguard::diag {
+
+enum class PerfTask : uint8_t { kTick, kGps, kTelemetry, kRadio, kLog, kFence, kCount };
+enum class PerfQueue : uint8_t { kRouter, kGpsRx, kLogWrite, kConsoleTx, kCount };
+enum class PerfIsr : uint8_t { kRadio, kGpsUart, kTimer, kCount };
+enum class PerfRail : uint8_t { kCore, kGps, kRadio, kIridium, kBurn, kCount };
+
+class PerfMonitor {
+ public:
+  /// A task ran for `elapsed_us`; it missed its deadline if that exceeds a
+  /// non-zero `budget_us`.
+  void task_run(PerfTask task, uint32_t elapsed_us, uint32_t budget_us);
+  void queue_depth(PerfQueue queue, uint32_t depth);
+  void flash_write(uint32_t us);
+  void radio_retry() { radio_retries_.fetch_add(1, std::memory_order_relaxed); }
+  /// Interrupt entry latency (request to handler start).
+  void isr_latency(PerfIsr isr, uint32_t us);
+  void energy(PerfRail rail, uint32_t microjoules);
+
+  /// Fills `out` for the window ending at `now_ms` and starts a new one.
+  void snapshot(uint32_t now_ms, const telemetry::BufferPool& pool,
+                records::PerfCounters* out);
+
+ private:
+  static constexpr size_t kTasks = static_cast<size_t>(PerfTask::kCount);
+  static constexpr size_t kQueues = static_cast<size_t>(PerfQueue::kCount);
+  static constexpr size_t kIsrs = static_cast<size_t>(PerfIsr::kCount);
+  static constexpr size_t kRails = static_cast<size_t>(PerfRail::kCount);
+
+  uint32_t window_start_ms_ = 0;
+  uint32_t task_us_[kTasks] = {};
+  uint16_t task_misses_[kTasks] = {};
+  std::atomic<uint8_t> queue_high_[kQueues] = {};
+  std::atomic<uint16_t> isr_max_us_[kIsrs] = {};
+  std::atomic<uint16_t> radio_retries_{0};
+  uint32_t energy_uj_[kRails] = {};
+  uint32_t pool_exhausted_base_ = 0;
+  LatencyHistogram flash_;
+};
+
+}  // namespace skyguard::diag
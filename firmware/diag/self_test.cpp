@@ -0,0 +1,86 @@
+#include "diag/self_test.h"
+
+namespace skyguard::diag {
+
+bool SelfTest::add(const SelfTestCheck& check) {
+  if (running_ || n_checks_ >= kSelfTestMaxChecks || !check.step) return false;
+  if (check.bus != kSelfTestNoBus && check.bus >= kSelfTestMaxBuses) return false;
+  checks_[n_checks_++] = check;
+  return true;
+}
+
+bool SelfTest::start(SelfTestMode mode, uint32_t now_ms, uint32_t budget_ms) {
+  if (running_) return false;
+  report_ = {};
+  report_.time_ms = now_ms;
+  report_.mode = static_cast<uint8_t>(mode);
+  report_.checks = static_cast<uint8_t>(n_checks_);
+  for (int8_t& owner : bus_owner_) owner = -1;
+  budget_us_ = budget_ms * 1000;
+  start_us_ = clock_us_();
+  end_us_ = start_us_;
+  steps_ = 0;
+  open_ = 0;
+  for (size_t i = 0; i < n_checks_; ++i) {
+    step_[i] = 0;
+    bool skip = mode == SelfTestMode::kFlight && (checks_[i].flags & kSelfTestPadOnly);
+    verdict_[i] = skip ? kSkipped : kRunning;
+    if (!skip) ++open_;
+  }
+  running_ = true;
+  if (open_ == 0) finish();
+  return true;
+}
+
+void SelfTest::settle(size_t i, Verdict v) {
+  verdict_[i] = v;
+  uint8_t bit = static_cast<uint8_t>(1u << i);
+  if (v == kPassed) report_.passed |= bit;
+  if (v == kFailed) report_.failed |= bit;
+  if (v == kTimedOut) report_.timed_out |= bit;
+  uint8_t bus = checks_[i].bus;
+  if (bus != kSelfTestNoBus && bus_owner_[bus] == static_cast<int8_t>(i)) bus_owner_[bus] = -1;
+  --open_;
+}
+
+void SelfTest::finish() {
+  end_us_ = clock_us_();
+  uint32_t ms = duration_us() / 1000;
+  report_.duration_ms = static_cast<uint16_t>(ms < 0xFFFF ? ms : 0xFFFF);
+  running_ = false;
+}
+
+bool SelfTest::poll(uint32_t slice_us) {
+  if (!running_) return true;
+  uint32_t t0 = clock_us_();
+  do {
+    for (size_t i = 0; i < n_checks_; ++i) {
+      if (verdict_[i] != kRunning) continue;
+      uint32_t now = clock_us_();
+      uint32_t elapsed = now - start_us_;
+      if (elapsed >= budget_us_ || elapsed / 1000 >= checks_[i].timeout_ms) {
+        settle(i, kTimedOut);
+        continue;
+      }
+      uint8_t bus = checks_[i].bus;
+      if (bus != kSelfTestNoBus) {
+        if (bus_owner_[bus] >= 0 && bus_owner_[bus] != static_cast<int8_t>(i)) continue;
+        bus_owner_[bus] = static_cast<int8_t>(i);
+      }
+      ++steps_;
+      CheckStatus s = checks_[i].step(checks_[i].ctx, step_[i]++, now, &report_.value[i]);
+      if (s == CheckStatus::kPass || s == CheckStatus::kFail) {
+        settle(i, s == CheckStatus::kPass ? kPassed : kFailed);
+      } else if (s == CheckStatus::kWait && bus != kSelfTestNoBus) {
+        bus_owner_[bus] = -1;
+      }
+    }
+    if (open_ == 0) {
+      finish();
+      return true;
+    }
+  } while (slice_us && clock_us_() - t0 < slice_us);
+  return false;
+}
+
+}  // namespace skyguard::diag
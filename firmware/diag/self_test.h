@@ -0,0 +1,92 @@
+// Launch-readiness self-test: independent checks run side by side under a
+// hard time budget and report as one records::SelfTestReport.
+//
+// Each check is a cooperative state machine. poll() calls its step
+// function, which starts or polls one non-blocking operation (drain a UART,
+// sample an ADC, one bus transaction) and returns. The runner interleaves
+// the steps of every running check, so a run takes about as long as its
+// slowest check rather than the sum of them. Checks that declare the same
+// bus get it one at a time, in registration order, and keep it until they
+// return a verdict or kWait (waiting on the device, e.g. a conversion);
+// everything else overlaps. A check still running at its own timeout, or
+// when the run's budget runs out, is reported as timed out.
+//
+// On the pad poll() is called in a loop. In flight the same checks can be
+// run from idle time: poll() then gets a small time slice per call, and
+// checks flagged kSelfTestPadOnly (those that would disturb flight
+// hardware or storage) are skipped.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "generated/records.h"
+
+namespace skyguard::diag {
+
+constexpr size_t kSelfTestMaxChecks = 8;  // SelfTestReport::value
+constexpr uint8_t kSelfTestMaxBuses = 4;
+constexpr uint8_t kSelfTestNoBus = 0xFF;
+constexpr uint32_t kSelfTestBudgetMs = 2000;
+
+/// SelfTestCheck::flags
+constexpr uint8_t kSelfTestPadOnly = 1u << 0;
+
+enum class SelfTestMode : uint8_t { kPad, kFlight };
+/// kWait: still running, but releases its bus until its next step.
+enum class CheckStatus : uint8_t { kRunning, kWait, kPass, kFail };
+
+struct SelfTestCheck {
+  /// One non-blocking step; `step` counts calls from 0 within the run. A
+  /// check may update `*value` (its measurement) on any step.
+  CheckStatus (*step)(void* ctx, uint32_t step, uint32_t now_us, int16_t* value);
+  void* ctx;
+  uint32_t timeout_ms;  // from the start of the run
+  uint8_t bus;          // kSelfTestNoBus, or an index below kSelfTestMaxBuses
+  uint8_t flags;
+};
+
+class SelfTest {
+ public:
+  explicit SelfTest(uint32_t (*clock_us)()) : clock_us_(clock_us) {}
+
+  bool add(const SelfTestCheck& check);
+  size_t check_count() const { return n_checks_; }
+
+  /// Starts a run of every registered check allowed in `mode`. Returns
+  /// false if a run is already in progress.
+  bool start(SelfTestMode mode, uint32_t now_ms, uint32_t budget_ms = kSelfTestBudgetMs);
+  /// Steps the running checks round robin until the run finishes or
+  /// `slice_us` has passed; 0 makes a single pass. Returns true once the
+  /// run is finished.
+  bool poll(uint32_t slice_us = 0);
+  bool running() const { return running_; }
+
+  /// The last run, complete once poll() has returned true.
+  const records::SelfTestReport& report() const { return report_; }
+  uint32_t duration_us() const { return end_us_ - start_us_; }
+  uint32_t steps() const { return steps_; }
+
+ private:
+  enum Verdict : uint8_t { kRunning, kPassed, kFailed, kTimedOut, kSkipped };
+
+  void settle(size_t i, Verdict v);
+  void finish();
+
+  uint32_t (*clock_us_)();
+  SelfTestCheck checks_[kSelfTestMaxChecks] = {};
+  size_t n_checks_ = 0;
+
+  bool running_ = false;
+  uint32_t budget_us_ = 0;
+  uint32_t start_us_ = 0;
+  uint32_t end_us_ = 0;
+  uint32_t steps_ = 0;
+  size_t open_ = 0;  // checks still running
+  Verdict verdict_[kSelfTestMaxChecks] = {};
+  uint32_t step_[kSelfTestMaxChecks] = {};
+  int8_t bus_owner_[kSelfTestMaxBuses] = {};
+  records::SelfTestReport report_ = {};
+};
+
+}  // namespace skyguard::diag
@@ -0,0 +1,518 @@
+// Generated by tools/schemagen.py from schema/records.schema. Do not edit.
+//
+// On-board record structs with a fixed, constexpr wire layout. encode()
+// writes the current version; the layout constants let log and telemetry
+// code reserve space and reference fields without runtime reflection.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace skyguard::records {
+
+struct StateSnapshot {
+  static constexpr uint8_t kId = 1;
+  static constexpr uint8_t kVersion = 2;
+  static constexpr size_t kEncodedSize = 33;
+  static constexpr size_t kOffset_time_ms = 0;
+  static constexpr size_t kOffset_lat_e7 = 4;
+  static constexpr size_t kOffset_lon_e7 = 8;
+  static constexpr size_t kOffset_alt_mm = 12;
+  static constexpr size_t kOffset_vel_cm_s = 16;
+  static constexpr size_t kOffset_flags = 22;
+  static constexpr size_t kOffset_baro_pa_div4 = 24;
+  static constexpr size_t kOffset_temp_c10 = 26;
+  static constexpr size_t kOffset_state = 28;
+  static constexpr size_t kOffset_fix = 29;
+  static constexpr size_t kOffset_sats = 30;
+  static constexpr size_t kOffset_battery_mv = 31;
+
+  /// Encoded size written by a given schema version of this record.
+  static constexpr size_t encoded_size(uint8_t version) {
+    if (version >= 2) return 33;
+    if (version >= 1) return 31;
+    return 0;
+  }
+
+  uint32_t time_ms;
+  int32_t lat_e7;
+  int32_t lon_e7;
+  int32_t alt_mm;
+  int16_t vel_cm_s[3];
+  uint16_t flags;
+  int16_t baro_pa_div4;
+  int16_t temp_c10;
+  uint8_t state;
+  uint8_t fix;
+  uint8_t sats;
+  uint16_t battery_mv;
+
+  /// Writes kEncodedSize bytes; returns 0 if `cap` is too small.
+  size_t encode(uint8_t* out, size_t cap) const {
+    if (cap < kEncodedSize) return 0;
+    out[0] = static_cast<uint8_t>(time_ms);
+    out[1] = static_cast<uint8_t>(time_ms >> 8);
+    out[2] = static_cast<uint8_t>(time_ms >> 16);
+    out[3] = static_cast<uint8_t>(time_ms >> 24);
+    out[4] = static_cast<uint8_t>(static_cast<uint32_t>(lat_e7));
+    out[5] = static_cast<uint8_t>(static_cast<uint32_t>(lat_e7) >> 8);
+    out[6] = static_cast<uint8_t>(static_cast<uint32_t>(lat_e7) >> 16);
+    out[7] = static_cast<uint8_t>(static_cast<uint32_t>(lat_e7) >> 24);
+    out[8] = static_cast<uint8_t>(static_cast<uint32_t>(lon_e7));
+    out[9] = static_cast<uint8_t>(static_cast<uint32_t>(lon_e7) >> 8);
+    out[10] = static_cast<uint8_t>(static_cast<uint32_t>(lon_e7) >> 16);
+    out[11] = static_cast<uint8_t>(static_cast<uint32_t>(lon_e7) >> 24);
+    out[12] = static_cast<uint8_t>(static_cast<uint32_t>(alt_mm));
+    out[13] = static_cast<uint8_t>(static_cast<uint32_t>(alt_mm) >> 8);
+    out[14] = static_cast<uint8_t>(static_cast<uint32_t>(alt_mm) >> 16);
+    out[15] = static_cast<uint8_t>(static_cast<uint32_t>(alt_mm) >> 24);
+    for (size_t i = 0; i < 3; ++i) {
+      out[16 + 2 * i] = static_cast<uint8_t>(static_cast<uint16_t>(vel_cm_s[i]));
+      out[17 + 2 * i] = static_cast<uint8_t>(static_cast<uint16_t>(vel_cm_s[i]) >> 8);
+    }
+    out[22] = static_cast<uint8_t>(flags);
+    out[23] = static_cast<uint8_t>(flags >> 8);
+    out[24] = static_cast<uint8_t>(static_cast<uint16_t>(baro_pa_div4));
+    out[25] = static_cast<uint8_t>(static_cast<uint16_t>(baro_pa_div4) >> 8);
+    out[26] = static_cast<uint8_t>(static_cast<uint16_t>(temp_c10));
+    out[27] = static_cast<uint8_t>(static_cast<uint16_t>(temp_c10) >> 8);
+    out[28] = state;
+    out[29] = fix;
+    out[30] = sats;
+    out[31] = static_cast<uint8_t>(battery_mv);
+    out[32] = static_cast<uint8_t>(battery_mv >> 8);
+    return kEncodedSize;
+  }
+};
+
+static_assert(StateSnapshot::kEncodedSize == 33, "StateSnapshot layout");
+
+struct HealthCounters {
+  static constexpr uint8_t kId = 2;
+  static constexpr uint8_t kVersion = 1;
+  static constexpr size_t kEncodedSize = 32;
+  static constexpr size_t kOffset_uptime_s = 0;
+  static constexpr size_t kOffset_resets = 4;
+  static constexpr size_t kOffset_gps_fixes = 8;
+  static constexpr size_t kOffset_gps_timeouts = 12;
+  static constexpr size_t kOffset_radio_tx = 16;
+  static constexpr size_t kOffset_radio_tx_failed = 20;
+  static constexpr size_t kOffset_log_writes = 24;
+  static constexpr size_t kOffset_log_errors = 28;
+
+  /// Encoded size written by a given schema version of this record.
+  static constexpr size_t encoded_size(uint8_t version) {
+    if (version >= 1) return 32;
+    return 0;
+  }
+
+  uint32_t uptime_s;
+  uint32_t resets;
+  uint32_t gps_fixes;
+  uint32_t gps_timeouts;
+  uint32_t radio_tx;
+  uint32_t radio_tx_failed;
+  uint32_t log_writes;
+  uint32_t log_errors;
+
+  /// Writes kEncodedSize bytes; returns 0 if `cap` is too small.
+  size_t encode(uint8_t* out, size_t cap) const {
+    if (cap < kEncodedSize) return 0;
+    out[0] = static_cast<uint8_t>(uptime_s);
+    out[1] = static_cast<uint8_t>(uptime_s >> 8);
+    out[2] = static_cast<uint8_t>(uptime_s >> 16);
+    out[3] = static_cast<uint8_t>(uptime_s >> 24);
+    out[4] = static_cast<uint8_t>(resets);
+    out[5] = static_cast<uint8_t>(resets >> 8);
+    out[6] = static_cast<uint8_t>(resets >> 16);
+    out[7] = static_cast<uint8_t>(resets >> 24);
+    out[8] = static_cast<uint8_t>(gps_fixes);
+    out[9] = static_cast<uint8_t>(gps_fixes >> 8);
+    out[10] = static_cast<uint8_t>(gps_fixes >> 16);
+    out[11] = static_cast<uint8_t>(gps_fixes >> 24);
+    out[12] = static_cast<uint8_t>(gps_timeouts);
+    out[13] = static_cast<uint8_t>(gps_timeouts >> 8);
+    out[14] = static_cast<uint8_t>(gps_timeouts >> 16);
+    out[15] = static_cast<uint8_t>(gps_timeouts >> 24);
+    out[16] = static_cast<uint8_t>(radio_tx);
+    out[17] = static_cast<uint8_t>(radio_tx >> 8);
+    out[18] = static_cast<uint8_t>(radio_tx >> 16);
+    out[19] = static_cast<uint8_t>(radio_tx >> 24);
+    out[20] = static_cast<uint8_t>(radio_tx_failed);
+    out[21] = static_cast<uint8_t>(radio_tx_failed >> 8);
+    out[22] = static_cast<uint8_t>(radio_tx_failed >> 16);
+    out[23] = static_cast<uint8_t>(radio_tx_failed >> 24);
+    out[24] = static_cast<uint8_t>(log_writes);
+    out[25] = static_cast<uint8_t>(log_writes >> 8);
+    out[26] = static_cast<uint8_t>(log_writes >> 16);
+    out[27] = static_cast<uint8_t>(log_writes >> 24);
+    out[28] = static_cast<uint8_t>(log_errors);
+    out[29] = static_cast<uint8_t>(log_errors >> 8);
+    out[30] = static_cast<uint8_t>(log_errors >> 16);
+    out[31] = static_cast<uint8_t>(log_errors >> 24);
+    return kEncodedSize;
+  }
+};
+
+static_assert(HealthCounters::kEncodedSize == 32, "HealthCounters layout");
+
+struct Event {
+  static constexpr uint8_t kId = 3;
+  static constexpr uint8_t kVersion = 1;
+  static constexpr size_t kEncodedSize = 16;
+  static constexpr size_t kOffset_time_ms = 0;
+  static constexpr size_t kOffset_code = 4;
+  static constexpr size_t kOffset_arg16 = 6;
+  static constexpr size_t kOffset_arg32 = 8;
+
+  /// Encoded size written by a given schema version of this record.
+  static constexpr size_t encoded_size(uint8_t version) {
+    if (version >= 1) return 16;
+    return 0;
+  }
+
+  uint32_t time_ms;
+  uint16_t code;
+  uint16_t arg16;
+  uint32_t arg32[2];
+
+  /// Writes kEncodedSize bytes; returns 0 if `cap` is too small.
+  size_t encode(uint8_t* out, size_t cap) const {
+    if (cap < kEncodedSize) return 0;
+    out[0] = static_cast<uint8_t>(time_ms);
+    out[1] = static_cast<uint8_t>(time_ms >> 8);
+    out[2] = static_cast<uint8_t>(time_ms >> 16);
+    out[3] = static_cast<uint8_t>(time_ms >> 24);
+    out[4] = static_cast<uint8_t>(code);
+    out[5] = static_cast<uint8_t>(code >> 8);
+    out[6] = static_cast<uint8_t>(arg16);
+    out[7] = static_cast<uint8_t>(arg16 >> 8);
+    for (size_t i = 0; i < 2; ++i) {
+      out[8 + 4 * i] = static_cast<uint8_t>(arg32[i]);
+      out[9 + 4 * i] = static_cast<uint8_t>(arg32[i] >> 8);
+      out[10 + 4 * i] = static_cast<uint8_t>(arg32[i] >> 16);
+      out[11 + 4 * i] = static_cast<uint8_t>(arg32[i] >> 24);
+    }
+    return kEncodedSize;
+  }
+};
+
+static_assert(Event::kEncodedSize == 16, "Event layout");
+
+struct PerfCounters {
+  static constexpr uint8_t kId = 4;
+  static constexpr uint8_t kVersion = 1;
+  static constexpr size_t kEncodedSize = 52;
+  static constexpr size_t kOffset_time_ms = 0;
+  static constexpr size_t kOffset_window_s = 4;
+  static constexpr size_t kOffset_task_cpu_permille = 6;
+  static constexpr size_t kOffset_task_deadline_misses = 18;
+  static constexpr size_t kOffset_queue_high_water = 24;
+  static constexpr size_t kOffset_pool_high_water = 28;
+  static constexpr size_t kOffset_pool_exhausted = 29;
+  static constexpr size_t kOffset_flash_write_p99_us = 30;
+  static constexpr size_t kOffset_flash_write_max_us = 32;
+  static constexpr size_t kOffset_radio_retries = 34;
+  static constexpr size_t kOffset_isr_latency_max_us = 36;
+  static constexpr size_t kOffset_energy_j10 = 42;
+
+  /// Encoded size written by a given schema version of this record.
+  static constexpr size_t encoded_size(uint8_t version) {
+    if (version >= 1) return 52;
+    return 0;
+  }
+
+  uint32_t time_ms;
+  uint16_t window_s;
+  uint16_t task_cpu_permille[6];
+  uint8_t task_deadline_misses[6];
+  uint8_t queue_high_water[4];
+  uint8_t pool_high_water;
+  uint8_t pool_exhausted;
+  uint16_t flash_write_p99_us;
+  uint16_t flash_write_max_us;
+  uint16_t radio_retries;
+  uint16_t isr_latency_max_us[3];
+  uint16_t energy_j10[5];
+
+  /// Writes kEncodedSize bytes; returns 0 if `cap` is too small.
+  size_t encode(uint8_t* out, size_t cap) const {
+    if (cap < kEncodedSize) return 0;
+    out[0] = static_cast<uint8_t>(time_ms);
+    out[1] = static_cast<uint8_t>(time_ms >> 8);
+    out[2] = static_cast<uint8_t>(time_ms >> 16);
+    out[3] = static_cast<uint8_t>(time_ms >> 24);
+    out[4] = static_cast<uint8_t>(window_s);
+    out[5] = static_cast<uint8_t>(window_s >> 8);
+    for (size_t i = 0; i < 6; ++i) {
+      out[6 + 2 * i] = static_cast<uint8_t>(task_cpu_permille[i]);
+      out[7 + 2 * i] = static_cast<uint8_t>(task_cpu_permille[i] >> 8);
+    }
+    for (size_t i = 0; i < 6; ++i) {
+      out[18 + 1 * i] = task_deadline_misses[i];
+    }
+    for (size_t i = 0; i < 4; ++i) {
+      out[24 + 1 * i] = queue_high_water[i];
+    }
+    out[28] = pool_high_water;
+    out[29] = pool_exhausted;
+    out[30] = static_cast<uint8_t>(flash_write_p99_us);
+    out[31] = static_cast<uint8_t>(flash_write_p99_us >> 8);
+    out[32] = static_cast<uint8_t>(flash_write_max_us);
+    out[33] = static_cast<uint8_t>(flash_write_max_us >> 8);
+    out[34] = static_cast<uint8_t>(radio_retries);
+    out[35] = static_cast<uint8_t>(radio_retries >> 8);
+    for (size_t i = 0; i < 3; ++i) {
+      out[36 + 2 * i] = static_cast<uint8_t>(isr_latency_max_us[i]);
+      out[37 + 2 * i] = static_cast<uint8_t>(isr_latency_max_us[i] >> 8);
+    }
+    for (size_t i = 0; i < 5; ++i) {
+      out[42 + 2 * i] = static_cast<uint8_t>(energy_j10[i]);
+      out[43 + 2 * i] = static_cast<uint8_t>(energy_j10[i] >> 8);
+    }
+    return kEncodedSize;
+  }
+};
+
+static_assert(PerfCounters::kEncodedSize == 52, "PerfCounters layout");
+
+struct PerfConfig {
+  static constexpr uint8_t kId = 5;
+  static constexpr uint8_t kVersion = 1;
+  static constexpr size_t kEncodedSize = 2;
+  static constexpr size_t kOffset_period_s = 0;
+
+  /// Encoded size written by a given schema version of this record.
+  static constexpr size_t encoded_size(uint8_t version) {
+    if (version >= 1) return 2;
+    return 0;
+  }
+
+  uint16_t period_s;
+
+  /// Writes kEncodedSize bytes; returns 0 if `cap` is too small.
+  size_t encode(uint8_t* out, size_t cap) const {
+    if (cap < kEncodedSize) return 0;
+    out[0] = static_cast<uint8_t>(period_s);
+    out[1] = static_cast<uint8_t>(period_s >> 8);
+    return kEncodedSize;
+  }
+};
+
+static_assert(PerfConfig::kEncodedSize == 2, "PerfConfig layout");
+
+struct SelfTestReport {
+  static constexpr uint8_t kId = 6;
+  static constexpr uint8_t kVersion = 1;
+  static constexpr size_t kEncodedSize = 27;
+  static constexpr size_t kOffset_time_ms = 0;
+  static constexpr size_t kOffset_duration_ms = 4;
+  static constexpr size_t kOffset_mode = 6;
+  static constexpr size_t kOffset_checks = 7;
+  static constexpr size_t kOffset_passed = 8;
+  static constexpr size_t kOffset_failed = 9;
+  static constexpr size_t kOffset_timed_out = 10;
+  static constexpr size_t kOffset_value = 11;
+
+  /// Encoded size written by a given schema version of this record.
+  static constexpr size_t encoded_size(uint8_t version) {
+    if (version >= 1) return 27;
+    return 0;
+  }
+
+  uint32_t time_ms;
+  uint16_t duration_ms;
+  uint8_t mode;
+  uint8_t checks;
+  uint8_t passed;
+  uint8_t failed;
+  uint8_t timed_out;
+  int16_t value[8];
+
+  /// Writes kEncodedSize bytes; returns 0 if `cap` is too small.
+  size_t encode(uint8_t* out, size_t cap) const {
+    if (cap < kEncodedSize) return 0;
+    out[0] = static_cast<uint8_t>(time_ms);
+    out[1] = static_cast<uint8_t>(time_ms >> 8);
+    out[2] = static_cast<uint8_t>(time_ms >> 16);
+    out[3] = static_cast<uint8_t>(time_ms >> 24);
+    out[4] = static_cast<uint8_t>(duration_ms);
+    out[5] = static_cast<uint8_t>(duration_ms >> 8);
+    out[6] = mode;
+    out[7] = checks;
+    out[8] = passed;
+    out[9] = failed;
+    out[10] = timed_out;
+    for (size_t i = 0; i < 8; ++i) {
+      out[11 + 2 * i] = static_cast<uint8_t>(static_cast<uint16_t>(value[i]));
+      out[12 + 2 * i] = static_cast<uint8_t>(static_cast<uint16_t>(value[i]) >> 8);
+    }
+    return kEncodedSize;
+  }
+};
+
+static_assert(SelfTestReport::kEncodedSize == 27, "SelfTestReport layout");
+
+struct ThermistorCal {
+  static constexpr uint8_t kId = 7;
+  static constexpr uint8_t kVersion = 1;
+  static constexpr size_t kEncodedSize = 16;
+  static constexpr size_t kOffset_sh_a = 0;
+  static constexpr size_t kOffset_sh_b = 4;
+  static constexpr size_t kOffset_sh_c = 8;
+  static constexpr size_t kOffset_r_fixed_ohm = 12;
+
+  /// Encoded size written by a given schema version of this record.
+  static constexpr size_t encoded_size(uint8_t version) {
+    if (version >= 1) return 16;
+    return 0;
+  }
+
+  float sh_a;
+  float sh_b;
+  float sh_c;
+  float r_fixed_ohm;
+
+  /// Writes kEncodedSize bytes; returns 0 if `cap` is too small.
+  size_t encode(uint8_t* out, size_t cap) const {
+    if (cap < kEncodedSize) return 0;
+    {
+      uint32_t bits;
+      memcpy(&bits, &sh_a, 4);
+      out[0] = static_cast<uint8_t>(bits);
+      out[1] = static_cast<uint8_t>(bits >> 8);
+      out[2] = static_cast<uint8_t>(bits >> 16);
+      out[3] = static_cast<uint8_t>(bits >> 24);
+    }
+    {
+      uint32_t bits;
+      memcpy(&bits, &sh_b, 4);
+      out[4] = static_cast<uint8_t>(bits);
+      out[5] = static_cast<uint8_t>(bits >> 8);
+      out[6] = static_cast<uint8_t>(bits >> 16);
+      out[7] = static_cast<uint8_t>(bits >> 24);
+    }
+    {
+      uint32_t bits;
+      memcpy(&bits, &sh_c, 4);
+      out[8] = static_cast<uint8_t>(bits);
+      out[9] = static_cast<uint8_t>(bits >> 8);
+      out[10] = static_cast<uint8_t>(bits >> 16);
+      out[11] = static_cast<uint8_t>(bits >> 24);
+    }
+    {
+      uint32_t bits;
+      memcpy(&bits, &r_fixed_ohm, 4);
+      out[12] = static_cast<uint8_t>(bits);
+      out[13] = static_cast<uint8_t>(bits >> 8);
+      out[14] = static_cast<uint8_t>(bits >> 16);
+      out[15] = static_cast<uint8_t>(bits >> 24);
+    }
+    return kEncodedSize;
+  }
+};
+
+static_assert(ThermistorCal::kEncodedSize == 16, "ThermistorCal layout");
+
+struct CutCommand {
+  static constexpr uint8_t kId = 8;
+  static constexpr uint8_t kVersion = 1;
+  static constexpr size_t kEncodedSize = 17;
+  static constexpr size_t kOffset_unit_id = 0;
+  static constexpr size_t kOffset_counter = 4;
+  static constexpr size_t kOffset_action = 8;
+  static constexpr size_t kOffset_tag = 9;
+
+  /// Encoded size written by a given schema version of this record.
+  static constexpr size_t encoded_size(uint8_t version) {
+    if (version >= 1) return 17;
+    return 0;
+  }
+
+  uint32_t unit_id;
+  uint32_t counter;
+  uint8_t action;
+  uint64_t tag;
+
+  /// Writes kEncodedSize bytes; returns 0 if `cap` is too small.
+  size_t encode(uint8_t* out, size_t cap) const {
+    if (cap < kEncodedSize) return 0;
+    out[0] = static_cast<uint8_t>(unit_id);
+    out[1] = static_cast<uint8_t>(unit_id >> 8);
+    out[2] = static_cast<uint8_t>(unit_id >> 16);
+    out[3] = static_cast<uint8_t>(unit_id >> 24);
+    out[4] = static_cast<uint8_t>(counter);
+    out[5] = static_cast<uint8_t>(counter >> 8);
+    out[6] = static_cast<uint8_t>(counter >> 16);
+    out[7] = static_cast<uint8_t>(counter >> 24);
+    out[8] = action;
+    out[9] = static_cast<uint8_t>(tag);
+    out[10] = static_cast<uint8_t>(tag >> 8);
+    out[11] = static_cast<uint8_t>(tag >> 16);
+    out[12] = static_cast<uint8_t>(tag >> 24);
+    out[13] = static_cast<uint8_t>(tag >> 32);
+    out[14] = static_cast<uint8_t>(tag >> 40);
+    out[15] = static_cast<uint8_t>(tag >> 48);
+    out[16] = static_cast<uint8_t>(tag >> 56);
+    return kEncodedSize;
+  }
+};
+
+static_assert(CutCommand::kEncodedSize == 17, "CutCommand layout");
+
+struct CutAck {
+  static constexpr uint8_t kId = 9;
+  static constexpr uint8_t kVersion = 1;
+  static constexpr size_t kEncodedSize = 18;
+  static constexpr size_t kOffset_time_ms = 0;
+  static constexpr size_t kOffset_counter = 4;
+  static constexpr size_t kOffset_result = 8;
+  static constexpr size_t kOffset_burn_state = 9;
+  static constexpr size_t kOffset_auth_us = 10;
+  static constexpr size_t kOffset_gate_us = 12;
+  static constexpr size_t kOffset_current_us = 14;
+
+  /// Encoded size written by a given schema version of this record.
+  static constexpr size_t encoded_size(uint8_t version) {
+    if (version >= 1) return 18;
+    return 0;
+  }
+
+  uint32_t time_ms;
+  uint32_t counter;
+  uint8_t result;
+  uint8_t burn_state;
+  uint16_t auth_us;
+  uint16_t gate_us;
+  uint32_t current_us;
+
+  /// Writes kEncodedSize bytes; returns 0 if `cap` is too small.
+  size_t encode(uint8_t* out, size_t cap) const {
+    if (cap < kEncodedSize) return 0;
+    out[0] = static_cast<uint8_t>(time_ms);
+    out[1] = static_cast<uint8_t>(time_ms >> 8);
+    out[2] = static_cast<uint8_t>(time_ms >> 16);
+    out[3] = static_cast<uint8_t>(time_ms >> 24);
+    out[4] = static_cast<uint8_t>(counter);
+    out[5] = static_cast<uint8_t>(counter >> 8);
+    out[6] = static_cast<uint8_t>(counter >> 16);
+    out[7] = static_cast<uint8_t>(counter >> 24);
+    out[8] = result;
+    out[9] = burn_state;
+    out[10] = static_cast<uint8_t>(auth_us);
+    out[11] = static_cast<uint8_t>(auth_us >> 8);
+    out[12] = static_cast<uint8_t>(gate_us);
+    out[13] = static_cast<uint8_t>(gate_us >> 8);
+    out[14] = static_cast<uint8_t>(current_us);
+    out[15] = static_cast<uint8_t>(current_us >> 8);
+    out[16] = static_cast<uint8_t>(current_us >> 16);
+    out[17] = static_cast<uint8_t>(current_us >> 24);
+    return kEncodedSize;
+  }
+};
+
+static_assert(CutAck::kEncodedSize == 18, "CutAck layout");
+
+}  // namespace skyguard::records
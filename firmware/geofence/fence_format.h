@@ -0,0 +1,94 @@
+// Binary fence image produced by the ground fence compiler and evaluated in
+// place on board.
+//
+// Layout (little endian, every section 4-byte aligned):
+//   FenceImageHeader
+//   FenceRecord[fence_count]
+//   per fence: vertices (int32 lat_e7, lon_e7 pairs), cell words, edge list,
+//              optional distance raster (FenceSdfHeader + int16 samples)
+//
+// Each fence is a simple polygon with an implicit closing edge. Its bounding
+// box is cut into a grid_w x grid_h grid. A cell word holds kCellBoundary
+// if any edge touches the cell, kCellRefInside if the cell's south-west
+// corner is inside, and in its low bits the start of the cell's run in the
+// uint16 edge list (the run ends where the next cell's begins; there is one
+// extra word at the end). A point in an interior or exterior cell is
+// classified by the flag alone; in a boundary cell by the corner's status
+// and the parity of crossings of the corner-to-point segment with the
+// cell's edges.
+//
+// The optional raster samples the signed distance to the boundary (negative
+// inside) on a regular lattice covering the bounding box plus margin_m.
+// Distances use a local equirectangular metric with the fence's own
+// lon_metres_per_e7. Bilinear interpolation is within max_error_m of the
+// true distance, so beyond that the sign is certain and nearer the
+// evaluator measures the edges directly.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace skyguard::geofence {
+
+constexpr uint32_t kFenceMagic = 0x4E464753;  // "SGFN"
+constexpr uint16_t kFenceFormatVersion = 2;
+constexpr uint32_t kMaxFenceVertices = 65535;
+// Bounds the extent of one fence so orientation tests fit in int64.
+constexpr int32_t kMaxFenceSpanE7 = 900000000;
+// Spherical metres per 1e-7 degree of latitude.
+constexpr float kMetresPerLatE7 = 0.0111195080f;
+
+constexpr uint32_t kCellBoundary = 1u << 31;
+constexpr uint32_t kCellRefInside = 1u << 30;
+constexpr uint32_t kCellIndexMask = kCellRefInside - 1;
+
+enum class FenceKind : uint8_t {
+  kKeepOut = 0,  // restricted inside
+  kKeepIn = 1,   // restricted outside
+};
+
+struct FenceImageHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t fence_count;
+  uint32_t image_size;  // bytes, including this header
+  uint32_t crc32;       // CRC-32 of bytes [sizeof(header), image_size)
+};
+static_assert(sizeof(FenceImageHeader) == 16, "fence header layout");
+
+struct FenceRecord {
+  uint8_t kind;  // FenceKind
+  uint8_t reserved;
+  uint16_t id;   // source feature number
+  uint32_t vertex_offset;  // bytes from image start
+  uint32_t vertex_count;
+  int32_t min_lat_e7;
+  int32_t min_lon_e7;
+  int32_t max_lat_e7;
+  int32_t max_lon_e7;
+  uint32_t cell_offset;       // grid_w * grid_h + 1 uint32 words
+  uint32_t edge_list_offset;  // uint16 edge indices
+  uint16_t grid_w;
+  uint16_t grid_h;
+  uint32_t cell_h_e7;  // cell size in latitude
+  uint32_t cell_w_e7;  // cell size in longitude
+  uint32_t max_cell_edges;  // worst-case edges tested for a point in this fence
+  uint32_t sdf_offset;      // FenceSdfHeader, or 0 without a raster
+};
+static_assert(sizeof(FenceRecord) == 56, "fence record layout");
+
+struct FenceSdfHeader {
+  int32_t origin_lat_e7;  // sample (0, 0)
+  int32_t origin_lon_e7;
+  uint32_t step_lat_e7;
+  uint32_t step_lon_e7;
+  uint16_t cols;
+  uint16_t rows;  // rows * cols int16 samples follow, row-major from south
+  float metres_per_unit;
+  float lon_metres_per_e7;
+  float margin_m;     // raster extends this far beyond the bounding box
+  float max_error_m;  // interpolation plus quantisation error bound
+};
+static_assert(sizeof(FenceSdfHeader) == 36, "fence raster layout");
+
+}  // namespace skyguard::geofence
@@ -0,0 +1,419 @@
+#include "geofence/fence_set.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "util/crc32.h"
+
+namespace skyguard::geofence {
+
+namespace {
+
+// Orientation of c relative to a->b; zero counts as positive (a fixed
+// symbolic perturbation), so degenerate touches never split parity.
+bool left_of(int32_t a_lat, int32_t a_lon, int32_t b_lat, int32_t b_lon, int32_t c_lat,
+             int32_t c_lon) {
+  int64_t cross = (static_cast<int64_t>(b_lon) - a_lon) * (static_cast<int64_t>(c_lat) - a_lat) -
+                  (static_cast<int64_t>(b_lat) - a_lat) * (static_cast<int64_t>(c_lon) - a_lon);
+  return cross >= 0;
+}
+
+float lon_scale_at(int64_t lat_e7) {
+  return kMetresPerLatE7 * cosf(static_cast<float>(lat_e7) * 1e-7f * 0.017453293f);
+}
+
+// Squared distance from the origin to segment (ax, ay)-(bx, by), metres.
+float segment_distance2(float ax, float ay, float bx, float by) {
+  float dx = bx - ax, dy = by - ay;
+  float len2 = dx * dx + dy * dy;
+  float t = len2 > 0 ? -(ax * dx + ay * dy) / len2 : 0;
+  t = t < 0 ? 0 : (t > 1 ? 1 : t);
+  float x = ax + t * dx, y = ay + t * dy;
+  return x * x + y * y;
+}
+
+bool sdf_valid(const FenceSdfHeader& h, uint32_t offset, uint32_t image_size) {
+  return !(offset & 3) && offset + sizeof(FenceSdfHeader) <= image_size && h.cols >= 2 &&
+         h.rows >= 2 && h.step_lat_e7 && h.step_lon_e7 && h.metres_per_unit > 0 &&
+         h.lon_metres_per_e7 > 0 &&
+         offset + sizeof(FenceSdfHeader) + 2ull * h.cols * h.rows <= image_size;
+}
+
+// Edge-list indices fetched per read on paged images.
+constexpr uint32_t kEdgeChunk = 32;
+
+// Image access for the lookup code, instantiated twice so that a mapped
+// image costs plain pointer arithmetic and only paged images pay for
+// copies. get() returns `n` Ts at `offset`; a failed read returns zeros
+// and counts an error, which marks the lookup's answer invalid.
+struct MappedAccess {
+  const uint8_t* base;
+  template <class T>
+  const T* get(uint32_t offset, uint32_t, T*) const {
+    return reinterpret_cast<const T*>(base + offset);
+  }
+};
+
+struct PagedAccess {
+  const storage::DataView* view;
+  uint32_t* errors;
+  template <class T>
+  const T* get(uint32_t offset, uint32_t n, T* scratch) const {
+    if (!view->read(offset, scratch, n * sizeof(T))) {
+      ++*errors;
+      memset(scratch, 0, n * sizeof(T));
+    }
+    return scratch;
+  }
+};
+
+template <class Access>
+bool contains_in(const Access& img, const FenceRecord& r, int32_t lat_e7, int32_t lon_e7,
+                 uint32_t* edges) {
+  if (lat_e7 < r.min_lat_e7 || lat_e7 > r.max_lat_e7 || lon_e7 < r.min_lon_e7 ||
+      lon_e7 > r.max_lon_e7) {
+    return false;
+  }
+  uint32_t gx = static_cast<uint32_t>(static_cast<int64_t>(lon_e7) - r.min_lon_e7) / r.cell_w_e7;
+  uint32_t gy = static_cast<uint32_t>(static_cast<int64_t>(lat_e7) - r.min_lat_e7) / r.cell_h_e7;
+  if (gx >= r.grid_w) gx = r.grid_w - 1u;
+  if (gy >= r.grid_h) gy = r.grid_h - 1u;
+  uint32_t cell_buf[2];
+  const uint32_t* cw = img.get(r.cell_offset + 4 * (gy * r.grid_w + gx), 2, cell_buf);
+  bool inside = cw[0] & kCellRefInside;
+  if (!(cw[0] & kCellBoundary)) return inside;
+
+  int32_t ref_lat = r.min_lat_e7 + static_cast<int32_t>(gy * r.cell_h_e7);
+  int32_t ref_lon = r.min_lon_e7 + static_cast<int32_t>(gx * r.cell_w_e7);
+  uint32_t begin = cw[0] & kCellIndexMask;
+  uint32_t end = cw[1] & kCellIndexMask;
+  uint16_t list_buf[kEdgeChunk];
+  int32_t a_buf[2], b_buf[2];
+  for (uint32_t k = begin; k < end; k += kEdgeChunk) {
+    uint32_t n = end - k < kEdgeChunk ? end - k : kEdgeChunk;
+    const uint16_t* list = img.get(r.edge_list_offset + 2 * k, n, list_buf);
+    for (uint32_t j = 0; j < n; ++j) {
+      uint32_t a = list[j];
+      uint32_t b = a + 1 == r.vertex_count ? 0 : a + 1;
+      const int32_t* va = img.get(r.vertex_offset + 8 * a, 2, a_buf);
+      const int32_t* vb = img.get(r.vertex_offset + 8 * b, 2, b_buf);
+      if (segments_cross(ref_lat, ref_lon, lat_e7, lon_e7, va[0], va[1], vb[0], vb[1])) {
+        inside = !inside;
+      }
+    }
+  }
+  if (edges) *edges += end - begin;
+  return inside;
+}
+
+template <class Access>
+float edge_distance_in(const Access& img, const FenceRecord& r, int32_t lat_e7, int32_t lon_e7,
+                       float lon_scale, float radius_m) {
+  // Only cells within radius_m can hold an edge that near; radius_m <= 0
+  // means the whole grid.
+  uint32_t gx0 = 0, gy0 = 0, gx1 = r.grid_w - 1u, gy1 = r.grid_h - 1u;
+  if (radius_m > 0) {
+    int64_t dlat = static_cast<int64_t>(radius_m / kMetresPerLatE7) + 1;
+    int64_t dlon = static_cast<int64_t>(radius_m / lon_scale) + 1;
+    auto span = [](int64_t lo, int64_t hi, int32_t origin, uint32_t size, uint32_t n,
+                   uint32_t* first, uint32_t* last) {
+      lo = (lo - origin) / static_cast<int64_t>(size);
+      hi = (hi - origin) / static_cast<int64_t>(size);
+      if (hi < 0 || lo >= n) return false;
+      *first = lo < 0 ? 0 : static_cast<uint32_t>(lo);
+      *last = hi >= n ? n - 1 : static_cast<uint32_t>(hi);
+      return true;
+    };
+    if (!span(lon_e7 - dlon, lon_e7 + dlon, r.min_lon_e7, r.cell_w_e7, r.grid_w, &gx0, &gx1) ||
+        !span(lat_e7 - dlat, lat_e7 + dlat, r.min_lat_e7, r.cell_h_e7, r.grid_h, &gy0, &gy1)) {
+      return INFINITY;
+    }
+  }
+
+  float best2 = INFINITY;
+  int32_t a_buf[2], b_buf[2];
+  auto measure = [&](uint32_t a) {
+    uint32_t b = a + 1 == r.vertex_count ? 0 : a + 1;
+    const int32_t* va = img.get(r.vertex_offset + 8 * a, 2, a_buf);
+    const int32_t* vb = img.get(r.vertex_offset + 8 * b, 2, b_buf);
+    float ax = static_cast<float>(static_cast<int64_t>(va[1]) - lon_e7) * lon_scale;
+    float ay = static_cast<float>(static_cast<int64_t>(va[0]) - lat_e7) * kMetresPerLatE7;
+    float bx = static_cast<float>(static_cast<int64_t>(vb[1]) - lon_e7) * lon_scale;
+    float by = static_cast<float>(static_cast<int64_t>(vb[0]) - lat_e7) * kMetresPerLatE7;
+    float d2 = segment_distance2(ax, ay, bx, by);
+    if (d2 < best2) best2 = d2;
+  };
+  if (radius_m <= 0) {
+    for (uint32_t a = 0; a < r.vertex_count; ++a) measure(a);
+  } else {
+    uint32_t cell_buf[2];
+    uint16_t list_buf[kEdgeChunk];
+    for (uint32_t gy = gy0; gy <= gy1; ++gy) {
+      for (uint32_t gx = gx0; gx <= gx1; ++gx) {
+        const uint32_t* cw = img.get(r.cell_offset + 4 * (gy * r.grid_w + gx), 2, cell_buf);
+        uint32_t end = cw[1] & kCellIndexMask;
+        for (uint32_t k = cw[0] & kCellIndexMask; k < end; k += kEdgeChunk) {
+          uint32_t n = end - k < kEdgeChunk ? end - k : kEdgeChunk;
+          const uint16_t* list = img.get(r.edge_list_offset + 2 * k, n, list_buf);
+          for (uint32_t j = 0; j < n; ++j) measure(list[j]);
+        }
+      }
+    }
+  }
+  return sqrtf(best2);
+}
+
+template <class Access>
+float lon_scale_of(const Access& img, const FenceRecord& r) {
+  FenceSdfHeader buf;
+  return r.sdf_offset ? img.get(r.sdf_offset, 1, &buf)->lon_metres_per_e7
+                      : lon_scale_at((static_cast<int64_t>(r.min_lat_e7) + r.max_lat_e7) / 2);
+}
+
+template <class Access>
+FenceDistance distance_in(const Access& img, const FenceRecord& r, int32_t lat_e7,
+                          int32_t lon_e7) {
+  if (!r.sdf_offset) {
+    float d = edge_distance_in(img, r, lat_e7, lon_e7, lon_scale_of(img, r), 0);
+    return {contains_in(img, r, lat_e7, lon_e7, nullptr) ? -d : d, true, false, true};
+  }
+  FenceSdfHeader h_buf;
+  const FenceSdfHeader& h = *img.get(r.sdf_offset, 1, &h_buf);
+
+  // Position in sample units; beyond the raster only a bound is known.
+  float fx = static_cast<float>(static_cast<int64_t>(lon_e7) - h.origin_lon_e7) /
+             static_cast<float>(h.step_lon_e7);
+  float fy = static_cast<float>(static_cast<int64_t>(lat_e7) - h.origin_lat_e7) /
+             static_cast<float>(h.step_lat_e7);
+  float max_x = static_cast<float>(h.cols - 1), max_y = static_cast<float>(h.rows - 1);
+  if (fx < 0 || fy < 0 || fx > max_x || fy > max_y) {
+    float ex = fx < 0 ? -fx : (fx > max_x ? fx - max_x : 0);
+    float ey = fy < 0 ? -fy : (fy > max_y ? fy - max_y : 0);
+    ex *= static_cast<float>(h.step_lon_e7) * h.lon_metres_per_e7;
+    ey *= static_cast<float>(h.step_lat_e7) * kMetresPerLatE7;
+    return {sqrtf(ex * ex + ey * ey) + h.margin_m, false, true, true};
+  }
+
+  uint32_t x0 = static_cast<uint32_t>(fx), y0 = static_cast<uint32_t>(fy);
+  if (x0 >= h.cols - 1u) x0 = h.cols - 2u;
+  if (y0 >= h.rows - 1u) y0 = h.rows - 2u;
+  float tx = fx - static_cast<float>(x0), ty = fy - static_cast<float>(y0);
+  uint32_t at = r.sdf_offset + static_cast<uint32_t>(sizeof(FenceSdfHeader)) +
+                2 * (y0 * static_cast<uint32_t>(h.cols) + x0);
+  int16_t s_buf[2], n_buf[2];
+  const int16_t* s = img.get(at, 2, s_buf);
+  const int16_t* n = img.get(at + 2 * h.cols, 2, n_buf);
+  float south = s[0] + (s[1] - s[0]) * tx;
+  float north = n[0] + (n[1] - n[0]) * tx;
+  float d = (south + (north - south) * ty) * h.metres_per_unit;
+  if (fabsf(d) >= h.max_error_m) return {d, false, false, true};
+
+  // Within the error band the true boundary is at most 2 * max_error_m away.
+  float exact = edge_distance_in(img, r, lat_e7, lon_e7, h.lon_metres_per_e7, 2 * h.max_error_m);
+  if (exact == INFINITY) return {d, false, false, true};
+  return {contains_in(img, r, lat_e7, lon_e7, nullptr) ? -exact : exact, true, false, true};
+}
+
+}  // namespace
+
+bool segments_cross(int32_t p0_lat, int32_t p0_lon, int32_t p1_lat, int32_t p1_lon,
+                    int32_t a_lat, int32_t a_lon, int32_t b_lat, int32_t b_lon) {
+  return left_of(p0_lat, p0_lon, p1_lat, p1_lon, a_lat, a_lon) !=
+             left_of(p0_lat, p0_lon, p1_lat, p1_lon, b_lat, b_lon) &&
+         left_of(a_lat, a_lon, b_lat, b_lon, p0_lat, p0_lon) !=
+             left_of(a_lat, a_lon, b_lat, b_lon, p1_lat, p1_lon);
+}
+
+FenceError FenceSet::bind(const uint8_t* image, size_t len) {
+  return bind(storage::DataView::mapped(image, len > UINT32_MAX ? UINT32_MAX
+                                                                 : static_cast<uint32_t>(len)));
+}
+
+FenceError FenceSet::bind(const storage::DataView& image) {
+  image_ = storage::DataView();
+  records_ = nullptr;
+  count_ = 0;
+  read_errors_ = 0;
+  FenceImageHeader h;
+  if (image.size() < sizeof(h) || !image.load(0, &h)) return FenceError::kTooSmall;
+  if (reinterpret_cast<uintptr_t>(image.data()) & 3) return FenceError::kMisaligned;
+  if (h.magic != kFenceMagic) return FenceError::kBadMagic;
+  if (h.version != kFenceFormatVersion) return FenceError::kBadVersion;
+  if (h.image_size > image.size() ||
+      h.image_size < sizeof(FenceImageHeader) + h.fence_count * sizeof(FenceRecord)) {
+    return FenceError::kBadSize;
+  }
+  uint32_t crc;
+  if (!image.crc32(sizeof(h), h.image_size - sizeof(h), &crc) || crc != h.crc32) {
+    return FenceError::kBadCrc;
+  }
+
+  bool keep_in = false;
+  for (size_t i = 0; i < h.fence_count; ++i) {
+    FenceRecord r;
+    if (!image.load(static_cast<uint32_t>(sizeof(h) + i * sizeof(r)), &r)) {
+      return FenceError::kBadRecord;
+    }
+    uint64_t cells = static_cast<uint64_t>(r.grid_w) * r.grid_h + 1;
+    if (r.kind > static_cast<uint8_t>(FenceKind::kKeepIn) || r.vertex_count < 3 ||
+        r.vertex_count > kMaxFenceVertices || r.grid_w == 0 || r.grid_h == 0 ||
+        r.cell_w_e7 == 0 || r.cell_h_e7 == 0 || r.max_lat_e7 < r.min_lat_e7 ||
+        r.max_lon_e7 < r.min_lon_e7 ||
+        static_cast<int64_t>(r.max_lat_e7) - r.min_lat_e7 > kMaxFenceSpanE7 ||
+        static_cast<int64_t>(r.max_lon_e7) - r.min_lon_e7 > kMaxFenceSpanE7 ||
+        ((r.vertex_offset | r.cell_offset | r.edge_list_offset) & 3) ||
+        r.vertex_offset + 8ull * r.vertex_count > h.image_size ||
+        r.cell_offset + 4 * cells > h.image_size || r.edge_list_offset > h.image_size) {
+      return FenceError::kBadRecord;
+    }
+    uint32_t last;
+    if (!image.load(static_cast<uint32_t>(r.cell_offset + 4 * (cells - 1)), &last) ||
+        r.edge_list_offset + 2ull * (last & kCellIndexMask) > h.image_size) {
+      return FenceError::kBadRecord;
+    }
+    FenceSdfHeader sdf;
+    if (r.sdf_offset && (r.sdf_offset + sizeof(FenceSdfHeader) > h.image_size ||
+                         !image.load(r.sdf_offset, &sdf) ||
+                         !sdf_valid(sdf, r.sdf_offset, h.image_size))) {
+      return FenceError::kBadRecord;
+    }
+    keep_in |= r.kind == static_cast<uint8_t>(FenceKind::kKeepIn);
+    if (i < kRamBounds) {
+      // Interpolated and beyond-raster distances may undershoot the box
+      // distance by the raster's error and margin.
+      float lon_scale = r.sdf_offset
+                            ? sdf.lon_metres_per_e7
+                            : lon_scale_at((static_cast<int64_t>(r.min_lat_e7) + r.max_lat_e7) / 2);
+      float slack = r.sdf_offset ? sdf.max_error_m + sdf.margin_m + 1 : 1;
+      bounds_[i] = {r.min_lat_e7, r.min_lon_e7, r.max_lat_e7, r.max_lon_e7, lon_scale, slack,
+                    r.kind};
+    }
+  }
+
+  image_ = image;
+  if (image.is_mapped()) {
+    records_ = reinterpret_cast<const FenceRecord*>(image.data() + sizeof(FenceImageHeader));
+  }
+  count_ = h.fence_count;
+  has_keep_in_ = keep_in;
+  return FenceError::kNone;
+}
+
+FenceRecord FenceSet::record(size_t i) const {
+  if (records_) return records_[i];
+  FenceRecord r;
+  if (!image_.load(static_cast<uint32_t>(sizeof(FenceImageHeader) + i * sizeof(r)), &r)) {
+    ++read_errors_;
+    r = FenceRecord{};  // empty bounding box; the lookup reports invalid
+    r.min_lat_e7 = r.min_lon_e7 = 1;
+  }
+  return r;
+}
+
+bool FenceSet::contains(size_t i, int32_t lat_e7, int32_t lon_e7, uint32_t* edges) const {
+  if (records_) {
+    return contains_in(MappedAccess{image_.data()}, records_[i], lat_e7, lon_e7, edges);
+  }
+  return contains_in(PagedAccess{&image_, &read_errors_}, record(i), lat_e7, lon_e7, edges);
+}
+
+float FenceSet::box_distance_m(size_t i, int32_t lat_e7, int32_t lon_e7) const {
+  const Bounds& b = bounds_[i];
+  int64_t dlat = lat_e7 < b.min_lat_e7   ? int64_t{b.min_lat_e7} - lat_e7
+                 : lat_e7 > b.max_lat_e7 ? int64_t{lat_e7} - b.max_lat_e7
+                                         : 0;
+  int64_t dlon = lon_e7 < b.min_lon_e7   ? int64_t{b.min_lon_e7} - lon_e7
+                 : lon_e7 > b.max_lon_e7 ? int64_t{lon_e7} - b.max_lon_e7
+                                         : 0;
+  float y = static_cast<float>(dlat) * kMetresPerLatE7;
+  float x = static_cast<float>(dlon) * b.lon_scale;
+  return sqrtf(x * x + y * y);
+}
+
+FenceCheck FenceSet::check(int32_t lat_e7, int32_t lon_e7) const {
+  FenceCheck c{false, -1, has_keep_in_, 0, true};
+  uint32_t errors = read_errors_;
+  for (size_t i = 0; i < count_; ++i) {
+    // Outside its box a fence cannot change the result.
+    if (i < kRamBounds &&
+        (lat_e7 < bounds_[i].min_lat_e7 || lat_e7 > bounds_[i].max_lat_e7 ||
+         lon_e7 < bounds_[i].min_lon_e7 || lon_e7 > bounds_[i].max_lon_e7)) {
+      continue;
+    }
+    FenceRecord loaded;
+    const FenceRecord& r = records_ ? records_[i] : (loaded = record(i));
+    bool in = records_ ? contains_in(MappedAccess{image_.data()}, r, lat_e7, lon_e7,
+                                     &c.edges_tested)
+                       : contains_in(PagedAccess{&image_, &read_errors_}, r, lat_e7, lon_e7,
+                                     &c.edges_tested);
+    if (r.kind == static_cast<uint8_t>(FenceKind::kKeepIn)) {
+      if (in) c.outside_keep_in = false;
+    } else if (in && c.fence < 0) {
+      c.fence = static_cast<int16_t>(i);
+    }
+  }
+  c.violation = c.fence >= 0 || c.outside_keep_in;
+  c.valid = read_errors_ == errors;
+  return c;
+}
+
+const int32_t* FenceSet::vertices(size_t i) const {
+  return records_ ? reinterpret_cast<const int32_t*>(image_.data() + records_[i].vertex_offset)
+                  : nullptr;
+}
+
+const FenceSdfHeader* FenceSet::raster(size_t i) const {
+  return records_ && records_[i].sdf_offset
+             ? reinterpret_cast<const FenceSdfHeader*>(image_.data() + records_[i].sdf_offset)
+             : nullptr;
+}
+
+float FenceSet::lon_metres_per_e7(size_t i) const {
+  if (records_) return lon_scale_of(MappedAccess{image_.data()}, records_[i]);
+  return lon_scale_of(PagedAccess{&image_, &read_errors_}, record(i));
+}
+
+FenceDistance FenceSet::distance(size_t i, int32_t lat_e7, int32_t lon_e7) const {
+  if (records_) return distance_in(MappedAccess{image_.data()}, records_[i], lat_e7, lon_e7);
+  uint32_t errors = read_errors_;
+  FenceDistance d = distance_in(PagedAccess{&image_, &read_errors_}, record(i), lat_e7, lon_e7);
+  d.valid = read_errors_ == errors;
+  return d;
+}
+
+float FenceSet::margin_m(int32_t lat_e7, int32_t lon_e7) const {
+  // The nearest box first, then the rest. A fence whose box, less its
+  // slack, is already farther than the best answer of its kind cannot
+  // change that answer.
+  size_t boxed = count_ < kRamBounds ? count_ : kRamBounds;
+  float lower[kRamBounds];
+  size_t nearest = 0;
+  for (size_t i = 0; i < boxed; ++i) {
+    float d = box_distance_m(i, lat_e7, lon_e7) - bounds_[i].slack_m;
+    lower[i] = d > 0 ? d : 0;
+    if (lower[i] < lower[nearest]) nearest = i;
+  }
+
+  float keep_out = INFINITY, keep_in = -INFINITY;
+  uint32_t errors = read_errors_;
+  for (size_t k = 0; k < count_; ++k) {
+    size_t i = k == 0 ? nearest : (k == nearest ? 0 : k);
+    if (i < boxed) {
+      bool boxed_keep_in = bounds_[i].kind == static_cast<uint8_t>(FenceKind::kKeepIn);
+      if (boxed_keep_in ? -lower[i] <= keep_in : lower[i] >= keep_out) continue;
+    }
+    FenceRecord loaded;
+    const FenceRecord& r = records_ ? records_[i] : (loaded = record(i));
+    float d = records_ ? distance_in(MappedAccess{image_.data()}, r, lat_e7, lon_e7).metres
+                       : distance_in(PagedAccess{&image_, &read_errors_}, r, lat_e7, lon_e7).metres;
+    if (r.kind == static_cast<uint8_t>(FenceKind::kKeepIn)) {
+      if (-d > keep_in) keep_in = -d;
+    } else if (d < keep_out) {
+      keep_out = d;
+    }
+  }
+  if (read_errors_ != errors) return NAN;
+  return has_keep_in_ && keep_in < keep_out ? keep_in : keep_out;
+}
+
+}  // namespace skyguard::geofence
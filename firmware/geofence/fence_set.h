@@ -0,0 +1,107 @@
+// On-board evaluation of a fence image (see fence_format.h).
+//
+// The image is read in place through a storage::DataView: bind() validates
+// it once and lookups touch only the fence record, one cell word and that
+// cell's edges. Longitudes are not wrapped, so fences must not straddle
+// the antimeridian.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "geofence/fence_format.h"
+#include "storage/data_view.h"
+
+namespace skyguard::geofence {
+
+enum class FenceError : uint8_t {
+  kNone,
+  kTooSmall,
+  kMisaligned,
+  kBadMagic,
+  kBadVersion,
+  kBadSize,
+  kBadCrc,
+  kBadRecord,
+};
+
+struct FenceCheck {
+  bool violation;
+  int16_t fence;          // keep-out fence containing the point, or -1
+  bool outside_keep_in;   // keep-in fences exist and none contains the point
+  uint32_t edges_tested;  // evaluation cost of this check
+  bool valid;             // false if a flash read failed: the answer is unknown
+};
+
+struct FenceDistance {
+  float metres;      // signed distance to the boundary, negative inside
+  bool exact;        // measured from the edges rather than the raster
+  bool lower_bound;  // beyond the raster: the true distance is at least this
+  bool valid;        // false if a flash read failed: the answer is unknown
+};
+
+/// The first this many fences keep their bounding boxes in RAM, so lookups
+/// only read the records of fences near the fix.
+constexpr size_t kRamBounds = 128;
+
+class FenceSet {
+ public:
+  /// Validates and adopts `image`, which must stay unchanged while bound.
+  /// A mapped image must be 4-byte aligned.
+  FenceError bind(const storage::DataView& image);
+  /// Binds an image in memory.
+  FenceError bind(const uint8_t* image, size_t len);
+
+  size_t count() const { return count_; }
+  FenceRecord record(size_t i) const;
+  /// In-place vertex and raster data; nullptr unless the image is mapped
+  /// (or fence i has no raster).
+  const int32_t* vertices(size_t i) const;
+  const FenceSdfHeader* raster(size_t i) const;
+  /// East-west scale of fence i's distance metric.
+  float lon_metres_per_e7(size_t i) const;
+
+  /// Point-in-polygon for one fence; adds the edges tested to `*edges`.
+  bool contains(size_t i, int32_t lat_e7, int32_t lon_e7, uint32_t* edges = nullptr) const;
+
+  /// Inside any keep-out, or outside every keep-in when there are any.
+  FenceCheck check(int32_t lat_e7, int32_t lon_e7) const;
+
+  /// Signed distance to fence i. Constant time with a raster: interpolated
+  /// where that is within max_error_m, otherwise measured against the edges
+  /// of the nearby cells. Without a raster every edge is measured.
+  FenceDistance distance(size_t i, int32_t lat_e7, int32_t lon_e7) const;
+
+  /// Distance to the nearest violation: positive while clear, negative in
+  /// violation (depth into a keep-out, or out of the nearest keep-in).
+  /// NaN if a flash read failed, so no answer is given for that fix.
+  float margin_m(int32_t lat_e7, int32_t lon_e7) const;
+
+  /// Device reads that failed on a paged image since bind(). The lookups
+  /// that saw one return valid = false (NaN from margin_m()).
+  uint32_t read_errors() const { return read_errors_; }
+
+ private:
+  storage::DataView image_;
+  const FenceRecord* records_ = nullptr;  // in place when mapped
+  size_t count_ = 0;
+  bool has_keep_in_ = false;
+  mutable uint32_t read_errors_ = 0;
+
+  struct Bounds {
+    int32_t min_lat_e7, min_lon_e7, max_lat_e7, max_lon_e7;
+    float lon_scale;  // the fence's distance metric
+    float slack_m;    // how far distance() may read below the box distance
+    uint8_t kind;
+  };
+  float box_distance_m(size_t i, int32_t lat_e7, int32_t lon_e7) const;
+  Bounds bounds_[kRamBounds] = {};
+};
+
+/// Whether segment (p0, p1) crosses edge (a, b), with collinear and
+/// touching cases resolved the same way everywhere so that crossing counts
+/// along any path have consistent parity. Shared with the ground compiler.
+bool segments_cross(int32_t p0_lat, int32_t p0_lon, int32_t p1_lat, int32_t p1_lon,
+                    int32_t a_lat, int32_t a_lon, int32_t b_lat, int32_t b_lon);
+
+}  // namespace skyguard::geofence
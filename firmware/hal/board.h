@@ -0,0 +1,29 @@
+// Selects the HAL backend and board pin map at build time.
+//
+// Exactly one of SKYGUARD_HAL_HOST, SKYGUARD_HAL_STM32L4 or
+// SKYGUARD_HAL_RP2040 must be defined. Each backend's board.h declares the
+// same set of types in skyguard::board:
+//
+//   BurnGateA, BurnGateB, StatusLed, ArmSense    GpioPin
+//   GpsUart, IridiumUart, ConsoleUart            Uart
+//   AdsbUart                                     Uart (ADS-B receiver; not on RP2040)
+//   RadioSpi, FlashSpi                           SpiBus
+//   SensorI2c                                    I2cBus
+//   BurnCurrentAdc, BatteryAdc, ThermistorAdc    AdcInput
+//   SystemClock                                  Clock
+//   SupplyWarning                                SupplyMonitor (brown-out warning)
+//   ConfigFlash                                  Flash (internal, config and checkpoints)
+//   DataFlash                                    ReadOnlyFlash (fences, forecast grids)
+#pragma once
+
+#include "hal/hal.h"
+
+#if defined(SKYGUARD_HAL_HOST)
+#include "hal/host/board.h"
+#elif defined(SKYGUARD_HAL_STM32L4)
+#include "hal/stm32l4/board.h"
+#elif defined(SKYGUARD_HAL_RP2040)
+#include "hal/rp2040/board.h"
+#else
+#error "Define SKYGUARD_HAL_HOST, SKYGUARD_HAL_STM32L4 or SKYGUARD_HAL_RP2040"
+#endif
@@ -0,0 +1,133 @@
+// Hardware abstraction layer interfaces.
+//
+// Each peripheral is a CRTP base that forwards to the backend's *_impl
+// members. Every call resolves at compile time and inlines into the
+// caller, so driver code written against these interfaces costs the same
+// as calling the backend directly. The backend is chosen at build time by
+// hal/board.h; drivers take the concrete peripheral type as a template
+// parameter.
+//
+// A backend peripheral provides:
+//   GpioPin:  write_impl(bool), read_impl(); optional toggle_impl()
+//   Uart:     begin_impl(baud), write_impl(p, n), read_impl(p, n), available_impl()
+//   SpiBus:   transfer_impl(tx, rx, n)             (tx or rx may be null)
+//   I2cBus:   write_read_impl(addr, tx, ntx, rx, nrx)
+//   AdcInput: read_impl(), kFullScale
+//   Clock:    now_us_impl(), delay_us_impl(us)
+//   Flash:    read_impl, program_impl, erase_sector_impl, kSectorSize, kSize,
+//             kProgramUnit, kProgramUnitMaxUs
+//   ReadOnlyFlash: map_impl(), read_impl(addr, out, n), size_impl()
+//   SupplyMonitor: enable_impl(), low_impl()
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace skyguard::hal {
+
+template <class Impl>
+class Peripheral {
+ protected:
+  Impl& impl() { return static_cast<Impl&>(*this); }
+  const Impl& impl() const { return static_cast<const Impl&>(*this); }
+};
+
+template <class Impl>
+class GpioPin : public Peripheral<Impl> {
+ public:
+  void set() { this->impl().write_impl(true); }
+  void clear() { this->impl().write_impl(false); }
+  void write(bool high) { this->impl().write_impl(high); }
+  bool read() const { return this->impl().read_impl(); }
+  void toggle() { this->impl().toggle_impl(); }
+
+  // Fallback for backends without a native toggle.
+  void toggle_impl() { write(!read()); }
+};
+
+template <class Impl>
+class Uart : public Peripheral<Impl> {
+ public:
+  bool begin(uint32_t baud) { return this->impl().begin_impl(baud); }
+  /// Non-blocking; returns the number of bytes accepted.
+  size_t write(const uint8_t* data, size_t n) { return this->impl().write_impl(data, n); }
+  /// Non-blocking; returns the number of bytes read.
+  size_t read(uint8_t* data, size_t n) { return this->impl().read_impl(data, n); }
+  size_t available() const { return this->impl().available_impl(); }
+};
+
+template <class Impl>
+class SpiBus : public Peripheral<Impl> {
+ public:
+  /// Full-duplex transfer of `n` bytes; `tx` null sends 0xFF, `rx` null
+  /// discards. Chip select belongs to the device driver.
+  bool transfer(const uint8_t* tx, uint8_t* rx, size_t n) {
+    return this->impl().transfer_impl(tx, rx, n);
+  }
+};
+
+template <class Impl>
+class I2cBus : public Peripheral<Impl> {
+ public:
+  /// Writes `ntx` bytes then reads `nrx` with a repeated start; either
+  /// count may be zero. `addr` is the 7-bit address.
+  bool write_read(uint8_t addr, const uint8_t* tx, size_t ntx, uint8_t* rx, size_t nrx) {
+    return this->impl().write_read_impl(addr, tx, ntx, rx, nrx);
+  }
+};
+
+template <class Impl>
+class AdcInput : public Peripheral<Impl> {
+ public:
+  uint16_t read() { return this->impl().read_impl(); }
+  uint16_t full_scale() const { return Impl::kFullScale; }
+};
+
+template <class Impl>
+class Clock : public Peripheral<Impl> {
+ public:
+  uint32_t now_us() const { return this->impl().now_us_impl(); }
+  void delay_us(uint32_t us) { this->impl().delay_us_impl(us); }
+};
+
+/// NOR-style flash: erased bytes read 0xFF and programming only clears
+/// bits. Addresses are offsets from the start of the region.
+template <class Impl>
+class Flash : public Peripheral<Impl> {
+ public:
+  bool read(uint32_t addr, uint8_t* out, size_t n) { return this->impl().read_impl(addr, out, n); }
+  bool program(uint32_t addr, const uint8_t* data, size_t n) {
+    return this->impl().program_impl(addr, data, n);
+  }
+  bool erase_sector(uint32_t addr) { return this->impl().erase_sector_impl(addr); }
+  uint32_t sector_size() const { return Impl::kSectorSize; }
+  uint32_t size() const { return Impl::kSize; }
+  /// Programming granule: addresses and lengths passed to program() are
+  /// multiples of it.
+  uint32_t program_unit() const { return Impl::kProgramUnit; }
+  /// Datasheet worst case for programming one unit.
+  uint32_t program_unit_max_us() const { return Impl::kProgramUnitMaxUs; }
+};
+
+/// External flash holding uploaded read-only data (see
+/// storage/data_view.h). map() is the memory-mapped window on parts that
+/// read flash in place, else nullptr and data is fetched with read().
+template <class Impl>
+class ReadOnlyFlash : public Peripheral<Impl> {
+ public:
+  const uint8_t* map() const { return this->impl().map_impl(); }
+  bool read(uint32_t addr, uint8_t* out, size_t n) { return this->impl().read_impl(addr, out, n); }
+  uint32_t size() const { return this->impl().size_impl(); }
+};
+
+/// Early warning of supply collapse (PVD, comparator or external
+/// supervisor). enable() arms its interrupt, which fires once the supply
+/// falls below the warning threshold; low() reads the present state.
+template <class Impl>
+class SupplyMonitor : public Peripheral<Impl> {
+ public:
+  void enable() { this->impl().enable_impl(); }
+  bool low() const { return this->impl().low_impl(); }
+};
+
+}  // namespace skyguard::hal
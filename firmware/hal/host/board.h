@@ -0,0 +1,36 @@
+// Host simulator board: pin, channel and bus numbers the simulator uses to
+// reach each signal through hal/host/host_hal.h.
+#pragma once
+
+#include "hal/host/host_hal.h"
+
+namespace skyguard::board {
+
+enum HostPin : uint8_t { kPinBurnGateA, kPinBurnGateB, kPinStatusLed, kPinArmSense };
+enum HostUartId : uint8_t { kUartGps, kUartIridium, kUartConsole, kUartAdsb };
+enum HostAdcId : uint8_t { kAdcBurnCurrent, kAdcBattery, kAdcThermistor };
+
+using BurnGateA = hal::host::Pin<kPinBurnGateA>;
+using BurnGateB = hal::host::Pin<kPinBurnGateB>;
+using StatusLed = hal::host::Pin<kPinStatusLed>;
+using ArmSense = hal::host::Pin<kPinArmSense>;
+
+using GpsUart = hal::host::HostUart<kUartGps>;
+using IridiumUart = hal::host::HostUart<kUartIridium>;
+using ConsoleUart = hal::host::HostUart<kUartConsole>;
+using AdsbUart = hal::host::HostUart<kUartAdsb>;
+
+using RadioSpi = hal::host::HostSpi<0>;
+using FlashSpi = hal::host::HostSpi<1>;
+using SensorI2c = hal::host::HostI2c<0>;
+
+using BurnCurrentAdc = hal::host::HostAdc<kAdcBurnCurrent>;
+using BatteryAdc = hal::host::HostAdc<kAdcBattery>;
+using ThermistorAdc = hal::host::HostAdc<kAdcThermistor>;
+
+using SystemClock = hal::host::HostClock;
+using SupplyWarning = hal::host::HostSupply;
+using ConfigFlash = hal::host::HostFlash<0, 64 * 1024, 2048>;
+using DataFlash = hal::host::HostDataFlash<0>;
+
+}  // namespace skyguard::board
@@ -0,0 +1,337 @@
+// Host backend: peripherals backed by process state that the simulator
+// reads and drives.
+//
+// The simulator sets input pins and ADC readings, feeds UART receive bytes,
+// attaches SPI/I2C device models and advances simulated time; it observes
+// output pins through pin_observer and collects UART output. The free
+// functions in this header are the "direct calls" the HAL wrappers forward
+// to.
+#pragma once
+
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <deque>
+#include <thread>
+#include <vector>
+
+#include "hal/hal.h"
+
+namespace skyguard::hal::host {
+
+constexpr size_t kMaxPins = 64;
+constexpr size_t kMaxUarts = 4;
+constexpr size_t kMaxAdcChannels = 16;
+constexpr size_t kMaxBuses = 2;
+
+// --- GPIO -----------------------------------------------------------------
+
+inline bool g_pin_level[kMaxPins];
+/// Called on every output write; the simulator uses it to timestamp
+/// actuator edges.
+inline void (*pin_observer)(uint8_t pin, bool level) = nullptr;
+
+inline void pin_write(uint8_t pin, bool level) {
+  g_pin_level[pin] = level;
+  if (pin_observer) pin_observer(pin, level);
+}
+inline bool pin_read(uint8_t pin) { return g_pin_level[pin]; }
+
+template <uint8_t N>
+class Pin : public GpioPin<Pin<N>> {
+  static_assert(N < kMaxPins, "host pin out of range");
+
+ public:
+  void write_impl(bool high) { pin_write(N, high); }
+  bool read_impl() const { return pin_read(N); }
+};
+
+// --- Clock ----------------------------------------------------------------
+
+/// Simulated time; when `g_realtime` is set the clock follows the host's
+/// monotonic clock instead.
+inline uint64_t g_now_us = 0;
+inline bool g_realtime = false;
+
+inline uint32_t clock_now_us() {
+  if (!g_realtime) return static_cast<uint32_t>(g_now_us);
+  using namespace std::chrono;
+  return static_cast<uint32_t>(
+      duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count());
+}
+inline void clock_advance_us(uint64_t us) { g_now_us += us; }
+
+class HostClock : public Clock<HostClock> {
+ public:
+  uint32_t now_us_impl() const { return clock_now_us(); }
+  void delay_us_impl(uint32_t us) {
+    if (g_realtime) {
+      std::this_thread::sleep_for(std::chrono::microseconds(us));
+    } else {
+      clock_advance_us(us);
+    }
+  }
+};
+
+// --- UART -----------------------------------------------------------------
+
+struct UartChannel {
+  uint32_t baud = 0;
+  std::deque<uint8_t> rx;   // simulator -> firmware
+  std::vector<uint8_t> tx;  // firmware -> simulator
+  size_t tx_space = SIZE_MAX;  // bytes the "hardware" accepts per write
+};
+inline UartChannel g_uart[kMaxUarts];
+
+inline size_t uart_write(uint8_t n, const uint8_t* data, size_t len) {
+  UartChannel& u = g_uart[n];
+  size_t k = len < u.tx_space ? len : u.tx_space;
+  u.tx.insert(u.tx.end(), data, data + k);
+  return k;
+}
+inline size_t uart_read(uint8_t n, uint8_t* data, size_t len) {
+  UartChannel& u = g_uart[n];
+  size_t k = 0;
+  while (k < len && !u.rx.empty()) {
+    data[k++] = u.rx.front();
+    u.rx.pop_front();
+  }
+  return k;
+}
+
+template <uint8_t N>
+class HostUart : public Uart<HostUart<N>> {
+  static_assert(N < kMaxUarts, "host UART out of range");
+
+ public:
+  bool begin_impl(uint32_t baud) {
+    g_uart[N].baud = baud;
+    return true;
+  }
+  size_t write_impl(const uint8_t* data, size_t n) { return uart_write(N, data, n); }
+  size_t read_impl(uint8_t* data, size_t n) { return uart_read(N, data, n); }
+  size_t available_impl() const { return g_uart[N].rx.size(); }
+};
+
+/// Replays a recorded receiver stream (e.g. an ADS-B decoder's SBS-1
+/// output) into a UART's receive queue at the line rate, 10 bits a byte,
+/// as simulated time advances: the host stand-in for a serial feed.
+class UartFileFeed {
+ public:
+  UartFileFeed() = default;
+  UartFileFeed(const UartFileFeed&) = delete;
+  UartFileFeed& operator=(const UartFileFeed&) = delete;
+  ~UartFileFeed() {
+    if (fd_ >= 0) ::close(fd_);
+  }
+
+  bool open(const char* path, uint8_t uart, uint32_t baud) {
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = ::open(path, O_RDONLY);
+    uart_ = uart;
+    bytes_per_s_ = baud / 10;
+    start_us_ = g_now_us;
+    sent_ = 0;
+    return fd_ >= 0 && uart < kMaxUarts && bytes_per_s_ > 0;
+  }
+  /// Queues the bytes due by now. Returns false once the file is used up.
+  bool pump() {
+    if (fd_ < 0) return false;
+    uint64_t due = (g_now_us - start_us_) * bytes_per_s_ / 1000000;
+    while (sent_ < due) {
+      uint8_t buf[512];
+      uint64_t want = due - sent_ < sizeof(buf) ? due - sent_ : sizeof(buf);
+      ssize_t n = ::read(fd_, buf, static_cast<size_t>(want));
+      if (n <= 0) {
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+      }
+      g_uart[uart_].rx.insert(g_uart[uart_].rx.end(), buf, buf + n);
+      sent_ += static_cast<uint64_t>(n);
+    }
+    return true;
+  }
+  uint64_t sent() const { return sent_; }
+
+ private:
+  int fd_ = -1;
+  uint8_t uart_ = 0;
+  uint32_t bytes_per_s_ = 0;
+  uint64_t start_us_ = 0;
+  uint64_t sent_ = 0;
+};
+
+// --- SPI / I2C ------------------------------------------------------------
+
+/// Device model attached to a host bus by the simulator.
+class BusDevice {
+ public:
+  virtual ~BusDevice() = default;
+  /// SPI: full-duplex exchange. I2C: write phase then read phase.
+  virtual bool exchange(uint8_t addr, const uint8_t* tx, size_t ntx, uint8_t* rx,
+                        size_t nrx) = 0;
+};
+
+inline BusDevice* g_spi_device[kMaxBuses];
+inline BusDevice* g_i2c_devices[kMaxBuses][128];
+
+template <uint8_t N>
+class HostSpi : public SpiBus<HostSpi<N>> {
+ public:
+  bool transfer_impl(const uint8_t* tx, uint8_t* rx, size_t n) {
+    BusDevice* d = g_spi_device[N];
+    if (!d) {
+      if (rx) memset(rx, 0xFF, n);
+      return true;
+    }
+    return d->exchange(0, tx, tx ? n : 0, rx, rx ? n : 0);
+  }
+};
+
+template <uint8_t N>
+class HostI2c : public I2cBus<HostI2c<N>> {
+ public:
+  bool write_read_impl(uint8_t addr, const uint8_t* tx, size_t ntx, uint8_t* rx,
+                       size_t nrx) {
+    BusDevice* d = addr < 128 ? g_i2c_devices[N][addr] : nullptr;
+    return d && d->exchange(addr, tx, ntx, rx, nrx);  // no device: NACK
+  }
+};
+
+// --- ADC ------------------------------------------------------------------
+
+inline uint16_t g_adc[kMaxAdcChannels];
+
+template <uint8_t Ch>
+class HostAdc : public AdcInput<HostAdc<Ch>> {
+  static_assert(Ch < kMaxAdcChannels, "host ADC channel out of range");
+
+ public:
+  static constexpr uint16_t kFullScale = 4095;
+  uint16_t read_impl() { return g_adc[Ch]; }
+};
+
+// --- Flash ----------------------------------------------------------------
+
+struct FlashRegion {
+  std::vector<uint8_t> bytes;
+  uint32_t erases = 0;
+  uint32_t programs = 0;
+  /// Simulator hook run before each program (`data` set) or erase (`data`
+  /// null); returning false makes the operation fail (e.g. to model a power
+  /// cut). The hook may itself leave a partial program in `bytes`.
+  bool (*before_write)(uint32_t addr, const uint8_t* data, size_t n) = nullptr;
+};
+inline FlashRegion g_flash[2];
+
+/// Programs any length; reports the STM32L4's 8-byte unit and its timing so
+/// that budgets computed on the host match the flight part.
+template <uint8_t N, uint32_t Size, uint32_t SectorSize>
+class HostFlash : public Flash<HostFlash<N, Size, SectorSize>> {
+ public:
+  static constexpr uint32_t kSize = Size;
+  static constexpr uint32_t kSectorSize = SectorSize;
+  static constexpr uint32_t kProgramUnit = 8;
+  static constexpr uint32_t kProgramUnitMaxUs = 91;
+
+  static FlashRegion& region() {
+    FlashRegion& r = g_flash[N];
+    if (r.bytes.size() != Size) r.bytes.assign(Size, 0xFF);
+    return r;
+  }
+
+  bool read_impl(uint32_t addr, uint8_t* out, size_t n) {
+    if (addr > Size || n > Size - addr) return false;
+    memcpy(out, region().bytes.data() + addr, n);
+    return true;
+  }
+  bool program_impl(uint32_t addr, const uint8_t* data, size_t n) {
+    if (addr > Size || n > Size - addr) return false;
+    FlashRegion& r = region();
+    if (r.before_write && !r.before_write(addr, data, n)) return false;
+    for (size_t i = 0; i < n; ++i) r.bytes[addr + i] &= data[i];
+    ++r.programs;
+    return true;
+  }
+  bool erase_sector_impl(uint32_t addr) {
+    if (addr >= Size || addr % SectorSize) return false;
+    FlashRegion& r = region();
+    if (r.before_write && !r.before_write(addr, nullptr, SectorSize)) return false;
+    memset(r.bytes.data() + addr, 0xFF, SectorSize);
+    ++r.erases;
+    return true;
+  }
+};
+
+// --- Supply monitor -------------------------------------------------------
+
+/// Set by the simulator when the supply falls below the warning threshold;
+/// it then calls the handler the firmware would attach to the interrupt.
+inline bool g_supply_low = false;
+
+class HostSupply : public SupplyMonitor<HostSupply> {
+ public:
+  void enable_impl() {}
+  bool low_impl() const { return g_supply_low; }
+};
+
+// --- Data flash -----------------------------------------------------------
+
+/// An image file mapped read-only, standing in for external data flash.
+/// Clearing `xip` models a part without a memory-mapped window: map()
+/// then returns nullptr and every read() is counted.
+struct DataRegion {
+  const uint8_t* base = nullptr;
+  uint32_t size = 0;
+  bool xip = true;
+  uint32_t reads = 0;
+  uint64_t read_bytes = 0;
+};
+inline DataRegion g_data_flash[2];
+
+inline void unmap_data_file(uint8_t n) {
+  DataRegion& r = g_data_flash[n];
+  if (r.base) munmap(const_cast<uint8_t*>(r.base), r.size);
+  r.base = nullptr;
+  r.size = 0;
+}
+
+inline bool map_data_file(uint8_t n, const char* path) {
+  unmap_data_file(n);
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) return false;
+  struct stat st;
+  void* p = MAP_FAILED;
+  if (fstat(fd, &st) == 0 && st.st_size > 0 && st.st_size <= 0xFFFFFFFF) {
+    p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  if (p == MAP_FAILED) return false;
+  g_data_flash[n].base = static_cast<const uint8_t*>(p);
+  g_data_flash[n].size = static_cast<uint32_t>(st.st_size);
+  return true;
+}
+
+template <uint8_t N>
+class HostDataFlash : public ReadOnlyFlash<HostDataFlash<N>> {
+ public:
+  const uint8_t* map_impl() const { return g_data_flash[N].xip ? g_data_flash[N].base : nullptr; }
+  uint32_t size_impl() const { return g_data_flash[N].size; }
+  bool read_impl(uint32_t addr, uint8_t* out, size_t n) {
+    DataRegion& r = g_data_flash[N];
+    if (!r.base || addr > r.size || n > r.size - addr) return false;
+    memcpy(out, r.base + addr, n);
+    ++r.reads;
+    r.read_bytes += n;
+    return true;
+  }
+};
+
+}  // namespace skyguard::hal::host
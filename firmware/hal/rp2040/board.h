@@ -0,0 +1,37 @@
+// SkyGuard Cutdown Pro on RP2040.
+#pragma once
+
+#include "hal/rp2040/rp2040_hal.h"
+
+namespace skyguard::board {
+
+using BurnGateA = hal::rp2040::Pin<14>;
+using BurnGateB = hal::rp2040::Pin<15>;
+using StatusLed = hal::rp2040::Pin<25>;
+using ArmSense = hal::rp2040::Pin<22>;
+
+using GpsUart = hal::rp2040::Uart<0>;
+using IridiumUart = hal::rp2040::Uart<1>;
+// Two hardware UARTs: the console shares UART1 with the Iridium modem, which
+// is held powered down while the service jumper is fitted.
+using ConsoleUart = hal::rp2040::Uart<1>;
+// No AdsbUart: with both UARTs taken, an ADS-B receiver needs a PIO UART,
+// which this HAL does not provide, so FlightSystem's ADS-B feed stays idle.
+
+using RadioSpi = hal::rp2040::Spi<0>;
+using FlashSpi = hal::rp2040::Spi<1>;
+using SensorI2c = hal::rp2040::I2c<0>;
+
+using BurnCurrentAdc = hal::rp2040::Adc<0>;
+using BatteryAdc = hal::rp2040::Adc<1>;
+using ThermistorAdc = hal::rp2040::Adc<2>;
+
+using SystemClock = hal::rp2040::TimerClock;
+// Supervisor (TPS3839-class, 2.9 V) output.
+using SupplyWarning = hal::rp2040::SupervisorPin<21>;
+// Last 64 KiB of the 2 MiB boot flash.
+using ConfigFlash = hal::rp2040::BootFlash<(2u << 20) - 64 * 1024, 64 * 1024>;
+// Uploaded data between the first 1 MiB (firmware) and the config region.
+using DataFlash = hal::rp2040::XipData<1u << 20, (1u << 20) - 64 * 1024>;
+
+}  // namespace skyguard::board
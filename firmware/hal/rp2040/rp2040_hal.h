@@ -0,0 +1,157 @@
+// RP2040 backend on the Pico SDK hardware_* libraries. Pin functions and
+// peripheral instances are set up by the board init code before use.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "hal/hal.h"
+#include "hardware/adc.h"
+#include "hardware/flash.h"
+#include "hardware/gpio.h"
+#include "hardware/i2c.h"
+#include "hardware/irq.h"
+#include "hardware/spi.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+#include "hardware/uart.h"
+
+namespace skyguard::hal::rp2040 {
+
+constexpr uint32_t kI2cTimeoutUs = 2000;
+
+template <uint Gpio>
+class Pin : public GpioPin<Pin<Gpio>> {
+ public:
+  void write_impl(bool high) { gpio_put(Gpio, high); }
+  bool read_impl() const { return gpio_get(Gpio); }
+  void toggle_impl() { gpio_xor_mask(1u << Gpio); }
+};
+
+class TimerClock : public Clock<TimerClock> {
+ public:
+  uint32_t now_us_impl() const { return time_us_32(); }
+  void delay_us_impl(uint32_t us) { busy_wait_us_32(us); }
+};
+
+template <uint Index>
+class Uart : public hal::Uart<Uart<Index>> {
+  static uart_inst_t* dev() { return UART_INSTANCE(Index); }
+
+ public:
+  bool begin_impl(uint32_t baud) { return uart_init(dev(), baud) != 0; }
+  size_t write_impl(const uint8_t* data, size_t n) {
+    size_t k = 0;
+    while (k < n && uart_is_writable(dev())) uart_putc_raw(dev(), static_cast<char>(data[k++]));
+    return k;
+  }
+  size_t read_impl(uint8_t* data, size_t n) {
+    size_t k = 0;
+    while (k < n && uart_is_readable(dev())) data[k++] = static_cast<uint8_t>(uart_getc(dev()));
+    return k;
+  }
+  size_t available_impl() const { return uart_is_readable(dev()) ? 1 : 0; }
+};
+
+template <uint Index>
+class Spi : public SpiBus<Spi<Index>> {
+  static spi_inst_t* dev() { return SPI_INSTANCE(Index); }
+
+ public:
+  bool transfer_impl(const uint8_t* tx, uint8_t* rx, size_t n) {
+    if (tx && rx) return spi_write_read_blocking(dev(), tx, rx, n) == static_cast<int>(n);
+    if (tx) return spi_write_blocking(dev(), tx, n) == static_cast<int>(n);
+    return spi_read_blocking(dev(), 0xFF, rx, n) == static_cast<int>(n);
+  }
+};
+
+template <uint Index>
+class I2c : public I2cBus<I2c<Index>> {
+  static i2c_inst_t* dev() { return I2C_INSTANCE(Index); }
+
+ public:
+  bool write_read_impl(uint8_t addr, const uint8_t* tx, size_t ntx, uint8_t* rx,
+                       size_t nrx) {
+    if (ntx && i2c_write_timeout_us(dev(), addr, tx, ntx, nrx != 0, kI2cTimeoutUs) !=
+                   static_cast<int>(ntx)) {
+      return false;
+    }
+    if (nrx && i2c_read_timeout_us(dev(), addr, rx, nrx, false, kI2cTimeoutUs) !=
+                   static_cast<int>(nrx)) {
+      return false;
+    }
+    return true;
+  }
+};
+
+template <uint Input>
+class Adc : public AdcInput<Adc<Input>> {
+ public:
+  static constexpr uint16_t kFullScale = 4095;
+  uint16_t read_impl() {
+    adc_select_input(Input);
+    return adc_read();
+  }
+};
+
+/// Region of the boot flash at offset `Base`. Reads go through the XIP
+/// window; program/erase run with interrupts off, as the SDK requires.
+template <uint32_t Base, uint32_t Size>
+class BootFlash : public Flash<BootFlash<Base, Size>> {
+ public:
+  static constexpr uint32_t kSize = Size;
+  static constexpr uint32_t kSectorSize = FLASH_SECTOR_SIZE;
+  static constexpr uint32_t kProgramUnit = FLASH_PAGE_SIZE;
+  static constexpr uint32_t kProgramUnitMaxUs = 3000;  // W25Q16JV t_PP max
+
+  bool read_impl(uint32_t addr, uint8_t* out, size_t n) {
+    if (addr > Size || n > Size - addr) return false;
+    memcpy(out, reinterpret_cast<const void*>(XIP_BASE + Base + addr), n);
+    return true;
+  }
+  bool program_impl(uint32_t addr, const uint8_t* data, size_t n) {
+    if (addr > Size || n > Size - addr || (addr | n) % FLASH_PAGE_SIZE) return false;
+    uint32_t irq = save_and_disable_interrupts();
+    flash_range_program(Base + addr, data, n);
+    restore_interrupts(irq);
+    return true;
+  }
+  bool erase_sector_impl(uint32_t addr) {
+    if (addr >= Size || addr % kSectorSize) return false;
+    uint32_t irq = save_and_disable_interrupts();
+    flash_range_erase(Base + addr, kSectorSize);
+    restore_interrupts(irq);
+    return true;
+  }
+};
+
+/// Read-only region of the boot flash at offset `Base`, used in place
+/// through the XIP window.
+template <uint32_t Base, uint32_t Size>
+class XipData : public ReadOnlyFlash<XipData<Base, Size>> {
+ public:
+  const uint8_t* map_impl() const { return reinterpret_cast<const uint8_t*>(XIP_BASE + Base); }
+  uint32_t size_impl() const { return Size; }
+  bool read_impl(uint32_t addr, uint8_t* out, size_t n) {
+    if (addr > Size || n > Size - addr) return false;
+    memcpy(out, map_impl() + addr, n);
+    return true;
+  }
+};
+
+/// The RP2040 has no voltage detector that interrupts before reset, so the
+/// warning comes from an external supervisor's open-drain output on `Gpio`,
+/// active low, handled on the shared GPIO interrupt (IO_IRQ_BANK0).
+template <uint Gpio>
+class SupervisorPin : public SupplyMonitor<SupervisorPin<Gpio>> {
+ public:
+  void enable_impl() {
+    gpio_set_irq_enabled(Gpio, GPIO_IRQ_EDGE_FALL, true);
+    irq_set_priority(IO_IRQ_BANK0, 0);
+    irq_set_enabled(IO_IRQ_BANK0, true);
+  }
+  bool low_impl() const { return !gpio_get(Gpio); }
+};
+
+}  // namespace skyguard::hal::rp2040
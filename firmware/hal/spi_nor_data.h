@@ -0,0 +1,37 @@
+// ReadOnlyFlash on a plain SPI NOR part (JEDEC READ, 0x03), for boards
+// whose data flash sits on an ordinary SPI bus and cannot be memory
+// mapped. Storage views over it read through the page cache.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hal/hal.h"
+
+namespace skyguard::hal {
+
+/// `Size` bytes starting at device address `Base`; `Cs` is active low.
+template <class Spi, class Cs, uint32_t Base, uint32_t Size>
+class SpiNorData : public ReadOnlyFlash<SpiNorData<Spi, Cs, Base, Size>> {
+  static_assert(Base + static_cast<uint64_t>(Size) <= (1u << 24), "3-byte addressing only");
+
+ public:
+  const uint8_t* map_impl() const { return nullptr; }
+  uint32_t size_impl() const { return Size; }
+  bool read_impl(uint32_t addr, uint8_t* out, size_t n) {
+    if (addr > Size || n > Size - addr) return false;
+    uint32_t a = Base + addr;
+    const uint8_t cmd[4] = {0x03, static_cast<uint8_t>(a >> 16), static_cast<uint8_t>(a >> 8),
+                            static_cast<uint8_t>(a)};
+    cs_.clear();
+    bool ok = spi_.transfer(cmd, nullptr, sizeof(cmd)) && spi_.transfer(nullptr, out, n);
+    cs_.set();
+    return ok;
+  }
+
+ private:
+  Spi spi_;
+  Cs cs_;
+};
+
+}  // namespace skyguard::hal
@@ -0,0 +1,39 @@
+// SkyGuard Cutdown Pro on STM32L476.
+#pragma once
+
+#include "hal/spi_nor_data.h"
+#include "hal/stm32l4/stm32l4_hal.h"
+
+namespace skyguard::board {
+
+constexpr uint32_t kPclkHz = 80000000;
+
+using BurnGateA = hal::stm32l4::Pin<GPIOB_BASE, LL_GPIO_PIN_0>;
+using BurnGateB = hal::stm32l4::Pin<GPIOB_BASE, LL_GPIO_PIN_1>;
+using StatusLed = hal::stm32l4::Pin<GPIOA_BASE, LL_GPIO_PIN_5>;
+using ArmSense = hal::stm32l4::Pin<GPIOC_BASE, LL_GPIO_PIN_13>;
+using FlashCs = hal::stm32l4::Pin<GPIOB_BASE, LL_GPIO_PIN_12>;
+
+using GpsUart = hal::stm32l4::Usart<USART1_BASE, kPclkHz>;
+using IridiumUart = hal::stm32l4::Usart<USART3_BASE, kPclkHz>;
+using ConsoleUart = hal::stm32l4::Usart<USART2_BASE, kPclkHz>;
+using AdsbUart = hal::stm32l4::Usart<UART4_BASE, kPclkHz>;
+
+using RadioSpi = hal::stm32l4::Spi<SPI1_BASE>;
+using FlashSpi = hal::stm32l4::Spi<SPI2_BASE>;
+using SensorI2c = hal::stm32l4::I2c<I2C1_BASE>;
+
+using BurnCurrentAdc = hal::stm32l4::Adc<LL_ADC_CHANNEL_5>;
+using BatteryAdc = hal::stm32l4::Adc<LL_ADC_CHANNEL_6>;
+using ThermistorAdc = hal::stm32l4::Adc<LL_ADC_CHANNEL_7>;
+
+using SystemClock = hal::stm32l4::Tim2Clock;
+// VDD below 2.9 V (the regulator has dropped out of regulation).
+using SupplyWarning = hal::stm32l4::Pvd<LL_PWR_PVDLEVEL_6>;
+// Last 64 KiB of the 1 MiB part.
+using ConfigFlash = hal::stm32l4::InternalFlash<0x080F0000, 64 * 1024>;
+// The external NOR is on SPI2, not QUADSPI, so data is read through the
+// page cache; first 4 MiB of the part.
+using DataFlash = hal::SpiNorData<FlashSpi, FlashCs, 0, 4u << 20>;
+
+}  // namespace skyguard::board
@@ -0,0 +1,222 @@
+// STM32L4 backend on the ST low-layer (LL) drivers, which are themselves
+// inline register accesses. Peripheral clocks, pin muxing and TIM2 (free
+// running at 1 MHz) are set up by the board init code before use.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "hal/hal.h"
+#include "stm32l4xx.h"
+#include "stm32l4xx_hal_flash.h"
+#include "stm32l4xx_ll_adc.h"
+#include "stm32l4xx_ll_gpio.h"
+#include "stm32l4xx_ll_exti.h"
+#include "stm32l4xx_ll_i2c.h"
+#include "stm32l4xx_ll_pwr.h"
+#include "stm32l4xx_ll_spi.h"
+#include "stm32l4xx_ll_tim.h"
+#include "stm32l4xx_ll_usart.h"
+
+namespace skyguard::hal::stm32l4 {
+
+constexpr uint32_t kI2cTimeoutUs = 2000;
+
+inline uint32_t tim2_now_us() { return LL_TIM_GetCounter(TIM2); }
+
+template <uintptr_t PortBase, uint32_t PinMask>
+class Pin : public GpioPin<Pin<PortBase, PinMask>> {
+  static GPIO_TypeDef* port() { return reinterpret_cast<GPIO_TypeDef*>(PortBase); }
+
+ public:
+  void write_impl(bool high) {
+    if (high) {
+      LL_GPIO_SetOutputPin(port(), PinMask);
+    } else {
+      LL_GPIO_ResetOutputPin(port(), PinMask);
+    }
+  }
+  bool read_impl() const { return LL_GPIO_IsInputPinSet(port(), PinMask); }
+  void toggle_impl() { LL_GPIO_TogglePin(port(), PinMask); }
+};
+
+class Tim2Clock : public Clock<Tim2Clock> {
+ public:
+  uint32_t now_us_impl() const { return tim2_now_us(); }
+  void delay_us_impl(uint32_t us) {
+    uint32_t start = tim2_now_us();
+    while (tim2_now_us() - start < us) {
+    }
+  }
+};
+
+/// Polled USART. Writes fill the transmit register only while it is empty,
+/// so a slow peer never stalls the caller; buffered/DMA transmit lives in
+/// the console and modem drivers.
+template <uintptr_t Base, uint32_t PclkHz>
+class Usart : public Uart<Usart<Base, PclkHz>> {
+  static USART_TypeDef* dev() { return reinterpret_cast<USART_TypeDef*>(Base); }
+
+ public:
+  bool begin_impl(uint32_t baud) {
+    LL_USART_Disable(dev());
+    LL_USART_SetBaudRate(dev(), PclkHz, LL_USART_OVERSAMPLING_16, baud);
+    LL_USART_SetTransferDirection(dev(), LL_USART_DIRECTION_TX_RX);
+    LL_USART_Enable(dev());
+    return true;
+  }
+  size_t write_impl(const uint8_t* data, size_t n) {
+    size_t k = 0;
+    while (k < n && LL_USART_IsActiveFlag_TXE(dev())) LL_USART_TransmitData8(dev(), data[k++]);
+    return k;
+  }
+  size_t read_impl(uint8_t* data, size_t n) {
+    size_t k = 0;
+    while (k < n && LL_USART_IsActiveFlag_RXNE(dev())) data[k++] = LL_USART_ReceiveData8(dev());
+    return k;
+  }
+  size_t available_impl() const { return LL_USART_IsActiveFlag_RXNE(dev()) ? 1 : 0; }
+};
+
+template <uintptr_t Base>
+class Spi : public SpiBus<Spi<Base>> {
+  static SPI_TypeDef* dev() { return reinterpret_cast<SPI_TypeDef*>(Base); }
+
+ public:
+  bool transfer_impl(const uint8_t* tx, uint8_t* rx, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+      while (!LL_SPI_IsActiveFlag_TXE(dev())) {
+      }
+      LL_SPI_TransmitData8(dev(), tx ? tx[i] : 0xFF);
+      while (!LL_SPI_IsActiveFlag_RXNE(dev())) {
+      }
+      uint8_t b = LL_SPI_ReceiveData8(dev());
+      if (rx) rx[i] = b;
+    }
+    while (LL_SPI_IsActiveFlag_BSY(dev())) {
+    }
+    return true;
+  }
+};
+
+template <uintptr_t Base>
+class I2c : public I2cBus<I2c<Base>> {
+  static I2C_TypeDef* dev() { return reinterpret_cast<I2C_TypeDef*>(Base); }
+
+  template <class Cond>
+  static bool wait(Cond cond) {
+    uint32_t start = tim2_now_us();
+    while (!cond()) {
+      if (LL_I2C_IsActiveFlag_NACK(dev())) {
+        LL_I2C_ClearFlag_NACK(dev());
+        return false;
+      }
+      if (tim2_now_us() - start > kI2cTimeoutUs) return false;
+    }
+    return true;
+  }
+
+ public:
+  bool write_read_impl(uint8_t addr, const uint8_t* tx, size_t ntx, uint8_t* rx,
+                       size_t nrx) {
+    if (ntx > 255 || nrx > 255) return false;
+    uint32_t addr8 = static_cast<uint32_t>(addr) << 1;
+    if (ntx > 0) {
+      LL_I2C_HandleTransfer(dev(), addr8, LL_I2C_ADDRSLAVE_7BIT, ntx,
+                            nrx ? LL_I2C_MODE_SOFTEND : LL_I2C_MODE_AUTOEND,
+                            LL_I2C_GENERATE_START_WRITE);
+      for (size_t i = 0; i < ntx; ++i) {
+        if (!wait([] { return LL_I2C_IsActiveFlag_TXIS(dev()) != 0; })) return false;
+        LL_I2C_TransmitData8(dev(), tx[i]);
+      }
+      if (nrx && !wait([] { return LL_I2C_IsActiveFlag_TC(dev()) != 0; })) return false;
+    }
+    if (nrx > 0) {
+      LL_I2C_HandleTransfer(dev(), addr8, LL_I2C_ADDRSLAVE_7BIT, nrx, LL_I2C_MODE_AUTOEND,
+                            LL_I2C_GENERATE_START_READ);
+      for (size_t i = 0; i < nrx; ++i) {
+        if (!wait([] { return LL_I2C_IsActiveFlag_RXNE(dev()) != 0; })) return false;
+        rx[i] = LL_I2C_ReceiveData8(dev());
+      }
+    }
+    if (!wait([] { return LL_I2C_IsActiveFlag_STOP(dev()) != 0; })) return false;
+    LL_I2C_ClearFlag_STOP(dev());
+    return true;
+  }
+};
+
+/// Single regular conversion on ADC1.
+template <uint32_t Channel>
+class Adc : public AdcInput<Adc<Channel>> {
+ public:
+  static constexpr uint16_t kFullScale = 4095;
+  uint16_t read_impl() {
+    LL_ADC_REG_SetSequencerRanks(ADC1, LL_ADC_REG_RANK_1, Channel);
+    LL_ADC_REG_StartConversion(ADC1);
+    while (!LL_ADC_IsActiveFlag_EOC(ADC1)) {
+    }
+    return LL_ADC_REG_ReadConversionData12(ADC1);
+  }
+};
+
+/// Region of internal flash starting at `Base`, programmed in 64-bit
+/// double words (addresses and lengths must be 8-byte aligned).
+template <uint32_t Base, uint32_t Size>
+class InternalFlash : public Flash<InternalFlash<Base, Size>> {
+ public:
+  static constexpr uint32_t kSize = Size;
+  static constexpr uint32_t kSectorSize = FLASH_PAGE_SIZE;
+  static constexpr uint32_t kProgramUnit = 8;
+  static constexpr uint32_t kProgramUnitMaxUs = 91;  // t_prog, 64-bit word
+
+  bool read_impl(uint32_t addr, uint8_t* out, size_t n) {
+    if (addr > Size || n > Size - addr) return false;
+    memcpy(out, reinterpret_cast<const void*>(Base + addr), n);
+    return true;
+  }
+  bool program_impl(uint32_t addr, const uint8_t* data, size_t n) {
+    if (addr > Size || n > Size - addr || (addr | n) & 7) return false;
+    HAL_FLASH_Unlock();
+    bool ok = true;
+    for (size_t i = 0; ok && i < n; i += 8) {
+      uint64_t dw;
+      memcpy(&dw, data + i, 8);
+      ok = HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, Base + addr + i, dw) == HAL_OK;
+    }
+    HAL_FLASH_Lock();
+    return ok;
+  }
+  bool erase_sector_impl(uint32_t addr) {
+    if (addr >= Size || addr % kSectorSize) return false;
+    FLASH_EraseInitTypeDef e{};
+    e.TypeErase = FLASH_TYPEERASE_PAGES;
+    uint32_t page = (Base + addr - FLASH_BASE) / FLASH_PAGE_SIZE;
+    e.Banks = page < FLASH_PAGE_NB ? FLASH_BANK_1 : FLASH_BANK_2;
+    e.Page = page % FLASH_PAGE_NB;
+    e.NbPages = 1;
+    uint32_t bad_page = 0;
+    HAL_FLASH_Unlock();
+    bool ok = HAL_FLASHEx_Erase(&e, &bad_page) == HAL_OK;
+    HAL_FLASH_Lock();
+    return ok;
+  }
+};
+
+/// Programmable voltage detector on VDD. PVDO rises when VDD falls below
+/// `Level` and raises EXTI line 16 (PVD_PVM_IRQn).
+template <uint32_t Level>
+class Pvd : public SupplyMonitor<Pvd<Level>> {
+ public:
+  void enable_impl() {
+    LL_PWR_SetPVDLevel(Level);
+    LL_PWR_EnablePVD();
+    LL_EXTI_EnableRisingTrig_0_31(LL_EXTI_LINE_16);
+    LL_EXTI_EnableIT_0_31(LL_EXTI_LINE_16);
+    NVIC_SetPriority(PVD_PVM_IRQn, 0);
+    NVIC_EnableIRQ(PVD_PVM_IRQn);
+  }
+  bool low_impl() const { return LL_PWR_IsActiveFlag_PVDO() != 0; }
+};
+
+}  // namespace skyguard::hal::stm32l4
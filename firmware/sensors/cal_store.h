@@ -0,0 +1,92 @@
+// Per-unit calibration records in config flash.
+//
+// A region of whole sectors holds an append-only list of entries:
+//   u8 type | u8 version | u16 len | payload | u32 crc32
+// each padded with 0xFF to the flash's program unit. The CRC covers the
+// header and payload. Recalibrating appends a new entry, and the last
+// valid entry of a type wins, so an interrupted write leaves the previous
+// calibration in force. The list ends at the first erased header; the
+// ground station erases the region when it fills up.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "util/crc32.h"
+
+namespace skyguard::sensors {
+
+constexpr size_t kCalEntryHeader = 4;
+constexpr size_t kCalMaxPayload = 64;
+
+namespace detail {
+
+inline uint32_t cal_round_up(uint32_t v, uint32_t unit) { return (v + unit - 1) / unit * unit; }
+
+}  // namespace detail
+
+/// Finds the newest valid entry of `type` in [base, base + size). Copies up
+/// to `cap` payload bytes to `out` and returns the payload length, or -1
+/// if there is none.
+template <class Flash>
+int cal_store_find(Flash& flash, uint32_t base, uint32_t size, uint8_t type, uint8_t* out,
+                   size_t cap, uint8_t* version = nullptr) {
+  int found = -1;
+  uint8_t buf[kCalEntryHeader + kCalMaxPayload + 4];
+  for (uint32_t off = 0; off + kCalEntryHeader + 4 <= size;) {
+    if (!flash.read(base + off, buf, kCalEntryHeader)) break;
+    if (buf[0] == 0xFF) break;  // erased: end of list
+    size_t len = static_cast<size_t>(buf[2] | buf[3] << 8);
+    uint32_t span = detail::cal_round_up(static_cast<uint32_t>(kCalEntryHeader + len + 4),
+                                         flash.program_unit());
+    if (len > kCalMaxPayload || off + span > size) break;
+    if (buf[0] == type &&
+        flash.read(base + off + kCalEntryHeader, buf + kCalEntryHeader, len + 4)) {
+      const uint8_t* c = buf + kCalEntryHeader + len;
+      uint32_t want = static_cast<uint32_t>(c[0]) | static_cast<uint32_t>(c[1]) << 8 |
+                      static_cast<uint32_t>(c[2]) << 16 | static_cast<uint32_t>(c[3]) << 24;
+      if (crc32(buf, kCalEntryHeader + len) == want) {
+        size_t n = len < cap ? len : cap;
+        for (size_t i = 0; i < n; ++i) out[i] = buf[kCalEntryHeader + i];
+        if (version) *version = buf[1];
+        found = static_cast<int>(len);
+      }
+    }
+    off += span;
+  }
+  return found;
+}
+
+/// Appends an entry after the last one. Returns false if the region is full
+/// or programming fails.
+template <class Flash>
+bool cal_store_append(Flash& flash, uint32_t base, uint32_t size, uint8_t type, uint8_t version,
+                      const uint8_t* payload, size_t len) {
+  if (len > kCalMaxPayload || type == 0xFF) return false;
+  const uint32_t unit = flash.program_unit();
+  uint32_t off = 0;
+  uint8_t hdr[kCalEntryHeader];
+  for (;;) {
+    if (off + kCalEntryHeader > size || !flash.read(base + off, hdr, kCalEntryHeader)) {
+      return false;
+    }
+    if (hdr[0] == 0xFF) break;
+    size_t n = static_cast<size_t>(hdr[2] | hdr[3] << 8);
+    if (n > kCalMaxPayload) return false;  // damaged list; needs erasing
+    off += detail::cal_round_up(static_cast<uint32_t>(kCalEntryHeader + n + 4), unit);
+  }
+  uint32_t span = detail::cal_round_up(static_cast<uint32_t>(kCalEntryHeader + len + 4), unit);
+  uint8_t buf[kCalEntryHeader + kCalMaxPayload + 4 + 256];
+  if (off + span > size || span > sizeof(buf)) return false;
+  for (uint32_t i = 0; i < span; ++i) buf[i] = 0xFF;
+  buf[0] = type;
+  buf[1] = version;
+  buf[2] = static_cast<uint8_t>(len);
+  buf[3] = static_cast<uint8_t>(len >> 8);
+  for (size_t i = 0; i < len; ++i) buf[kCalEntryHeader + i] = payload[i];
+  uint32_t crc = crc32(buf, kCalEntryHeader + len);
+  for (int i = 0; i < 4; ++i) buf[kCalEntryHeader + len + i] = static_cast<uint8_t>(crc >> (8 * i));
+  return flash.program(base + off, buf, span);
+}
+
+}  // namespace skyguard::sensors
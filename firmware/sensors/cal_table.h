@@ -0,0 +1,117 @@
+// Interpolation tables for nonlinear sensor conversions, built by constant
+// evaluation of the exact formula.
+//
+// make_cal_table() samples a conversion at Segments + 1 evenly spaced ADC
+// codes and stores the results in output units; convert() is then a shift,
+// two loads and a multiply instead of a logarithm per sample. The same
+// builder runs at compile time for the nominal part, putting the table in
+// flash, and at boot for a per-unit calibration, putting it in RAM.
+//
+// The valid range is the longest run of segments whose ends both lie in
+// [y_min, y_max]; it is rounded inward to whole segments so that nothing
+// is extrapolated or interpolated across the singularities at the ends of
+// a divider's range. convert() rejects codes outside it.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <limits>
+
+namespace skyguard::sensors {
+
+/// Natural logarithm for constant expressions (std::log is not constexpr
+/// in C++17). Accurate to a few ulp for finite x > 0; NaN otherwise.
+constexpr double cal_ln(double x) {
+  if (!(x > 0) || x > std::numeric_limits<double>::max()) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  int k = 0;
+  while (x > 1.4142135623730951) {
+    x /= 2;
+    ++k;
+  }
+  while (x < 0.7071067811865476) {
+    x *= 2;
+    --k;
+  }
+  // ln x = 2 atanh(s) with |s| <= 0.172.
+  double s = (x - 1) / (x + 1);
+  double s2 = s * s;
+  double term = s;
+  double sum = 0;
+  for (int n = 1; n < 40; n += 2) {
+    sum += term / n;
+    term *= s2;
+  }
+  return 2 * sum + k * 0.6931471805599453;
+}
+
+template <size_t Segments>
+struct CalTable {
+  static_assert(Segments >= 2 && (Segments & (Segments - 1)) == 0,
+                "segment count must be a power of two");
+
+  uint8_t shift;     // log2 of the codes per segment
+  uint16_t code_lo;  // valid codes: [code_lo, code_hi]; empty if lo > hi
+  uint16_t code_hi;
+  int16_t y[Segments + 1];
+
+  constexpr bool valid() const { return code_lo <= code_hi; }
+
+  /// Converts an ADC code. Returns false, leaving `*out` alone, outside
+  /// the valid range.
+  constexpr bool convert(uint16_t code, int16_t* out) const {
+    if (code < code_lo || code > code_hi) return false;
+    uint32_t i = code >> shift;
+    int32_t frac = static_cast<int32_t>(code & ((1u << shift) - 1));
+    int32_t y0 = y[i];
+    int32_t d = y[i + 1] - y0;
+    int32_t half = shift ? 1 << (shift - 1) : 0;
+    *out = static_cast<int16_t>(y0 + ((d * frac + half) >> shift));
+    return true;
+  }
+};
+
+/// Samples `f(code)` (a constexpr callable returning output units as a
+/// double, NaN where undefined) over codes 0..full_scale.
+template <size_t Segments, class F>
+constexpr CalTable<Segments> make_cal_table(F f, uint32_t full_scale, int16_t y_min,
+                                            int16_t y_max) {
+  CalTable<Segments> t{};
+  uint8_t shift = 0;
+  while ((Segments << shift) <= full_scale) ++shift;
+  t.shift = shift;
+
+  bool ok[Segments + 1] = {};
+  for (size_t i = 0; i <= Segments; ++i) {
+    double v = f(static_cast<double>(i << shift));
+    ok[i] = v >= y_min && v <= y_max;  // false for NaN
+    double c = ok[i] ? v : v < y_min ? y_min : y_max;
+    t.y[i] = static_cast<int16_t>(c >= 0 ? c + 0.5 : c - 0.5);
+  }
+
+  size_t best_lo = 0, best_len = 0, run_lo = 0, run_len = 0;
+  for (size_t s = 0; s < Segments; ++s) {
+    if (!ok[s] || !ok[s + 1]) {
+      run_len = 0;
+      continue;
+    }
+    if (run_len++ == 0) run_lo = s;
+    if (run_len > best_len) {
+      best_len = run_len;
+      best_lo = run_lo;
+    }
+  }
+  if (best_len == 0) {
+    t.code_lo = 1;
+    t.code_hi = 0;
+    return t;
+  }
+  uint32_t hi = static_cast<uint32_t>((best_lo + best_len) << shift);
+  t.code_lo = static_cast<uint16_t>(best_lo << shift);
+  t.code_hi = static_cast<uint16_t>(hi < full_scale ? hi : full_scale);
+  return t;
+}
+
+}  // namespace skyguard::sensors
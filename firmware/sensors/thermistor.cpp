@@ -0,0 +1,50 @@
+#include "sensors/thermistor.h"
+
+#include <string.h>
+
+#include "generated/records.h"
+
+namespace skyguard::sensors {
+
+namespace {
+
+using records::ThermistorCal;
+
+constexpr ThermistorTable kNominal = make_thermistor_table(kNominalThermistor);
+
+constexpr bool covers_operating_range(const ThermistorTable& t) {
+  int16_t a = 0, b = 0;
+  if (!t.convert(t.code_lo, &a) || !t.convert(t.code_hi, &b)) return false;
+  int16_t lo = a < b ? a : b, hi = a < b ? b : a;
+  return lo <= kThermistorOperatingMinC10 && hi >= kThermistorOperatingMaxC10;
+}
+
+static_assert(covers_operating_range(kNominal), "nominal thermistor table covers -40..85 C");
+
+float read_f32(const uint8_t* p) {
+  uint32_t bits = static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 |
+                  static_cast<uint32_t>(p[2]) << 16 | static_cast<uint32_t>(p[3]) << 24;
+  float v;
+  memcpy(&v, &bits, sizeof(v));
+  return v;
+}
+
+}  // namespace
+
+const ThermistorTable kNominalThermistorTable = kNominal;
+
+bool Thermistor::apply_cal(const uint8_t* payload, size_t len) {
+  if (len < ThermistorCal::kEncodedSize) return false;
+  ThermistorModel m{read_f32(payload + ThermistorCal::kOffset_sh_a),
+                    read_f32(payload + ThermistorCal::kOffset_sh_b),
+                    read_f32(payload + ThermistorCal::kOffset_sh_c),
+                    read_f32(payload + ThermistorCal::kOffset_r_fixed_ohm)};
+  if (!(m.r_fixed_ohm > 0)) return false;  // also rejects NaN
+  ThermistorTable t = make_thermistor_table(m);
+  if (!covers_operating_range(t)) return false;
+  ram_ = t;
+  table_ = &ram_;
+  return true;
+}
+
+}  // namespace skyguard::sensors
@@ -0,0 +1,80 @@
+// NTC thermistor temperature through a table built from its Steinhart-Hart
+// coefficients (see sensors/cal_table.h).
+//
+// The thermistor sits between the ADC input and ground with a fixed
+// resistor to the reference, so R = R_fixed * code / (2^12 - code). The
+// nominal part's table is generated at compile time; a per-unit
+// ThermistorCal record (from config flash, sensors/cal_store.h) replaces
+// it with one built in RAM, if its table covers the operating range.
+// Output is tenths of a degree Celsius, as in StateSnapshot::temp_c10.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <limits>
+
+#include "sensors/cal_table.h"
+
+namespace skyguard::sensors {
+
+constexpr uint32_t kThermistorAdcFullScale = 4095;
+constexpr size_t kThermistorSegments = 256;
+// Table range, and the span a calibration must cover to be accepted.
+constexpr int16_t kThermistorMinC10 = -550;
+constexpr int16_t kThermistorMaxC10 = 1250;
+constexpr int16_t kThermistorOperatingMinC10 = -400;
+constexpr int16_t kThermistorOperatingMaxC10 = 850;
+
+struct ThermistorModel {
+  double sh_a;  // 1/T = a + b ln R + c (ln R)^3, T in kelvin
+  double sh_b;
+  double sh_c;
+  double r_fixed_ohm;
+};
+
+/// Nominal 10 kOhm, B = 3950 part on a 10 kOhm divider.
+constexpr ThermistorModel kNominalThermistor{1.009249522e-3, 2.378405444e-4, 2.019202697e-7,
+                                             10000.0};
+
+/// Exact conversion of a (possibly fractional) ADC code; NaN where the
+/// divider is open or shorted.
+constexpr double thermistor_c10(const ThermistorModel& m, double code) {
+  constexpr double kCodes = kThermistorAdcFullScale + 1.0;
+  if (!(code > 0 && code < kCodes)) return std::numeric_limits<double>::quiet_NaN();
+  double ln_r = cal_ln(m.r_fixed_ohm * code / (kCodes - code));
+  double inv_t = m.sh_a + m.sh_b * ln_r + m.sh_c * ln_r * ln_r * ln_r;
+  if (!(inv_t > 0)) return std::numeric_limits<double>::quiet_NaN();
+  return (1.0 / inv_t - 273.15) * 10.0;
+}
+
+using ThermistorTable = CalTable<kThermistorSegments>;
+
+constexpr ThermistorTable make_thermistor_table(const ThermistorModel& m) {
+  return make_cal_table<kThermistorSegments>(
+      [m](double code) { return thermistor_c10(m, code); }, kThermistorAdcFullScale,
+      kThermistorMinC10, kThermistorMaxC10);
+}
+
+extern const ThermistorTable kNominalThermistorTable;
+
+class Thermistor {
+ public:
+  /// Converts an ADC code; false outside the table's range (open or
+  /// shorted sensor, or beyond the calibrated span).
+  bool to_c10(uint16_t code, int16_t* out) const { return table_->convert(code, out); }
+
+  /// Switches to a per-unit calibration given as an encoded ThermistorCal
+  /// payload. Returns false, keeping the current table, if the payload is
+  /// short or its table does not cover the operating range.
+  bool apply_cal(const uint8_t* payload, size_t len);
+  void use_nominal() { table_ = &kNominalThermistorTable; }
+  bool calibrated() const { return table_ == &ram_; }
+  const ThermistorTable& table() const { return *table_; }
+
+ private:
+  const ThermistorTable* table_ = &kNominalThermistorTable;
+  ThermistorTable ram_ = {};
+};
+
+}  // namespace skyguard::sensors
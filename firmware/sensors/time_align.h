@@ -0,0 +1,124 @@
+// Time alignment of sensor streams to common fusion epochs.
+//
+// GPS fixes, baro conversions, IMU FIFO bursts and ADC DMA blocks arrive
+// at different rates and after different delays. Pairing whatever arrived
+// last treats a GPS solution half a second old as current next to a baro
+// sample from the last tick, which shows up as lag and bias wherever the
+// flight accelerates (burst, canopy opening, wind shear).
+//
+// Each stream keeps a short ring of samples, each stamped with the instant
+// it describes: arrival minus the source's fixed latency, or the source's
+// own time (GPS solution age). A fusion epoch reads every stream by linear
+// interpolation between the samples around it. Fusion runs a fixed delay
+// behind now (at least the largest latency plus one sample period of the
+// slowest stream), so each stream has a sample on both sides of the
+// epoch. A stream that does not (a dropout, or a latency larger than
+// planned) says so rather than silently repeating its last value.
+//
+// Times are local milliseconds and may wrap; memory is Depth samples of
+// Channels floats per stream.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace skyguard::sensors {
+
+enum class AlignStatus : uint8_t {
+  kInterpolated,  // between two samples
+  kHeld,          // past the newest sample by at most max_gap_ms: its value
+  kStale,         // no sample within max_gap_ms, or a gap wider than that
+  kTooOld,        // before the oldest sample still held
+};
+
+template <size_t Channels, size_t Depth>
+class AlignedStream {
+ public:
+  static_assert(Channels >= 1 && Depth >= 2, "a stream holds at least two samples");
+
+  /// `latency_ms`: from the instant a sample describes to its arrival.
+  /// `max_gap_ms`: the widest span interpolated across or held past.
+  constexpr AlignedStream(uint32_t latency_ms, uint32_t max_gap_ms)
+      : latency_ms_(latency_ms), max_gap_ms_(max_gap_ms) {}
+
+  /// A sample arriving at `arrival_ms`, describing arrival - latency.
+  bool push_arrival(uint32_t arrival_ms, const float* v) {
+    return push(arrival_ms - latency_ms_, v);
+  }
+
+  /// A sample with the instant it describes. Samples not later than the
+  /// newest one held are counted and dropped.
+  bool push(uint32_t valid_ms, const float* v) {
+    if (count_ > 0 && static_cast<int32_t>(valid_ms - t_[newest()]) <= 0) {
+      ++rejected_;
+      return false;
+    }
+    size_t slot = (head_ + count_) % Depth;
+    if (count_ == Depth) {
+      head_ = (head_ + 1) % Depth;
+    } else {
+      ++count_;
+    }
+    t_[slot] = valid_ms;
+    for (size_t c = 0; c < Channels; ++c) v_[slot][c] = v[c];
+    return true;
+  }
+
+  /// A FIFO burst or DMA block: `n` samples of Channels values, oldest
+  /// first, `period_us` apart, the last one arriving at `arrival_ms`.
+  /// Returns the samples kept.
+  size_t push_block(uint32_t arrival_ms, uint32_t period_us, const float* v, size_t n) {
+    size_t kept = 0;
+    uint32_t last_ms = arrival_ms - latency_ms_;
+    for (size_t i = 0; i < n; ++i) {
+      uint32_t back_ms = static_cast<uint32_t>((static_cast<uint64_t>(n - 1 - i) * period_us +
+                                                500) / 1000);
+      kept += push(last_ms - back_ms, v + i * Channels) ? 1 : 0;
+    }
+    return kept;
+  }
+
+  /// The stream at `epoch_ms` into `out` (Channels values), for
+  /// kInterpolated and kHeld.
+  AlignStatus at(uint32_t epoch_ms, float* out) const {
+    if (count_ == 0) return AlignStatus::kStale;
+    // Epochs trail the newest samples, so search from the newest end.
+    size_t i = count_;
+    while (i > 0 && static_cast<int32_t>(epoch_ms - t_[slot(i - 1)]) < 0) --i;
+    if (i == 0) return AlignStatus::kTooOld;
+    size_t a = slot(i - 1);
+    uint32_t since = epoch_ms - t_[a];
+    if (i == count_) {
+      if (since > max_gap_ms_) return AlignStatus::kStale;
+      for (size_t c = 0; c < Channels; ++c) out[c] = v_[a][c];
+      return AlignStatus::kHeld;
+    }
+    size_t b = slot(i);
+    uint32_t span = t_[b] - t_[a];
+    if (span > max_gap_ms_) return AlignStatus::kStale;
+    float f = static_cast<float>(since) / static_cast<float>(span);
+    for (size_t c = 0; c < Channels; ++c) out[c] = v_[a][c] + f * (v_[b][c] - v_[a][c]);
+    return AlignStatus::kInterpolated;
+  }
+
+  size_t size() const { return count_; }
+  /// The instant the newest sample describes; meaningless while empty.
+  uint32_t newest_ms() const { return t_[newest()]; }
+  uint32_t latency_ms() const { return latency_ms_; }
+  uint32_t rejected() const { return rejected_; }
+  void clear() { head_ = count_ = 0; }
+
+ private:
+  size_t slot(size_t i) const { return (head_ + i) % Depth; }
+  size_t newest() const { return slot(count_ - 1); }
+
+  uint32_t latency_ms_;
+  uint32_t max_gap_ms_;
+  uint32_t t_[Depth] = {};
+  float v_[Depth][Channels] = {};
+  size_t head_ = 0;
+  size_t count_ = 0;
+  uint32_t rejected_ = 0;
+};
+
+}  // namespace skyguard::sensors
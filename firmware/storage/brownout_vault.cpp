@@ -0,0 +1,239 @@
+#include "storage/brownout_vault.h"
+
+#include <string.h>
+
+#include "util/crc32.h"
+
+namespace skyguard::storage {
+
+namespace {
+
+// Slot header, little endian:
+//   u32 seq | u32 payload_len | u32 crc | u32 commit
+// The CRC covers the payload and then seq and payload_len. The header is
+// programmed after the payload, in one operation that ends with the
+// commit word.
+constexpr uint32_t kCommit = 0x56424753;  // "SGBV"
+
+void put_le32(uint8_t* p, uint32_t v) {
+  for (int i = 0; i < 4; ++i) p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+uint32_t get_le32(const uint8_t* p) {
+  return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 |
+         static_cast<uint32_t>(p[2]) << 16 | static_cast<uint32_t>(p[3]) << 24;
+}
+
+uint32_t round_up(uint32_t v, uint32_t unit) { return (v + unit - 1) / unit * unit; }
+
+}  // namespace
+
+uint32_t BrownoutVault::header_span() const {
+  return round_up(kVaultHeaderSize, flash_.program_unit);
+}
+
+bool BrownoutVault::begin(const VaultFlash& flash) {
+  if (flash.slots < 2 || flash.slots > kVaultMaxSlots || flash.program_unit == 0 ||
+      flash.program_unit > kVaultMaxProgramUnit || flash.sector_size == 0 ||
+      flash.slot_size % flash.sector_size || flash.slot_size <= kVaultHeaderSize) {
+    return false;
+  }
+  flash_ = flash;
+  budget_ = flash_.slot_size - header_span();
+  found_ = false;
+  for (uint8_t s = 0; s < flash_.slots; ++s) {
+    uint32_t seq, len;
+    if (check_slot(s, &seq, &len) && (!found_ || static_cast<int32_t>(seq - found_seq_) > 0)) {
+      found_ = true;
+      found_slot_ = s;
+      found_seq_ = seq;
+      found_len_ = len;
+    }
+  }
+  armed_slot_ = found_ ? static_cast<uint8_t>((found_slot_ + 1) % flash_.slots) : 0;
+  next_seq_ = found_ ? found_seq_ + 1 : 1;
+  arm_offset_ = 0;
+  state_.store(static_cast<uint8_t>(VaultState::kUnarmed));
+  return true;
+}
+
+bool BrownoutVault::check_slot(uint8_t slot, uint32_t* seq, uint32_t* len) {
+  uint8_t hdr[kVaultHeaderSize];
+  uint32_t base = slot_addr(slot);
+  if (!flash_.read(flash_.ctx, base, hdr, sizeof(hdr))) return false;
+  if (get_le32(hdr + 12) != kCommit) return false;
+  *seq = get_le32(hdr);
+  *len = get_le32(hdr + 4);
+  if (*len > flash_.slot_size - header_span()) return false;
+  uint32_t crc = kCrc32Init;
+  for (uint32_t off = 0; off < *len;) {
+    uint32_t n = *len - off < sizeof(unit_) ? *len - off : sizeof(unit_);
+    if (!flash_.read(flash_.ctx, base + header_span() + off, unit_, n)) return false;
+    crc = crc32_update(crc, unit_, n);
+    off += n;
+  }
+  crc = crc32_update(crc, hdr, 8) ^ 0xFFFFFFFF;
+  return crc == get_le32(hdr + 8);
+}
+
+void BrownoutVault::set_payload_budget(uint32_t bytes) {
+  uint32_t cap = flash_.slot_size - header_span();
+  budget_ = bytes < cap ? bytes : cap;
+}
+
+uint32_t BrownoutVault::worst_case_us(uint32_t crc_ns_per_byte) const {
+  uint32_t units = (header_span() + round_up(budget_, flash_.program_unit)) / flash_.program_unit;
+  uint64_t crc_ns = static_cast<uint64_t>(crc_ns_per_byte) * (budget_ + 8);
+  return units * flash_.program_unit_max_us + static_cast<uint32_t>((crc_ns + 999) / 1000);
+}
+
+uint32_t BrownoutVault::budget_for_us(uint32_t us, uint32_t crc_ns_per_byte) const {
+  BrownoutVault probe;
+  probe.flash_ = flash_;
+  uint32_t cap = flash_.slot_size - header_span();
+  // Programming dominates; start from the unit count and step down.
+  uint32_t units = us / (flash_.program_unit_max_us ? flash_.program_unit_max_us : 1);
+  uint32_t bytes = units * flash_.program_unit;
+  probe.budget_ = bytes > header_span() ? bytes - header_span() : 0;
+  if (probe.budget_ > cap) probe.budget_ = cap;
+  while (probe.budget_ && probe.worst_case_us(crc_ns_per_byte) > us) {
+    probe.budget_ = probe.budget_ > flash_.program_unit ? probe.budget_ - flash_.program_unit : 0;
+  }
+  return probe.budget_;
+}
+
+bool BrownoutVault::service() {
+  switch (state()) {
+    case VaultState::kArmed:
+      return true;
+    case VaultState::kFlushing:
+      return false;
+    case VaultState::kFlushed:
+      // The supply recovered; move on to the next slot.
+      armed_slot_ = static_cast<uint8_t>((armed_slot_ + 1) % flash_.slots);
+      arm_offset_ = 0;
+      state_.store(static_cast<uint8_t>(VaultState::kUnarmed));
+      return false;
+    case VaultState::kUnarmed:
+      break;
+  }
+  uint32_t sector = slot_addr(armed_slot_) + arm_offset_;
+  bool blank = true;
+  for (uint32_t off = 0; blank && off < flash_.sector_size; off += sizeof(unit_)) {
+    uint32_t n = flash_.sector_size - off < sizeof(unit_) ? flash_.sector_size - off
+                                                          : sizeof(unit_);
+    if (!flash_.read(flash_.ctx, sector + off, unit_, n)) return false;
+    for (uint32_t i = 0; i < n; ++i) blank &= unit_[i] == 0xFF;
+  }
+  if (!blank) {
+    flash_.erase_sector(flash_.ctx, sector);  // checked again next call
+    return false;
+  }
+  arm_offset_ += flash_.sector_size;
+  if (arm_offset_ < flash_.slot_size) return false;
+  state_.store(static_cast<uint8_t>(VaultState::kArmed));
+  return true;
+}
+
+bool BrownoutVault::flush_unit() {
+  if (fill_ == 0) return true;
+  memset(unit_ + fill_, 0xFF, flash_.program_unit - fill_);
+  fill_ = 0;
+  bool ok = flash_.program(flash_.ctx, write_addr_, unit_, flash_.program_unit);
+  write_addr_ += flash_.program_unit;
+  return ok;
+}
+
+bool BrownoutVault::put(const uint8_t* data, size_t n) {
+  crc_ = crc32_update(crc_, data, n);
+  uint32_t unit = flash_.program_unit;
+  while (n) {
+    if (fill_ == 0 && n >= unit) {
+      // Whole units straight from the caller's memory.
+      size_t k = n - n % unit;
+      if (!flash_.program(flash_.ctx, write_addr_, data, k)) return false;
+      write_addr_ += static_cast<uint32_t>(k);
+      data += k;
+      n -= k;
+      continue;
+    }
+    size_t k = unit - fill_ < n ? unit - fill_ : n;
+    memcpy(unit_ + fill_, data, k);
+    fill_ += k;
+    data += k;
+    n -= k;
+    if (fill_ == unit && !flush_unit()) return false;
+  }
+  return true;
+}
+
+bool BrownoutVault::on_brownout(const VaultSource& src) {
+  uint8_t armed = static_cast<uint8_t>(VaultState::kArmed);
+  if (!state_.compare_exchange_strong(armed, static_cast<uint8_t>(VaultState::kFlushing))) {
+    ++missed_;
+    return false;
+  }
+  VaultSpan spans[kVaultMaxSpans];
+  size_t n = src.collect(src.ctx, spans, kVaultMaxSpans, budget_);
+  if (n > kVaultMaxSpans) n = kVaultMaxSpans;
+
+  uint32_t base = slot_addr(armed_slot_);
+  write_addr_ = base + header_span();
+  crc_ = kCrc32Init;
+  fill_ = 0;
+  uint32_t payload = 0;
+  bool ok = true;
+  for (size_t i = 0; ok && i < n; ++i) {
+    uint32_t need = kVaultEntryHeader + spans[i].len;
+    if (payload + need > budget_) {
+      ++dropped_;
+      continue;
+    }
+    uint8_t eh[kVaultEntryHeader] = {spans[i].type, spans[i].version,
+                                     static_cast<uint8_t>(spans[i].len),
+                                     static_cast<uint8_t>(spans[i].len >> 8)};
+    ok = put(eh, sizeof(eh)) && put(spans[i].data, spans[i].len);
+    payload += need;
+  }
+  ok = ok && flush_unit();
+
+  if (ok) {
+    uint8_t* hdr = unit_;
+    memset(hdr, 0xFF, header_span());
+    put_le32(hdr, next_seq_);
+    put_le32(hdr + 4, payload);
+    put_le32(hdr + 8, crc32_update(crc_, hdr, 8) ^ 0xFFFFFFFF);
+    put_le32(hdr + 12, kCommit);
+    ok = flash_.program(flash_.ctx, base, hdr, header_span());
+  }
+  if (!ok) {
+    state_.store(static_cast<uint8_t>(VaultState::kUnarmed));  // slot needs erasing
+    return false;
+  }
+  found_ = true;
+  found_slot_ = armed_slot_;
+  found_seq_ = next_seq_++;
+  found_len_ = payload;
+  last_bytes_ = payload;
+  ++flushes_;
+  state_.store(static_cast<uint8_t>(VaultState::kFlushed));
+  return true;
+}
+
+bool BrownoutVault::read_record(uint32_t offset, uint8_t* out, size_t n) const {
+  if (!found_ || offset > found_len_ || n > found_len_ - offset) return false;
+  return flash_.read(flash_.ctx, slot_addr(found_slot_) + header_span() + offset, out, n);
+}
+
+bool BrownoutVault::next_entry(const uint8_t* payload, uint32_t len, uint32_t* offset,
+                               VaultSpan* out) {
+  if (*offset > len || len - *offset < kVaultEntryHeader) return false;
+  const uint8_t* p = payload + *offset;
+  uint16_t n = static_cast<uint16_t>(p[2] | p[3] << 8);
+  if (len - *offset - kVaultEntryHeader < n) return false;
+  *out = VaultSpan{p[0], p[1], p + kVaultEntryHeader, n};
+  *offset += kVaultEntryHeader + n;
+  return true;
+}
+
+}  // namespace skyguard::storage
@@ -0,0 +1,166 @@
+// Last-gasp save of critical state when the supply collapses.
+//
+// A few slots in internal flash are kept erased ahead of time. When the
+// supply monitor warns (hal::SupplyMonitor), its interrupt calls
+// on_brownout(), which asks the owner for what to save (the checkpoint and
+// the staging log not yet written out, as VaultSpans) and programs it into
+// the armed slot: payload first, header with its CRC and commit word last.
+// Nothing is erased, allocated or waited for on that path, and the bytes it
+// programs are capped by a budget, so its worst-case time is a fixed number
+// of program operations that can be checked against the holdup time of
+// the bulk capacitance (holdup_us(), worst_case_us()).
+//
+// A cut part-way through leaves a slot without a valid commit, which
+// begin() ignores; it then reports the newest complete record. service()
+// re-arms from the main loop after a boot or a warning the supply rode
+// out, one sector operation per call.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+namespace skyguard::storage {
+
+constexpr size_t kVaultMaxSlots = 4;
+constexpr size_t kVaultMaxSpans = 8;
+constexpr size_t kVaultMaxProgramUnit = 256;
+constexpr uint32_t kVaultHeaderSize = 16;
+constexpr uint32_t kVaultEntryHeader = 4;  // type, version, u16 length
+
+struct VaultFlash {
+  bool (*read)(void* ctx, uint32_t addr, uint8_t* out, size_t n);
+  bool (*program)(void* ctx, uint32_t addr, const uint8_t* data, size_t n);
+  bool (*erase_sector)(void* ctx, uint32_t addr);
+  void* ctx;
+  uint32_t base;         // first slot; sector aligned
+  uint32_t slot_size;    // a multiple of sector_size
+  uint32_t sector_size;
+  uint32_t program_unit;
+  uint32_t program_unit_max_us;
+  uint8_t slots;         // 2..kVaultMaxSlots
+};
+
+/// One schema record (or run of records) to save.
+struct VaultSpan {
+  uint8_t type;
+  uint8_t version;
+  const uint8_t* data;
+  uint16_t len;
+};
+
+struct VaultSource {
+  /// Runs in the warning interrupt: fills up to `max` spans, most important
+  /// first, pointing at memory that stays put until the flush returns.
+  /// Spans that would take the payload (kVaultEntryHeader + len each) past
+  /// `budget` bytes are skipped, so trim logs to their newest records.
+  size_t (*collect)(void* ctx, VaultSpan* spans, size_t max, uint32_t budget);
+  void* ctx;
+};
+
+/// Time the bulk capacitance carries a `load_mw` load from the warning
+/// threshold down to the minimum operating voltage.
+constexpr uint32_t holdup_us(uint32_t cap_uf, uint32_t v_warn_mv, uint32_t v_min_mv,
+                             uint32_t load_mw) {
+  // uF * mV^2 / mW is nanoseconds.
+  return static_cast<uint32_t>(static_cast<uint64_t>(cap_uf) *
+                               (static_cast<uint64_t>(v_warn_mv) * v_warn_mv -
+                                static_cast<uint64_t>(v_min_mv) * v_min_mv) /
+                               (2ull * load_mw) / 1000);
+}
+
+enum class VaultState : uint8_t { kUnarmed, kArmed, kFlushing, kFlushed };
+
+class BrownoutVault {
+ public:
+  /// Scans the slots for the newest complete record. Call once at boot.
+  bool begin(const VaultFlash& flash);
+
+  /// Caps the payload programmed by a flush (default: the slot size).
+  void set_payload_budget(uint32_t bytes);
+  uint32_t payload_budget() const { return budget_; }
+  /// Worst-case flush time for the budget; `crc_ns_per_byte` is the CPU
+  /// cost of the checksum.
+  uint32_t worst_case_us(uint32_t crc_ns_per_byte) const;
+  /// Largest budget whose worst case fits in `us`.
+  uint32_t budget_for_us(uint32_t us, uint32_t crc_ns_per_byte) const;
+
+  /// Main loop: one blank check or sector erase per call towards arming
+  /// the next slot. Returns true while armed.
+  bool service();
+
+  /// Supply warning interrupt. Returns true if a record was committed.
+  bool on_brownout(const VaultSource& src);
+
+  VaultState state() const { return static_cast<VaultState>(state_.load()); }
+
+  /// Record found by begin(), if any.
+  bool has_record() const { return found_; }
+  uint32_t record_seq() const { return found_seq_; }
+  uint32_t record_len() const { return found_len_; }
+  /// Reads `n` payload bytes of the found record from `offset`.
+  bool read_record(uint32_t offset, uint8_t* out, size_t n) const;
+  /// Walks entries of a payload held in memory; `*offset` starts at 0.
+  static bool next_entry(const uint8_t* payload, uint32_t len, uint32_t* offset,
+                         VaultSpan* out);
+
+  uint32_t flushes() const { return flushes_; }
+  uint32_t missed_warnings() const { return missed_; }  // warned while not armed
+  uint32_t last_flush_bytes() const { return last_bytes_; }
+  uint32_t dropped_spans() const { return dropped_; }  // over budget
+
+ private:
+  uint32_t slot_addr(uint8_t slot) const { return flash_.base + slot * flash_.slot_size; }
+  uint32_t header_span() const;
+  bool check_slot(uint8_t slot, uint32_t* seq, uint32_t* len);
+  bool put(const uint8_t* data, size_t n);
+  bool flush_unit();
+
+  VaultFlash flash_ = {};
+  uint32_t budget_ = 0;
+  std::atomic<uint8_t> state_{static_cast<uint8_t>(VaultState::kUnarmed)};
+  uint8_t armed_slot_ = 0;
+  uint32_t next_seq_ = 1;
+  uint32_t arm_offset_ = 0;  // next sector of the armed slot to check
+
+  bool found_ = false;
+  uint8_t found_slot_ = 0;
+  uint32_t found_seq_ = 0;
+  uint32_t found_len_ = 0;
+
+  // Flush stream state.
+  uint32_t write_addr_ = 0;
+  uint32_t crc_ = 0;
+  size_t fill_ = 0;
+  alignas(8) uint8_t unit_[kVaultMaxProgramUnit] = {};
+
+  uint32_t flushes_ = 0;
+  uint32_t missed_ = 0;
+  uint32_t last_bytes_ = 0;
+  uint32_t dropped_ = 0;
+};
+
+/// Vault over a hal::Flash region: `slots` slots of `slot_sectors` sectors
+/// starting at sector `first_sector`.
+template <class Flash>
+VaultFlash vault_flash_of(Flash& flash, uint32_t first_sector, uint32_t slot_sectors,
+                          uint8_t slots) {
+  return VaultFlash{
+      [](void* ctx, uint32_t addr, uint8_t* out, size_t n) {
+        return static_cast<Flash*>(ctx)->read(addr, out, n);
+      },
+      [](void* ctx, uint32_t addr, const uint8_t* data, size_t n) {
+        return static_cast<Flash*>(ctx)->program(addr, data, n);
+      },
+      [](void* ctx, uint32_t addr) { return static_cast<Flash*>(ctx)->erase_sector(addr); },
+      &flash,
+      first_sector * flash.sector_size(),
+      slot_sectors * flash.sector_size(),
+      flash.sector_size(),
+      flash.program_unit(),
+      flash.program_unit_max_us(),
+      slots};
+}
+
+}  // namespace skyguard::storage
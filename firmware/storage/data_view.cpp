@@ -0,0 +1,95 @@
+#include "storage/data_view.h"
+
+#include "util/crc32.h"
+
+namespace skyguard::storage {
+
+void PageCache::clear() {
+  for (Page& p : pages_) p.last_use = 0;
+  hits_ = misses_ = bytes_ = 0;
+}
+
+const uint8_t* PageCache::page(const FlashReader& src, uint32_t index) {
+  ++clock_;
+  Page* victim = &pages_[0];
+  for (Page& p : pages_) {
+    if (p.page == index && p.owner == src.ctx && p.last_use) {
+      p.last_use = clock_;
+      ++hits_;
+      return p.data;
+    }
+    if (p.last_use < victim->last_use) victim = &p;
+  }
+  // Pages are valid while last_use is non-zero; the device's last page may
+  // be short.
+  ++misses_;
+  victim->last_use = 0;
+  uint32_t at = index * kPageSize;
+  if (at >= src.size) return nullptr;
+  uint32_t n = src.size - at < kPageSize ? src.size - at : kPageSize;
+  if (!src.read(src.ctx, at, victim->data, n)) return nullptr;
+  bytes_ += n;
+  victim->owner = src.ctx;
+  victim->page = index;
+  victim->last_use = clock_;
+  return victim->data;
+}
+
+bool PageCache::read(const FlashReader& src, uint32_t offset, uint8_t* dst, uint32_t len) {
+  while (len) {
+    const uint8_t* p = page(src, offset / kPageSize);
+    if (!p) return false;
+    uint32_t at = offset % kPageSize;
+    uint32_t n = kPageSize - at < len ? kPageSize - at : len;
+    memcpy(dst, p + at, n);
+    dst += n;
+    offset += n;
+    len -= n;
+  }
+  return true;
+}
+
+DataView DataView::mapped(const uint8_t* base, uint32_t size) {
+  DataView v;
+  v.base_ = base;
+  v.size_ = base ? size : 0;
+  return v;
+}
+
+DataView DataView::paged(const FlashReader& src, PageCache* cache) {
+  DataView v;
+  v.src_ = src;
+  v.cache_ = cache;
+  v.size_ = cache && src.read ? src.size : 0;
+  return v;
+}
+
+DataView DataView::sub(uint32_t offset, uint32_t len) const {
+  if (offset > size_ || len > size_ - offset) return DataView();
+  DataView v = *this;
+  if (base_) v.base_ += offset;
+  v.start_ += offset;
+  v.size_ = len;
+  return v;
+}
+
+bool DataView::crc32(uint32_t offset, uint32_t len, uint32_t* out) const {
+  if (offset > size_ || len > size_ - offset) return false;
+  if (base_) {
+    *out = skyguard::crc32(base_ + offset, len);
+    return true;
+  }
+  uint8_t chunk[kPageSize];
+  uint32_t crc = kCrc32Init;
+  while (len) {
+    uint32_t n = len < kPageSize ? len : kPageSize;
+    if (!src_.read(src_.ctx, start_ + offset, chunk, n)) return false;
+    crc = crc32_update(crc, chunk, n);
+    offset += n;
+    len -= n;
+  }
+  *out = crc ^ 0xFFFFFFFF;
+  return true;
+}
+
+}  // namespace skyguard::storage
@@ -0,0 +1,118 @@
+// Read-only view of a data image in external flash: fence indexes and
+// distance rasters, forecast grids and other uploads too large to copy
+// into RAM.
+//
+// Where the part maps its flash into the address space (QSPI XIP) the view
+// is a plain pointer and fetch() hands out addresses inside the window.
+// Otherwise reads go through a PageCache of 256-byte pages shared by every
+// paged view; fetch() then copies into the caller's scratch. Consumers
+// write one code path against fetch()/read() and get zero-copy access
+// wherever the hardware allows it. Paged views are not thread-safe.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace skyguard::storage {
+
+/// Raw byte reader for a non-mapped device of `size` bytes.
+struct FlashReader {
+  bool (*read)(void* ctx, uint32_t offset, uint8_t* dst, uint32_t len);
+  void* ctx;
+  uint32_t size;
+};
+
+constexpr uint32_t kPageSize = 256;
+constexpr size_t kCachePages = 16;
+
+class PageCache {
+ public:
+  /// Reads through the cache; pages are tagged with the reader's ctx so
+  /// several devices can share one cache.
+  bool read(const FlashReader& src, uint32_t offset, uint8_t* dst, uint32_t len);
+  void clear();
+
+  uint32_t hits() const { return hits_; }
+  /// Each miss is one device read of up to a page.
+  uint32_t misses() const { return misses_; }
+  uint32_t bytes_fetched() const { return bytes_; }
+
+ private:
+  struct Page {
+    const void* owner;
+    uint32_t page;
+    uint32_t last_use;
+    uint8_t data[kPageSize];
+  };
+
+  const uint8_t* page(const FlashReader& src, uint32_t index);
+
+  Page pages_[kCachePages] = {};
+  uint32_t clock_ = 0;
+  uint32_t hits_ = 0, misses_ = 0, bytes_ = 0;
+};
+
+class DataView {
+ public:
+  DataView() = default;
+  /// View of a memory-mapped window (XIP, host mmap or RAM).
+  static DataView mapped(const uint8_t* base, uint32_t size);
+  /// View of a whole device read through `cache`.
+  static DataView paged(const FlashReader& src, PageCache* cache);
+
+  uint32_t size() const { return size_; }
+  bool is_mapped() const { return base_ != nullptr; }
+  /// The mapped window, or nullptr for a paged view.
+  const uint8_t* data() const { return base_; }
+
+  bool read(uint32_t offset, void* dst, uint32_t len) const {
+    if (offset > size_ || len > size_ - offset) return false;
+    if (base_) {
+      memcpy(dst, base_ + offset, len);
+      return true;
+    }
+    return cache_ && cache_->read(src_, start_ + offset, static_cast<uint8_t*>(dst), len);
+  }
+
+  template <class T>
+  bool load(uint32_t offset, T* out) const {
+    return read(offset, out, sizeof(T));
+  }
+
+  /// Bytes [offset, offset + len): a pointer into the window when mapped,
+  /// else `scratch` filled through the cache. nullptr if out of range or
+  /// the device read fails. Mapped pointers keep the image's alignment.
+  const uint8_t* fetch(uint32_t offset, uint32_t len, void* scratch) const {
+    if (base_) return offset <= size_ && len <= size_ - offset ? base_ + offset : nullptr;
+    return read(offset, scratch, len) ? static_cast<const uint8_t*>(scratch) : nullptr;
+  }
+
+  /// View of [offset, offset + len) of this one.
+  DataView sub(uint32_t offset, uint32_t len) const;
+
+  /// CRC-32 of [offset, offset + len). Paged views read the device directly
+  /// so a whole-image check does not flush the cache.
+  bool crc32(uint32_t offset, uint32_t len, uint32_t* out) const;
+
+ private:
+  const uint8_t* base_ = nullptr;
+  FlashReader src_{};
+  PageCache* cache_ = nullptr;
+  uint32_t start_ = 0;  // paged: device offset of byte 0
+  uint32_t size_ = 0;
+};
+
+/// View of a HAL ReadOnlyFlash: mapped if the part supports it, else paged
+/// through `cache`.
+template <class Store>
+DataView view_of(Store& store, PageCache* cache) {
+  if (const uint8_t* window = store.map()) return DataView::mapped(window, store.size());
+  FlashReader reader{[](void* ctx, uint32_t offset, uint8_t* dst, uint32_t len) {
+                       return static_cast<Store*>(ctx)->read(offset, dst, len);
+                     },
+                     &store, store.size()};
+  return DataView::paged(reader, cache);
+}
+
+}  // namespace skyguard::storage
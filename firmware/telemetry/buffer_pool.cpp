@@ -0,0 +1,24 @@
+#include "telemetry/buffer_pool.h"
+
+namespace skyguard::telemetry {
+
+int BufferPool::acquire() {
+  for (uint8_t i = 0; i < n_blocks_; ++i) {
+    uint8_t expected = 0;
+    if (refs_[i].compare_exchange_strong(expected, 1, std::memory_order_acquire)) {
+      uint8_t n = static_cast<uint8_t>(in_use_.fetch_add(1, std::memory_order_relaxed) + 1);
+      if (n > high_water_) high_water_ = n;
+      return i;
+    }
+  }
+  ++exhausted_;
+  return -1;
+}
+
+void BufferPool::release(int block) {
+  if (refs_[block].fetch_sub(1, std::memory_order_release) == 1) {
+    in_use_.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace skyguard::telemetry
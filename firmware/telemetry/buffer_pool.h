@@ -0,0 +1,55 @@
+// Fixed-size, reference-counted buffer blocks shared between producers and
+// DMA consumers.
+//
+// A producer acquires a block, writes into it once and hands references to
+// frames; the block returns to the pool when the last reference is released,
+// typically from a DMA-complete interrupt. Reference counts are atomics so
+// acquire/release are safe between thread and interrupt context.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+namespace skyguard::telemetry {
+
+class BufferPool {
+ public:
+  BufferPool(uint8_t* storage, std::atomic<uint8_t>* refs, uint16_t block_size,
+             uint8_t n_blocks)
+      : storage_(storage), refs_(refs), block_size_(block_size), n_blocks_(n_blocks) {}
+
+  /// Returns a block index with one reference held, or -1 if exhausted.
+  int acquire();
+  void retain(int block) { refs_[block].fetch_add(1, std::memory_order_relaxed); }
+  void release(int block);
+
+  uint8_t* data(int block) { return storage_ + static_cast<size_t>(block) * block_size_; }
+  uint16_t block_size() const { return block_size_; }
+  uint8_t in_use() const { return in_use_.load(std::memory_order_relaxed); }
+  uint8_t high_water() const { return high_water_; }
+  uint32_t exhausted() const { return exhausted_; }
+
+ private:
+  uint8_t* storage_;
+  std::atomic<uint8_t>* refs_;
+  uint16_t block_size_;
+  uint8_t n_blocks_;
+  std::atomic<uint8_t> in_use_{0};
+  uint8_t high_water_ = 0;
+  uint32_t exhausted_ = 0;
+};
+
+/// Pool with statically allocated storage.
+template <uint16_t BlockSize, uint8_t NBlocks>
+class StaticBufferPool : public BufferPool {
+ public:
+  StaticBufferPool() : BufferPool(storage_, refs_, BlockSize, NBlocks) {}
+
+ private:
+  alignas(4) uint8_t storage_[static_cast<size_t>(BlockSize) * NBlocks] = {};
+  std::atomic<uint8_t> refs_[NBlocks] = {};
+};
+
+}  // namespace skyguard::telemetry
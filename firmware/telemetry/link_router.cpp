@@ -0,0 +1,292 @@
+#include "telemetry/link_router.h"
+
+namespace skyguard::telemetry {
+
+namespace {
+constexpr float kAvailabilityAlpha = 0.2f;
+constexpr float kLatencyAlpha = 0.25f;
+
+bool expired(uint32_t now_ms, uint32_t deadline_ms) {
+  return static_cast<int32_t>(now_ms - deadline_ms) > 0;
+}
+}  // namespace
+
+int LinkRouter::add_link(const LinkConfig& cfg) {
+  if (n_links_ >= kMaxLinks) return -1;
+  uint8_t i = static_cast<uint8_t>(n_links_++);
+  cfg_[i] = cfg;
+  stats_[i] = LinkStats{};
+  stats_[i].up = true;
+  stats_[i].availability = cfg.ack_timeout_ms ? 1.0f : cfg.unacked_delivery;
+  stats_[i].latency_ms = static_cast<float>(cfg.nominal_latency_ms);
+  return i;
+}
+
+void LinkRouter::set_link_up(uint8_t link, bool up) {
+  if (link < n_links_) stats_[link].up = up;
+}
+
+size_t LinkRouter::queued() const {
+  size_t n = 0;
+  for (const Message& m : queue_) n += m.used ? 1 : 0;
+  return n;
+}
+
+LinkRouter::Message* LinkRouter::find(uint16_t msg_id) {
+  for (Message& m : queue_) {
+    if (m.used && m.id == msg_id) return &m;
+  }
+  return nullptr;
+}
+
+bool LinkRouter::submit(uint16_t msg_id, Urgency urgency, uint32_t deadline_ms,
+                        uint32_t now_ms, uint8_t link_mask) {
+  if (find(msg_id)) return false;
+  for (Message& m : queue_) {
+    if (m.used) continue;
+    m = Message{};
+    m.used = true;
+    m.id = msg_id;
+    m.urgency = urgency;
+    m.created_ms = now_ms;
+    m.deadline_ms = now_ms + deadline_ms;
+    m.allowed_mask = link_mask;
+    if (urgency == Urgency::kTermination) service(m, now_ms);
+    return true;
+  }
+  return false;
+}
+
+void LinkRouter::cancel(uint16_t msg_id) {
+  if (Message* m = find(msg_id)) m->used = false;
+}
+
+float LinkRouter::expected_latency_ms(uint8_t link) const {
+  const LinkStats& s = stats_[link];
+  uint32_t retry = cfg_[link].ack_timeout_ms ? cfg_[link].ack_timeout_ms
+                                             : cfg_[link].nominal_latency_ms;
+  return s.latency_ms + (1.0f - s.availability) * static_cast<float>(retry);
+}
+
+int LinkRouter::pick_link(const Message& m, uint32_t now_ms, bool must_meet,
+                          bool need_ack) const {
+  int best = -1;
+  float best_latency = 0;
+  for (uint8_t i = 0; i < n_links_; ++i) {
+    const LinkStats& s = stats_[i];
+    if (!s.up || s.busy || (m.failed_mask & (1u << i)) || !(m.allowed_mask & (1u << i))) {
+      continue;
+    }
+    if (need_ack && cfg_[i].ack_timeout_ms == 0) continue;
+    float lat = expected_latency_ms(i);
+    if (must_meet &&
+        static_cast<int32_t>(m.deadline_ms - now_ms) < static_cast<int32_t>(lat)) {
+      continue;
+    }
+    bool better;
+    if (best < 0) {
+      better = true;
+    } else if (must_meet && cfg_[i].cost_micro_usd != cfg_[best].cost_micro_usd) {
+      better = cfg_[i].cost_micro_usd < cfg_[best].cost_micro_usd;
+    } else if (must_meet && (cfg_[i].ack_timeout_ms != 0) != (cfg_[best].ack_timeout_ms != 0)) {
+      // An acknowledged link retries its losses and keeps its estimate fresh.
+      better = cfg_[i].ack_timeout_ms != 0;
+    } else if (must_meet && s.availability != stats_[best].availability) {
+      better = s.availability > stats_[best].availability;
+    } else {
+      better = lat < best_latency;
+    }
+    if (better) {
+      best = i;
+      best_latency = lat;
+    }
+  }
+  return best;
+}
+
+bool LinkRouter::try_send(Message& m, uint8_t link, uint32_t now_ms) {
+  stats_[link].busy = true;
+  if (!hooks_.send(hooks_.ctx, link, m.id)) {
+    stats_[link].busy = false;  // refused locally: says nothing about the link
+    return false;
+  }
+  ++stats_[link].sent;
+  m.sent_mask |= static_cast<uint8_t>(1u << link);
+  m.sent_at_ms[link] = now_ms;
+  return true;
+}
+
+void LinkRouter::record_attempt(uint8_t link, bool ok, uint32_t latency_ms) {
+  LinkStats& s = stats_[link];
+  float success = cfg_[link].ack_timeout_ms ? 1.0f : cfg_[link].unacked_delivery;
+  s.availability += kAvailabilityAlpha * ((ok ? success : 0.0f) - s.availability);
+  if (ok) {
+    s.latency_ms += kLatencyAlpha * (static_cast<float>(latency_ms) - s.latency_ms);
+  } else {
+    ++s.failed;
+  }
+}
+
+void LinkRouter::service(Message& m, uint32_t now_ms) {
+  if (m.urgency == Urgency::kTermination) {
+    // Every link that is up gets a copy; failed links are simply retried.
+    for (uint8_t i = 0; i < n_links_; ++i) {
+      uint8_t bit = static_cast<uint8_t>(1u << i);
+      if (!stats_[i].up || stats_[i].busy || !(m.allowed_mask & bit) ||
+          ((m.sent_mask | m.done_mask) & bit)) {
+        continue;
+      }
+      try_send(m, i, now_ms);
+    }
+    return;
+  }
+
+  if (m.sent_mask) return;  // one attempt at a time
+  if (expired(now_ms, m.deadline_ms)) {
+    drop(m);
+    return;
+  }
+  int link;
+  if (m.urgency == Urgency::kAlert) {
+    // Alerts want confirmed delivery: cheapest acknowledged link that meets
+    // the deadline, else the fastest acknowledged one, else anything.
+    link = pick_link(m, now_ms, true, true);
+    if (link < 0) link = pick_link(m, now_ms, false, true);
+    if (link < 0) link = pick_link(m, now_ms, false, false);
+  } else {
+    link = pick_link(m, now_ms, true, false);
+  }
+  if (link >= 0 && !try_send(m, static_cast<uint8_t>(link), now_ms)) {
+    m.failed_mask |= static_cast<uint8_t>(1u << link);
+  }
+  uint8_t usable = static_cast<uint8_t>(m.allowed_mask & ((1u << n_links_) - 1));
+  if ((m.failed_mask & usable) == usable) {
+    m.failed_mask = 0;  // every usable link failed once; start over
+  }
+}
+
+void LinkRouter::tick(uint32_t now_ms) {
+  for (Message& m : queue_) {
+    if (!m.used) continue;
+    for (uint8_t i = 0; i < n_links_; ++i) {
+      uint8_t bit = static_cast<uint8_t>(1u << i);
+      if (!(m.acking_mask & bit) ||
+          !expired(now_ms, m.sent_at_ms[i] + cfg_[i].ack_timeout_ms)) {
+        continue;
+      }
+      record_attempt(i, false, 0);
+      m.sent_mask &= static_cast<uint8_t>(~bit);
+      m.acking_mask &= static_cast<uint8_t>(~bit);
+      if (m.urgency != Urgency::kTermination) {
+        m.failed_mask |= bit;
+      } else if (!m.acked) {
+        m.done_mask &= static_cast<uint8_t>(~bit);  // resend on this link
+      }
+    }
+  }
+  // Enumerators are ordered most urgent first.
+  for (uint8_t u = 0; u <= static_cast<uint8_t>(Urgency::kRoutine); ++u) {
+    for (Message& m : queue_) {
+      if (!m.used || static_cast<uint8_t>(m.urgency) != u) continue;
+      service(m, now_ms);
+      if (m.delivered) maybe_retire(m);
+    }
+  }
+}
+
+void LinkRouter::on_tx_done(uint8_t link, uint16_t msg_id, bool ok,
+                            uint32_t now_ms) {
+  if (link >= n_links_) return;
+  stats_[link].busy = false;
+  if (ok) stats_[link].cost_micro_usd += cfg_[link].cost_micro_usd;
+
+  Message* m = find(msg_id);
+  uint8_t bit = static_cast<uint8_t>(1u << link);
+  if (!m || !(m->sent_mask & bit)) return;
+  if (!ok) {
+    record_attempt(link, false, 0);
+    m->sent_mask &= static_cast<uint8_t>(~bit);
+    if (m->urgency != Urgency::kTermination) m->failed_mask |= bit;
+    return;
+  }
+  m->done_mask |= bit;
+  if (cfg_[link].ack_timeout_ms) {
+    m->acking_mask |= bit;
+    return;
+  }
+  m->sent_mask &= static_cast<uint8_t>(~bit);
+  record_attempt(link, true, now_ms - m->sent_at_ms[link]);
+  deliver(*m, link, now_ms);
+}
+
+void LinkRouter::on_ack(uint8_t link, uint16_t msg_id, uint32_t now_ms) {
+  if (link >= n_links_) return;
+  Message* m = find(msg_id);
+  if (!m) {
+    if (recently_acked(msg_id)) ++duplicate_acks_;
+    return;
+  }
+  uint8_t bit = static_cast<uint8_t>(1u << link);
+  if (m->sent_mask & bit) {
+    record_attempt(link, true, now_ms - m->sent_at_ms[link]);
+    m->sent_mask &= static_cast<uint8_t>(~bit);
+    m->acking_mask &= static_cast<uint8_t>(~bit);
+    m->done_mask |= bit;
+  }
+  if (m->acked) ++duplicate_acks_;
+  m->acked = true;
+  deliver(*m, link, now_ms);
+}
+
+void LinkRouter::deliver(Message& m, uint8_t link, uint32_t now_ms) {
+  if (!m.delivered) {
+    m.delivered = true;
+    remember_ack(m.id);
+    if (hooks_.delivered) {
+      hooks_.delivered(hooks_.ctx, m.id, link, now_ms - m.created_ms);
+    }
+  }
+  maybe_retire(m);
+}
+
+void LinkRouter::maybe_retire(Message& m) {
+  if (m.urgency != Urgency::kTermination) {
+    if (m.delivered) retire(m);
+    return;
+  }
+  // Termination stays queued until every link that is up has carried it,
+  // and until it is acknowledged if any of those links can acknowledge.
+  bool ackable = false;
+  for (uint8_t i = 0; i < n_links_; ++i) {
+    if (!stats_[i].up || !(m.allowed_mask & (1u << i))) continue;
+    if (!(m.done_mask & (1u << i))) return;
+    ackable |= cfg_[i].ack_timeout_ms != 0;
+  }
+  if (m.acked || !ackable) retire(m);
+}
+
+void LinkRouter::retire(Message& m) {
+  m.used = false;
+  if (hooks_.retired) hooks_.retired(hooks_.ctx, m.id);
+}
+
+void LinkRouter::drop(Message& m) {
+  m.used = false;
+  ++dropped_;
+  if (hooks_.dropped) hooks_.dropped(hooks_.ctx, m.id);
+}
+
+void LinkRouter::remember_ack(uint16_t msg_id) {
+  recent_acks_[recent_head_] = msg_id;
+  recent_head_ = (recent_head_ + 1) % kRouterRecentAcks;
+  if (n_recent_ < kRouterRecentAcks) ++n_recent_;
+}
+
+bool LinkRouter::recently_acked(uint16_t msg_id) const {
+  for (size_t i = 0; i < n_recent_; ++i) {
+    if (recent_acks_[i] == msg_id) return true;
+  }
+  return false;
+}
+
+}  // namespace skyguard::telemetry
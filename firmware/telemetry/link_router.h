@@ -0,0 +1,144 @@
+// Cost- and latency-aware routing of telemetry messages across radio links.
+//
+// The router never touches payloads: it holds message ids and asks the
+// owning code to transmit an id on a chosen link through RouterHooks. Each
+// link's availability and delivery latency are tracked as running averages
+// from its own send/ack history. A link without acknowledgments cannot see
+// its losses, so a finished transmit only counts as its configured delivery
+// prior, not as a delivery.
+//
+// Policy:
+//  - kTermination goes out on every link that is up as soon as it is
+//    submitted and is retried per link until any link acknowledges it.
+//  - kAlert and kRoutine go on the cheapest link whose expected latency
+//    still meets the message deadline; among equally cheap links, one that
+//    acknowledges, then the one most likely to deliver, then the fastest.
+//    A link without acks is used when the others fail. Alerts only use
+//    links that can acknowledge while one is up, and fall back to the
+//    fastest link when none meets the deadline; routine messages wait and
+//    are dropped at the deadline.
+//  - A message may be restricted to a subset of links (e.g. records that a
+//    link cannot carry); the policy above applies within that subset.
+//  - Acknowledgments are matched by id; repeats and acks for messages
+//    already retired are counted and ignored.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "config/build_profile.h"
+
+namespace skyguard::telemetry {
+
+constexpr size_t kMaxLinks = profile::kRadioLinkCount;
+constexpr size_t kRouterQueueLen = 16;
+constexpr size_t kRouterRecentAcks = 16;
+
+enum class Urgency : uint8_t { kTermination, kAlert, kRoutine };
+
+struct LinkConfig {
+  const char* name;
+  uint32_t cost_micro_usd;      // per message sent
+  uint32_t nominal_latency_ms;  // seeds the latency estimate
+  uint32_t ack_timeout_ms;      // 0: no acknowledgments, tx done is delivery
+  float unacked_delivery = 0.5f;  // without acks: share of tx done assumed delivered
+};
+
+struct LinkStats {
+  bool up;
+  bool busy;             // a transmit is in progress
+  float availability;    // EWMA of attempt success, 0..1 (see unacked_delivery)
+  float latency_ms;      // EWMA of send-to-delivery time
+  uint32_t sent;
+  uint32_t failed;
+  uint64_t cost_micro_usd;
+};
+
+struct RouterHooks {
+  /// Start sending `msg_id` on `link`. Return false if it cannot be queued;
+  /// the link is tried again later and is not charged with a failure.
+  bool (*send)(void* ctx, uint8_t link, uint16_t msg_id);
+  /// Optional: the message was delivered (first ack or tx done). A
+  /// kTermination message may still be sent on other links after this.
+  void (*delivered)(void* ctx, uint16_t msg_id, uint8_t link,
+                    uint32_t latency_ms);
+  /// Optional: the message was dropped without delivery.
+  void (*dropped)(void* ctx, uint16_t msg_id);
+  /// Optional: a delivered message left the queue, so send() will not be
+  /// asked for it again and its payload can be freed.
+  void (*retired)(void* ctx, uint16_t msg_id);
+  void* ctx;
+};
+
+class LinkRouter {
+ public:
+  explicit LinkRouter(const RouterHooks& hooks) : hooks_(hooks) {}
+
+  /// Returns the link index, or -1 if all slots are taken.
+  int add_link(const LinkConfig& cfg);
+  void set_link_up(uint8_t link, bool up);
+
+  /// Queues a message. `deadline_ms` is relative to `now_ms`; `link_mask`
+  /// has bit i set for each link index the message may use. Returns false
+  /// if the queue is full or the id is already queued.
+  bool submit(uint16_t msg_id, Urgency urgency, uint32_t deadline_ms,
+              uint32_t now_ms, uint8_t link_mask = 0xFF);
+  void cancel(uint16_t msg_id);
+
+  /// Link driver events.
+  void on_tx_done(uint8_t link, uint16_t msg_id, bool ok, uint32_t now_ms);
+  void on_ack(uint8_t link, uint16_t msg_id, uint32_t now_ms);
+
+  /// Schedules queued messages and expires timeouts; call every tick.
+  void tick(uint32_t now_ms);
+
+  const LinkStats& link_stats(uint8_t link) const { return stats_[link]; }
+  size_t link_count() const { return n_links_; }
+  size_t queued() const;
+  uint32_t duplicate_acks() const { return duplicate_acks_; }
+  uint32_t dropped() const { return dropped_; }
+
+ private:
+  struct Message {
+    bool used;
+    uint16_t id;
+    Urgency urgency;
+    uint32_t created_ms;
+    uint32_t deadline_ms;  // absolute
+    bool delivered;        // delivery already reported
+    bool acked;            // acknowledged on some link
+    uint8_t sent_mask;     // links sending or awaiting an ack
+    uint8_t acking_mask;   // subset of sent_mask past tx done
+    uint8_t done_mask;     // links that transmitted it successfully
+    uint8_t failed_mask;   // links not to retry for this message
+    uint8_t allowed_mask;  // links this message may use
+    uint32_t sent_at_ms[kMaxLinks];
+  };
+
+  Message* find(uint16_t msg_id);
+  void service(Message& m, uint32_t now_ms);
+  bool try_send(Message& m, uint8_t link, uint32_t now_ms);
+  int pick_link(const Message& m, uint32_t now_ms, bool must_meet,
+                bool need_ack) const;
+  float expected_latency_ms(uint8_t link) const;
+  void record_attempt(uint8_t link, bool ok, uint32_t latency_ms);
+  void deliver(Message& m, uint8_t link, uint32_t now_ms);
+  void maybe_retire(Message& m);
+  void retire(Message& m);
+  void drop(Message& m);
+  void remember_ack(uint16_t msg_id);
+  bool recently_acked(uint16_t msg_id) const;
+
+  RouterHooks hooks_;
+  LinkConfig cfg_[kMaxLinks] = {};
+  LinkStats stats_[kMaxLinks] = {};
+  size_t n_links_ = 0;
+  Message queue_[kRouterQueueLen] = {};
+  uint16_t recent_acks_[kRouterRecentAcks] = {};
+  size_t n_recent_ = 0;
+  size_t recent_head_ = 0;
+  uint32_t duplicate_acks_ = 0;
+  uint32_t dropped_ = 0;
+};
+
+}  // namespace skyguard::telemetry
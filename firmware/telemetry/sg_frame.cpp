@@ -0,0 +1,78 @@
+#include "telemetry/sg_frame.h"
+
+#include "util/crc16.h"
+
+namespace skyguard::telemetry {
+
+namespace {
+void put_u16(uint8_t* p, uint16_t v) {
+  p[0] = static_cast<uint8_t>(v & 0xFF);
+  p[1] = static_cast<uint8_t>(v >> 8);
+}
+}  // namespace
+
+void SgFrame::begin(uint8_t type, uint8_t flags, uint16_t seq) {
+  release();
+  put_u16(header_, kFrameSync);
+  header_[2] = type;
+  header_[3] = flags;
+  put_u16(header_ + 4, seq);
+  put_u16(header_ + 6, 0);
+  segs_[0] = {header_, static_cast<uint16_t>(kFrameHeaderLen)};
+  n_segs_ = 1;
+  payload_len_ = 0;
+  finished_ = false;
+}
+
+bool SgFrame::add(const void* data, uint16_t len) {
+  if (finished_ || n_segs_ == 0 || n_segs_ + 1 >= kSgMaxSegments) return false;
+  if (len == 0) return true;
+  if (len > kSgMaxPayloadLen - payload_len_) return false;
+  segs_[n_segs_++] = {static_cast<const uint8_t*>(data), len};
+  payload_len_ = static_cast<uint16_t>(payload_len_ + len);
+  return true;
+}
+
+bool SgFrame::add_pooled(BufferPool& pool, int block, uint16_t len) {
+  if (block < 0 || len > pool.block_size()) return false;
+  size_t slot = n_segs_;
+  if (!add(pool.data(block), len)) return false;
+  if (n_segs_ == slot) return true;  // empty segment, nothing referenced
+  pool.retain(block);
+  pools_[slot] = &pool;
+  blocks_[slot] = static_cast<int16_t>(block);
+  return true;
+}
+
+bool SgFrame::finish() {
+  if (finished_ || n_segs_ < 2) return false;
+  put_u16(header_ + 6, payload_len_);
+  uint16_t crc = kCrc16X25Init;
+  crc = crc16_x25_update(crc, header_ + 2, kFrameHeaderLen - 2);
+  for (size_t i = 1; i < n_segs_; ++i) {
+    crc = crc16_x25_update(crc, segs_[i].data, segs_[i].len);
+  }
+  put_u16(trailer_, static_cast<uint16_t>(crc ^ 0xFFFF));
+  segs_[n_segs_++] = {trailer_, static_cast<uint16_t>(kFrameTrailerLen)};
+  finished_ = true;
+  return true;
+}
+
+void SgFrame::release() {
+  for (size_t i = 0; i < n_segs_; ++i) {
+    if (pools_[i]) {
+      pools_[i]->release(blocks_[i]);
+      pools_[i] = nullptr;
+    }
+  }
+  n_segs_ = 0;
+  finished_ = false;
+}
+
+uint16_t SgFrame::length() const {
+  uint16_t n = 0;
+  for (size_t i = 0; i < n_segs_; ++i) n = static_cast<uint16_t>(n + segs_[i].len);
+  return n;
+}
+
+}  // namespace skyguard::telemetry
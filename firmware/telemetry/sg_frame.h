@@ -0,0 +1,89 @@
+// Telemetry frames assembled as scatter-gather descriptors.
+//
+// A frame is a short header the frame owns, a list of references into
+// producer memory (pooled blocks or other storage that outlives the
+// transmit), and a CRC trailer computed by streaming over those references.
+// Payload bytes are never copied: the segment list is what the radio or
+// modem driver programs into its DMA.
+//
+// Wire format (little endian):
+//   sync u16 | type u8 | flags u8 | seq u16 | payload_len u16 | payload | crc u16
+// The CRC-16/X.25 covers everything from `type` to the end of the payload.
+// For schema records, `type` is the record id and `flags` its version.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "telemetry/buffer_pool.h"
+
+namespace skyguard::telemetry {
+
+constexpr uint16_t kFrameSync = 0x4753;  // "SG" on the wire
+constexpr size_t kFrameHeaderLen = 8;
+constexpr size_t kFrameTrailerLen = 2;
+constexpr size_t kSgMaxPayloadSegments = 8;
+constexpr size_t kSgMaxSegments = kSgMaxPayloadSegments + 2;
+// The whole frame's length must fit the u16 segment and length fields.
+constexpr size_t kSgMaxPayloadLen = 0xFFFF - kFrameHeaderLen - kFrameTrailerLen;
+
+struct SgSegment {
+  const uint8_t* data;
+  uint16_t len;
+};
+
+class SgFrame {
+ public:
+  SgFrame() = default;
+  SgFrame(const SgFrame&) = delete;
+  SgFrame& operator=(const SgFrame&) = delete;
+  ~SgFrame() { release(); }
+
+  /// Starts a new frame, dropping any references still held.
+  void begin(uint8_t type, uint8_t flags, uint16_t seq);
+
+  /// References `len` bytes that the caller keeps unchanged until release().
+  /// Returns false if the segment list is full or the payload would exceed
+  /// kSgMaxPayloadLen.
+  bool add(const void* data, uint16_t len);
+
+  /// References the first `len` bytes of a pooled block; holds a reference
+  /// until release().
+  bool add_pooled(BufferPool& pool, int block, uint16_t len);
+
+  /// Fills in the header length and streams the CRC over all segments.
+  /// Returns false if the frame is empty or already finished.
+  bool finish();
+
+  /// Drops pool references. Call once the DMA that read the frame is done.
+  void release();
+
+  const SgSegment* segments() const { return segs_; }
+  size_t segment_count() const { return n_segs_; }
+  uint16_t length() const;
+
+  /// Bytes written by the frame itself (header and CRC) rather than
+  /// referenced from producers.
+  static constexpr size_t inline_bytes() { return kFrameHeaderLen + kFrameTrailerLen; }
+
+ private:
+  uint8_t header_[kFrameHeaderLen] = {};
+  uint8_t trailer_[kFrameTrailerLen] = {};
+  SgSegment segs_[kSgMaxSegments] = {};
+  size_t n_segs_ = 0;
+  BufferPool* pools_[kSgMaxSegments] = {};
+  int16_t blocks_[kSgMaxSegments] = {};  // pools hold up to 255 blocks
+  uint16_t payload_len_ = 0;
+  bool finished_ = false;
+};
+
+/// Driver-side hook: queue the segments of a finished frame for DMA (as a
+/// linked descriptor list or chained transfers). Returns false if the
+/// driver is busy. The driver reports completion to the frame's owner,
+/// which then calls release().
+struct SgTxPort {
+  bool (*submit)(void* ctx, const SgFrame& frame);
+  void* ctx;
+};
+
+}  // namespace skyguard::telemetry
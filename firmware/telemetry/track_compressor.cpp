@@ -0,0 +1,115 @@
+#include "telemetry/track_compressor.h"
+
+#include <math.h>
+
+#include "geofence/fence_format.h"
+
+namespace skyguard::telemetry {
+
+namespace {
+
+using geofence::kMetresPerLatE7;
+
+constexpr float kInvSqrt2 = 0.70710678f;
+constexpr float kMinCos = 0.1f;  // keeps longitude metres finite near the poles
+
+int32_t round_i32(float v) { return static_cast<int32_t>(lroundf(v)); }
+
+}  // namespace
+
+TrackTolerance track_tolerance(const TrackToleranceSchedule& s, int32_t fence_margin_m,
+                               bool event) {
+  if (event || fence_margin_m <= 0) return s.tight;
+  if (fence_margin_m >= s.fence_taper_m) return s.cruise;
+  float f = static_cast<float>(fence_margin_m) / static_cast<float>(s.fence_taper_m);
+  return {s.tight.horizontal_m + f * (s.cruise.horizontal_m - s.tight.horizontal_m),
+          s.tight.vertical_m + f * (s.cruise.vertical_m - s.tight.vertical_m)};
+}
+
+void TrackCompressor::reset() { *this = TrackCompressor(); }
+
+void TrackCompressor::offset_m(const TrackPoint& p, float* v) const {
+  v[0] = static_cast<float>(static_cast<int64_t>(p.lat_e7) - anchor_.lat_e7) * kMetresPerLatE7;
+  v[1] = static_cast<float>(static_cast<int64_t>(p.lon_e7) - anchor_.lon_e7) * lon_m_per_e7_;
+  v[2] = static_cast<float>(static_cast<int64_t>(p.alt_mm) - anchor_.alt_mm) * 0.001f;
+}
+
+TrackPoint TrackCompressor::place(uint32_t time_ms) const {
+  float dt = static_cast<float>(time_ms - anchor_.time_ms) * 0.001f;
+  float mid[3];
+  for (int k = 0; k < 3; ++k) mid[k] = 0.5f * (lo_[k] + hi_[k]) * dt;
+  return {time_ms, anchor_.lat_e7 + round_i32(mid[0] / kMetresPerLatE7),
+          anchor_.lon_e7 + round_i32(mid[1] / lon_m_per_e7_),
+          anchor_.alt_mm + round_i32(mid[2] * 1000.0f)};
+}
+
+void TrackCompressor::archive(const TrackPoint& p) {
+  anchor_ = p;
+  float c = cosf(static_cast<float>(p.lat_e7) * 1e-7f * 0.017453293f);
+  lon_m_per_e7_ = kMetresPerLatE7 * (c < kMinCos ? kMinCos : c);
+  held_ = 0;
+  ++reported_;
+}
+
+bool TrackCompressor::push(const TrackPoint& fix, const TrackTolerance& tol, TrackPoint* out) {
+  if (!started_) {
+    started_ = true;
+    ++pushed_;
+    archive(fix);
+    last_ = fix;
+    *out = fix;
+    return true;
+  }
+  if (static_cast<int32_t>(fix.time_ms - last_.time_ms) <= 0) return false;
+  ++pushed_;
+
+  const float t[3] = {tol.horizontal_m * kInvSqrt2, tol.horizontal_m * kInvSqrt2,
+                      tol.vertical_m};
+  float v[3], lo[3], hi[3];
+  offset_m(fix, v);
+  float inv_dt = 1000.0f / static_cast<float>(fix.time_ms - anchor_.time_ms);
+  bool closed = false;
+  for (int k = 0; k < 3; ++k) {
+    lo[k] = (v[k] - t[k]) * inv_dt;
+    hi[k] = (v[k] + t[k]) * inv_dt;
+    if (held_ > 0) {
+      if (lo_[k] > lo[k]) lo[k] = lo_[k];
+      if (hi_[k] < hi[k]) hi[k] = hi_[k];
+    }
+    closed |= lo[k] > hi[k];
+  }
+  bool report = false;
+  if (closed) {
+    // No line from the anchor fits this fix too: report the previous fix
+    // and restart the doors there.
+    *out = place(last_.time_ms);
+    archive(*out);
+    report = true;
+    offset_m(fix, v);
+    inv_dt = 1000.0f / static_cast<float>(fix.time_ms - anchor_.time_ms);
+    for (int k = 0; k < 3; ++k) {
+      lo[k] = (v[k] - t[k]) * inv_dt;
+      hi[k] = (v[k] + t[k]) * inv_dt;
+    }
+  }
+  for (int k = 0; k < 3; ++k) {
+    lo_[k] = lo[k];
+    hi_[k] = hi[k];
+  }
+  ++held_;
+  last_ = fix;
+  return report;
+}
+
+bool TrackCompressor::flush(TrackPoint* out) {
+  if (!started_) return false;
+  if (held_ == 0) {
+    *out = anchor_;
+    return true;
+  }
+  *out = place(last_.time_ms);
+  archive(*out);
+  return true;
+}
+
+}  // namespace skyguard::telemetry
@@ -0,0 +1,85 @@
+// Significance-based position reporting: a streaming swinging-door
+// compressor over GPS fixes.
+//
+// The ground reconstructs the track by linear interpolation between
+// reported points, so a point is reported only when no straight line from
+// the last reported point can stay within tolerance of every fix since.
+// Each axis (north, east, up, in metres from the last reported point)
+// keeps a "door": the range of slopes that still fits every fix so far.
+// Each new fix narrows the door to slopes passing within its tolerance.
+// When some axis's door closes, the previous fix's time is reported with
+// the position the middle of the open doors gives it, which is within
+// tolerance of every fix it spans (the reported position is not the raw
+// fix, but at most one tolerance from it). Then the doors restart from
+// there with the new fix.
+//
+// Each fix carries its own tolerance, so tightening takes effect from the
+// next fix without disturbing the guarantee for earlier ones. Horizontal
+// tolerance is a radius: each horizontal axis gets tolerance / sqrt(2).
+// Apart from float and e7/mm rounding (about a centimetre), every fix is
+// within its tolerance of the interpolated track.
+#pragma once
+
+#include <stdint.h>
+
+namespace skyguard::telemetry {
+
+struct TrackPoint {
+  uint32_t time_ms;
+  int32_t lat_e7;
+  int32_t lon_e7;
+  int32_t alt_mm;
+};
+
+struct TrackTolerance {
+  float horizontal_m;
+  float vertical_m;
+};
+
+struct TrackToleranceSchedule {
+  TrackTolerance cruise = {250.0f, 100.0f};
+  TrackTolerance tight = {25.0f, 10.0f};
+  int32_t fence_taper_m = 10000;  // margin at which tightening starts
+};
+
+/// `tight` during an event or at (or beyond) the fence; `cruise` from
+/// fence_taper_m of margin inward, linear in between.
+TrackTolerance track_tolerance(const TrackToleranceSchedule& s, int32_t fence_margin_m,
+                               bool event);
+
+class TrackCompressor {
+ public:
+  /// Feeds one fix. Returns true with `out` set when a point must be
+  /// reported: the first fix, or a door closing (then `out` is at the
+  /// previous fix's time). Fixes not later than the previous one are
+  /// ignored.
+  bool push(const TrackPoint& fix, const TrackTolerance& tol, TrackPoint* out);
+
+  /// Reports the held fixes now (heartbeat, lost GPS, an event): the most
+  /// recent fix as the doors place it, or the last reported point again if
+  /// nothing is held. Returns false before the first fix.
+  bool flush(TrackPoint* out);
+
+  void reset();
+
+  uint32_t pushed() const { return pushed_; }
+  uint32_t reported() const { return reported_; }
+  bool holding() const { return held_ > 0; }
+
+ private:
+  void offset_m(const TrackPoint& p, float* v) const;
+  TrackPoint place(uint32_t time_ms) const;
+  void archive(const TrackPoint& p);
+
+  bool started_ = false;
+  TrackPoint anchor_ = {};  // last reported point
+  float lon_m_per_e7_ = 0;
+  TrackPoint last_ = {};    // newest fix, reported or held
+  uint32_t held_ = 0;       // fixes since the anchor
+  float lo_[3] = {};        // door slopes, m/s: north, east, up
+  float hi_[3] = {};
+  uint32_t pushed_ = 0;
+  uint32_t reported_ = 0;
+};
+
+}  // namespace skyguard::telemetry
@@ -0,0 +1,43 @@
+#include "termination/burn_sequencer.h"
+
+namespace skyguard::termination {
+
+BurnSequencer::BurnSequencer(const BurnPort& port, const BurnTiming& timing)
+    : port_(port), timing_(timing) {}
+
+bool BurnSequencer::fire(uint32_t t_us) {
+  if (!armed() || claimed_.exchange(true, std::memory_order_acq_rel)) return false;
+  fire_us_ = t_us;
+  channel_on_us_ = t_us;
+  channel_ = 0;
+  port_.gate(port_.ctx, 0, true);
+  // Publishes the fields above to service().
+  state_.store(static_cast<uint8_t>(BurnState::kBurning), std::memory_order_release);
+  return true;
+}
+
+void BurnSequencer::service(uint32_t t_us, uint16_t current_ma) {
+  if (state() != BurnState::kBurning) return;
+  if (current_ma >= timing_.current_threshold_ma) {
+    if (!current_seen()) {
+      current_us_ = t_us;
+      current_seen_.store(true, std::memory_order_release);
+    }
+  } else if (!current_seen() && t_us - channel_on_us_ >= timing_.current_timeout_us) {
+    port_.gate(port_.ctx, channel_, false);
+    if (channel_ == 0) {
+      channel_ = 1;
+      channel_on_us_ = t_us;
+      port_.gate(port_.ctx, 1, true);
+    } else {
+      state_.store(static_cast<uint8_t>(BurnState::kFailed), std::memory_order_release);
+    }
+    return;
+  }
+  if (current_seen() && t_us - current_us_ >= timing_.pulse_us) {
+    port_.gate(port_.ctx, channel_, false);
+    state_.store(static_cast<uint8_t>(BurnState::kDone), std::memory_order_release);
+  }
+}
+
+}  // namespace skyguard::termination
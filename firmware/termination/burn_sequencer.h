@@ -0,0 +1,80 @@
+// Burn-wire actuator sequencing.
+//
+// fire() switches burn channel A on. It may be called from any context,
+// including a receive interrupt: it claims the sequencer with one atomic
+// exchange, so only the first caller drives the gate and later calls
+// (another link's copy of the command, the rule engine's tick-path cut)
+// return without touching it. Everything after that is timed by
+// service() from the owning task with the newest burn current sample: if
+// no current flows within current_timeout_us the wire or its switch has
+// failed open and channel B takes over; the burning channel is switched
+// off after pulse_us.
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+
+namespace skyguard::termination {
+
+struct BurnPort {
+  /// Drives burn gate `channel` (0 = A, 1 = B). Called from fire()'s
+  /// context, so it must be interrupt-safe (a GPIO write).
+  void (*gate)(void* ctx, uint8_t channel, bool on);
+  /// The hardware arm input (board::ArmSense).
+  bool (*armed)(void* ctx);
+  void* ctx;
+};
+
+struct BurnTiming {
+  uint32_t pulse_us = 3000000;
+  uint32_t current_timeout_us = 20000;  // per channel
+  uint16_t current_threshold_ma = 500;
+};
+
+enum class BurnState : uint8_t {
+  kIdle,
+  kBurning,
+  kDone,    // a channel carried current for the full pulse
+  kFailed,  // neither channel carried current
+};
+
+class BurnSequencer {
+ public:
+  explicit BurnSequencer(const BurnPort& port, const BurnTiming& timing = {});
+
+  /// False without an arm input.
+  bool armed() const { return port_.armed && port_.armed(port_.ctx); }
+
+  /// Starts the burn at `t_us` if armed and not already started. Returns
+  /// true only for the call that started it. Interrupt-safe.
+  bool fire(uint32_t t_us);
+
+  /// Owning task: advances the burn with a burn current sample taken at
+  /// `t_us`. Does nothing unless burning.
+  void service(uint32_t t_us, uint16_t current_ma);
+
+  BurnState state() const {
+    return static_cast<BurnState>(state_.load(std::memory_order_acquire));
+  }
+  bool fired() const { return claimed_.load(std::memory_order_acquire); }
+  uint8_t channel() const { return channel_; }
+  /// Valid once state() is past kIdle.
+  uint32_t fire_us() const { return fire_us_; }
+  /// When current was first seen; valid when current_seen().
+  uint32_t current_us() const { return current_us_; }
+  bool current_seen() const { return current_seen_.load(std::memory_order_acquire); }
+
+ private:
+  BurnPort port_;
+  BurnTiming timing_;
+  std::atomic<bool> claimed_{false};
+  std::atomic<uint8_t> state_{static_cast<uint8_t>(BurnState::kIdle)};
+  uint32_t fire_us_ = 0;
+  uint32_t channel_on_us_ = 0;
+  uint32_t current_us_ = 0;
+  uint8_t channel_ = 0;
+  std::atomic<bool> current_seen_{false};
+};
+
+}  // namespace skyguard::termination
@@ -0,0 +1,93 @@
+#include "termination/cut_fast_path.h"
+
+#include "generated/records.h"
+
+namespace skyguard::termination {
+
+namespace {
+
+using records::CutCommand;
+
+uint32_t read_le32(const uint8_t* p) {
+  return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 |
+         static_cast<uint32_t>(p[2]) << 16 | static_cast<uint32_t>(p[3]) << 24;
+}
+
+uint64_t read_le64(const uint8_t* p) {
+  return static_cast<uint64_t>(read_le32(p)) | static_cast<uint64_t>(read_le32(p + 4)) << 32;
+}
+
+}  // namespace
+
+CutFastPath::CutFastPath(const CutConfig& config, BurnSequencer& burn, uint32_t (*clock_us)())
+    : config_(config), burn_(burn), clock_us_(clock_us), last_counter_(config.last_counter) {}
+
+CutResult CutFastPath::check(const uint8_t* payload, size_t len, uint32_t* counter) {
+  if (len != CutCommand::kEncodedSize) return CutResult::kBadLength;
+  if (read_le32(payload + CutCommand::kOffset_unit_id) != config_.unit_id) {
+    return CutResult::kBadUnit;
+  }
+  uint64_t tag = siphash24(config_.key.bytes, payload, CutCommand::kOffset_tag);
+  // One whole-word comparison: no byte-wise early exit to time.
+  if (tag != read_le64(payload + CutCommand::kOffset_tag)) return CutResult::kBadTag;
+  *counter = read_le32(payload + CutCommand::kOffset_counter);
+  uint32_t last = last_counter_.load(std::memory_order_relaxed);
+  if (*counter < last) return CutResult::kReplay;
+  if (*counter == last) return CutResult::kDuplicate;
+  last_counter_.store(*counter, std::memory_order_release);
+  if (payload[CutCommand::kOffset_action] != kCutActionCutNow) return CutResult::kBadAction;
+  return CutResult::kAccepted;
+}
+
+CutResult CutFastPath::on_frame(const uint8_t* payload, size_t len, uint32_t rx_us) {
+  if (busy_.exchange(true, std::memory_order_acquire)) {
+    rejected_.fetch_add(1, std::memory_order_relaxed);
+    return CutResult::kBusy;
+  }
+  uint32_t counter = 0;
+  CutResult r = check(payload, len, &counter);
+  uint32_t auth_us = now(rx_us);
+  uint32_t gate_us = auth_us;
+  if (r == CutResult::kAccepted) {
+    if (!burn_.armed()) {
+      r = CutResult::kNotArmed;
+    } else if (!burn_.fire(now(auth_us))) {
+      r = CutResult::kAlreadyFired;
+    } else {
+      gate_us = now(auth_us);
+    }
+  }
+  if (r == CutResult::kDuplicate) {
+    if (last_result_ != CutResult::kAccepted) r = last_result_;
+  } else if (cut_result_authenticated(r)) {
+    last_result_ = r;
+  }
+  if (cut_result_authenticated(r)) {
+    post({rx_us, auth_us, gate_us, counter, r});
+  } else {
+    rejected_.fetch_add(1, std::memory_order_relaxed);
+  }
+  busy_.store(false, std::memory_order_release);
+  return r;
+}
+
+void CutFastPath::post(const CutEvent& e) {
+  uint8_t tail = tail_.load(std::memory_order_relaxed);
+  uint8_t next = static_cast<uint8_t>((tail + 1) % kCutEventQueue);
+  if (next == head_.load(std::memory_order_acquire)) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  events_[tail] = e;
+  tail_.store(next, std::memory_order_release);
+}
+
+bool CutFastPath::take(CutEvent* out) {
+  uint8_t head = head_.load(std::memory_order_relaxed);
+  if (head == tail_.load(std::memory_order_acquire)) return false;
+  *out = events_[head];
+  head_.store(static_cast<uint8_t>((head + 1) % kCutEventQueue), std::memory_order_release);
+  return true;
+}
+
+}  // namespace skyguard::termination
@@ -0,0 +1,121 @@
+// Fast path for authenticated remote cut commands.
+//
+// A range-safety cut should not wait for the next rule tick, or behind a
+// log flush holding the main loop. The radio or modem driver calls
+// on_frame() from its receive interrupt as soon as a CutCommand frame has
+// passed its CRC. on_frame() checks the unit id, the SipHash tag and the
+// counter, and fires the BurnSequencer directly. Its cost is bounded: one
+// fixed-length MAC and a few comparisons, with no waits and no flash access.
+// Logging, the acknowledgement and the counter's persistence are left to the
+// owning task, which take()s an event per authenticated command.
+//
+// Frames that fail authentication, and stale counters (replays), leave no
+// event and are only counted, so a flood of them cannot crowd out the real
+// command's event or the ACK. A repeat of the last accepted counter is
+// the ground retrying after a lost ACK, and is acknowledged again with the
+// result that counter got: kDuplicate if its command fired, else kNotArmed,
+// kAlreadyFired or kBadAction, so the ground knows to send a new counter.
+// The counter is spent either way, so a command received while disarmed
+// cannot be replayed once armed.
+//
+// Give the receive interrupts that call on_frame() one priority, so they
+// queue rather than nest. A nested call returns kBusy and its frame is
+// lost (the ground retries until acknowledged).
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+#include "termination/burn_sequencer.h"
+#include "util/siphash.h"
+
+namespace skyguard::termination {
+
+constexpr uint8_t kCutActionCutNow = 1;
+constexpr size_t kCutEventQueue = 8;
+
+struct CutKey {
+  uint8_t bytes[kSipHashKeyLen];
+};
+
+struct CutConfig {
+  uint32_t unit_id;
+  CutKey key;
+  /// Highest counter accepted so far (from config flash); commands must
+  /// exceed it.
+  uint32_t last_counter;
+};
+
+enum class CutResult : uint8_t {
+  kAccepted,      // authenticated; fired the burn
+  kDuplicate,     // the last accepted counter again, whose command fired
+  kNotArmed,      // authenticated, but the arm input is off
+  kAlreadyFired,  // authenticated; the burn had already started
+  kBadAction,     // authenticated, unknown action
+  // Not authenticated: no event, not acknowledged.
+  kBadLength,
+  kBadUnit,
+  kBadTag,
+  kReplay,  // counter below the last accepted one
+  kBusy,
+};
+
+struct CutEvent {
+  uint32_t rx_us;    // end of the command frame
+  uint32_t auth_us;  // authentication done
+  uint32_t gate_us;  // burn channel on, once fire() returned (kAccepted; else auth_us)
+  uint32_t counter;
+  CutResult result;
+};
+
+/// Where the owning task hands each event: the event log, and config
+/// flash when last_counter() has moved.
+struct CutEventSink {
+  void (*write)(void* ctx, const CutEvent& e, uint32_t last_counter);
+  void* ctx;
+};
+
+inline bool cut_result_authenticated(CutResult r) { return r <= CutResult::kBadAction; }
+
+class CutFastPath {
+ public:
+  /// `clock_us`: the free-running microsecond clock, readable from the
+  /// receive interrupt. Without it every time recorded is the frame's.
+  CutFastPath(const CutConfig& config, BurnSequencer& burn, uint32_t (*clock_us)());
+
+  /// Receive interrupt: a CutCommand payload whose frame ended at `rx_us`.
+  CutResult on_frame(const uint8_t* payload, size_t len, uint32_t rx_us);
+
+  /// Owning task: the oldest pending event. Returns false when none.
+  bool take(CutEvent* out);
+
+  /// Persist this to config flash when it changes, so a reboot does not
+  /// reopen old counters to replay.
+  uint32_t last_counter() const { return last_counter_.load(std::memory_order_acquire); }
+  uint32_t rejected() const { return rejected_.load(std::memory_order_relaxed); }
+  /// Events lost to a full queue (the command still took effect).
+  uint32_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+ private:
+  CutResult check(const uint8_t* payload, size_t len, uint32_t* counter);
+  void post(const CutEvent& e);
+  uint32_t now(uint32_t fallback) const { return clock_us_ ? clock_us_() : fallback; }
+
+  CutConfig config_;
+  BurnSequencer& burn_;
+  uint32_t (*clock_us_)();
+  std::atomic<bool> busy_{false};
+  std::atomic<uint32_t> last_counter_;
+  // What last_counter_ got; kAccepted also after a boot, when it is not
+  // known. Only on_frame() touches it.
+  CutResult last_result_ = CutResult::kAccepted;
+  std::atomic<uint32_t> rejected_{0};
+  std::atomic<uint32_t> dropped_{0};
+  CutEvent events_[kCutEventQueue] = {};
+  std::atomic<uint8_t> head_{0};  // next to take
+  std::atomic<uint8_t> tail_{0};  // next to post
+};
+
+}  // namespace skyguard::termination
@@ -0,0 +1,124 @@
+#include "termination/provenance.h"
+
+#include "termination/termination_engine.h"
+
+namespace skyguard::termination {
+
+namespace {
+
+class BitWriter {
+ public:
+  explicit BitWriter(uint8_t* out) : out_(out) {}
+
+  void put(uint32_t v, unsigned bits) {
+    acc_ |= static_cast<uint64_t>(v & mask(bits)) << fill_;
+    fill_ += bits;
+    while (fill_ >= 8) {
+      out_[n_++] = static_cast<uint8_t>(acc_);
+      acc_ >>= 8;
+      fill_ -= 8;
+    }
+  }
+  size_t finish() {
+    if (fill_) out_[n_++] = static_cast<uint8_t>(acc_);
+    acc_ = 0;
+    fill_ = 0;
+    return n_;
+  }
+
+ private:
+  static uint32_t mask(unsigned bits) { return bits >= 32 ? ~0u : (1u << bits) - 1; }
+
+  uint8_t* out_;
+  size_t n_ = 0;
+  uint64_t acc_ = 0;
+  unsigned fill_ = 0;
+};
+
+uint32_t saturate_unsigned(uint32_t v, unsigned bits) {
+  uint32_t max = (1u << bits) - 1;
+  return v > max ? max : v;
+}
+
+uint32_t saturate_signed(int32_t v, unsigned bits) {
+  int32_t max = (1 << (bits - 1)) - 1;
+  int32_t min = -max;  // -max - 1 is the unknown code
+  if (v > max) v = max;
+  if (v < min) v = min;
+  return static_cast<uint32_t>(v) & ((1u << bits) - 1);
+}
+
+constexpr size_t max_entry_bits() {
+  size_t bits = 1 + 32 + 2 * kConditionCount + 1 + 4 + kConditionCount;
+  for (const ProvenanceField& f : kProvenanceFields) bits += f.bits;
+  return bits;
+}
+
+static_assert(1 + (max_entry_bits() + 7) / 8 <= kProvenanceMaxEntry,
+              "kProvenanceMaxEntry holds an entry with every field");
+
+}  // namespace
+
+uint32_t provenance_value(Condition c, const RuleInputs& in) {
+  const ProvenanceField& f = kProvenanceFields[static_cast<size_t>(c)];
+  switch (c) {
+    case Condition::kFenceBreach:
+    case Condition::kFenceNear:
+      if (in.fence_margin_m == kFenceMarginUnknown) return provenance_unknown(f);
+      return saturate_signed(in.fence_margin_m, f.bits);
+    case Condition::kAboveCeiling:
+      return saturate_signed(in.alt_m, f.bits);
+    case Condition::kFlightTimeout:
+      return saturate_unsigned(in.flight_s, f.bits);
+    case Condition::kGpsLost:
+      return saturate_unsigned(in.fix_age_ms / f.scale, f.bits);
+    case Condition::kLinkLost:
+      return saturate_unsigned(in.link_silence_s, f.bits);
+    case Condition::kLowBattery:
+      return saturate_unsigned(in.battery_mv, f.bits);
+    case Condition::kAirspaceClear:
+      return saturate_unsigned(in.traffic_m / f.scale, f.bits);
+    default:
+      return 0;
+  }
+}
+
+void ProvenanceEncoder::record(const RuleInputs& in, uint16_t conditions, uint16_t changed,
+                               int rule, uint16_t rule_mask) {
+  uint8_t buf[kProvenanceMaxEntry];
+  BitWriter w(buf + 1);
+  uint32_t delta = in.time_ms - last_ms_;
+  bool absolute = need_absolute_ || delta > kProvenanceMaxDeltaMs;
+  w.put(absolute, 1);
+  if (absolute) {
+    w.put(in.time_ms, 32);
+  } else {
+    w.put(delta, 16);
+  }
+  w.put(conditions, kConditionCount);
+  w.put(changed, kConditionCount);
+  w.put(rule >= 0, 1);
+  uint16_t values = changed;
+  if (rule >= 0) {
+    w.put(static_cast<uint32_t>(rule), 4);
+    w.put(rule_mask, kConditionCount);
+    values |= rule_mask;
+  }
+  for (size_t i = 0; i < kConditionCount; ++i) {
+    unsigned bits = kProvenanceFields[i].bits;
+    if ((values >> i & 1) && bits) w.put(provenance_value(static_cast<Condition>(i), in), bits);
+  }
+  size_t len = 1 + w.finish();
+  buf[0] = static_cast<uint8_t>(len);
+  last_ms_ = in.time_ms;
+  if (!sink_.write(sink_.ctx, buf, len)) {
+    ++dropped_;
+    need_absolute_ = true;
+    return;
+  }
+  need_absolute_ = false;
+  ++entries_;
+  bytes_ += static_cast<uint32_t>(len);
+}
+
+}  // namespace skyguard::termination
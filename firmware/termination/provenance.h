@@ -0,0 +1,46 @@
+// Encoder for decision provenance entries (layout in provenance_format.h).
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "termination/provenance_format.h"
+
+namespace skyguard::termination {
+
+struct RuleInputs;
+
+/// Where entries go (the event log, a RAM ring for the downlink). write()
+/// takes a whole entry or refuses it.
+struct ProvenanceSink {
+  bool (*write)(void* ctx, const uint8_t* entry, size_t len);
+  void* ctx;
+};
+
+/// Quantized input for condition `c`, saturated to its field width (signed
+/// fields in two's complement within that width).
+uint32_t provenance_value(Condition c, const RuleInputs& in);
+
+class ProvenanceEncoder {
+ public:
+  explicit ProvenanceEncoder(ProvenanceSink sink) : sink_(sink) {}
+
+  /// Writes one entry. `rule` is the deciding rule's index and
+  /// `rule_mask` its conditions, or -1 and 0 when no decision was made.
+  void record(const RuleInputs& in, uint16_t conditions, uint16_t changed, int rule,
+              uint16_t rule_mask);
+
+  uint32_t entries() const { return entries_; }
+  uint32_t bytes() const { return bytes_; }
+  uint32_t dropped() const { return dropped_; }
+
+ private:
+  ProvenanceSink sink_;
+  bool need_absolute_ = true;
+  uint32_t last_ms_ = 0;
+  uint32_t entries_ = 0;
+  uint32_t bytes_ = 0;
+  uint32_t dropped_ = 0;
+};
+
+}  // namespace skyguard::termination
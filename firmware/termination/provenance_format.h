@@ -0,0 +1,86 @@
+// Decision provenance entries written by the termination engine (see
+// termination_engine.h) and decoded on the ground
+// (ground/termination/provenance_decode.h).
+//
+// An entry is written only on a tick where a condition bit or the cut
+// decision changed. Byte 0 is the entry length in bytes, including itself;
+// the rest is a bit stream, least significant bit first, zero padded to a
+// byte:
+//   1 bit   absolute time flag
+//   32 bits time_ms if absolute, else 16 bits ms since the previous entry
+//   kConditionCount bits  condition state after the tick
+//   kConditionCount bits  conditions that changed on the tick
+//   1 bit   cut decided on this tick; if set:
+//             4 bits rule index, kConditionCount bits the rule's conditions
+//   then, for each condition in index order that changed or belongs to the
+//   deciding rule, its input value with the field's width and scale
+//   (kProvenanceFields; signed fields in two's complement, saturated).
+//   The most negative code of a signed field means the input was unknown
+//   (kFenceMarginUnknown); values saturate one above it.
+// The first entry, and the first after one the sink refused, carries
+// absolute time, so the decoder can resynchronize.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace skyguard::termination {
+
+enum class Condition : uint8_t {
+  kArmed,          // termination armed on the pad
+  kRemoteCut,      // authenticated cut command received
+  kFenceBreach,    // outside the allowed area
+  kFenceNear,      // within the warning margin of the fence
+  kAboveCeiling,   // above the altitude ceiling
+  kFlightTimeout,  // flight time limit reached
+  kGpsLost,        // no fix for longer than the limit
+  kLinkLost,       // no ground contact for longer than the limit
+  kLowBattery,
+  kFreefall,       // from the IMU
+  kAirspaceClear,  // no ADS-B traffic in the cylinder around and below
+  kCount
+};
+
+constexpr size_t kConditionCount = static_cast<size_t>(Condition::kCount);
+static_assert(kConditionCount <= 16, "condition masks are 16 bits");
+
+constexpr uint16_t condition_bit(Condition c) {
+  return static_cast<uint16_t>(1u << static_cast<unsigned>(c));
+}
+
+/// Input value recorded with a condition: value = raw / scale, in `bits`.
+struct ProvenanceField {
+  const char* name;
+  const char* unit;
+  uint8_t bits;  // 0: the condition bit is its own input
+  bool is_signed;
+  uint16_t scale;
+};
+
+constexpr ProvenanceField kProvenanceFields[kConditionCount] = {
+    {"armed", "", 0, false, 1},
+    {"remote_cut", "", 0, false, 1},
+    {"fence_margin", "m", 20, true, 1},
+    {"fence_margin", "m", 20, true, 1},
+    {"altitude", "m", 18, true, 1},
+    {"flight_time", "s", 16, false, 1},
+    {"fix_age", "ms", 10, false, 100},
+    {"link_silence", "s", 16, false, 1},
+    {"battery", "mV", 13, false, 1},
+    {"freefall", "", 0, false, 1},
+    {"nearest_traffic", "m", 16, false, 10},
+};
+
+/// Code of a signed field whose input was unknown.
+constexpr uint32_t provenance_unknown(const ProvenanceField& f) { return 1u << (f.bits - 1); }
+
+constexpr const char* kConditionNames[kConditionCount] = {
+    "armed",          "remote_cut", "fence_breach", "fence_near",  "above_ceiling",
+    "flight_timeout", "gps_lost",   "link_lost",    "low_battery", "freefall",
+    "airspace_clear",
+};
+
+constexpr size_t kProvenanceMaxEntry = 32;
+constexpr uint32_t kProvenanceMaxDeltaMs = 0xFFFF;
+
+}  // namespace skyguard::termination
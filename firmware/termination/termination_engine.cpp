@@ -0,0 +1,127 @@
+#include "termination/termination_engine.h"
+
+namespace skyguard::termination {
+
+namespace {
+
+constexpr uint16_t kFence = condition_bit(Condition::kFenceBreach) |
+                            condition_bit(Condition::kFenceNear);
+
+constexpr uint16_t kHeld = kFence | condition_bit(Condition::kAboveCeiling) |
+                           condition_bit(Condition::kLowBattery);
+
+constexpr uint16_t kAllConditions = static_cast<uint16_t>((1u << kConditionCount) - 1);
+
+}  // namespace
+
+const TerminationRule kDefaultRules[] = {
+    {condition_bit(Condition::kRemoteCut)},
+    {condition_bit(Condition::kFenceBreach)},
+    {condition_bit(Condition::kAboveCeiling)},
+    {condition_bit(Condition::kFlightTimeout)},
+    {condition_bit(Condition::kGpsLost) | condition_bit(Condition::kLinkLost)},
+    {condition_bit(Condition::kLowBattery) | condition_bit(Condition::kLinkLost)},
+};
+const size_t kDefaultRuleCount = sizeof(kDefaultRules) / sizeof(kDefaultRules[0]);
+
+const TerminationRule kTrafficAwareRules[] = {
+    {condition_bit(Condition::kRemoteCut)},
+    {condition_bit(Condition::kFenceBreach)},
+    {condition_bit(Condition::kAboveCeiling)},
+    {condition_bit(Condition::kFlightTimeout), 120000},
+    {condition_bit(Condition::kGpsLost) | condition_bit(Condition::kLinkLost), 60000},
+    {condition_bit(Condition::kLowBattery) | condition_bit(Condition::kLinkLost), 30000},
+};
+const size_t kTrafficAwareRuleCount = sizeof(kTrafficAwareRules) / sizeof(kTrafficAwareRules[0]);
+
+TerminationEngine::TerminationEngine() : TerminationEngine(TerminationLimits{}) {}
+
+TerminationEngine::TerminationEngine(const TerminationLimits& limits) : limits_(limits) {
+  set_rules(kDefaultRules, kDefaultRuleCount);
+}
+
+bool TerminationEngine::set_rules(const TerminationRule* rules, size_t n) {
+  if (n > kMaxRules) return false;
+  for (size_t i = 0; i < n; ++i) {
+    if (!(rules[i].all_of & kAllConditions)) return false;
+  }
+  for (size_t i = 0; i < n; ++i) rules_[i] = rules[i];
+  rule_count_ = n;
+  deferring_ = 0;
+  return true;
+}
+
+uint16_t TerminationEngine::raw_conditions(const RuleInputs& in) const {
+  uint16_t c = 0;
+  if (in.armed) c |= condition_bit(Condition::kArmed);
+  if (in.cut_command) c |= condition_bit(Condition::kRemoteCut);
+  if (in.fence_margin_m == kFenceMarginUnknown) {
+    c |= pending_ & kFence;  // the last reading; evaluate() pauses its hold
+  } else {
+    if (in.fence_margin_m < 0) c |= condition_bit(Condition::kFenceBreach);
+    if (in.fence_margin_m < limits_.fence_near_m) c |= condition_bit(Condition::kFenceNear);
+  }
+  if (in.alt_m > limits_.ceiling_m) c |= condition_bit(Condition::kAboveCeiling);
+  if (in.flight_s >= limits_.max_flight_s) c |= condition_bit(Condition::kFlightTimeout);
+  if (in.fix_age_ms > limits_.gps_lost_ms) c |= condition_bit(Condition::kGpsLost);
+  if (in.link_silence_s > limits_.link_lost_s) c |= condition_bit(Condition::kLinkLost);
+  if (in.battery_mv < limits_.low_battery_mv) c |= condition_bit(Condition::kLowBattery);
+  if (in.freefall) c |= condition_bit(Condition::kFreefall);
+  if (in.airspace_clear) c |= condition_bit(Condition::kAirspaceClear);
+  return c;
+}
+
+bool TerminationEngine::evaluate(const RuleInputs& in) {
+  uint16_t raw = raw_conditions(in);
+  if (in.fence_margin_m == kFenceMarginUnknown) {
+    // Only known readings count toward hold_ms: the unknown span moves the
+    // start of a pending fence hold forward.
+    for (size_t i = 0; i < kConditionCount; ++i) {
+      if ((pending_ & kFence) >> i & 1) pending_since_ms_[i] += in.time_ms - last_ms_;
+    }
+  }
+  last_ms_ = in.time_ms;
+
+  // Held conditions set only after hold_ms of continuous raw bits; they
+  // clear at once.
+  uint16_t started = raw & kHeld & ~pending_;
+  pending_ = raw & kHeld;
+  uint16_t held = 0;
+  for (size_t i = 0; pending_ >> i; ++i) {
+    if (!(pending_ >> i & 1)) continue;
+    if (started >> i & 1) pending_since_ms_[i] = in.time_ms;
+    if (in.time_ms - pending_since_ms_[i] >= limits_.hold_ms) held |= 1u << i;
+  }
+  uint16_t next = static_cast<uint16_t>((raw & ~kHeld) | held);
+
+  int decided = -1;
+  if (fired_rule_ < 0 && (next & condition_bit(Condition::kArmed))) {
+    bool clear = next & condition_bit(Condition::kAirspaceClear);
+    for (size_t i = 0; i < rule_count_; ++i) {
+      if ((next & rules_[i].all_of) != rules_[i].all_of) {
+        deferring_ &= static_cast<uint16_t>(~(1u << i));
+        continue;
+      }
+      if (rules_[i].defer_ms && !clear) {
+        // Traffic in the cylinder: wait, from when the rule began matching,
+        // and let a later rule that cannot wait fire meanwhile.
+        if (!(deferring_ >> i & 1)) defer_since_ms_[i] = in.time_ms;
+        deferring_ |= static_cast<uint16_t>(1u << i);
+        if (in.time_ms - defer_since_ms_[i] < rules_[i].defer_ms) continue;
+      }
+      decided = static_cast<int>(i);
+      fired_rule_ = decided;
+      break;
+    }
+  }
+  if (decided >= 0 || !(next & condition_bit(Condition::kArmed))) deferring_ = 0;
+
+  uint16_t changed = next ^ conditions_;
+  conditions_ = next;
+  if (trace_ && (changed || decided >= 0)) {
+    trace_->record(in, next, changed, decided, decided >= 0 ? rules_[decided].all_of : 0);
+  }
+  return fired_rule_ >= 0;
+}
+
+}  // namespace skyguard::termination
@@ -0,0 +1,123 @@
+// Termination rule engine.
+//
+// Each tick the engine turns the current inputs into condition bits
+// (provenance_format.h). Sensor-threshold conditions must hold for
+// hold_ms before their bit sets, so a single bad fix or sag does not
+// count; the time-based ones (flight timeout, GPS and link loss) are
+// already filtered by their own limits. A rule is a set of conditions that
+// must all be present while armed; the first rule to match latches the
+// cut, and the engine keeps tracking conditions afterwards. A rule with
+// timing freedom may wait, up to its defer_ms, for the airspace to clear
+// before it fires.
+//
+// With a ProvenanceEncoder attached, the engine writes an entry only on
+// ticks where a condition bit or the decision changed, so a quiet tick
+// costs one comparison.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "termination/provenance.h"
+#include "termination/provenance_format.h"
+
+namespace skyguard::termination {
+
+constexpr size_t kMaxRules = 16;
+
+/// RuleInputs::fence_margin_m when the margin is unknown (a fence read
+/// failed, geofence::FenceSet::margin_m() is NaN). The fence conditions
+/// keep their last reading, and their hold pauses: the tick neither
+/// breaches nor clears, and only known readings count toward hold_ms.
+constexpr int32_t kFenceMarginUnknown = INT32_MIN;
+
+/// RuleInputs::fence_margin_m from a FenceSet::margin_m() value: NaN is
+/// unknown, and margins past int32 (INFINITY without a fence) saturate.
+inline int32_t fence_margin_input(float margin_m) {
+  if (margin_m != margin_m) return kFenceMarginUnknown;
+  double m = margin_m;
+  return static_cast<int32_t>(m < -INT32_MAX ? -INT32_MAX : m > INT32_MAX ? INT32_MAX : m);
+}
+
+struct RuleInputs {
+  uint32_t time_ms;
+  bool armed;
+  bool cut_command;
+  int32_t fence_margin_m;  // negative outside the allowed area, or kFenceMarginUnknown
+  int32_t alt_m;
+  uint32_t flight_s;
+  uint32_t fix_age_ms;
+  uint32_t link_silence_s;
+  uint16_t battery_mv;
+  bool freefall;
+  bool airspace_clear;  // from traffic::TrackTable::clear(); false without ADS-B
+  uint32_t traffic_m;   // nearest aircraft in the cylinder, or UINT32_MAX
+};
+
+struct TerminationLimits {
+  int32_t fence_near_m = 500;
+  int32_t ceiling_m = 33000;
+  uint32_t max_flight_s = 6 * 3600;
+  uint32_t gps_lost_ms = 30000;
+  uint32_t link_lost_s = 600;
+  uint16_t low_battery_mv = 3300;
+  uint32_t hold_ms = 3000;
+};
+
+struct TerminationRule {
+  uint16_t all_of;  // condition bits; kArmed is implied
+  /// While kAirspaceClear is absent, the cut waits up to this long from when
+  /// the rule began matching; 0 fires at once.
+  uint32_t defer_ms = 0;
+};
+
+/// Remote cut; fence breach; ceiling; flight timeout; GPS and link both
+/// lost; low battery with no link.
+extern const TerminationRule kDefaultRules[];
+extern const size_t kDefaultRuleCount;
+/// The defaults for units with an ADS-B receiver: the flight timeout and
+/// the lost-link rules wait while traffic is inside the clear cylinder (up
+/// to 120 s, 60 s and 30 s), so the payload does not fall through it.
+/// Remote cut, fence breach and ceiling never wait.
+extern const TerminationRule kTrafficAwareRules[];
+extern const size_t kTrafficAwareRuleCount;
+
+class TerminationEngine {
+ public:
+  TerminationEngine();
+  explicit TerminationEngine(const TerminationLimits& limits);
+
+  /// Replaces the rule list (at most kMaxRules). Returns false, keeping the
+  /// current rules, if there are too many or one is empty.
+  bool set_rules(const TerminationRule* rules, size_t n);
+  /// Entries go to `encoder` from the next tick on; nullptr detaches.
+  void attach(ProvenanceEncoder* encoder) { trace_ = encoder; }
+
+  /// Runs one tick. Returns true once the cut is latched.
+  bool evaluate(const RuleInputs& in);
+
+  uint16_t conditions() const { return conditions_; }
+  bool cut() const { return fired_rule_ >= 0; }
+  /// Index of the rule that latched the cut, or -1.
+  int fired_rule() const { return fired_rule_; }
+  uint16_t rule_mask(size_t i) const { return i < rule_count_ ? rules_[i].all_of : 0; }
+  /// Rules (bit per index) that match but are waiting for clear airspace.
+  uint16_t deferring() const { return deferring_; }
+
+ private:
+  uint16_t raw_conditions(const RuleInputs& in) const;
+
+  TerminationLimits limits_;
+  TerminationRule rules_[kMaxRules];
+  size_t rule_count_ = 0;
+  ProvenanceEncoder* trace_ = nullptr;
+  uint16_t conditions_ = 0;
+  uint16_t pending_ = 0;  // held conditions whose raw bit is set
+  uint32_t pending_since_ms_[kConditionCount] = {};
+  uint32_t last_ms_ = 0;  // time_ms of the previous tick
+  uint16_t deferring_ = 0;
+  uint32_t defer_since_ms_[kMaxRules] = {};
+  int fired_rule_ = -1;
+};
+
+}  // namespace skyguard::termination
@@ -0,0 +1,143 @@
+#include "traffic/sbs_parser.h"
+
+namespace skyguard::traffic {
+
+namespace {
+
+constexpr size_t kFieldType = 1;
+constexpr size_t kFieldIcao = 4;
+constexpr size_t kFieldAltitude = 11;
+constexpr size_t kFieldLat = 14;
+constexpr size_t kFieldLon = 15;
+constexpr size_t kFields = 16;
+
+struct Field {
+  const char* p;
+  size_t n;
+};
+
+bool parse_hex24(Field f, uint32_t* out) {
+  if (f.n == 0 || f.n > 6) return false;
+  uint32_t v = 0;
+  for (size_t i = 0; i < f.n; ++i) {
+    char c = f.p[i];
+    uint32_t d;
+    if (c >= '0' && c <= '9') {
+      d = static_cast<uint32_t>(c - '0');
+    } else if (c >= 'A' && c <= 'F') {
+      d = static_cast<uint32_t>(c - 'A' + 10);
+    } else if (c >= 'a' && c <= 'f') {
+      d = static_cast<uint32_t>(c - 'a' + 10);
+    } else {
+      return false;
+    }
+    v = v << 4 | d;
+  }
+  *out = v;
+  return true;
+}
+
+bool parse_int(Field f, int32_t* out) {
+  size_t i = 0;
+  bool neg = f.n && f.p[0] == '-';
+  if (neg) ++i;
+  if (i == f.n || f.n - i > 9) return false;
+  int32_t v = 0;
+  for (; i < f.n; ++i) {
+    if (f.p[i] < '0' || f.p[i] > '9') return false;
+    v = v * 10 + (f.p[i] - '0');
+  }
+  *out = neg ? -v : v;
+  return true;
+}
+
+/// Decimal degrees to 1e-7 degrees; digits past the seventh are dropped.
+bool parse_deg_e7(Field f, int32_t limit_deg, int32_t* out) {
+  size_t i = 0;
+  bool neg = f.n && f.p[0] == '-';
+  if (neg) ++i;
+  int64_t whole = 0, frac = 0;
+  int frac_digits = 0;
+  bool digits = false, point = false;
+  for (; i < f.n; ++i) {
+    char c = f.p[i];
+    if (c == '.' && !point) {
+      point = true;
+      continue;
+    }
+    if (c < '0' || c > '9') return false;
+    digits = true;
+    if (!point) {
+      whole = whole * 10 + (c - '0');
+      if (whole > limit_deg) return false;
+    } else if (frac_digits < 7) {
+      frac = frac * 10 + (c - '0');
+      ++frac_digits;
+    }
+  }
+  if (!digits) return false;
+  for (; frac_digits < 7; ++frac_digits) frac *= 10;
+  int64_t v = whole * 10000000 + frac;
+  if (v > static_cast<int64_t>(limit_deg) * 10000000) return false;
+  *out = static_cast<int32_t>(neg ? -v : v);
+  return true;
+}
+
+}  // namespace
+
+bool SbsParser::push(uint8_t byte, AdsbReport* out) {
+  if (byte == '\r') return false;
+  if (byte != '\n') {
+    if (len_ < kSbsMaxLine) {
+      line_[len_++] = static_cast<char>(byte);
+    } else {
+      overflow_ = true;
+    }
+    return false;
+  }
+  bool ok = false;
+  if (overflow_) {
+    ++rejected_;
+  } else if (len_) {
+    ++lines_;
+    ok = parse(out);
+  }
+  len_ = 0;
+  overflow_ = false;
+  return ok;
+}
+
+bool SbsParser::parse(AdsbReport* out) {
+  Field f[kFields] = {};
+  size_t n = 0, start = 0;
+  for (size_t i = 0; i <= len_ && n < kFields; ++i) {
+    if (i == len_ || line_[i] == ',') {
+      f[n++] = {line_ + start, i - start};
+      start = i + 1;
+    }
+  }
+  if (n <= kFieldIcao || f[0].n != 3 || line_[0] != 'M' || line_[1] != 'S' || line_[2] != 'G' ||
+      f[kFieldType].n != 1) {
+    ++rejected_;
+    return false;
+  }
+  AdsbReport r{};
+  if (!parse_hex24(f[kFieldIcao], &r.icao)) {
+    ++rejected_;
+    return false;
+  }
+  int32_t alt_ft = 0;
+  if (n > kFieldAltitude && f[kFieldAltitude].n && parse_int(f[kFieldAltitude], &alt_ft)) {
+    r.alt_m = static_cast<int32_t>(static_cast<int64_t>(alt_ft) * 3048 / 10000);
+    r.has_altitude = true;
+  }
+  if (n > kFieldLon && f[kFieldLat].n && f[kFieldLon].n) {
+    r.has_position = parse_deg_e7(f[kFieldLat], 90, &r.lat_e7) &&
+                     parse_deg_e7(f[kFieldLon], 180, &r.lon_e7);
+  }
+  if (!r.has_position && !r.has_altitude) return false;
+  *out = r;
+  return true;
+}
+
+}  // namespace skyguard::traffic
@@ -0,0 +1,48 @@
+// Decoded ADS-B reports from a receiver's serial feed in the BaseStation
+// (SBS-1) text format, as dump1090-class decoders and several serial
+// receivers emit it: one comma-separated line per message,
+//   MSG,<type>,<session>,<aircraft>,<hex ident>,<flight>,<date>,<time>,
+//   <date>,<time>,<callsign>,<altitude ft>,<speed>,<track>,<lat>,<lon>,...
+// Only MSG lines with a hex ident and a position or an altitude yield a
+// report; everything else is skipped. Bytes are pushed one at a time from
+// the UART drain, so a line split across reads needs no buffering beyond
+// the parser's own.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace skyguard::traffic {
+
+constexpr size_t kSbsMaxLine = 160;
+
+struct AdsbReport {
+  uint32_t icao;  // 24-bit address
+  int32_t lat_e7;
+  int32_t lon_e7;
+  int32_t alt_m;  // barometric
+  bool has_position;
+  bool has_altitude;
+};
+
+class SbsParser {
+ public:
+  /// Consumes one byte. Returns true when it ends a line that yields a
+  /// report, written to `out`.
+  bool push(uint8_t byte, AdsbReport* out);
+
+  uint32_t lines() const { return lines_; }
+  /// Lines skipped as too long or malformed.
+  uint32_t rejected() const { return rejected_; }
+
+ private:
+  bool parse(AdsbReport* out);
+
+  char line_[kSbsMaxLine];
+  size_t len_ = 0;
+  bool overflow_ = false;
+  uint32_t lines_ = 0;
+  uint32_t rejected_ = 0;
+};
+
+}  // namespace skyguard::traffic
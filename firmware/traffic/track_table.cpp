@@ -0,0 +1,244 @@
+#include "traffic/track_table.h"
+
+#include <math.h>
+
+#include "geofence/fence_format.h"
+
+namespace skyguard::traffic {
+
+namespace {
+
+using geofence::kMetresPerLatE7;
+
+constexpr int32_t kDefaultReferenceLatE7 = 450000000;
+constexpr float kMinCos = 0.1f;  // keeps longitude cells finite near the poles
+
+float cos_lat(int32_t lat_e7) {
+  float c = cosf(static_cast<float>(lat_e7) * 1e-7f * 0.017453293f);
+  return c < kMinCos ? kMinCos : c;
+}
+
+int32_t clamp_e7(int64_t v) {
+  return static_cast<int32_t>(v < INT32_MIN ? INT32_MIN : (v > INT32_MAX ? INT32_MAX : v));
+}
+
+}  // namespace
+
+TrackTable::TrackTable() {
+  for (uint8_t& s : icao_) s = kNone;
+  for (uint8_t& b : bucket_) b = kNone;
+  for (size_t i = 0; i < kMaxTracks; ++i) {
+    next_[i] = kNone;
+    track_bucket_[i] = kNone;
+  }
+  set_reference(kDefaultReferenceLatE7);
+}
+
+void TrackTable::set_reference(int32_t lat_e7) {
+  ref_cos_ = cos_lat(lat_e7);
+  cell_lat_e7_ = static_cast<int32_t>(kTrafficCellM / kMetresPerLatE7);
+  cell_lon_e7_ = static_cast<int32_t>(static_cast<float>(cell_lat_e7_) / ref_cos_);
+  far_ = -1;
+  for (uint8_t& b : bucket_) b = kNone;
+  for (size_t i = 0; i < kMaxTracks; ++i) {
+    track_bucket_[i] = kNone;
+    if (used_[i] && tracks_[i].has_position) link(static_cast<uint8_t>(i));
+  }
+}
+
+void TrackTable::set_focus(int32_t lat_e7, int32_t lon_e7) {
+  focus_lat_e7_ = lat_e7;
+  focus_lon_e7_ = lon_e7;
+  far_ = -1;
+}
+
+float TrackTable::focus_d2(const Track& t) const {
+  if (!t.has_position) return INFINITY;
+  float dy = static_cast<float>(static_cast<int64_t>(t.lat_e7) - focus_lat_e7_);
+  float dx = static_cast<float>(static_cast<int64_t>(t.lon_e7) - focus_lon_e7_) * ref_cos_;
+  return dx * dx + dy * dy;  // squared 1e-7 degrees of latitude
+}
+
+bool TrackTable::make_room(const AdsbReport& r) {
+  if (far_ < 0) {
+    far_d2_ = -1;
+    for (size_t i = 0; i < kMaxTracks; ++i) {
+      float d2 = focus_d2(tracks_[i]);
+      if (d2 > far_d2_) {
+        far_d2_ = d2;
+        far_ = static_cast<int>(i);
+      }
+    }
+  }
+  Track probe{};
+  probe.lat_e7 = r.lat_e7;
+  probe.lon_e7 = r.lon_e7;
+  probe.has_position = r.has_position;
+  if (focus_d2(probe) >= far_d2_) {
+    ++ignored_;
+    return false;
+  }
+  remove(static_cast<uint8_t>(far_));
+  ++evicted_;
+  return true;
+}
+
+size_t TrackTable::icao_slot(uint32_t icao) const {
+  static_assert(kIcaoSlots == 256, "hash takes the top 8 bits");
+  return (icao * 2654435761u) >> 24;
+}
+
+int TrackTable::find_index(uint32_t icao) const {
+  for (size_t s = icao_slot(icao); icao_[s] != kNone; s = (s + 1) % kIcaoSlots) {
+    if (tracks_[icao_[s]].icao == icao) return icao_[s];
+  }
+  return -1;
+}
+
+const Track* TrackTable::find(uint32_t icao) const {
+  int i = find_index(icao);
+  return i < 0 ? nullptr : &tracks_[i];
+}
+
+void TrackTable::icao_remove(size_t slot) {
+  // Backward shift: pull later entries of the probe run into the hole
+  // unless their home slot lies after it.
+  size_t hole = slot;
+  for (size_t s = (hole + 1) % kIcaoSlots; icao_[s] != kNone; s = (s + 1) % kIcaoSlots) {
+    size_t home = icao_slot(tracks_[icao_[s]].icao);
+    bool stays = hole <= s ? (home > hole && home <= s) : (home > hole || home <= s);
+    if (!stays) {
+      icao_[hole] = icao_[s];
+      hole = s;
+    }
+  }
+  icao_[hole] = kNone;
+}
+
+uint8_t TrackTable::cell_bucket(int32_t cell_lat, int32_t cell_lon) {
+  uint32_t h = static_cast<uint32_t>(cell_lat) * 73856093u ^
+               static_cast<uint32_t>(cell_lon) * 19349663u;
+  return static_cast<uint8_t>((h ^ h >> 16) % kBuckets);
+}
+
+uint8_t TrackTable::bucket_of(int32_t lat_e7, int32_t lon_e7) const {
+  return cell_bucket(cell_lat(lat_e7), cell_lon(lon_e7));
+}
+
+void TrackTable::link(uint8_t i) {
+  uint8_t b = bucket_of(tracks_[i].lat_e7, tracks_[i].lon_e7);
+  next_[i] = bucket_[b];
+  bucket_[b] = i;
+  track_bucket_[i] = b;
+}
+
+void TrackTable::unlink(uint8_t i) {
+  if (track_bucket_[i] == kNone) return;
+  uint8_t* p = &bucket_[track_bucket_[i]];
+  while (*p != i) p = &next_[*p];
+  *p = next_[i];
+  next_[i] = kNone;
+  track_bucket_[i] = kNone;
+}
+
+void TrackTable::remove(uint8_t i) {
+  if (far_ == i) far_ = -1;
+  unlink(i);
+  size_t s = icao_slot(tracks_[i].icao);
+  while (icao_[s] != i) s = (s + 1) % kIcaoSlots;
+  icao_remove(s);
+  used_[i] = false;
+  --count_;
+}
+
+void TrackTable::update(const AdsbReport& r, uint32_t now_ms) {
+  int found = find_index(r.icao & 0xFFFFFF);
+  uint8_t i;
+  if (found >= 0) {
+    i = static_cast<uint8_t>(found);
+  } else {
+    if (count_ == kMaxTracks && !make_room(r)) return;
+    i = 0;
+    while (used_[i]) ++i;
+    tracks_[i] = Track{r.icao & 0xFFFFFF, 0, 0, 0, now_ms, false, false};
+    used_[i] = true;
+    ++count_;
+    far_ = -1;
+    size_t s = icao_slot(tracks_[i].icao);
+    while (icao_[s] != kNone) s = (s + 1) % kIcaoSlots;
+    icao_[s] = i;
+  }
+  Track& t = tracks_[i];
+  t.heard_ms = now_ms;
+  if (r.has_altitude) {
+    t.alt_m = r.alt_m;
+    t.has_altitude = true;
+  }
+  if (r.has_position) {
+    bool moved = !t.has_position || bucket_of(r.lat_e7, r.lon_e7) != track_bucket_[i];
+    if (moved) unlink(i);
+    t.lat_e7 = r.lat_e7;
+    t.lon_e7 = r.lon_e7;
+    t.has_position = true;
+    if (moved) link(i);
+    if (far_ == i) {
+      far_ = -1;
+    } else if (far_ >= 0 && focus_d2(t) > far_d2_) {
+      far_ = i;
+      far_d2_ = focus_d2(t);
+    }
+  }
+}
+
+void TrackTable::expire(uint32_t now_ms) {
+  for (size_t i = 0; i < kMaxTracks; ++i) {
+    if (used_[i] && now_ms - tracks_[i].heard_ms > kTrackMaxAgeMs) {
+      remove(static_cast<uint8_t>(i));
+      ++expired_;
+    }
+  }
+}
+
+bool TrackTable::clear(const AirspaceQuery& q, uint32_t now_ms, uint32_t* nearest_m) const {
+  const float lon_m_per_e7 = kMetresPerLatE7 * cos_lat(q.lat_e7);
+  const float r = static_cast<float>(q.radius_m);
+  float best2 = INFINITY;
+  bool found = false;
+
+  auto visit = [&](const Track& t) {
+    if (!t.has_position || now_ms - t.heard_ms > kTrackMaxAgeMs) return;
+    if (t.has_altitude && (t.alt_m < q.floor_m || t.alt_m > q.ceiling_m)) return;
+    float dy = static_cast<float>(t.lat_e7 - q.lat_e7) * kMetresPerLatE7;
+    float dx = static_cast<float>(static_cast<int64_t>(t.lon_e7) - q.lon_e7) * lon_m_per_e7;
+    float d2 = dx * dx + dy * dy;
+    if (d2 <= r * r) {
+      found = true;
+      if (d2 < best2) best2 = d2;
+    }
+  };
+
+  int64_t dlat = static_cast<int64_t>(r / kMetresPerLatE7) + 1;
+  int64_t dlon = static_cast<int64_t>(r / lon_m_per_e7) + 1;
+  int32_t y0 = cell_lat(clamp_e7(q.lat_e7 - dlat)), y1 = cell_lat(clamp_e7(q.lat_e7 + dlat));
+  int32_t x0 = cell_lon(clamp_e7(q.lon_e7 - dlon)), x1 = cell_lon(clamp_e7(q.lon_e7 + dlon));
+  int64_t cells = (static_cast<int64_t>(y1) - y0 + 1) * (static_cast<int64_t>(x1) - x0 + 1);
+  if (cells > static_cast<int64_t>(kBuckets)) {
+    for (size_t i = 0; i < kMaxTracks; ++i) {
+      if (used_[i]) visit(tracks_[i]);
+    }
+  } else {
+    uint32_t seen[kBuckets / 32] = {};
+    for (int32_t y = y0; y <= y1; ++y) {
+      for (int32_t x = x0; x <= x1; ++x) {
+        uint8_t b = cell_bucket(y, x);
+        if (seen[b / 32] >> (b % 32) & 1) continue;
+        seen[b / 32] |= 1u << (b % 32);
+        for (uint8_t i = bucket_[b]; i != kNone; i = next_[i]) visit(tracks_[i]);
+      }
+    }
+  }
+  if (nearest_m) *nearest_m = found ? static_cast<uint32_t>(sqrtf(best2)) : kNoTraffic;
+  return !found;
+}
+
+}  // namespace skyguard::traffic
@@ -0,0 +1,115 @@
+// Fixed-capacity table of nearby aircraft built from ADS-B reports, for the
+// termination engine's "clear airspace" rule input.
+//
+// Tracks are found by ICAO address through an open-addressed hash (linear
+// probing, backward-shift deletion) and by position through a spatial hash:
+// latitude and longitude are cut into cells of kTrafficCellM (longitude
+// cells sized at the reference latitude), and each cell hashes to a bucket
+// that chains the tracks in it. A query visits only the buckets of cells
+// overlapping its circle. Tracks not heard from for kTrackMaxAgeMs age out.
+// A receiver at altitude hears far more aircraft than the table holds, so
+// when it is full a new aircraft replaces the track farthest from the focus
+// (the balloon's position), or is ignored if it is farther still. Cells do
+// not wrap at the antimeridian.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "traffic/sbs_parser.h"
+
+namespace skyguard::traffic {
+
+constexpr size_t kMaxTracks = 128;
+constexpr uint32_t kTrackMaxAgeMs = 30000;
+constexpr float kTrafficCellM = 4000.0f;
+constexpr uint32_t kNoTraffic = UINT32_MAX;
+
+struct Track {
+  uint32_t icao;
+  int32_t lat_e7;
+  int32_t lon_e7;
+  int32_t alt_m;
+  uint32_t heard_ms;  // last report of any kind
+  bool has_position;
+  bool has_altitude;
+};
+
+/// Vertical cylinder around a point.
+struct AirspaceQuery {
+  int32_t lat_e7;
+  int32_t lon_e7;
+  uint32_t radius_m;
+  int32_t floor_m;
+  int32_t ceiling_m;
+};
+
+class TrackTable {
+ public:
+  TrackTable();
+
+  /// Cell width in longitude follows this latitude; set it near the launch
+  /// site. Re-buckets existing tracks.
+  void set_reference(int32_t lat_e7);
+  /// Position the table keeps the nearest aircraft to when full.
+  void set_focus(int32_t lat_e7, int32_t lon_e7);
+
+  void update(const AdsbReport& r, uint32_t now_ms);
+  /// Drops tracks older than kTrackMaxAgeMs.
+  void expire(uint32_t now_ms);
+
+  /// True if no current track with a position lies inside the cylinder.
+  /// A track without altitude counts as inside vertically. `nearest_m`, if
+  /// given, gets the horizontal distance of the nearest such track, or
+  /// kNoTraffic.
+  bool clear(const AirspaceQuery& q, uint32_t now_ms, uint32_t* nearest_m = nullptr) const;
+
+  size_t size() const { return count_; }
+  const Track* find(uint32_t icao) const;
+  uint32_t evicted() const { return evicted_; }
+  /// New aircraft not tracked because the table was full of nearer ones.
+  uint32_t ignored() const { return ignored_; }
+  uint32_t expired() const { return expired_; }
+
+ private:
+  static constexpr size_t kIcaoSlots = 2 * kMaxTracks;
+  static constexpr size_t kBuckets = 128;
+  static constexpr uint8_t kNone = 0xFF;
+  static_assert(kMaxTracks < kNone, "track indexes fit in a byte");
+
+  size_t icao_slot(uint32_t icao) const;
+  int find_index(uint32_t icao) const;
+  void icao_remove(size_t slot);
+  static uint8_t cell_bucket(int32_t cell_lat, int32_t cell_lon);
+  uint8_t bucket_of(int32_t lat_e7, int32_t lon_e7) const;
+  void link(uint8_t i);
+  void unlink(uint8_t i);
+  void remove(uint8_t i);
+  float focus_d2(const Track& t) const;
+  /// Makes room for a report from a new aircraft; false if it is farther
+  /// from the focus than every track.
+  bool make_room(const AdsbReport& r);
+  int32_t cell_lat(int32_t lat_e7) const { return floor_div(lat_e7, cell_lat_e7_); }
+  int32_t cell_lon(int32_t lon_e7) const { return floor_div(lon_e7, cell_lon_e7_); }
+  static int32_t floor_div(int32_t a, int32_t b) { return a / b - (a % b != 0 && (a < 0)); }
+
+  Track tracks_[kMaxTracks];
+  bool used_[kMaxTracks] = {};
+  uint8_t icao_[kIcaoSlots];          // track index, or kNone
+  uint8_t bucket_[kBuckets];          // head of each chain, or kNone
+  uint8_t next_[kMaxTracks];          // chain link, or kNone
+  uint8_t track_bucket_[kMaxTracks];  // kNone while not indexed by position
+  size_t count_ = 0;
+  int32_t cell_lat_e7_;
+  int32_t cell_lon_e7_;
+  float ref_cos_ = 1.0f;
+  int32_t focus_lat_e7_ = 0;
+  int32_t focus_lon_e7_ = 0;
+  int far_ = -1;  // cached farthest track, -1 if unknown
+  float far_d2_ = 0;
+  uint32_t evicted_ = 0;
+  uint32_t ignored_ = 0;
+  uint32_t expired_ = 0;
+};
+
+}  // namespace skyguard::traffic
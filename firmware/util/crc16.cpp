@@ -0,0 +1,39 @@
+#include "util/crc16.h"
+
+namespace skyguard {
+
+namespace {
+
+struct Crc16Table {
+  uint16_t v[256];
+};
+
+constexpr Crc16Table make_crc16_table() {
+  Crc16Table t{};
+  for (unsigned i = 0; i < 256; ++i) {
+    uint16_t crc = static_cast<uint16_t>(i);
+    for (int b = 0; b < 8; ++b) {
+      crc = (crc & 1) ? static_cast<uint16_t>((crc >> 1) ^ 0x8408)
+                      : static_cast<uint16_t>(crc >> 1);
+    }
+    t.v[i] = crc;
+  }
+  return t;
+}
+
+constexpr Crc16Table kCrcTable = make_crc16_table();
+
+}  // namespace
+
+uint16_t crc16_x25_update(uint16_t crc, const uint8_t* data, size_t len) {
+  for (size_t i = 0; i < len; ++i) {
+    crc = static_cast<uint16_t>((crc >> 8) ^ kCrcTable.v[(crc ^ data[i]) & 0xFF]);
+  }
+  return crc;
+}
+
+uint16_t crc16_x25(const uint8_t* data, size_t len) {
+  return static_cast<uint16_t>(crc16_x25_update(kCrc16X25Init, data, len) ^ 0xFFFF);
+}
+
+}  // namespace skyguard
@@ -0,0 +1,18 @@
+// CRC-16/X.25 (reflected 0x1021, init 0xFFFF, final xor 0xFFFF), the FCS
+// used by AX.25 and by SkyGuard telemetry frames.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace skyguard {
+
+constexpr uint16_t kCrc16X25Init = 0xFFFF;
+
+uint16_t crc16_x25(const uint8_t* data, size_t len);
+
+/// Continue a running CRC with no final xor; seed with kCrc16X25Init and
+/// xor the result with 0xFFFF once all data has been fed.
+uint16_t crc16_x25_update(uint16_t crc, const uint8_t* data, size_t len);
+
+}  // namespace skyguard
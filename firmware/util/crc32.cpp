@@ -0,0 +1,34 @@
+#include "util/crc32.h"
+
+namespace skyguard {
+
+namespace {
+
+struct Crc32Table {
+  uint32_t v[256];
+};
+
+constexpr Crc32Table make_crc32_table() {
+  Crc32Table t{};
+  for (uint32_t i = 0; i < 256; ++i) {
+    uint32_t crc = i;
+    for (int b = 0; b < 8; ++b) crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+    t.v[i] = crc;
+  }
+  return t;
+}
+
+constexpr Crc32Table kCrcTable = make_crc32_table();
+
+}  // namespace
+
+uint32_t crc32_update(uint32_t crc, const uint8_t* data, size_t len) {
+  for (size_t i = 0; i < len; ++i) crc = (crc >> 8) ^ kCrcTable.v[(crc ^ data[i]) & 0xFF];
+  return crc;
+}
+
+uint32_t crc32(const uint8_t* data, size_t len) {
+  return crc32_update(kCrc32Init, data, len) ^ 0xFFFFFFFFu;
+}
+
+}  // namespace skyguard
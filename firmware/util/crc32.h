@@ -0,0 +1,18 @@
+// CRC-32/ISO-HDLC (reflected 0x04C11DB7, init and final xor 0xFFFFFFFF),
+// used for integrity checks on uploaded data images.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace skyguard {
+
+constexpr uint32_t kCrc32Init = 0xFFFFFFFF;
+
+uint32_t crc32(const uint8_t* data, size_t len);
+
+/// Continue a running CRC with no final xor; seed with kCrc32Init and xor
+/// the result with 0xFFFFFFFF once all data has been fed.
+uint32_t crc32_update(uint32_t crc, const uint8_t* data, size_t len);
+
+}  // namespace skyguard
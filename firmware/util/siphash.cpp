@@ -0,0 +1,59 @@
+#include "util/siphash.h"
+
+namespace skyguard {
+
+namespace {
+
+uint64_t rotl(uint64_t x, int b) { return (x << b) | (x >> (64 - b)); }
+
+uint64_t load_le64(const uint8_t* p) {
+  uint64_t v = 0;
+  for (int i = 7; i >= 0; --i) v = v << 8 | p[i];
+  return v;
+}
+
+struct SipState {
+  uint64_t v0, v1, v2, v3;
+
+  void round() {
+    v0 += v1;
+    v1 = rotl(v1, 13);
+    v1 ^= v0;
+    v0 = rotl(v0, 32);
+    v2 += v3;
+    v3 = rotl(v3, 16);
+    v3 ^= v2;
+    v0 += v3;
+    v3 = rotl(v3, 21);
+    v3 ^= v0;
+    v2 += v1;
+    v1 = rotl(v1, 17);
+    v1 ^= v2;
+    v2 = rotl(v2, 32);
+  }
+
+  void compress(uint64_t m) {
+    v3 ^= m;
+    round();
+    round();
+    v0 ^= m;
+  }
+};
+
+}  // namespace
+
+uint64_t siphash24(const uint8_t key[kSipHashKeyLen], const uint8_t* data, size_t len) {
+  uint64_t k0 = load_le64(key), k1 = load_le64(key + 8);
+  SipState s{k0 ^ 0x736f6d6570736575ull, k1 ^ 0x646f72616e646f6dull, k0 ^ 0x6c7967656e657261ull,
+             k1 ^ 0x7465646279746573ull};
+  size_t whole = len & ~static_cast<size_t>(7);
+  for (size_t i = 0; i < whole; i += 8) s.compress(load_le64(data + i));
+  uint64_t last = static_cast<uint64_t>(len & 0xFF) << 56;
+  for (size_t i = whole; i < len; ++i) last |= static_cast<uint64_t>(data[i]) << (8 * (i - whole));
+  s.compress(last);
+  s.v2 ^= 0xFF;
+  for (int r = 0; r < 4; ++r) s.round();
+  return s.v0 ^ s.v1 ^ s.v2 ^ s.v3;
+}
+
+}  // namespace skyguard
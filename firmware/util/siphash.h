@@ -0,0 +1,16 @@
+// SipHash-2-4 (Aumasson and Bernstein): a keyed 64-bit MAC over short
+// messages, used to authenticate uplinked commands. Its running time
+// depends only on the message length, so a check of a fixed-size command
+// has a fixed cost.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace skyguard {
+
+constexpr size_t kSipHashKeyLen = 16;
+
+uint64_t siphash24(const uint8_t key[kSipHashKeyLen], const uint8_t* data, size_t len);
+
+}  // namespace skyguard
@@ -0,0 +1,63 @@
+#include "wind/wind_blend.h"
+
+#include <math.h>
+
+namespace skyguard::wind {
+
+namespace {
+
+constexpr float kAgeTauS = 3.0f * 3600.0f;
+// Weight of each new sample in the band's running average.
+constexpr float kObserveGain = 0.2f;
+// Below this confidence a band no longer stands in for a missing forecast.
+constexpr float kMinWeight = 0.05f;
+
+}  // namespace
+
+int WindBlender::band_of(float alt_m) {
+  if (!(alt_m > 0)) return 0;
+  int band = static_cast<int>(alt_m / kWindBandM);
+  return band >= static_cast<int>(kWindBands) ? kWindBands - 1 : band;
+}
+
+float WindBlender::decay(const Band& b, uint32_t utc_s) const {
+  if (b.weight == 0) return 0;
+  float age = utc_s > b.t_s ? static_cast<float>(utc_s - b.t_s) : 0.0f;
+  return b.weight * expf(-age / kAgeTauS);
+}
+
+void WindBlender::observe(uint32_t utc_s, int32_t lat_e7, int32_t lon_e7, float alt_m,
+                          float ve_ms, float vn_ms) {
+  Band& b = bands_[band_of(alt_m)];
+  float w = decay(b, utc_s);
+  // Normalised running average: the first sample lands fully, later ones
+  // move the estimate by the gain.
+  float gain = kObserveGain / (w * (1 - kObserveGain) + kObserveGain);
+  b.measured.u_ms = w ? b.measured.u_ms + gain * (ve_ms - b.measured.u_ms) : ve_ms;
+  b.measured.v_ms = w ? b.measured.v_ms + gain * (vn_ms - b.measured.v_ms) : vn_ms;
+
+  WindVector forecast;
+  if (grid_.sample(utc_s, lat_e7, lon_e7, alt_m, &forecast)) {
+    float bu = ve_ms - forecast.u_ms, bv = vn_ms - forecast.v_ms;
+    b.bias.u_ms = w ? b.bias.u_ms + gain * (bu - b.bias.u_ms) : bu;
+    b.bias.v_ms = w ? b.bias.v_ms + gain * (bv - b.bias.v_ms) : bv;
+  }
+  b.weight = w + kObserveGain * (1 - w);
+  b.t_s = utc_s;
+}
+
+bool WindBlender::wind_at(uint32_t utc_s, int32_t lat_e7, int32_t lon_e7, float alt_m,
+                          WindVector* out) {
+  const Band& b = bands_[band_of(alt_m)];
+  float w = decay(b, utc_s);
+  if (grid_.sample(utc_s, lat_e7, lon_e7, alt_m, out)) {
+    out->u_ms += w * b.bias.u_ms;
+    out->v_ms += w * b.bias.v_ms;
+    return true;
+  }
+  if (w < kMinWeight) return false;
+  *out = b.measured;
+  return true;
+}
+
+}  // namespace skyguard::wind
@@ -0,0 +1,46 @@
+// Blends the uploaded forecast with winds measured during flight.
+//
+// GNSS drift while floating is the wind at that altitude. Each 1 km band
+// keeps an exponentially weighted bias (measured - forecast) and the last
+// measured wind; both age out with a three-hour time constant, so stale
+// ascent measurements fade back towards the forecast over a long float.
+#pragma once
+
+#include <stdint.h>
+
+#include "wind/wind_grid.h"
+
+namespace skyguard::wind {
+
+constexpr uint32_t kWindBands = 40;
+constexpr float kWindBandM = 1000.0f;
+
+class WindBlender {
+ public:
+  /// `grid` may be unbound (no upload); measured winds are then used alone.
+  explicit WindBlender(WindGrid& grid) : grid_(grid) {}
+
+  /// Feeds a measured wind (GNSS velocity while drifting) at a position.
+  void observe(uint32_t utc_s, int32_t lat_e7, int32_t lon_e7, float alt_m, float ve_ms,
+               float vn_ms);
+
+  /// Best estimate at a point. False only if neither the forecast nor any
+  /// fresh band measurement covers it.
+  bool wind_at(uint32_t utc_s, int32_t lat_e7, int32_t lon_e7, float alt_m, WindVector* out);
+
+ private:
+  struct Band {
+    uint32_t t_s;
+    float weight;  // confidence in [0, 1], decays with age
+    WindVector bias;
+    WindVector measured;
+  };
+
+  static int band_of(float alt_m);
+  float decay(const Band& b, uint32_t utc_s) const;
+
+  WindGrid& grid_;
+  Band bands_[kWindBands] = {};
+};
+
+}  // namespace skyguard::wind
@@ -0,0 +1,177 @@
+#include "wind/wind_grid.h"
+
+namespace skyguard::wind {
+
+namespace {
+
+constexpr uint32_t kNoBlock = 0xFFFFFFFF;
+
+}  // namespace
+
+bool wind_decode_block(const uint8_t* data, uint32_t len, int16_t* uv) {
+  uint32_t pos = 0;
+  for (uint32_t plane = 0; plane < 2; ++plane) {
+    int16_t* out = uv + plane * kWindTilePoints;
+    for (uint32_t i = 0; i < kWindTilePoints; ++i) {
+      uint32_t zz = 0;
+      for (uint32_t shift = 0;; shift += 7) {
+        if (pos == len || shift > 14) return false;
+        uint8_t b = data[pos++];
+        zz |= static_cast<uint32_t>(b & 0x7F) << shift;
+        if (!(b & 0x80)) break;
+      }
+      int32_t residual = static_cast<int32_t>(zz >> 1) ^ -static_cast<int32_t>(zz & 1);
+      uint32_t x = i % kWindTile, y = i / kWindTile;
+      int32_t w = x ? out[i - 1] : 0;
+      int32_t s = y ? out[i - kWindTile] : 0;
+      int32_t sw = x && y ? out[i - kWindTile - 1] : 0;
+      int32_t value = w + s - sw + residual;
+      if (value < -32768 || value > 32767) return false;
+      out[i] = static_cast<int16_t>(value);
+    }
+  }
+  return pos == len;
+}
+
+bool WindGrid::bind(const storage::DataView& image) {
+  bound_ = false;
+  image_ = image;
+  for (Slot& s : slots_) s.block = kNoBlock;
+  hits_ = misses_ = 0;
+
+  WindGridHeader& h = header_;
+  if (!image.load(0, &h)) return false;
+  if (h.magic != kWindMagic || h.version != kWindFormatVersion || h.n_levels == 0 ||
+      h.n_levels > kMaxWindLevels || h.n_lat < 2 || h.n_lon < 2 || h.n_times == 0 ||
+      h.dlat_e7 == 0 || h.dlon_e7 == 0 || (h.n_times > 1 && h.dt_s == 0) || !(h.unit_ms > 0)) {
+    return false;
+  }
+  tiles_lat_ = wind_tiles(h.n_lat);
+  tiles_lon_ = wind_tiles(h.n_lon);
+  n_blocks_ = static_cast<uint32_t>(h.n_times) * h.n_levels * tiles_lat_ * tiles_lon_;
+  uint32_t levels_offset = sizeof(h);
+  blocks_offset_ = levels_offset + 4 * h.n_levels;
+  if (h.image_size > image.size() ||
+      static_cast<uint64_t>(blocks_offset_) + 4ull * (n_blocks_ + 1) > h.image_size ||
+      !image.read(levels_offset, levels_m_, 4 * h.n_levels)) {
+    return false;
+  }
+  for (uint32_t l = 1; l < h.n_levels; ++l) {
+    if (levels_m_[l] <= levels_m_[l - 1]) return false;
+  }
+
+  // Whole-image CRC so a corrupt upload is caught before flight, not mid-air.
+  uint32_t crc;
+  if (!image.crc32(sizeof(h), h.image_size - sizeof(h), &crc) || crc != h.crc32) return false;
+  bound_ = true;
+  return true;
+}
+
+const int16_t* WindGrid::tile(uint32_t block) {
+  ++clock_;
+  Slot* victim = &slots_[0];
+  for (Slot& s : slots_) {
+    if (s.block == block) {
+      s.last_use = clock_;
+      ++hits_;
+      return s.uv;
+    }
+    if (s.block == kNoBlock || (victim->block != kNoBlock && s.last_use < victim->last_use)) {
+      victim = &s;
+    }
+  }
+  ++misses_;
+  // Decoded straight from the flash window when it is mapped.
+  uint32_t span[2];
+  uint8_t scratch[kMaxWindBlockBytes];
+  const uint8_t* data;
+  victim->block = kNoBlock;
+  if (!image_.load(blocks_offset_ + 4 * block, &span) || span[1] < span[0] ||
+      span[1] - span[0] > kMaxWindBlockBytes || span[1] > header_.image_size ||
+      !(data = image_.fetch(span[0], span[1] - span[0], scratch)) ||
+      !wind_decode_block(data, span[1] - span[0], victim->uv)) {
+    ++read_errors_;
+    return nullptr;
+  }
+  victim->block = block;
+  victim->last_use = clock_;
+  return victim->uv;
+}
+
+bool WindGrid::point(uint32_t time, uint32_t level, uint32_t iy, uint32_t ix, float* u,
+                     float* v) {
+  uint32_t block =
+      ((time * header_.n_levels + level) * tiles_lat_ + iy / kWindTile) * tiles_lon_ +
+      ix / kWindTile;
+  const int16_t* t = tile(block);
+  if (!t) return false;
+  uint32_t i = (iy % kWindTile) * kWindTile + ix % kWindTile;
+  *u = t[i];
+  *v = t[kWindTilePoints + i];
+  return true;
+}
+
+bool WindGrid::sample(uint32_t utc_s, int32_t lat_e7, int32_t lon_e7, float alt_m,
+                      WindVector* out) {
+  if (!bound_) return false;
+  const WindGridHeader& h = header_;
+
+  // Fractional position on each axis; area and time must be covered.
+  int64_t dy = static_cast<int64_t>(lat_e7) - h.lat0_e7;
+  int64_t dx = static_cast<int64_t>(lon_e7) - h.lon0_e7;
+  if (dy < 0 || dx < 0 || dy > static_cast<int64_t>(h.dlat_e7) * (h.n_lat - 1) ||
+      dx > static_cast<int64_t>(h.dlon_e7) * (h.n_lon - 1) || utc_s < h.t0_utc_s) {
+    return false;
+  }
+  uint32_t iy = static_cast<uint32_t>(dy / h.dlat_e7), ix = static_cast<uint32_t>(dx / h.dlon_e7);
+  if (iy >= h.n_lat - 1u) iy = h.n_lat - 2u;
+  if (ix >= h.n_lon - 1u) ix = h.n_lon - 2u;
+  float fy = static_cast<float>(dy - static_cast<int64_t>(iy) * h.dlat_e7) / h.dlat_e7;
+  float fx = static_cast<float>(dx - static_cast<int64_t>(ix) * h.dlon_e7) / h.dlon_e7;
+
+  uint32_t it = 0, t_span = h.n_times > 1 ? 1 : 0;
+  float ft = 0;
+  if (h.n_times > 1) {
+    uint32_t dt = utc_s - h.t0_utc_s;
+    if (dt > h.dt_s * (h.n_times - 1u)) return false;
+    it = dt / h.dt_s;
+    if (it >= h.n_times - 1u) it = h.n_times - 2u;
+    ft = static_cast<float>(dt - it * h.dt_s) / static_cast<float>(h.dt_s);
+  } else if (utc_s != h.t0_utc_s) {
+    return false;
+  }
+
+  uint32_t il = 0, l_span = h.n_levels > 1 ? 1 : 0;
+  float fl = 0;
+  if (h.n_levels > 1) {
+    while (il + 2 < h.n_levels && alt_m >= static_cast<float>(levels_m_[il + 1])) ++il;
+    float lo = static_cast<float>(levels_m_[il]), hi = static_cast<float>(levels_m_[il + 1]);
+    fl = (alt_m - lo) / (hi - lo);
+    fl = fl < 0 ? 0 : (fl > 1 ? 1 : fl);
+  }
+
+  float u = 0, v = 0;
+  for (uint32_t a = 0; a <= t_span; ++a) {
+    float wt = a ? ft : 1 - ft;
+    for (uint32_t b = 0; b <= l_span; ++b) {
+      float wl = wt * (b ? fl : 1 - fl);
+      if (wl == 0) continue;
+      float pu[4], pv[4];
+      if (!point(it + a, il + b, iy, ix, &pu[0], &pv[0]) ||
+          !point(it + a, il + b, iy, ix + 1, &pu[1], &pv[1]) ||
+          !point(it + a, il + b, iy + 1, ix, &pu[2], &pv[2]) ||
+          !point(it + a, il + b, iy + 1, ix + 1, &pu[3], &pv[3])) {
+        return false;
+      }
+      float su = pu[0] + (pu[1] - pu[0]) * fx, nu = pu[2] + (pu[3] - pu[2]) * fx;
+      float sv = pv[0] + (pv[1] - pv[0]) * fx, nv = pv[2] + (pv[3] - pv[2]) * fx;
+      u += wl * (su + (nu - su) * fy);
+      v += wl * (sv + (nv - sv) * fy);
+    }
+  }
+  out->u_ms = u * h.unit_ms;
+  out->v_ms = v * h.unit_ms;
+  return true;
+}
+
+}  // namespace skyguard::wind
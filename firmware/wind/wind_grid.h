@@ -0,0 +1,67 @@
+// On-board reader for the forecast wind grid (wind_grid_format.h).
+//
+// The image stays in external flash behind a storage::DataView. Tiles are
+// decoded on demand into a small LRU cache, so a sample normally costs
+// sixteen cached lookups: the grid is interpolated linearly in altitude,
+// latitude, longitude and time.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "storage/data_view.h"
+#include "wind/wind_grid_format.h"
+
+namespace skyguard::wind {
+
+struct WindVector {
+  float u_ms;  // towards east
+  float v_ms;  // towards north
+};
+
+constexpr size_t kWindCacheSlots = 8;
+
+class WindGrid {
+ public:
+  /// Reads and validates the header, level table and CRC. False leaves the
+  /// grid unbound, and sample() then always fails.
+  bool bind(const storage::DataView& image);
+  bool bound() const { return bound_; }
+
+  /// Forecast wind at a point. False outside the grid's area or time span,
+  /// or if a tile it needs cannot be read or decoded (never a made-up calm);
+  /// altitudes beyond the levels clamp to the nearest level.
+  bool sample(uint32_t utc_s, int32_t lat_e7, int32_t lon_e7, float alt_m, WindVector* out);
+
+  const WindGridHeader& header() const { return header_; }
+  uint32_t cache_hits() const { return hits_; }
+  uint32_t cache_misses() const { return misses_; }
+  /// Tiles that failed to read or decode.
+  uint32_t read_errors() const { return read_errors_; }
+
+ private:
+  struct Slot {
+    uint32_t block;
+    uint32_t last_use;
+    int16_t uv[2 * kWindTilePoints];
+  };
+
+  const int16_t* tile(uint32_t block);
+  bool point(uint32_t time, uint32_t level, uint32_t iy, uint32_t ix, float* u, float* v);
+
+  storage::DataView image_;
+  WindGridHeader header_{};
+  bool bound_ = false;
+  int32_t levels_m_[kMaxWindLevels] = {};
+  uint32_t tiles_lat_ = 0, tiles_lon_ = 0, n_blocks_ = 0;
+  uint32_t blocks_offset_ = 0;
+  Slot slots_[kWindCacheSlots] = {};
+  uint32_t clock_ = 0;
+  uint32_t hits_ = 0, misses_ = 0, read_errors_ = 0;
+};
+
+/// Decodes one compressed block into 2 * kWindTilePoints values; false if
+/// the data is malformed. Shared with the ground packer's self-check.
+bool wind_decode_block(const uint8_t* data, uint32_t len, int16_t* uv);
+
+}  // namespace skyguard::wind
@@ -0,0 +1,55 @@
+// Forecast wind grid image, packed on the ground before launch and read
+// from external flash (see wind_grid.h).
+//
+// Layout (little endian):
+//   WindGridHeader
+//   int32 level altitudes, metres, ascending [n_levels]
+//   uint32 block offsets from image start [n_blocks + 1]
+//   compressed blocks
+//
+// The grid is n_times x n_levels x n_lat x n_lon points of (u east, v
+// north) quantised to `unit_ms`. Each (time, level) slab is cut into
+// kWindTile x kWindTile tiles (edge tiles padded by repeating the last
+// row/column); block index = ((time * n_levels + level) * tiles_lat +
+// tile_y) * tiles_lon + tile_x. A block holds the tile's u values then its v
+// values, row-major from the south-west, each coded as the zigzag LEB128
+// residual from the gradient predictor west + south - south-west (missing
+// neighbours read as zero).
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace skyguard::wind {
+
+constexpr uint32_t kWindMagic = 0x47574753;  // "SGWG"
+constexpr uint16_t kWindFormatVersion = 1;
+constexpr uint32_t kWindTile = 8;
+constexpr uint32_t kWindTilePoints = kWindTile * kWindTile;
+constexpr uint32_t kMaxWindLevels = 48;
+// Worst-case compressed block: three bytes per residual.
+constexpr uint32_t kMaxWindBlockBytes = 2 * kWindTilePoints * 3;
+
+struct WindGridHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t n_levels;
+  uint32_t image_size;
+  uint32_t crc32;  // CRC-32 of bytes [sizeof(header), image_size)
+  uint32_t t0_utc_s;
+  uint32_t dt_s;
+  int32_t lat0_e7;  // south-west grid point
+  int32_t lon0_e7;
+  uint32_t dlat_e7;
+  uint32_t dlon_e7;
+  uint16_t n_lat;
+  uint16_t n_lon;
+  uint16_t n_times;
+  uint16_t reserved;
+  float unit_ms;
+};
+static_assert(sizeof(WindGridHeader) == 52, "wind header layout");
+
+inline uint32_t wind_tiles(uint32_t n) { return (n + kWindTile - 1) / kWindTile; }
+
+}  // namespace skyguard::wind
@@ -0,0 +1,110 @@
+#include "ground/aprs/afsk_demod.h"
+
+#include <cmath>
+
+#include "aprs/afsk.h"
+#include "util/crc16.h"
+
+namespace skyguard::ground {
+
+namespace {
+constexpr double kTwoPi = 6.283185307179586;
+constexpr double kPllGain = 0.3;
+constexpr size_t kMinFrameLen = 7 * 2 + 2 + 2;
+}  // namespace
+
+AfskDemodulator::AfskDemodulator(uint32_t sample_rate)
+    : sample_rate_(sample_rate),
+      window_(sample_rate / aprs::kAfskBaud),
+      history_(window_, 0.0f),
+      mi_(window_, 0.0f),
+      mq_(window_, 0.0f),
+      si_(window_, 0.0f),
+      sq_(window_, 0.0f) {}
+
+void AfskDemodulator::process(const float* samples, size_t n) {
+  const double wm = kTwoPi * aprs::kAfskMarkHz / sample_rate_;
+  const double ws = kTwoPi * aprs::kAfskSpaceHz / sample_rate_;
+  for (size_t k = 0; k < n; ++k, ++n_) {
+    dc_ += (samples[k] - dc_) * 0.001;
+    float x = static_cast<float>(samples[k] - dc_);
+
+    float a = static_cast<float>(x * std::cos(wm * n_));
+    float b = static_cast<float>(x * std::sin(wm * n_));
+    float c = static_cast<float>(x * std::cos(ws * n_));
+    float d = static_cast<float>(x * std::sin(ws * n_));
+    mark_i_ += a - mi_[pos_];
+    mark_q_ += b - mq_[pos_];
+    space_i_ += c - si_[pos_];
+    space_q_ += d - sq_[pos_];
+    mi_[pos_] = a;
+    mq_[pos_] = b;
+    si_[pos_] = c;
+    sq_[pos_] = d;
+    pos_ = (pos_ + 1) % window_;
+
+    double em = mark_i_ * mark_i_ + mark_q_ * mark_q_;
+    double es = space_i_ * space_i_ + space_q_ * space_q_;
+    on_tone(em > es);
+  }
+}
+
+void AfskDemodulator::on_tone(bool mark) {
+  if (mark != last_tone_) {
+    // Transitions should land half a bit away from the sampling instant.
+    bit_phase_ += (0.5 - bit_phase_) * kPllGain;
+    last_tone_ = mark;
+  }
+  bit_phase_ += static_cast<double>(aprs::kAfskBaud) / sample_rate_;
+  if (bit_phase_ >= 1.0) {
+    bit_phase_ -= 1.0;
+    on_bit(mark == last_sampled_);  // NRZI: no change is a 1
+    last_sampled_ = mark;
+  }
+}
+
+void AfskDemodulator::on_bit(bool bit) {
+  shift_ = static_cast<uint8_t>((shift_ >> 1) | (bit ? 0x80 : 0));
+  if (shift_ == 0x7E) {
+    if (in_frame_) end_frame();
+    in_frame_ = true;
+    buf_.clear();
+    cur_byte_ = 0;
+    cur_bits_ = 0;
+    ones_ = 0;
+    return;
+  }
+  if (!in_frame_) return;
+
+  if (bit) {
+    if (++ones_ >= 7) {  // abort
+      in_frame_ = false;
+      return;
+    }
+  } else {
+    bool stuffed = ones_ == 5;
+    ones_ = 0;
+    if (stuffed) return;
+  }
+  cur_byte_ = static_cast<uint8_t>((cur_byte_ >> 1) | (bit ? 0x80 : 0));
+  if (++cur_bits_ == 8) {
+    buf_.push_back(cur_byte_);
+    cur_bits_ = 0;
+  }
+}
+
+void AfskDemodulator::end_frame() {
+  // The first seven bits of the closing flag have already been shifted in
+  // as data; drop the partial byte they formed.
+  if (buf_.size() < kMinFrameLen) return;
+  uint16_t fcs = static_cast<uint16_t>(buf_[buf_.size() - 2] |
+                                       (buf_[buf_.size() - 1] << 8));
+  uint16_t crc = crc16_x25(buf_.data(), buf_.size() - 2);
+  if (crc != fcs) {
+    ++crc_errors_;
+    return;
+  }
+  frames_.emplace_back(buf_.begin(), buf_.end() - 2);
+}
+
+}  // namespace skyguard::ground
@@ -0,0 +1,56 @@
+// Reference Bell 202 AFSK demodulator and HDLC deframer.
+//
+// Used on the ground side to check the firmware's modulator output end to
+// end: sliding-window mark/space correlators, a simple DPLL for bit timing,
+// NRZI decoding, bit unstuffing and FCS verification. It favours clarity
+// over weak-signal performance.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+namespace skyguard::ground {
+
+class AfskDemodulator {
+ public:
+  explicit AfskDemodulator(uint32_t sample_rate);
+
+  /// Feeds samples (any DC offset is removed). Complete frames with a valid
+  /// FCS are appended to frames(), FCS bytes stripped.
+  void process(const float* samples, size_t n);
+
+  const std::vector<std::vector<uint8_t>>& frames() const { return frames_; }
+  size_t crc_errors() const { return crc_errors_; }
+
+ private:
+  void on_tone(bool mark);
+  void on_bit(bool bit);
+  void end_frame();
+
+  uint32_t sample_rate_;
+  size_t window_;
+  std::vector<float> history_;
+  size_t pos_ = 0;
+  double mark_i_ = 0, mark_q_ = 0, space_i_ = 0, space_q_ = 0;
+  std::vector<float> mi_, mq_, si_, sq_;
+  uint64_t n_ = 0;
+  double dc_ = 0;
+
+  double bit_phase_ = 0;
+  bool last_tone_ = true;
+  bool last_sampled_ = true;
+
+  uint8_t shift_ = 0;
+  int ones_ = 0;
+  bool in_frame_ = false;
+  uint8_t cur_byte_ = 0;
+  int cur_bits_ = 0;
+  std::vector<uint8_t> buf_;
+
+  std::vector<std::vector<uint8_t>> frames_;
+  size_t crc_errors_ = 0;
+};
+
+}  // namespace skyguard::ground
@@ -0,0 +1,199 @@
+#include "ground/fence/fence_sdf.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <algorithm>
+
+namespace skyguard::ground {
+
+namespace {
+
+using geofence::FenceSdfHeader;
+using geofence::kMetresPerLatE7;
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr uint32_t kBucketSamples = 8;
+// Float evaluation on board: sample positions and weights.
+constexpr double kFloatSlopM = 0.05;
+
+double segment_distance(double px, double py, double ax, double ay, double bx, double by) {
+  double dx = bx - ax, dy = by - ay;
+  double len2 = dx * dx + dy * dy;
+  double t = len2 > 0 ? std::clamp(((px - ax) * dx + (py - ay) * dy) / len2, 0.0, 1.0) : 0.0;
+  double x = ax + t * dx - px, y = ay + t * dy - py;
+  return sqrt(x * x + y * y);
+}
+
+}  // namespace
+
+bool build_fence_sdf(const CompiledFence& fence, const SdfOptions& opt, std::vector<uint8_t>* out,
+                     SdfStats* stats, std::string* err) {
+  size_t n = fence.ring_e7.size() / 2;
+  const int32_t* v = fence.ring_e7.data();  // lat, lon
+  if (n < 3 || opt.step_m <= 0 || opt.max_side < 2) {
+    *err = "bad raster parameters";
+    return false;
+  }
+  int64_t min_lat = v[0], max_lat = v[0], min_lon = v[1], max_lon = v[1];
+  for (size_t i = 0; i < n; ++i) {
+    min_lat = std::min<int64_t>(min_lat, v[2 * i]);
+    max_lat = std::max<int64_t>(max_lat, v[2 * i]);
+    min_lon = std::min<int64_t>(min_lon, v[2 * i + 1]);
+    max_lon = std::max<int64_t>(max_lon, v[2 * i + 1]);
+  }
+
+  // The device uses exactly these float scales.
+  const double lat_m = kMetresPerLatE7;
+  const double lon_m = static_cast<float>(
+      kMetresPerLatE7 * cos(double(min_lat + max_lat) / 2 * 1e-7 * kPi / 180));
+  double width_m = double(max_lon - min_lon) * lon_m + 2 * opt.margin_m;
+  double height_m = double(max_lat - min_lat) * lat_m + 2 * opt.margin_m;
+  double step = std::max({opt.step_m, width_m / (opt.max_side - 1), height_m / (opt.max_side - 1)});
+
+  FenceSdfHeader h{};
+  h.step_lat_e7 = static_cast<uint32_t>(std::max(1.0, ceil(step / lat_m)));
+  h.step_lon_e7 = static_cast<uint32_t>(std::max(1.0, ceil(step / lon_m)));
+  h.origin_lat_e7 = static_cast<int32_t>(min_lat - static_cast<int64_t>(opt.margin_m / lat_m) - 1);
+  h.origin_lon_e7 = static_cast<int32_t>(min_lon - static_cast<int64_t>(opt.margin_m / lon_m) - 1);
+  double step_x = h.step_lon_e7 * lon_m, step_y = h.step_lat_e7 * lat_m;
+  h.cols = static_cast<uint16_t>(ceil(width_m / step_x) + 1);
+  h.rows = static_cast<uint16_t>(ceil(height_m / step_y) + 1);
+  h.lon_metres_per_e7 = static_cast<float>(lon_m);
+  h.margin_m = static_cast<float>(opt.margin_m);
+  uint32_t cols = h.cols, rows = h.rows;
+
+  // Sample (c, r) in metres relative to the origin; edges in the same frame.
+  std::vector<double> ex(n), ey(n);
+  for (size_t i = 0; i < n; ++i) {
+    ey[i] = double(int64_t(v[2 * i]) - h.origin_lat_e7) * lat_m;
+    ex[i] = double(int64_t(v[2 * i + 1]) - h.origin_lon_e7) * lon_m;
+  }
+
+  // Edge buckets of kBucketSamples x kBucketSamples samples.
+  uint32_t bw = (cols + kBucketSamples - 1) / kBucketSamples;
+  uint32_t bh = (rows + kBucketSamples - 1) / kBucketSamples;
+  double bucket_x = kBucketSamples * step_x, bucket_y = kBucketSamples * step_y;
+  std::vector<std::vector<uint32_t>> buckets(size_t(bw) * bh);
+  auto bucket_of = [](double p, double size, uint32_t count) {
+    return static_cast<uint32_t>(std::clamp(floor(p / size), 0.0, double(count - 1)));
+  };
+  for (size_t a = 0; a < n; ++a) {
+    size_t b = (a + 1) % n;
+    uint32_t x0 = bucket_of(std::min(ex[a], ex[b]), bucket_x, bw);
+    uint32_t x1 = bucket_of(std::max(ex[a], ex[b]), bucket_x, bw);
+    uint32_t y0 = bucket_of(std::min(ey[a], ey[b]), bucket_y, bh);
+    uint32_t y1 = bucket_of(std::max(ey[a], ey[b]), bucket_y, bh);
+    for (uint32_t y = y0; y <= y1; ++y) {
+      for (uint32_t x = x0; x <= x1; ++x) buckets[size_t(y) * bw + x].push_back(uint32_t(a));
+    }
+  }
+
+  // Nearest edge to (px, py): rings of buckets until nothing unsearched
+  // can be nearer.
+  auto nearest = [&](double px, double py) {
+    uint32_t bx = bucket_of(px, bucket_x, bw), by = bucket_of(py, bucket_y, bh);
+    double best = INFINITY;
+    for (uint32_t ring = 0;; ++ring) {
+      int64_t lo_x = int64_t(bx) - ring, hi_x = int64_t(bx) + ring;
+      int64_t lo_y = int64_t(by) - ring, hi_y = int64_t(by) + ring;
+      for (int64_t y = std::max<int64_t>(lo_y, 0); y <= std::min<int64_t>(hi_y, bh - 1); ++y) {
+        for (int64_t x = std::max<int64_t>(lo_x, 0); x <= std::min<int64_t>(hi_x, bw - 1); ++x) {
+          if (x != lo_x && x != hi_x && y != lo_y && y != hi_y) continue;
+          for (uint32_t a : buckets[size_t(y) * bw + size_t(x)]) {
+            size_t b = (a + 1) % n;
+            best = std::min(best, segment_distance(px, py, ex[a], ey[a], ex[b], ey[b]));
+          }
+        }
+      }
+      bool covered = lo_x <= 0 && lo_y <= 0 && hi_x >= bw - 1 && hi_y >= bh - 1;
+      if (covered || best <= ring * std::min(bucket_x, bucket_y)) return best;
+    }
+  };
+
+  // Inside/outside along each row from its edge crossings.
+  std::vector<uint8_t> inside(size_t(cols) * rows);
+  std::vector<double> crossings;
+  for (uint32_t r = 0; r < rows; ++r) {
+    double py = r * step_y;
+    crossings.clear();
+    for (size_t a = 0; a < n; ++a) {
+      size_t b = (a + 1) % n;
+      if ((ey[a] > py) != (ey[b] > py)) {
+        crossings.push_back(ex[a] + (py - ey[a]) * (ex[b] - ex[a]) / (ey[b] - ey[a]));
+      }
+    }
+    std::sort(crossings.begin(), crossings.end());
+    size_t k = 0;
+    for (uint32_t c = 0; c < cols; ++c) {
+      while (k < crossings.size() && crossings[k] <= c * step_x) ++k;
+      inside[size_t(r) * cols + c] = k % 2;
+    }
+  }
+
+  // Per bucket, only edges that can be nearest to one of its samples: within
+  // (centre's nearest + half diagonal) of the samples, so within that plus
+  // another half diagonal of the centre.
+  std::vector<double> dist(size_t(cols) * rows);
+  std::vector<uint32_t> candidates, stamp(n, UINT32_MAX);
+  double half_diag = sqrt(bucket_x * bucket_x + bucket_y * bucket_y) / 2;
+  double max_abs = 0;
+  for (uint32_t by = 0; by < bh; ++by) {
+    for (uint32_t bx = 0; bx < bw; ++bx) {
+      uint32_t bucket = by * bw + bx;
+      double cx = (bx + 0.5) * bucket_x - step_x / 2, cy = (by + 0.5) * bucket_y - step_y / 2;
+      double reach = nearest(cx, cy) + 2 * half_diag;
+      candidates.clear();
+      uint32_t x0 = bucket_of(cx - reach, bucket_x, bw), x1 = bucket_of(cx + reach, bucket_x, bw);
+      uint32_t y0 = bucket_of(cy - reach, bucket_y, bh), y1 = bucket_of(cy + reach, bucket_y, bh);
+      for (uint32_t y = y0; y <= y1; ++y) {
+        for (uint32_t x = x0; x <= x1; ++x) {
+          for (uint32_t a : buckets[size_t(y) * bw + x]) {
+            if (stamp[a] == bucket) continue;
+            stamp[a] = bucket;
+            size_t b = (a + 1) % n;
+            if (segment_distance(cx, cy, ex[a], ey[a], ex[b], ey[b]) <= reach) {
+              candidates.push_back(a);
+            }
+          }
+        }
+      }
+      for (uint32_t r = by * kBucketSamples; r < std::min(rows, (by + 1) * kBucketSamples); ++r) {
+        for (uint32_t c = bx * kBucketSamples; c < std::min(cols, (bx + 1) * kBucketSamples);
+             ++c) {
+          double px = c * step_x, py = r * step_y, best = INFINITY;
+          for (uint32_t a : candidates) {
+            size_t b = (a + 1) % n;
+            best = std::min(best, segment_distance(px, py, ex[a], ey[a], ex[b], ey[b]));
+          }
+          size_t i = size_t(r) * cols + c;
+          dist[i] = inside[i] ? -best : best;
+          max_abs = std::max(max_abs, best);
+        }
+      }
+    }
+  }
+
+  double unit = std::max(step / 64, max_abs / 32000);
+  h.metres_per_unit = static_cast<float>(unit);
+  h.max_error_m =
+      static_cast<float>(sqrt(step_x * step_x + step_y * step_y) / 2 + unit / 2 + kFloatSlopM);
+
+  size_t at = out->size();
+  size_t bytes = (sizeof(h) + 2 * dist.size() + 3) & ~size_t{3};
+  out->resize(at + bytes, 0);
+  memcpy(out->data() + at, &h, sizeof(h));
+  auto* s = reinterpret_cast<int16_t*>(out->data() + at + sizeof(h));
+  for (size_t i = 0; i < dist.size(); ++i) {
+    s[i] = static_cast<int16_t>(std::clamp(lround(dist[i] / unit), -32767L, 32767L));
+  }
+  if (stats) {
+    stats->cols = cols;
+    stats->rows = rows;
+    stats->step_m = step;
+    stats->max_error_m = h.max_error_m;
+  }
+  return true;
+}
+
+}  // namespace skyguard::ground
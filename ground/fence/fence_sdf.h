@@ -0,0 +1,35 @@
+// Signed-distance raster for one compiled fence (see FenceSdfHeader in
+// firmware/geofence/fence_format.h).
+//
+// Samples are exact distances to the compiled ring in the fence's local
+// metric, found with a bucketed nearest-edge search. The recorded error
+// bound covers bilinear interpolation of a 1-Lipschitz field (half the
+// sample diagonal) plus quantisation.
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "ground/fence/fence_writer.h"
+
+namespace skyguard::ground {
+
+struct SdfOptions {
+  double step_m = 250;     // sample spacing
+  double margin_m = 2000;  // coverage beyond the bounding box
+  uint32_t max_side = 512;  // samples per axis; the step grows to fit
+};
+
+struct SdfStats {
+  uint32_t cols = 0, rows = 0;
+  double step_m = 0;
+  double max_error_m = 0;
+};
+
+/// Appends the header and samples to `out`, padded to 4 bytes.
+bool build_fence_sdf(const CompiledFence& fence, const SdfOptions& opt, std::vector<uint8_t>* out,
+                     SdfStats* stats, std::string* err);
+
+}  // namespace skyguard::ground
@@ -0,0 +1,465 @@
+#include "ground/fence/fence_simplify.h"
+
+#include <math.h>
+
+#include <algorithm>
+
+namespace skyguard::ground {
+
+namespace {
+
+using geofence::FenceKind;
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kEarthRadiusM = 6371008.8;
+constexpr double kMetresPerDegree = kEarthRadiusM * kPi / 180.0;
+constexpr double kE7 = 1e7;
+// Covers rounding to 1e-7 degree (about 6 mm at worst) plus float slop.
+constexpr double kRoundingAllowanceM = 0.02;
+constexpr double kMaxAbsLatitude = 85.0;
+constexpr int kMaxPasses = 64;
+
+struct Vec {
+  double x, y;
+};
+
+Vec operator+(Vec a, Vec b) { return {a.x + b.x, a.y + b.y}; }
+Vec operator-(Vec a, Vec b) { return {a.x - b.x, a.y - b.y}; }
+Vec operator*(Vec a, double k) { return {a.x * k, a.y * k}; }
+double cross(Vec a, Vec b) { return a.x * b.y - a.y * b.x; }
+double dot(Vec a, Vec b) { return a.x * b.x + a.y * b.y; }
+double norm(Vec a) { return sqrt(dot(a, a)); }
+double orient(Vec a, Vec b, Vec c) { return cross(b - a, c - a); }
+
+double segment_distance(Vec p, Vec a, Vec b) {
+  Vec ab = b - a;
+  double len2 = dot(ab, ab);
+  double t = len2 > 0 ? std::clamp(dot(p - a, ab) / len2, 0.0, 1.0) : 0.0;
+  return norm(p - (a + ab * t));
+}
+
+// --- exact-or-double segment predicates shared by both simplicity checks --
+
+template <typename A, typename P>
+int orient_sign(const P& a, const P& b, const P& c) {
+  A v = (A(b.x) - A(a.x)) * (A(c.y) - A(a.y)) - (A(b.y) - A(a.y)) * (A(c.x) - A(a.x));
+  return (v > 0) - (v < 0);
+}
+
+// c is collinear with a-b; is it within the segment's closed extent?
+template <typename P>
+bool within(const P& a, const P& b, const P& c) {
+  return std::min(a.x, b.x) <= c.x && c.x <= std::max(a.x, b.x) && std::min(a.y, b.y) <= c.y &&
+         c.y <= std::max(a.y, b.y);
+}
+
+template <typename A, typename P>
+bool segments_touch(const P& a, const P& b, const P& c, const P& d) {
+  int o1 = orient_sign<A>(a, b, c), o2 = orient_sign<A>(a, b, d);
+  int o3 = orient_sign<A>(c, d, a), o4 = orient_sign<A>(c, d, b);
+  if (o1 * o2 < 0 && o3 * o4 < 0) return true;
+  return (o1 == 0 && within(a, b, c)) || (o2 == 0 && within(a, b, d)) ||
+         (o3 == 0 && within(c, d, a)) || (o4 == 0 && within(c, d, b));
+}
+
+// Uniform bucket grid of segments keyed by a caller-chosen id. Points
+// outside the bounds clamp to the border cells, which keeps bbox overlap
+// queries exact.
+class SegmentGrid {
+ public:
+  SegmentGrid(double min_x, double min_y, double max_x, double max_y, size_t segments)
+      : min_x_(min_x), min_y_(min_y) {
+    double w = std::max(max_x - min_x, 1e-9), h = std::max(max_y - min_y, 1e-9);
+    double cell = sqrt(w * h / std::max<size_t>(segments, 1));
+    nx_ = std::clamp<size_t>(static_cast<size_t>(w / cell) + 1, 1, 4096);
+    ny_ = std::clamp<size_t>(static_cast<size_t>(h / cell) + 1, 1, 4096);
+    cw_ = w / nx_;
+    ch_ = h / ny_;
+    cells_.resize(nx_ * ny_);
+  }
+
+  void insert(double x0, double y0, double x1, double y1, uint64_t key) {
+    visit(x0, y0, x1, y1, [&](std::vector<uint64_t>& c) { c.push_back(key); });
+  }
+
+  template <typename F>
+  void query(double x0, double y0, double x1, double y1, F&& f) {
+    visit(x0, y0, x1, y1, [&](std::vector<uint64_t>& c) {
+      for (uint64_t k : c) f(k);
+    });
+  }
+
+ private:
+  size_t clamp_index(double v, double origin, double size, size_t n) const {
+    double i = floor((v - origin) / size);
+    return i <= 0 ? 0 : std::min(static_cast<size_t>(i), n - 1);
+  }
+
+  template <typename F>
+  void visit(double x0, double y0, double x1, double y1, F&& f) {
+    size_t ix0 = clamp_index(std::min(x0, x1), min_x_, cw_, nx_);
+    size_t ix1 = clamp_index(std::max(x0, x1), min_x_, cw_, nx_);
+    size_t iy0 = clamp_index(std::min(y0, y1), min_y_, ch_, ny_);
+    size_t iy1 = clamp_index(std::max(y0, y1), min_y_, ch_, ny_);
+    for (size_t y = iy0; y <= iy1; ++y) {
+      for (size_t x = ix0; x <= ix1; ++x) f(cells_[y * nx_ + x]);
+    }
+  }
+
+  double min_x_, min_y_, cw_, ch_;
+  size_t nx_, ny_;
+  std::vector<std::vector<uint64_t>> cells_;
+};
+
+template <typename A, typename P>
+bool ring_simple(const std::vector<P>& p) {
+  size_t n = p.size();
+  if (n < 3) return false;
+  double min_x = p[0].x, max_x = p[0].x, min_y = p[0].y, max_y = p[0].y;
+  for (const P& q : p) {
+    min_x = std::min<double>(min_x, q.x);
+    max_x = std::max<double>(max_x, q.x);
+    min_y = std::min<double>(min_y, q.y);
+    max_y = std::max<double>(max_y, q.y);
+  }
+  SegmentGrid grid(min_x, min_y, max_x, max_y, n);
+  for (size_t i = 0; i < n; ++i) {
+    const P& a = p[i];
+    const P& b = p[(i + 1) % n];
+    const P& c = p[(i + 2) % n];
+    if (a.x == b.x && a.y == b.y) return false;
+    // Neighbours may only share their vertex: reject folds back along a.
+    if (orient_sign<A>(a, b, c) == 0 &&
+        (A(b.x) - A(a.x)) * (A(c.x) - A(b.x)) + (A(b.y) - A(a.y)) * (A(c.y) - A(b.y)) <= 0) {
+      return false;
+    }
+    grid.insert(a.x, a.y, b.x, b.y, i);
+  }
+  std::vector<size_t> stamp(n, SIZE_MAX);
+  for (size_t i = 0; i < n; ++i) {
+    const P& a = p[i];
+    const P& b = p[(i + 1) % n];
+    bool ok = true;
+    grid.query(a.x, a.y, b.x, b.y, [&](uint64_t k) {
+      size_t j = static_cast<size_t>(k);
+      if (!ok || j <= i || stamp[j] == i) return;
+      stamp[j] = i;
+      if (j == i + 1 || (i == 0 && j == n - 1)) return;
+      if (segments_touch<A>(a, b, p[j], p[(j + 1) % n])) ok = false;
+    });
+    if (!ok) return false;
+  }
+  return true;
+}
+
+struct PointE7 {
+  int32_t x, y;  // lon, lat
+};
+
+// --- simplification ------------------------------------------------------
+
+// Doubly linked ring with a per-vertex version that changes whenever the
+// edge leaving that vertex changes, so stale grid entries can be skipped.
+struct Ring {
+  std::vector<Vec> p;
+  std::vector<uint32_t> next, prev, ver;
+  std::vector<double> err;  // deviation bound of the edge leaving the vertex
+  std::vector<uint8_t> alive;
+  size_t count = 0;
+};
+
+class Simplifier {
+ public:
+  Simplifier(const std::vector<Vec>& pts, double tol) : tol_(tol), grid_(make_grid(pts, tol)) {
+    size_t n = pts.size();
+    r_.p = pts;
+    r_.next.resize(n);
+    r_.prev.resize(n);
+    r_.ver.assign(n, 0);
+    r_.err.assign(n, 0);
+    r_.alive.assign(n, 1);
+    r_.count = n;
+    for (size_t i = 0; i < n; ++i) {
+      r_.next[i] = static_cast<uint32_t>((i + 1) % n);
+      r_.prev[i] = static_cast<uint32_t>((i + n - 1) % n);
+      insert_edge(static_cast<uint32_t>(i));
+    }
+  }
+
+  std::vector<Vec> run() {
+    for (int pass = 0; pass < kMaxPasses; ++pass) {
+      bool changed = false;
+      for (uint32_t v = 0; v < r_.p.size() && r_.count > 3; ++v) {
+        if (!r_.alive[v]) continue;
+        changed |= drop_reflex(v) || collapse_convex_pair(v);
+      }
+      if (!changed) break;
+    }
+    std::vector<Vec> out;
+    uint32_t start = 0;
+    while (!r_.alive[start]) ++start;
+    uint32_t v = start;
+    do {
+      out.push_back(r_.p[v]);
+      v = r_.next[v];
+    } while (v != start);
+    return out;
+  }
+
+ private:
+  static SegmentGrid make_grid(const std::vector<Vec>& pts, double margin) {
+    double min_x = pts[0].x, min_y = pts[0].y, max_x = pts[0].x, max_y = pts[0].y;
+    for (Vec q : pts) {
+      min_x = std::min(min_x, q.x);
+      min_y = std::min(min_y, q.y);
+      max_x = std::max(max_x, q.x);
+      max_y = std::max(max_y, q.y);
+    }
+    return SegmentGrid(min_x - margin, min_y - margin, max_x + margin, max_y + margin,
+                       pts.size());
+  }
+
+  void insert_edge(uint32_t v) {
+    Vec a = r_.p[v], b = r_.p[r_.next[v]];
+    grid_.insert(a.x, a.y, b.x, b.y, (static_cast<uint64_t>(r_.ver[v]) << 32) | v);
+  }
+
+  void touch(uint32_t v) {
+    ++r_.ver[v];
+    insert_edge(v);
+  }
+
+  // True if segment a-b touches no live edge except those starting at the
+  // `skip` vertices.
+  bool clear(Vec a, Vec b, const uint32_t* skip, size_t n_skip) {
+    bool ok = true;
+    grid_.query(a.x, a.y, b.x, b.y, [&](uint64_t key) {
+      uint32_t v = static_cast<uint32_t>(key);
+      if (!ok || !r_.alive[v] || r_.ver[v] != static_cast<uint32_t>(key >> 32)) return;
+      for (size_t i = 0; i < n_skip; ++i) {
+        if (skip[i] == v) return;
+      }
+      if (segments_touch<double>(a, b, r_.p[v], r_.p[r_.next[v]])) ok = false;
+    });
+    return ok;
+  }
+
+  static bool in_triangle(Vec q, Vec a, Vec b, Vec c) {
+    double o1 = orient(a, b, q), o2 = orient(b, c, q), o3 = orient(c, a, q);
+    return (o1 >= 0 && o2 >= 0 && o3 >= 0) || (o1 <= 0 && o2 <= 0 && o3 <= 0);
+  }
+
+  // The ring turns right (or goes straight) at v: replacing a-v-b with a-b
+  // grows the left side by the triangle a, v, b.
+  bool drop_reflex(uint32_t v) {
+    uint32_t a = r_.prev[v], b = r_.next[v];
+    Vec pa = r_.p[a], pv = r_.p[v], pb = r_.p[b];
+    double o = orient(pa, pv, pb);
+    double chord = norm(pb - pa);
+    if (o > 0 || chord == 0) return false;
+    double err = -o / chord + std::max(r_.err[a], r_.err[v]);
+    if (err > tol_) return false;
+    uint32_t pa_prev = r_.prev[a], pb_next = r_.next[b];
+    if (in_triangle(r_.p[pa_prev], pa, pv, pb) || in_triangle(r_.p[pb_next], pa, pv, pb)) {
+      return false;
+    }
+    const uint32_t skip[] = {pa_prev, a, v, b};
+    if (!clear(pa, pb, skip, 4)) return false;
+    r_.alive[v] = 0;
+    r_.next[a] = b;
+    r_.prev[b] = a;
+    r_.err[a] = err;
+    --r_.count;
+    touch(a);
+    return true;
+  }
+
+  // The ring turns left at both v and w = next(v): extend a-v and b-w to
+  // meet at X and replace a-v-w-b with a-X-b.
+  bool collapse_convex_pair(uint32_t v) {
+    uint32_t w = r_.next[v], a = r_.prev[v], b = r_.next[w];
+    if (a == b) return false;
+    Vec pa = r_.p[a], pv = r_.p[v], pw = r_.p[w], pb = r_.p[b];
+    if (orient(pa, pv, pw) <= 0 || orient(pv, pw, pb) <= 0) return false;
+    Vec d1 = pv - pa, d2 = pw - pb;
+    double den = cross(d1, d2);
+    if (den == 0) return false;
+    double t = cross(pw - pv, d2) / den;
+    double s = cross(pw - pv, d1) / den;
+    if (t <= 0 || s <= 0) return false;
+    Vec x = pv + d1 * t;
+    if (orient(pv, pw, x) >= 0) return false;
+    double dx = segment_distance(x, pv, pw);
+    double err_ax = std::max(r_.err[a], r_.err[v] + dx);
+    double err_xb = std::max(r_.err[w], r_.err[v] + dx);
+    if (err_ax > tol_ || err_xb > tol_) return false;
+    const uint32_t skip[] = {r_.prev[a], a, v, w, b};
+    if (!clear(pa, x, skip, 5) || !clear(x, pb, skip, 5)) return false;
+    r_.p[v] = x;
+    r_.alive[w] = 0;
+    r_.next[v] = b;
+    r_.prev[b] = v;
+    r_.err[a] = err_ax;
+    r_.err[v] = err_xb;
+    --r_.count;
+    touch(a);
+    touch(v);
+    return true;
+  }
+
+  double tol_;
+  Ring r_;
+  SegmentGrid grid_;
+};
+
+// --- buffering -----------------------------------------------------------
+
+struct Line {
+  Vec p;  // a point on the line
+  Vec u;  // unit direction of travel
+};
+
+Vec meet(const Line& l1, const Line& l2) {
+  double den = cross(l1.u, l2.u);
+  if (fabs(den) < 1e-12) return l2.p;  // parallel: the lines coincide
+  double t = cross(l2.p - l1.p, l2.u) / den;
+  return l1.p + l1.u * t;
+}
+
+// Moves every edge `d` to its right, i.e. grows the left side.
+bool offset_ring(const std::vector<Vec>& q, double d, std::vector<Vec>* out) {
+  size_t n = q.size();
+  std::vector<Line> lines;
+  lines.reserve(2 * n);
+  auto unit = [&](size_t j) {
+    Vec e = q[(j + 1) % n] - q[j];
+    return e * (1.0 / norm(e));
+  };
+  for (size_t j = 0; j < n; ++j) {
+    Vec u0 = unit((j + n - 1) % n), u1 = unit(j);
+    Vec n0{u0.y, -u0.x}, n1{u1.y, -u1.x};
+    if (cross(u0, u1) > 0 && dot(n0, n1) < 0) {
+      // Sharp convex corner: bevel on the tangent to the circle round q[j].
+      Vec m = n0 + n1;
+      double len = norm(m);
+      m = len < 1e-9 ? u0 : m * (1.0 / len);
+      lines.push_back({q[j] + m * d, {-m.y, m.x}});
+    }
+    lines.push_back({q[j] + n1 * d, u1});
+  }
+
+  // Drop edges that the offset turned around, until none are left.
+  for (bool changed = true; changed && lines.size() >= 3;) {
+    changed = false;
+    size_t m = lines.size();
+    std::vector<Vec> v(m);
+    for (size_t j = 0; j < m; ++j) v[j] = meet(lines[(j + m - 1) % m], lines[j]);
+    for (size_t j = 0; j < m; ++j) {
+      if (dot(v[(j + 1) % m] - v[j], lines[j].u) < 0) {
+        lines.erase(lines.begin() + static_cast<ptrdiff_t>(j));
+        changed = true;
+        break;
+      }
+    }
+  }
+  if (lines.size() < 3) return false;
+  size_t m = lines.size();
+  out->resize(m);
+  for (size_t j = 0; j < m; ++j) (*out)[j] = meet(lines[(j + m - 1) % m], lines[j]);
+  return true;
+}
+
+double signed_area(const std::vector<Vec>& q) {
+  double a = 0;
+  for (size_t i = 0; i < q.size(); ++i) a += cross(q[i], q[(i + 1) % q.size()]);
+  return a / 2;
+}
+
+}  // namespace
+
+bool ring_is_simple_e7(const std::vector<int32_t>& ring_e7) {
+  std::vector<PointE7> p(ring_e7.size() / 2);
+  for (size_t i = 0; i < p.size(); ++i) p[i] = {ring_e7[2 * i + 1], ring_e7[2 * i]};
+  return ring_simple<int64_t>(p);
+}
+
+bool compile_ring(const std::vector<LatLon>& ring, FenceKind kind, const SimplifyOptions& opt,
+                  std::vector<int32_t>* out_e7, std::string* err) {
+  if (ring.size() < 3) {
+    *err = "fewer than 3 vertices";
+    return false;
+  }
+  double min_lat = ring[0].lat, max_lat = ring[0].lat;
+  double min_lon = ring[0].lon, max_lon = ring[0].lon;
+  for (const LatLon& q : ring) {
+    min_lat = std::min(min_lat, q.lat);
+    max_lat = std::max(max_lat, q.lat);
+    min_lon = std::min(min_lon, q.lon);
+    max_lon = std::max(max_lon, q.lon);
+  }
+  if (min_lat < -kMaxAbsLatitude || max_lat > kMaxAbsLatitude || min_lon < -180 ||
+      max_lon > 180 || (max_lat - min_lat) * kE7 > geofence::kMaxFenceSpanE7 / 2 ||
+      (max_lon - min_lon) * kE7 > geofence::kMaxFenceSpanE7 / 2) {
+    *err = "outside the supported extent";
+    return false;
+  }
+
+  // Local frame and its worst-case east-west stretch over the polygon.
+  double lat0 = (min_lat + max_lat) / 2, lon0 = (min_lon + max_lon) / 2;
+  double cos0 = cos(lat0 * kPi / 180);
+  double kx = kMetresPerDegree * cos0, ky = kMetresPerDegree;
+  double far_abs = std::max(fabs(min_lat), fabs(max_lat));
+  double near_abs = min_lat <= 0 && max_lat >= 0 ? 0 : std::min(fabs(min_lat), fabs(max_lat));
+  double s_min = std::min(1.0, cos(far_abs * kPi / 180) / cos0);
+  double s_max = std::max(1.0, cos(near_abs * kPi / 180) / cos0);
+  double tol = opt.tolerance_m / s_max;
+  double buffer = (opt.buffer_m + kRoundingAllowanceM) / s_min;
+
+  std::vector<Vec> pts;
+  pts.reserve(ring.size());
+  for (const LatLon& q : ring) {
+    Vec v{(q.lon - lon0) * kx, (q.lat - lat0) * ky};
+    if (pts.empty() || v.x != pts.back().x || v.y != pts.back().y) pts.push_back(v);
+  }
+  while (pts.size() > 1 && pts.front().x == pts.back().x && pts.front().y == pts.back().y) {
+    pts.pop_back();
+  }
+  if (!ring_simple<double>(pts)) {
+    *err = "input ring is not simple";
+    return false;
+  }
+  // Orient so the restricted side is on the left of travel.
+  bool ccw = signed_area(pts) > 0;
+  if (ccw != (kind == FenceKind::kKeepOut)) std::reverse(pts.begin(), pts.end());
+  double area_sign = kind == FenceKind::kKeepOut ? 1 : -1;
+
+  // A simplified ring whose offset fails is retried unsimplified.
+  for (double t : {tol, 0.0}) {
+    std::vector<Vec> simple = t > 0 && pts.size() > 3 ? Simplifier(pts, t).run() : pts;
+    std::vector<Vec> grown;
+    if (!offset_ring(simple, buffer, &grown) || signed_area(grown) * area_sign <= 0) continue;
+    out_e7->clear();
+    for (Vec v : grown) {
+      int32_t lat = static_cast<int32_t>(lround((lat0 + v.y / ky) * kE7));
+      int32_t lon = static_cast<int32_t>(lround((lon0 + v.x / kx) * kE7));
+      size_t n = out_e7->size();
+      if (n >= 2 && (*out_e7)[n - 2] == lat && (*out_e7)[n - 1] == lon) continue;
+      out_e7->push_back(lat);
+      out_e7->push_back(lon);
+    }
+    size_t n = out_e7->size();
+    if (n >= 4 && (*out_e7)[0] == (*out_e7)[n - 2] && (*out_e7)[1] == (*out_e7)[n - 1]) {
+      out_e7->resize(n - 2);
+    }
+    if (out_e7->size() / 2 > geofence::kMaxFenceVertices) {
+      *err = "too many vertices after simplification; raise the tolerance";
+      return false;
+    }
+    if (ring_is_simple_e7(*out_e7)) return true;
+  }
+  *err = kind == FenceKind::kKeepIn ? "buffer leaves no simple keep-in area"
+                                    : "buffered ring is not simple";
+  return false;
+}
+
+}  // namespace skyguard::ground
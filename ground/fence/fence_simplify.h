@@ -0,0 +1,44 @@
+// Conservative simplification and buffering of fence polygons.
+//
+// The restricted side of a fence is its inside for keep-out and its outside
+// for keep-in. compile_ring() only ever moves the boundary into the
+// permitted side: vertices are dropped where that grows the restricted side
+// by at most `tolerance_m`, and convex vertex pairs are collapsed onto the
+// intersection of their neighbouring edges under the same bound. The result
+// is then offset by `buffer_m` into the permitted side (mitred at reflex
+// corners, bevelled tangent to the buffer circle at sharp convex ones) and
+// rounded to the 1e-7 degree grid with a small allowance so rounding never
+// undoes the guarantee.
+//
+// Geometry is done in a local equirectangular frame per polygon; distances
+// are scaled by the frame's worst-case stretch over the polygon's latitude
+// range so the bounds hold on the sphere.
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "geofence/fence_format.h"
+#include "ground/fence/fence_source.h"
+
+namespace skyguard::ground {
+
+struct SimplifyOptions {
+  double tolerance_m = 50;  // furthest the restricted side may grow
+  double buffer_m = 0;      // safety margin added to the restricted side
+};
+
+/// Produces the on-board ring as lat_e7, lon_e7 pairs. Returns false with
+/// `*err` set if the input is not a simple polygon or the result would not
+/// be one (e.g. a keep-in narrower than twice the buffer).
+bool compile_ring(const std::vector<LatLon>& ring, geofence::FenceKind kind,
+                  const SimplifyOptions& opt, std::vector<int32_t>* out_e7, std::string* err);
+
+/// Exact simplicity check of a closed lat_e7, lon_e7 ring: no repeated
+/// consecutive vertices, no spikes and no two edges touching other than
+/// neighbours at their shared vertex.
+bool ring_is_simple_e7(const std::vector<int32_t>& ring_e7);
+
+}  // namespace skyguard::ground
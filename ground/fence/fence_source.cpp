@@ -0,0 +1,361 @@
+#include "ground/fence/fence_source.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <utility>
+
+namespace skyguard::ground {
+
+namespace {
+
+using geofence::FenceKind;
+
+// Just enough of a JSON DOM for GeoJSON: numbers, strings, arrays, objects.
+struct Json {
+  enum Type { kNull, kBool, kNumber, kString, kArray, kObject } type = kNull;
+  double number = 0;
+  std::string str;
+  std::vector<Json> items;
+  std::vector<std::pair<std::string, Json>> members;
+
+  const Json* get(const char* key) const {
+    for (const auto& m : members) {
+      if (m.first == key) return &m.second;
+    }
+    return nullptr;
+  }
+};
+
+class JsonParser {
+ public:
+  explicit JsonParser(const std::string& s) : s_(s.c_str()), end_(s_ + s.size()) {}
+
+  bool parse(Json* out, std::string* err) {
+    if (!value(out, 0) || (skip(), p_ != end_)) {
+      *err = "JSON syntax error at byte " + std::to_string(p_ - s_);
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  void skip() {
+    while (p_ < end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')) ++p_;
+  }
+
+  bool literal(const char* word) {
+    size_t n = strlen(word);
+    if (static_cast<size_t>(end_ - p_) < n || memcmp(p_, word, n) != 0) return false;
+    p_ += n;
+    return true;
+  }
+
+  bool string(std::string* out) {
+    if (p_ == end_ || *p_ != '"') return false;
+    ++p_;
+    while (p_ < end_ && *p_ != '"') {
+      char c = *p_++;
+      if (c == '\\') {
+        if (p_ == end_) return false;
+        c = *p_++;
+        switch (c) {
+          case 'n': c = '\n'; break;
+          case 't': c = '\t'; break;
+          case 'r': c = '\r'; break;
+          case 'b': c = '\b'; break;
+          case 'f': c = '\f'; break;
+          case 'u':
+            // Property values we care about are ASCII; keep a placeholder.
+            if (end_ - p_ < 4) return false;
+            p_ += 4;
+            c = '?';
+            break;
+          default: break;
+        }
+      }
+      out->push_back(c);
+    }
+    if (p_ == end_) return false;
+    ++p_;
+    return true;
+  }
+
+  bool value(Json* out, int depth) {
+    if (depth > 64) return false;
+    skip();
+    if (p_ == end_) return false;
+    char c = *p_;
+    if (c == '{') {
+      out->type = Json::kObject;
+      ++p_;
+      skip();
+      if (p_ < end_ && *p_ == '}') return ++p_, true;
+      for (;;) {
+        skip();
+        std::pair<std::string, Json> m;
+        if (!string(&m.first)) return false;
+        skip();
+        if (p_ == end_ || *p_++ != ':') return false;
+        if (!value(&m.second, depth + 1)) return false;
+        out->members.push_back(std::move(m));
+        skip();
+        if (p_ == end_) return false;
+        if (*p_ == '}') return ++p_, true;
+        if (*p_++ != ',') return false;
+      }
+    }
+    if (c == '[') {
+      out->type = Json::kArray;
+      ++p_;
+      skip();
+      if (p_ < end_ && *p_ == ']') return ++p_, true;
+      for (;;) {
+        out->items.emplace_back();
+        if (!value(&out->items.back(), depth + 1)) return false;
+        skip();
+        if (p_ == end_) return false;
+        if (*p_ == ']') return ++p_, true;
+        if (*p_++ != ',') return false;
+      }
+    }
+    if (c == '"') {
+      out->type = Json::kString;
+      return string(&out->str);
+    }
+    if (literal("true") || literal("false")) {
+      out->type = Json::kBool;
+      return true;
+    }
+    if (literal("null")) return true;
+    char* num_end = nullptr;
+    out->number = strtod(p_, &num_end);
+    if (num_end == p_ || num_end > end_) return false;
+    out->type = Json::kNumber;
+    p_ = num_end;
+    return true;
+  }
+
+  const char* s_;
+  const char* end_;
+  const char* p_ = s_;
+};
+
+void drop_closing_vertex(std::vector<LatLon>* ring) {
+  if (ring->size() > 1 && ring->front().lat == ring->back().lat &&
+      ring->front().lon == ring->back().lon) {
+    ring->pop_back();
+  }
+}
+
+bool parse_ring(const Json& j, std::vector<LatLon>* ring) {
+  if (j.type != Json::kArray) return false;
+  ring->reserve(j.items.size());
+  for (const Json& pos : j.items) {
+    if (pos.type != Json::kArray || pos.items.size() < 2 ||
+        pos.items[0].type != Json::kNumber || pos.items[1].type != Json::kNumber) {
+      return false;
+    }
+    ring->push_back({pos.items[1].number, pos.items[0].number});  // [lon, lat]
+  }
+  drop_closing_vertex(ring);
+  return true;
+}
+
+bool parse_polygon(const Json& rings, FenceKind kind, uint16_t id,
+                   std::vector<SourcePolygon>* out) {
+  if (rings.type != Json::kArray || rings.items.empty()) return false;
+  SourcePolygon poly;
+  poly.kind = kind;
+  poly.id = id;
+  if (!parse_ring(rings.items[0], &poly.outer)) return false;
+  for (size_t i = 1; i < rings.items.size(); ++i) {
+    poly.holes.emplace_back();
+    if (!parse_ring(rings.items[i], &poly.holes.back())) return false;
+  }
+  out->push_back(std::move(poly));
+  return true;
+}
+
+FenceKind kind_from(const std::string& s) {
+  return s == "keep_in" || s == "keep-in" || s == "keepin" ? FenceKind::kKeepIn
+                                                           : FenceKind::kKeepOut;
+}
+
+bool parse_geometry(const Json& g, FenceKind kind, uint16_t id, std::vector<SourcePolygon>* out,
+                    std::string* err) {
+  const Json* type = g.get("type");
+  const Json* coords = g.get("coordinates");
+  if (!type || type->type != Json::kString) {
+    *err = "geometry without a type";
+    return false;
+  }
+  if (type->str == "Polygon") {
+    if (coords && parse_polygon(*coords, kind, id, out)) return true;
+  } else if (type->str == "MultiPolygon") {
+    if (coords && coords->type == Json::kArray) {
+      for (const Json& p : coords->items) {
+        if (!parse_polygon(p, kind, id, out)) {
+          *err = "bad MultiPolygon coordinates in feature " + std::to_string(id);
+          return false;
+        }
+      }
+      return true;
+    }
+  } else {
+    return true;  // points and lines carry no fence
+  }
+  *err = "bad Polygon coordinates in feature " + std::to_string(id);
+  return false;
+}
+
+bool parse_feature(const Json& f, uint16_t id, std::vector<SourcePolygon>* out,
+                   std::string* err) {
+  FenceKind kind = FenceKind::kKeepOut;
+  if (const Json* props = f.get("properties")) {
+    const Json* k = props->get("kind");
+    if (k && k->type == Json::kString) kind = kind_from(k->str);
+  }
+  const Json* g = f.get("geometry");
+  if (!g || g->type != Json::kObject) return true;
+  return parse_geometry(*g, kind, id, out, err);
+}
+
+// KML helpers: plain tag scanning, namespaces prefixes are not supported.
+size_t find_tag(const std::string& s, const char* tag, size_t from, size_t limit) {
+  std::string open = std::string("<") + tag;
+  for (size_t p = s.find(open, from); p != std::string::npos && p < limit;
+       p = s.find(open, p + 1)) {
+    char c = s[p + open.size()];
+    if (c == '>' || c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '/') return p;
+  }
+  return std::string::npos;
+}
+
+// Returns the text between <tag ...> and </tag> starting at or after
+// `from`, with *next set past the closing tag.
+bool element(const std::string& s, const char* tag, size_t from, size_t limit,
+             size_t* body_begin, size_t* body_end, size_t* next) {
+  size_t open = find_tag(s, tag, from, limit);
+  if (open == std::string::npos) return false;
+  size_t gt = s.find('>', open);
+  if (gt == std::string::npos || gt >= limit) return false;
+  std::string close = std::string("</") + tag + ">";
+  size_t c = s.find(close, gt);
+  if (c == std::string::npos || c > limit) return false;
+  *body_begin = gt + 1;
+  *body_end = c;
+  *next = c + close.size();
+  return true;
+}
+
+bool parse_kml_coordinates(const std::string& s, size_t b, size_t e, std::vector<LatLon>* ring) {
+  std::string text = s.substr(b, e - b);
+  const char* p = text.c_str();
+  for (;;) {
+    while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') ++p;
+    if (!*p) break;
+    char* q;
+    double lon = strtod(p, &q);
+    if (q == p || *q != ',') return false;
+    p = q + 1;
+    double lat = strtod(p, &q);
+    if (q == p) return false;
+    p = q;
+    if (*p == ',') {  // altitude
+      strtod(p + 1, &q);
+      p = q;
+    }
+    ring->push_back({lat, lon});
+  }
+  drop_closing_vertex(ring);
+  return true;
+}
+
+bool parse_kml_ring(const std::string& s, const char* boundary, size_t from, size_t limit,
+                    std::vector<LatLon>* ring, size_t* next) {
+  size_t b, e, n, cb, ce, cn;
+  if (!element(s, boundary, from, limit, &b, &e, &n)) return false;
+  if (!element(s, "coordinates", b, e, &cb, &ce, &cn)) return false;
+  *next = n;
+  return parse_kml_coordinates(s, cb, ce, ring);
+}
+
+FenceKind kml_kind(const std::string& s, size_t b, size_t e) {
+  for (const char* tag : {"Data", "SimpleData"}) {
+    size_t p = b;
+    while ((p = find_tag(s, tag, p, e)) != std::string::npos) {
+      size_t gt = s.find('>', p);
+      std::string open = s.substr(p, gt - p);
+      size_t vb, ve, vn;
+      if (open.find("name=\"kind\"") != std::string::npos) {
+        if (strcmp(tag, "Data") == 0 && element(s, "value", gt, e, &vb, &ve, &vn)) {
+          return kind_from(s.substr(vb, ve - vb));
+        }
+        size_t close = s.find("</SimpleData>", gt);
+        if (strcmp(tag, "SimpleData") == 0 && close != std::string::npos) {
+          return kind_from(s.substr(gt + 1, close - gt - 1));
+        }
+      }
+      p = gt;
+    }
+  }
+  return FenceKind::kKeepOut;
+}
+
+}  // namespace
+
+bool parse_geojson(const std::string& text, std::vector<SourcePolygon>* out, std::string* err) {
+  Json root;
+  if (!JsonParser(text).parse(&root, err)) return false;
+  const Json* type = root.get("type");
+  if (!type || type->type != Json::kString) {
+    *err = "GeoJSON root has no type";
+    return false;
+  }
+  if (type->str == "FeatureCollection") {
+    const Json* features = root.get("features");
+    if (!features || features->type != Json::kArray) {
+      *err = "FeatureCollection without features";
+      return false;
+    }
+    for (size_t i = 0; i < features->items.size(); ++i) {
+      if (!parse_feature(features->items[i], static_cast<uint16_t>(i), out, err)) return false;
+    }
+    return true;
+  }
+  if (type->str == "Feature") return parse_feature(root, 0, out, err);
+  return parse_geometry(root, FenceKind::kKeepOut, 0, out, err);
+}
+
+bool parse_kml(const std::string& text, std::vector<SourcePolygon>* out, std::string* err) {
+  size_t pos = 0, b, e, next;
+  uint16_t id = 0;
+  while (element(text, "Placemark", pos, text.size(), &b, &e, &next)) {
+    FenceKind kind = kml_kind(text, b, e);
+    size_t pb, pe, pn, p = b;
+    while (element(text, "Polygon", p, e, &pb, &pe, &pn)) {
+      SourcePolygon poly;
+      poly.kind = kind;
+      poly.id = id;
+      size_t rn;
+      if (!parse_kml_ring(text, "outerBoundaryIs", pb, pe, &poly.outer, &rn)) {
+        *err = "Placemark " + std::to_string(id) + ": bad outerBoundaryIs";
+        return false;
+      }
+      size_t hp = pb;
+      for (;;) {
+        std::vector<LatLon> hole;
+        if (!parse_kml_ring(text, "innerBoundaryIs", hp, pe, &hole, &hp)) break;
+        poly.holes.push_back(std::move(hole));
+      }
+      out->push_back(std::move(poly));
+      p = pn;
+    }
+    ++id;
+    pos = next;
+  }
+  return true;
+}
+
+}  // namespace skyguard::ground
@@ -0,0 +1,35 @@
+// Fence boundary input for the ground fence compiler: GeoJSON and KML.
+//
+// GeoJSON: a FeatureCollection, Feature or bare geometry of type Polygon or
+// MultiPolygon. KML: every <Placemark> with <Polygon> elements. A fence is
+// keep-out unless the feature carries kind = "keep_in" (GeoJSON
+// properties, or a KML <Data>/<SimpleData> named "kind").
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "geofence/fence_format.h"
+
+namespace skyguard::ground {
+
+struct LatLon {
+  double lat;
+  double lon;
+};
+
+struct SourcePolygon {
+  geofence::FenceKind kind = geofence::FenceKind::kKeepOut;
+  uint16_t id = 0;  // feature number in the input
+  std::vector<LatLon> outer;
+  std::vector<std::vector<LatLon>> holes;
+};
+
+/// Both parsers append to `out` and return false with `*err` set on
+/// malformed input. A closing vertex equal to the first is dropped.
+bool parse_geojson(const std::string& text, std::vector<SourcePolygon>* out, std::string* err);
+bool parse_kml(const std::string& text, std::vector<SourcePolygon>* out, std::string* err);
+
+}  // namespace skyguard::ground
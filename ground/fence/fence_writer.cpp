@@ -0,0 +1,219 @@
+#include "ground/fence/fence_writer.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "geofence/fence_set.h"
+#include "ground/fence/fence_sdf.h"
+#include "util/crc32.h"
+
+namespace skyguard::ground {
+
+namespace {
+
+using geofence::FenceRecord;
+
+constexpr int kMaxOriginShifts = 16;
+
+int orient_sign(int64_t ax, int64_t ay, int64_t bx, int64_t by, int64_t cx, int64_t cy) {
+  int64_t v = (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+  return (v > 0) - (v < 0);
+}
+
+// Cell range whose closed rectangles overlap [lo, hi] on one axis.
+void cell_span(int64_t lo, int64_t hi, int64_t origin, int64_t size, uint32_t n, uint32_t* first,
+               uint32_t* last) {
+  int64_t a = (lo - origin) / size;
+  if (a > 0 && (lo - origin) % size == 0) --a;
+  int64_t b = (hi - origin) / size;
+  *first = static_cast<uint32_t>(std::clamp<int64_t>(a, 0, n - 1));
+  *last = static_cast<uint32_t>(std::clamp<int64_t>(b, 0, n - 1));
+}
+
+void put(std::vector<uint8_t>* out, size_t at, const void* src, size_t n) {
+  memcpy(out->data() + at, src, n);
+}
+
+}  // namespace
+
+bool build_fence_blob(const CompiledFence& fence, FenceBlob* blob, std::string* err,
+                      const SdfOptions* sdf) {
+  size_t n = fence.ring_e7.size() / 2;
+  if (n < 3 || n > geofence::kMaxFenceVertices) {
+    *err = "bad vertex count";
+    return false;
+  }
+  const int32_t* v = fence.ring_e7.data();  // lat, lon
+  int32_t min_lat = v[0], max_lat = v[0], min_lon = v[1], max_lon = v[1];
+  for (size_t i = 0; i < n; ++i) {
+    min_lat = std::min(min_lat, v[2 * i]);
+    max_lat = std::max(max_lat, v[2 * i]);
+    min_lon = std::min(min_lon, v[2 * i + 1]);
+    max_lon = std::max(max_lon, v[2 * i + 1]);
+  }
+
+  // The grid's south-west corner sits strictly outside the polygon so the
+  // first corner of every row is known to be outside.
+  int64_t span_lat = static_cast<int64_t>(max_lat) - min_lat + 2;
+  int64_t span_lon = static_cast<int64_t>(max_lon) - min_lon + 2;
+  double cells = std::clamp(n * kCellsPerVertex, 1.0, double(kMaxCellsPerFence));
+  double aspect = double(span_lon) / double(span_lat);
+  uint32_t gw = static_cast<uint32_t>(std::clamp(sqrt(cells * aspect), 1.0, cells));
+  uint32_t gh = static_cast<uint32_t>(std::clamp(cells / gw, 1.0, cells));
+
+  for (int shift = 0; shift < kMaxOriginShifts; ++shift) {
+    int64_t lat0 = static_cast<int64_t>(min_lat) - 1 - shift;
+    int64_t lon0 = static_cast<int64_t>(min_lon) - 1 - shift;
+    int64_t ch = (static_cast<int64_t>(max_lat) - lat0) / gh + 1;
+    int64_t cw = (static_cast<int64_t>(max_lon) - lon0) / gw + 1;
+    if (static_cast<int64_t>(max_lat) - lat0 > geofence::kMaxFenceSpanE7 ||
+        static_cast<int64_t>(max_lon) - lon0 > geofence::kMaxFenceSpanE7) {
+      *err = "fence too large";
+      return false;
+    }
+    uint32_t ny = static_cast<uint32_t>((max_lat - lat0) / ch + 1);
+    uint32_t nx = static_cast<uint32_t>((max_lon - lon0) / cw + 1);
+    size_t n_cells = static_cast<size_t>(nx) * ny;
+
+    // Assign every edge to each closed cell it touches (CSR layout).
+    std::vector<uint32_t> start(n_cells + 1, 0);
+    std::vector<uint16_t> list;
+    for (int fill = 0; fill < 2; ++fill) {
+      std::vector<uint32_t> cursor;
+      if (fill) {
+        for (size_t c = 0; c < n_cells; ++c) start[c + 1] += start[c];
+        list.resize(start[n_cells]);
+        cursor.assign(start.begin(), start.end() - 1);
+      }
+      for (size_t e = 0; e < n; ++e) {
+        size_t f = (e + 1) % n;
+        int64_t ay = v[2 * e], ax = v[2 * e + 1], by = v[2 * f], bx = v[2 * f + 1];
+        uint32_t x0, x1, y0, y1;
+        cell_span(std::min(ax, bx), std::max(ax, bx), lon0, cw, nx, &x0, &x1);
+        cell_span(std::min(ay, by), std::max(ay, by), lat0, ch, ny, &y0, &y1);
+        for (uint32_t gy = y0; gy <= y1; ++gy) {
+          for (uint32_t gx = x0; gx <= x1; ++gx) {
+            int64_t rx0 = lon0 + gx * cw, rx1 = rx0 + cw, ry0 = lat0 + gy * ch, ry1 = ry0 + ch;
+            int s = orient_sign(ax, ay, bx, by, rx0, ry0) + orient_sign(ax, ay, bx, by, rx1, ry0) +
+                    orient_sign(ax, ay, bx, by, rx0, ry1) + orient_sign(ax, ay, bx, by, rx1, ry1);
+            if (s == 4 || s == -4) continue;  // the line misses the cell
+            size_t c = static_cast<size_t>(gy) * nx + gx;
+            if (fill) {
+              list[cursor[c]++] = static_cast<uint16_t>(e);
+            } else {
+              ++start[c + 1];
+            }
+          }
+        }
+      }
+    }
+    if (list.size() > geofence::kCellIndexMask) {
+      *err = "edge list too long";
+      return false;
+    }
+
+    // Walk each row west to east, flipping the corner status on crossings.
+    std::vector<uint32_t> words(n_cells + 1);
+    bool corner_on_edge = false;
+    uint32_t max_edges = 0, boundary = 0;
+    for (uint32_t gy = 0; gy < ny && !corner_on_edge; ++gy) {
+      bool inside = false;
+      int32_t y = static_cast<int32_t>(lat0 + gy * ch);
+      for (uint32_t gx = 0; gx < nx; ++gx) {
+        size_t c = static_cast<size_t>(gy) * nx + gx;
+        int32_t x = static_cast<int32_t>(lon0 + gx * cw);
+        int32_t x_next = static_cast<int32_t>(x + cw);
+        uint32_t count = start[c + 1] - start[c];
+        words[c] = start[c] | (inside ? geofence::kCellRefInside : 0) |
+                   (count ? geofence::kCellBoundary : 0);
+        max_edges = std::max(max_edges, count);
+        boundary += count != 0;
+        for (uint32_t k = start[c]; k < start[c + 1]; ++k) {
+          size_t a = list[k], b = (a + 1) % n;
+          int64_t ay = v[2 * a], ax = v[2 * a + 1], by = v[2 * b], bx = v[2 * b + 1];
+          if (orient_sign(ax, ay, bx, by, x, y) == 0 && std::min(ax, bx) <= x &&
+              x <= std::max(ax, bx) && std::min(ay, by) <= y && y <= std::max(ay, by)) {
+            corner_on_edge = true;
+          }
+          if (gx + 1 < nx && geofence::segments_cross(y, x, y, x_next, static_cast<int32_t>(ay),
+                                                      static_cast<int32_t>(ax),
+                                                      static_cast<int32_t>(by),
+                                                      static_cast<int32_t>(bx))) {
+            inside = !inside;
+          }
+        }
+      }
+    }
+    if (corner_on_edge) continue;  // shift the grid and try again
+    words[n_cells] = start[n_cells];
+
+    FenceRecord& r = blob->record;
+    r = FenceRecord{};
+    r.kind = static_cast<uint8_t>(fence.kind);
+    r.id = fence.id;
+    r.vertex_count = static_cast<uint32_t>(n);
+    r.min_lat_e7 = static_cast<int32_t>(lat0);
+    r.min_lon_e7 = static_cast<int32_t>(lon0);
+    r.max_lat_e7 = max_lat;
+    r.max_lon_e7 = max_lon;
+    r.grid_w = static_cast<uint16_t>(nx);
+    r.grid_h = static_cast<uint16_t>(ny);
+    r.cell_h_e7 = static_cast<uint32_t>(ch);
+    r.cell_w_e7 = static_cast<uint32_t>(cw);
+    r.max_cell_edges = max_edges;
+
+    size_t vbytes = 8 * n, cbytes = 4 * words.size(), ebytes = (2 * list.size() + 3) & ~size_t{3};
+    r.vertex_offset = 0;
+    r.cell_offset = static_cast<uint32_t>(vbytes);
+    r.edge_list_offset = static_cast<uint32_t>(vbytes + cbytes);
+    blob->bytes.assign(vbytes + cbytes + ebytes, 0);
+    put(&blob->bytes, 0, fence.ring_e7.data(), vbytes);
+    put(&blob->bytes, vbytes, words.data(), cbytes);
+    put(&blob->bytes, vbytes + cbytes, list.data(), 2 * list.size());
+    blob->boundary_cells = boundary;
+    blob->mean_cell_edges = double(list.size()) / double(n_cells);
+    if (sdf) {
+      SdfStats st;
+      size_t at = blob->bytes.size();
+      if (!build_fence_sdf(fence, *sdf, &blob->bytes, &st, err)) return false;
+      r.sdf_offset = static_cast<uint32_t>(at);
+      blob->sdf_bytes = static_cast<uint32_t>(blob->bytes.size() - at);
+      blob->sdf_max_error_m = st.max_error_m;
+    }
+    return true;
+  }
+  *err = "grid corners keep landing on edges";
+  return false;
+}
+
+std::vector<uint8_t> assemble_fence_image(const std::vector<FenceBlob>& blobs) {
+  size_t base = sizeof(geofence::FenceImageHeader) + blobs.size() * sizeof(FenceRecord);
+  size_t total = base;
+  for (const FenceBlob& b : blobs) total += b.bytes.size();
+  std::vector<uint8_t> image(total, 0);
+
+  size_t at = base;
+  for (size_t i = 0; i < blobs.size(); ++i) {
+    FenceRecord r = blobs[i].record;
+    r.vertex_offset += static_cast<uint32_t>(at);
+    r.cell_offset += static_cast<uint32_t>(at);
+    r.edge_list_offset += static_cast<uint32_t>(at);
+    if (r.sdf_offset) r.sdf_offset += static_cast<uint32_t>(at);
+    put(&image, sizeof(geofence::FenceImageHeader) + i * sizeof(FenceRecord), &r, sizeof(r));
+    put(&image, at, blobs[i].bytes.data(), blobs[i].bytes.size());
+    at += blobs[i].bytes.size();
+  }
+
+  geofence::FenceImageHeader h{};
+  h.magic = geofence::kFenceMagic;
+  h.version = geofence::kFenceFormatVersion;
+  h.fence_count = static_cast<uint16_t>(blobs.size());
+  h.image_size = static_cast<uint32_t>(total);
+  h.crc32 = crc32(image.data() + sizeof(h), total - sizeof(h));
+  put(&image, 0, &h, sizeof(h));
+  return image;
+}
+
+}  // namespace skyguard::ground
@@ -0,0 +1,44 @@
+// Builds the on-board fence image (firmware/geofence/fence_format.h) from
+// compiled rings: per-fence cell grids, edge lists and the header CRC.
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "geofence/fence_format.h"
+
+namespace skyguard::ground {
+
+struct CompiledFence {
+  geofence::FenceKind kind = geofence::FenceKind::kKeepOut;
+  uint16_t id = 0;
+  std::vector<int32_t> ring_e7;  // lat_e7, lon_e7 pairs
+};
+
+/// One fence's record and sections; offsets are relative to `bytes` until
+/// assemble_fence_image() places it.
+struct FenceBlob {
+  geofence::FenceRecord record{};
+  std::vector<uint8_t> bytes;
+  uint32_t boundary_cells = 0;
+  double mean_cell_edges = 0;  // edges tested per fix, averaged over the grid
+  uint32_t sdf_bytes = 0;
+  double sdf_max_error_m = 0;
+};
+
+struct SdfOptions;
+
+/// Grid density: cells per fence vertex, capped per fence.
+constexpr double kCellsPerVertex = 1.0;
+constexpr uint32_t kMaxCellsPerFence = 16384;
+
+/// Independent per fence, so callers may build blobs in parallel. A
+/// distance raster is added when `sdf` is given.
+bool build_fence_blob(const CompiledFence& fence, FenceBlob* blob, std::string* err,
+                      const SdfOptions* sdf = nullptr);
+
+std::vector<uint8_t> assemble_fence_image(const std::vector<FenceBlob>& blobs);
+
+}  // namespace skyguard::ground
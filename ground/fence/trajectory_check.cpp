@@ -0,0 +1,318 @@
+#include "ground/fence/trajectory_check.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SKYGUARD_HAVE_AVX2_KERNEL 1
+#endif
+
+namespace skyguard::ground {
+
+namespace {
+
+using geofence::FenceKind;
+using geofence::FenceSdfHeader;
+using geofence::kMetresPerLatE7;
+
+constexpr size_t kChunk = 256;
+// Points further than this from a fence are pulled in to keep int32
+// differences exact; that only shortens distances that are bounds anyway.
+constexpr int64_t kClampE7 = int64_t{1} << 29;
+
+int32_t clamp_low(int32_t origin) {
+  return static_cast<int32_t>(std::max<int64_t>(INT32_MIN, int64_t(origin) - kClampE7));
+}
+int32_t clamp_high(int32_t origin) {
+  return static_cast<int32_t>(std::min<int64_t>(INT32_MAX, int64_t(origin) + kClampE7));
+}
+
+}  // namespace
+
+SimdLevel best_simd_level() {
+#ifdef SKYGUARD_HAVE_AVX2_KERNEL
+  if (__builtin_cpu_supports("avx2")) return SimdLevel::kAvx2;
+#endif
+  return SimdLevel::kScalar;
+}
+
+TrajectoryChecker::TrajectoryChecker(const geofence::FenceSet& fences) : set_(fences) {
+  fences_.resize(fences.count());
+  for (size_t i = 0; i < fences.count(); ++i) {
+    const geofence::FenceRecord& r = fences.record(i);
+    Prepared& p = fences_[i];
+    p.keep_in = r.kind == static_cast<uint8_t>(FenceKind::kKeepIn);
+    p.lon_m = fences.lon_metres_per_e7(i);
+    const FenceSdfHeader* h = fences.raster(i);
+    p.raster = h != nullptr;
+    if (h) {
+      p.origin_lat_e7 = h->origin_lat_e7;
+      p.origin_lon_e7 = h->origin_lon_e7;
+      p.min_lat_e7 = h->origin_lat_e7;
+      p.min_lon_e7 = h->origin_lon_e7;
+      p.max_lat_e7 = static_cast<int32_t>(h->origin_lat_e7 + int64_t(h->rows - 1) * h->step_lat_e7);
+      p.max_lon_e7 = static_cast<int32_t>(h->origin_lon_e7 + int64_t(h->cols - 1) * h->step_lon_e7);
+      p.reach_m = h->margin_m;
+    } else {
+      p.origin_lat_e7 = r.min_lat_e7;
+      p.origin_lon_e7 = r.min_lon_e7;
+      p.min_lat_e7 = r.min_lat_e7;
+      p.min_lon_e7 = r.min_lon_e7;
+      p.max_lat_e7 = r.max_lat_e7;
+      p.max_lon_e7 = r.max_lon_e7;
+      p.reach_m = 0;
+    }
+  }
+}
+
+float TrajectoryChecker::bound_outside(const Prepared& p, int64_t min_lat, int64_t min_lon,
+                                       int64_t max_lat, int64_t max_lon) const {
+  int64_t gx = std::max<int64_t>({0, p.min_lon_e7 - max_lon, min_lon - p.max_lon_e7});
+  int64_t gy = std::max<int64_t>({0, p.min_lat_e7 - max_lat, min_lat - p.max_lat_e7});
+  float x = static_cast<float>(gx) * p.lon_m, y = static_cast<float>(gy) * kMetresPerLatE7;
+  return sqrtf(x * x + y * y) + p.reach_m;
+}
+
+void TrajectoryChecker::fence_scalar(size_t f, const int32_t* lat, const int32_t* lon, size_t n,
+                                     float* d) const {
+  for (size_t i = 0; i < n; ++i) d[i] = set_.distance(f, lat[i], lon[i]).metres;
+}
+
+#ifdef SKYGUARD_HAVE_AVX2_KERNEL
+
+namespace {
+
+// (c - q) * scale per lane: a vertex coordinate relative to eight points.
+__attribute__((target("avx2"))) inline __m256 rel(int32_t c, __m256i q, __m256 scale) {
+  return _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_set1_epi32(c), q)), scale);
+}
+
+}  // namespace
+
+// Mirrors FenceSet::distance() operation for operation (no fused
+// multiply-adds), so both levels give bit-identical margins.
+__attribute__((target("avx2"))) void TrajectoryChecker::fence_avx2(size_t f, const int32_t* lat,
+                                                                   const int32_t* lon, size_t n,
+                                                                   float* d) const {
+  const Prepared& p = fences_[f];
+  const __m256i olat = _mm256_set1_epi32(p.origin_lat_e7);
+  const __m256i olon = _mm256_set1_epi32(p.origin_lon_e7);
+  const __m256i lat_lo = _mm256_set1_epi32(clamp_low(p.origin_lat_e7));
+  const __m256i lat_hi = _mm256_set1_epi32(clamp_high(p.origin_lat_e7));
+  const __m256i lon_lo = _mm256_set1_epi32(clamp_low(p.origin_lon_e7));
+  const __m256i lon_hi = _mm256_set1_epi32(clamp_high(p.origin_lon_e7));
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 sign = _mm256_set1_ps(-0.0f);
+  size_t i = 0;
+
+  if (p.raster) {
+    const FenceSdfHeader* h = set_.raster(f);
+    const auto* base = reinterpret_cast<const int*>(h + 1);
+    const __m256 step_lat = _mm256_set1_ps(static_cast<float>(h->step_lat_e7));
+    const __m256 step_lon = _mm256_set1_ps(static_cast<float>(h->step_lon_e7));
+    const __m256 max_x = _mm256_set1_ps(static_cast<float>(h->cols - 1));
+    const __m256 max_y = _mm256_set1_ps(static_cast<float>(h->rows - 1));
+    const __m256 scale_x =
+        _mm256_set1_ps(static_cast<float>(h->step_lon_e7) * h->lon_metres_per_e7);
+    const __m256 scale_y = _mm256_set1_ps(static_cast<float>(h->step_lat_e7) * kMetresPerLatE7);
+    const __m256 margin = _mm256_set1_ps(h->margin_m);
+    const __m256 unit = _mm256_set1_ps(h->metres_per_unit);
+    const __m256i last_x = _mm256_set1_epi32(h->cols - 2);
+    const __m256i last_y = _mm256_set1_epi32(h->rows - 2);
+    const __m256i cols = _mm256_set1_epi32(h->cols);
+    for (; i + 8 <= n; i += 8) {
+      __m256i la = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lat + i));
+      __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lon + i));
+      la = _mm256_min_epi32(_mm256_max_epi32(la, lat_lo), lat_hi);
+      lo = _mm256_min_epi32(_mm256_max_epi32(lo, lon_lo), lon_hi);
+      __m256 fx = _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_sub_epi32(lo, olon)), step_lon);
+      __m256 fy = _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_sub_epi32(la, olat)), step_lat);
+
+      // Beyond the raster: distance to it plus its margin.
+      __m256 ex = _mm256_max_ps(_mm256_max_ps(_mm256_xor_ps(fx, sign), _mm256_sub_ps(fx, max_x)),
+                                zero);
+      __m256 ey = _mm256_max_ps(_mm256_max_ps(_mm256_xor_ps(fy, sign), _mm256_sub_ps(fy, max_y)),
+                                zero);
+      ex = _mm256_mul_ps(ex, scale_x);
+      ey = _mm256_mul_ps(ey, scale_y);
+      __m256 outside = _mm256_add_ps(
+          _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(ex, ex), _mm256_mul_ps(ey, ey))), margin);
+      __m256 beyond = _mm256_or_ps(_mm256_cmp_ps(ex, zero, _CMP_GT_OQ),
+                                   _mm256_cmp_ps(ey, zero, _CMP_GT_OQ));
+
+      // Inside: bilinear interpolation of the four surrounding samples.
+      __m256 cx = _mm256_min_ps(_mm256_max_ps(fx, zero), max_x);
+      __m256 cy = _mm256_min_ps(_mm256_max_ps(fy, zero), max_y);
+      __m256i x0 = _mm256_min_epi32(_mm256_cvttps_epi32(cx), last_x);
+      __m256i y0 = _mm256_min_epi32(_mm256_cvttps_epi32(cy), last_y);
+      __m256 tx = _mm256_sub_ps(cx, _mm256_cvtepi32_ps(x0));
+      __m256 ty = _mm256_sub_ps(cy, _mm256_cvtepi32_ps(y0));
+      __m256i idx = _mm256_add_epi32(_mm256_mullo_epi32(y0, cols), x0);
+      // One 32-bit gather fetches a sample and its east neighbour.
+      __m256i south_pair = _mm256_i32gather_epi32(base, idx, 2);
+      __m256i north_pair = _mm256_i32gather_epi32(base, _mm256_add_epi32(idx, cols), 2);
+      __m256i v00 = _mm256_srai_epi32(_mm256_slli_epi32(south_pair, 16), 16);
+      __m256i v01 = _mm256_srai_epi32(south_pair, 16);
+      __m256i v10 = _mm256_srai_epi32(_mm256_slli_epi32(north_pair, 16), 16);
+      __m256i v11 = _mm256_srai_epi32(north_pair, 16);
+      __m256 south = _mm256_add_ps(_mm256_cvtepi32_ps(v00),
+                                   _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_sub_epi32(v01, v00)),
+                                                 tx));
+      __m256 north = _mm256_add_ps(_mm256_cvtepi32_ps(v10),
+                                   _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_sub_epi32(v11, v10)),
+                                                 tx));
+      __m256 interp = _mm256_mul_ps(
+          _mm256_add_ps(south, _mm256_mul_ps(_mm256_sub_ps(north, south), ty)), unit);
+
+      __m256 out = _mm256_blendv_ps(interp, outside, beyond);
+      _mm256_storeu_ps(d + i, out);
+      // Near the boundary the firmware measures edges; so do we.
+      __m256 near = _mm256_andnot_ps(
+          beyond, _mm256_cmp_ps(_mm256_andnot_ps(sign, interp),
+                                _mm256_set1_ps(h->max_error_m), _CMP_LT_OQ));
+      for (int mask = _mm256_movemask_ps(near); mask; mask &= mask - 1) {
+        size_t k = i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+        d[k] = set_.distance(f, lat[k], lon[k]).metres;
+      }
+    }
+  } else {
+    // Every edge, broadcast against eight points at a time.
+    const int32_t* v = set_.vertices(f);
+    uint32_t nv = set_.record(f).vertex_count;
+    const __m256 sx = _mm256_set1_ps(p.lon_m), sy = _mm256_set1_ps(kMetresPerLatE7);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    for (; i + 8 <= n; i += 8) {
+      __m256i la = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lat + i));
+      __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lon + i));
+      la = _mm256_min_epi32(_mm256_max_epi32(la, lat_lo), lat_hi);
+      lo = _mm256_min_epi32(_mm256_max_epi32(lo, lon_lo), lon_hi);
+      __m256 best = _mm256_set1_ps(INFINITY);
+      for (uint32_t a = 0; a < nv; ++a) {
+        uint32_t b = a + 1 == nv ? 0 : a + 1;
+        __m256 ax = rel(v[2 * a + 1], lo, sx), ay = rel(v[2 * a], la, sy);
+        __m256 bx = rel(v[2 * b + 1], lo, sx), by = rel(v[2 * b], la, sy);
+        __m256 dx = _mm256_sub_ps(bx, ax), dy = _mm256_sub_ps(by, ay);
+        __m256 len2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        __m256 t = _mm256_div_ps(
+            _mm256_xor_ps(_mm256_add_ps(_mm256_mul_ps(ax, dx), _mm256_mul_ps(ay, dy)), sign), len2);
+        t = _mm256_and_ps(t, _mm256_cmp_ps(len2, zero, _CMP_GT_OQ));
+        t = _mm256_min_ps(_mm256_max_ps(t, zero), one);
+        __m256 x = _mm256_add_ps(ax, _mm256_mul_ps(t, dx));
+        __m256 y = _mm256_add_ps(ay, _mm256_mul_ps(t, dy));
+        best = _mm256_min_ps(best, _mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)));
+      }
+      _mm256_storeu_ps(d + i, _mm256_sqrt_ps(best));
+      for (size_t k = i; k < i + 8; ++k) {
+        if (lat[k] >= p.min_lat_e7 && lat[k] <= p.max_lat_e7 && lon[k] >= p.min_lon_e7 &&
+            lon[k] <= p.max_lon_e7 && set_.contains(f, lat[k], lon[k])) {
+          d[k] = -d[k];
+        }
+      }
+    }
+  }
+  fence_scalar(f, lat + i, lon + i, n - i, d + i);
+}
+
+#else
+
+void TrajectoryChecker::fence_avx2(size_t f, const int32_t* lat, const int32_t* lon, size_t n,
+                                   float* d) const {
+  fence_scalar(f, lat, lon, n, d);
+}
+
+#endif
+
+void TrajectoryChecker::margins(const int32_t* lat_e7, const int32_t* lon_e7, size_t n,
+                                const uint32_t* fences, size_t n_fences, float* out,
+                                SimdLevel level) const {
+  bool any_keep_in = false;
+  for (const Prepared& p : fences_) any_keep_in |= p.keep_in;
+  float d[kChunk], keep_in[kChunk];
+  for (size_t base = 0; base < n; base += kChunk) {
+    size_t m = std::min(kChunk, n - base);
+    std::fill(out + base, out + base + m, INFINITY);
+    std::fill(keep_in, keep_in + m, -INFINITY);
+    for (size_t j = 0; j < n_fences; ++j) {
+      uint32_t f = fences[j];
+      if (level == SimdLevel::kAvx2) {
+        fence_avx2(f, lat_e7 + base, lon_e7 + base, m, d);
+      } else {
+        fence_scalar(f, lat_e7 + base, lon_e7 + base, m, d);
+      }
+      if (fences_[f].keep_in) {
+        for (size_t k = 0; k < m; ++k) keep_in[k] = std::max(keep_in[k], -d[k]);
+      } else {
+        for (size_t k = 0; k < m; ++k) out[base + k] = std::min(out[base + k], d[k]);
+      }
+    }
+    if (any_keep_in) {
+      for (size_t k = 0; k < m; ++k) {
+        if (keep_in[k] < out[base + k]) out[base + k] = keep_in[k];
+      }
+    }
+  }
+}
+
+TrajectoryResult TrajectoryChecker::check(const TrajectoryView& t, SimdLevel level) const {
+  TrajectoryResult res;
+  std::vector<uint32_t> near;
+  float m[kChunk];
+  for (size_t base = 0; base < t.n; base += kChunk) {
+    size_t n = std::min(kChunk, t.n - base);
+    const int32_t* lat = t.lat_e7 + base;
+    const int32_t* lon = t.lon_e7 + base;
+    int64_t min_lat = lat[0], max_lat = lat[0], min_lon = lon[0], max_lon = lon[0];
+    for (size_t k = 1; k < n; ++k) {
+      min_lat = std::min<int64_t>(min_lat, lat[k]);
+      max_lat = std::max<int64_t>(max_lat, lat[k]);
+      min_lon = std::min<int64_t>(min_lon, lon[k]);
+      max_lon = std::max<int64_t>(max_lon, lon[k]);
+    }
+
+    // Evaluate keep-ins and the keep-outs that can reach this stretch.
+    near.clear();
+    float far = INFINITY;
+    for (size_t f = 0; f < fences_.size(); ++f) {
+      const Prepared& p = fences_[f];
+      bool reach = p.min_lat_e7 <= max_lat && p.max_lat_e7 >= min_lat &&
+                   p.min_lon_e7 <= max_lon && p.max_lon_e7 >= min_lon;
+      if (reach || p.keep_in) {
+        near.push_back(static_cast<uint32_t>(f));
+      } else {
+        far = std::min(far, bound_outside(p, min_lat, min_lon, max_lat, max_lon));
+      }
+    }
+
+    margins(lat, lon, n, near.data(), near.size(), m, level);
+    for (size_t k = 0; k < n; ++k) {
+      float margin = std::min(m[k], far);
+      if (margin < res.min_margin_m) {
+        res.min_margin_m = margin;
+        res.min_margin_index = base + k;
+      }
+      if (margin <= 0 && res.first_breach < 0) {
+        res.first_breach = static_cast<int64_t>(base + k);
+        res.first_breach_t_s = t.t_s[base + k];
+      }
+    }
+  }
+  return res;
+}
+
+void TrajectoryChecker::check_all(const std::vector<TrajectoryView>& ts,
+                                  std::vector<TrajectoryResult>* out, size_t threads,
+                                  SimdLevel level) const {
+  out->assign(ts.size(), TrajectoryResult{});
+  std::atomic<size_t> next{0};
+  auto worker = [&] {
+    for (size_t i; (i = next.fetch_add(1)) < ts.size();) (*out)[i] = check(ts[i], level);
+  };
+  std::vector<std::thread> pool;
+  for (size_t t = 1; t < std::max<size_t>(threads, 1); ++t) pool.emplace_back(worker);
+  worker();
+  for (auto& t : pool) t.join();
+}
+
+}  // namespace skyguard::ground
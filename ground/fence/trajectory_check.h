@@ -0,0 +1,80 @@
+// Batch fence checking of predicted trajectories for pre-flight planning.
+//
+// Works on a bound firmware FenceSet and gives the same answers as
+// FenceSet::margin_m() point by point: margins come from the distance
+// rasters where present (falling back to the firmware's exact path near
+// the boundary) and from every edge otherwise. Points are evaluated eight
+// at a time with AVX2 where the CPU has it, with a scalar fallback, and
+// check_all() spreads trajectories over threads.
+//
+// Trajectories are taken in stretches of 256 points. Keep-outs whose raster
+// (or, without one, bounding box) cannot reach a stretch's bounding box
+// contribute a box-to-box lower bound instead of being evaluated, in the
+// spirit of the firmware's lower bound beyond a raster.
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "geofence/fence_set.h"
+
+namespace skyguard::ground {
+
+struct TrajectoryView {
+  const float* t_s;  // time of each point
+  const int32_t* lat_e7;
+  const int32_t* lon_e7;
+  size_t n;
+};
+
+struct TrajectoryResult {
+  int64_t first_breach = -1;  // index of the first point with margin <= 0
+  float first_breach_t_s = NAN;
+  float min_margin_m = INFINITY;
+  size_t min_margin_index = 0;
+};
+
+enum class SimdLevel : uint8_t { kScalar, kAvx2 };
+
+/// The widest level this CPU supports.
+SimdLevel best_simd_level();
+
+class TrajectoryChecker {
+ public:
+  /// `fences` must stay bound and unchanged while the checker is used.
+  explicit TrajectoryChecker(const geofence::FenceSet& fences);
+
+  TrajectoryResult check(const TrajectoryView& t, SimdLevel level) const;
+
+  void check_all(const std::vector<TrajectoryView>& ts, std::vector<TrajectoryResult>* out,
+                 size_t threads, SimdLevel level) const;
+
+  /// Margins of a batch of points against the given fences (indices into
+  /// the fence set); `out` receives one margin per point.
+  void margins(const int32_t* lat_e7, const int32_t* lon_e7, size_t n, const uint32_t* fences,
+               size_t n_fences, float* out, SimdLevel level) const;
+
+ private:
+  struct Prepared {
+    bool keep_in;
+    bool raster;
+    // Reach of the fence: raster extent, or bounding box without one.
+    int32_t min_lat_e7, min_lon_e7, max_lat_e7, max_lon_e7;
+    float lon_m;     // metres per 1e-7 degree of longitude
+    float reach_m;   // distance already covered at the reach box edge
+    int32_t origin_lat_e7, origin_lon_e7;  // raster sample (0, 0)
+  };
+
+  void fence_scalar(size_t f, const int32_t* lat, const int32_t* lon, size_t n, float* d) const;
+  void fence_avx2(size_t f, const int32_t* lat, const int32_t* lon, size_t n, float* d) const;
+  float bound_outside(const Prepared& p, int64_t min_lat, int64_t min_lon, int64_t max_lat,
+                      int64_t max_lon) const;
+
+  const geofence::FenceSet& set_;
+  std::vector<Prepared> fences_;
+};
+
+}  // namespace skyguard::ground
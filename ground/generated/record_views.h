@@ -0,0 +1,646 @@
+// Generated by tools/schemagen.py from schema/records.schema. Do not edit.
+//
+// Zero-copy views over encoded records. A view borrows the buffer; each
+// accessor decodes straight from it, and has_<field>() reports whether
+// the writer's schema version included that field.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace skyguard::records {
+
+class StateSnapshotView {
+ public:
+  static constexpr uint8_t kId = 1;
+  static constexpr size_t kMinSize = 31;
+
+  /// Returns false if `len` is shorter than the first version.
+  bool bind(const uint8_t* p, size_t len) {
+    p_ = p;
+    len_ = len;
+    return len >= kMinSize;
+  }
+
+  bool has_time_ms() const { return len_ >= 4; }
+  uint32_t time_ms() const {
+    if (!has_time_ms()) return uint32_t{};
+    uint32_t v = static_cast<uint32_t>(p_[0]) |
+                 static_cast<uint32_t>(p_[1]) << 8 |
+                 static_cast<uint32_t>(p_[2]) << 16 |
+                 static_cast<uint32_t>(p_[3]) << 24;
+    return static_cast<uint32_t>(v);
+  }
+  bool has_lat_e7() const { return len_ >= 8; }
+  int32_t lat_e7() const {
+    if (!has_lat_e7()) return int32_t{};
+    uint32_t v = static_cast<uint32_t>(p_[4]) |
+                 static_cast<uint32_t>(p_[5]) << 8 |
+                 static_cast<uint32_t>(p_[6]) << 16 |
+                 static_cast<uint32_t>(p_[7]) << 24;
+    return static_cast<int32_t>(v);
+  }
+  bool has_lon_e7() const { return len_ >= 12; }
+  int32_t lon_e7() const {
+    if (!has_lon_e7()) return int32_t{};
+    uint32_t v = static_cast<uint32_t>(p_[8]) |
+                 static_cast<uint32_t>(p_[9]) << 8 |
+                 static_cast<uint32_t>(p_[10]) << 16 |
+                 static_cast<uint32_t>(p_[11]) << 24;
+    return static_cast<int32_t>(v);
+  }
+  bool has_alt_mm() const { return len_ >= 16; }
+  int32_t alt_mm() const {
+    if (!has_alt_mm()) return int32_t{};
+    uint32_t v = static_cast<uint32_t>(p_[12]) |
+                 static_cast<uint32_t>(p_[13]) << 8 |
+                 static_cast<uint32_t>(p_[14]) << 16 |
+                 static_cast<uint32_t>(p_[15]) << 24;
+    return static_cast<int32_t>(v);
+  }
+  bool has_vel_cm_s() const { return len_ >= 22; }
+  int16_t vel_cm_s(size_t i) const {
+    if (!has_vel_cm_s() || i >= 3) return int16_t{};
+    uint16_t v = static_cast<uint16_t>(p_[16 + 2 * i]) |
+                 static_cast<uint16_t>(p_[17 + 2 * i]) << 8;
+    return static_cast<int16_t>(v);
+  }
+  bool has_flags() const { return len_ >= 24; }
+  uint16_t flags() const {
+    if (!has_flags()) return uint16_t{};
+    uint16_t v = static_cast<uint16_t>(p_[22]) |
+                 static_cast<uint16_t>(p_[23]) << 8;
+    return static_cast<uint16_t>(v);
+  }
+  bool has_baro_pa_div4() const { return len_ >= 26; }
+  int16_t baro_pa_div4() const {
+    if (!has_baro_pa_div4()) return int16_t{};
+    uint16_t v = static_cast<uint16_t>(p_[24]) |
+                 static_cast<uint16_t>(p_[25]) << 8;
+    return static_cast<int16_t>(v);
+  }
+  bool has_temp_c10() const { return len_ >= 28; }
+  int16_t temp_c10() const {
+    if (!has_temp_c10()) return int16_t{};
+    uint16_t v = static_cast<uint16_t>(p_[26]) |
+                 static_cast<uint16_t>(p_[27]) << 8;
+    return static_cast<int16_t>(v);
+  }
+  bool has_state() const { return len_ >= 29; }
+  uint8_t state() const {
+    if (!has_state()) return uint8_t{};
+    uint8_t v = static_cast<uint8_t>(p_[28]);
+    return static_cast<uint8_t>(v);
+  }
+  bool has_fix() const { return len_ >= 30; }
+  uint8_t fix() const {
+    if (!has_fix()) return uint8_t{};
+    uint8_t v = static_cast<uint8_t>(p_[29]);
+    return static_cast<uint8_t>(v);
+  }
+  bool has_sats() const { return len_ >= 31; }
+  uint8_t sats() const {
+    if (!has_sats()) return uint8_t{};
+    uint8_t v = static_cast<uint8_t>(p_[30]);
+    return static_cast<uint8_t>(v);
+  }
+  bool has_battery_mv() const { return len_ >= 33; }
+  uint16_t battery_mv() const {
+    if (!has_battery_mv()) return uint16_t{};
+    uint16_t v = static_cast<uint16_t>(p_[31]) |
+                 static_cast<uint16_t>(p_[32]) << 8;
+    return static_cast<uint16_t>(v);
+  }
+
+ private:
+  const uint8_t* p_ = nullptr;
+  size_t len_ = 0;
+};
+
+class HealthCountersView {
+ public:
+  static constexpr uint8_t kId = 2;
+  static constexpr size_t kMinSize = 32;
+
+  /// Returns false if `len` is shorter than the first version.
+  bool bind(const uint8_t* p, size_t len) {
+    p_ = p;
+    len_ = len;
+    return len >= kMinSize;
+  }
+
+  bool has_uptime_s() const { return len_ >= 4; }
+  uint32_t uptime_s() const {
+    if (!has_uptime_s()) return uint32_t{};
+    uint32_t v = static_cast<uint32_t>(p_[0]) |
+                 static_cast<uint32_t>(p_[1]) << 8 |
+                 static_cast<uint32_t>(p_[2]) << 16 |
+                 static_cast<uint32_t>(p_[3]) << 24;
+    return static_cast<uint32_t>(v);
+  }
+  bool has_resets() const { return len_ >= 8; }
+  uint32_t resets() const {
+    if (!has_resets()) return uint32_t{};
+    uint32_t v = static_cast<uint32_t>(p_[4]) |
+                 static_cast<uint32_t>(p_[5]) << 8 |
+                 static_cast<uint32_t>(p_[6]) << 16 |
+                 static_cast<uint32_t>(p_[7]) << 24;
+    return static_cast<uint32_t>(v);
+  }
+  bool has_gps_fixes() const { return len_ >= 12; }
+  uint32_t gps_fixes() const {
+    if (!has_gps_fixes()) return uint32_t{};
+    uint32_t v = static_cast<uint32_t>(p_[8]) |
+                 static_cast<uint32_t>(p_[9]) << 8 |
+                 static_cast<uint32_t>(p_[10]) << 16 |
+                 static_cast<uint32_t>(p_[11]) << 24;
+    return static_cast<uint32_t>(v);
+  }
+  bool has_gps_timeouts() const { return len_ >= 16; }
+  uint32_t gps_timeouts() const {
+    if (!has_gps_timeouts()) return uint32_t{};
+    uint32_t v = static_cast<uint32_t>(p_[12]) |
+                 static_cast<uint32_t>(p_[13]) << 8 |
+                 static_cast<uint32_t>(p_[14]) << 16 |
+                 static_cast<uint32_t>(p_[15]) << 24;
+    return static_cast<uint32_t>(v);
+  }
+  bool has_radio_tx() const { return len_ >= 20; }
+  uint32_t radio_tx() const {
+    if (!has_radio_tx()) return uint32_t{};
+    uint32_t v = static_cast<uint32_t>(p_[16]) |
+                 static_cast<uint32_t>(p_[17]) << 8 |
+                 static_cast<uint32_t>(p_[18]) << 16 |
+                 static_cast<uint32_t>(p_[19]) << 24;
+    return static_cast<uint32_t>(v);
+  }
+  bool has_radio_tx_failed() const { return len_ >= 24; }
+  uint32_t radio_tx_failed() const {
+    if (!has_radio_tx_failed()) return uint32_t{};
+    uint32_t v = static_cast<uint32_t>(p_[20]) |
+                 static_cast<uint32_t>(p_[21]) << 8 |
+                 static_cast<uint32_t>(p_[22]) << 16 |
+                 static_cast<uint32_t>(p_[23]) << 24;
+    return static_cast<uint32_t>(v);
+  }
+  bool has_log_writes() const { return len_ >= 28; }
+  uint32_t log_writes() const {
+    if (!has_log_writes()) return uint32_t{};
+    uint32_t v = static_cast<uint32_t>(p_[24]) |
+                 static_cast<uint32_t>(p_[25]) << 8 |
+                 static_cast<uint32_t>(p_[26]) << 16 |
+                 static_cast<uint32_t>(p_[27]) << 24;
+    return static_cast<uint32_t>(v);
+  }
+  bool has_log_errors() const { return len_ >= 32; }
+  uint32_t log_errors() const {
+    if (!has_log_errors()) return uint32_t{};
+    uint32_t v = static_cast<uint32_t>(p_[28]) |
+                 static_cast<uint32_t>(p_[29]) << 8 |
+                 static_cast<uint32_t>(p_[30]) << 16 |
+                 static_cast<uint32_t>(p_[31]) << 24;
+    return static_cast<uint32_t>(v);
+  }
+
+ private:
+  const uint8_t* p_ = nullptr;
+  size_t len_ = 0;
+};
+
+class EventView {
+ public:
+  static constexpr uint8_t kId = 3;
+  static constexpr size_t kMinSize = 16;
+
+  /// Returns false if `len` is shorter than the first version.
+  bool bind(const uint8_t* p, size_t len) {
+    p_ = p;
+    len_ = len;
+    return len >= kMinSize;
+  }
+
+  bool has_time_ms() const { return len_ >= 4; }
+  uint32_t time_ms() const {
+    if (!has_time_ms()) return uint32_t{};
+    uint32_t v = static_cast<uint32_t>(p_[0]) |
+                 static_cast<uint32_t>(p_[1]) << 8 |
+                 static_cast<uint32_t>(p_[2]) << 16 |
+                 static_cast<uint32_t>(p_[3]) << 24;
+    return static_cast<uint32_t>(v);
+  }
+  bool has_code() const { return len_ >= 6; }
+  uint16_t code() const {
+    if (!has_code()) return uint16_t{};
+    uint16_t v = static_cast<uint16_t>(p_[4]) |
+                 static_cast<uint16_t>(p_[5]) << 8;
+    return static_cast<uint16_t>(v);
+  }
+  bool has_arg16() const { return len_ >= 8; }
+  uint16_t arg16() const {
+    if (!has_arg16()) return uint16_t{};
+    uint16_t v = static_cast<uint16_t>(p_[6]) |
+                 static_cast<uint16_t>(p_[7]) << 8;
+    return static_cast<uint16_t>(v);
+  }
+  bool has_arg32() const { return len_ >= 16; }
+  uint32_t arg32(size_t i) const {
+    if (!has_arg32() || i >= 2) return uint32_t{};
+    uint32_t v = static_cast<uint32_t>(p_[8 + 4 * i]) |
+                 static_cast<uint32_t>(p_[9 + 4 * i]) << 8 |
+                 static_cast<uint32_t>(p_[10 + 4 * i]) << 16 |
+                 static_cast<uint32_t>(p_[11 + 4 * i]) << 24;
+    return static_cast<uint32_t>(v);
+  }
+
+ private:
+  const uint8_t* p_ = nullptr;
+  size_t len_ = 0;
+};
+
+class PerfCountersView {
+ public:
+  static constexpr uint8_t kId = 4;
+  static constexpr size_t kMinSize = 52;
+
+  /// Returns false if `len` is shorter than the first version.
+  bool bind(const uint8_t* p, size_t len) {
+    p_ = p;
+    len_ = len;
+    return len >= kMinSize;
+  }
+
+  bool has_time_ms() const { return len_ >= 4; }
+  uint32_t time_ms() const {
+    if (!has_time_ms()) return uint32_t{};
+    uint32_t v = static_cast<uint32_t>(p_[0]) |
+                 static_cast<uint32_t>(p_[1]) << 8 |
+                 static_cast<uint32_t>(p_[2]) << 16 |
+                 static_cast<uint32_t>(p_[3]) << 24;
+    return static_cast<uint32_t>(v);
+  }
+  bool has_window_s() const { return len_ >= 6; }
+  uint16_t window_s() const {
+    if (!has_window_s()) return uint16_t{};
+    uint16_t v = static_cast<uint16_t>(p_[4]) |
+                 static_cast<uint16_t>(p_[5]) << 8;
+    return static_cast<uint16_t>(v);
+  }
+  bool has_task_cpu_permille() const { return len_ >= 18; }
+  uint16_t task_cpu_permille(size_t i) const {
+    if (!has_task_cpu_permille() || i >= 6) return uint16_t{};
+    uint16_t v = static_cast<uint16_t>(p_[6 + 2 * i]) |
+                 static_cast<uint16_t>(p_[7 + 2 * i]) << 8;
+    return static_cast<uint16_t>(v);
+  }
+  bool has_task_deadline_misses() const { return len_ >= 24; }
+  uint8_t task_deadline_misses(size_t i) const {
+    if (!has_task_deadline_misses() || i >= 6) return uint8_t{};
+    uint8_t v = static_cast<uint8_t>(p_[18 + 1 * i]);
+    return static_cast<uint8_t>(v);
+  }
+  bool has_queue_high_water() const { return len_ >= 28; }
+  uint8_t queue_high_water(size_t i) const {
+    if (!has_queue_high_water() || i >= 4) return uint8_t{};
+    uint8_t v = static_cast<uint8_t>(p_[24 + 1 * i]);
+    return static_cast<uint8_t>(v);
+  }
+  bool has_pool_high_water() const { return len_ >= 29; }
+  uint8_t pool_high_water() const {
+    if (!has_pool_high_water()) return uint8_t{};
+    uint8_t v = static_cast<uint8_t>(p_[28]);
+    return static_cast<uint8_t>(v);
+  }
+  bool has_pool_exhausted() const { return len_ >= 30; }
+  uint8_t pool_exhausted() const {
+    if (!has_pool_exhausted()) return uint8_t{};
+    uint8_t v = static_cast<uint8_t>(p_[29]);
+    return static_cast<uint8_t>(v);
+  }
+  bool has_flash_write_p99_us() const { return len_ >= 32; }
+  uint16_t flash_write_p99_us() const {
+    if (!has_flash_write_p99_us()) return uint16_t{};
+    uint16_t v = static_cast<uint16_t>(p_[30]) |
+                 static_cast<uint16_t>(p_[31]) << 8;
+    return static_cast<uint16_t>(v);
+  }
+  bool has_flash_write_max_us() const { return len_ >= 34; }
+  uint16_t flash_write_max_us() const {
+    if (!has_flash_write_max_us()) return uint16_t{};
+    uint16_t v = static_cast<uint16_t>(p_[32]) |
+                 static_cast<uint16_t>(p_[33]) << 8;
+    return static_cast<uint16_t>(v);
+  }
+  bool has_radio_retries() const { return len_ >= 36; }
+  uint16_t radio_retries() const {
+    if (!has_radio_retries()) return uint16_t{};
+    uint16_t v = static_cast<uint16_t>(p_[34]) |
+                 static_cast<uint16_t>(p_[35]) << 8;
+    return static_cast<uint16_t>(v);
+  }
+  bool has_isr_latency_max_us() const { return len_ >= 42; }
+  uint16_t isr_latency_max_us(size_t i) const {
+    if (!has_isr_latency_max_us() || i >= 3) return uint16_t{};
+    uint16_t v = static_cast<uint16_t>(p_[36 + 2 * i]) |
+                 static_cast<uint16_t>(p_[37 + 2 * i]) << 8;
+    return static_cast<uint16_t>(v);
+  }
+  bool has_energy_j10() const { return len_ >= 52; }
+  uint16_t energy_j10(size_t i) const {
+    if (!has_energy_j10() || i >= 5) return uint16_t{};
+    uint16_t v = static_cast<uint16_t>(p_[42 + 2 * i]) |
+                 static_cast<uint16_t>(p_[43 + 2 * i]) << 8;
+    return static_cast<uint16_t>(v);
+  }
+
+ private:
+  const uint8_t* p_ = nullptr;
+  size_t len_ = 0;
+};
+
+class PerfConfigView {
+ public:
+  static constexpr uint8_t kId = 5;
+  static constexpr size_t kMinSize = 2;
+
+  /// Returns false if `len` is shorter than the first version.
+  bool bind(const uint8_t* p, size_t len) {
+    p_ = p;
+    len_ = len;
+    return len >= kMinSize;
+  }
+
+  bool has_period_s() const { return len_ >= 2; }
+  uint16_t period_s() const {
+    if (!has_period_s()) return uint16_t{};
+    uint16_t v = static_cast<uint16_t>(p_[0]) |
+                 static_cast<uint16_t>(p_[1]) << 8;
+    return static_cast<uint16_t>(v);
+  }
+
+ private:
+  const uint8_t* p_ = nullptr;
+  size_t len_ = 0;
+};
+
+class SelfTestReportView {
+ public:
+  static constexpr uint8_t kId = 6;
+  static constexpr size_t kMinSize = 27;
+
+  /// Returns false if `len` is shorter than the first version.
+  bool bind(const uint8_t* p, size_t len) {
+    p_ = p;
+    len_ = len;
+    return len >= kMinSize;
+  }
+
+  bool has_time_ms() const { return len_ >= 4; }
+  uint32_t time_ms() const {
+    if (!has_time_ms()) return uint32_t{};
+    uint32_t v = static_cast<uint32_t>(p_[0]) |
+                 static_cast<uint32_t>(p_[1]) << 8 |
+                 static_cast<uint32_t>(p_[2]) << 16 |
+                 static_cast<uint32_t>(p_[3]) << 24;
+    return static_cast<uint32_t>(v);
+  }
+  bool has_duration_ms() const { return len_ >= 6; }
+  uint16_t duration_ms() const {
+    if (!has_duration_ms()) return uint16_t{};
+    uint16_t v = static_cast<uint16_t>(p_[4]) |
+                 static_cast<uint16_t>(p_[5]) << 8;
+    return static_cast<uint16_t>(v);
+  }
+  bool has_mode() const { return len_ >= 7; }
+  uint8_t mode() const {
+    if (!has_mode()) return uint8_t{};
+    uint8_t v = static_cast<uint8_t>(p_[6]);
+    return static_cast<uint8_t>(v);
+  }
+  bool has_checks() const { return len_ >= 8; }
+  uint8_t checks() const {
+    if (!has_checks()) return uint8_t{};
+    uint8_t v = static_cast<uint8_t>(p_[7]);
+    return static_cast<uint8_t>(v);
+  }
+  bool has_passed() const { return len_ >= 9; }
+  uint8_t passed() const {
+    if (!has_passed()) return uint8_t{};
+    uint8_t v = static_cast<uint8_t>(p_[8]);
+    return static_cast<uint8_t>(v);
+  }
+  bool has_failed() const { return len_ >= 10; }
+  uint8_t failed() const {
+    if (!has_failed()) return uint8_t{};
+    uint8_t v = static_cast<uint8_t>(p_[9]);
+    return static_cast<uint8_t>(v);
+  }
+  bool has_timed_out() const { return len_ >= 11; }
+  uint8_t timed_out() const {
+    if (!has_timed_out()) return uint8_t{};
+    uint8_t v = static_cast<uint8_t>(p_[10]);
+    return static_cast<uint8_t>(v);
+  }
+  bool has_value() const { return len_ >= 27; }
+  int16_t value(size_t i) const {
+    if (!has_value() || i >= 8) return int16_t{};
+    uint16_t v = static_cast<uint16_t>(p_[11 + 2 * i]) |
+                 static_cast<uint16_t>(p_[12 + 2 * i]) << 8;
+    return static_cast<int16_t>(v);
+  }
+
+ private:
+  const uint8_t* p_ = nullptr;
+  size_t len_ = 0;
+};
+
+class ThermistorCalView {
+ public:
+  static constexpr uint8_t kId = 7;
+  static constexpr size_t kMinSize = 16;
+
+  /// Returns false if `len` is shorter than the first version.
+  bool bind(const uint8_t* p, size_t len) {
+    p_ = p;
+    len_ = len;
+    return len >= kMinSize;
+  }
+
+  bool has_sh_a() const { return len_ >= 4; }
+  float sh_a() const {
+    if (!has_sh_a()) return float{};
+    uint32_t v = static_cast<uint32_t>(p_[0]) |
+                 static_cast<uint32_t>(p_[1]) << 8 |
+                 static_cast<uint32_t>(p_[2]) << 16 |
+                 static_cast<uint32_t>(p_[3]) << 24;
+    float out;
+    memcpy(&out, &v, 4);
+    return out;
+  }
+  bool has_sh_b() const { return len_ >= 8; }
+  float sh_b() const {
+    if (!has_sh_b()) return float{};
+    uint32_t v = static_cast<uint32_t>(p_[4]) |
+                 static_cast<uint32_t>(p_[5]) << 8 |
+                 static_cast<uint32_t>(p_[6]) << 16 |
+                 static_cast<uint32_t>(p_[7]) << 24;
+    float out;
+    memcpy(&out, &v, 4);
+    return out;
+  }
+  bool has_sh_c() const { return len_ >= 12; }
+  float sh_c() const {
+    if (!has_sh_c()) return float{};
+    uint32_t v = static_cast<uint32_t>(p_[8]) |
+                 static_cast<uint32_t>(p_[9]) << 8 |
+                 static_cast<uint32_t>(p_[10]) << 16 |
+                 static_cast<uint32_t>(p_[11]) << 24;
+    float out;
+    memcpy(&out, &v, 4);
+    return out;
+  }
+  bool has_r_fixed_ohm() const { return len_ >= 16; }
+  float r_fixed_ohm() const {
+    if (!has_r_fixed_ohm()) return float{};
+    uint32_t v = static_cast<uint32_t>(p_[12]) |
+                 static_cast<uint32_t>(p_[13]) << 8 |
+                 static_cast<uint32_t>(p_[14]) << 16 |
+                 static_cast<uint32_t>(p_[15]) << 24;
+    float out;
+    memcpy(&out, &v, 4);
+    return out;
+  }
+
+ private:
+  const uint8_t* p_ = nullptr;
+  size_t len_ = 0;
+};
+
+class CutCommandView {
+ public:
+  static constexpr uint8_t kId = 8;
+  static constexpr size_t kMinSize = 17;
+
+  /// Returns false if `len` is shorter than the first version.
+  bool bind(const uint8_t* p, size_t len) {
+    p_ = p;
+    len_ = len;
+    return len >= kMinSize;
+  }
+
+  bool has_unit_id() const { return len_ >= 4; }
+  uint32_t unit_id() const {
+    if (!has_unit_id()) return uint32_t{};
+    uint32_t v = static_cast<uint32_t>(p_[0]) |
+                 static_cast<uint32_t>(p_[1]) << 8 |
+                 static_cast<uint32_t>(p_[2]) << 16 |
+                 static_cast<uint32_t>(p_[3]) << 24;
+    return static_cast<uint32_t>(v);
+  }
+  bool has_counter() const { return len_ >= 8; }
+  uint32_t counter() const {
+    if (!has_counter()) return uint32_t{};
+    uint32_t v = static_cast<uint32_t>(p_[4]) |
+                 static_cast<uint32_t>(p_[5]) << 8 |
+                 static_cast<uint32_t>(p_[6]) << 16 |
+                 static_cast<uint32_t>(p_[7]) << 24;
+    return static_cast<uint32_t>(v);
+  }
+  bool has_action() const { return len_ >= 9; }
+  uint8_t action() const {
+    if (!has_action()) return uint8_t{};
+    uint8_t v = static_cast<uint8_t>(p_[8]);
+    return static_cast<uint8_t>(v);
+  }
+  bool has_tag() const { return len_ >= 17; }
+  uint64_t tag() const {
+    if (!has_tag()) return uint64_t{};
+    uint64_t v = static_cast<uint64_t>(p_[9]) |
+                 static_cast<uint64_t>(p_[10]) << 8 |
+                 static_cast<uint64_t>(p_[11]) << 16 |
+                 static_cast<uint64_t>(p_[12]) << 24 |
+                 static_cast<uint64_t>(p_[13]) << 32 |
+                 static_cast<uint64_t>(p_[14]) << 40 |
+                 static_cast<uint64_t>(p_[15]) << 48 |
+                 static_cast<uint64_t>(p_[16]) << 56;
+    return static_cast<uint64_t>(v);
+  }
+
+ private:
+  const uint8_t* p_ = nullptr;
+  size_t len_ = 0;
+};
+
+class CutAckView {
+ public:
+  static constexpr uint8_t kId = 9;
+  static constexpr size_t kMinSize = 18;
+
+  /// Returns false if `len` is shorter than the first version.
+  bool bind(const uint8_t* p, size_t len) {
+    p_ = p;
+    len_ = len;
+    return len >= kMinSize;
+  }
+
+  bool has_time_ms() const { return len_ >= 4; }
+  uint32_t time_ms() const {
+    if (!has_time_ms()) return uint32_t{};
+    uint32_t v = static_cast<uint32_t>(p_[0]) |
+                 static_cast<uint32_t>(p_[1]) << 8 |
+                 static_cast<uint32_t>(p_[2]) << 16 |
+                 static_cast<uint32_t>(p_[3]) << 24;
+    return static_cast<uint32_t>(v);
+  }
+  bool has_counter() const { return len_ >= 8; }
+  uint32_t counter() const {
+    if (!has_counter()) return uint32_t{};
+    uint32_t v = static_cast<uint32_t>(p_[4]) |
+                 static_cast<uint32_t>(p_[5]) << 8 |
+                 static_cast<uint32_t>(p_[6]) << 16 |
+                 static_cast<uint32_t>(p_[7]) << 24;
+    return static_cast<uint32_t>(v);
+  }
+  bool has_result() const { return len_ >= 9; }
+  uint8_t result() const {
+    if (!has_result()) return uint8_t{};
+    uint8_t v = static_cast<uint8_t>(p_[8]);
+    return static_cast<uint8_t>(v);
+  }
+  bool has_burn_state() const { return len_ >= 10; }
+  uint8_t burn_state() const {
+    if (!has_burn_state()) return uint8_t{};
+    uint8_t v = static_cast<uint8_t>(p_[9]);
+    return static_cast<uint8_t>(v);
+  }
+  bool has_auth_us() const { return len_ >= 12; }
+  uint16_t auth_us() const {
+    if (!has_auth_us()) return uint16_t{};
+    uint16_t v = static_cast<uint16_t>(p_[10]) |
+                 static_cast<uint16_t>(p_[11]) << 8;
+    return static_cast<uint16_t>(v);
+  }
+  bool has_gate_us() const { return len_ >= 14; }
+  uint16_t gate_us() const {
+    if (!has_gate_us()) return uint16_t{};
+    uint16_t v = static_cast<uint16_t>(p_[12]) |
+                 static_cast<uint16_t>(p_[13]) << 8;
+    return static_cast<uint16_t>(v);
+  }
+  bool has_current_us() const { return len_ >= 18; }
+  uint32_t current_us() const {
+    if (!has_current_us()) return uint32_t{};
+    uint32_t v = static_cast<uint32_t>(p_[14]) |
+                 static_cast<uint32_t>(p_[15]) << 8 |
+                 static_cast<uint32_t>(p_[16]) << 16 |
+                 static_cast<uint32_t>(p_[17]) << 24;
+    return static_cast<uint32_t>(v);
+  }
+
+ private:
+  const uint8_t* p_ = nullptr;
+  size_t len_ = 0;
+};
+
+}  // namespace skyguard::records
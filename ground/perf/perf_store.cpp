@@ -0,0 +1,278 @@
+#include "ground/perf/perf_store.h"
+
+#include <math.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "ground/generated/record_views.h"
+
+namespace skyguard::ground {
+
+namespace {
+
+using records::PerfCountersView;
+
+constexpr uint8_t kLogMagic[4] = {'S', 'G', 'P', 'L'};
+constexpr size_t kEntryHeader = 4 + 8 + 2;  // unit, rx time, payload length
+
+enum class Field : uint8_t {
+  kWindow,
+  kCpu,
+  kMisses,
+  kQueue,
+  kPoolHigh,
+  kPoolExhausted,
+  kFlashP99,
+  kFlashMax,
+  kRetries,
+  kIsr,
+  kEnergy,
+};
+
+struct MetricDef {
+  const char* name;
+  Field field;
+  uint8_t index;
+};
+
+// Indexes follow the PerfTask, PerfQueue, PerfIsr and PerfRail enums.
+constexpr MetricDef kMetrics[] = {
+    {"window_s", Field::kWindow, 0},
+    {"cpu.tick", Field::kCpu, 0},
+    {"cpu.gps", Field::kCpu, 1},
+    {"cpu.telemetry", Field::kCpu, 2},
+    {"cpu.radio", Field::kCpu, 3},
+    {"cpu.log", Field::kCpu, 4},
+    {"cpu.fence", Field::kCpu, 5},
+    {"miss.tick", Field::kMisses, 0},
+    {"miss.gps", Field::kMisses, 1},
+    {"miss.telemetry", Field::kMisses, 2},
+    {"miss.radio", Field::kMisses, 3},
+    {"miss.log", Field::kMisses, 4},
+    {"miss.fence", Field::kMisses, 5},
+    {"queue.router", Field::kQueue, 0},
+    {"queue.gps_rx", Field::kQueue, 1},
+    {"queue.log_write", Field::kQueue, 2},
+    {"queue.console_tx", Field::kQueue, 3},
+    {"pool.high_water", Field::kPoolHigh, 0},
+    {"pool.exhausted", Field::kPoolExhausted, 0},
+    {"flash.p99_us", Field::kFlashP99, 0},
+    {"flash.max_us", Field::kFlashMax, 0},
+    {"radio.retries", Field::kRetries, 0},
+    {"isr.radio_us", Field::kIsr, 0},
+    {"isr.gps_uart_us", Field::kIsr, 1},
+    {"isr.timer_us", Field::kIsr, 2},
+    {"energy.core_j", Field::kEnergy, 0},
+    {"energy.gps_j", Field::kEnergy, 1},
+    {"energy.radio_j", Field::kEnergy, 2},
+    {"energy.iridium_j", Field::kEnergy, 3},
+    {"energy.burn_j", Field::kEnergy, 4},
+};
+constexpr size_t kMetricCount = sizeof(kMetrics) / sizeof(kMetrics[0]);
+
+float metric_value(const PerfCountersView& v, const MetricDef& m) {
+  switch (m.field) {
+    case Field::kWindow: return v.window_s();
+    case Field::kCpu: return v.task_cpu_permille(m.index) / 10.0f;
+    case Field::kMisses: return v.task_deadline_misses(m.index);
+    case Field::kQueue: return v.queue_high_water(m.index);
+    case Field::kPoolHigh: return v.pool_high_water();
+    case Field::kPoolExhausted: return v.pool_exhausted();
+    case Field::kFlashP99: return v.flash_write_p99_us();
+    case Field::kFlashMax: return v.flash_write_max_us();
+    case Field::kRetries: return v.radio_retries();
+    case Field::kIsr: return v.isr_latency_max_us(m.index);
+    case Field::kEnergy: return v.energy_j10(m.index) / 10.0f;
+  }
+  return NAN;
+}
+
+void put_le(uint64_t v, size_t n, uint8_t* out) {
+  for (size_t i = 0; i < n; ++i) out[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+uint64_t get_le(const uint8_t* p, size_t n) {
+  uint64_t v = 0;
+  for (size_t i = 0; i < n; ++i) v |= static_cast<uint64_t>(p[i]) << (8 * i);
+  return v;
+}
+
+}  // namespace
+
+size_t perf_metric_count() { return kMetricCount; }
+
+const char* perf_metric_name(size_t metric) {
+  return metric < kMetricCount ? kMetrics[metric].name : nullptr;
+}
+
+int perf_metric_index(const std::string& name) {
+  for (size_t i = 0; i < kMetricCount; ++i) {
+    if (name == kMetrics[i].name) return static_cast<int>(i);
+  }
+  return -1;
+}
+
+PerfStore::~PerfStore() { close(); }
+
+void PerfStore::close() {
+  if (log_) fclose(log_);
+  log_ = nullptr;
+}
+
+bool PerfStore::open(const std::string& path, std::string* err) {
+  close();
+  replayed_ = 0;
+  torn_tail_ = false;
+  FILE* f = fopen(path.c_str(), "r+b");
+  if (!f) f = fopen(path.c_str(), "w+b");
+  if (!f) {
+    *err = "cannot open " + path;
+    return false;
+  }
+  uint8_t magic[4];
+  size_t got = fread(magic, 1, sizeof(magic), f);
+  if (got == 0) {
+    if (fwrite(kLogMagic, 1, sizeof(kLogMagic), f) != sizeof(kLogMagic) || fflush(f) != 0) {
+      fclose(f);
+      *err = "cannot write " + path;
+      return false;
+    }
+    log_ = f;
+    return true;
+  }
+  if (got != sizeof(magic) || memcmp(magic, kLogMagic, sizeof(magic)) != 0) {
+    fclose(f);
+    *err = path + " is not a perf log";
+    return false;
+  }
+
+  long good = static_cast<long>(sizeof(kLogMagic));
+  std::vector<uint8_t> payload;
+  for (;;) {
+    uint8_t hdr[kEntryHeader];
+    size_t n = fread(hdr, 1, sizeof(hdr), f);
+    if (n == 0) break;
+    size_t len = n == sizeof(hdr) ? static_cast<size_t>(get_le(hdr + 12, 2)) : 0;
+    payload.resize(len);
+    if (n != sizeof(hdr) || fread(payload.data(), 1, len, f) != len) {
+      torn_tail_ = true;
+      break;
+    }
+    std::string ignored;
+    if (decode(static_cast<uint32_t>(get_le(hdr, 4)), static_cast<int64_t>(get_le(hdr + 4, 8)),
+               payload.data(), len, &ignored)) {
+      ++replayed_;
+    }
+    good += static_cast<long>(sizeof(hdr) + len);
+  }
+  if (torn_tail_ && (fflush(f) != 0 || ftruncate(fileno(f), good) != 0)) {
+    fclose(f);
+    *err = "cannot truncate " + path;
+    return false;
+  }
+  fseek(f, good, SEEK_SET);
+  log_ = f;
+  return true;
+}
+
+bool PerfStore::ingest(uint32_t unit, int64_t rx_time_s, const uint8_t* payload, size_t len,
+                       std::string* err) {
+  if (len > UINT16_MAX) {
+    *err = "payload too long";
+    return false;
+  }
+  if (!decode(unit, rx_time_s, payload, len, err)) return false;
+  if (!log_) return true;
+  uint8_t hdr[kEntryHeader];
+  put_le(unit, 4, hdr);
+  put_le(static_cast<uint64_t>(rx_time_s), 8, hdr + 4);
+  put_le(len, 2, hdr + 12);
+  if (fwrite(hdr, 1, sizeof(hdr), log_) != sizeof(hdr) ||
+      fwrite(payload, 1, len, log_) != len) {
+    *err = "log write failed";
+    return false;
+  }
+  return true;
+}
+
+bool PerfStore::decode(uint32_t unit, int64_t rx_time_s, const uint8_t* payload, size_t len,
+                       std::string* err) {
+  PerfCountersView v;
+  if (!v.bind(payload, len)) {
+    *err = "short PerfCounters payload (" + std::to_string(len) + " B)";
+    return false;
+  }
+  Unit& u = units_[unit];
+  if (u.columns.empty()) u.columns.resize(kMetricCount);
+  // Frames normally arrive in order; late ones are inserted in place.
+  size_t at = u.t_s.size();
+  if (at && rx_time_s < u.t_s.back()) {
+    at = static_cast<size_t>(std::upper_bound(u.t_s.begin(), u.t_s.end(), rx_time_s) -
+                             u.t_s.begin());
+  }
+  u.t_s.insert(u.t_s.begin() + static_cast<ptrdiff_t>(at), rx_time_s);
+  for (size_t m = 0; m < kMetricCount; ++m) {
+    std::vector<float>& col = u.columns[m];
+    col.insert(col.begin() + static_cast<ptrdiff_t>(at), metric_value(v, kMetrics[m]));
+  }
+  ++samples_;
+  return true;
+}
+
+std::vector<PerfPoint> PerfStore::series(uint32_t unit, size_t metric, int64_t t0_s,
+                                         int64_t t1_s) const {
+  std::vector<PerfPoint> out;
+  auto it = units_.find(unit);
+  if (it == units_.end() || metric >= kMetricCount) return out;
+  const Unit& u = it->second;
+  size_t i = static_cast<size_t>(std::lower_bound(u.t_s.begin(), u.t_s.end(), t0_s) -
+                                 u.t_s.begin());
+  for (; i < u.t_s.size() && u.t_s[i] < t1_s; ++i) {
+    out.push_back({u.t_s[i], u.columns[metric][i]});
+  }
+  return out;
+}
+
+std::vector<PerfBucket> PerfStore::fleet(size_t metric, int64_t t0_s, int64_t t1_s,
+                                         uint32_t bucket_s) const {
+  std::vector<PerfBucket> out;
+  if (metric >= kMetricCount || bucket_s == 0 || t1_s <= t0_s) return out;
+  size_t n = static_cast<size_t>((t1_s - t0_s + bucket_s - 1) / bucket_s);
+  out.resize(n);
+  std::vector<double> sums(n, 0.0);
+  for (size_t b = 0; b < n; ++b) {
+    out[b] = {t0_s + static_cast<int64_t>(b) * bucket_s, 0, INFINITY, 0, -INFINITY};
+  }
+  for (const auto& entry : units_) {
+    const Unit& u = entry.second;
+    const std::vector<float>& col = u.columns[metric];
+    size_t i = static_cast<size_t>(std::lower_bound(u.t_s.begin(), u.t_s.end(), t0_s) -
+                                   u.t_s.begin());
+    for (; i < u.t_s.size() && u.t_s[i] < t1_s; ++i) {
+      size_t b = static_cast<size_t>((u.t_s[i] - t0_s) / bucket_s);
+      PerfBucket& k = out[b];
+      ++k.count;
+      sums[b] += col[i];
+      k.min = std::min(k.min, col[i]);
+      k.max = std::max(k.max, col[i]);
+    }
+  }
+  for (size_t b = 0; b < n; ++b) {
+    if (out[b].count) {
+      out[b].mean = static_cast<float>(sums[b] / out[b].count);
+    } else {
+      out[b].min = out[b].max = 0;
+    }
+  }
+  return out;
+}
+
+std::vector<uint32_t> PerfStore::units() const {
+  std::vector<uint32_t> out;
+  for (const auto& entry : units_) out.push_back(entry.first);
+  return out;
+}
+
+}  // namespace skyguard::ground
@@ -0,0 +1,85 @@
+// Fleet store for downlinked PerfCounters records.
+//
+// Each payload is kept as received (unit, ground receive time, raw bytes)
+// in an append-only log, so a newer schema can replay older files, and is
+// decoded into one column per metric per unit for queries. Units' columns
+// are kept sorted by receive time; a fleet query folds one metric across
+// all units into fixed time buckets (count, min, mean, max) for
+// dashboards.
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace skyguard::ground {
+
+/// Metric columns, in record order: CPU share (%) and deadline misses per
+/// task, queue high-water marks, pool, flash write timing (us), radio
+/// retries, ISR latency maxima (us) and energy per rail (J) for the window.
+size_t perf_metric_count();
+const char* perf_metric_name(size_t metric);
+/// Returns -1 for an unknown name.
+int perf_metric_index(const std::string& name);
+
+struct PerfPoint {
+  int64_t t_s;
+  float value;
+};
+
+struct PerfBucket {
+  int64_t t0_s;
+  uint32_t count;
+  float min, mean, max;
+};
+
+class PerfStore {
+ public:
+  PerfStore() = default;
+  PerfStore(const PerfStore&) = delete;
+  PerfStore& operator=(const PerfStore&) = delete;
+  ~PerfStore();
+
+  /// Opens (creating if absent) the log at `path` and replays it. A torn
+  /// final entry is cut off. Without open() the store is memory only.
+  bool open(const std::string& path, std::string* err);
+  void close();
+
+  /// Adds one PerfCounters payload from `unit` received at `rx_time_s`.
+  bool ingest(uint32_t unit, int64_t rx_time_s, const uint8_t* payload, size_t len,
+              std::string* err);
+
+  /// Samples of one metric for one unit with t0_s <= t < t1_s.
+  std::vector<PerfPoint> series(uint32_t unit, size_t metric, int64_t t0_s,
+                                int64_t t1_s) const;
+  /// One metric over all units in `bucket_s` buckets from t0_s; empty
+  /// buckets have count 0.
+  std::vector<PerfBucket> fleet(size_t metric, int64_t t0_s, int64_t t1_s,
+                                uint32_t bucket_s) const;
+
+  std::vector<uint32_t> units() const;
+  size_t samples() const { return samples_; }
+  /// Log replay statistics from the last open().
+  size_t replayed() const { return replayed_; }
+  bool torn_tail() const { return torn_tail_; }
+
+ private:
+  struct Unit {
+    std::vector<int64_t> t_s;
+    std::vector<std::vector<float>> columns;  // [metric][sample]
+  };
+
+  bool decode(uint32_t unit, int64_t rx_time_s, const uint8_t* payload, size_t len,
+              std::string* err);
+
+  std::map<uint32_t, Unit> units_;
+  FILE* log_ = nullptr;
+  size_t samples_ = 0;
+  size_t replayed_ = 0;
+  bool torn_tail_ = false;
+};
+
+}  // namespace skyguard::ground
@@ -0,0 +1,84 @@
+// Balloon flight physics shared by the launch planner and the simulators'
+// synthetic flights (sim/flight_synth.h).
+//
+// The 1976 standard atmosphere to 50 km from a table, and the vertical
+// rates that follow the air density: a free-lift ascent that speeds up as
+// the air thins, and a parachute descent at constant dynamic pressure. A
+// rate is given at sea level and scaled by the density ratio.
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+
+namespace skyguard::ground {
+
+/// 1976 standard atmosphere, tabulated every 10 m from 0 to 50 km.
+class Atmosphere {
+ public:
+  static constexpr double kStepM = 10;
+  static constexpr int kRows = 5001;
+  static constexpr double kSeaLevelPa = 101325;
+  static constexpr double kSeaLevelDensity = 1.225;
+  static constexpr double kDryAirJPerKgK = 287.05;
+
+  static const Atmosphere& standard() {
+    static const Atmosphere a;
+    return a;
+  }
+  /// Exact layer formulas; the table is built from these.
+  static void exact(double alt_m, double* t_k, double* p_pa) {
+    struct Layer {
+      double base_m, base_k, lapse_k_m, base_pa;
+    };
+    static constexpr Layer kLayers[] = {
+        {0, 288.15, -0.0065, 101325.0},   {11000, 216.65, 0, 22632.06},
+        {20000, 216.65, 0.001, 5474.889}, {32000, 228.65, 0.0028, 868.0187},
+        {47000, 270.65, 0, 110.9063},
+    };
+    constexpr double kGmOverR = 0.0341631947;  // g0 M / R*, K/m
+    size_t i = 0;
+    while (i + 1 < sizeof(kLayers) / sizeof(kLayers[0]) && alt_m >= kLayers[i + 1].base_m) ++i;
+    const Layer& l = kLayers[i];
+    double dh = alt_m - l.base_m;
+    *t_k = l.base_k + l.lapse_k_m * dh;
+    *p_pa = l.lapse_k_m == 0 ? l.base_pa * exp(-kGmOverR * dh / l.base_k)
+                             : l.base_pa * pow(l.base_k / *t_k, kGmOverR / l.lapse_k_m);
+  }
+  /// Linear interpolation in the table; clamped to 0..50 km.
+  void at(double alt_m, double* t_k, double* p_pa) const {
+    double x = alt_m < 0 ? 0 : alt_m / kStepM;
+    int i = x >= kRows - 1 ? kRows - 2 : static_cast<int>(x);
+    double f = x - i > 1 ? 1 : x - i;
+    *t_k = t_k_[i] + f * (t_k_[i + 1] - t_k_[i]);
+    *p_pa = p_pa_[i] + f * (p_pa_[i + 1] - p_pa_[i]);
+  }
+  /// Air density over its sea-level value.
+  static double density_ratio(double t_k, double p_pa) {
+    return p_pa / (kDryAirJPerKgK * t_k) / kSeaLevelDensity;
+  }
+  double density_ratio_at(double alt_m) const {
+    double t_k, p_pa;
+    at(alt_m, &t_k, &p_pa);
+    return density_ratio(t_k, p_pa);
+  }
+
+ private:
+  Atmosphere() {
+    for (int i = 0; i < kRows; ++i) exact(i * kStepM, &t_k_[i], &p_pa_[i]);
+  }
+  double t_k_[kRows];
+  double p_pa_[kRows];
+};
+
+/// Free-lift climb rate for `sea_level_mps` at `density_ratio`.
+inline double ascent_rate_mps(double sea_level_mps, double density_ratio) {
+  return sea_level_mps * pow(density_ratio, -1.0 / 12);
+}
+
+/// Terminal descent rate under canopy for `sea_level_mps` at
+/// `density_ratio`.
+inline double descent_rate_mps(double sea_level_mps, double density_ratio) {
+  return sea_level_mps / sqrt(density_ratio);
+}
+
+}  // namespace skyguard::ground
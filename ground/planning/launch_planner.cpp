@@ -0,0 +1,270 @@
+#include "ground/planning/launch_planner.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "ground/planning/balloon_model.h"
+#include "storage/data_view.h"
+#include "wind/wind_grid.h"
+
+namespace skyguard::ground {
+
+namespace {
+
+constexpr double kMetresPerDegree = 111195.0;
+constexpr double kRadPerDegree = 0.017453292519943295;
+
+// splitmix64 over (seed, candidate, member): members are reproducible in
+// any order and on any thread.
+class MemberRng {
+ public:
+  MemberRng(uint64_t seed, uint64_t candidate, uint32_t member)
+      : s_(seed ^ candidate * 0x9E3779B97F4A7C15ull ^ (uint64_t{member} << 40 | member)) {}
+  double uniform() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+  double normal() {
+    // Box-Muller; one draw per call keeps the sequence simple.
+    double u = uniform(), v = uniform();
+    return sqrt(-2 * log(u > 0 ? u : 0x1.0p-53)) * cos(6.283185307179586 * v);
+  }
+
+ private:
+  uint64_t next() {
+    uint64_t z = (s_ += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+  }
+  uint64_t s_;
+};
+
+int32_t e7(double deg) { return static_cast<int32_t>(llround(deg * 1e7)); }
+
+float percentile(std::vector<float> v, double q) {
+  if (v.empty()) return NAN;
+  std::sort(v.begin(), v.end());
+  return v[static_cast<size_t>(q * (v.size() - 1))];
+}
+
+}  // namespace
+
+bool ForecastArchive::add(std::vector<uint8_t> image, std::string* err) {
+  wind::WindGrid grid;
+  if (!grid.bind(storage::DataView::mapped(image.data(), static_cast<uint32_t>(image.size())))) {
+    *err = "not a valid wind grid image";
+    return false;
+  }
+  headers_.push_back(grid.header());
+  images_.push_back(std::move(image));
+  return true;
+}
+
+int ForecastArchive::covering(uint32_t t0_utc_s, uint32_t t1_utc_s) const {
+  int best = -1;
+  for (size_t i = 0; i < headers_.size(); ++i) {
+    const wind::WindGridHeader& h = headers_[i];
+    uint32_t end = h.t0_utc_s + (h.n_times - 1u) * h.dt_s;
+    if (h.t0_utc_s > t0_utc_s || end < t1_utc_s) continue;
+    if (best < 0 || h.t0_utc_s > headers_[best].t0_utc_s) best = static_cast<int>(i);
+  }
+  return best;
+}
+
+// One thread's grid readers, bound on first use: WindGrid keeps a tile
+// cache, so threads cannot share one.
+struct LaunchPlanner::Readers {
+  std::vector<wind::WindGrid> grids;
+  std::vector<bool> bound;
+};
+
+LaunchPlanner::LaunchPlanner(const ForecastArchive& archive, const geofence::FenceSet& fences,
+                             const PlanConfig& config)
+    : archive_(archive), fences_(fences), config_(config) {}
+
+size_t LaunchPlanner::candidates() const {
+  if (config_.step_s == 0 || config_.last_utc_s < config_.first_utc_s) return 0;
+  return (config_.last_utc_s - config_.first_utc_s) / config_.step_s + 1;
+}
+
+MemberOutcome LaunchPlanner::fly(size_t candidate, uint32_t member, int forecast,
+                                 Readers& r) const {
+  const BalloonProfile& b = config_.balloon;
+  const PlanSpread& sp = config_.spread;
+  MemberRng rng(config_.seed, candidate, member);
+  double ascent = b.ascent_mps * std::max(0.5, 1 + sp.ascent_frac * rng.normal());
+  double burst = b.burst_m + sp.burst_m * rng.normal();
+  double descent = b.descent_mps * std::max(0.5, 1 + sp.descent_frac * rng.normal());
+  double wind_scale = 1 + sp.wind_frac * rng.normal();
+  double bias_u = sp.wind_ms * rng.normal(), bias_v = sp.wind_ms * rng.normal();
+
+  wind::WindGrid& grid = r.grids[static_cast<size_t>(forecast)];
+  const Atmosphere& atm = Atmosphere::standard();
+  termination::TerminationEngine engine(config_.limits);
+  const uint16_t breach = termination::condition_bit(termination::Condition::kFenceBreach);
+  const uint32_t launch = candidate_utc_s(candidate);
+  const double dt = config_.dt_s;
+  double lat = config_.launch_lat_e7 * 1e-7, lon = config_.launch_lon_e7 * 1e-7;
+  double alt = b.launch_alt_m;
+  bool descending = false;
+  MemberOutcome o;
+  for (double t = 0;; t += dt) {
+    ++o.steps;
+    int32_t lat_e7 = e7(lat), lon_e7 = e7(lon);
+    float margin = fences_.margin_m(lat_e7, lon_e7);
+    o.min_margin_m = std::min(o.min_margin_m, margin);
+    if (descending && alt <= b.launch_alt_m) {
+      o.land_lat_e7 = lat_e7;
+      o.land_lon_e7 = lon_e7;
+      o.land_margin_m = margin;
+      o.flight_s = static_cast<float>(t);
+      return o;
+    }
+    if (!descending) {
+      termination::RuleInputs in{};
+      in.time_ms = static_cast<uint32_t>(t * 1000);
+      in.armed = true;
+      in.fence_margin_m = termination::fence_margin_input(margin);
+      in.alt_m = static_cast<int32_t>(alt);
+      in.flight_s = static_cast<uint32_t>(t);
+      in.battery_mv = UINT16_MAX;
+      in.traffic_m = UINT32_MAX;
+      if (engine.evaluate(in)) {
+        descending = true;
+        o.rule = static_cast<int8_t>(engine.fired_rule());
+        o.fence_cut = engine.rule_mask(static_cast<size_t>(o.rule)) & breach;
+      } else if (alt >= burst) {
+        descending = true;
+        o.completed = true;
+      }
+    }
+    wind::WindVector w;
+    uint32_t utc = launch + static_cast<uint32_t>(t);
+    if (!grid.sample(utc, lat_e7, lon_e7, static_cast<float>(alt), &w)) {
+      o.in_forecast = false;
+      o.flight_s = static_cast<float>(t);
+      return o;
+    }
+    double u = w.u_ms * wind_scale + bias_u, v = w.v_ms * wind_scale + bias_v;
+    lat += v * dt / kMetresPerDegree;
+    lon += u * dt / (kMetresPerDegree * cos(lat * kRadPerDegree));
+    double rho = atm.density_ratio_at(alt);
+    alt += (descending ? -descent_rate_mps(descent, rho) : ascent_rate_mps(ascent, rho)) * dt;
+  }
+}
+
+CandidateResult LaunchPlanner::evaluate(size_t candidate, Readers& r,
+                                        std::vector<MemberOutcome>* m) const {
+  CandidateResult c;
+  c.launch_utc_s = candidate_utc_s(candidate);
+  m->clear();
+  c.forecast = archive_.covering(c.launch_utc_s, c.launch_utc_s + config_.limits.max_flight_s);
+  if (c.forecast < 0) return c;
+  size_t g = static_cast<size_t>(c.forecast);
+  if (!r.bound[g]) {
+    const std::vector<uint8_t>& img = archive_.image(g);
+    r.bound[g] = r.grids[g].bind(
+        storage::DataView::mapped(img.data(), static_cast<uint32_t>(img.size())));
+    if (!r.bound[g]) return c;
+  }
+  for (uint32_t k = 0; k < config_.members; ++k) m->push_back(fly(candidate, k, c.forecast, r));
+
+  size_t risky = 0, completed = 0;
+  std::vector<float> land, track, lat, lon;
+  for (const MemberOutcome& o : *m) {
+    bool landed = o.in_forecast;
+    risky += !landed || o.fence_cut || !(o.land_margin_m >= config_.landing_margin_m);
+    completed += o.completed;
+    // Off the grid counts as landing on the fence.
+    land.push_back(landed ? o.land_margin_m : 0.0f);
+    track.push_back(o.min_margin_m);
+    if (landed) {
+      lat.push_back(static_cast<float>(o.land_lat_e7 * 1e-7));
+      lon.push_back(static_cast<float>(o.land_lon_e7 * 1e-7));
+    }
+  }
+  float n = static_cast<float>(m->size());
+  c.risk = n > 0 ? risky / n : 1;
+  c.completion = n > 0 ? completed / n : 0;
+  c.land_margin_p10_m = percentile(land, 0.1);
+  c.min_margin_p10_m = percentile(track, 0.1);
+  if (!lat.empty()) {
+    c.land_lat_e7 = e7(percentile(lat, 0.5));
+    c.land_lon_e7 = e7(percentile(lon, 0.5));
+  }
+  return c;
+}
+
+CandidateResult LaunchPlanner::evaluate(size_t candidate,
+                                        std::vector<MemberOutcome>* members) const {
+  Readers r{std::vector<wind::WindGrid>(archive_.size()), std::vector<bool>(archive_.size())};
+  std::vector<MemberOutcome> local;
+  return evaluate(candidate, r, members ? members : &local);
+}
+
+void LaunchPlanner::run(size_t threads, std::vector<CandidateResult>* out,
+                        PlanStats* stats) const {
+  auto t0 = std::chrono::steady_clock::now();
+  size_t n = candidates();
+  threads = std::max<size_t>(threads, 1);
+  out->assign(n, CandidateResult{});
+  std::vector<uint64_t> flights(threads), steps(threads);
+  std::atomic<size_t> next{0};
+  auto worker = [&](size_t id) {
+    Readers r{std::vector<wind::WindGrid>(archive_.size()), std::vector<bool>(archive_.size())};
+    std::vector<MemberOutcome> m;
+    for (size_t i; (i = next.fetch_add(1)) < n;) {
+      (*out)[i] = evaluate(i, r, &m);
+      flights[id] += m.size();
+      for (const MemberOutcome& o : m) steps[id] += o.steps;
+    }
+  };
+  std::vector<std::thread> pool;
+  for (size_t t = 1; t < threads; ++t) pool.emplace_back(worker, t);
+  worker(0);
+  for (auto& t : pool) t.join();
+  *stats = {};
+  for (size_t t = 0; t < threads; ++t) {
+    stats->flights += flights[t];
+    stats->steps += steps[t];
+  }
+  stats->threads = threads;
+  stats->wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+void rank_candidates(std::vector<CandidateResult>* c) {
+  std::stable_sort(c->begin(), c->end(), [](const CandidateResult& a, const CandidateResult& b) {
+    if (a.risk != b.risk) return a.risk < b.risk;
+    if (a.completion != b.completion) return a.completion > b.completion;
+    float ma = std::isnan(a.land_margin_p10_m) ? -INFINITY : a.land_margin_p10_m;
+    float mb = std::isnan(b.land_margin_p10_m) ? -INFINITY : b.land_margin_p10_m;
+    return ma > mb;
+  });
+}
+
+std::vector<LaunchWindow> launch_windows(const std::vector<CandidateResult>& by_time,
+                                         uint32_t step_s, float max_risk) {
+  std::vector<LaunchWindow> out;
+  for (size_t i = 0; i < by_time.size(); ++i) {
+    const CandidateResult& c = by_time[i];
+    if (c.forecast < 0 || c.risk > max_risk) continue;
+    bool extends = !out.empty() && i > 0 && by_time[i - 1].forecast >= 0 &&
+                   by_time[i - 1].risk <= max_risk &&
+                   c.launch_utc_s - out.back().last_utc_s == step_s;
+    if (!extends) {
+      out.push_back({c.launch_utc_s, c.launch_utc_s, c.risk, c.land_margin_p10_m});
+      continue;
+    }
+    LaunchWindow& w = out.back();
+    w.last_utc_s = c.launch_utc_s;
+    w.worst_risk = std::max(w.worst_risk, c.risk);
+    w.worst_land_margin_p10_m = std::min(w.worst_land_margin_p10_m, c.land_margin_p10_m);
+  }
+  std::stable_sort(out.begin(), out.end(), [](const LaunchWindow& a, const LaunchWindow& b) {
+    if (a.worst_risk != b.worst_risk) return a.worst_risk < b.worst_risk;
+    return a.worst_land_margin_p10_m > b.worst_land_margin_p10_m;
+  });
+  return out;
+}
+
+}  // namespace skyguard::ground
@@ -0,0 +1,159 @@
+// Launch-window planning over a local forecast archive.
+//
+// Every candidate launch time is flown as a small Monte Carlo ensemble
+// through the newest archived forecast grid that covers it. Each member
+// perturbs the ascent rate, burst altitude, descent rate and forecast
+// wind. Climb and descent follow ground/planning/balloon_model.h, as in the
+// simulators' synthetic flights. The on-board pieces decide the flight as
+// they would in the air: wind::WindGrid samples the packed grid,
+// geofence::FenceSet gives the margin, and termination::TerminationEngine
+// runs the default rules on it. A cut starts the descent where the balloon
+// is.
+//
+// A member is a risk if it lands within landing_margin_m of a fence
+// violation, is cut for breaching the fence, or drifts off the forecast
+// grid. A candidate's risk is the share of its members that are. It
+// completes its mission if it reaches burst before any cut. Candidates rank
+// by risk, then completion, then the 10th-percentile landing margin.
+// Consecutive acceptable candidates merge into launch windows.
+//
+// Members are independent, and each depends only on (seed, candidate,
+// member). run() spreads them over threads with each thread's own grid
+// readers, and gives the same results on any number of threads.
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "geofence/fence_set.h"
+#include "termination/termination_engine.h"
+#include "wind/wind_grid_format.h"
+
+namespace skyguard::ground {
+
+/// Packed forecast grids (wind_pack output), each covering its own span.
+class ForecastArchive {
+ public:
+  /// Adopts a grid image; false with `*err` set if it does not bind.
+  bool add(std::vector<uint8_t> image, std::string* err);
+
+  size_t size() const { return images_.size(); }
+  const std::vector<uint8_t>& image(size_t i) const { return images_[i]; }
+  const wind::WindGridHeader& header(size_t i) const { return headers_[i]; }
+  /// Index of the grid with the latest start whose times span
+  /// [t0_utc_s, t1_utc_s], or -1.
+  int covering(uint32_t t0_utc_s, uint32_t t1_utc_s) const;
+
+ private:
+  std::vector<std::vector<uint8_t>> images_;
+  std::vector<wind::WindGridHeader> headers_;
+};
+
+struct BalloonProfile {
+  double ascent_mps = 5.0;   // at sea level; the climb speeds up as the air thins
+  double burst_m = 30000;
+  double descent_mps = 5.5;  // under canopy at sea level
+  double launch_alt_m = 100;
+};
+
+/// One-sigma spread of the ensemble members.
+struct PlanSpread {
+  double ascent_frac = 0.08;
+  double burst_m = 1500;
+  double descent_frac = 0.10;
+  double wind_frac = 0.10;  // forecast speed error
+  double wind_ms = 2.0;     // plus a bias per member and component
+};
+
+struct PlanConfig {
+  int32_t launch_lat_e7 = 0;
+  int32_t launch_lon_e7 = 0;
+  uint32_t first_utc_s = 0;
+  uint32_t last_utc_s = 0;
+  uint32_t step_s = 600;  // between candidate launch times
+  uint32_t members = 32;
+  uint64_t seed = 1;
+  double dt_s = 10;  // integration step, also the rule tick
+  BalloonProfile balloon;
+  PlanSpread spread;
+  termination::TerminationLimits limits;
+  float landing_margin_m = 2000;
+};
+
+struct MemberOutcome {
+  int32_t land_lat_e7 = 0;
+  int32_t land_lon_e7 = 0;
+  float land_margin_m = NAN;
+  float min_margin_m = INFINITY;  // along the track
+  float flight_s = 0;
+  int8_t rule = -1;  // rule that cut the flight; -1 for a burst
+  bool fence_cut = false;  // that rule needs a fence breach
+  bool completed = false;
+  bool in_forecast = true;
+  uint32_t steps = 0;
+};
+
+struct CandidateResult {
+  uint32_t launch_utc_s = 0;
+  int forecast = -1;  // archive grid flown; -1: none covers the flight
+  float risk = 1;
+  float completion = 0;
+  float land_margin_p10_m = NAN;
+  float min_margin_p10_m = NAN;
+  int32_t land_lat_e7 = 0;  // median landing point
+  int32_t land_lon_e7 = 0;
+};
+
+struct LaunchWindow {
+  uint32_t first_utc_s;
+  uint32_t last_utc_s;
+  float worst_risk;
+  float worst_land_margin_p10_m;
+};
+
+struct PlanStats {
+  uint64_t flights = 0;
+  uint64_t steps = 0;
+  double wall_s = 0;
+  size_t threads = 0;
+};
+
+class LaunchPlanner {
+ public:
+  /// `archive` and `fences` must outlive the planner; `fences` must be
+  /// bound to a mapped image (paged views are not thread-safe).
+  LaunchPlanner(const ForecastArchive& archive, const geofence::FenceSet& fences,
+                const PlanConfig& config);
+
+  size_t candidates() const;
+  uint32_t candidate_utc_s(size_t i) const { return config_.first_utc_s + i * config_.step_s; }
+
+  /// Flies every member of every candidate; `out` is in candidate order.
+  void run(size_t threads, std::vector<CandidateResult>* out, PlanStats* stats) const;
+
+  /// One candidate's members on the calling thread.
+  CandidateResult evaluate(size_t candidate, std::vector<MemberOutcome>* members = nullptr) const;
+
+ private:
+  struct Readers;
+  CandidateResult evaluate(size_t candidate, Readers& r, std::vector<MemberOutcome>* m) const;
+  MemberOutcome fly(size_t candidate, uint32_t member, int forecast, Readers& r) const;
+
+  const ForecastArchive& archive_;
+  const geofence::FenceSet& fences_;
+  PlanConfig config_;
+};
+
+/// Candidates best first.
+void rank_candidates(std::vector<CandidateResult>* c);
+
+/// Runs of consecutive candidates (in launch order) with risk at most
+/// `max_risk`, best first: lowest worst risk, then widest landing margin.
+std::vector<LaunchWindow> launch_windows(const std::vector<CandidateResult>& by_time,
+                                         uint32_t step_s, float max_risk);
+
+}  // namespace skyguard::ground
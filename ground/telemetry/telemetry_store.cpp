@@ -0,0 +1,576 @@
+#include "ground/telemetry/telemetry_store.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "ground/generated/record_views.h"
+#include "util/crc32.h"
+
+namespace skyguard::ground {
+
+namespace {
+
+using records::StateSnapshotView;
+
+struct LevelDef {
+  uint32_t res_s;     // bucket width
+  uint32_t window_s;  // span of one segment
+  size_t columns;     // per metric: mean, or min, mean, max
+};
+
+constexpr LevelDef kLevels[kTelemetryLevels] = {
+    {1, 900, 1},
+    {60, 6 * 3600, 3},
+    {600, 2 * 86400, 3},
+};
+static_assert(kLevels[0].window_s / kLevels[0].res_s <= 0xFFFF &&
+                  kLevels[1].window_s / kLevels[1].res_s <= 0xFFFF &&
+                  kLevels[2].window_s / kLevels[2].res_s <= 0xFFFF,
+              "bucket indexes are 16 bits");
+
+enum class Metric : uint8_t {
+  kLat,
+  kLon,
+  kAlt,
+  kVelN,
+  kVelE,
+  kVelD,
+  kBaro,
+  kTemp,
+  kFix,
+  kSats,
+  kBattery,
+  kCount
+};
+constexpr size_t kMetricCount = static_cast<size_t>(Metric::kCount);
+
+constexpr const char* kMetricNames[kMetricCount] = {
+    "lat_deg", "lon_deg", "alt_m",  "vel_n_m_s", "vel_e_m_s", "vel_d_m_s",
+    "baro_pa", "temp_c",  "fix",    "sats",      "battery_v",
+};
+
+// Store files: "index" holds a header then fixed entries, one per sealed
+// segment, appended after the segment's bytes; "unit_<id>" holds that
+// unit's segments, every level, back to back.
+constexpr uint8_t kIndexMagic[4] = {'S', 'G', 'T', 'I'};
+constexpr size_t kIndexHeader = 8;  // magic, entry size
+// unit, level, 3 pad, window start, rows, segment offset, CRC-32 of the rest
+constexpr size_t kIndexEntry = 4 + 1 + 3 + 8 + 4 + 8 + 4;
+constexpr uint8_t kSegmentMagic[4] = {'S', 'G', 'T', 'S'};
+// magic, level, metric count, rows; then u16 buckets, u32 counts, and per
+// metric `columns` f32 columns
+constexpr size_t kSegmentHeader = 8;
+
+void put_le(uint64_t v, size_t n, uint8_t* out) {
+  for (size_t i = 0; i < n; ++i) out[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+uint64_t get_le(const uint8_t* p, size_t n) {
+  uint64_t v = 0;
+  for (size_t i = 0; i < n; ++i) v |= static_cast<uint64_t>(p[i]) << (8 * i);
+  return v;
+}
+
+void put_f32(float f, uint8_t* out) {
+  uint32_t bits;
+  memcpy(&bits, &f, sizeof(bits));
+  put_le(bits, 4, out);
+}
+
+float get_f32(const uint8_t* p) {
+  uint32_t bits = static_cast<uint32_t>(get_le(p, 4));
+  float f;
+  memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+int64_t floor_to(int64_t t, int64_t step) {
+  int64_t q = t / step;
+  if (t % step && t < 0) --q;
+  return q * step;
+}
+
+uint64_t segment_size(size_t level, uint32_t rows) {
+  return kSegmentHeader + uint64_t{rows} * (2 + 4 + 4 * kMetricCount * kLevels[level].columns);
+}
+
+// Offset in a segment of column `c` (0 buckets, 1 counts, then the metric
+// columns in order).
+uint64_t column_offset(uint32_t rows, size_t c) {
+  if (c == 0) return kSegmentHeader;
+  return kSegmentHeader + uint64_t{rows} * (2 + 4 + 4 * (c - 2));
+}
+
+void decode_values(const StateSnapshotView& v, float* out) {
+  out[static_cast<size_t>(Metric::kLat)] = static_cast<float>(v.lat_e7() * 1e-7);
+  out[static_cast<size_t>(Metric::kLon)] = static_cast<float>(v.lon_e7() * 1e-7);
+  out[static_cast<size_t>(Metric::kAlt)] = v.alt_mm() / 1000.0f;
+  for (size_t k = 0; k < 3; ++k) {
+    out[static_cast<size_t>(Metric::kVelN) + k] = v.vel_cm_s(k) / 100.0f;
+  }
+  out[static_cast<size_t>(Metric::kBaro)] = v.baro_pa_div4() * 4.0f;
+  out[static_cast<size_t>(Metric::kTemp)] = v.temp_c10() / 10.0f;
+  out[static_cast<size_t>(Metric::kFix)] = v.fix();
+  out[static_cast<size_t>(Metric::kSats)] = v.sats();
+  out[static_cast<size_t>(Metric::kBattery)] =
+      v.has_battery_mv() ? v.battery_mv() / 1000.0f : NAN;
+}
+
+bool pread_all(int fd, uint8_t* out, size_t n, uint64_t at, size_t* bytes) {
+  size_t done = 0;
+  while (done < n) {
+    ssize_t k = ::pread(fd, out + done, n - done, static_cast<off_t>(at + done));
+    if (k <= 0) return false;
+    done += static_cast<size_t>(k);
+  }
+  *bytes += n;
+  return true;
+}
+
+// Merges rows into buckets of `bucket_s`, count-weighting the means.
+std::vector<TsPoint> merge_rows(std::vector<TsPoint>* rows, uint32_t bucket_s) {
+  for (TsPoint& p : *rows) p.t_s = floor_to(p.t_s, bucket_s);
+  std::stable_sort(rows->begin(), rows->end(),
+                   [](const TsPoint& a, const TsPoint& b) { return a.t_s < b.t_s; });
+  std::vector<TsPoint> out;
+  double sum = 0;
+  uint64_t weight = 0;
+  auto finish = [&] {
+    if (!out.empty()) out.back().mean = weight ? static_cast<float>(sum / weight) : NAN;
+  };
+  for (const TsPoint& p : *rows) {
+    if (out.empty() || out.back().t_s != p.t_s) {
+      finish();
+      out.push_back({p.t_s, 0, INFINITY, 0, -INFINITY});
+      sum = 0;
+      weight = 0;
+    }
+    TsPoint& o = out.back();
+    o.count += p.count;
+    if (!isnan(p.mean)) {
+      sum += static_cast<double>(p.mean) * p.count;
+      weight += p.count;
+      o.min = std::min(o.min, p.min);
+      o.max = std::max(o.max, p.max);
+    }
+  }
+  finish();
+  for (TsPoint& o : out) {
+    if (isnan(o.mean)) o.min = o.max = NAN;
+  }
+  return out;
+}
+
+}  // namespace
+
+size_t telemetry_metric_count() { return kMetricCount; }
+
+const char* telemetry_metric_name(size_t metric) {
+  return metric < kMetricCount ? kMetricNames[metric] : nullptr;
+}
+
+int telemetry_metric_index(const std::string& name) {
+  for (size_t i = 0; i < kMetricCount; ++i) {
+    if (name == kMetricNames[i]) return static_cast<int>(i);
+  }
+  return -1;
+}
+
+uint32_t telemetry_level_resolution_s(size_t level) {
+  return level < kTelemetryLevels ? kLevels[level].res_s : 0;
+}
+
+TelemetryStore::~TelemetryStore() {
+  std::string ignored;
+  close(&ignored);
+}
+
+std::string TelemetryStore::unit_path(uint32_t unit) const {
+  return dir_ + "/unit_" + std::to_string(unit);
+}
+
+bool TelemetryStore::open(const std::string& dir, std::string* err) {
+  if (open_ && !close(err)) return false;
+  dir_ = dir;
+  units_.clear();
+  samples_ = sealed_ = bytes_written_ = 0;
+  for (uint64_t& n : late_) n = 0;
+  if (::mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+    *err = "cannot create " + dir;
+    return false;
+  }
+  std::string path = dir + "/index";
+  FILE* f = fopen(path.c_str(), "r+b");
+  if (!f) f = fopen(path.c_str(), "w+b");
+  if (!f) {
+    *err = "cannot open " + path;
+    return false;
+  }
+  uint8_t hdr[kIndexHeader];
+  size_t got = fread(hdr, 1, sizeof(hdr), f);
+  if (got == 0) {
+    memcpy(hdr, kIndexMagic, sizeof(kIndexMagic));
+    put_le(kIndexEntry, 4, hdr + 4);
+    if (fwrite(hdr, 1, sizeof(hdr), f) != sizeof(hdr) || fflush(f) != 0) {
+      fclose(f);
+      *err = "cannot write " + path;
+      return false;
+    }
+  } else if (got != sizeof(hdr) || memcmp(hdr, kIndexMagic, sizeof(kIndexMagic)) != 0 ||
+             get_le(hdr + 4, 4) != kIndexEntry) {
+    fclose(f);
+    *err = path + " is not a telemetry index";
+    return false;
+  }
+
+  // Entries are appended in seal order, so a torn or corrupt entry can only
+  // be the last one written.
+  long good = static_cast<long>(kIndexHeader);
+  bool torn = false;
+  for (;;) {
+    uint8_t e[kIndexEntry];
+    size_t n = fread(e, 1, sizeof(e), f);
+    if (n == 0) break;
+    if (n != sizeof(e) || get_le(e + 28, 4) != crc32(e, 28) || e[4] >= kTelemetryLevels) {
+      torn = true;
+      break;
+    }
+    Unit& u = units_[static_cast<uint32_t>(get_le(e, 4))];
+    size_t level = e[4];
+    Segment s{static_cast<int64_t>(get_le(e + 8, 8)), static_cast<uint32_t>(get_le(e + 16, 4)),
+              get_le(e + 20, 8)};
+    u.index[level].push_back(s);
+    u.file_size = std::max(u.file_size, s.offset + segment_size(level, s.rows));
+    ++sealed_;
+    good += static_cast<long>(sizeof(e));
+  }
+  if (torn && (fflush(f) != 0 || ftruncate(fileno(f), good) != 0)) {
+    fclose(f);
+    *err = "cannot truncate " + path;
+    return false;
+  }
+  fseek(f, good, SEEK_SET);
+  index_ = f;
+
+  // Cut segment bytes sealed after the last good entry; index entries past
+  // the end of their unit file (lost writes) are dropped.
+  for (auto& entry : units_) {
+    Unit& u = entry.second;
+    std::string upath = unit_path(entry.first);
+    struct stat st;
+    uint64_t size = ::stat(upath.c_str(), &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+    if (size < u.file_size) {
+      u.file_size = 0;
+      for (size_t level = 0; level < kTelemetryLevels; ++level) {
+        std::vector<Segment>& idx = u.index[level];
+        idx.erase(std::remove_if(idx.begin(), idx.end(),
+                                 [&](const Segment& s) {
+                                   return s.offset + segment_size(level, s.rows) > size;
+                                 }),
+                  idx.end());
+        for (const Segment& s : idx) {
+          u.file_size = std::max(u.file_size, s.offset + segment_size(level, s.rows));
+        }
+      }
+    }
+    if (size > u.file_size && ::truncate(upath.c_str(), static_cast<off_t>(u.file_size)) != 0) {
+      *err = "cannot truncate " + upath;
+      return false;
+    }
+    for (std::vector<Segment>& idx : u.index) {
+      std::stable_sort(idx.begin(), idx.end(), [](const Segment& a, const Segment& b) {
+        return a.window_t0 < b.window_t0;
+      });
+    }
+  }
+  open_ = true;
+  return true;
+}
+
+bool TelemetryStore::close(std::string* err) {
+  bool ok = !open_ || flush(err);
+  if (index_) fclose(index_);
+  index_ = nullptr;
+  open_ = false;
+  return ok;
+}
+
+bool TelemetryStore::ingest(uint32_t unit, int64_t t_s, const uint8_t* payload, size_t len,
+                            std::string* err) {
+  if (!open_) {
+    *err = "store not open";
+    return false;
+  }
+  StateSnapshotView v;
+  if (!v.bind(payload, len)) {
+    *err = "short StateSnapshot payload (" + std::to_string(len) + " B)";
+    return false;
+  }
+  float values[kMetricCount];
+  decode_values(v, values);
+  Unit& u = units_[unit];
+  for (size_t level = 0; level < kTelemetryLevels; ++level) {
+    const LevelDef& def = kLevels[level];
+    Head& h = u.head[level];
+    int64_t window = floor_to(t_s, def.window_s);
+    if (!h.bucket.empty() && window != h.window_t0) {
+      if (window < h.window_t0) {
+        ++late_[level];
+        continue;
+      }
+      if (!seal(unit, u, level, err)) return false;
+    }
+    if (h.bucket.empty()) h.window_t0 = window;
+    fold(h, level, static_cast<uint32_t>((t_s - window) / def.res_s), values);
+  }
+  ++samples_;
+  return true;
+}
+
+void TelemetryStore::fold(Head& h, size_t level, uint32_t bucket, const float* values) {
+  // Samples normally arrive in order; late ones in the window go in place.
+  size_t row = h.bucket.size();
+  if (row && bucket <= h.bucket.back()) {
+    row = static_cast<size_t>(std::lower_bound(h.bucket.begin(), h.bucket.end(), bucket) -
+                              h.bucket.begin());
+  }
+  bool stats = kLevels[level].columns > 1;
+  if (row == h.bucket.size() || h.bucket[row] != bucket) {
+    auto at = [row](auto& v, size_t width) {
+      return v.begin() + static_cast<ptrdiff_t>(row * width);
+    };
+    h.bucket.insert(at(h.bucket, 1), bucket);
+    h.count.insert(at(h.count, 1), 0u);
+    h.sum.insert(at(h.sum, kMetricCount), kMetricCount, 0.0);
+    h.n.insert(at(h.n, kMetricCount), kMetricCount, 0u);
+    if (stats) {
+      h.min.insert(at(h.min, kMetricCount), kMetricCount, INFINITY);
+      h.max.insert(at(h.max, kMetricCount), kMetricCount, -INFINITY);
+    }
+  }
+  ++h.count[row];
+  size_t base = row * kMetricCount;
+  for (size_t m = 0; m < kMetricCount; ++m) {
+    float x = values[m];
+    if (isnan(x)) continue;
+    h.sum[base + m] += x;
+    ++h.n[base + m];
+    if (stats) {
+      h.min[base + m] = std::min(h.min[base + m], x);
+      h.max[base + m] = std::max(h.max[base + m], x);
+    }
+  }
+}
+
+bool TelemetryStore::seal(uint32_t unit, Unit& u, size_t level, std::string* err) {
+  Head& h = u.head[level];
+  uint32_t rows = static_cast<uint32_t>(h.bucket.size());
+  if (rows == 0) return true;
+  size_t columns = kLevels[level].columns;
+  std::vector<uint8_t> seg(segment_size(level, rows));
+  memcpy(seg.data(), kSegmentMagic, sizeof(kSegmentMagic));
+  seg[4] = static_cast<uint8_t>(level);
+  seg[5] = static_cast<uint8_t>(kMetricCount);
+  put_le(rows, 2, seg.data() + 6);
+  uint8_t* p = seg.data() + kSegmentHeader;
+  for (uint32_t r = 0; r < rows; ++r, p += 2) put_le(h.bucket[r], 2, p);
+  for (uint32_t r = 0; r < rows; ++r, p += 4) put_le(h.count[r], 4, p);
+  for (size_t m = 0; m < kMetricCount; ++m) {
+    for (size_t c = 0; c < columns; ++c) {
+      for (uint32_t r = 0; r < rows; ++r, p += 4) {
+        size_t i = r * kMetricCount + m;
+        float x = NAN;
+        if (h.n[i] && (columns == 1 || c == 1)) {
+          x = static_cast<float>(h.sum[i] / h.n[i]);
+        } else if (h.n[i]) {
+          x = c == 0 ? h.min[i] : h.max[i];
+        }
+        put_f32(x, p);
+      }
+    }
+  }
+
+  // Segment bytes first, then the entry that makes them visible. Writing at
+  // the indexed end rather than appending overwrites any bytes a torn seal
+  // left behind.
+  std::string path = unit_path(unit);
+  FILE* f = fopen(path.c_str(), "r+b");
+  if (!f) f = fopen(path.c_str(), "wb");
+  bool ok = f && fseek(f, static_cast<long>(u.file_size), SEEK_SET) == 0 &&
+            fwrite(seg.data(), 1, seg.size(), f) == seg.size();
+  if (f && fclose(f) != 0) ok = false;
+  uint8_t e[kIndexEntry] = {};
+  put_le(unit, 4, e);
+  e[4] = static_cast<uint8_t>(level);
+  put_le(static_cast<uint64_t>(h.window_t0), 8, e + 8);
+  put_le(rows, 4, e + 16);
+  put_le(u.file_size, 8, e + 20);
+  put_le(crc32(e, 28), 4, e + 28);
+  if (!ok || fwrite(e, 1, sizeof(e), index_) != sizeof(e) || fflush(index_) != 0) {
+    *err = "segment write failed for unit " + std::to_string(unit);
+    return false;
+  }
+
+  // A flushed window sealed again later lands after its first part.
+  std::vector<Segment>& idx = u.index[level];
+  Segment s{h.window_t0, rows, u.file_size};
+  idx.insert(std::upper_bound(idx.begin(), idx.end(), s,
+                              [](const Segment& a, const Segment& b) {
+                                return a.window_t0 < b.window_t0;
+                              }),
+             s);
+  u.file_size += seg.size();
+  bytes_written_ += seg.size() + sizeof(e);
+  ++sealed_;
+  h = Head{};
+  return true;
+}
+
+bool TelemetryStore::flush(std::string* err) {
+  if (!open_) return true;
+  for (auto& entry : units_) {
+    for (size_t level = 0; level < kTelemetryLevels; ++level) {
+      if (!seal(entry.first, entry.second, level, err)) return false;
+    }
+  }
+  return true;
+}
+
+size_t TelemetryStore::pick_level(int64_t t0_s, int64_t t1_s, size_t max_points) const {
+  for (size_t level = 0; level + 1 < kTelemetryLevels; ++level) {
+    uint64_t res = kLevels[level].res_s;
+    if ((static_cast<uint64_t>(t1_s - t0_s) + res - 1) / res <= max_points) return level;
+  }
+  return kTelemetryLevels - 1;
+}
+
+void TelemetryStore::read_level(uint32_t unit, const Unit& u, size_t level, size_t metric,
+                                int64_t t0_s, int64_t t1_s, std::vector<TsPoint>* rows,
+                                TsQueryStats* stats) const {
+  const LevelDef& def = kLevels[level];
+  const std::vector<Segment>& idx = u.index[level];
+  size_t columns = def.columns;
+  // Segments whose window ends after t0, in window order.
+  auto it = std::lower_bound(idx.begin(), idx.end(), t0_s - def.window_s + 1,
+                             [](const Segment& s, int64_t t) { return s.window_t0 < t; });
+  int fd = -1;
+  std::vector<uint8_t> buf;
+  for (; it != idx.end() && it->window_t0 < t1_s; ++it) {
+    const Segment& s = *it;
+    if (fd < 0) fd = ::open(unit_path(unit).c_str(), O_RDONLY);
+    if (fd < 0) break;
+    ++stats->segments;
+    // Bucket column, then just the rows in range of the other columns.
+    buf.resize(size_t{s.rows} * 2);
+    if (!pread_all(fd, buf.data(), buf.size(), s.offset + column_offset(s.rows, 0),
+                   &stats->bytes)) {
+      continue;
+    }
+    auto bucket_at = [&](size_t r) { return static_cast<uint32_t>(get_le(&buf[r * 2], 2)); };
+    // First row at or after bucket b.
+    auto row_of = [&](int64_t b) {
+      size_t lo = 0, hi = s.rows;
+      while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (bucket_at(mid) < b) {
+          lo = mid + 1;
+        } else {
+          hi = mid;
+        }
+      }
+      return lo;
+    };
+    size_t r0 = row_of((t0_s - s.window_t0 + def.res_s - 1) / def.res_s);
+    size_t r1 = row_of((t1_s - s.window_t0 + def.res_s - 1) / def.res_s);
+    if (r0 >= r1) continue;
+    size_t n = r1 - r0;
+    std::vector<uint8_t> counts(n * 4), vals(n * 4 * columns);
+    bool ok = pread_all(fd, counts.data(), counts.size(),
+                        s.offset + column_offset(s.rows, 1) + r0 * 4, &stats->bytes);
+    for (size_t c = 0; ok && c < columns; ++c) {
+      ok = pread_all(fd, vals.data() + c * n * 4, n * 4,
+                     s.offset + column_offset(s.rows, 2 + metric * columns + c) + r0 * 4,
+                     &stats->bytes);
+    }
+    if (!ok) continue;
+    size_t mean_col = columns == 1 ? 0 : 1;
+    for (size_t r = 0; r < n; ++r) {
+      TsPoint p;
+      p.t_s = s.window_t0 + int64_t{bucket_at(r0 + r)} * def.res_s;
+      p.count = static_cast<uint32_t>(get_le(&counts[r * 4], 4));
+      p.mean = get_f32(&vals[(mean_col * n + r) * 4]);
+      p.min = columns == 1 ? p.mean : get_f32(&vals[r * 4]);
+      p.max = columns == 1 ? p.mean : get_f32(&vals[(2 * n + r) * 4]);
+      rows->push_back(p);
+    }
+    stats->rows += n;
+  }
+  if (fd >= 0) ::close(fd);
+
+  const Head& h = u.head[level];
+  for (size_t r = 0; r < h.bucket.size(); ++r) {
+    int64_t t = h.window_t0 + int64_t{h.bucket[r]} * def.res_s;
+    if (t < t0_s || t >= t1_s) continue;
+    size_t i = r * kMetricCount + metric;
+    TsPoint p;
+    p.t_s = t;
+    p.count = h.count[r];
+    p.mean = h.n[i] ? static_cast<float>(h.sum[i] / h.n[i]) : NAN;
+    p.min = columns == 1 || !h.n[i] ? p.mean : h.min[i];
+    p.max = columns == 1 || !h.n[i] ? p.mean : h.max[i];
+    rows->push_back(p);
+    ++stats->rows;
+  }
+}
+
+std::vector<TsPoint> TelemetryStore::query(uint32_t unit, size_t metric, int64_t t0_s,
+                                           int64_t t1_s, size_t max_points,
+                                           TsQueryStats* stats) const {
+  TsQueryStats local;
+  TsQueryStats& st = stats ? *stats : local;
+  st = TsQueryStats{};
+  std::vector<TsPoint> rows;
+  auto it = units_.find(unit);
+  if (it == units_.end() || metric >= kMetricCount || t1_s <= t0_s || max_points == 0) {
+    return rows;
+  }
+  size_t level = pick_level(t0_s, t1_s, max_points);
+  uint64_t res = kLevels[level].res_s;
+  uint64_t want = (static_cast<uint64_t>(t1_s - t0_s) + max_points - 1) / max_points;
+  st.level = level;
+  st.bucket_s = static_cast<uint32_t>(std::max(res, (want + res - 1) / res * res));
+  read_level(unit, it->second, level, metric, t0_s, t1_s, &rows, &st);
+  return merge_rows(&rows, st.bucket_s);
+}
+
+std::vector<TsPoint> TelemetryStore::fleet(size_t metric, int64_t t0_s, int64_t t1_s,
+                                           size_t max_points, TsQueryStats* stats) const {
+  TsQueryStats local;
+  TsQueryStats& st = stats ? *stats : local;
+  st = TsQueryStats{};
+  std::vector<TsPoint> rows;
+  if (metric >= kMetricCount || t1_s <= t0_s || max_points == 0) return rows;
+  size_t level = pick_level(t0_s, t1_s, max_points);
+  uint64_t res = kLevels[level].res_s;
+  uint64_t want = (static_cast<uint64_t>(t1_s - t0_s) + max_points - 1) / max_points;
+  st.level = level;
+  st.bucket_s = static_cast<uint32_t>(std::max(res, (want + res - 1) / res * res));
+  for (const auto& entry : units_) {
+    read_level(entry.first, entry.second, level, metric, t0_s, t1_s, &rows, &st);
+  }
+  return merge_rows(&rows, st.bucket_s);
+}
+
+std::vector<uint32_t> TelemetryStore::units() const {
+  std::vector<uint32_t> out;
+  for (const auto& entry : units_) out.push_back(entry.first);
+  return out;
+}
+
+}  // namespace skyguard::ground
@@ -0,0 +1,128 @@
+// Fleet store for downlinked StateSnapshot telemetry, with rollups.
+//
+// Every sample is folded into three levels of time buckets: 1 s, 1 min and
+// 10 min (count, and min/mean/max per metric; the 1 s level keeps only the
+// mean, since units send at most one snapshot a second). Each unit and
+// level has an open head segment in memory covering one aligned window
+// (15 min, 6 h, 2 days). When a sample lands in a later window the head is
+// sealed: appended to the unit's segment file as columns (bucket index,
+// count, then each metric's columns) and recorded in the time index.
+//
+// A query picks the finest level whose buckets over the range fit in
+// max_points, finds the overlapping segments through the index, reads
+// their bucket column, and then reads only the wanted rows of the wanted
+// metric. So a query touches about max_points rows plus two segments'
+// bucket columns, whatever the zoom. Ranges too long even for the 10 min
+// level read that level and merge it into max_points buckets.
+//
+// Samples older than a level's head window are counted and dropped for
+// that level. Heads are lost if the process dies before they are sealed;
+// flush() seals them early (the server calls it periodically and on
+// shutdown), and later samples in the same window go into a new segment.
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace skyguard::ground {
+
+constexpr size_t kTelemetryLevels = 3;
+
+/// Metric columns: lat and lon (deg), alt (m), velocity north, east and
+/// down (m/s), barometric pressure (Pa), temperature (C), fix, satellites,
+/// battery (V; NaN before StateSnapshot v2).
+size_t telemetry_metric_count();
+const char* telemetry_metric_name(size_t metric);
+int telemetry_metric_index(const std::string& name);
+uint32_t telemetry_level_resolution_s(size_t level);
+
+struct TsPoint {
+  int64_t t_s;  // bucket start
+  uint32_t count;
+  float min, mean, max;
+};
+
+struct TsQueryStats {
+  size_t level = 0;
+  uint32_t bucket_s = 0;  // width of the returned buckets
+  size_t segments = 0;    // sealed segments read
+  size_t rows = 0;        // level rows read, sealed and in memory
+  size_t bytes = 0;       // bytes read from segment files
+};
+
+class TelemetryStore {
+ public:
+  TelemetryStore() = default;
+  TelemetryStore(const TelemetryStore&) = delete;
+  TelemetryStore& operator=(const TelemetryStore&) = delete;
+  ~TelemetryStore();
+
+  /// Opens (creating if absent) the store in directory `dir` and loads its
+  /// index. A torn final index entry is cut off, along with segment bytes
+  /// no entry covers.
+  bool open(const std::string& dir, std::string* err);
+  /// Seals every head, then closes.
+  bool close(std::string* err);
+
+  /// Adds one StateSnapshot payload from `unit` received at `t_s`.
+  bool ingest(uint32_t unit, int64_t t_s, const uint8_t* payload, size_t len, std::string* err);
+  /// Seals every head segment now.
+  bool flush(std::string* err);
+
+  /// One metric for one unit from the level buckets starting in
+  /// [t0_s, t1_s), merged into at most max_points buckets (non-empty ones
+  /// only). Buckets with no value (battery before v2) have a NaN mean.
+  std::vector<TsPoint> query(uint32_t unit, size_t metric, int64_t t0_s, int64_t t1_s,
+                             size_t max_points, TsQueryStats* stats = nullptr) const;
+  /// The same over every unit, merged per bucket.
+  std::vector<TsPoint> fleet(size_t metric, int64_t t0_s, int64_t t1_s, size_t max_points,
+                             TsQueryStats* stats = nullptr) const;
+
+  std::vector<uint32_t> units() const;
+  uint64_t samples() const { return samples_; }
+  uint64_t late(size_t level) const { return late_[level]; }
+  uint64_t sealed_segments() const { return sealed_; }
+  uint64_t bytes_written() const { return bytes_written_; }
+
+ private:
+  struct Segment {
+    int64_t window_t0;
+    uint32_t rows;
+    uint64_t offset;
+  };
+  struct Head {
+    int64_t window_t0 = 0;
+    std::vector<uint32_t> bucket;  // bucket index within the window, ascending
+    std::vector<uint32_t> count;
+    std::vector<float> min, max;   // [row * metrics + m]
+    std::vector<double> sum;
+    std::vector<uint32_t> n;       // non-NaN samples per metric
+  };
+  struct Unit {
+    Head head[kTelemetryLevels];
+    std::vector<Segment> index[kTelemetryLevels];
+    uint64_t file_size = 0;
+  };
+
+  void fold(Head& h, size_t level, uint32_t bucket, const float* values);
+  bool seal(uint32_t unit, Unit& u, size_t level, std::string* err);
+  std::string unit_path(uint32_t unit) const;
+  void read_level(uint32_t unit, const Unit& u, size_t level, size_t metric, int64_t t0_s,
+                  int64_t t1_s, std::vector<TsPoint>* rows, TsQueryStats* stats) const;
+  size_t pick_level(int64_t t0_s, int64_t t1_s, size_t max_points) const;
+
+  std::string dir_;
+  bool open_ = false;
+  FILE* index_ = nullptr;
+  std::map<uint32_t, Unit> units_;
+  uint64_t samples_ = 0;
+  uint64_t late_[kTelemetryLevels] = {};
+  uint64_t sealed_ = 0;
+  uint64_t bytes_written_ = 0;
+};
+
+}  // namespace skyguard::ground
@@ -0,0 +1,53 @@
+#include "ground/telemetry/track_decode.h"
+
+#include <math.h>
+
+#include <algorithm>
+
+#include "ground/generated/record_views.h"
+
+namespace skyguard::ground {
+
+namespace {
+
+bool earlier(const TrackFix& a, uint32_t t) { return a.time_ms < t; }
+
+int32_t lerp(int32_t a, int32_t b, double f) {
+  return a + static_cast<int32_t>(llround(f * (static_cast<double>(b) - a)));
+}
+
+}  // namespace
+
+bool TrackDecoder::add(const uint8_t* payload, size_t len) {
+  records::StateSnapshotView v;
+  if (!v.bind(payload, len) || v.fix() == 0) return false;
+  add({v.time_ms(), v.lat_e7(), v.lon_e7(), v.alt_mm()});
+  return true;
+}
+
+void TrackDecoder::add(const TrackFix& p) {
+  auto it = std::lower_bound(points_.begin(), points_.end(), p.time_ms, earlier);
+  if (it != points_.end() && it->time_ms == p.time_ms) {
+    ++duplicates_;
+    return;
+  }
+  points_.insert(it, p);
+}
+
+bool TrackDecoder::at(uint32_t time_ms, TrackFix* out) const {
+  auto it = std::lower_bound(points_.begin(), points_.end(), time_ms, earlier);
+  if (it == points_.end()) return false;
+  if (it->time_ms == time_ms) {
+    *out = *it;
+    return true;
+  }
+  if (it == points_.begin()) return false;
+  const TrackFix& a = *(it - 1);
+  const TrackFix& b = *it;
+  double f = static_cast<double>(time_ms - a.time_ms) / static_cast<double>(b.time_ms - a.time_ms);
+  *out = {time_ms, lerp(a.lat_e7, b.lat_e7, f), lerp(a.lon_e7, b.lon_e7, f),
+          lerp(a.alt_mm, b.alt_mm, f)};
+  return true;
+}
+
+}  // namespace skyguard::ground
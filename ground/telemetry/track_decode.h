@@ -0,0 +1,45 @@
+// Flight track from significance-reported StateSnapshots
+// (firmware/telemetry/track_compressor.h).
+//
+// The unit reports a position only when the track bends past its
+// tolerance, so the track between two reports is the straight line
+// between them: every fix the unit had in between is within the
+// tolerance it was reported at. Reports arrive over several links and out
+// of order; they are kept sorted by unit time, and the copy of one point
+// that came over a second link is dropped.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+namespace skyguard::ground {
+
+struct TrackFix {
+  uint32_t time_ms;  // unit time
+  int32_t lat_e7;
+  int32_t lon_e7;
+  int32_t alt_mm;
+};
+
+class TrackDecoder {
+ public:
+  /// Adds one StateSnapshot payload. Returns false if it is too short or
+  /// has no fix; true for a duplicate.
+  bool add(const uint8_t* payload, size_t len);
+  void add(const TrackFix& p);
+
+  /// Position at unit time `time_ms`, interpolated between the reports
+  /// around it. False outside the reported span.
+  bool at(uint32_t time_ms, TrackFix* out) const;
+
+  const std::vector<TrackFix>& points() const { return points_; }
+  size_t duplicates() const { return duplicates_; }
+
+ private:
+  std::vector<TrackFix> points_;
+  size_t duplicates_ = 0;
+};
+
+}  // namespace skyguard::ground
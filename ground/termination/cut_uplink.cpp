@@ -0,0 +1,30 @@
+#include "ground/termination/cut_uplink.h"
+
+#include "generated/records.h"
+#include "ground/generated/record_views.h"
+#include "util/siphash.h"
+
+namespace skyguard::ground {
+
+size_t sign_cut_command(const termination::CutKey& key, uint32_t unit_id, uint32_t counter,
+                        uint8_t action, uint8_t* out, size_t cap) {
+  records::CutCommand cmd{unit_id, counter, action, 0};
+  if (cmd.encode(out, cap) == 0) return 0;
+  cmd.tag = siphash24(key.bytes, out, records::CutCommand::kOffset_tag);
+  return cmd.encode(out, cap);
+}
+
+bool read_cut_ack(const uint8_t* payload, size_t len, CutAckInfo* out) {
+  records::CutAckView v;
+  if (!v.bind(payload, len)) return false;
+  *out = {v.time_ms(),
+          v.counter(),
+          static_cast<termination::CutResult>(v.result()),
+          static_cast<termination::BurnState>(v.burn_state()),
+          v.auth_us(),
+          v.gate_us(),
+          v.current_us()};
+  return true;
+}
+
+}  // namespace skyguard::ground
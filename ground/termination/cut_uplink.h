@@ -0,0 +1,36 @@
+// Ground side of the remote cut (firmware/termination/cut_fast_path.h):
+// signs CutCommands and reads the unit's CutAck.
+//
+// The counter must grow with every command sent to a unit, across
+// sessions and ground stations, or the unit drops the command as a
+// replay; keep it with the unit's key. Resend the same signed command, not
+// a new counter, until a CutAck for it arrives.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "termination/cut_fast_path.h"
+
+namespace skyguard::ground {
+
+/// Encodes and signs a CutCommand payload (records::CutCommand). Returns
+/// its length, or 0 if `cap` is too small.
+size_t sign_cut_command(const termination::CutKey& key, uint32_t unit_id, uint32_t counter,
+                        uint8_t action, uint8_t* out, size_t cap);
+
+struct CutAckInfo {
+  uint32_t time_ms;  // unit time the ACK was queued
+  uint32_t counter;
+  termination::CutResult result;
+  termination::BurnState burn;
+  // Microseconds from the end of the command frame; 0 if not reached.
+  uint32_t auth_us;
+  uint32_t gate_us;
+  uint32_t current_us;
+};
+
+/// Reads a CutAck payload.
+bool read_cut_ack(const uint8_t* payload, size_t len, CutAckInfo* out);
+
+}  // namespace skyguard::ground
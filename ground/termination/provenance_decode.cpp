@@ -0,0 +1,143 @@
+#include "ground/termination/provenance_decode.h"
+
+#include <math.h>
+#include <stdio.h>
+
+#include <algorithm>
+
+namespace skyguard::ground {
+
+namespace {
+
+using termination::kConditionCount;
+using termination::kConditionNames;
+using termination::kProvenanceFields;
+
+class BitReader {
+ public:
+  BitReader(const uint8_t* p, size_t n) : p_(p), n_(n) {}
+
+  bool get(unsigned bits, uint32_t* v) {
+    if (pos_ + bits > n_ * 8) return false;
+    uint64_t out = 0;
+    for (unsigned i = 0; i < bits; ++i, ++pos_) {
+      out |= static_cast<uint64_t>(p_[pos_ >> 3] >> (pos_ & 7) & 1) << i;
+    }
+    *v = static_cast<uint32_t>(out);
+    return true;
+  }
+
+ private:
+  const uint8_t* p_;
+  size_t n_;
+  size_t pos_ = 0;
+};
+
+double field_value(size_t i, uint32_t raw) {
+  const termination::ProvenanceField& f = kProvenanceFields[i];
+  if (f.is_signed && raw == termination::provenance_unknown(f)) return NAN;
+  double v = raw;
+  if (f.is_signed && (raw >> (f.bits - 1) & 1)) v -= static_cast<double>(1ull << f.bits);
+  return v * f.scale;
+}
+
+void append_value(std::string* s, size_t i, double v) {
+  char buf[64];
+  if (isnan(v)) {
+    snprintf(buf, sizeof(buf), "%s=unknown", kProvenanceFields[i].name);
+  } else {
+    snprintf(buf, sizeof(buf), "%s=%.0f%s", kProvenanceFields[i].name, v,
+             kProvenanceFields[i].unit);
+  }
+  *s += buf;
+}
+
+}  // namespace
+
+bool decode_provenance(const uint8_t* data, size_t len, DecisionTimeline* out, std::string* err) {
+  DecisionStep prev{};
+  bool have_time = !out->steps.empty();
+  if (have_time) prev = out->steps.back();
+  for (size_t off = 0; off < len;) {
+    size_t n = data[off];
+    if (n < 2 || off + n > len) {
+      *err = "bad entry length at byte " + std::to_string(off);
+      return false;
+    }
+    BitReader r(data + off + 1, n - 1);
+    uint32_t absolute = 0, time = 0, conditions = 0, changed = 0, decided = 0;
+    bool ok = r.get(1, &absolute) && r.get(absolute ? 32 : 16, &time) &&
+              r.get(kConditionCount, &conditions) && r.get(kConditionCount, &changed) &&
+              r.get(1, &decided);
+    uint32_t rule = 0, rule_mask = 0;
+    if (ok && decided) ok = r.get(4, &rule) && r.get(kConditionCount, &rule_mask);
+    DecisionStep s = prev;
+    s.carried = 0;
+    uint16_t values = static_cast<uint16_t>(changed | rule_mask);
+    for (size_t i = 0; ok && i < kConditionCount; ++i) {
+      if (!(values >> i & 1)) continue;
+      uint32_t raw = 0;
+      if (kProvenanceFields[i].bits) ok = r.get(kProvenanceFields[i].bits, &raw);
+      s.values[i] = kProvenanceFields[i].bits ? field_value(i, raw) : (conditions >> i & 1);
+      s.carried = static_cast<uint16_t>(s.carried | 1u << i);
+    }
+    if (!ok) {
+      *err = "entry at byte " + std::to_string(off) + " is truncated";
+      return false;
+    }
+    off += n;
+    out->bytes += n;
+    if (!absolute && !have_time) {
+      ++out->skipped;
+      continue;
+    }
+    s.time_ms = absolute ? time : prev.time_ms + time;
+    s.conditions = static_cast<uint16_t>(conditions);
+    s.changed = static_cast<uint16_t>(changed);
+    s.rule = decided ? static_cast<int>(rule) : -1;
+    s.rule_mask = static_cast<uint16_t>(rule_mask);
+    s.known = static_cast<uint16_t>(prev.known | s.carried);
+    out->steps.push_back(s);
+    prev = s;
+    have_time = true;
+  }
+  return true;
+}
+
+uint16_t conditions_at(const DecisionTimeline& tl, uint32_t time_ms) {
+  auto it = std::upper_bound(tl.steps.begin(), tl.steps.end(), time_ms,
+                             [](uint32_t t, const DecisionStep& s) { return t < s.time_ms; });
+  return it == tl.steps.begin() ? 0 : std::prev(it)->conditions;
+}
+
+std::string format_step(const DecisionStep& s) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%10.3f s", s.time_ms / 1000.0);
+  std::string line = buf;
+  for (size_t i = 0; i < kConditionCount; ++i) {
+    if (!(s.changed >> i & 1)) continue;
+    line += (s.conditions >> i & 1) ? " +" : " -";
+    line += kConditionNames[i];
+    if (kProvenanceFields[i].bits) {
+      line += '(';
+      append_value(&line, i, s.values[i]);
+      line += ')';
+    }
+  }
+  if (s.rule >= 0) {
+    snprintf(buf, sizeof(buf), "  CUT by rule %d:", s.rule);
+    line += buf;
+    for (size_t i = 0; i < kConditionCount; ++i) {
+      if (!(s.rule_mask >> i & 1)) continue;
+      line += ' ';
+      if (kProvenanceFields[i].bits) {
+        append_value(&line, i, s.values[i]);
+      } else {
+        line += kConditionNames[i];
+      }
+    }
+  }
+  return line;
+}
+
+}  // namespace skyguard::ground
@@ -0,0 +1,49 @@
+// Decision timeline from downlinked or log-dumped provenance entries
+// (firmware/termination/provenance_format.h).
+//
+// Each entry becomes one step: absolute time, the condition state after
+// it, what changed, the deciding rule if any, and every input value known
+// so far (the one carried by this entry, or the last one that was). The
+// condition state between steps is the state of the step before.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "termination/provenance_format.h"
+
+namespace skyguard::ground {
+
+struct DecisionStep {
+  uint32_t time_ms;
+  uint16_t conditions;
+  uint16_t changed;
+  int rule;  // -1 unless the cut was decided on this step
+  uint16_t rule_mask;
+  uint16_t carried;  // conditions whose value came in this entry
+  uint16_t known;    // conditions with a value so far
+  double values[termination::kConditionCount];  // in the field's unit; NaN if unknown
+};
+
+struct DecisionTimeline {
+  std::vector<DecisionStep> steps;
+  size_t bytes = 0;
+  /// Entries before the first absolute one, whose time is unknown.
+  size_t skipped = 0;
+};
+
+/// Decodes back-to-back entries, appending to `out`. Fails on a length
+/// byte that is short for its content or runs past the end.
+bool decode_provenance(const uint8_t* data, size_t len, DecisionTimeline* out, std::string* err);
+
+/// Condition state at `time_ms` (0 before the first step).
+uint16_t conditions_at(const DecisionTimeline& tl, uint32_t time_ms);
+
+/// One line per step: time, changes (+set, -cleared) with their inputs,
+/// and the decision with the values of the rule's conditions.
+std::string format_step(const DecisionStep& s);
+
+}  // namespace skyguard::ground
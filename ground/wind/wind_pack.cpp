@@ -0,0 +1,237 @@
+#include "ground/wind/wind_pack.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+
+#include "util/crc32.h"
+#include "wind/wind_grid.h"
+
+namespace skyguard::ground {
+
+namespace {
+
+using wind::kWindTile;
+using wind::kWindTilePoints;
+
+struct Row {
+  double t, alt, lat, lon, u, v;
+};
+
+// Sorted unique values; returns false unless they are evenly spaced.
+bool regular_axis(std::vector<double> values, double scale, std::vector<int64_t>* axis) {
+  axis->clear();
+  for (double v : values) axis->push_back(llround(v * scale));
+  std::sort(axis->begin(), axis->end());
+  axis->erase(std::unique(axis->begin(), axis->end()), axis->end());
+  for (size_t i = 2; i < axis->size(); ++i) {
+    int64_t step = (*axis)[1] - (*axis)[0];
+    if (llabs((*axis)[i] - (*axis)[i - 1] - step) > 1) return false;
+  }
+  return true;
+}
+
+void put_varint(uint32_t v, std::vector<uint8_t>* out) {
+  while (v >= 0x80) {
+    out->push_back(static_cast<uint8_t>(v | 0x80));
+    v >>= 7;
+  }
+  out->push_back(static_cast<uint8_t>(v));
+}
+
+template <typename T>
+void append(const T& value, std::vector<uint8_t>* out) {
+  const uint8_t* p = reinterpret_cast<const uint8_t*>(&value);
+  out->insert(out->end(), p, p + sizeof(T));
+}
+
+}  // namespace
+
+bool parse_wind_csv(const std::string& text, WindForecast* out, std::string* err) {
+  std::vector<Row> rows;
+  size_t line_no = 0;
+  for (size_t pos = 0; pos < text.size();) {
+    size_t end = text.find('\n', pos);
+    if (end == std::string::npos) end = text.size();
+    std::string line = text.substr(pos, end - pos);
+    pos = end + 1;
+    ++line_no;
+    if (line.empty() || line[0] == '#' || line == "\r") continue;
+    double f[6];
+    const char* p = line.c_str();
+    int n = 0;
+    for (; n < 6; ++n) {
+      char* q;
+      f[n] = strtod(p, &q);
+      if (q == p) break;
+      p = q;
+      if (n < 5) {
+        if (*p != ',') break;
+        ++p;
+      }
+    }
+    if (n < 6) {
+      if (rows.empty() && line_no == 1) continue;  // header
+      *err = "line " + std::to_string(line_no) + ": expected six numbers";
+      return false;
+    }
+    rows.push_back({f[0], f[1], f[2], f[3], f[4], f[5]});
+  }
+  if (rows.empty()) {
+    *err = "no grid points";
+    return false;
+  }
+
+  std::vector<double> ts, alts, lats, lons;
+  for (const Row& r : rows) {
+    ts.push_back(r.t);
+    alts.push_back(r.alt);
+    lats.push_back(r.lat);
+    lons.push_back(r.lon);
+  }
+  std::vector<int64_t> t_axis, l_axis, y_axis, x_axis;
+  regular_axis(alts, 1, &l_axis);
+  if (!regular_axis(ts, 1, &t_axis) || !regular_axis(lats, 1e7, &y_axis) ||
+      !regular_axis(lons, 1e7, &x_axis)) {
+    *err = "times, latitudes and longitudes must be evenly spaced";
+    return false;
+  }
+  if (y_axis.size() < 2 || x_axis.size() < 2 || l_axis.size() > wind::kMaxWindLevels ||
+      t_axis.size() > 0xFFFF || y_axis.size() > 0xFFFF || x_axis.size() > 0xFFFF) {
+    *err = "grid needs 2+ latitudes and longitudes and at most " +
+           std::to_string(wind::kMaxWindLevels) + " levels";
+    return false;
+  }
+  if (rows.size() != t_axis.size() * l_axis.size() * y_axis.size() * x_axis.size()) {
+    *err = "grid is incomplete or has duplicate points";
+    return false;
+  }
+
+  WindForecast& w = *out;
+  w.t0_utc_s = static_cast<uint32_t>(t_axis[0]);
+  w.dt_s = t_axis.size() > 1 ? static_cast<uint32_t>(t_axis[1] - t_axis[0]) : 0;
+  w.lat0_e7 = static_cast<int32_t>(y_axis[0]);
+  w.lon0_e7 = static_cast<int32_t>(x_axis[0]);
+  w.dlat_e7 = static_cast<uint32_t>(y_axis[1] - y_axis[0]);
+  w.dlon_e7 = static_cast<uint32_t>(x_axis[1] - x_axis[0]);
+  w.n_times = static_cast<uint32_t>(t_axis.size());
+  w.n_lat = static_cast<uint32_t>(y_axis.size());
+  w.n_lon = static_cast<uint32_t>(x_axis.size());
+  w.levels_m.assign(l_axis.begin(), l_axis.end());
+  w.u_ms.assign(rows.size(), NAN);
+  w.v_ms.assign(rows.size(), NAN);
+
+  auto find = [](const std::vector<int64_t>& axis, int64_t v) {
+    return static_cast<uint32_t>(std::lower_bound(axis.begin(), axis.end(), v - 1) - axis.begin());
+  };
+  for (const Row& r : rows) {
+    size_t i = w.index(find(t_axis, llround(r.t)), find(l_axis, llround(r.alt)),
+                       find(y_axis, llround(r.lat * 1e7)), find(x_axis, llround(r.lon * 1e7)));
+    if (!isnan(w.u_ms[i])) {
+      *err = "duplicate grid point";
+      return false;
+    }
+    w.u_ms[i] = static_cast<float>(r.u);
+    w.v_ms[i] = static_cast<float>(r.v);
+  }
+  return true;
+}
+
+bool pack_wind_grid(const WindForecast& f, float unit_ms, std::vector<uint8_t>* image,
+                    WindPackStats* stats, std::string* err) {
+  const uint32_t n_levels = static_cast<uint32_t>(f.levels_m.size());
+  if (n_levels == 0 || n_levels > wind::kMaxWindLevels || f.n_lat < 2 || f.n_lon < 2 ||
+      f.n_times == 0 || (f.n_times > 1 && f.dt_s == 0) || !(unit_ms > 0)) {
+    *err = "forecast grid is empty or malformed";
+    return false;
+  }
+  const uint32_t tiles_lat = wind::wind_tiles(f.n_lat), tiles_lon = wind::wind_tiles(f.n_lon);
+  const uint32_t n_blocks = f.n_times * n_levels * tiles_lat * tiles_lon;
+  *stats = WindPackStats{};
+  stats->blocks = n_blocks;
+  stats->raw_bytes = f.n_times * n_levels * f.n_lat * f.n_lon * 4;
+
+  std::vector<uint8_t> blocks;
+  std::vector<uint32_t> offsets;
+  int16_t tile[2 * kWindTilePoints], check[2 * kWindTilePoints];
+  for (uint32_t t = 0; t < f.n_times; ++t) {
+    for (uint32_t l = 0; l < n_levels; ++l) {
+      for (uint32_t ty = 0; ty < tiles_lat; ++ty) {
+        for (uint32_t tx = 0; tx < tiles_lon; ++tx) {
+          for (uint32_t i = 0; i < kWindTilePoints; ++i) {
+            // Edge tiles repeat the last row / column.
+            uint32_t y = std::min(ty * kWindTile + i / kWindTile, f.n_lat - 1);
+            uint32_t x = std::min(tx * kWindTile + i % kWindTile, f.n_lon - 1);
+            for (int plane = 0; plane < 2; ++plane) {
+              float value = (plane ? f.v_ms : f.u_ms)[f.index(t, l, y, x)];
+              long q = lroundf(value / unit_ms);
+              if (!(fabsf(value) < 1e6f) || q < -32768 || q > 32767) {
+                *err = "wind value does not fit the quantisation unit";
+                return false;
+              }
+              tile[plane * kWindTilePoints + i] = static_cast<int16_t>(q);
+              stats->max_quant_error_ms =
+                  std::max(stats->max_quant_error_ms, fabs(q * double(unit_ms) - value));
+            }
+          }
+          size_t start = blocks.size();
+          offsets.push_back(static_cast<uint32_t>(start));
+          for (int plane = 0; plane < 2; ++plane) {
+            const int16_t* p = tile + plane * kWindTilePoints;
+            for (uint32_t i = 0; i < kWindTilePoints; ++i) {
+              uint32_t x = i % kWindTile, y = i / kWindTile;
+              int32_t w = x ? p[i - 1] : 0;
+              int32_t s = y ? p[i - kWindTile] : 0;
+              int32_t sw = x && y ? p[i - kWindTile - 1] : 0;
+              int32_t r = p[i] - (w + s - sw);
+              put_varint((static_cast<uint32_t>(r) << 1) ^ static_cast<uint32_t>(r >> 31),
+                         &blocks);
+            }
+          }
+          // Round-trip through the on-board decoder.
+          if (!wind::wind_decode_block(blocks.data() + start,
+                                       static_cast<uint32_t>(blocks.size() - start), check) ||
+              memcmp(check, tile, sizeof(tile)) != 0) {
+            *err = "block failed to decode";
+            return false;
+          }
+        }
+      }
+    }
+  }
+
+  wind::WindGridHeader h{};
+  h.magic = wind::kWindMagic;
+  h.version = wind::kWindFormatVersion;
+  h.n_levels = static_cast<uint16_t>(n_levels);
+  h.t0_utc_s = f.t0_utc_s;
+  h.dt_s = f.dt_s;
+  h.lat0_e7 = f.lat0_e7;
+  h.lon0_e7 = f.lon0_e7;
+  h.dlat_e7 = f.dlat_e7;
+  h.dlon_e7 = f.dlon_e7;
+  h.n_lat = static_cast<uint16_t>(f.n_lat);
+  h.n_lon = static_cast<uint16_t>(f.n_lon);
+  h.n_times = static_cast<uint16_t>(f.n_times);
+  h.unit_ms = unit_ms;
+  const uint32_t blocks_start =
+      static_cast<uint32_t>(sizeof(h) + 4 * n_levels + 4 * (n_blocks + 1));
+
+  image->clear();
+  append(h, image);
+  for (int32_t level : f.levels_m) append(level, image);
+  offsets.push_back(static_cast<uint32_t>(blocks.size()));
+  for (uint32_t off : offsets) append(blocks_start + off, image);
+  image->insert(image->end(), blocks.begin(), blocks.end());
+
+  wind::WindGridHeader* out = reinterpret_cast<wind::WindGridHeader*>(image->data());
+  out->image_size = static_cast<uint32_t>(image->size());
+  out->crc32 = crc32(image->data() + sizeof(h), image->size() - sizeof(h));
+  stats->image_bytes = out->image_size;
+  return true;
+}
+
+}  // namespace skyguard::ground
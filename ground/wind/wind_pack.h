@@ -0,0 +1,46 @@
+// Packs a regional wind forecast into the on-board grid image
+// (firmware/wind/wind_grid_format.h) for upload before launch.
+//
+// Input CSV, one row per grid point, header line optional:
+//   time_utc_s,alt_m,lat_deg,lon_deg,u_ms,v_ms
+// The points must form a complete regular grid: evenly spaced times,
+// latitudes and longitudes, and any ascending set of altitudes.
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+namespace skyguard::ground {
+
+struct WindForecast {
+  uint32_t t0_utc_s = 0;
+  uint32_t dt_s = 0;
+  int32_t lat0_e7 = 0, lon0_e7 = 0;
+  uint32_t dlat_e7 = 0, dlon_e7 = 0;
+  uint32_t n_times = 0, n_lat = 0, n_lon = 0;
+  std::vector<int32_t> levels_m;
+  // Indexed [((time * levels + level) * n_lat + lat) * n_lon + lon].
+  std::vector<float> u_ms, v_ms;
+
+  size_t index(uint32_t t, uint32_t l, uint32_t y, uint32_t x) const {
+    return ((static_cast<size_t>(t) * levels_m.size() + l) * n_lat + y) * n_lon + x;
+  }
+};
+
+struct WindPackStats {
+  uint32_t blocks = 0;
+  uint32_t raw_bytes = 0;  // int16 u and v per point, uncompressed
+  uint32_t image_bytes = 0;
+  double max_quant_error_ms = 0;
+};
+
+bool parse_wind_csv(const std::string& text, WindForecast* out, std::string* err);
+
+/// Quantises to `unit_ms` (0.1 m/s keeps jet-stream speeds in int16 with
+/// margin) and compresses. Fails if a value does not fit the quantisation.
+bool pack_wind_grid(const WindForecast& forecast, float unit_ms, std::vector<uint8_t>* image,
+                    WindPackStats* stats, std::string* err);
+
+}  // namespace skyguard::ground
@@ -0,0 +1,373 @@
+// ADS-B traffic table under busy terminal airspace.
+//
+//   adsb_traffic_bench [aircraft] [seed]
+//
+// Synthesizes two minutes of SBS-1 output from a receiver near a busy
+// airport: arrivals and departures on the runway axis and overflights
+// within 250 km, each sending positions twice a second and velocity,
+// altitude and ident messages until they land, plus corrupt and overlong
+// lines. A balloon climbs through the traffic near the approach path.
+//
+// The feed runs through traffic::SbsParser and TrackTable at its own
+// timestamps with a 10 Hz tick. Each tick the balloon's "clear airspace"
+// query, and a query around a random aircraft, are checked against a brute
+// force search of every aircraft's last report. The balloon query covers
+// all aircraft; the random one covers those the table holds. The feed is
+// then written to a file and replayed through board::AdsbUart at 921600
+// baud with hal::host::UartFileFeed. Reports host ingest and query costs
+// against the feed's message rate and the UART line rate.
+//
+// Exits 1 on a query mismatch, or if host ingest is less than kMinHeadroom
+// times a saturated 921600 baud line.
+
+#define SKYGUARD_HAL_HOST
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "geofence/fence_format.h"
+#include "hal/board.h"
+#include "traffic/sbs_parser.h"
+#include "traffic/track_table.h"
+
+using namespace skyguard;
+using namespace skyguard::traffic;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using geofence::kMetresPerLatE7;
+
+constexpr uint32_t kTickMs = 100;
+constexpr uint32_t kDurationMs = 120000;
+constexpr uint32_t kFastBaud = 921600;
+constexpr double kMinHeadroom = 20;  // host vs a saturated line, for MCU speed
+constexpr int32_t kAirportLat = 397000000;
+constexpr int32_t kAirportLon = -1047000000;
+constexpr uint32_t kClearRadiusM = 5000;
+constexpr int32_t kClearAboveM = 1000;
+
+struct Line {
+  uint32_t t_ms;
+  std::string text;
+};
+
+struct Aircraft {
+  uint32_t icao;
+  double x_m, y_m, alt_m;  // east and north of the airport
+  double vx, vy, vz;
+};
+
+int32_t lat_of(double y_m) { return kAirportLat + static_cast<int32_t>(y_m / kMetresPerLatE7); }
+int32_t lon_of(double x_m) {
+  float lon_m = kMetresPerLatE7 * cosf(static_cast<float>(kAirportLat) * 1e-7f * 0.017453293f);
+  return kAirportLon + static_cast<int32_t>(x_m / lon_m);
+}
+
+std::string deg(int32_t e7) {
+  char buf[24];
+  snprintf(buf, sizeof(buf), "%s%d.%07d", e7 < 0 ? "-" : "", abs(e7) / 10000000,
+           abs(e7) % 10000000);
+  return buf;
+}
+
+std::string sbs(int type, uint32_t icao, const std::string& alt, const std::string& lat,
+                const std::string& lon, const std::string& extra = "") {
+  char head[96];
+  snprintf(head, sizeof(head), "MSG,%d,1,1,%06X,1,2026/10/18,12:00:00.000,2026/10/18,"
+           "12:00:00.000,", type, icao);
+  return std::string(head) + extra + "," + alt + ",,," + lat + "," + lon + ",,,0,0,0,0\r\n";
+}
+
+std::vector<Line> synth_feed(size_t n, std::mt19937& rng) {
+  std::uniform_real_distribution<double> u(0, 1);
+  std::vector<Aircraft> fleet;
+  for (size_t i = 0; i < n; ++i) {
+    Aircraft a{};
+    a.icao = 0xA00000 + static_cast<uint32_t>(i) * 37;
+    double kind = u(rng);
+    if (kind < 0.35) {
+      // Approach or departure along the 080 runway axis, within 60 km.
+      double r = (u(rng) * 2 - 1) * 60000, dir = u(rng) < 0.5 ? 1 : -1;
+      double ax = cos(10 * M_PI / 180), ay = sin(10 * M_PI / 180);
+      a.x_m = r * ax + (u(rng) - 0.5) * 2000;
+      a.y_m = r * ay + (u(rng) - 0.5) * 2000;
+      a.alt_m = 300 + fabs(r) * 0.052;
+      double v = 70 + 60 * u(rng);
+      a.vx = dir * v * ax;
+      a.vy = dir * v * ay;
+      a.vz = (r * dir < 0 ? -1 : 1) * v * 0.052;
+    } else {
+      double r = 250000 * sqrt(u(rng)), th = 2 * M_PI * u(rng), hd = 2 * M_PI * u(rng);
+      a.x_m = r * cos(th);
+      a.y_m = r * sin(th);
+      a.alt_m = kind < 0.6 ? 3000 + 6000 * u(rng) : 9000 + 3500 * u(rng);
+      double v = 120 + 130 * u(rng);
+      a.vx = v * cos(hd);
+      a.vy = v * sin(hd);
+    }
+    fleet.push_back(a);
+  }
+
+  std::vector<Line> out;
+  std::vector<uint32_t> next_pos(n), next_slow(n);
+  for (size_t i = 0; i < n; ++i) {
+    next_pos[i] = static_cast<uint32_t>(u(rng) * 500);
+    next_slow[i] = static_cast<uint32_t>(u(rng) * 1000);
+  }
+  for (uint32_t t = 0; t < kDurationMs; t += 10) {
+    for (size_t i = 0; i < n; ++i) {
+      Aircraft& a = fleet[i];
+      a.x_m += a.vx * 0.01;
+      a.y_m += a.vy * 0.01;
+      a.alt_m = std::max(300.0, a.alt_m + a.vz * 0.01);
+      if (a.alt_m <= 300 && a.vz < 0) continue;  // landed; ages out of the table
+      std::string alt = std::to_string(static_cast<int>(a.alt_m / 0.3048 / 25) * 25);
+      if (t >= next_pos[i]) {
+        next_pos[i] = t + 400 + static_cast<uint32_t>(u(rng) * 200);
+        out.push_back({t, sbs(3, a.icao, alt, deg(lat_of(a.y_m)), deg(lon_of(a.x_m)))});
+      }
+      if (t >= next_slow[i]) {
+        next_slow[i] = t + 900 + static_cast<uint32_t>(u(rng) * 200);
+        out.push_back({t, sbs(4, a.icao, "", "", "")});
+        out.push_back({t, sbs(5, a.icao, alt, "", "")});
+        if (u(rng) < 0.2) out.push_back({t, sbs(1, a.icao, "", "", "", "UAL123")});
+      }
+    }
+    if (u(rng) < 0.05) {
+      std::string bad = sbs(3, 0xBAD000, "9000", "39.5", "-104.9");
+      out.push_back({t, bad.substr(0, static_cast<size_t>(u(rng) * 40)) + "\r\n"});
+    }
+    if (u(rng) < 0.005) out.push_back({t, std::string(400, 'X') + "\n"});
+  }
+  return out;
+}
+
+struct RefTrack {
+  AdsbReport last;
+  uint32_t heard_ms;
+};
+
+/// Brute force over the reference; `only` limits it to tracked aircraft.
+bool ref_clear(const std::unordered_map<uint32_t, RefTrack>& ref, const AirspaceQuery& q,
+               uint32_t now_ms, const TrackTable* only, uint32_t* nearest) {
+  float lon_m = kMetresPerLatE7 * cosf(static_cast<float>(q.lat_e7) * 1e-7f * 0.017453293f);
+  if (lon_m < 0.1f * kMetresPerLatE7) lon_m = 0.1f * kMetresPerLatE7;
+  float best = INFINITY, r = static_cast<float>(q.radius_m);
+  for (const auto& [icao, t] : ref) {
+    if (!t.last.has_position || now_ms - t.heard_ms > kTrackMaxAgeMs) continue;
+    if (only && !only->find(icao)) continue;
+    if (t.last.has_altitude && (t.last.alt_m < q.floor_m || t.last.alt_m > q.ceiling_m)) continue;
+    float dy = static_cast<float>(t.last.lat_e7 - q.lat_e7) * kMetresPerLatE7;
+    float dx = static_cast<float>(static_cast<int64_t>(t.last.lon_e7) - q.lon_e7) * lon_m;
+    float d2 = dx * dx + dy * dy;
+    if (d2 <= r * r && d2 < best) best = d2;
+  }
+  *nearest = isinf(best) ? kNoTraffic : static_cast<uint32_t>(sqrtf(best));
+  return isinf(best);
+}
+
+template <class Fn>
+double best_seconds(int reps, Fn fn) {
+  double best = 1e30;
+  for (int i = 0; i < reps; ++i) {
+    auto t0 = Clock::now();
+    fn();
+    best = std::min(best, std::chrono::duration<double>(Clock::now() - t0).count());
+  }
+  return best;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t n_aircraft = argc > 1 ? static_cast<size_t>(atol(argv[1])) : 400;
+  uint32_t seed = argc > 2 ? static_cast<uint32_t>(atol(argv[2])) : 1;
+  std::mt19937 rng(seed);
+  std::vector<Line> feed = synth_feed(n_aircraft, rng);
+  size_t feed_bytes = 0;
+  for (const Line& l : feed) feed_bytes += l.text.size();
+  double feed_rate = feed.size() / (kDurationMs / 1000.0);
+  double line_rate = kFastBaud / 10.0 / (static_cast<double>(feed_bytes) / feed.size());
+  printf("feed: %zu aircraft, %zu lines in %u s (%.0f lines/s, %.0f B/s, %.0f B/line); "
+         "%u baud carries %.0f lines/s\n",
+         n_aircraft, feed.size(), kDurationMs / 1000, feed_rate, feed_bytes / (kDurationMs / 1e3),
+         static_cast<double>(feed_bytes) / feed.size(), kFastBaud, line_rate);
+
+  // Timestamped run with checks.
+  SbsParser parser;
+  TrackTable table;
+  table.set_reference(kAirportLat);
+  std::unordered_map<uint32_t, RefTrack> ref;
+  size_t next = 0, queries = 0, mismatches = 0, not_clear = 0, max_tracks = 0;
+  std::uniform_real_distribution<double> u(0, 1);
+  for (uint32_t now = 0; now < kDurationMs; now += kTickMs) {
+    for (; next < feed.size() && feed[next].t_ms < now + kTickMs; ++next) {
+      uint32_t t = feed[next].t_ms;
+      for (char c : feed[next].text) {
+        AdsbReport r;
+        if (!parser.push(static_cast<uint8_t>(c), &r)) continue;
+        table.update(r, t);
+        RefTrack& rt = ref[r.icao];
+        rt.heard_ms = t;
+        if (r.has_position) {
+          rt.last.lat_e7 = r.lat_e7;
+          rt.last.lon_e7 = r.lon_e7;
+          rt.last.has_position = true;
+        }
+        if (r.has_altitude) {
+          rt.last.alt_m = r.alt_m;
+          rt.last.has_altitude = true;
+        }
+      }
+    }
+    uint32_t t = now + kTickMs - 1;
+    table.expire(t);
+    max_tracks = std::max(max_tracks, table.size());
+
+    // Balloon 15 km out, just over 5 km off the approach, climbing through the
+    // layers.
+    AirspaceQuery q{lat_of(-8000), lon_of(-15000), kClearRadiusM, INT32_MIN,
+                    static_cast<int32_t>(500 + now / 10) + kClearAboveM};
+    table.set_focus(q.lat_e7, q.lon_e7);
+    uint32_t got_m, want_m;
+    bool got = table.clear(q, t, &got_m), want = ref_clear(ref, q, t, nullptr, &want_m);
+    not_clear += !want;
+    if (got != want || got_m != want_m) ++mismatches;
+
+    // Somewhere busy, through the spatial index only.
+    auto it = std::next(ref.begin(), static_cast<long>(rng() % ref.size()));
+    AirspaceQuery r{it->second.last.lat_e7, it->second.last.lon_e7,
+                    static_cast<uint32_t>(1000 + 30000 * u(rng)),
+                    static_cast<int32_t>(u(rng) * 6000),
+                    static_cast<int32_t>(6000 + u(rng) * 8000)};
+    got = table.clear(r, t, &got_m);
+    want = ref_clear(ref, r, t, &table, &want_m);
+    if (got != want || got_m != want_m) ++mismatches;
+    queries += 2;
+  }
+  printf("checked: %zu queries, %zu mismatches; balloon not clear on %zu ticks; tracks max %zu "
+         "of %zu, %u evicted, %u ignored (farther than every track), %u expired\n",
+         queries, mismatches, not_clear, max_tracks, kMaxTracks, table.evicted(), table.ignored(),
+         table.expired());
+  printf("parser: %u lines, %u rejected\n", parser.lines(), parser.rejected());
+
+  // Host cost.
+  std::string all;
+  for (const Line& l : feed) all += l.text;
+  volatile uint32_t sink = 0;
+  double parse_s = best_seconds(5, [&] {
+    SbsParser p;
+    AdsbReport r;
+    uint32_t k = 0;
+    for (char c : all) k += p.push(static_cast<uint8_t>(c), &r);
+    sink = k;
+  });
+  double ingest_s = best_seconds(5, [&] {
+    SbsParser p;
+    TrackTable tt;
+    tt.set_reference(kAirportLat);
+    tt.set_focus(lat_of(-8000), lon_of(-15000));
+    AdsbReport r;
+    uint32_t last_expire = 0;
+    for (const Line& l : feed) {
+      if (l.t_ms - last_expire >= 1000) {
+        tt.expire(l.t_ms);
+        last_expire = l.t_ms;
+      }
+      for (char c : l.text) {
+        if (p.push(static_cast<uint8_t>(c), &r)) tt.update(r, l.t_ms);
+      }
+    }
+    sink = static_cast<uint32_t>(tt.size());
+  });
+  AirspaceQuery qb{lat_of(-8000), lon_of(-15000), kClearRadiusM, INT32_MIN, 12000};
+  AirspaceQuery qw{kAirportLat, kAirportLon, 30000, INT32_MIN, INT32_MAX};
+  const size_t kQueries = 200000;
+  double qb_s = best_seconds(5, [&] {
+    uint32_t k = 0;
+    for (size_t i = 0; i < kQueries; ++i) k += table.clear(qb, kDurationMs - 1);
+    sink = k;
+  });
+  double qw_s = best_seconds(5, [&] {
+    uint32_t k = 0;
+    for (size_t i = 0; i < kQueries; ++i) k += table.clear(qw, kDurationMs - 1);
+    sink = k;
+  });
+  double ingest_rate = feed.size() / ingest_s;
+  printf("host: parse %.0f ns/line (%.0f MB/s), parse+track %.0f ns/line (%.2f M lines/s), "
+         "%.1fx the feed, %.1fx a saturated %u baud line\n",
+         parse_s * 1e9 / feed.size(), all.size() / parse_s / 1e6, ingest_s * 1e9 / feed.size(),
+         ingest_rate / 1e6, ingest_rate / feed_rate, ingest_rate / line_rate, kFastBaud);
+  printf("host: clear() %.0f ns for %u m, %.0f ns for 30 km over the airport\n",
+         qb_s * 1e9 / kQueries, kClearRadiusM, qw_s * 1e9 / kQueries);
+
+  // The same feed from a file through the host UART.
+  char path[] = "/tmp/adsb_feed_XXXXXX";
+  int fd = mkstemp(path);
+  if (fd < 0 || write(fd, all.data(), all.size()) != static_cast<ssize_t>(all.size())) {
+    fprintf(stderr, "cannot write %s\n", path);
+    return 2;
+  }
+  close(fd);
+  hal::host::UartFileFeed file_feed;
+  board::AdsbUart uart;
+  uart.begin(kFastBaud);
+  if (!file_feed.open(path, board::kUartAdsb, kFastBaud)) {
+    fprintf(stderr, "cannot open %s\n", path);
+    return 2;
+  }
+  SbsParser up;
+  TrackTable ut;
+  ut.set_reference(kAirportLat);
+  ut.set_focus(lat_of(-8000), lon_of(-15000));
+  uint32_t reports = 0, ticks = 0;
+  size_t max_backlog = 0;
+  hal::host::g_now_us = 0;
+  while (file_feed.pump()) {
+    hal::host::clock_advance_us(kTickMs * 1000);
+    file_feed.pump();
+    uint32_t now = static_cast<uint32_t>(hal::host::g_now_us / 1000);
+    max_backlog = std::max(max_backlog, hal::host::g_uart[board::kUartAdsb].rx.size());
+    uint8_t buf[256];
+    AdsbReport r;
+    for (size_t n; (n = uart.read(buf, sizeof(buf))) > 0;) {
+      for (size_t i = 0; i < n; ++i) {
+        if (!up.push(buf[i], &r)) continue;
+        ut.update(r, now);
+        ++reports;
+      }
+    }
+    ut.expire(now);
+    ++ticks;
+  }
+  unlink(path);
+  printf("uart replay: %llu bytes in %.1f s at %u baud, %u reports, %zu B max per tick, "
+         "%zu tracks at the end\n",
+         static_cast<unsigned long long>(file_feed.sent()), ticks * kTickMs / 1000.0, kFastBaud,
+         reports, max_backlog, ut.size());
+
+  int failures = 0;
+  if (mismatches) {
+    fprintf(stderr, "%zu query mismatches\n", mismatches);
+    ++failures;
+  }
+  if (ingest_rate < kMinHeadroom * line_rate) {
+    fprintf(stderr, "ingest %.0f lines/s under %.0fx the line rate\n", ingest_rate, kMinHeadroom);
+    ++failures;
+  }
+  if (!reports || up.lines() == 0) {
+    fprintf(stderr, "uart replay produced no reports\n");
+    ++failures;
+  }
+  printf("failures %d\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,179 @@
+// Host driver for the APRS beacon path.
+//
+//   aprs_wav encode <out.wav> [sample_rate]   build a beacon, write AFSK audio
+//   aprs_wav decode <in.wav>                  demodulate and print frames
+//
+// `encode` also reports the time to format, frame and HDLC-encode a beacon,
+// and pushes the samples through AfskDmaStreamer with a fake DMA channel so
+// the WAV holds exactly what the DAC would see.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "aprs/afsk.h"
+#include "aprs/aprs_format.h"
+#include "aprs/ax25.h"
+#include "ground/aprs/afsk_demod.h"
+#include "sim/wav_file.h"
+
+using namespace skyguard;
+
+namespace {
+
+constexpr uint16_t kDacMax = 4095;
+constexpr size_t kDmaHalf = 128;
+
+struct Beacon {
+  uint8_t frame[aprs::kAx25MaxFrameLen];
+  size_t frame_len;
+  uint8_t symbols[(aprs::ax25_hdlc_max_symbols(aprs::kAx25MaxFrameLen, 64) + 7) / 8];
+  size_t n_symbols;
+};
+
+bool build_beacon(Beacon& b) {
+  const aprs::Ax25Address dest{"APZSKY", 0};
+  const aprs::Ax25Address src{"N0CALL", 11};
+  const aprs::Ax25Address path[] = {{"WIDE2", 1}};
+
+  aprs::AprsPosition pos{};
+  pos.lat_e7 = 402345678;
+  pos.lon_e7 = -1054321098;
+  pos.altitude_m = 27432;
+  pos.has_time = true;
+  pos.hour = 17;
+  pos.minute = 4;
+  pos.second = 33;
+  pos.comment = "SkyGuard";
+  char info[aprs::kAx25MaxInfoLen];
+  size_t info_len = aprs::aprs_format_position(pos, info, sizeof(info));
+  if (info_len == 0) return false;
+
+  b.frame_len = aprs::ax25_build_ui_frame(
+      dest, src, path, 1, reinterpret_cast<const uint8_t*>(info), info_len,
+      b.frame, sizeof(b.frame));
+  if (b.frame_len == 0) return false;
+  b.n_symbols = aprs::ax25_encode_hdlc(b.frame, b.frame_len, 32, 4, b.symbols,
+                                       sizeof(b.symbols) * 8);
+  return b.n_symbols != 0;
+}
+
+struct FakeDma {
+  const uint16_t* buf = nullptr;
+  size_t n = 0;
+  bool running = false;
+};
+
+void fake_start(void* ctx, const uint16_t* buf, size_t n) {
+  auto* d = static_cast<FakeDma*>(ctx);
+  d->buf = buf;
+  d->n = n;
+  d->running = true;
+}
+
+void fake_stop(void* ctx) { static_cast<FakeDma*>(ctx)->running = false; }
+
+std::string format_address(const uint8_t* a) {
+  std::string s;
+  for (int i = 0; i < 6; ++i) {
+    char c = static_cast<char>(a[i] >> 1);
+    if (c != ' ') s += c;
+  }
+  int ssid = (a[6] >> 1) & 0x0F;
+  if (ssid) s += "-" + std::to_string(ssid);
+  return s;
+}
+
+// TNC2 monitor format: SRC>DEST,PATH:info
+std::string format_tnc2(const std::vector<uint8_t>& f) {
+  size_t off = 0;
+  std::vector<std::string> addrs;
+  while (off + 7 <= f.size()) {
+    addrs.push_back(format_address(&f[off]));
+    bool last = f[off + 6] & 1;
+    off += 7;
+    if (last) break;
+  }
+  if (addrs.size() < 2 || off + 2 > f.size()) return "<malformed>";
+  std::string s = addrs[1] + ">" + addrs[0];
+  for (size_t i = 2; i < addrs.size(); ++i) s += "," + addrs[i];
+  s += ":";
+  s.append(f.begin() + off + 2, f.end());
+  return s;
+}
+
+int cmd_encode(const char* path, uint32_t sample_rate) {
+  static Beacon b;
+  constexpr int kIters = 20000;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < kIters; ++i) {
+    if (!build_beacon(b)) {
+      fprintf(stderr, "beacon build failed\n");
+      return 1;
+    }
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  double us = std::chrono::duration<double, std::micro>(t1 - t0).count() / kIters;
+  printf("frame: %zu bytes, %zu symbols, build %.2f us\n", b.frame_len,
+         b.n_symbols, us);
+
+  aprs::AfskModulator mod;
+  mod.init(sample_rate, kDacMax);
+  FakeDma dma;
+  aprs::AfskDmaPort port{fake_start, fake_stop, &dma};
+  static uint16_t dma_buf[2 * kDmaHalf];
+  aprs::AfskDmaStreamer streamer(mod, port, dma_buf, kDmaHalf);
+
+  std::vector<int16_t> pcm;
+  auto emit = [&](size_t from, size_t n) {
+    for (size_t i = from; i < from + n; ++i) {
+      pcm.push_back(static_cast<int16_t>((dma_buf[i] - kDacMax / 2) * 8));
+    }
+  };
+  streamer.transmit(b.symbols, b.n_symbols);
+  while (dma.running) {
+    emit(0, kDmaHalf);
+    streamer.on_half_transfer();
+    if (!dma.running) break;
+    emit(kDmaHalf, kDmaHalf);
+    streamer.on_transfer_complete();
+  }
+  if (!sim::write_wav(path, sample_rate, pcm)) {
+    fprintf(stderr, "cannot write %s\n", path);
+    return 1;
+  }
+  printf("wrote %zu samples at %u Hz to %s\n", pcm.size(), sample_rate, path);
+  return 0;
+}
+
+int cmd_decode(const char* path) {
+  uint32_t rate = 0;
+  std::vector<int16_t> pcm;
+  if (!sim::read_wav(path, &rate, &pcm)) {
+    fprintf(stderr, "cannot read %s (16-bit mono PCM expected)\n", path);
+    return 1;
+  }
+  std::vector<float> x(pcm.begin(), pcm.end());
+  ground::AfskDemodulator demod(rate);
+  demod.process(x.data(), x.size());
+  for (const auto& f : demod.frames()) printf("%s\n", format_tnc2(f).c_str());
+  printf("%zu frame(s), %zu FCS error(s)\n", demod.frames().size(),
+         demod.crc_errors());
+  return demod.frames().empty() ? 2 : 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc >= 3 && strcmp(argv[1], "encode") == 0) {
+    uint32_t rate = argc >= 4 ? static_cast<uint32_t>(atoi(argv[3])) : 26400;
+    return cmd_encode(argv[2], rate);
+  }
+  if (argc >= 3 && strcmp(argv[1], "decode") == 0) return cmd_decode(argv[2]);
+  fprintf(stderr, "usage: %s encode <out.wav> [rate] | decode <in.wav>\n", argv[0]);
+  return 1;
+}
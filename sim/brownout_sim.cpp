@@ -0,0 +1,368 @@
+// Power cuts against the brown-out vault on the host config flash.
+//
+//   brownout_sim [trials] [seed]
+//
+// Runs one device through many power cycles. Each boot recovers the newest
+// vault record and re-arms; in flight the supply warning fires (sometimes
+// a spurious one the supply rides out first, sometimes twice before the
+// vault is re-armed) and the supply then dies after a random delay of up
+// to twice the nominal holdup time. Flash programs are charged their
+// worst-case time; the cut finishes the units already due, leaves the one
+// in progress with a random part of its bits programmed and fails
+// everything after. The payload is a StateSnapshot checkpoint plus as many
+// of the newest staged Event records as the budget allows.
+//
+// Finally the same flash goes behind an app::FlightSystem: a warning after
+// a fix saves its checkpoint and a staged log, and the next FlightSystem
+// has to boot at the saved position with the log in the vault's record.
+//
+// Exits 1 if a recovered record differs from what was flushed under its
+// sequence number, if a cut that came after the worst-case flush time
+// lost the new record, or if the FlightSystem round trip fails.
+
+#define SKYGUARD_HAL_HOST
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "app/flight_system.h"
+#include "generated/records.h"
+#include "hal/board.h"
+#include "storage/brownout_vault.h"
+
+using namespace skyguard;
+using storage::BrownoutVault;
+using storage::VaultSpan;
+namespace host = skyguard::hal::host;
+
+namespace {
+
+// 470 uF bulk capacitance from the 2.9 V warning down to 1.8 V at 250 mW.
+constexpr uint32_t kHoldupUs = storage::holdup_us(470, 2900, 1800, 250);
+constexpr uint32_t kCrcNsPerByte = 20;
+constexpr uint32_t kFirstSector = 16;
+constexpr uint32_t kSlotSectors = 2;
+constexpr uint8_t kSlots = 2;
+constexpr size_t kStagedMax = 32;
+
+std::mt19937 g_rng;
+
+// Power model, driven from the flash hook.
+uint64_t g_now_us = 0;
+uint64_t g_cut_us = UINT64_MAX;  // supply gone at this time
+bool g_dead = false;
+
+uint32_t rand_below(uint32_t n) { return n ? g_rng() % n : 0; }
+
+bool before_write(uint32_t addr, const uint8_t* data, size_t n) {
+  if (g_dead) return false;
+  if (!data) return true;  // erases only run from the main loop
+  host::FlashRegion& r = host::g_flash[0];
+  const uint32_t unit = board::ConfigFlash::kProgramUnit;
+  const uint32_t unit_us = board::ConfigFlash::kProgramUnitMaxUs;
+  uint64_t units = (n + unit - 1) / unit;
+  if (g_now_us + units * unit_us <= g_cut_us) {
+    g_now_us += units * unit_us;
+    return true;
+  }
+  // Finish the units that were due, tear the next one.
+  uint64_t done = (g_cut_us - g_now_us) / unit_us;
+  size_t k = static_cast<size_t>(done * unit);
+  for (size_t i = 0; i < k; ++i) r.bytes[addr + i] &= data[i];
+  for (size_t i = k; i < n && i < k + unit; ++i) {
+    uint8_t clear = r.bytes[addr + i] & static_cast<uint8_t>(~data[i]);
+    r.bytes[addr + i] &= static_cast<uint8_t>(~(clear & rand_below(256)));
+  }
+  g_now_us = g_cut_us;
+  g_dead = true;
+  return false;
+}
+
+// What the flight software would hand to the vault.
+struct Source {
+  uint8_t checkpoint[records::StateSnapshot::kEncodedSize];
+  uint8_t staged[kStagedMax * records::Event::kEncodedSize];
+  size_t n_staged = 0;
+  std::vector<uint8_t> expected;  // payload the last collect() asked for
+  size_t events_saved = 0;
+
+  void fly() {
+    for (uint8_t& b : checkpoint) b = static_cast<uint8_t>(g_rng());
+    n_staged = rand_below(kStagedMax + 1);
+    for (size_t i = 0; i < n_staged * records::Event::kEncodedSize; ++i) {
+      staged[i] = static_cast<uint8_t>(g_rng());
+    }
+  }
+
+  static void append(std::vector<uint8_t>* out, const VaultSpan& s) {
+    out->insert(out->end(), {s.type, s.version, static_cast<uint8_t>(s.len),
+                             static_cast<uint8_t>(s.len >> 8)});
+    out->insert(out->end(), s.data, s.data + s.len);
+  }
+
+  static size_t collect(void* ctx, VaultSpan* spans, size_t max, uint32_t budget) {
+    Source& src = *static_cast<Source*>(ctx);
+    constexpr size_t kEv = records::Event::kEncodedSize;
+    size_t n = 0;
+    src.expected.clear();
+    spans[n++] = {records::StateSnapshot::kId, records::StateSnapshot::kVersion,
+                  src.checkpoint, sizeof(src.checkpoint)};
+    uint32_t used = storage::kVaultEntryHeader + sizeof(src.checkpoint);
+    size_t fit = used + storage::kVaultEntryHeader < budget
+                     ? (budget - used - storage::kVaultEntryHeader) / kEv
+                     : 0;
+    size_t k = src.n_staged < fit ? src.n_staged : fit;
+    if (k && n < max) {
+      spans[n++] = {records::Event::kId, records::Event::kVersion,
+                    src.staged + (src.n_staged - k) * kEv, static_cast<uint16_t>(k * kEv)};
+    }
+    for (size_t i = 0; i < n; ++i) append(&src.expected, spans[i]);
+    src.events_saved = k;
+    return n;
+  }
+};
+
+// Ports for a FlightSystem that never transmits or cuts.
+void no_gate(void*, uint8_t, bool) {}
+bool disarmed(void*) { return false; }
+bool no_submit(void*, const telemetry::SgFrame&) { return false; }
+#if SKYGUARD_HAS_APRS
+void no_dma_start(void*, const uint16_t*, size_t) {}
+void no_dma_stop(void*) {}
+#endif
+
+app::FlightPorts flight_ports(const storage::VaultFlash& vf, uint32_t budget,
+                              const storage::VaultSource& log) {
+  app::FlightPorts ports{};
+  ports.burn = {no_gate, disarmed, nullptr};
+  ports.vault = vf;
+  ports.vault_budget = budget;
+  ports.vault_log = log;
+#if SKYGUARD_HAS_LORA
+  ports.lora = {no_submit, nullptr};
+#endif
+#if SKYGUARD_HAS_IRIDIUM
+  ports.iridium = {no_submit, nullptr};
+#endif
+#if SKYGUARD_HAS_APRS
+  ports.afsk = {no_dma_start, no_dma_stop, nullptr};
+  ports.afsk_sample_rate = 26400;
+  ports.afsk_out_max = 4095;
+  ports.aprs_source = {"N0CALL", 11};
+#endif
+  return ports;
+}
+
+// The platform's staged log: a few Event records not yet written out.
+struct StagedLog {
+  uint8_t events[3 * records::Event::kEncodedSize];
+
+  static size_t collect(void* ctx, VaultSpan* spans, size_t max, uint32_t budget) {
+    auto* log = static_cast<StagedLog*>(ctx);
+    if (!max || storage::kVaultEntryHeader + sizeof(log->events) > budget) return 0;
+    spans[0] = {records::Event::kId, records::Event::kVersion, log->events,
+                static_cast<uint16_t>(sizeof(log->events))};
+    return 1;
+  }
+};
+
+// Warning in flight, then a boot; returns the number of failures.
+uint32_t flight_system_round_trip(const storage::VaultFlash& vf, uint32_t budget) {
+  g_dead = false;
+  g_cut_us = UINT64_MAX;
+  StagedLog log;
+  for (uint8_t& b : log.events) b = static_cast<uint8_t>(g_rng());
+  storage::VaultSource vs{StagedLog::collect, &log};
+  app::GpsFix fix{};
+  fix.lat_e7 = 452000000 + static_cast<int32_t>(rand_below(1000000));
+  fix.lon_e7 = 25000000 + static_cast<int32_t>(rand_below(1000000));
+  fix.alt_mm = 20000000 + static_cast<int32_t>(rand_below(10000000));
+  fix.fix = 3;
+  fix.sats = 9;
+
+  uint32_t failures = 0;
+  {
+    std::unique_ptr<app::FlightSystem> fs(new app::FlightSystem(flight_ports(vf, budget, vs)));
+    uint32_t now_ms = 0;
+    // The vault re-arms one sector per tick.
+    for (int i = 0; i < 64 && fs->vault().state() != storage::VaultState::kArmed; ++i) {
+      fix.time_ms = now_ms;
+      fs->on_gps_fix(0, fix);
+      fs->tick(now_ms);
+      now_ms += 50;
+    }
+    if (!fs->on_supply_warning()) {
+      fprintf(stderr, "flight system: the supply warning saved nothing\n");
+      return 1;
+    }
+  }
+  storage::VaultSource none{};
+  std::unique_ptr<app::FlightSystem> fs(new app::FlightSystem(flight_ports(vf, budget, none)));
+  const records::StateSnapshot& st = fs->state();
+  if (!fs->recovered() || st.lat_e7 != fix.lat_e7 || st.lon_e7 != fix.lon_e7 ||
+      st.alt_mm != fix.alt_mm) {
+    fprintf(stderr, "flight system: boot did not restore the checkpoint\n");
+    ++failures;
+  }
+  std::vector<uint8_t> got(fs->vault().record_len());
+  fs->vault().read_record(0, got.data(), got.size());
+  uint32_t off = 0;
+  VaultSpan s;
+  bool staged = false;
+  while (BrownoutVault::next_entry(got.data(), static_cast<uint32_t>(got.size()), &off, &s)) {
+    staged |= s.type == records::Event::kId && s.len == sizeof(log.events) &&
+              memcmp(s.data, log.events, s.len) == 0;
+  }
+  if (!staged) {
+    fprintf(stderr, "flight system: the staged log is not in the record\n");
+    ++failures;
+  }
+  printf("flight system: checkpoint %s, staged log %s\n", failures ? "lost" : "restored",
+         staged ? "saved" : "lost");
+  return failures;
+}
+
+struct Stats {
+  uint32_t boots = 0;
+  uint32_t recovered_new = 0;   // the record of the last flush attempt
+  uint32_t recovered_old = 0;   // an earlier one: torn flush or missed warning
+  uint32_t committed = 0;
+  uint32_t torn = 0;            // cut before the commit
+  uint32_t late_cuts = 0;       // cut after the worst case
+  uint32_t spurious = 0;
+  uint64_t events_saved = 0;
+  uint32_t failures = 0;
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  uint32_t trials = argc > 1 ? static_cast<uint32_t>(atol(argv[1])) : 2000;
+  g_rng.seed(argc > 2 ? static_cast<uint32_t>(atol(argv[2])) : 1);
+
+  board::ConfigFlash flash;
+  host::g_flash[0].before_write = before_write;
+  storage::VaultFlash vf = storage::vault_flash_of(flash, kFirstSector, kSlotSectors, kSlots);
+
+  BrownoutVault probe;
+  probe.begin(vf);
+  uint32_t budget = probe.budget_for_us(kHoldupUs, kCrcNsPerByte);
+  probe.set_payload_budget(budget);
+  uint32_t worst_us = probe.worst_case_us(kCrcNsPerByte);
+  printf("holdup %u us, payload budget %u B, worst-case flush %u us (%u program units)\n",
+         kHoldupUs, budget, worst_us,
+         (budget + storage::kVaultHeaderSize) / board::ConfigFlash::kProgramUnit);
+
+  std::map<uint32_t, std::vector<uint8_t>> flushed;  // by sequence number
+  uint32_t newest = 0;   // newest sequence known to be committed
+  uint32_t must = 0;     // the record a boot has to find
+  uint32_t attempted = 0;  // sequence of the flush the cut hit
+  Source src;
+  Stats st;
+  storage::VaultSource vs{Source::collect, &src};
+  uint32_t missed = 0;
+
+  for (uint32_t t = 0; t <= trials; ++t) {
+    // Boot.
+    g_dead = false;
+    g_cut_us = UINT64_MAX;
+    ++st.boots;
+    BrownoutVault vault;
+    if (!vault.begin(vf)) {
+      fprintf(stderr, "begin failed\n");
+      return 2;
+    }
+    vault.set_payload_budget(budget);
+    if (vault.has_record()) {
+      uint32_t seq = vault.record_seq();
+      std::vector<uint8_t> got(vault.record_len());
+      vault.read_record(0, got.data(), got.size());
+      auto it = flushed.find(seq);
+      if (it == flushed.end() || it->second != got) {
+        fprintf(stderr, "boot %u: record %u does not match what was flushed\n", st.boots, seq);
+        ++st.failures;
+      }
+      uint32_t off = 0;
+      VaultSpan s;
+      while (BrownoutVault::next_entry(got.data(), static_cast<uint32_t>(got.size()), &off, &s)) {
+      }
+      if (off != got.size()) {
+        fprintf(stderr, "boot %u: record %u does not parse\n", st.boots, seq);
+        ++st.failures;
+      }
+      if (seq < must) {
+        fprintf(stderr, "boot %u: found record %u, expected %u\n", st.boots, seq, must);
+        ++st.failures;
+      }
+      if (t > 0) ++(seq == attempted ? st.recovered_new : st.recovered_old);
+      newest = seq;
+    } else if (must) {
+      fprintf(stderr, "boot %u: no record, expected %u\n", st.boots, must);
+      ++st.failures;
+    }
+    if (t == trials) break;
+    uint32_t next = vault.has_record() ? vault.record_seq() + 1 : 1;
+    while (!vault.service()) {
+    }
+
+    // Flight, with an optional spurious warning.
+    src.fly();
+    if (rand_below(4) == 0) {
+      ++st.spurious;
+      vault.on_brownout(vs);
+      flushed[next] = src.expected;
+      newest = next++;
+      src.fly();
+      if (rand_below(3)) {
+        while (!vault.service()) {
+        }
+      }
+    }
+
+    // The warning that is followed by the cut.
+    uint32_t delay = rand_below(2 * kHoldupUs + 1);
+    g_cut_us = g_now_us + delay;
+    bool armed = vault.state() == storage::VaultState::kArmed;
+    bool ok = vault.on_brownout(vs);
+    missed += vault.missed_warnings();
+    must = newest;
+    attempted = armed ? next : 0;
+    if (armed) {
+      flushed[next] = src.expected;  // compared only if it committed
+      if (ok) {
+        must = next;
+        ++st.committed;
+        st.events_saved += src.events_saved;
+      } else {
+        ++st.torn;
+      }
+      if (delay >= worst_us) {
+        ++st.late_cuts;
+        if (!ok) {
+          fprintf(stderr, "trial %u: cut at %u us lost a flush with %u us worst case\n", t,
+                  delay, worst_us);
+          ++st.failures;
+        }
+      }
+    }
+    g_dead = true;
+    g_now_us += 1000000;
+  }
+
+  host::FlashRegion& r = host::g_flash[0];
+  printf("%u boots: %u recovered the record of the last flush, %u an earlier one\n",
+         st.boots, st.recovered_new, st.recovered_old);
+  printf("torn flushes %u, cuts after the worst case %u, spurious warnings %u, missed %u\n",
+         st.torn, st.late_cuts, st.spurious, missed);
+  printf("events saved per committed flush %.1f (staged up to %zu)\n",
+         st.committed ? double(st.events_saved) / st.committed : 0.0, kStagedMax);
+  printf("flash: %u programs, %u sector erases\n", r.programs, r.erases);
+  st.failures += flight_system_round_trip(vf, budget);
+  printf("failures %u\n", st.failures);
+  return st.failures ? 1 : 0;
+}
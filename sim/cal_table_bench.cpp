@@ -0,0 +1,215 @@
+// Thermistor lookup tables against the exact Steinhart-Hart formula.
+//
+//   cal_table_bench [iterations]
+//
+// Compares the compile-time nominal table with std::log evaluation at every
+// ADC code, then stores per-unit ThermistorCal records in the host config
+// flash (a superseded one, the current one and a torn one after it), loads
+// the newest valid record and checks the RAM table it builds the same way.
+// Also checks that shorted, open and out-of-range codes are rejected, and
+// reports the host cost of a conversion by table, by float logf and by
+// double log.
+//
+// Exits 1 if a table is off by more than kMaxSpanErrC10 in the operating
+// span or kMaxErrC10 elsewhere in its range (the curve is steepest at the
+// ends), rejects a code whose temperature is inside the operating span, or
+// accepts a code outside the table range.
+
+#define SKYGUARD_HAL_HOST
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "generated/records.h"
+#include "hal/board.h"
+#include "sensors/cal_store.h"
+#include "sensors/thermistor.h"
+
+using namespace skyguard;
+using namespace skyguard::sensors;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr double kMaxSpanErrC10 = 1.0;  // one output step
+constexpr double kMaxErrC10 = 2.0;
+constexpr uint32_t kCalBase = 8 * 2048;
+constexpr uint32_t kCalSize = 2048;
+
+double exact_c10(const ThermistorModel& m, double code) {
+  constexpr double kCodes = kThermistorAdcFullScale + 1.0;
+  if (code <= 0 || code >= kCodes) return NAN;
+  double ln_r = log(m.r_fixed_ohm * code / (kCodes - code));
+  return (1.0 / (m.sh_a + m.sh_b * ln_r + m.sh_c * ln_r * ln_r * ln_r) - 273.15) * 10.0;
+}
+
+float float_c10(const ThermistorModel& m, uint16_t code) {
+  constexpr float kCodes = kThermistorAdcFullScale + 1.0f;
+  float ln_r = logf(static_cast<float>(m.r_fixed_ohm) * code / (kCodes - code));
+  float inv_t = static_cast<float>(m.sh_a) + static_cast<float>(m.sh_b) * ln_r +
+                static_cast<float>(m.sh_c) * ln_r * ln_r * ln_r;
+  return (1.0f / inv_t - 273.15f) * 10.0f;
+}
+
+int check_table(const char* name, const Thermistor& th, const ThermistorModel& m) {
+  const ThermistorTable& t = th.table();
+  double max_err = 0, max_span_err = 0;
+  uint16_t worst = 0;
+  uint32_t rejected_inside = 0, accepted_outside = 0;
+  for (uint32_t code = 0; code <= kThermistorAdcFullScale; ++code) {
+    double want = exact_c10(m, code);
+    int16_t got = 0;
+    bool ok = th.to_c10(static_cast<uint16_t>(code), &got);
+    bool in_span = want >= kThermistorOperatingMinC10 && want <= kThermistorOperatingMaxC10;
+    bool in_range = want >= kThermistorMinC10 && want <= kThermistorMaxC10;
+    if (!ok) {
+      rejected_inside += in_span;
+      continue;
+    }
+    if (!in_range) {
+      ++accepted_outside;
+      continue;
+    }
+    double err = fabs(got - want);
+    if (in_span && err > max_span_err) max_span_err = err;
+    if (err > max_err) {
+      max_err = err;
+      worst = static_cast<uint16_t>(code);
+    }
+  }
+  int16_t t_lo = 0, t_hi = 0;
+  th.to_c10(t.code_lo, &t_lo);
+  th.to_c10(t.code_hi, &t_hi);
+  printf("%-9s codes %4u..%4u (%.1f..%.1f C), max error %.3f C in -40..85 C, %.3f C at code %u\n",
+         name, t.code_lo, t.code_hi, t_lo / 10.0, t_hi / 10.0, max_span_err / 10.0,
+         max_err / 10.0, worst);
+  int failures = 0;
+  if (max_span_err > kMaxSpanErrC10 || max_err > kMaxErrC10) {
+    fprintf(stderr, "%s: error %.2f C10 in span, %.2f overall\n", name, max_span_err, max_err);
+    ++failures;
+  }
+  if (rejected_inside || accepted_outside) {
+    fprintf(stderr, "%s: %u codes in the operating span rejected, %u out of range accepted\n",
+            name, rejected_inside, accepted_outside);
+    ++failures;
+  }
+  int16_t v;
+  if (th.to_c10(0, &v) || th.to_c10(static_cast<uint16_t>(kThermistorAdcFullScale), &v)) {
+    fprintf(stderr, "%s: shorted or open sensor accepted\n", name);
+    ++failures;
+  }
+  return failures;
+}
+
+std::vector<uint8_t> encode_cal(const ThermistorModel& m) {
+  records::ThermistorCal cal{static_cast<float>(m.sh_a), static_cast<float>(m.sh_b),
+                             static_cast<float>(m.sh_c), static_cast<float>(m.r_fixed_ohm)};
+  std::vector<uint8_t> out(records::ThermistorCal::kEncodedSize);
+  cal.encode(out.data(), out.size());
+  return out;
+}
+
+ThermistorModel as_stored(const ThermistorModel& m) {
+  return {static_cast<float>(m.sh_a), static_cast<float>(m.sh_b), static_cast<float>(m.sh_c),
+          static_cast<float>(m.r_fixed_ohm)};
+}
+
+/// Beta-model part expressed as Steinhart-Hart coefficients.
+ThermistorModel beta_part(double r25, double beta, double r_fixed) {
+  return {1.0 / 298.15 - log(r25) / beta, 1.0 / beta, 0.0, r_fixed};
+}
+
+template <class Fn>
+double ns_per(size_t n, Fn fn) {
+  double best = 1e30;
+  for (int rep = 0; rep < 5; ++rep) {
+    auto t = Clock::now();
+    fn();
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - t).count() / n;
+    if (ns < best) best = ns;
+  }
+  return best;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t iters = argc > 1 ? static_cast<size_t>(atol(argv[1])) : 1000000;
+  int failures = 0;
+
+  printf("table: %zu segments, %zu bytes\n", kThermistorSegments, sizeof(ThermistorTable));
+  Thermistor th;
+  failures += check_table("nominal", th, kNominalThermistor);
+
+  // Per-unit calibration in config flash.
+  board::ConfigFlash flash;
+  ThermistorModel old_cal = beta_part(10000, 3380, 10000);
+  ThermistorModel unit_cal = beta_part(10000, 3435, 9960);
+  std::vector<uint8_t> p0 = encode_cal(old_cal), p1 = encode_cal(unit_cal);
+  auto id = records::ThermistorCal::kId;
+  auto ver = records::ThermistorCal::kVersion;
+  if (!cal_store_append(flash, kCalBase, kCalSize, id, ver, p0.data(), p0.size()) ||
+      !cal_store_append(flash, kCalBase, kCalSize, id, ver, p1.data(), p1.size())) {
+    fprintf(stderr, "cal_store_append failed\n");
+    return 2;
+  }
+  // A third write torn by a reset: header and the first payload bytes.
+  std::vector<uint8_t> p2 = encode_cal(beta_part(10000, 4100, 10000));
+  uint32_t end = 2 * 24;  // two 24-byte entries, a multiple of the 8-byte unit
+  uint8_t torn[8] = {id, ver, static_cast<uint8_t>(p2.size()), 0, p2[0], p2[1], p2[2], p2[3]};
+  flash.program(kCalBase + end, torn, sizeof(torn));
+
+  uint8_t payload[kCalMaxPayload];
+  int len = cal_store_find(flash, kCalBase, kCalSize, id, payload, sizeof(payload));
+  if (len < 0 || !th.apply_cal(payload, static_cast<size_t>(len)) || !th.calibrated() ||
+      std::vector<uint8_t>(payload, payload + len) != p1) {
+    fprintf(stderr, "stored calibration not applied\n");
+    ++failures;
+  }
+  failures += check_table("unit cal", th, as_stored(unit_cal));
+
+  // A calibration that cannot cover the operating span is refused.
+  std::vector<uint8_t> bad = encode_cal(beta_part(100, 3950, 1000000));
+  if (th.apply_cal(bad.data(), bad.size()) || !th.calibrated()) {
+    fprintf(stderr, "unusable calibration accepted\n");
+    ++failures;
+  }
+
+  // Conversion cost over codes inside the range.
+  std::mt19937 rng(1);
+  const ThermistorTable& t = th.table();
+  std::vector<uint16_t> codes(4096);
+  for (uint16_t& c : codes) {
+    c = static_cast<uint16_t>(t.code_lo + rng() % (t.code_hi - t.code_lo));
+  }
+  volatile int32_t sink = 0;
+  ThermistorModel m = as_stored(unit_cal);
+  double table_ns = ns_per(iters, [&] {
+    int32_t acc = 0;
+    for (size_t i = 0; i < iters; ++i) {
+      int16_t v = 0;
+      th.to_c10(codes[i & 4095], &v);
+      acc += v;
+    }
+    sink = acc;
+  });
+  double float_ns = ns_per(iters, [&] {
+    float acc = 0;
+    for (size_t i = 0; i < iters; ++i) acc += float_c10(m, codes[i & 4095]);
+    sink = static_cast<int32_t>(acc);
+  });
+  double double_ns = ns_per(iters, [&] {
+    double acc = 0;
+    for (size_t i = 0; i < iters; ++i) acc += exact_c10(m, codes[i & 4095]);
+    sink = static_cast<int32_t>(acc);
+  });
+  printf("conversion (host): table %.2f ns, float logf %.2f ns, double log %.2f ns\n", table_ns,
+         float_ns, double_ns);
+  printf("failures %d\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,361 @@
+// Host driver for the serial console over a pseudo-terminal.
+//
+//   console_pty            interactive: connect a terminal to the printed
+//                          pty (e.g. `screen /dev/pts/N`), Ctrl-C here quits
+//   console_pty flood      load test, exits 1 on any failure
+//
+// The main loop stands in for the firmware's: every 1 ms it moves at most
+// one UART's worth of bytes (115200 baud) between the pty and the console,
+// as the receive interrupt and TX DMA would, calls Console::poll(), and
+// every 100 ms runs a fixed-cost flight tick whose start lateness is the
+// jitter measured.
+//
+// The flood test drives the other side of the pty from a thread: junk and
+// overlong lines at full UART rate without reading the replies, a scripted
+// session checked reply by reply (immediate sets, a committed batch and a
+// batch with a bad line that must apply nothing), a 2000-line log dump read
+// by a slow terminal, and a dump cancelled with Ctrl-C. It reports tick
+// lateness and poll() cost with the console idle and under that load.
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "console/console.h"
+#include "diag/latency_histogram.h"
+
+using namespace skyguard;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+constexpr size_t kUartBytesPerMs = 12;  // 115200 baud, 8N1
+constexpr uint32_t kFlightTickMs = 100;
+constexpr uint32_t kFlightWorkUs = 300;
+
+std::atomic<bool> g_stop{false};
+
+uint32_t now_us() {
+  return static_cast<uint32_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(Clock::now().time_since_epoch())
+          .count());
+}
+
+// TX "DMA": the span the console handed over, sent at UART rate.
+struct PtyDma {
+  int fd = -1;
+  const uint8_t* data = nullptr;
+  size_t n = 0;
+};
+
+bool dma_start(void* ctx, const uint8_t* data, size_t n) {
+  auto* d = static_cast<PtyDma*>(ctx);
+  d->data = data;
+  d->n = n;
+  return true;
+}
+
+struct Params {
+  int32_t telemetry_period_s = 60;
+  int32_t perf_period_s = 600;
+  int32_t cut_altitude_m = 30000;
+  int32_t fence_margin_m = 500;
+  int32_t burn_ms = 3000;
+  uint32_t commits = 0;
+};
+
+struct LoopStats {
+  diag::LatencyHistogram lateness, poll;
+  uint32_t ticks = 0;
+};
+
+// Streams `log [n]` synthetic log lines, one per step.
+console::CmdResult cmd_log(void*, console::Console& con, console::CmdCall& call) {
+  long n = call.argc > 1 ? atol(call.argv[1]) : 20;
+  if (call.cursor < static_cast<uint32_t>(n)) {
+    con.printf("log %06u t=%u alt=%u fix=3\r\n", call.cursor, call.cursor * 1000,
+               1200 + call.cursor * 5);
+    return console::CmdResult::kMore;
+  }
+  con.print("ok\r\n");
+  return console::CmdResult::kDone;
+}
+
+console::CmdResult cmd_stats(void* ctx, console::Console& con, console::CmdCall&) {
+  auto* s = static_cast<LoopStats*>(ctx);
+  const console::ConsoleStats& c = con.stats();
+  con.printf("ok ticks %u lateness p99 %u us max %u us; poll p99 %u us; rx lost %u, tx dropped "
+             "%u\r\n",
+             s->ticks, s->lateness.percentile_us(990), s->lateness.max_us(),
+             s->poll.percentile_us(990), c.rx_overflow, c.tx_dropped);
+  return console::CmdResult::kDone;
+}
+
+// Runs the firmware-side loop until `until` returns true.
+template <class Until>
+void run_loop(int fd, PtyDma* dma, console::Console* con, LoopStats* stats, Until until) {
+  Clock::time_point next = Clock::now(), next_tick = next;
+  while (!until() && !g_stop.load()) {
+    next += std::chrono::milliseconds(1);
+    // Receive interrupt: what the UART delivered during the last ms.
+    uint8_t in[kUartBytesPerMs];
+    ssize_t got = read(fd, in, sizeof(in));
+    if (got > 0) con->on_rx(in, static_cast<size_t>(got));
+    // TX DMA progress.
+    if (dma->n) {
+      ssize_t w = write(fd, dma->data, std::min(dma->n, kUartBytesPerMs));
+      if (w > 0) {
+        dma->n = 0;
+        con->on_tx_done(static_cast<size_t>(w));
+      }
+    }
+    uint32_t t0 = now_us();
+    con->poll();
+    stats->poll.add(now_us() - t0);
+
+    Clock::time_point now = Clock::now();
+    if (now >= next_tick) {
+      auto late = std::chrono::duration_cast<std::chrono::microseconds>(now - next_tick);
+      stats->lateness.add(static_cast<uint32_t>(late.count()));
+      ++stats->ticks;
+      next_tick += std::chrono::milliseconds(kFlightTickMs);
+      uint32_t w0 = now_us();
+      while (now_us() - w0 < kFlightWorkUs) {
+      }
+    }
+    std::this_thread::sleep_until(std::min(next, next_tick));
+  }
+}
+
+// --- flood test client --------------------------------------------------------
+
+struct Client {
+  int fd;
+  std::string pending;
+  size_t failures = 0;
+
+  void send(const std::string& s) {
+    size_t off = 0;
+    while (off < s.size()) {
+      ssize_t w = write(fd, s.data() + off, s.size() - off);
+      if (w > 0) off += static_cast<size_t>(w);
+    }
+  }
+
+  // Next reply line, reading at most `bytes_per_s`; empty on timeout.
+  std::string line(int timeout_ms, double bytes_per_s = 0) {
+    Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(timeout_ms);
+    for (;;) {
+      size_t nl = pending.find('\n');
+      if (nl != std::string::npos) {
+        std::string l = pending.substr(0, nl);
+        pending.erase(0, nl + 1);
+        if (!l.empty() && l.back() == '\r') l.pop_back();
+        return l;
+      }
+      if (Clock::now() > deadline) return "";
+      pollfd p{fd, POLLIN, 0};
+      if (::poll(&p, 1, 10) <= 0) continue;
+      char buf[256];
+      size_t want = bytes_per_s > 0 ? 64 : sizeof(buf);
+      ssize_t n = read(fd, buf, want);
+      if (n > 0) pending.append(buf, static_cast<size_t>(n));
+      if (bytes_per_s > 0 && n > 0) {
+        std::this_thread::sleep_for(std::chrono::duration<double>(n / bytes_per_s));
+      }
+    }
+  }
+
+  void drain() {
+    while (!line(300).empty()) {
+    }
+    pending.clear();
+  }
+
+  // Sends one command and returns its final ok/err line.
+  std::string cmd(const std::string& c) {
+    send(c + "\r\n");
+    for (;;) {
+      std::string l = line(2000);
+      if (l.empty() || l.rfind("ok", 0) == 0 || l.rfind("err", 0) == 0) return l;
+    }
+  }
+
+  void expect(const std::string& c, const std::string& reply) {
+    std::string got = cmd(c);
+    if (got.rfind(reply, 0) != 0) {
+      printf("  FAIL %-36s -> \"%s\" (want \"%s\")\n", c.substr(0, 36).c_str(), got.c_str(),
+             reply.c_str());
+      ++failures;
+    }
+  }
+};
+
+void flood_client(int fd, const Params* params, std::atomic<int>* phase, size_t* failures) {
+  Client c{fd, {}, 0};
+  // Junk at full rate, replies unread.
+  std::string junk;
+  for (int i = 0; junk.size() < 30000; ++i) {
+    junk += i % 7 == 0 ? std::string(300, 'x') : "frob" + std::to_string(i);
+    junk += "\r\n";
+  }
+  c.send(junk);
+  c.send("\x03");
+  c.drain();
+
+  phase->store(1);
+  c.expect("set burn_ms 4000", "ok burn_ms 4000");
+  c.expect("begin", "ok batch");
+  c.expect("set telemetry_period_s 30", "ok staged");
+  c.expect("set cut_altitude_m 31000", "ok staged");
+  c.send("# comments and blank lines are ignored in scripts\r\n\r\n");
+  c.expect("commit", "ok committed 2");
+  c.expect("begin", "ok batch");
+  c.expect("set telemetry_period_s 10", "ok staged");
+  c.expect("set cut_altitude_m 999999", "err cut_altitude_m must be");
+  c.expect("set fence_margin_m 50", "ok staged");
+  c.expect("commit", "err batch had errors");
+  c.expect("get telemetry_period_s", "ok telemetry_period_s 30");
+  c.expect("get fence_margin_m", "ok fence_margin_m 500");
+  c.expect("frobnicate", "err unknown command");
+  c.expect(std::string(200, 'y'), "err line too long");
+  if (params->cut_altitude_m != 31000 || params->burn_ms != 4000 || params->commits != 2) {
+    printf("  FAIL parameters not as committed\n");
+    ++c.failures;
+  }
+
+  // A long dump read by a slow terminal.
+  phase->store(2);
+  c.send("log 2000\r\n");
+  size_t lines = 0;
+  for (;;) {
+    std::string l = c.line(3000, 20000);
+    if (l.rfind("log ", 0) == 0) ++lines;
+    if (l.empty() || l == "ok") break;
+  }
+  if (lines != 2000) {
+    printf("  FAIL log dump gave %zu lines\n", lines);
+    ++c.failures;
+  }
+
+  // Cancelled mid-stream.
+  c.send("log 100000\r\n");
+  for (int i = 0; i < 100; ++i) c.line(1000);
+  c.send("\x03");
+  bool cancelled = false;
+  for (int i = 0; i < 2000 && !cancelled; ++i) {
+    std::string l = c.line(1000);
+    if (l.empty()) break;
+    cancelled = l == "err cancelled";
+  }
+  c.drain();
+  if (!cancelled) {
+    printf("  FAIL dump not cancelled\n");
+    ++c.failures;
+  }
+  c.expect("get burn_ms", "ok burn_ms 4000");
+  *failures = c.failures;
+  phase->store(3);
+}
+
+void report(const char* what, const LoopStats& s) {
+  printf("  %-10s ticks %5u  lateness p50 %5u p99 %5u max %6u us  poll() p50 %3u p99 %4u "
+         "max %5u us\n",
+         what, s.ticks, s.lateness.percentile_us(500), s.lateness.percentile_us(990),
+         s.lateness.max_us(), s.poll.percentile_us(500), s.poll.percentile_us(990),
+         s.poll.max_us());
+}
+
+void on_sigint(int) { g_stop.store(true); }
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  bool flood = argc > 1 && strcmp(argv[1], "flood") == 0;
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+    perror("posix_openpt");
+    return 2;
+  }
+  fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+  const char* slave_name = ptsname(master);
+  int slave = open(slave_name, O_RDWR | O_NOCTTY);
+  termios tio;
+  if (slave < 0 || tcgetattr(slave, &tio) != 0) {
+    perror(slave_name);
+    return 2;
+  }
+  cfmakeraw(&tio);
+  tcsetattr(slave, TCSANOW, &tio);
+
+  PtyDma dma;
+  dma.fd = master;
+  console::Console con({dma_start, &dma});
+  Params params;
+  LoopStats stats;
+  con.add_param({"telemetry_period_s", 5, 3600, &params.telemetry_period_s});
+  con.add_param({"perf_period_s", 0, 65535, &params.perf_period_s});
+  con.add_param({"cut_altitude_m", 1000, 40000, &params.cut_altitude_m});
+  con.add_param({"fence_margin_m", 0, 10000, &params.fence_margin_m});
+  con.add_param({"burn_ms", 500, 10000, &params.burn_ms});
+  con.set_commit_hook([](void* ctx) { ++static_cast<Params*>(ctx)->commits; }, &params);
+  con.add_command({"log", "log [n]: dump n log lines", cmd_log, nullptr});
+  con.add_command({"stats", "loop timing and console counters", cmd_stats, &stats});
+
+  if (!flood) {
+    close(slave);
+    signal(SIGINT, on_sigint);
+    con.set_echo(true);
+    printf("console on %s (Ctrl-C here to quit)\n", slave_name);
+    run_loop(master, &dma, &con, &stats, [] { return false; });
+    printf("\n");
+    report("session", stats);
+    return 0;
+  }
+
+  LoopStats idle;
+  Clock::time_point idle_end = Clock::now() + std::chrono::seconds(2);
+  run_loop(master, &dma, &con, &idle, [&] { return Clock::now() > idle_end; });
+
+  std::atomic<int> phase{0};
+  size_t failures = 0;
+  std::thread client(flood_client, slave, &params, &phase, &failures);
+  LoopStats loaded[3];
+  for (int p = 0; p < 3; ++p) {
+    run_loop(master, &dma, &con, &loaded[p], [&] { return phase.load() != p; });
+  }
+  client.join();
+
+  const console::ConsoleStats& c = con.stats();
+  printf("flight tick every %u ms (%u us of work), console polled every 1 ms\n", kFlightTickMs,
+         kFlightWorkUs);
+  report("idle", idle);
+  report("junk flood", loaded[0]);
+  report("script", loaded[1]);
+  report("log dump", loaded[2]);
+  printf("console: %u commands, %u errors, %u commits, %u B lost to rx overflow, %u lines "
+         "dropped, %u long lines\n",
+         c.commands, c.errors, c.commits, c.rx_overflow, c.tx_dropped, c.long_lines);
+  // The console's own cost must stay small next to a 1 ms poll period.
+  uint32_t worst_p99 = 0;
+  for (const LoopStats& s : loaded) worst_p99 = std::max(worst_p99, s.poll.percentile_us(990));
+  if (worst_p99 > 100) {
+    printf("  FAIL poll() p99 %u us\n", worst_p99);
+    ++failures;
+  }
+  printf("failures %zu\n", failures);
+  close(slave);
+  close(master);
+  return failures ? 1 : 0;
+}
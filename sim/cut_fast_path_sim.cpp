@@ -0,0 +1,440 @@
+// Remote cut latency and integrity under load: the receive-interrupt fast
+// path (firmware/termination/cut_fast_path.h) against the rule tick.
+//
+//   cut_fast_path_sim [trials] [seed]
+//
+// Each trial sends one genuine cut command during a flood of forged,
+// replayed and wrong-unit frames on two links. Log flushes hold the main
+// loop, critical sections delay interrupts, and the burn current ADC
+// samples at 1 kHz. One channel A wire in twenty is open, so channel B has
+// to take over. The real CutFastPath and BurnSequencer run against a
+// simulated clock. The two receive interrupts share a priority, so they
+// run one at a time in arrival order, each with a modelled cost. The
+// ground then repeats the command (a lost ACK) and sends a newer one. The
+// same genuine command taken by the 50 ms rule tick gives the comparison.
+// Every tenth trial runs with the arm input off.
+//
+// Checks, per trial: the genuine command fires exactly once; nothing else
+// drives a gate; the repeat gets the result of the first copy; only the
+// authenticated frames leave events. Then FlightSystem runs the path end
+// to end, with fake radios: the CutAck must come down with the burn
+// outcome on every link, forged and replayed frames get no ACK, and
+// remote_cut() latches.
+//
+// Prints receive-to-gate and receive-to-current percentiles for both paths.
+// Exits 1 on a failed check, or if the fast path's receive-to-gate p99
+// exceeds 1 ms.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "app/flight_system.h"
+#include "ground/termination/cut_uplink.h"
+#include "termination/burn_sequencer.h"
+#include "termination/cut_fast_path.h"
+
+using namespace skyguard;
+using termination::BurnSequencer;
+using termination::BurnState;
+using termination::CutEvent;
+using termination::CutFastPath;
+using termination::CutResult;
+
+namespace {
+
+constexpr uint32_t kTickUs = 50000;
+constexpr uint32_t kCurrentSampleUs = 1000;
+constexpr double kFlushProbability = 0.05;  // log flush holding the main loop
+// Receive interrupt costs on the STM32L4 at 80 MHz: entry and frame
+// handling, then the SipHash check of a 17-byte command, or only the
+// length and unit checks for another unit's frame.
+constexpr uint32_t kIsrEntryUs = 3;
+constexpr uint32_t kAuthUs = 14;
+constexpr uint32_t kRejectUs = 2;
+constexpr uint32_t kTickEvalUs = 150;  // rule evaluation up to the fire() call
+constexpr uint32_t kTrialUs = 300000;
+constexpr uint32_t kGateBudgetUs = 1000;
+constexpr uint32_t kUnitId = 0x5347000A;
+constexpr uint32_t kStartCounter = 1000;
+
+const termination::CutKey kKey = {{0x3a, 0x91, 0x0c, 0x5e, 0x77, 0x12, 0xb4, 0x68, 0xd2, 0x09,
+                                   0xee, 0x41, 0x8f, 0x26, 0xc3, 0x5d}};
+
+size_t failures = 0;
+
+void fail(const char* what, int trial) {
+  if (failures++ < 10) printf("FAIL trial %d: %s\n", trial, what);
+}
+
+uint32_t g_now_us = 0;
+uint32_t sim_clock() { return g_now_us; }
+
+struct Rng {
+  std::mt19937_64 gen;
+  uint32_t uniform(uint32_t lo, uint32_t hi) {
+    return std::uniform_int_distribution<uint32_t>(lo, hi)(gen);
+  }
+  bool chance(double p) { return std::uniform_real_distribution<double>(0, 1)(gen) < p; }
+  // Interrupts masked by a critical section, or stalled by a flash program.
+  uint32_t masked() {
+    if (chance(0.01)) return uniform(0, 100);
+    return chance(0.1) ? uniform(0, 40) : 0;
+  }
+  uint32_t blocking() { return chance(kFlushProbability) ? uniform(5000, 30000) : 0; }
+};
+
+// The burn wire: current flows a little after the gate closes, unless the
+// channel is open.
+struct Wire {
+  bool open_a = false;
+  uint32_t rise_us = 0;
+};
+
+struct Gates {
+  const Wire* wire = nullptr;
+  bool armed = true;
+  bool on[2] = {};
+  uint32_t on_us[2] = {};
+  int switched_on[2] = {};
+  uint16_t current_ma(uint32_t t_us) const {
+    for (int c = 0; c < 2; ++c) {
+      if (!on[c] || (c == 0 && wire->open_a)) continue;
+      if (t_us - on_us[c] >= wire->rise_us) return 2200;
+    }
+    return 0;
+  }
+};
+
+void gate(void* ctx, uint8_t channel, bool on) {
+  auto* g = static_cast<Gates*>(ctx);
+  if (on && !g->on[channel]) {
+    g->on_us[channel] = g_now_us;
+    ++g->switched_on[channel];
+  }
+  g->on[channel] = on;
+}
+
+bool armed(void* ctx) { return static_cast<Gates*>(ctx)->armed; }
+
+enum class FrameKind : uint8_t { kForged, kReplay, kOtherUnit, kGenuine, kRepeat, kNewer };
+
+struct Frame {
+  uint32_t end_us;  // end of the frame on air
+  FrameKind kind;
+  uint8_t bytes[records::CutCommand::kEncodedSize];
+};
+
+Frame make_frame(Rng& rng, FrameKind kind, uint32_t end_us, uint32_t counter) {
+  Frame f{end_us, kind, {}};
+  uint32_t unit = kind == FrameKind::kOtherUnit ? kUnitId + 1 : kUnitId;
+  ground::sign_cut_command(kKey, unit, counter, termination::kCutActionCutNow, f.bytes,
+                           sizeof(f.bytes));
+  if (kind == FrameKind::kForged) {
+    f.bytes[rng.uniform(9, 16)] ^= static_cast<uint8_t>(rng.uniform(1, 255));
+  }
+  return f;
+}
+
+struct Latencies {
+  std::vector<uint32_t> gate_us, current_us;
+};
+
+void print_row(const char* name, std::vector<uint32_t>& v) {
+  if (v.empty()) return;
+  std::sort(v.begin(), v.end());
+  auto at = [&](double q) { return v[static_cast<size_t>(q * (v.size() - 1))] / 1000.0; };
+  printf("  %-24s %9.3f %9.3f %9.3f\n", name, at(0.5), at(0.99), v.back() / 1000.0);
+}
+
+// Runs `seq` to the end of its pulse on the 1 kHz current samples from
+// `from_us`; returns when current was first seen, or false.
+bool run_burn(BurnSequencer& seq, Gates& g, uint32_t phase_us, uint32_t from_us) {
+  uint32_t t = from_us - from_us % kCurrentSampleUs + phase_us;
+  if (t < from_us) t += kCurrentSampleUs;
+  for (; seq.state() == BurnState::kBurning; t += kCurrentSampleUs) {
+    g_now_us = t;
+    seq.service(t, g.current_ma(t));
+  }
+  return seq.current_seen();
+}
+
+void trial(Rng& rng, int n, Latencies* fast, Latencies* tick, uint64_t* flood_frames) {
+  Wire wire{rng.chance(0.05), rng.uniform(5, 60)};
+  bool arm = n % 10 != 9;
+  Gates g;
+  g.wire = &wire;
+  g.armed = arm;
+  BurnSequencer seq({gate, armed, &g});
+  uint32_t counter = kStartCounter + static_cast<uint32_t>(n) * 4;
+  CutFastPath path({kUnitId, kKey, counter}, seq, sim_clock);
+
+  // Frames ending on two links through the trial: ~200/s of noise each.
+  std::vector<Frame> frames;
+  for (int link = 0; link < 2; ++link) {
+    for (uint32_t t = rng.uniform(0, 5000); t < kTrialUs; t += rng.uniform(1000, 9000)) {
+      uint32_t r = rng.uniform(0, 3);
+      FrameKind kind = r < 2 ? FrameKind::kForged
+                             : r == 2 ? FrameKind::kReplay : FrameKind::kOtherUnit;
+      uint32_t c = kind == FrameKind::kReplay ? counter - rng.uniform(1, 50) : counter + 1;
+      frames.push_back(make_frame(rng, kind, t, c));
+    }
+  }
+  *flood_frames += frames.size();
+  uint32_t rx = rng.uniform(10000, 150000);
+  frames.push_back(make_frame(rng, FrameKind::kGenuine, rx, counter + 1));
+  frames.push_back(make_frame(rng, FrameKind::kRepeat, rx + 40000, counter + 1));
+  frames.push_back(make_frame(rng, FrameKind::kNewer, rx + 80000, counter + 2));
+  std::sort(frames.begin(), frames.end(),
+            [](const Frame& a, const Frame& b) { return a.end_us < b.end_us; });
+
+  uint32_t isr_free = 0;
+  uint32_t genuine_auth = 0;
+  size_t flood_seen = 0;
+  for (const Frame& f : frames) {
+    uint32_t start = std::max(f.end_us + rng.masked(), isr_free) + kIsrEntryUs;
+    uint32_t cost = f.kind == FrameKind::kOtherUnit ? kRejectUs : kAuthUs;
+    g_now_us = start + cost;
+    isr_free = g_now_us + 1;
+    // The burn is serviced after this loop: the frames after the genuine
+    // one must not touch the gates, whatever the current does meanwhile.
+    CutResult r = path.on_frame(f.bytes, sizeof(f.bytes), f.end_us);
+    switch (f.kind) {
+      case FrameKind::kGenuine:
+        genuine_auth = g_now_us;
+        if (r != (arm ? CutResult::kAccepted : CutResult::kNotArmed)) {
+          fail("genuine command not accepted", n);
+        }
+        break;
+      case FrameKind::kRepeat:
+        // Re-acknowledged with the result the counter got first.
+        if (r != (arm ? CutResult::kDuplicate : CutResult::kNotArmed)) {
+          fail("repeat not acknowledged with the first result", n);
+        }
+        break;
+      case FrameKind::kNewer:
+        if (r != (arm ? CutResult::kAlreadyFired : CutResult::kNotArmed)) {
+          fail("newer command fired again", n);
+        }
+        break;
+      default:
+        ++flood_seen;
+        if (termination::cut_result_authenticated(r)) fail("flood frame authenticated", n);
+        if (g.switched_on[0] + g.switched_on[1] > 0 && f.end_us < rx) {
+          fail("gate driven before the genuine command", n);
+        }
+    }
+  }
+  if (path.rejected() != flood_seen) fail("rejected count", n);
+  CutEvent e;
+  int events = 0;
+  while (path.take(&e)) ++events;
+  if (events != 3 || path.dropped() != 0) fail("event count", n);
+  if (path.last_counter() != counter + 2) fail("last counter", n);
+
+  uint32_t phase = rng.uniform(0, kCurrentSampleUs - 1);
+  if (!arm) {
+    if (seq.fired() || g.switched_on[0] + g.switched_on[1] != 0) fail("fired while safe", n);
+    return;
+  }
+  if (seq.fire_us() != genuine_auth) fail("fire time", n);
+  bool seen = run_burn(seq, g, phase, seq.fire_us());
+  if (!seen || seq.state() != BurnState::kDone) fail("burn did not complete", n);
+  if (g.switched_on[0] != 1 || g.switched_on[1] != (wire.open_a ? 1 : 0)) {
+    fail("gate switched on more than once", n);
+  }
+  fast->gate_us.push_back(seq.fire_us() - rx);
+  if (seen) fast->current_us.push_back(seq.current_us() - rx);
+
+  // The same command through the tick: the task sees the frame once the
+  // main loop is free and the next tick runs the rules.
+  Gates tg;
+  tg.wire = &wire;
+  BurnSequencer tick_seq({gate, armed, &tg});
+  uint32_t t_fire = rx + rng.blocking() + rng.uniform(0, kTickUs - 1) + kAuthUs + kTickEvalUs;
+  g_now_us = t_fire;
+  tick_seq.fire(t_fire);
+  if (run_burn(tick_seq, tg, phase, t_fire)) {
+    tick->current_us.push_back(tick_seq.current_us() - rx);
+  }
+  tick->gate_us.push_back(t_fire - rx);
+}
+
+// ---- End to end, through FlightSystem ----
+
+struct FakeRadio {
+  bool busy = false;
+  uint32_t refuse_until_us = 0;  // the driver is busy with its own traffic
+  uint16_t seq = 0;
+  std::vector<ground::CutAckInfo> acks;
+};
+
+bool radio_submit(void* ctx, const telemetry::SgFrame& f) {
+  auto* r = static_cast<FakeRadio*>(ctx);
+  if (r->busy || static_cast<int32_t>(g_now_us - r->refuse_until_us) < 0) return false;
+  r->busy = true;
+  const uint8_t* hdr = f.segments()[0].data;
+  r->seq = static_cast<uint16_t>(hdr[4] | hdr[5] << 8);
+  if (hdr[2] == records::CutAck::kId) {
+    const telemetry::SgSegment& payload = f.segments()[1];
+    ground::CutAckInfo a;
+    if (ground::read_cut_ack(payload.data, payload.len, &a)) r->acks.push_back(a);
+  }
+  return true;
+}
+
+void finish(app::FlightSystem& fs, FakeRadio& r, app::LinkKind kind, uint32_t now_ms) {
+  if (!r.busy) return;
+  r.busy = false;
+  fs.on_link_tx_done(kind, true, now_ms);
+  fs.on_link_ack(kind, r.seq, now_ms);
+}
+
+#if SKYGUARD_HAS_APRS
+bool dma_running = false;
+void dma_start(void*, const uint16_t*, size_t) { dma_running = true; }
+void dma_stop(void*) { dma_running = false; }
+#endif
+
+struct CutLog {
+  int events = 0;
+  uint32_t last_counter = 0;
+};
+
+void log_cut(void* ctx, const CutEvent&, uint32_t last_counter) {
+  auto* l = static_cast<CutLog*>(ctx);
+  ++l->events;
+  l->last_counter = last_counter;
+}
+
+void end_to_end(Rng& rng) {
+  Wire wire{true, 30};  // channel A open: the ACK should report the failover
+  Gates g;
+  g.wire = &wire;
+  CutLog log;
+  app::FlightPorts ports{};
+  ports.clock_us = sim_clock;
+  ports.burn = {gate, armed, &g};
+  ports.cut = {kUnitId, kKey, kStartCounter};
+  ports.cut_log = {log_cut, &log};
+  FakeRadio lora, iridium;
+  // The modem is in a session of its own when the ACK is queued, so the
+  // ACK waits for it after LoRa has delivered its copy.
+  iridium.refuse_until_us = 2000000;
+#if SKYGUARD_HAS_LORA
+  ports.lora = {radio_submit, &lora};
+#endif
+#if SKYGUARD_HAS_IRIDIUM
+  ports.iridium = {radio_submit, &iridium};
+#endif
+#if SKYGUARD_HAS_APRS
+  ports.afsk = {dma_start, dma_stop, nullptr};
+  ports.afsk_sample_rate = 26400;
+  ports.afsk_out_max = 4095;
+  ports.aprs_source = {"N0CALL", 11};
+#endif
+  std::unique_ptr<app::FlightSystem> owned(new app::FlightSystem(ports));
+  app::FlightSystem& fs = *owned;
+
+  struct Uplink {
+    uint32_t end_us;
+    FrameKind kind;
+    bool from_isr;
+  };
+  const Uplink uplinks[] = {
+      {1000300, FrameKind::kForged, true},   {1200500, FrameKind::kReplay, true},
+      {1500700, FrameKind::kGenuine, true},  {1500900, FrameKind::kOtherUnit, true},
+      {2600000, FrameKind::kRepeat, false},
+  };
+  size_t next = 0;
+  uint32_t rx = 0;
+  for (uint32_t t_us = 0; t_us < 6000000; t_us += kCurrentSampleUs) {
+    for (; next < sizeof(uplinks) / sizeof(uplinks[0]) && uplinks[next].end_us <= t_us;
+         ++next) {
+      const Uplink& u = uplinks[next];
+      uint32_t c = u.kind == FrameKind::kReplay ? kStartCounter - 3 : kStartCounter + 1;
+      Frame f = make_frame(rng, u.kind, u.end_us, c);
+      g_now_us = u.end_us + kIsrEntryUs + kAuthUs;
+      if (u.kind == FrameKind::kGenuine) rx = u.end_us;
+      if (u.from_isr) {
+        fs.cut_path().on_frame(f.bytes, sizeof(f.bytes), u.end_us);
+      } else {
+        fs.on_uplink(records::CutCommand::kId, f.bytes, sizeof(f.bytes), u.end_us);
+      }
+    }
+    g_now_us = t_us;
+    fs.on_burn_current(t_us, g.current_ma(t_us));
+    if (t_us % 100000 == 0) {
+      uint32_t now_ms = t_us / 1000;
+#if SKYGUARD_HAS_LORA
+      finish(fs, lora, app::LinkKind::kLora, now_ms);
+#endif
+#if SKYGUARD_HAS_IRIDIUM
+      finish(fs, iridium, app::LinkKind::kIridium, now_ms);
+#endif
+      fs.tick(now_ms);
+    }
+  }
+
+  if (!fs.remote_cut()) fail("remote_cut() not latched", -1);
+  if (fs.burn().state() != BurnState::kDone || fs.burn().channel() != 1) {
+    fail("end-to-end burn did not fail over to channel B", -1);
+  }
+  if (log.events != 2 || log.last_counter != kStartCounter + 1) fail("cut log", -1);
+  std::vector<ground::CutAckInfo> acks = lora.acks;
+  acks.insert(acks.end(), iridium.acks.begin(), iridium.acks.end());
+  int accepted = 0, duplicate = 0;
+  for (const ground::CutAckInfo& a : acks) {
+    if (a.counter != kStartCounter + 1) fail("ACK for an unauthenticated frame", -1);
+    if (a.result == CutResult::kAccepted) {
+      if (a.current_us == 0 || a.burn != BurnState::kBurning) fail("ACK without outcome", -1);
+      if (accepted++ == 0) {
+        printf("end to end: CutAck accepted, gate %u us, current %.1f ms after the frame "
+               "(channel B), queued %u ms after it\n",
+               a.gate_us, a.current_us / 1000.0, a.time_ms - rx / 1000);
+      }
+    }
+    duplicate += a.result == CutResult::kDuplicate;
+  }
+  // kTermination goes out on every link that is up.
+  int links = SKYGUARD_HAS_LORA + SKYGUARD_HAS_IRIDIUM;
+  if (accepted != links || duplicate != links) fail("ACKs not delivered on every link", -1);
+  if (fs.router().queued() != 0) fail("ACK still queued after every link carried it", -1);
+  for (uint8_t i = 0; i < fs.router().link_count(); ++i) {
+    if (fs.router().link_stats(i).failed != 0) fail("healthy link charged with failures", -1);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int trials = argc > 1 ? atoi(argv[1]) : 10000;
+  Rng rng;
+  rng.gen.seed(argc > 2 ? static_cast<uint64_t>(atoll(argv[2])) : 1);
+
+  Latencies fast, tick;
+  uint64_t flood = 0;
+  for (int n = 0; n < trials; ++n) trial(rng, n, &fast, &tick, &flood);
+  printf("%d cut commands, %llu flood frames (forged, replayed, other unit)\n", trials,
+         static_cast<unsigned long long>(flood));
+  printf("latency in ms from the end of the command frame\n");
+  printf("  %-24s %9s %9s %9s\n", "", "p50", "p99", "max");
+  print_row("interrupt: gate on", fast.gate_us);
+  print_row("interrupt: current seen", fast.current_us);
+  print_row("tick: gate on", tick.gate_us);
+  print_row("tick: current seen", tick.current_us);
+
+  end_to_end(rng);
+
+  uint32_t gate_p99 = fast.gate_us.empty()
+                          ? 0
+                          : fast.gate_us[static_cast<size_t>(0.99 * (fast.gate_us.size() - 1))];
+  bool ok = failures == 0 && gate_p99 <= kGateBudgetUs;
+  printf("failures: %zu; interrupt gate p99 %u us (budget %u) -> %s\n", failures, gate_p99,
+         kGateBudgetUs, ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}
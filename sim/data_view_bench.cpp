@@ -0,0 +1,213 @@
+// Mapped against paged access to data images in external flash.
+//
+//   data_view_bench [fences] [fixes] [wind_grid.bin]
+//
+// Writes a synthetic fence image (with distance rasters) to a temporary
+// file, maps it as the host board's DataFlash and binds the firmware
+// FenceSet twice: through the mapped window, as on an XIP part, and with
+// the window disabled so every read goes through the page cache, as on a
+// plain SPI flash. A forecast grid from `wind_pack synth` is compared the
+// same way when given. Reports bind time, lookup cost along drifting
+// tracks, cache hit rate, device reads per lookup and the SPI bus time
+// those reads would take. Exits 1 if the two views ever disagree.
+
+#define SKYGUARD_HAL_HOST
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "geofence/fence_set.h"
+#include "ground/fence/fence_sdf.h"
+#include "ground/fence/fence_simplify.h"
+#include "ground/fence/fence_writer.h"
+#include "hal/board.h"
+#include "sim/fence_synth.h"
+#include "storage/data_view.h"
+#include "wind/wind_grid.h"
+
+using namespace skyguard;
+using namespace skyguard::ground;
+namespace host = skyguard::hal::host;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+constexpr double kPi = 3.14159265358979323846;
+// Bus model for a plain SPI NOR: READ command and address, then data.
+constexpr double kSpiHz = 20e6;
+constexpr double kReadOverheadBytes = 4;
+
+struct Fix {
+  uint32_t t_s;
+  int32_t lat_e7, lon_e7;
+  float alt_m;
+};
+
+// Fixes every 10 s from balloons drifting across the fence region.
+std::vector<Fix> drift_tracks(size_t n, uint32_t t0) {
+  std::mt19937 rng(11);
+  std::uniform_real_distribution<double> u(0.0, 1.0);
+  std::vector<Fix> fixes;
+  while (fixes.size() < n) {
+    double lat = 40 + 10 * u(rng), lon = -4 + 16 * u(rng), alt = 0;
+    double heading = 2 * kPi * u(rng), speed = 5 + 20 * u(rng);
+    for (uint32_t k = 0; k < 2000 && fixes.size() < n; ++k) {
+      fixes.push_back({t0 + 10 * k, static_cast<int32_t>(lround(lat * 1e7)),
+                       static_cast<int32_t>(lround(lon * 1e7)), static_cast<float>(alt)});
+      heading += 0.05 * (u(rng) - 0.5);
+      lat += speed * 10 * cos(heading) / 111195.0;
+      lon += speed * 10 * sin(heading) / (111195.0 * cos(lat * kPi / 180));
+      alt = std::min(alt + 50, 30000.0);
+    }
+  }
+  return fixes;
+}
+
+double ms_since(Clock::time_point t) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - t).count();
+}
+
+struct Run {
+  double bind_ms = 0, ns = 0;
+  uint32_t reads = 0;
+  uint64_t bytes = 0;
+  uint32_t hits = 0, misses = 0;
+};
+
+void report(const char* what, const Run& r, size_t n) {
+  uint32_t lookups = r.hits + r.misses;
+  double bus_us = (r.reads * kReadOverheadBytes + r.bytes) * 8 / kSpiHz * 1e6;
+  printf("  %-7s bind %7.2f ms  lookup %6.0f ns", what, r.bind_ms, r.ns / n);
+  if (lookups) {
+    printf("  cache %.1f%% hits, %.3f reads (%.1f B) per lookup, SPI %.2f us per lookup",
+           100.0 * r.hits / lookups, double(r.reads) / n, double(r.bytes) / n, bus_us / n);
+  }
+  printf("\n");
+}
+
+// Binds the board's data flash with the window on or off and runs `fn`
+// over it, recording device traffic after bind.
+template <class Bind, class Query>
+Run measure(bool xip, storage::PageCache* cache, Bind bind, Query query) {
+  host::g_data_flash[0].xip = xip;
+  host::g_data_flash[0].reads = 0;
+  host::g_data_flash[0].read_bytes = 0;
+  board::DataFlash flash;
+  cache->clear();
+  storage::DataView view = storage::view_of(flash, cache);
+  Run r;
+  auto t = Clock::now();
+  if (!bind(view)) return r;
+  r.bind_ms = ms_since(t);
+  cache->clear();
+  host::g_data_flash[0].reads = 0;
+  host::g_data_flash[0].read_bytes = 0;
+  t = Clock::now();
+  query();
+  r.ns = ms_since(t) * 1e6;
+  r.reads = host::g_data_flash[0].reads;
+  r.bytes = host::g_data_flash[0].read_bytes;
+  r.hits = cache->hits();
+  r.misses = cache->misses();
+  return r;
+}
+
+bool write_file(const std::string& path, const std::vector<uint8_t>& data) {
+  FILE* f = fopen(path.c_str(), "wb");
+  if (!f) return false;
+  bool ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+  return fclose(f) == 0 && ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t n_fences = argc > 1 ? static_cast<size_t>(atol(argv[1])) : 100;
+  size_t n_fixes = argc > 2 ? static_cast<size_t>(atol(argv[2])) : 100000;
+  const char* wind_path = argc > 3 ? argv[3] : nullptr;
+
+  std::vector<SourcePolygon> polys;
+  sim::synthesize_fences(n_fences, 5, &polys);
+  std::vector<FenceBlob> blobs(polys.size());
+  SdfOptions sdf;
+  std::string err;
+  for (size_t i = 0; i < polys.size(); ++i) {
+    CompiledFence f;
+    f.id = static_cast<uint16_t>(i);
+    if (!compile_ring(polys[i].outer, f.kind, SimplifyOptions{}, &f.ring_e7, &err) ||
+        !build_fence_blob(f, &blobs[i], &err, &sdf)) {
+      fprintf(stderr, "fence %zu: %s\n", i, err.c_str());
+      return 2;
+    }
+  }
+  std::vector<uint8_t> image = assemble_fence_image(blobs);
+  std::string path = "/tmp/data_view_bench." + std::to_string(getpid()) + ".bin";
+  if (!write_file(path, image) || !host::map_data_file(0, path.c_str())) {
+    fprintf(stderr, "cannot map %s\n", path.c_str());
+    return 2;
+  }
+  unlink(path.c_str());
+
+  std::vector<Fix> fixes = drift_tracks(n_fixes, 0);
+  storage::PageCache cache;
+  geofence::FenceSet set;
+  auto bind_fences = [&](const storage::DataView& v) {
+    return set.bind(v) == geofence::FenceError::kNone;
+  };
+  std::vector<float> margins[2];
+  std::vector<int16_t> hits[2];
+  Run runs[2][2];
+  for (int xip = 1; xip >= 0; --xip) {
+    runs[xip][0] = measure(xip, &cache, bind_fences, [&] {
+      for (const Fix& f : fixes) hits[xip].push_back(set.check(f.lat_e7, f.lon_e7).fence);
+    });
+    runs[xip][1] = measure(xip, &cache, bind_fences, [&] {
+      for (const Fix& f : fixes) margins[xip].push_back(set.margin_m(f.lat_e7, f.lon_e7));
+    });
+  }
+  size_t mismatches = (hits[0] != hits[1]) + (margins[0] != margins[1]) + set.read_errors();
+  printf("fence image: %zu fences, %zu B; page cache %zu B of RAM\n", polys.size(),
+         image.size(), sizeof(storage::PageCache));
+  printf("check() over %zu fixes\n", fixes.size());
+  report("mapped", runs[1][0], fixes.size());
+  report("paged", runs[0][0], fixes.size());
+  printf("margin_m()\n");
+  report("mapped", runs[1][1], fixes.size());
+  report("paged", runs[0][1], fixes.size());
+  host::unmap_data_file(0);
+
+  if (wind_path) {
+    if (!host::map_data_file(0, wind_path)) {
+      fprintf(stderr, "cannot map %s\n", wind_path);
+      return 2;
+    }
+    wind::WindGrid grid;
+    std::vector<float> winds[2];
+    Run wind_runs[2];
+    for (int xip = 1; xip >= 0; --xip) {
+      wind_runs[xip] = measure(
+          xip, &cache, [&](const storage::DataView& v) { return grid.bind(v); },
+          [&] {
+            uint32_t t0 = grid.header().t0_utc_s;
+            for (const Fix& f : fixes) {
+              wind::WindVector w{0, 0};
+              grid.sample(t0 + f.t_s, f.lat_e7, f.lon_e7, f.alt_m, &w);
+              winds[xip].push_back(w.u_ms);
+            }
+          });
+    }
+    mismatches += winds[0] != winds[1];
+    printf("WindGrid::sample(), %u B grid\n", grid.header().image_size);
+    report("mapped", wind_runs[1], fixes.size());
+    report("paged", wind_runs[0], fixes.size());
+    host::unmap_data_file(0);
+  }
+  printf("mapped/paged mismatches %zu\n", mismatches);
+  return mismatches ? 1 : 0;
+}
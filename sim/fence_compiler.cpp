@@ -0,0 +1,312 @@
+// Ground fence compiler: GeoJSON/KML boundaries in, on-board fence image
+// out.
+//
+//   fence_compiler <in.geojson|in.kml> <out.bin> [options]
+//   fence_compiler --synthetic <polygons> <out.bin> [options]
+//
+//   --tolerance <m>   furthest the restricted side may grow (default 50)
+//   --buffer <m>      safety margin on the restricted side (default 0)
+//   --threads <n>     worker threads (default: all cores)
+//   --samples <n>     random fixes for the cost report and check (default 100000)
+//   --sdf <m>         add a signed-distance raster with this sample spacing
+//   --sdf-margin <m>  raster coverage beyond each fence (default 2000)
+//
+// Keep-in holes become keep-out fences. After writing, the image is bound
+// with the firmware evaluator and sampled: every fix that violates the
+// source boundaries must violate the compiled ones (exit 1 otherwise), and
+// the edges tested per fix are the on-board evaluation cost.
+//
+// --synthetic generates a national-scale set of noisy airspace polygons
+// (a few thousand vertices each) and reports throughput.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "geofence/fence_set.h"
+#include "ground/fence/fence_sdf.h"
+#include "ground/fence/fence_simplify.h"
+#include "ground/fence/fence_source.h"
+#include "ground/fence/fence_writer.h"
+#include "sim/fence_synth.h"
+
+using namespace skyguard;
+using namespace skyguard::ground;
+using geofence::FenceKind;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double ms_since(Clock::time_point t) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - t).count();
+}
+
+struct Job {
+  const std::vector<LatLon>* ring;
+  FenceKind kind;
+  uint16_t id;
+};
+
+bool read_file(const char* path, std::string* out) {
+  FILE* f = fopen(path, "rb");
+  if (!f) return false;
+  char buf[65536];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) out->append(buf, n);
+  fclose(f);
+  return true;
+}
+
+bool ring_contains(const std::vector<LatLon>& ring, double lat, double lon) {
+  bool in = false;
+  for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+    const LatLon& a = ring[i];
+    const LatLon& b = ring[j];
+    if ((a.lat > lat) != (b.lat > lat) &&
+        lon < (b.lon - a.lon) * (lat - a.lat) / (b.lat - a.lat) + a.lon) {
+      in = !in;
+    }
+  }
+  return in;
+}
+
+struct Box {
+  double min_lat = 90, max_lat = -90, min_lon = 180, max_lon = -180;
+
+  void add(const LatLon& q) {
+    min_lat = std::min(min_lat, q.lat);
+    max_lat = std::max(max_lat, q.lat);
+    min_lon = std::min(min_lon, q.lon);
+    max_lon = std::max(max_lon, q.lon);
+  }
+  bool contains(double lat, double lon) const {
+    return lat >= min_lat && lat <= max_lat && lon >= min_lon && lon <= max_lon;
+  }
+};
+
+bool source_violation(const std::vector<SourcePolygon>& polys, const std::vector<Box>& boxes,
+                      bool any_keep_in, double lat, double lon) {
+  bool in_keep_in = false;
+  for (size_t i = 0; i < polys.size(); ++i) {
+    const SourcePolygon& p = polys[i];
+    if (!boxes[i].contains(lat, lon) || !ring_contains(p.outer, lat, lon)) continue;
+    if (p.kind == FenceKind::kKeepOut) return true;
+    bool in_hole = false;
+    for (const auto& h : p.holes) in_hole |= ring_contains(h, lat, lon);
+    if (in_hole) return true;
+    in_keep_in = true;
+  }
+  return any_keep_in && !in_keep_in;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  double tolerance = 50, buffer = 0;
+  SdfOptions sdf;
+  bool with_sdf = false;
+  size_t threads = std::max(1u, std::thread::hardware_concurrency());
+  size_t samples = 100000, synthetic = 0;
+  std::vector<const char*> paths;
+  for (int i = 1; i < argc; ++i) {
+    bool has_value = i + 1 < argc;
+    if (!strcmp(argv[i], "--tolerance") && has_value) {
+      tolerance = atof(argv[++i]);
+    } else if (!strcmp(argv[i], "--buffer") && has_value) {
+      buffer = atof(argv[++i]);
+    } else if (!strcmp(argv[i], "--threads") && has_value) {
+      threads = std::max(1, atoi(argv[++i]));
+    } else if (!strcmp(argv[i], "--samples") && has_value) {
+      samples = static_cast<size_t>(atol(argv[++i]));
+    } else if (!strcmp(argv[i], "--sdf") && has_value) {
+      sdf.step_m = atof(argv[++i]);
+      with_sdf = true;
+    } else if (!strcmp(argv[i], "--sdf-margin") && has_value) {
+      sdf.margin_m = atof(argv[++i]);
+    } else if (!strcmp(argv[i], "--synthetic") && has_value) {
+      synthetic = static_cast<size_t>(atol(argv[++i]));
+    } else {
+      paths.push_back(argv[i]);
+    }
+  }
+  if (paths.size() != (synthetic ? 1u : 2u)) {
+    fprintf(stderr,
+            "usage: fence_compiler <in.geojson|in.kml> <out.bin> [--tolerance m] [--buffer m]\n"
+            "       fence_compiler --synthetic <polygons> <out.bin> [options]\n");
+    return 2;
+  }
+  const char* out_path = paths.back();
+
+  auto t0 = Clock::now();
+  std::vector<SourcePolygon> polys;
+  std::string err;
+  if (synthetic) {
+    sim::synthesize_fences(synthetic, 7, &polys);
+  } else {
+    std::string text;
+    if (!read_file(paths[0], &text)) {
+      fprintf(stderr, "cannot read %s\n", paths[0]);
+      return 2;
+    }
+    size_t first = text.find_first_not_of(" \t\r\n\xEF\xBB\xBF");
+    bool kml = first != std::string::npos && text[first] == '<';
+    if (!(kml ? parse_kml(text, &polys, &err) : parse_geojson(text, &polys, &err))) {
+      fprintf(stderr, "%s: %s\n", paths[0], err.c_str());
+      return 2;
+    }
+  }
+  double parse_ms = ms_since(t0);
+
+  std::vector<Job> jobs;
+  bool any_keep_in = false;
+  size_t in_vertices = 0;
+  for (const SourcePolygon& p : polys) {
+    jobs.push_back({&p.outer, p.kind, p.id});
+    in_vertices += p.outer.size();
+    if (p.kind != FenceKind::kKeepIn) continue;
+    any_keep_in = true;
+    for (const auto& h : p.holes) {
+      jobs.push_back({&h, FenceKind::kKeepOut, p.id});
+      in_vertices += h.size();
+    }
+  }
+  if (jobs.size() > UINT16_MAX) {
+    fprintf(stderr, "%zu fences exceed the image limit\n", jobs.size());
+    return 2;
+  }
+
+  auto t1 = Clock::now();
+  SimplifyOptions opt;
+  opt.tolerance_m = tolerance;
+  opt.buffer_m = buffer;
+  std::vector<FenceBlob> blobs(jobs.size());
+  std::vector<std::string> errors(jobs.size());
+  std::vector<size_t> out_vertices(jobs.size());
+  std::atomic<size_t> next{0};
+  auto worker = [&] {
+    for (size_t i; (i = next.fetch_add(1)) < jobs.size();) {
+      CompiledFence f;
+      f.kind = jobs[i].kind;
+      f.id = jobs[i].id;
+      if (compile_ring(*jobs[i].ring, f.kind, opt, &f.ring_e7, &errors[i])) {
+        out_vertices[i] = f.ring_e7.size() / 2;
+        build_fence_blob(f, &blobs[i], &errors[i], with_sdf ? &sdf : nullptr);
+      }
+    }
+  };
+  std::vector<std::thread> pool;
+  for (size_t t = 0; t < threads; ++t) pool.emplace_back(worker);
+  for (auto& t : pool) t.join();
+  double compile_ms = ms_since(t1);
+
+  bool failed = false;
+  for (size_t i = 0; i < jobs.size(); ++i) {
+    if (errors[i].empty()) continue;
+    fprintf(stderr, "feature %u (%s): %s\n", jobs[i].id,
+            jobs[i].kind == FenceKind::kKeepIn ? "keep-in" : "keep-out", errors[i].c_str());
+    failed = true;
+  }
+  if (failed) return 1;
+
+  auto t2 = Clock::now();
+  std::vector<uint8_t> image = assemble_fence_image(blobs);
+  double assemble_ms = ms_since(t2);
+  FILE* f = fopen(out_path, "wb");
+  if (!f || fwrite(image.data(), 1, image.size(), f) != image.size()) {
+    fprintf(stderr, "cannot write %s\n", out_path);
+    return 2;
+  }
+  fclose(f);
+
+  size_t total_out = 0, worst_cell = 0, sdf_bytes = 0;
+  double mean_cell = 0, sdf_error = 0;
+  for (size_t i = 0; i < jobs.size(); ++i) {
+    total_out += out_vertices[i];
+    sdf_bytes += blobs[i].sdf_bytes;
+    sdf_error = std::max(sdf_error, blobs[i].sdf_max_error_m);
+    worst_cell = std::max<size_t>(worst_cell, blobs[i].record.max_cell_edges);
+    mean_cell += blobs[i].mean_cell_edges;
+  }
+  printf("fences %zu  vertices %zu -> %zu (%.1f%%)  image %zu bytes\n", jobs.size(), in_vertices,
+         total_out, 100.0 * double(total_out) / double(std::max<size_t>(in_vertices, 1)),
+         image.size());
+  printf("parse %.1f ms  simplify+index %.1f ms on %zu threads  assemble %.1f ms\n", parse_ms,
+         compile_ms, threads, assemble_ms);
+  printf("grid: worst cell %zu edges, mean %.2f edges per cell\n", worst_cell,
+         jobs.empty() ? 0.0 : mean_cell / double(jobs.size()));
+  if (with_sdf) {
+    printf("distance rasters: %zu bytes, interpolation within %.1f m\n", sdf_bytes, sdf_error);
+  }
+
+  // Bind exactly as the firmware does and sample fixes over the data set.
+  std::vector<uint32_t> aligned((image.size() + 3) / 4);
+  memcpy(aligned.data(), image.data(), image.size());
+  geofence::FenceSet set;
+  geofence::FenceError bind = set.bind(reinterpret_cast<const uint8_t*>(aligned.data()),
+                                       image.size());
+  if (bind != geofence::FenceError::kNone) {
+    fprintf(stderr, "image does not bind (error %d)\n", static_cast<int>(bind));
+    return 1;
+  }
+  if (polys.empty() || samples == 0) return 0;
+
+  Box all;
+  std::vector<Box> boxes(polys.size());
+  for (size_t i = 0; i < polys.size(); ++i) {
+    for (const LatLon& q : polys[i].outer) {
+      boxes[i].add(q);
+      all.add(q);
+    }
+  }
+  std::mt19937 rng(11);
+  std::uniform_real_distribution<double> u(0.0, 1.0);
+  std::vector<std::pair<double, double>> fixes(samples);
+  for (size_t i = 0; i < samples; ++i) {
+    if (i % 2) {
+      // Half the fixes land close to a source vertex, where errors would be.
+      const SourcePolygon& p = polys[rng() % polys.size()];
+      const LatLon& q = p.outer[rng() % p.outer.size()];
+      double r = (tolerance + buffer + 5) * 2 / 111000.0;
+      fixes[i] = {q.lat + r * (u(rng) - 0.5), q.lon + r * (u(rng) - 0.5)};
+    } else {
+      fixes[i] = {all.min_lat + (all.max_lat - all.min_lat) * u(rng),
+                  all.min_lon + (all.max_lon - all.min_lon) * u(rng)};
+    }
+  }
+
+  uint64_t edges = 0, worst = 0;
+  size_t violations = 0, missed = 0;
+  auto t3 = Clock::now();
+  for (const auto& fx : fixes) {
+    geofence::FenceCheck c = set.check(static_cast<int32_t>(lround(fx.first * 1e7)),
+                                       static_cast<int32_t>(lround(fx.second * 1e7)));
+    edges += c.edges_tested;
+    worst = std::max<uint64_t>(worst, c.edges_tested);
+    violations += c.violation;
+  }
+  double check_ns = ms_since(t3) * 1e6 / double(samples);
+  for (const auto& fx : fixes) {
+    double lat = double(lround(fx.first * 1e7)) / 1e7, lon = double(lround(fx.second * 1e7)) / 1e7;
+    if (!source_violation(polys, boxes, any_keep_in, lat, lon)) continue;
+    if (!set.check(static_cast<int32_t>(lround(lat * 1e7)), static_cast<int32_t>(lround(lon * 1e7)))
+             .violation) {
+      ++missed;
+    }
+  }
+  printf("per fix: %zu bbox tests, %.2f edges mean, %llu worst; %.0f ns on this host\n",
+         set.count(), double(edges) / double(samples), static_cast<unsigned long long>(worst),
+         check_ns);
+  printf("sampled %zu fixes: %zu violate the compiled fences, %zu source violations missed\n",
+         samples, violations, missed);
+  return missed ? 1 : 0;
+}
@@ -0,0 +1,166 @@
+// Distance-raster lookups against exact edge distances on the same fences.
+//
+//   fence_sdf_bench [fences] [step_m] [queries]
+//
+// Compiles synthetic fences twice, with and without rasters, and queries
+// both through the firmware evaluator. Reports lookup cost, how often the
+// raster falls back to the edges, and the interpolation error against the
+// exact distance. Exits 1 if any error exceeds the recorded bound, any sign
+// disagrees with contains(), or a beyond-raster bound is not a lower bound.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "geofence/fence_set.h"
+#include "ground/fence/fence_sdf.h"
+#include "ground/fence/fence_simplify.h"
+#include "ground/fence/fence_writer.h"
+#include "sim/fence_synth.h"
+
+using namespace skyguard;
+using namespace skyguard::ground;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Query {
+  size_t fence;
+  int32_t lat_e7, lon_e7;
+};
+
+struct Bound {
+  std::vector<uint32_t> words;
+  geofence::FenceSet set;
+
+  bool bind(const std::vector<uint8_t>& image) {
+    words.assign((image.size() + 3) / 4, 0);
+    memcpy(words.data(), image.data(), image.size());
+    return set.bind(reinterpret_cast<const uint8_t*>(words.data()), image.size()) ==
+           geofence::FenceError::kNone;
+  }
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t n_fences = argc > 1 ? static_cast<size_t>(atol(argv[1])) : 50;
+  SdfOptions sdf;
+  sdf.step_m = argc > 2 ? atof(argv[2]) : 250;
+  size_t n_queries = argc > 3 ? static_cast<size_t>(atol(argv[3])) : 200000;
+
+  std::vector<SourcePolygon> polys;
+  sim::synthesize_fences(n_fences, 3, &polys);
+  std::vector<FenceBlob> with(polys.size()), without(polys.size());
+  std::string err;
+  auto t0 = Clock::now();
+  double raster_ms = 0;
+  for (size_t i = 0; i < polys.size(); ++i) {
+    CompiledFence f;
+    f.id = static_cast<uint16_t>(i);
+    if (!compile_ring(polys[i].outer, f.kind, SimplifyOptions{}, &f.ring_e7, &err) ||
+        !build_fence_blob(f, &without[i], &err)) {
+      fprintf(stderr, "fence %zu: %s\n", i, err.c_str());
+      return 2;
+    }
+    auto t = Clock::now();
+    build_fence_blob(f, &with[i], &err, &sdf);
+    raster_ms += std::chrono::duration<double, std::milli>(Clock::now() - t).count();
+  }
+  double build_ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+  Bound raster, exact;
+  if (!raster.bind(assemble_fence_image(with)) || !exact.bind(assemble_fence_image(without))) {
+    fprintf(stderr, "image does not bind\n");
+    return 2;
+  }
+
+  // Queries around each fence, half of them close to its boundary.
+  std::mt19937 rng(5);
+  std::uniform_real_distribution<double> u(0.0, 1.0);
+  std::vector<Query> queries(n_queries);
+  for (size_t q = 0; q < n_queries; ++q) {
+    size_t i = rng() % polys.size();
+    const geofence::FenceRecord& r = raster.set.record(i);
+    double pad = (sdf.margin_m + 1000) / geofence::kMetresPerLatE7;
+    if (q % 2) {
+      const LatLon& v = polys[i].outer[rng() % polys[i].outer.size()];
+      double near = 2 * sdf.step_m / geofence::kMetresPerLatE7;
+      queries[q] = {i, static_cast<int32_t>(v.lat * 1e7 + near * (u(rng) - 0.5)),
+                    static_cast<int32_t>(v.lon * 1e7 + near * (u(rng) - 0.5))};
+    } else {
+      double h = r.max_lat_e7 - r.min_lat_e7 + 2 * pad, w = r.max_lon_e7 - r.min_lon_e7 + 2 * pad;
+      queries[q] = {i, static_cast<int32_t>(r.min_lat_e7 - pad + h * u(rng)),
+                    static_cast<int32_t>(r.min_lon_e7 - pad + w * u(rng))};
+    }
+  }
+
+  volatile float sink = 0;
+  auto t1 = Clock::now();
+  for (const Query& q : queries) {
+    sink = sink + raster.set.distance(q.fence, q.lat_e7, q.lon_e7).metres;
+  }
+  auto t2 = Clock::now();
+  for (const Query& q : queries) {
+    sink = sink + exact.set.distance(q.fence, q.lat_e7, q.lon_e7).metres;
+  }
+  auto t3 = Clock::now();
+  double raster_ns = std::chrono::duration<double, std::nano>(t2 - t1).count() / n_queries;
+  double exact_ns = std::chrono::duration<double, std::nano>(t3 - t2).count() / n_queries;
+
+  size_t interpolated = 0, fallback = 0, beyond = 0, over_bound = 0, bad_sign = 0, bad_lower = 0;
+  double max_err = 0, sum_err = 0, max_ratio = 0, max_fallback_err = 0;
+  std::vector<double> errors;
+  for (const Query& q : queries) {
+    geofence::FenceDistance d = raster.set.distance(q.fence, q.lat_e7, q.lon_e7);
+    float truth = exact.set.distance(q.fence, q.lat_e7, q.lon_e7).metres;
+    bool inside = raster.set.contains(q.fence, q.lat_e7, q.lon_e7);
+    if (d.metres != 0 && (d.metres < 0) != inside) ++bad_sign;
+    if (d.lower_bound) {
+      ++beyond;
+      if (d.metres > truth + 0.05f) ++bad_lower;
+      continue;
+    }
+    double e = fabs(double(d.metres) - truth);
+    if (d.exact) {
+      ++fallback;
+      max_fallback_err = std::max(max_fallback_err, e);
+      continue;
+    }
+    ++interpolated;
+    double bound = with[q.fence].sdf_max_error_m;
+    if (e > bound) ++over_bound;
+    max_ratio = std::max(max_ratio, e / bound);
+    max_err = std::max(max_err, e);
+    sum_err += e;
+    errors.push_back(e);
+  }
+  std::sort(errors.begin(), errors.end());
+  size_t raster_bytes = 0;
+  double bound = 0;
+  for (const FenceBlob& b : with) {
+    raster_bytes += b.sdf_bytes;
+    bound = std::max(bound, b.sdf_max_error_m);
+  }
+
+  printf("%zu fences, %.0f m step: rasters %zu bytes, built in %.0f ms (%.0f ms total)\n",
+         polys.size(), sdf.step_m, raster_bytes, raster_ms, build_ms);
+  printf("distance(): raster %.0f ns, exact over all edges %.0f ns per query\n", raster_ns,
+         exact_ns);
+  printf("%zu queries: %zu interpolated, %zu measured near the edge, %zu beyond the raster\n",
+         n_queries, interpolated, fallback, beyond);
+  printf("interpolation error: mean %.2f m, p99 %.2f m, max %.2f m; bound %.1f m (worst %.0f%%)\n",
+         errors.empty() ? 0 : sum_err / double(errors.size()),
+         errors.empty() ? 0 : errors[errors.size() * 99 / 100], max_err, bound, 100 * max_ratio);
+  printf("edge fallback error: max %.3f m (float evaluation)\n", max_fallback_err);
+  printf("over bound %zu, sign mismatches %zu, bad lower bounds %zu\n", over_bound, bad_sign,
+         bad_lower);
+  return over_bound || bad_sign || bad_lower ? 1 : 0;
+}
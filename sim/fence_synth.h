@@ -0,0 +1,38 @@
+// Synthetic airspace boundaries for the fence tools and benchmarks: noisy
+// closed curves a few kilometres to tens of kilometres across, scattered
+// over a national-scale region.
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+
+#include <random>
+#include <vector>
+
+#include "ground/fence/fence_source.h"
+
+namespace skyguard::sim {
+
+inline void synthesize_fences(size_t count, uint32_t seed,
+                              std::vector<ground::SourcePolygon>* out) {
+  constexpr double kPi = 3.14159265358979323846;
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> lat(36.0, 50.0), lon(-5.0, 15.0), u(0.0, 1.0);
+  for (size_t i = 0; i < count; ++i) {
+    ground::SourcePolygon p;
+    p.id = static_cast<uint16_t>(i);
+    double clat = lat(rng), clon = lon(rng);
+    double radius_deg = 0.02 + 0.2 * u(rng);
+    size_t n = 500 + static_cast<size_t>(3500 * u(rng));
+    // Survey-style noise: a few smooth lobes plus fine jitter.
+    double a1 = 0.15 * u(rng), a2 = 0.05 * u(rng), ph = 2 * kPi * u(rng);
+    for (size_t k = 0; k < n; ++k) {
+      double t = 2 * kPi * double(k) / double(n);
+      double r = radius_deg * (1 + a1 * sin(3 * t + ph) + a2 * sin(11 * t) + 0.004 * u(rng));
+      p.outer.push_back({clat + r * sin(t), clon + r * cos(t) / cos(clat * kPi / 180)});
+    }
+    out->push_back(std::move(p));
+  }
+}
+
+}  // namespace skyguard::sim
@@ -0,0 +1,310 @@
+// Synthetic flight corpora: throughput, reproducibility, and a Monte Carlo
+// run of the termination rules.
+//
+//   flight_corpus [flights] [seed] [threads]
+//
+// Generates `flights` FlightSynth flights at the 10 Hz rule tick across
+// worker threads, hashing every sensor stream, and reports samples per
+// second. A slice of the corpus is then regenerated on one thread in
+// reverse order and must hash identically; a different seed must not.
+// The standard atmosphere table is checked against the published layer
+// values, and every flight against loose physical bounds (burst and float
+// levels, descent rate, landing).
+//
+// The Monte Carlo pass closes the loop: each flight's GPS, IMU, battery
+// and link streams drive a TerminationEngine with the default rules and a
+// 150 km keep-in circle around the launch site (plus a ground-commanded
+// cut on one flight in ten), and a cut terminates the synthetic flight.
+// Prints which rules cut how many flights, and where.
+//
+// Exits 1 if a check fails or generation runs below kMinSamplesPerS per
+// thread.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sim/flight_synth.h"
+#include "termination/termination_engine.h"
+
+using namespace skyguard;
+using namespace skyguard::sim;
+using termination::RuleInputs;
+using termination::TerminationEngine;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+constexpr double kMinSamplesPerS = 1e6;
+constexpr double kFenceRadiusM = 150000;
+constexpr uint32_t kArmAfterMs = 60000;
+constexpr uint32_t kFreefallMg2 = 300u * 300u;  // as FlightSystem
+constexpr uint8_t kFreefallSamples = 5;
+
+struct FlightStats {
+  uint64_t hash = 0;
+  uint64_t samples = 0;
+  double max_alt_m = 0;
+  double max_sink_mps = 0;
+  double ascent_mps = 0;  // mean, pad to top
+  bool landed = false;
+};
+
+struct Outcome {
+  int rule = -1;  // -1: no cut
+  SynthPhase phase_at_cut = SynthPhase::kPad;
+  double alt_at_cut_m = 0;
+  double landing_margin_m = 0;  // negative outside the keep-in circle
+  bool freefall_seen = false;
+};
+
+uint64_t mix(uint64_t h, uint64_t v) { return (h ^ v) * 0x100000001B3ull; }
+
+double distance_m(double lat0, double lon0, double lat1, double lon1) {
+  double dn = (lat1 - lat0) * 111195.0;
+  double de = (lon1 - lon0) * 111195.0 * cos(lat0 * 0.017453292519943295);
+  return sqrt(dn * dn + de * de);
+}
+
+FlightStats generate(const SynthConfig& cfg, uint64_t seed, uint64_t flight) {
+  FlightSynth synth(cfg, seed, flight);
+  FlightStats st;
+  st.hash = 0xCBF29CE484222325ull;
+  SynthSample s;
+  uint32_t top_ms = 0;
+  while (synth.next(&s)) {
+    ++st.samples;
+    uint64_t h = st.hash;
+    h = mix(h, s.time_ms);
+    if (s.gps_new) {
+      h = mix(h, static_cast<uint32_t>(s.gps.lat_e7));
+      h = mix(h, static_cast<uint32_t>(s.gps.lon_e7));
+      h = mix(h, static_cast<uint32_t>(s.gps.alt_mm));
+    }
+    h = mix(h, static_cast<uint16_t>(s.accel_mg[2]) | uint64_t(uint16_t(s.accel_mg[0])) << 16);
+    h = mix(h, static_cast<uint32_t>(s.baro_pa) | uint64_t(s.battery_mv) << 32);
+    h = mix(h, static_cast<uint16_t>(s.temp_c10) | uint64_t(s.link_up) << 16);
+    st.hash = h;
+    if (s.alt_m > st.max_alt_m) {
+      st.max_alt_m = s.alt_m;
+      top_ms = s.time_ms;
+    }
+    st.max_sink_mps = std::max(st.max_sink_mps, s.vel_d_mps);
+    st.landed = s.phase == SynthPhase::kLanded;
+  }
+  const SynthPlan& p = synth.plan();
+  double climb_s = top_ms / 1000.0 - cfg.pad_s;
+  st.ascent_mps = climb_s > 0 ? (st.max_alt_m - p.launch_alt_m) / climb_s : 0;
+  return st;
+}
+
+Outcome monte_carlo(const SynthConfig& cfg, uint64_t seed, uint64_t flight) {
+  FlightSynth synth(cfg, seed, flight);
+  const SynthPlan& p = synth.plan();
+  SynthRng rng(seed * 31 + flight);
+  double remote_s = rng.chance(0.1) ? rng.uniform(1800, 4 * 3600) : -1;
+  TerminationEngine engine;
+  Outcome o;
+  SynthSample s;
+  app::GpsFix fix{};
+  bool have_fix = false;
+  uint32_t last_link_ms = 0;
+  uint8_t freefall_run = 0;
+  while (synth.next(&s)) {
+    if (s.gps_new) {
+      fix = s.gps;
+      have_fix = true;
+    }
+    if (s.link_up) last_link_ms = s.time_ms;
+    uint32_t mag2 = 0;
+    for (int16_t a : s.accel_mg) mag2 += static_cast<uint32_t>(a * a);
+    freefall_run = mag2 < kFreefallMg2 ? std::min<uint8_t>(freefall_run + 1, kFreefallSamples)
+                                       : 0;
+    double flight_s = s.time_ms / 1000.0 - cfg.pad_s;
+    RuleInputs in{};
+    in.time_ms = s.time_ms;
+    in.armed = s.time_ms >= kArmAfterMs;
+    in.cut_command = remote_s > 0 && flight_s >= remote_s && flight_s < remote_s + 2;
+    double lat = have_fix ? fix.lat_e7 * 1e-7 : p.launch_lat_deg;
+    double lon = have_fix ? fix.lon_e7 * 1e-7 : p.launch_lon_deg;
+    in.fence_margin_m = static_cast<int32_t>(
+        kFenceRadiusM - distance_m(p.launch_lat_deg, p.launch_lon_deg, lat, lon));
+    in.alt_m = have_fix ? fix.alt_mm / 1000 : static_cast<int32_t>(p.launch_alt_m);
+    in.flight_s = flight_s > 0 ? static_cast<uint32_t>(flight_s) : 0;
+    in.fix_age_ms = have_fix ? s.time_ms - fix.time_ms : s.time_ms;
+    in.link_silence_s = (s.time_ms - last_link_ms) / 1000;
+    in.battery_mv = s.battery_mv;
+    in.freefall = freefall_run >= kFreefallSamples;
+    in.traffic_m = UINT32_MAX;
+    o.freefall_seen |= in.freefall;
+    bool was_cut = engine.cut();
+    if (engine.evaluate(in) && !was_cut) {
+      o.rule = engine.fired_rule();
+      o.phase_at_cut = s.phase;
+      o.alt_at_cut_m = s.alt_m;
+      synth.terminate();
+    }
+  }
+  o.landing_margin_m =
+      kFenceRadiusM - distance_m(p.launch_lat_deg, p.launch_lon_deg, s.lat_deg, s.lon_deg);
+  return o;
+}
+
+template <typename Fn>
+void parallel_for(size_t n, size_t threads, Fn fn) {
+  std::atomic<size_t> next{0};
+  auto worker = [&] {
+    for (size_t i; (i = next.fetch_add(1)) < n;) fn(i);
+  };
+  std::vector<std::thread> pool;
+  for (size_t t = 0; t < threads; ++t) pool.emplace_back(worker);
+  for (auto& t : pool) t.join();
+}
+
+double since_s(Clock::time_point t) {
+  return std::chrono::duration<double>(Clock::now() - t).count();
+}
+
+std::string rule_name(const TerminationEngine& e, int rule) {
+  if (rule < 0) return "no cut";
+  std::string out;
+  uint16_t mask = e.rule_mask(static_cast<size_t>(rule));
+  for (size_t c = 0; c < termination::kConditionCount; ++c) {
+    if (!(mask >> c & 1)) continue;
+    if (!out.empty()) out += "+";
+    out += termination::kConditionNames[c];
+  }
+  return out;
+}
+
+double percentile(std::vector<double> v, double q) {
+  if (v.empty()) return 0;
+  std::sort(v.begin(), v.end());
+  return v[static_cast<size_t>(q * (v.size() - 1))];
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t n = argc > 1 ? static_cast<size_t>(atol(argv[1])) : 200;
+  uint64_t seed = argc > 2 ? strtoull(argv[2], nullptr, 0) : 1;
+  size_t threads = argc > 3 ? static_cast<size_t>(std::max(1, atoi(argv[3])))
+                            : std::max(1u, std::thread::hardware_concurrency());
+  size_t failures = 0;
+
+  // The table against the published layer boundaries, and its
+  // interpolation against the formulas.
+  const double kIsa[][2] = {{0, 101325}, {11000, 22632.1}, {20000, 5474.89},
+                            {32000, 868.019}, {47000, 110.906}};
+  const Atmosphere& atm = Atmosphere::standard();
+  double worst = 0;
+  for (const auto& row : kIsa) {
+    double t_k, pa;
+    atm.at(row[0], &t_k, &pa);
+    worst = std::max(worst, fabs(pa / row[1] - 1));
+  }
+  SynthRng probe(seed);
+  for (int i = 0; i < 100000; ++i) {
+    double alt = probe.uniform(0, 50000), t0, p0, t1, p1;
+    atm.at(alt, &t0, &p0);
+    Atmosphere::exact(alt, &t1, &p1);
+    worst = std::max(worst, fabs(p0 / p1 - 1));
+  }
+  printf("standard atmosphere: worst pressure error %.2e\n", worst);
+  if (worst > 1e-4) ++failures;
+
+  SynthConfig cfg;
+  std::vector<FlightStats> stats(n);
+  auto t = Clock::now();
+  parallel_for(n, threads, [&](size_t i) { stats[i] = generate(cfg, seed, i); });
+  double gen_s = since_s(t);
+  uint64_t samples = 0;
+  for (const FlightStats& s : stats) samples += s.samples;
+  double rate = samples / gen_s;
+  printf("%zu flights, %llu samples (%.1f flight-hours) in %.2f s on %zu threads: "
+         "%.1f M samples/s (%.1f M/s per thread)\n",
+         n, static_cast<unsigned long long>(samples), samples * cfg.step_ms / 3.6e6, gen_s,
+         threads, rate / 1e6, rate / threads / 1e6);
+  if (rate / threads < kMinSamplesPerS) {
+    printf("  below %.0f samples/s per thread\n", kMinSamplesPerS);
+    ++failures;
+  }
+
+  // Same flights, other order and thread: same streams. Other seed: not.
+  size_t slice = std::min<size_t>(n, 16), differ = 0, repro = 0;
+  for (size_t k = slice; k-- > 0;) {
+    repro += generate(cfg, seed, k).hash != stats[k].hash;
+    differ += generate(cfg, seed + 1, k).hash != stats[k].hash;
+  }
+  printf("reproducibility: %zu of %zu regenerated flights differ; %zu of %zu differ under "
+         "another seed\n",
+         repro, slice, differ, slice);
+  if (repro || differ != slice) ++failures;
+
+  std::vector<double> burst_alt, float_alt, sink, ascent;
+  size_t bad = 0;
+  for (size_t i = 0; i < n; ++i) {
+    FlightSynth synth(cfg, seed, i);
+    const SynthPlan& p = synth.plan();
+    const FlightStats& s = stats[i];
+    (p.floats ? float_alt : burst_alt).push_back(s.max_alt_m);
+    sink.push_back(s.max_sink_mps);
+    if (!p.floats) ascent.push_back(s.ascent_mps);
+    bool ok = s.landed && s.max_alt_m >= p.burst_m - 200 && s.max_alt_m <= p.burst_m + 400 &&
+              s.max_sink_mps > 15 && s.max_sink_mps < 90 &&
+              (p.floats || (s.ascent_mps > 3.5 && s.ascent_mps < 9));
+    if (!ok) {
+      if (bad++ < 5) {
+        printf("  flight %zu out of bounds: top %.0f m (plan %.0f), sink %.1f m/s, "
+               "ascent %.2f m/s, %s\n",
+               i, s.max_alt_m, p.burst_m, s.max_sink_mps, s.ascent_mps,
+               s.landed ? "landed" : "still up");
+      }
+    }
+  }
+  printf("burst %zu: top p5/p50/p95 %.1f/%.1f/%.1f km; float %zu: level p50 %.1f km\n",
+         burst_alt.size(), percentile(burst_alt, 0.05) / 1e3, percentile(burst_alt, 0.5) / 1e3,
+         percentile(burst_alt, 0.95) / 1e3, float_alt.size(), percentile(float_alt, 0.5) / 1e3);
+  printf("mean ascent p50 %.2f m/s; peak sink p5/p50/p95 %.1f/%.1f/%.1f m/s; "
+         "%zu flights out of bounds\n",
+         percentile(ascent, 0.5), percentile(sink, 0.05), percentile(sink, 0.5),
+         percentile(sink, 0.95), bad);
+  failures += bad;
+
+  // Monte Carlo with the termination rules in the loop.
+  std::vector<Outcome> outcomes(n);
+  t = Clock::now();
+  parallel_for(n, threads, [&](size_t i) { outcomes[i] = monte_carlo(cfg, seed, i); });
+  double mc_s = since_s(t);
+  TerminationEngine names;
+  printf("\nMonte Carlo (%.2f s, %.1f flights/s):\n", mc_s, n / mc_s);
+  printf("  %-26s %7s %8s %12s %14s\n", "cut by", "flights", "share", "alt p50 km",
+         "landed outside");
+  for (int rule = -1; rule < static_cast<int>(termination::kDefaultRuleCount); ++rule) {
+    std::vector<double> alts;
+    size_t outside = 0;
+    for (const Outcome& o : outcomes) {
+      if (o.rule != rule) continue;
+      alts.push_back(o.alt_at_cut_m);
+      outside += o.landing_margin_m < 0;
+    }
+    if (alts.empty()) continue;
+    printf("  %-26s %7zu %7.1f%% %12.1f %14zu\n", rule_name(names, rule).c_str(), alts.size(),
+           100.0 * alts.size() / n, rule < 0 ? 0 : percentile(alts, 0.5) / 1e3, outside);
+  }
+  // Every flight ends in a burst or a cut, which the IMU stream must show.
+  size_t missed_freefall = 0;
+  for (const Outcome& o : outcomes) missed_freefall += !o.freefall_seen;
+  printf("  freefall missed on %zu flights\n", missed_freefall);
+  failures += missed_freefall;
+
+  printf("\nfailures %zu\n", failures);
+  return failures ? 1 : 0;
+}
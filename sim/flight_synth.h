@@ -0,0 +1,430 @@
+// Synthetic balloon flights for Monte Carlo and regression corpora.
+//
+// FlightSynth steps one flight at a fixed tick and yields what the firmware
+// would be fed: GPS fixes as app::GpsFix (white noise, a wandering
+// multipath bias, outliers, dropouts and an optional receiver altitude
+// limit), IMU specific force, barometric pressure and temperature, battery
+// voltage and link state, next to the true trajectory.
+//
+// Physics, kept cheap enough for millions of samples a second per core,
+// shares its atmosphere and vertical rates with the launch planner
+// (ground/planning/balloon_model.h): the standard atmosphere with
+// per-flight surface pressure and temperature perturbations; a free-lift
+// ascent, then burst, or a float at a fixed level until terminate() or
+// the float time runs out; a short freefall, then a parachute descent. Wind comes from a
+// per-flight layered profile (surface, jet, stratosphere) with linear
+// shear between layers and first-order gusts.
+//
+// A flight depends only on (seed, flight index), so flights can be
+// generated in any order, on any thread, and come out bit for bit the same.
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+
+#include <algorithm>
+
+#include "app/flight_system.h"
+#include "ground/planning/balloon_model.h"
+
+namespace skyguard::sim {
+
+using ground::Atmosphere;
+
+/// xoshiro256** seeded through splitmix64. Normals come from an inverse
+/// CDF table, so their tails stop near 3.7 sigma; model outliers
+/// explicitly.
+class SynthRng {
+ public:
+  explicit SynthRng(uint64_t seed) {
+    for (uint64_t& s : s_) {
+      seed += 0x9E3779B97F4A7C15ull;
+      uint64_t z = seed;
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+      s = z ^ (z >> 31);
+    }
+  }
+  uint64_t next() {
+    uint64_t r = rotl(s_[1] * 5, 7) * 9, t = s_[1] << 17;
+    s_[2] ^= s_[0];
+    s_[3] ^= s_[1];
+    s_[1] ^= s_[2];
+    s_[0] ^= s_[3];
+    s_[2] ^= t;
+    s_[3] = rotl(s_[3], 45);
+    return r;
+  }
+  /// [0, 1)
+  double uniform() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+  double uniform(double lo, double hi) { return lo + (hi - lo) * uniform(); }
+  double normal() {
+    static const NormalTable table;
+    uint64_t r = next();
+    size_t i = static_cast<size_t>(r >> (64 - NormalTable::kBits));
+    double f = static_cast<double>(r & 0xFFFFFFFF) * 0x1.0p-32;
+    return table.z[i] + f * (table.z[i + 1] - table.z[i]);
+  }
+  bool chance(double p) { return uniform() < p; }
+
+ private:
+  // z[i] = the standard normal quantile at (i + 0.5) / 2^kBits.
+  struct NormalTable {
+    static constexpr int kBits = 12;
+    static constexpr size_t kSize = size_t{1} << kBits;
+    double z[kSize + 1];
+    NormalTable() {
+      for (size_t i = 0; i < kSize; ++i) {
+        double p = (i + 0.5) / kSize, lo = -10, hi = 10;
+        for (int k = 0; k < 64; ++k) {
+          double mid = (lo + hi) / 2;
+          (0.5 * erfc(-mid / sqrt(2.0)) < p ? lo : hi) = mid;
+        }
+        z[i] = (lo + hi) / 2;
+      }
+      z[kSize] = z[kSize - 1];
+    }
+  };
+  static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+  uint64_t s_[4];
+};
+
+enum class SynthPhase : uint8_t { kPad, kAscent, kFloat, kDescent, kLanded };
+
+struct SynthConfig {
+  uint32_t step_ms = 100;  // the rule tick
+  uint32_t gps_period_ms = 1000;
+  uint32_t pad_s = 120;
+  double float_share = 0.3;        // flights that float instead of bursting
+  double gps_dropouts_per_h = 1.5;
+  double baro_dropouts_per_h = 0.5;
+  double link_outages_per_h = 0.4;
+  double gps_outliers_per_h = 0.5;
+  int32_t gps_ceiling_m = 0;       // receiver altitude limit; 0 for none
+  uint32_t max_float_s = 6 * 3600;
+};
+
+/// Per-flight parameters, drawn from the seed.
+struct SynthPlan {
+  bool floats;
+  double launch_lat_deg, launch_lon_deg, launch_alt_m;
+  double ascent_mps;       // at sea level
+  double burst_m;          // burst, or float level when `floats`
+  double float_s;
+  double descent_mps;      // under canopy, at sea level
+  double surface_dp_pa;    // pressure anomaly
+  double temp_offset_k;    // near the ground, fading with height
+  double drain_mv_per_h;
+  static constexpr int kWindLayers = 6;
+  double wind_alt_m[kWindLayers];
+  double wind_e_mps[kWindLayers], wind_n_mps[kWindLayers];
+};
+
+struct SynthSample {
+  uint32_t time_ms;
+  SynthPhase phase;
+  // Truth.
+  double lat_deg, lon_deg, alt_m;
+  double vel_n_mps, vel_e_mps, vel_d_mps;
+  double air_pa, air_temp_c;
+  // Sensor streams.
+  bool gps_new;      // `gps` arrived on this tick
+  app::GpsFix gps;   // the latest fix
+  int16_t accel_mg[3];
+  bool baro_valid;
+  int32_t baro_pa;
+  int16_t temp_c10;
+  uint16_t battery_mv;
+  bool link_up;
+};
+
+class FlightSynth {
+ public:
+  FlightSynth(const SynthConfig& cfg, uint64_t seed, uint64_t flight)
+      : cfg_(cfg), rng_(seed ^ (flight + 1) * 0xD1B54A32D192ED03ull) {
+    SynthPlan& p = plan_;
+    p.floats = rng_.chance(cfg.float_share);
+    p.launch_lat_deg = rng_.uniform(30, 55);
+    p.launch_lon_deg = rng_.uniform(-120, 20);
+    p.launch_alt_m = rng_.uniform(0, 1500);
+    p.ascent_mps = rng_.uniform(4, 6.5);
+    p.burst_m = p.floats ? rng_.uniform(28000, 38000) : rng_.uniform(24000, 34500);
+    p.float_s = p.floats ? rng_.uniform(1800, cfg.max_float_s) : 0;
+    p.descent_mps = rng_.uniform(4.5, 6.5);
+    p.surface_dp_pa = 900 * rng_.normal();
+    p.temp_offset_k = 7 * rng_.normal();
+    p.drain_mv_per_h = rng_.uniform(40, 160);
+    // Surface, boundary layer top, jet base, jet core, lower and upper
+    // stratosphere, as speed and the direction the air moves towards
+    // (radians from east); the shear sits in between.
+    constexpr double kTwoPi = 6.283185307179586;
+    double surface_dir = rng_.uniform(0, kTwoPi), jet_dir = 0.4 * rng_.normal();
+    double jet = rng_.uniform(10, 60);
+    const double alts[] = {0,
+                           rng_.uniform(800, 2000),
+                           rng_.uniform(6000, 8500),
+                           rng_.uniform(9500, 12500),
+                           rng_.uniform(17000, 22000),
+                           rng_.uniform(28000, 34000)};
+    const double speeds[] = {rng_.uniform(0, 8), rng_.uniform(3, 15), jet * 0.5,
+                             jet,                rng_.uniform(0, 8),  rng_.uniform(-15, 15)};
+    const double dirs[] = {surface_dir, surface_dir + 0.5 * rng_.normal(), jet_dir,
+                           jet_dir,     rng_.uniform(0, kTwoPi),          0};
+    for (int i = 0; i < SynthPlan::kWindLayers; ++i) {
+      p.wind_alt_m[i] = p.launch_alt_m + alts[i];
+      p.wind_e_mps[i] = speeds[i] * cos(dirs[i]);
+      p.wind_n_mps[i] = speeds[i] * sin(dirs[i]);
+    }
+    baro_offset_pa_ = 40 * rng_.normal();
+    swing_period_s_ = rng_.uniform(3, 8);
+    swing_mg_ = rng_.uniform(20, 80);
+
+    s_ = SynthSample{};
+    s_.lat_deg = p.launch_lat_deg;
+    s_.lon_deg = p.launch_lon_deg;
+    s_.alt_m = p.launch_alt_m;
+    s_.phase = SynthPhase::kPad;
+    s_.link_up = true;
+    double t_k, pa;
+    air(p.launch_alt_m, &t_k, &pa);
+    temp_c_ = t_k - 273.15;
+    rho_ratio_ = Atmosphere::density_ratio(t_k, pa);
+    cos_lat_ = cos(p.launch_lat_deg * 0.017453292519943295);
+    // First-order (Ornstein-Uhlenbeck) gusts, 1.5 m/s over 30 s, and GPS
+    // bias, 3 m over 300 s, discretized at their update steps.
+    gust_a_ = cfg.step_ms / 30000.0;
+    gust_k_ = 1.5 * sqrt(2 * gust_a_);
+    bias_a_ = cfg.gps_period_ms / 300000.0;
+    bias_k_ = 3 * sqrt(2 * bias_a_);
+  }
+
+  const SynthPlan& plan() const { return plan_; }
+  SynthPhase phase() const { return s_.phase; }
+
+  /// Cuts the flight train now, as the termination unit would: the
+  /// payload falls, then descends under its canopy.
+  void terminate() {
+    if (s_.phase == SynthPhase::kAscent || s_.phase == SynthPhase::kFloat) start_descent();
+  }
+
+  /// Next tick. Returns false once the payload has been down for a minute.
+  bool next(SynthSample* out) {
+    if (s_.phase == SynthPhase::kLanded && s_.time_ms - landed_ms_ >= 60000) return false;
+    const double dt = cfg_.step_ms / 1000.0;
+    if (started_) s_.time_ms += cfg_.step_ms;
+    started_ = true;
+    double t = s_.time_ms / 1000.0;
+    const SynthPlan& p = plan_;
+
+    double rho_ratio = rho_ratio_;  // at the start of the tick
+    double accel_up = 0;            // besides gravity
+    switch (s_.phase) {
+      case SynthPhase::kPad:
+        if (t >= cfg_.pad_s) {
+          s_.phase = SynthPhase::kAscent;
+          phase_start_s_ = t;
+        }
+        break;
+      case SynthPhase::kAscent: {
+        double climb = ground::ascent_rate_mps(p.ascent_mps, rho_ratio);
+        if (p.floats) {
+          // Vents lift on the way in to the float level.
+          double left = p.burst_m - s_.alt_m;
+          climb *= left < 1500 ? std::max(0.0, left / 1500) : 1.0;
+          if (left < 30) {
+            s_.phase = SynthPhase::kFloat;
+            phase_start_s_ = t;
+          }
+        } else if (s_.alt_m >= p.burst_m) {
+          start_descent();
+        }
+        vz_ = climb;
+        break;
+      }
+      case SynthPhase::kFloat: {
+        double ft = t - phase_start_s_;
+        // Diurnal and gravity-wave oscillation about the float level.
+        double target = p.burst_m + 120 * sin(ft / 7000) + 25 * sin(ft / 260);
+        vz_ = (target - s_.alt_m) / 20;
+        if (ft >= p.float_s) start_descent();
+        break;
+      }
+      case SynthPhase::kDescent: {
+        double terminal = ground::descent_rate_mps(p.descent_mps, rho_ratio);
+        if (t - phase_start_s_ < freefall_s_) {
+          vz_ = std::max(vz_ - 9.81 * dt, -terminal);
+          accel_up = -9.81;  // specific force near zero while falling free
+        } else {
+          // The canopy opens and drags the payload to its descent rate.
+          accel_up = (-terminal - vz_) / 4;
+          vz_ += accel_up * dt;
+        }
+        if (s_.alt_m <= p.launch_alt_m) {
+          s_.phase = SynthPhase::kLanded;
+          landed_ms_ = s_.time_ms;
+        }
+        break;
+      }
+      case SynthPhase::kLanded:
+        vz_ = 0;
+        break;
+    }
+
+    // Wind and gusts; the balloon drifts with the air once off the pad.
+    double we = 0, wn = 0;
+    if (s_.phase != SynthPhase::kPad && s_.phase != SynthPhase::kLanded) {
+      wind(s_.alt_m, &we, &wn);
+      gust_e_ += -gust_a_ * gust_e_ + gust_k_ * rng_.normal();
+      gust_n_ += -gust_a_ * gust_n_ + gust_k_ * rng_.normal();
+      we += gust_e_;
+      wn += gust_n_;
+    }
+    s_.alt_m = std::max(p.launch_alt_m, s_.alt_m + vz_ * dt);
+    s_.vel_e_mps = we;
+    s_.vel_n_mps = wn;
+    s_.vel_d_mps = -vz_;
+    constexpr double kDegPerM = 1.0 / 111195.0;
+    s_.lat_deg += wn * dt * kDegPerM;
+    s_.lon_deg += we * dt * kDegPerM / cos_lat_;
+    double t_k, pa;
+    air(s_.alt_m, &t_k, &pa);
+    s_.air_pa = pa;
+    s_.air_temp_c = t_k - 273.15;
+    rho_ratio_ = Atmosphere::density_ratio(t_k, pa);
+
+    sense_imu(t, accel_up);
+    sense_baro(dt);
+    sense_gps();
+    sense_power_and_link(t, dt);
+    *out = s_;
+    s_.gps_new = false;
+    return true;
+  }
+
+ private:
+  void air(double alt_m, double* t_k, double* pa) const {
+    Atmosphere::standard().at(alt_m, t_k, pa);
+    *pa *= 1 + plan_.surface_dp_pa / Atmosphere::kSeaLevelPa;
+    *t_k += plan_.temp_offset_k * exp(-alt_m / 11000) + 1.5 * sin(alt_m / 950);
+  }
+  void wind(double alt_m, double* e, double* n) const {
+    const SynthPlan& p = plan_;
+    int i = 0;
+    while (i + 2 < SynthPlan::kWindLayers && alt_m >= p.wind_alt_m[i + 1]) ++i;
+    double f = (alt_m - p.wind_alt_m[i]) / (p.wind_alt_m[i + 1] - p.wind_alt_m[i]);
+    f = f < 0 ? 0 : f > 1 ? 1 : f;
+    *e = p.wind_e_mps[i] + f * (p.wind_e_mps[i + 1] - p.wind_e_mps[i]);
+    *n = p.wind_n_mps[i] + f * (p.wind_n_mps[i + 1] - p.wind_n_mps[i]);
+  }
+  void start_descent() {
+    s_.phase = SynthPhase::kDescent;
+    phase_start_s_ = s_.time_ms / 1000.0;
+    freefall_s_ = rng_.uniform(1.5, 4);
+    vz_ = 0;
+  }
+
+  void sense_imu(double t, double accel_up) {
+    bool falling = accel_up <= -9.8;
+    bool still = s_.phase == SynthPhase::kPad || s_.phase == SynthPhase::kLanded;
+    double swing = still || falling ? 0 : swing_mg_;
+    if (s_.phase == SynthPhase::kDescent) swing *= 3;  // canopy oscillation
+    double ph = 6.283185307179586 * t / swing_period_s_;
+    double noise = falling ? 60 : 8;  // tumbling
+    double up = 1000 + accel_up / 9.81 * 1000;
+    s_.accel_mg[0] = clamp16(swing * sin(ph) + noise * rng_.normal());
+    s_.accel_mg[1] = clamp16(0.5 * swing * cos(ph) + noise * rng_.normal());
+    s_.accel_mg[2] = clamp16(up + noise * rng_.normal());
+  }
+
+  void sense_baro(double dt) {
+    double per_tick = cfg_.baro_dropouts_per_h * dt / 3600;
+    if (baro_out_s_ <= 0 && rng_.chance(per_tick)) baro_out_s_ = rng_.uniform(1, 20);
+    baro_out_s_ -= dt;
+    s_.baro_valid = baro_out_s_ <= 0;
+    s_.baro_pa = static_cast<int32_t>(s_.air_pa + baro_offset_pa_ + 3 * rng_.normal());
+    // Sensor lag, plus solar heating that grows as the air thins.
+    double heating = 4 * (1 - s_.air_pa / Atmosphere::kSeaLevelPa);
+    temp_c_ += (s_.air_temp_c + heating - temp_c_) * dt / 20;
+    s_.temp_c10 = clamp16(10 * temp_c_ + rng_.normal());
+  }
+
+  void sense_gps() {
+    double dt = cfg_.step_ms / 1000.0;
+    if (gps_out_s_ <= 0 && rng_.chance(cfg_.gps_dropouts_per_h * dt / 3600)) {
+      gps_out_s_ = 5 + 60 * -log(1 - rng_.uniform());
+    }
+    gps_out_s_ -= dt;
+    if (s_.time_ms < next_fix_ms_) return;
+    next_fix_ms_ = s_.time_ms + cfg_.gps_period_ms;
+    // The multipath bias wanders over minutes; the latitude scale barely
+    // moves between fixes.
+    bias_e_ += -bias_a_ * bias_e_ + bias_k_ * rng_.normal();
+    bias_n_ += -bias_a_ * bias_n_ + bias_k_ * rng_.normal();
+    bias_u_ += -bias_a_ * bias_u_ + 2 * bias_k_ * rng_.normal();
+    cos_lat_ = cos(s_.lat_deg * 0.017453292519943295);
+    if (gps_out_s_ > 0) return;
+    if (cfg_.gps_ceiling_m > 0 && s_.alt_m > cfg_.gps_ceiling_m) return;
+    if (rng_.chance(0.05)) sats_ += rng_.chance(0.5) ? 1 : -1;
+    sats_ = sats_ < 4 ? 4 : sats_ > 14 ? 14 : sats_;
+    double oe = 0, on = 0;
+    double per_fix = cfg_.gps_outliers_per_h * cfg_.gps_period_ms / 3.6e6;
+    if (rng_.chance(per_fix)) {
+      oe = rng_.uniform(-500, 500);
+      on = rng_.uniform(-500, 500);
+    }
+    constexpr double kE7PerM = 1e7 / 111195.0;
+    double e = bias_e_ + 2 * rng_.normal() + oe, n = bias_n_ + 2 * rng_.normal() + on;
+    app::GpsFix& g = s_.gps;
+    g.time_ms = s_.time_ms;
+    g.lat_e7 = static_cast<int32_t>(llround(s_.lat_deg * 1e7 + n * kE7PerM));
+    g.lon_e7 = static_cast<int32_t>(llround(s_.lon_deg * 1e7 + e * kE7PerM / cos_lat_));
+    g.alt_mm = static_cast<int32_t>((s_.alt_m + bias_u_ + 4 * rng_.normal()) * 1000);
+    g.vel_cm_s[0] = clamp16(100 * s_.vel_n_mps + 5 * rng_.normal());
+    g.vel_cm_s[1] = clamp16(100 * s_.vel_e_mps + 5 * rng_.normal());
+    g.vel_cm_s[2] = clamp16(100 * s_.vel_d_mps + 8 * rng_.normal());
+    g.sats = static_cast<uint8_t>(sats_);
+    g.fix = sats_ >= 5 ? 3 : 2;
+    s_.gps_new = true;
+  }
+
+  void sense_power_and_link(double t, double dt) {
+    const SynthPlan& p = plan_;
+    double flight_h = t > cfg_.pad_s ? (t - cfg_.pad_s) / 3600 : 0;
+    double cold = temp_c_ < -20 ? (-20 - temp_c_) * 4 : 0;  // mV lost to a cold cell
+    double sag = rng_.chance(0.002) ? 250 : 0;  // transmit bursts
+    s_.battery_mv = static_cast<uint16_t>(
+        std::max(2500.0, 4150 - p.drain_mv_per_h * flight_h - cold - sag + 4 * rng_.normal()));
+    if (link_out_s_ <= 0 && rng_.chance(cfg_.link_outages_per_h * dt / 3600)) {
+      link_out_s_ = rng_.uniform(60, 1200);
+    }
+    link_out_s_ -= dt;
+    // On the ground the payload is below the ground station's horizon.
+    s_.link_up = link_out_s_ <= 0 && s_.phase != SynthPhase::kLanded;
+  }
+
+  static int16_t clamp16(double v) {
+    return static_cast<int16_t>(v < -32768 ? -32768 : v > 32767 ? 32767 : v);
+  }
+
+  SynthConfig cfg_;
+  SynthRng rng_;
+  SynthPlan plan_;
+  SynthSample s_;
+  bool started_ = false;
+  double phase_start_s_ = 0;
+  double freefall_s_ = 0;
+  double vz_ = 0;  // m/s up
+  uint32_t landed_ms_ = 0;
+  double rho_ratio_ = 1;
+  double cos_lat_ = 1;
+  double gust_a_ = 0, gust_k_ = 0, gust_e_ = 0, gust_n_ = 0;
+  double bias_a_ = 0, bias_k_ = 0, bias_e_ = 0, bias_n_ = 0, bias_u_ = 0;
+  double gps_out_s_ = 0, baro_out_s_ = 0, link_out_s_ = 0;
+  uint32_t next_fix_ms_ = 0;
+  int sats_ = 10;
+  double temp_c_ = 0;
+  double baro_offset_pa_ = 0;
+  double swing_period_s_ = 5, swing_mg_ = 40;
+};
+
+}  // namespace skyguard::sim
@@ -0,0 +1,115 @@
+// Checks that calls through the HAL interfaces cost the same as calling the
+// host backend directly.
+//
+//   hal_overhead_bench [iterations]
+//
+// Each pair of loops does identical work, one through skyguard::board types
+// and one through the backend's free functions. Cycle counts use the TSC on
+// x86 and steady_clock elsewhere.
+
+#define SKYGUARD_HAL_HOST
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+
+#include "hal/board.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static uint64_t ticks() { return __rdtsc(); }
+static const char* kTickUnit = "cycles";
+#else
+static uint64_t ticks() {
+  return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+}
+static const char* kTickUnit = "ns";
+#endif
+
+using namespace skyguard;
+namespace host = skyguard::hal::host;
+
+namespace {
+
+volatile uint32_t g_sink;
+
+template <class Fn>
+double per_op(size_t n, Fn fn) {
+  double best = 1e30;
+  for (int rep = 0; rep < 5; ++rep) {
+    uint64_t t0 = ticks();
+    fn(n);
+    uint64_t t1 = ticks();
+    double v = static_cast<double>(t1 - t0) / static_cast<double>(n);
+    if (v < best) best = v;
+  }
+  return best;
+}
+
+__attribute__((noinline)) void gpio_hal(size_t n) {
+  board::BurnGateA pin;
+  for (size_t i = 0; i < n; ++i) pin.write(i & 1);
+}
+__attribute__((noinline)) void gpio_direct(size_t n) {
+  for (size_t i = 0; i < n; ++i) host::pin_write(board::kPinBurnGateA, i & 1);
+}
+
+__attribute__((noinline)) void adc_hal(size_t n) {
+  board::BatteryAdc adc;
+  uint32_t acc = 0;
+  for (size_t i = 0; i < n; ++i) {
+    host::g_adc[board::kAdcBattery] = static_cast<uint16_t>(i);
+    acc += adc.read();
+  }
+  g_sink = acc;
+}
+__attribute__((noinline)) void adc_direct(size_t n) {
+  uint32_t acc = 0;
+  for (size_t i = 0; i < n; ++i) {
+    host::g_adc[board::kAdcBattery] = static_cast<uint16_t>(i);
+    acc += host::g_adc[board::kAdcBattery];
+  }
+  g_sink = acc;
+}
+
+__attribute__((noinline)) void clock_hal(size_t n) {
+  board::SystemClock clk;
+  uint32_t acc = 0;
+  for (size_t i = 0; i < n; ++i) {
+    clk.delay_us(1);
+    acc += clk.now_us();
+  }
+  g_sink = acc;
+}
+__attribute__((noinline)) void clock_direct(size_t n) {
+  uint32_t acc = 0;
+  for (size_t i = 0; i < n; ++i) {
+    host::clock_advance_us(1);
+    acc += host::clock_now_us();
+  }
+  g_sink = acc;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t n = argc > 1 ? static_cast<size_t>(atol(argv[1])) : 10000000;
+  struct Row {
+    const char* name;
+    void (*hal)(size_t);
+    void (*direct)(size_t);
+  } rows[] = {
+      {"gpio write", gpio_hal, gpio_direct},
+      {"adc read", adc_hal, adc_direct},
+      {"clock delay+now", clock_hal, clock_direct},
+  };
+  for (const Row& r : rows) {  // warm up caches and clocks
+    r.hal(n);
+    r.direct(n);
+  }
+  printf("%-16s %12s %12s   (%s/op, best of 5)\n", "operation", "hal", "direct", kTickUnit);
+  for (const Row& r : rows) {
+    printf("%-16s %12.3f %12.3f\n", r.name, per_op(n, r.hal), per_op(n, r.direct));
+  }
+  return 0;
+}
@@ -0,0 +1,227 @@
+// Termination-path latency as FlightSystem stamps it (FlightSystem::latency()).
+//
+//   latency_budget [events] [boundary_budget_ms] [command_budget_ms] [seed]
+//
+// Each event is a short flight segment on a fresh FlightSystem against a
+// simulated microsecond clock. GPS fixes are computed once a second, and
+// their last sentence ends after the receiver's UART delivery; the driver
+// stamps both and decodes the fix. The 50 ms tick runs late when
+// a log flush holds the main loop. After each tick the default rules in a
+// TerminationEngine are evaluated and their verdict goes to on_rules(). The
+// burn current ADC samples at 1 kHz. Even events drift across the fence
+// (boundary path); odd events uplink a signed cut command, which the
+// receive interrupt hands to the fast path (command path). Only the
+// timing of the platform around the firmware is modelled; the stages are
+// the ones the firmware marks.
+//
+// Prints the per-stage breakdown and exits 1 if either path's p99 exceeds
+// its budget or an event did not cut, so it can gate a benchmark run.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <memory>
+#include <random>
+
+#include "app/flight_system.h"
+#include "diag/latency_trace.h"
+#include "ground/termination/cut_uplink.h"
+#include "termination/termination_engine.h"
+
+using namespace skyguard;
+using diag::LatencyBudget;
+using diag::LatencyPath;
+using diag::LatencyTracer;
+
+namespace {
+
+constexpr uint32_t kTickUs = 50000;          // rule engine period
+constexpr uint32_t kFixPeriodUs = 1000000;   // GPS navigation rate
+constexpr uint32_t kCurrentSampleUs = 1000;  // burn current ADC period
+constexpr double kFlushProbability = 0.05;   // log flush in progress
+constexpr uint32_t kEventUs = 30000000;
+constexpr uint32_t kUnitId = 0x5347000A;
+constexpr uint32_t kCounter = 500;
+constexpr int32_t kApproachMps = 10;
+constexpr uint32_t kGateWriteUs = 2;  // burn gate driver
+
+const termination::CutKey kKey = {{0x3a, 0x91, 0x0c, 0x5e, 0x77, 0x12, 0xb4, 0x68, 0xd2, 0x09,
+                                   0xee, 0x41, 0x8f, 0x26, 0xc3, 0x5d}};
+
+uint32_t g_now_us = 0;
+uint32_t sim_clock() { return g_now_us; }
+
+struct Model {
+  std::mt19937 rng;
+  uint32_t uniform(uint32_t lo, uint32_t hi) {
+    return std::uniform_int_distribution<uint32_t>(lo, hi)(rng);
+  }
+  bool chance(double p) { return std::uniform_real_distribution<double>(0, 1)(rng) < p; }
+  uint32_t blocking() { return chance(kFlushProbability) ? uniform(5000, 30000) : 0; }
+};
+
+// Burn gates; current flows `rise_us` after a channel closes.
+struct Gates {
+  bool on[2] = {};
+  uint32_t on_us[2] = {};
+  uint32_t rise_us = 0;
+  uint16_t current_ma(uint32_t t_us) const {
+    for (int c = 0; c < 2; ++c) {
+      if (on[c] && static_cast<int32_t>(t_us - on_us[c]) >= static_cast<int32_t>(rise_us)) {
+        return 2200;
+      }
+    }
+    return 0;
+  }
+};
+
+void gate(void* ctx, uint8_t channel, bool on) {
+  auto* g = static_cast<Gates*>(ctx);
+  g_now_us += kGateWriteUs;
+  if (on && !g->on[channel]) g->on_us[channel] = g_now_us;
+  g->on[channel] = on;
+}
+
+bool armed(void*) { return true; }
+
+bool radio_submit(void*, const telemetry::SgFrame&) { return false; }
+
+#if SKYGUARD_HAS_APRS
+void dma_start(void*, const uint16_t*, size_t) {}
+void dma_stop(void*) {}
+#endif
+
+// Runs one event; false if it never cut.
+bool run_event(Model& m, bool command, LatencyTracer* total) {
+  Gates g;
+  g.rise_us = m.uniform(5, 60);
+  app::FlightPorts ports{};
+  ports.clock_us = sim_clock;
+  ports.burn = {gate, armed, &g};
+  ports.cut = {kUnitId, kKey, kCounter};
+#if SKYGUARD_HAS_LORA
+  ports.lora = {radio_submit, nullptr};
+#endif
+#if SKYGUARD_HAS_IRIDIUM
+  ports.iridium = {radio_submit, nullptr};
+#endif
+#if SKYGUARD_HAS_APRS
+  ports.afsk = {dma_start, dma_stop, nullptr};
+  ports.afsk_sample_rate = 26400;
+  ports.afsk_out_max = 4095;
+  ports.aprs_source = {"N0CALL", 11};
+#endif
+  g_now_us = 0;
+  std::unique_ptr<app::FlightSystem> owned(new app::FlightSystem(ports));
+  app::FlightSystem& fs = *owned;
+  termination::TerminationEngine engine;
+
+  // Boundary: the fence is crossed between 5 and 15 s. Command: the frame
+  // ends between 5 and 15 s, well inside the fence.
+  uint32_t cross_us = m.uniform(5000000, 15000000);
+  int32_t start_margin_m =
+      command ? 50000 : static_cast<int32_t>(cross_us / 1000000) * kApproachMps;
+  uint32_t cmd_us = command ? cross_us : UINT32_MAX;
+  uint8_t frame[records::CutCommand::kEncodedSize];
+  ground::sign_cut_command(kKey, kUnitId, kCounter + 1, termination::kCutActionCutNow, frame,
+                           sizeof(frame));
+
+  // A fix's last sentence ends after the receiver's UART delivery, and
+  // reaches on_gps_fix() once parsed.
+  auto frame_end = [&](uint32_t valid) {
+    return valid + m.uniform(8000, 40000);
+  };
+  uint32_t fix_valid = m.uniform(0, kFixPeriodUs - 1);
+  uint32_t next_fix = frame_end(fix_valid);
+  uint32_t next_tick = kTickUs;
+  bool tick_held = false;
+  uint32_t next_sample = m.uniform(0, kCurrentSampleUs - 1);
+  uint32_t end_us = kEventUs;
+  while (true) {
+    uint32_t t = std::min(std::min(next_fix, next_tick), std::min(next_sample, cmd_us));
+    if (t >= end_us) break;
+    // One core: an event waits for the handler before it to return.
+    if (static_cast<int32_t>(t - g_now_us) > 0) g_now_us = t;
+    if (t == cmd_us) {
+      g_now_us += m.uniform(0, 40) + 17;  // masked, entry, SipHash check
+      fs.cut_path().on_frame(frame, sizeof(frame), t);
+      cmd_us = UINT32_MAX;
+    } else if (t == next_fix) {
+      g_now_us += m.uniform(50, 400);  // NMEA decode
+      fs.set_fence_margin(start_margin_m -
+                          static_cast<int32_t>(fix_valid / 1000) * kApproachMps / 1000);
+      app::GpsFix fix{};
+      fix.time_ms = g_now_us / 1000;
+      fix.lat_e7 = 452000000;
+      fix.lon_e7 = 25000000;
+      fix.alt_mm = 25000000;
+      fix.fix = 3;
+      fix.sats = 12;
+      fix.valid_us = fix_valid;
+      fix.frame_us = t;
+      fs.on_gps_fix(0, fix);
+      fix_valid += kFixPeriodUs;
+      next_fix = frame_end(fix_valid);
+    } else if (t == next_tick) {
+      uint32_t held = tick_held ? 0 : m.blocking();
+      if (held) {
+        next_tick = t + held;  // a log flush holds the main loop
+        tick_held = true;
+        continue;
+      }
+      tick_held = false;
+      uint32_t now_ms = g_now_us / 1000;
+      fs.tick(now_ms);
+      termination::RuleInputs in{};
+      fs.rule_inputs(now_ms, &in);
+      in.armed = true;
+      in.flight_s = now_ms / 1000;
+      in.battery_mv = 3900;
+      g_now_us += m.uniform(80, 150);  // evaluation
+      bool cut = engine.evaluate(in);
+      uint32_t evaluated_us = g_now_us;
+      g_now_us += m.uniform(1, 5);  // verdict back to the platform
+      fs.on_rules(evaluated_us, cut);
+      next_tick = next_tick - next_tick % kTickUs + kTickUs;
+      while (static_cast<int32_t>(next_tick - g_now_us) <= 0) next_tick += kTickUs;
+      if (fs.burn().current_seen() && end_us == kEventUs) {
+        end_us = g_now_us + 2 * kTickUs;  // one more tick closes the trace
+      }
+    } else {
+      fs.on_burn_current(g_now_us, g.current_ma(g_now_us));
+      next_sample += kCurrentSampleUs;
+      while (static_cast<int32_t>(next_sample - g_now_us) <= 0) next_sample += kCurrentSampleUs;
+    }
+  }
+  total->merge(fs.latency());
+  return fs.burn().current_seen();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int events = argc > 1 ? atoi(argv[1]) : 2000;
+  double boundary_ms = argc > 2 ? atof(argv[2]) : 300;
+  double command_ms = argc > 3 ? atof(argv[3]) : 120;
+  Model m;
+  m.rng.seed(argc > 4 ? static_cast<uint32_t>(atoi(argv[4])) : 1);
+
+  LatencyTracer tr;
+  int missed = 0;
+  for (int i = 0; i < events; ++i) missed += run_event(m, i % 2 == 1, &tr) ? 0 : 1;
+
+  static char report[1024];
+  tr.format_report(report, sizeof(report));
+  printf("latency in us, %d cut events (half each path)\n%s", events, report);
+
+  LatencyBudget budget{};
+  budget.p99_us[static_cast<size_t>(LatencyPath::kBoundary)] =
+      static_cast<uint32_t>(boundary_ms * 1000);
+  budget.p99_us[static_cast<size_t>(LatencyPath::kCommand)] =
+      static_cast<uint32_t>(command_ms * 1000);
+  bool ok = tr.within_budget(budget) && missed == 0;
+  printf("events without a cut: %d\n", missed);
+  printf("budget p99: boundary %.1f ms, command %.1f ms -> %s\n", boundary_ms,
+         command_ms, ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,307 @@
+// Launch-window planner over a forecast archive
+// (ground/planning/launch_planner.h).
+//
+//   launch_planner plan <fences.bin> <lat_deg> <lon_deg> <first_utc_s> <hours>
+//                  <grid.bin>... [--step-min m] [--members n] [--threads n]
+//   launch_planner synth [hours] [--step-min m] [--members n] [--threads n]
+//
+// `plan` reads a fence image (fence_compiler) and packed forecast grids
+// (wind_pack), one per forecast issue, and flies every candidate launch
+// time from the site every step_min minutes (default 10) over `hours`.
+// `synth` builds a 3.5-day archive in memory: a grid issued every 12 h,
+// each covering 36 h, with a jet that wanders in latitude and strength
+// from day to day. Its fences are a keep-in around the launch region and
+// scattered keep-outs. It then plans the first `hours` (default 72).
+//
+// Both print the best candidates and launch windows. They report simulated
+// flights per second, overall and per thread. They re-fly a sample of
+// candidates on one thread and check that the results match the parallel
+// run exactly. Exits 1 on a mismatch.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "geofence/fence_set.h"
+#include "ground/fence/fence_sdf.h"
+#include "ground/fence/fence_simplify.h"
+#include "ground/fence/fence_writer.h"
+#include "ground/planning/launch_planner.h"
+#include "ground/wind/wind_pack.h"
+#include "sim/fence_synth.h"
+
+using namespace skyguard;
+using namespace skyguard::ground;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+constexpr double kPi = 3.14159265358979323846;
+constexpr size_t kShown = 10;
+constexpr float kMaxRisk = 0.05f;
+constexpr size_t kReplayed = 12;
+
+bool read_file(const char* path, std::vector<uint8_t>* out) {
+  FILE* f = fopen(path, "rb");
+  if (!f) return false;
+  uint8_t buf[65536];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) out->insert(out->end(), buf, buf + n);
+  fclose(f);
+  return true;
+}
+
+std::string utc(uint32_t t) {
+  time_t tt = t;
+  struct tm tm;
+  gmtime_r(&tt, &tm);
+  char buf[32];
+  strftime(buf, sizeof(buf), "%Y-%m-%d %H:%MZ", &tm);
+  return buf;
+}
+
+// ---- Synthetic archive ----
+
+constexpr uint32_t kSynthT0 = 1790000000;
+constexpr uint32_t kIssueS = 12 * 3600;
+constexpr uint32_t kIssues = 7;
+constexpr double kSiteLat = 45.2, kSiteLon = 2.5;
+
+// A westerly jet whose latitude and strength wander over days, a
+// rotating surface wind, and a travelling wave. `issue_h` adds the error
+// of a forecast that grows with its lead time.
+void synth_wind(double t_h, double issue_h, double alt_m, double lat, double lon, double* u,
+                double* v) {
+  double jet_lat = 45.5 + 2.5 * sin(2 * kPi * t_h / 31);
+  double jet = 35 + 25 * sin(2 * kPi * t_h / 57 + 1);
+  double core = exp(-pow((alt_m - 11000) / 3500, 2) - pow((lat - jet_lat) / 3, 2));
+  double surface = exp(-alt_m / 2500);
+  double turn = 2 * kPi * t_h / 40;
+  double wave = sin((lon + 0.3 * t_h) * kPi / 6) * cos(lat * kPi / 9);
+  double lead = (t_h - issue_h) / 36;
+  *u = 4 + jet * core + 6 * wave + 8 * surface * cos(turn) + lead * 3 * sin(issue_h);
+  *v = 8 * wave * (0.3 + core) + 8 * surface * sin(turn) + lead * 3 * cos(issue_h);
+}
+
+WindForecast synth_forecast(uint32_t issue) {
+  WindForecast f;
+  double issue_h = issue * kIssueS / 3600.0;
+  f.t0_utc_s = kSynthT0 + issue * kIssueS;
+  f.dt_s = 3 * 3600;
+  f.n_times = 13;
+  f.lat0_e7 = 400000000;
+  f.lon0_e7 = -100000000;
+  f.dlat_e7 = f.dlon_e7 = 2500000;
+  f.n_lat = 49;
+  f.n_lon = 97;
+  for (int alt = 0; alt <= 34000; alt += alt < 16000 ? 1000 : 2000) f.levels_m.push_back(alt);
+  size_t n = f.n_times * f.levels_m.size() * f.n_lat * f.n_lon;
+  f.u_ms.resize(n);
+  f.v_ms.resize(n);
+  for (uint32_t t = 0; t < f.n_times; ++t) {
+    for (uint32_t l = 0; l < f.levels_m.size(); ++l) {
+      for (uint32_t y = 0; y < f.n_lat; ++y) {
+        for (uint32_t x = 0; x < f.n_lon; ++x) {
+          double u, v;
+          synth_wind(issue_h + t * 3.0, issue_h, f.levels_m[l],
+                     (f.lat0_e7 + y * double(f.dlat_e7)) * 1e-7,
+                     (f.lon0_e7 + x * double(f.dlon_e7)) * 1e-7, &u, &v);
+          size_t i = f.index(t, l, y, x);
+          f.u_ms[i] = static_cast<float>(u);
+          f.v_ms[i] = static_cast<float>(v);
+        }
+      }
+    }
+  }
+  return f;
+}
+
+bool synth_archive(size_t threads, ForecastArchive* archive) {
+  std::vector<std::vector<uint8_t>> images(kIssues);
+  std::vector<std::string> errs(kIssues);
+  std::vector<std::thread> pool;
+  for (uint32_t i = 0; i < kIssues; ++i) {
+    pool.emplace_back([&, i] {
+      WindPackStats stats;
+      pack_wind_grid(synth_forecast(i), 0.1f, &images[i], &stats, &errs[i]);
+    });
+    if (pool.size() >= threads) {
+      for (auto& t : pool) t.join();
+      pool.clear();
+    }
+  }
+  for (auto& t : pool) t.join();
+  for (uint32_t i = 0; i < kIssues; ++i) {
+    if (!errs[i].empty() || !archive->add(std::move(images[i]), &errs[i])) {
+      fprintf(stderr, "synthetic grid %u: %s\n", i, errs[i].c_str());
+      return false;
+    }
+  }
+  return true;
+}
+
+// A keep-in around the launch region and keep-outs scattered across it.
+bool synth_fences(std::vector<uint8_t>* image) {
+  std::vector<SourcePolygon> polys(1);
+  polys[0].kind = geofence::FenceKind::kKeepIn;
+  const double kKeepIn[][2] = {{42.5, -3.0}, {42.5, 4.5}, {48.5, 4.5}, {48.5, -3.0}};
+  for (const auto& p : kKeepIn) polys[0].outer.push_back({p[0], p[1]});
+  sim::synthesize_fences(160, 5, &polys);
+  SdfOptions sdf;
+  sdf.step_m = 250;
+  std::vector<FenceBlob> blobs;
+  std::string err;
+  for (size_t i = 0; i < polys.size(); ++i) {
+    CompiledFence f;
+    f.id = static_cast<uint16_t>(i);
+    f.kind = polys[i].kind;
+    blobs.emplace_back();
+    if (!compile_ring(polys[i].outer, f.kind, SimplifyOptions{}, &f.ring_e7, &err) ||
+        !build_fence_blob(f, &blobs.back(), &err, i > 0 ? &sdf : nullptr)) {
+      fprintf(stderr, "fence %zu: %s\n", i, err.c_str());
+      return false;
+    }
+  }
+  *image = assemble_fence_image(blobs);
+  return true;
+}
+
+// ---- Planning ----
+
+bool same(const CandidateResult& a, const CandidateResult& b) {
+  return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+int plan(const ForecastArchive& archive, const std::vector<uint8_t>& fence_image,
+         const PlanConfig& cfg, size_t threads) {
+  // FenceSet reads the image in place, 4-byte aligned.
+  std::vector<uint32_t> words((fence_image.size() + 3) / 4);
+  memcpy(words.data(), fence_image.data(), fence_image.size());
+  geofence::FenceSet fences;
+  if (fences.bind(reinterpret_cast<const uint8_t*>(words.data()), fence_image.size()) !=
+      geofence::FenceError::kNone) {
+    fprintf(stderr, "fence image does not bind\n");
+    return 2;
+  }
+  LaunchPlanner planner(archive, fences, cfg);
+  size_t n = planner.candidates();
+  printf("archive: %zu grids from %s; %zu fences\n", archive.size(),
+         archive.size() ? utc(archive.header(0).t0_utc_s).c_str() : "-", fences.count());
+  printf("candidates: %zu launch times every %u min from %s, %u members each\n", n,
+         cfg.step_s / 60, utc(cfg.first_utc_s).c_str(), cfg.members);
+
+  std::vector<CandidateResult> by_time;
+  PlanStats stats;
+  planner.run(threads, &by_time, &stats);
+  double rate = stats.flights / stats.wall_s;
+  printf("simulated %llu flights (%.1f M steps) in %.2f s on %zu threads: %.0f flights/s "
+         "(%.0f per thread)\n",
+         static_cast<unsigned long long>(stats.flights), stats.steps / 1e6, stats.wall_s,
+         stats.threads, rate, rate / stats.threads);
+
+  // The same candidates on this thread alone must come out identical.
+  size_t mismatched = 0, replayed = std::min(n, kReplayed);
+  for (size_t k = 0; k < replayed; ++k) {
+    size_t i = k * n / replayed;
+    mismatched += !same(planner.evaluate(i), by_time[i]);
+  }
+  printf("determinism: %zu of %zu candidates re-flown on one thread differ\n", mismatched,
+         replayed);
+
+  size_t uncovered = 0;
+  for (const CandidateResult& c : by_time) uncovered += c.forecast < 0;
+  if (uncovered) printf("  %zu candidates have no forecast covering the flight\n", uncovered);
+
+  std::vector<CandidateResult> ranked = by_time;
+  rank_candidates(&ranked);
+  printf("\nbest launch times\n  %-18s %6s %9s %12s %12s %10s %10s\n", "launch", "risk",
+         "complete", "land p10 km", "track p10 km", "land lat", "land lon");
+  for (size_t i = 0; i < std::min(kShown, ranked.size()); ++i) {
+    const CandidateResult& c = ranked[i];
+    if (c.forecast < 0) break;
+    printf("  %-18s %5.1f%% %8.1f%% %12.1f %12.1f %10.3f %10.3f\n", utc(c.launch_utc_s).c_str(),
+           100 * c.risk, 100 * c.completion, c.land_margin_p10_m / 1000,
+           c.min_margin_p10_m / 1000, c.land_lat_e7 * 1e-7, c.land_lon_e7 * 1e-7);
+  }
+  std::vector<LaunchWindow> windows = launch_windows(by_time, cfg.step_s, kMaxRisk);
+  printf("\nlaunch windows (risk <= %.0f%%): %zu\n", 100 * kMaxRisk, windows.size());
+  for (size_t i = 0; i < std::min(kShown, windows.size()); ++i) {
+    const LaunchWindow& w = windows[i];
+    printf("  %s to %s (%4.1f h): worst risk %.1f%%, land margin p10 >= %.1f km\n",
+           utc(w.first_utc_s).c_str(), utc(w.last_utc_s).c_str(),
+           (w.last_utc_s - w.first_utc_s + cfg.step_s) / 3600.0, 100 * w.worst_risk,
+           w.worst_land_margin_p10_m / 1000);
+  }
+  return mismatched ? 1 : 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  PlanConfig cfg;
+  size_t threads = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<const char*> args;
+  for (int i = 1; i < argc; ++i) {
+    if (i + 1 < argc && !strcmp(argv[i], "--step-min")) {
+      cfg.step_s = static_cast<uint32_t>(atoi(argv[++i])) * 60;
+    } else if (i + 1 < argc && !strcmp(argv[i], "--members")) {
+      cfg.members = static_cast<uint32_t>(atoi(argv[++i]));
+    } else if (i + 1 < argc && !strcmp(argv[i], "--threads")) {
+      threads = static_cast<size_t>(std::max(1, atoi(argv[++i])));
+    } else {
+      args.push_back(argv[i]);
+    }
+  }
+  std::string mode = args.empty() ? "" : args[0];
+  if (cfg.step_s == 0) cfg.step_s = 600;
+
+  if (mode == "synth") {
+    double hours = args.size() > 1 ? atof(args[1]) : 72;
+    cfg.launch_lat_e7 = static_cast<int32_t>(lround(kSiteLat * 1e7));
+    cfg.launch_lon_e7 = static_cast<int32_t>(lround(kSiteLon * 1e7));
+    cfg.first_utc_s = kSynthT0;
+    cfg.last_utc_s = kSynthT0 + static_cast<uint32_t>(hours * 3600);
+    auto t0 = Clock::now();
+    ForecastArchive archive;
+    std::vector<uint8_t> fences;
+    if (!synth_archive(threads, &archive) || !synth_fences(&fences)) return 2;
+    printf("synthetic archive and fences built in %.1f s\n",
+           std::chrono::duration<double>(Clock::now() - t0).count());
+    return plan(archive, fences, cfg, threads);
+  }
+  if (mode == "plan" && args.size() >= 7) {
+    std::vector<uint8_t> fences;
+    if (!read_file(args[1], &fences)) {
+      fprintf(stderr, "cannot read %s\n", args[1]);
+      return 2;
+    }
+    cfg.launch_lat_e7 = static_cast<int32_t>(lround(atof(args[2]) * 1e7));
+    cfg.launch_lon_e7 = static_cast<int32_t>(lround(atof(args[3]) * 1e7));
+    cfg.first_utc_s = static_cast<uint32_t>(strtoul(args[4], nullptr, 0));
+    cfg.last_utc_s = cfg.first_utc_s + static_cast<uint32_t>(atof(args[5]) * 3600);
+    ForecastArchive archive;
+    for (size_t i = 6; i < args.size(); ++i) {
+      std::vector<uint8_t> image;
+      std::string err;
+      if (!read_file(args[i], &image) || !archive.add(std::move(image), &err)) {
+        fprintf(stderr, "%s: %s\n", args[i], err.empty() ? "cannot read" : err.c_str());
+        return 2;
+      }
+    }
+    return plan(archive, fences, cfg, threads);
+  }
+  fprintf(stderr,
+          "usage: launch_planner plan <fences.bin> <lat_deg> <lon_deg> <first_utc_s> <hours> "
+          "<grid.bin>... [options]\n"
+          "       launch_planner synth [hours] [options]\n"
+          "options: --step-min m (10), --members n (32), --threads n (all cores)\n");
+  return 2;
+}
@@ -0,0 +1,248 @@
+// Monte Carlo flights through LinkRouter with Iridium, LoRa and APRS links
+// that suffer random outages, lost acknowledgments and duplicate acks.
+//
+//   link_router_sim [flights] [seed]
+//
+// Reports, per urgency class, the latency until the ground first holds a
+// copy of each message, the fraction never received, and the airtime cost
+// per flight.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "telemetry/link_router.h"
+
+using namespace skyguard;
+using telemetry::Urgency;
+
+namespace {
+
+constexpr uint32_t kTickMs = 100;
+constexpr uint32_t kFlightMs = 3 * 3600 * 1000;
+constexpr uint32_t kFixPeriodMs = 60 * 1000;
+constexpr uint32_t kAlertPeriodMs = 30 * 60 * 1000;
+
+struct LinkModel {
+  telemetry::LinkConfig cfg;
+  uint32_t tx_ms;             // time on air / session time
+  float p_deliver;            // while up
+  float p_ack_lost;
+  float p_dup_ack;
+  float mean_up_s, mean_down_s;
+  float p_outage_visible;     // driver can tell the link is down
+
+  // Runtime state.
+  bool up = true;
+  bool reported_up = true;
+  uint32_t next_toggle_ms = 0;
+  bool busy = false;
+  uint16_t tx_id = 0;
+  uint32_t tx_end_ms = 0;
+};
+
+struct PendingAck {
+  uint32_t at_ms;
+  uint8_t link;
+  uint16_t id;
+};
+
+struct Flight {
+  std::mt19937 rng;
+  std::vector<LinkModel> links;
+  std::vector<PendingAck> acks;
+  std::map<uint16_t, uint32_t> created_ms;
+  std::map<uint16_t, Urgency> urgency;
+  std::map<uint16_t, uint32_t> received_ms;  // first ground receipt
+  uint32_t now_ms = 0;
+
+  float uniform() { return std::uniform_real_distribution<float>(0, 1)(rng); }
+  uint32_t exp_ms(float mean_s) {
+    return static_cast<uint32_t>(
+        std::exponential_distribution<float>(1.0f / mean_s)(rng) * 1000.0f);
+  }
+};
+
+bool hook_send(void* ctx, uint8_t link, uint16_t id) {
+  auto* f = static_cast<Flight*>(ctx);
+  LinkModel& l = f->links[link];
+  if (l.busy) return false;
+  l.busy = true;
+  l.tx_id = id;
+  l.tx_end_ms = f->now_ms + l.tx_ms;
+  return true;
+}
+
+std::vector<LinkModel> make_links() {
+  std::vector<LinkModel> v(3);
+  v[0].cfg = {"iridium", 150000, 20000, 60000};
+  v[0].tx_ms = 15000;
+  v[0].p_deliver = 0.92f;
+  v[0].p_ack_lost = 0.0f;  // SBD session result is the ack
+  v[0].p_dup_ack = 0.0f;
+  v[0].mean_up_s = 3600;
+  v[0].mean_down_s = 300;
+  v[0].p_outage_visible = 0.8f;
+
+  v[1].cfg = {"lora", 0, 800, 4000};
+  v[1].tx_ms = 400;
+  v[1].p_deliver = 0.85f;
+  v[1].p_ack_lost = 0.1f;
+  v[1].p_dup_ack = 0.05f;
+  v[1].mean_up_s = 1800;
+  v[1].mean_down_s = 1200;
+  v[1].p_outage_visible = 0.3f;
+
+  v[2].cfg = {"aprs", 0, 1000, 0};
+  v[2].tx_ms = 1000;
+  v[2].p_deliver = 0.6f;  // igate coverage; never confirmed
+  v[2].p_ack_lost = 0.0f;
+  v[2].p_dup_ack = 0.0f;
+  v[2].mean_up_s = 7200;
+  v[2].mean_down_s = 600;
+  v[2].p_outage_visible = 0.5f;
+  return v;
+}
+
+struct Totals {
+  std::map<Urgency, std::vector<uint32_t>> latency;
+  std::map<Urgency, uint32_t> sent, lost;
+  std::vector<double> cost_usd;
+  std::vector<uint64_t> link_sent;
+  uint32_t dup_acks = 0;
+};
+
+void run_flight(uint32_t seed, Totals& t) {
+  Flight f;
+  f.rng.seed(seed);
+  f.links = make_links();
+  telemetry::LinkRouter router({hook_send, nullptr, nullptr, nullptr, &f});
+  for (LinkModel& l : f.links) {
+    router.add_link(l.cfg);
+    l.next_toggle_ms = f.exp_ms(l.mean_up_s);
+  }
+
+  uint16_t next_id = 1;
+  auto submit = [&](Urgency u, uint32_t deadline) {
+    uint16_t id = next_id++;
+    f.created_ms[id] = f.now_ms;
+    f.urgency[id] = u;
+    router.submit(id, u, deadline, f.now_ms);
+  };
+
+  const uint32_t end_ms = kFlightMs + 10 * 60 * 1000;
+  for (f.now_ms = 0; f.now_ms < end_ms; f.now_ms += kTickMs) {
+    for (uint8_t i = 0; i < f.links.size(); ++i) {
+      LinkModel& l = f.links[i];
+      if (f.now_ms >= l.next_toggle_ms) {
+        l.up = !l.up;
+        l.next_toggle_ms = f.now_ms + f.exp_ms(l.up ? l.mean_up_s : l.mean_down_s);
+        bool visible = l.up || f.uniform() < l.p_outage_visible;
+        if (visible != l.reported_up) {
+          l.reported_up = visible;
+          router.set_link_up(i, visible);
+        }
+      }
+      if (l.busy && f.now_ms >= l.tx_end_ms) {
+        l.busy = false;
+        bool ok = l.up && f.uniform() < l.p_deliver;
+        if (ok && !f.received_ms.count(l.tx_id)) f.received_ms[l.tx_id] = f.now_ms;
+        // Iridium reports the session result; LoRa and APRS always finish.
+        bool tx_ok = l.cfg.ack_timeout_ms == 60000 ? ok : true;
+        router.on_tx_done(i, l.tx_id, tx_ok, f.now_ms);
+        if (ok && l.cfg.ack_timeout_ms) {
+          if (l.cfg.ack_timeout_ms == 60000) {
+            router.on_ack(i, l.tx_id, f.now_ms);
+          } else if (f.uniform() >= l.p_ack_lost) {
+            f.acks.push_back({f.now_ms + 600, i, l.tx_id});
+            if (f.uniform() < l.p_dup_ack) {
+              f.acks.push_back({f.now_ms + 1500, i, l.tx_id});
+            }
+          }
+        }
+      }
+    }
+    for (size_t k = 0; k < f.acks.size();) {
+      if (f.acks[k].at_ms <= f.now_ms) {
+        router.on_ack(f.acks[k].link, f.acks[k].id, f.now_ms);
+        f.acks.erase(f.acks.begin() + static_cast<long>(k));
+      } else {
+        ++k;
+      }
+    }
+
+    if (f.now_ms < kFlightMs && f.now_ms % kFixPeriodMs == 0) {
+      submit(Urgency::kRoutine, 2 * kFixPeriodMs);
+    }
+    if (f.now_ms > 0 && f.now_ms < kFlightMs && f.now_ms % kAlertPeriodMs == 0) {
+      submit(Urgency::kAlert, 60000);
+    }
+    if (f.now_ms == kFlightMs) submit(Urgency::kTermination, 0);
+    router.tick(f.now_ms);
+  }
+
+  for (const auto& [id, created] : f.created_ms) {
+    Urgency u = f.urgency[id];
+    ++t.sent[u];
+    auto it = f.received_ms.find(id);
+    if (it == f.received_ms.end()) {
+      ++t.lost[u];
+    } else {
+      t.latency[u].push_back(it->second - created);
+    }
+  }
+  uint64_t cost = 0;
+  t.link_sent.resize(router.link_count());
+  for (size_t i = 0; i < router.link_count(); ++i) {
+    cost += router.link_stats(static_cast<uint8_t>(i)).cost_micro_usd;
+    t.link_sent[i] += router.link_stats(static_cast<uint8_t>(i)).sent;
+  }
+  t.cost_usd.push_back(static_cast<double>(cost) / 1e6);
+  t.dup_acks += router.duplicate_acks();
+}
+
+double percentile(std::vector<uint32_t> v, double p) {
+  if (v.empty()) return 0;
+  std::sort(v.begin(), v.end());
+  return v[static_cast<size_t>(p * (v.size() - 1))];
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int flights = argc > 1 ? atoi(argv[1]) : 100;
+  uint32_t seed = argc > 2 ? static_cast<uint32_t>(atoi(argv[2])) : 1;
+  Totals t;
+  for (int i = 0; i < flights; ++i) run_flight(seed + static_cast<uint32_t>(i), t);
+
+  const char* names[] = {"termination", "alert", "routine"};
+  printf("%d flights\n", flights);
+  printf("%-12s %8s %8s %10s %10s %10s\n", "urgency", "sent", "lost%",
+         "p50_s", "p95_s", "max_s");
+  for (Urgency u : {Urgency::kTermination, Urgency::kAlert, Urgency::kRoutine}) {
+    const auto& lat = t.latency[u];
+    double lost = t.sent[u] ? 100.0 * t.lost[u] / t.sent[u] : 0;
+    printf("%-12s %8u %8.2f %10.1f %10.1f %10.1f\n",
+           names[static_cast<int>(u)], t.sent[u], lost,
+           percentile(lat, 0.5) / 1000, percentile(lat, 0.95) / 1000,
+           percentile(lat, 1.0) / 1000);
+  }
+  double sum = 0;
+  for (double c : t.cost_usd) sum += c;
+  std::vector<uint32_t> cents;
+  for (double c : t.cost_usd) cents.push_back(static_cast<uint32_t>(c * 100));
+  printf("cost per flight: mean $%.2f, p95 $%.2f\n", sum / flights,
+         percentile(cents, 0.95) / 100);
+  printf("sends per flight:");
+  std::vector<LinkModel> links = make_links();
+  for (size_t i = 0; i < t.link_sent.size(); ++i) {
+    printf(" %s %.1f", links[i].cfg.name, static_cast<double>(t.link_sent[i]) / flights);
+  }
+  printf("\n");
+  printf("duplicate acks ignored: %u\n", t.dup_acks);
+  return 0;
+}
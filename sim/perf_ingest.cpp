@@ -0,0 +1,252 @@
+// Fleet performance-counter pipeline: on-board PerfMonitor to ground store.
+//
+//   perf_ingest [units] [days] [log] [dashboard.csv]
+//
+// Simulates a fleet reporting records::PerfCounters every 10 minutes: each
+// unit runs the firmware PerfMonitor over synthetic task, flash, radio, ISR
+// and power activity (one unit's flash wears, one has a poor antenna), and
+// its encoded payloads are ingested into the ground PerfStore with some
+// frames lost or late. Reports ingest and replay rates and fleet query
+// cost, prints a daily dashboard and the outlier units, and writes every
+// metric in hourly buckets to the CSV when given. The log is reopened (with
+// a torn final entry appended) and must replay to identical query results;
+// exits 1 otherwise.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "diag/perf_counters.h"
+#include "generated/records.h"
+#include "ground/perf/perf_store.h"
+#include "telemetry/buffer_pool.h"
+
+using namespace skyguard;
+using namespace skyguard::ground;
+using diag::PerfIsr;
+using diag::PerfQueue;
+using diag::PerfRail;
+using diag::PerfTask;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+constexpr uint32_t kWindowS = 600;
+constexpr uint32_t kStepS = 10;
+constexpr int64_t kEpoch = 1790000000;  // fleet start, UTC
+constexpr uint32_t kWornUnit = 3;
+constexpr uint32_t kPoorAntennaUnit = 5;
+
+struct Frame {
+  uint32_t unit;
+  int64_t rx_s;
+  uint8_t payload[records::PerfCounters::kEncodedSize];
+};
+
+// One unit's activity for one reporting window, in 10 s steps.
+void simulate_window(uint32_t unit, double day, std::mt19937& rng, diag::PerfMonitor* perf,
+                     telemetry::BufferPool* pool) {
+  std::exponential_distribution<double> expo(1.0);
+  std::uniform_real_distribution<double> u(0.0, 1.0);
+  // Per-task cost of 10 s of work (us) and its budget.
+  static const double kTaskUs[] = {300000, 200000, 50000, 150000, 400000, 100000};
+  for (uint32_t s = 0; s < kWindowS; s += kStepS) {
+    for (size_t t = 0; t < 6; ++t) {
+      double us = kTaskUs[t] * (0.8 + 0.4 * u(rng));
+      if (u(rng) < 0.01) us *= 4;  // occasional overrun
+      perf->task_run(static_cast<PerfTask>(t), static_cast<uint32_t>(us),
+                     static_cast<uint32_t>(2 * kTaskUs[t]));
+    }
+    double wear = unit == kWornUnit ? 1 + day * 0.4 : 1;
+    for (int k = 0; k < 2; ++k) {
+      perf->flash_write(static_cast<uint32_t>(wear * (300 + 400 * expo(rng))));
+    }
+    perf->queue_depth(PerfQueue::kRouter, static_cast<uint32_t>(1 + 3 * u(rng)));
+    perf->queue_depth(PerfQueue::kGpsRx, static_cast<uint32_t>(8 * u(rng) * u(rng)));
+    perf->queue_depth(PerfQueue::kLogWrite, static_cast<uint32_t>(6 * u(rng)));
+    perf->queue_depth(PerfQueue::kConsoleTx, 0);
+    double retry_p = unit == kPoorAntennaUnit ? 0.3 : 0.02;
+    if (u(rng) < retry_p) perf->radio_retry();
+    perf->isr_latency(PerfIsr::kRadio, static_cast<uint32_t>(4 + 6 * expo(rng)));
+    perf->isr_latency(PerfIsr::kGpsUart, static_cast<uint32_t>(2 + 3 * expo(rng)));
+    perf->isr_latency(PerfIsr::kTimer, static_cast<uint32_t>(1 + expo(rng)));
+    // Rail power in mW over the step, as microjoules.
+    static const double kRailMw[] = {35, 90, 120, 0, 0};
+    for (size_t r = 0; r < 5; ++r) {
+      double mw = kRailMw[r] * (0.9 + 0.2 * u(rng));
+      if (r == 3 && u(rng) < 0.05) mw = 1500;  // Iridium burst
+      perf->energy(static_cast<PerfRail>(r), static_cast<uint32_t>(mw * kStepS * 1000));
+    }
+    int a = pool->acquire(), b = u(rng) < 0.2 ? pool->acquire() : -1;
+    if (b >= 0) pool->release(b);
+    if (a >= 0) pool->release(a);
+  }
+}
+
+std::vector<Frame> simulate_fleet(uint32_t units, uint32_t days, size_t* lost) {
+  std::vector<Frame> frames;
+  std::mt19937 rng(5);
+  std::uniform_real_distribution<double> u(0.0, 1.0);
+  uint32_t windows = days * 86400 / kWindowS;
+  std::vector<diag::PerfMonitor> perf(units);
+  std::vector<telemetry::StaticBufferPool<64, 4>> pools(units);
+  *lost = 0;
+  for (uint32_t w = 1; w <= windows; ++w) {
+    for (uint32_t unit = 0; unit < units; ++unit) {
+      simulate_window(unit, w * double(kWindowS) / 86400, rng, &perf[unit], &pools[unit]);
+      records::PerfCounters rec;
+      perf[unit].snapshot(w * kWindowS * 1000, pools[unit], &rec);
+      if (u(rng) < 0.01) {
+        ++*lost;
+        continue;
+      }
+      Frame f;
+      f.unit = 100 + unit;
+      // Iridium store-and-forward occasionally delivers well after later frames.
+      f.rx_s = kEpoch + int64_t(w) * kWindowS + 2 + int64_t(u(rng) < 0.02 ? 1500 : 5 * u(rng));
+      rec.encode(f.payload, sizeof(f.payload));
+      frames.push_back(f);
+    }
+  }
+  std::sort(frames.begin(), frames.end(),
+            [](const Frame& a, const Frame& b) { return a.rx_s < b.rx_s; });
+  return frames;
+}
+
+double since_s(Clock::time_point t) {
+  return std::chrono::duration<double>(Clock::now() - t).count();
+}
+
+bool same(const std::vector<PerfBucket>& a, const std::vector<PerfBucket>& b) {
+  if (a.size() != b.size()) return false;
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (a[i].count != b[i].count || a[i].min != b[i].min || a[i].max != b[i].max ||
+        a[i].mean != b[i].mean) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  uint32_t n_units = argc > 1 ? static_cast<uint32_t>(atol(argv[1])) : 50;
+  uint32_t days = argc > 2 ? static_cast<uint32_t>(atol(argv[2])) : 7;
+  std::string log = argc > 3 ? argv[3] : "/tmp/perf_ingest." + std::to_string(getpid()) + ".log";
+  const char* csv_path = argc > 4 ? argv[4] : nullptr;
+  bool own_log = argc <= 3;
+  unlink(log.c_str());
+
+  size_t lost = 0;
+  std::vector<Frame> frames = simulate_fleet(n_units, days, &lost);
+  std::string err;
+  PerfStore store;
+  if (!store.open(log, &err)) {
+    fprintf(stderr, "%s\n", err.c_str());
+    return 2;
+  }
+  auto t = Clock::now();
+  for (const Frame& f : frames) {
+    if (!store.ingest(f.unit, f.rx_s, f.payload, sizeof(f.payload), &err)) {
+      fprintf(stderr, "ingest: %s\n", err.c_str());
+      return 2;
+    }
+  }
+  store.close();
+  double ingest_s = since_s(t);
+
+  int64_t t0 = kEpoch, t1 = kEpoch + int64_t(days) * 86400 + kWindowS * 4;
+  std::vector<std::vector<PerfBucket>> live;
+  t = Clock::now();
+  for (size_t m = 0; m < perf_metric_count(); ++m) live.push_back(store.fleet(m, t0, t1, 3600));
+  double query_s = since_s(t) / double(perf_metric_count());
+
+  // A torn final entry, as from a crash mid-append, must be cut off.
+  if (FILE* f = fopen(log.c_str(), "ab")) {
+    fwrite("\x65\x00\x00\x00\x01", 1, 5, f);
+    fclose(f);
+  }
+  PerfStore replay;
+  t = Clock::now();
+  if (!replay.open(log, &err)) {
+    fprintf(stderr, "%s\n", err.c_str());
+    return 2;
+  }
+  double replay_s = since_s(t);
+  size_t mismatches = replay.samples() != store.samples() || !replay.torn_tail();
+  for (size_t m = 0; m < perf_metric_count(); ++m) {
+    mismatches += !same(live[m], replay.fleet(m, t0, t1, 3600));
+  }
+
+  printf("%u units x %u days: %zu frames (%zu lost, late ones reordered), log %s\n", n_units,
+         days, store.samples(), lost, log.c_str());
+  printf("ingest %.0f frames/s, replay %.0f frames/s, fleet query %.2f ms per metric "
+         "(%zu hourly buckets)\n",
+         frames.size() / ingest_s, replay.replayed() / replay_s, query_s * 1e3,
+         live[0].size());
+
+  const char* dash[] = {"cpu.gps", "flash.p99_us", "radio.retries", "isr.radio_us",
+                        "energy.iridium_j"};
+  printf("\n%-6s", "day");
+  for (const char* name : dash) printf(" %22s", name);
+  printf("\n%-6s", "");
+  for (size_t k = 0; k < sizeof(dash) / sizeof(dash[0]); ++k) printf(" %22s", "mean / max");
+  printf("\n");
+  for (uint32_t d = 0; d < days; ++d) {
+    printf("%-6u", d);
+    for (const char* name : dash) {
+      std::vector<PerfBucket> b =
+          store.fleet(static_cast<size_t>(perf_metric_index(name)), t0 + d * 86400LL,
+                      t0 + (d + 1) * 86400LL, 86400);
+      printf(" %12.1f / %7.1f", b[0].mean, b[0].max);
+    }
+    printf("\n");
+  }
+
+  // Units whose last-day mean is far from the fleet's.
+  printf("\noutliers over the last day:\n");
+  size_t outliers = 0;
+  for (const char* name : {"flash.p99_us", "radio.retries"}) {
+    size_t m = static_cast<size_t>(perf_metric_index(name));
+    int64_t from = t1 - 86400;
+    float fleet_mean = store.fleet(m, from, t1, 86400)[0].mean;
+    for (uint32_t unit : store.units()) {
+      std::vector<PerfPoint> s = store.series(unit, m, from, t1);
+      double sum = 0;
+      for (const PerfPoint& p : s) sum += p.value;
+      double mean = s.empty() ? 0 : sum / s.size();
+      if (mean > 2 * fleet_mean) {
+        printf("  unit %u %s mean %.1f (fleet %.1f)\n", unit, name, mean, fleet_mean);
+        ++outliers;
+      }
+    }
+  }
+  if (!outliers) printf("  none\n");
+
+  if (csv_path) {
+    FILE* f = fopen(csv_path, "w");
+    if (!f) {
+      fprintf(stderr, "cannot write %s\n", csv_path);
+      return 2;
+    }
+    fprintf(f, "metric,bucket_utc_s,count,min,mean,max\n");
+    for (size_t m = 0; m < perf_metric_count(); ++m) {
+      for (const PerfBucket& b : live[m]) {
+        fprintf(f, "%s,%lld,%u,%g,%g,%g\n", perf_metric_name(m), static_cast<long long>(b.t0_s),
+                b.count, b.min, b.mean, b.max);
+      }
+    }
+    fclose(f);
+  }
+  if (own_log) unlink(log.c_str());
+  printf("\nreplay mismatches %zu\n", mismatches);
+  return mismatches ? 1 : 0;
+}
@@ -0,0 +1,114 @@
+// Runs FlightSystem for the build profile it is compiled with and reports
+// its RAM footprint and per-tick cost. tools/profile_report.py builds and
+// runs it once per profile.
+//
+//   profile_tick [ticks]
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+
+#include "app/flight_system.h"
+
+using namespace skyguard;
+
+namespace {
+
+constexpr uint32_t kTickMs = 100;
+
+struct FakeRadio {
+  bool busy = false;
+  uint16_t seq = 0;
+};
+
+bool radio_submit(void* ctx, const telemetry::SgFrame& f) {
+  auto* r = static_cast<FakeRadio*>(ctx);
+  if (r->busy) return false;
+  r->busy = true;
+  const uint8_t* hdr = f.segments()[0].data;
+  r->seq = static_cast<uint16_t>(hdr[4] | hdr[5] << 8);
+  return true;
+}
+
+// Completes the last transmit and has the ground acknowledge it.
+void finish(app::FlightSystem& fs, FakeRadio& r, app::LinkKind kind, uint32_t now) {
+  if (!r.busy) return;
+  r.busy = false;
+  fs.on_link_tx_done(kind, true, now);
+  fs.on_link_ack(kind, r.seq, now);
+}
+
+#if SKYGUARD_HAS_APRS
+struct FakeDma {
+  bool running = false;
+};
+void dma_start(void* ctx, const uint16_t*, size_t) { static_cast<FakeDma*>(ctx)->running = true; }
+void dma_stop(void* ctx) { static_cast<FakeDma*>(ctx)->running = false; }
+#endif
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  long ticks = argc > 1 ? atol(argv[1]) : 200000;
+
+  app::FlightPorts ports{};
+#if SKYGUARD_HAS_LORA
+  FakeRadio lora;
+  ports.lora = {radio_submit, &lora};
+#endif
+#if SKYGUARD_HAS_IRIDIUM
+  FakeRadio iridium;
+  ports.iridium = {radio_submit, &iridium};
+#endif
+#if SKYGUARD_HAS_APRS
+  FakeDma dma;
+  ports.afsk = {dma_start, dma_stop, &dma};
+  ports.afsk_sample_rate = 26400;
+  ports.afsk_out_max = 4095;
+  ports.aprs_source = {"N0CALL", 11};
+#endif
+  static app::FlightSystem fs(ports);
+
+  using Clock = std::chrono::steady_clock;
+  Clock::duration in_tick{};
+  for (long i = 0; i < ticks; ++i) {
+    uint32_t now = static_cast<uint32_t>(i) * kTickMs;
+    for (uint8_t r = 0; r < SKYGUARD_GPS_COUNT; ++r) {
+      app::GpsFix fix{now, 400000000 + static_cast<int32_t>(i), -1050000000, 20000000,
+                      {0, 0, -500}, 3, static_cast<uint8_t>(8 + r), 0, 0};
+      fs.on_gps_fix(r, fix);
+    }
+#if SKYGUARD_HAS_IMU
+    fs.on_imu_sample({now, {0, 0, 1000}});
+#endif
+#if SKYGUARD_HAS_ADSB
+    char line[128];
+    int n = snprintf(line, sizeof(line),
+                     "MSG,3,1,1,%06lX,1,,,,,,12000,,,40.%04ld,-105.0100,,,0,0,0,0\n",
+                     static_cast<unsigned long>(0xA00000 + i % 40), i % 10000);
+    fs.on_adsb_bytes(reinterpret_cast<const uint8_t*>(line), static_cast<size_t>(n), now);
+#endif
+    // Drivers finish whatever was started last tick.
+#if SKYGUARD_HAS_LORA
+    finish(fs, lora, app::LinkKind::kLora, now);
+#endif
+#if SKYGUARD_HAS_IRIDIUM
+    finish(fs, iridium, app::LinkKind::kIridium, now);
+#endif
+#if SKYGUARD_HAS_APRS
+    while (dma.running) {
+      fs.afsk_streamer().on_half_transfer();
+      if (dma.running) fs.afsk_streamer().on_transfer_complete();
+    }
+#endif
+    auto t0 = Clock::now();
+    fs.tick(now);
+    in_tick += Clock::now() - t0;
+  }
+
+  double ns = std::chrono::duration<double, std::nano>(in_tick).count() / static_cast<double>(ticks);
+  printf("profile=%s flight_system_bytes=%zu tick_ns=%.1f pool_high_water=%u\n", profile::kName,
+         sizeof(app::FlightSystem), ns, fs.pool().high_water());
+  return 0;
+}
@@ -0,0 +1,528 @@
+// Duration of the launch-readiness self-test on the host board.
+//
+//   self_test_bench [seed]
+//
+// Registers the pad checks (GPS lock, barometer and IMU on the shared
+// sensor I2C bus, both burn channels' continuity through the shared
+// current sense, radio transmit, battery, config flash CRC) against
+// skyguard::board types, with device models that take their datasheet
+// times in simulated time. Runs them one after another, as the old serial
+// self-test did, and then concurrently through diag::SelfTest; then again
+// with faults injected (no GPS fix, burn channel B open, radio missing);
+// then in flight mode, polled from a 10 ms tick with a 300 us slice.
+//
+// Exits 1 if the concurrent pad run exceeds its budget, a verdict differs
+// from what the scenario injected, or a flight-mode poll overruns its
+// slice by more than one step.
+
+#define SKYGUARD_HAL_HOST
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <random>
+
+#include "diag/self_test.h"
+#include "hal/board.h"
+#include "util/crc32.h"
+
+using namespace skyguard;
+using diag::CheckStatus;
+using diag::SelfTest;
+using diag::SelfTestCheck;
+using diag::SelfTestMode;
+namespace host = skyguard::hal::host;
+
+namespace {
+
+constexpr uint32_t kPadLoopUs = 200;      // rest of the pad main loop per poll
+constexpr uint32_t kFlightTickUs = 10000;
+constexpr uint32_t kFlightSliceUs = 300;
+constexpr uint32_t kStepCpuUs = 4;        // charged per step on top of bus time
+constexpr uint32_t kGgaPeriodUs = 1000000;
+constexpr uint32_t kConfigBytes = 4096;   // last 4 bytes: CRC-32 of the rest
+
+enum Bus : uint8_t { kBusSensorI2c, kBusBurnSense };
+
+// --- Device models ----------------------------------------------------------
+
+struct World {
+  bool gps_fix = true;
+  bool burn_b_open = false;
+  bool radio_present = true;
+  uint64_t next_gga_us = 0;
+};
+World g_world;
+std::mt19937 g_rng;
+
+void push_gga() {
+  int q = g_world.gps_fix ? 1 : 0;
+  int sats = g_world.gps_fix ? 9 : 0;
+  char body[96];
+  snprintf(body, sizeof(body),
+           "GPGGA,123519,4807.038,N,01131.000,E,%d,%02d,0.9,545.4,M,46.9,M,,", q, sats);
+  uint8_t sum = 0;
+  for (const char* p = body; *p; ++p) sum ^= static_cast<uint8_t>(*p);
+  char line[112];
+  int n = snprintf(line, sizeof(line), "$%s*%02X\r\n", body, sum);
+  auto& rx = host::g_uart[board::kUartGps].rx;
+  rx.insert(rx.end(), line, line + n);
+}
+
+/// Moves the world to the current simulated time.
+void advance_world() {
+  while (host::g_now_us >= g_world.next_gga_us) {
+    push_gga();
+    g_world.next_gga_us += kGgaPeriodUs;
+  }
+}
+
+class I2cTimed : public host::BusDevice {
+ protected:
+  static void charge(size_t ntx, size_t nrx) { host::clock_advance_us(25 * (ntx + nrx + 1)); }
+};
+
+// Barometer: forced-mode conversion takes 40 ms.
+class BaroModel : public I2cTimed {
+ public:
+  bool exchange(uint8_t, const uint8_t* tx, size_t ntx, uint8_t* rx, size_t nrx) override {
+    charge(ntx, nrx);
+    if (ntx == 2 && tx[0] == 0xF4) {
+      ready_us_ = host::g_now_us + 40000;
+      return true;
+    }
+    if (ntx == 1 && tx[0] == 0xF3 && nrx == 1) {
+      rx[0] = host::g_now_us < ready_us_ ? 0x08 : 0x00;
+      return true;
+    }
+    if (ntx == 1 && tx[0] == 0xF7 && nrx == 3) {
+      uint32_t pa = 101325;
+      rx[0] = static_cast<uint8_t>(pa >> 16);
+      rx[1] = static_cast<uint8_t>(pa >> 8);
+      rx[2] = static_cast<uint8_t>(pa);
+      return true;
+    }
+    return false;
+  }
+
+ private:
+  uint64_t ready_us_ = 0;
+};
+
+// IMU: identity register, then 1 g on Z.
+class ImuModel : public I2cTimed {
+ public:
+  bool exchange(uint8_t, const uint8_t* tx, size_t ntx, uint8_t* rx, size_t nrx) override {
+    charge(ntx, nrx);
+    if (ntx == 1 && tx[0] == 0x75 && nrx == 1) {
+      rx[0] = 0x71;
+      return true;
+    }
+    if (ntx == 2 && tx[0] == 0x1C) return true;
+    if (ntx == 1 && tx[0] == 0x3B && nrx == 6) {
+      const int16_t a[3] = {12, -8, 1003};
+      for (int i = 0; i < 3; ++i) {
+        rx[2 * i] = static_cast<uint8_t>(static_cast<uint16_t>(a[i]) >> 8);
+        rx[2 * i + 1] = static_cast<uint8_t>(a[i]);
+      }
+      return true;
+    }
+    return false;
+  }
+};
+
+// LoRa transceiver: version register, and a test frame that takes 250 ms.
+class RadioModel : public host::BusDevice {
+ public:
+  bool exchange(uint8_t, const uint8_t* tx, size_t ntx, uint8_t* rx, size_t nrx) override {
+    host::clock_advance_us(2 * (ntx > nrx ? ntx : nrx));
+    if (ntx < 2) return true;
+    uint8_t reg = tx[0] & 0x7F;
+    if (tx[0] & 0x80) {
+      if (reg == 0x01 && tx[1] == 0x83) done_us_ = host::g_now_us + 250000;
+      return true;
+    }
+    if (rx && nrx >= 2) {
+      if (reg == 0x42) rx[1] = 0x12;
+      if (reg == 0x12) rx[1] = done_us_ && host::g_now_us >= done_us_ ? 0x08 : 0x00;
+    }
+    return true;
+  }
+
+ private:
+  uint64_t done_us_ = 0;
+};
+
+BaroModel g_baro;
+ImuModel g_imu;
+RadioModel g_radio;
+
+// Burn current sense: a healthy cutter draws about 1.2 A during a pulse.
+void on_pin(uint8_t pin, bool level) {
+  if (pin != board::kPinBurnGateA && pin != board::kPinBurnGateB) return;
+  bool open = pin == board::kPinBurnGateB && g_world.burn_b_open;
+  host::g_adc[board::kAdcBurnCurrent] = level && !open ? 745 : 3;
+}
+
+// --- Checks, as board integration code writes them -------------------------
+
+struct GpsCheck {
+  board::GpsUart uart;
+  char line[96];
+  size_t len;
+};
+
+// Waits for a GGA sentence reporting a fix; the value is the satellite count.
+CheckStatus gps_lock(void* ctx, uint32_t step, uint32_t, int16_t* value) {
+  auto& c = *static_cast<GpsCheck*>(ctx);
+  if (step == 0) c.len = 0;
+  uint8_t buf[64];
+  size_t n = c.uart.read(buf, sizeof(buf));
+  for (size_t i = 0; i < n; ++i) {
+    char ch = static_cast<char>(buf[i]);
+    if (ch == '$') c.len = 0;
+    if (ch != '\n') {
+      if (c.len < sizeof(c.line) - 1) c.line[c.len++] = ch;
+      continue;
+    }
+    c.line[c.len] = '\0';
+    c.len = 0;
+    if (strncmp(c.line, "$GPGGA,", 7) != 0) continue;
+    // Fields 6 and 7: fix quality and satellites.
+    const char* p = c.line;
+    for (int f = 0; f < 6 && p; ++f) {
+      p = strchr(p, ',');
+      if (p) ++p;
+    }
+    if (!p) continue;
+    int quality = atoi(p);
+    const char* s = strchr(p, ',');
+    int sats = s ? atoi(s + 1) : 0;
+    *value = static_cast<int16_t>(sats);
+    if (quality >= 1 && sats >= 5) return CheckStatus::kPass;
+  }
+  return CheckStatus::kRunning;
+}
+
+struct BaroCheck {
+  board::SensorI2c i2c;
+};
+
+// Triggers one conversion; the value is the pressure in Pa / 4.
+CheckStatus baro(void* ctx, uint32_t step, uint32_t, int16_t* value) {
+  auto& c = *static_cast<BaroCheck*>(ctx);
+  constexpr uint8_t kAddr = 0x76;
+  if (step == 0) {
+    const uint8_t cmd[] = {0xF4, 0x25};
+    return c.i2c.write_read(kAddr, cmd, 2, nullptr, 0) ? CheckStatus::kWait : CheckStatus::kFail;
+  }
+  uint8_t reg = 0xF3, status;
+  if (!c.i2c.write_read(kAddr, &reg, 1, &status, 1)) return CheckStatus::kFail;
+  if (status & 0x08) return CheckStatus::kWait;
+  reg = 0xF7;
+  uint8_t raw[3];
+  if (!c.i2c.write_read(kAddr, &reg, 1, raw, 3)) return CheckStatus::kFail;
+  int32_t pa = raw[0] << 16 | raw[1] << 8 | raw[2];
+  *value = static_cast<int16_t>(pa / 4);
+  return pa >= 30000 && pa <= 110000 ? CheckStatus::kPass : CheckStatus::kFail;
+}
+
+struct ImuCheck {
+  board::SensorI2c i2c;
+  uint32_t settle_from_us;
+};
+
+// Identity, then gravity magnitude after the accelerometer settles
+// (200 ms); the value is in mg.
+CheckStatus imu(void* ctx, uint32_t step, uint32_t now_us, int16_t* value) {
+  auto& c = *static_cast<ImuCheck*>(ctx);
+  constexpr uint8_t kAddr = 0x68;
+  if (step == 0) {
+    uint8_t reg = 0x75, who = 0;
+    const uint8_t cfg[] = {0x1C, 0x00};
+    if (!c.i2c.write_read(kAddr, &reg, 1, &who, 1) || who != 0x71 ||
+        !c.i2c.write_read(kAddr, cfg, 2, nullptr, 0)) {
+      return CheckStatus::kFail;
+    }
+    c.settle_from_us = now_us;
+    return CheckStatus::kWait;
+  }
+  if (now_us - c.settle_from_us < 200000) return CheckStatus::kWait;
+  uint8_t reg = 0x3B, raw[6];
+  if (!c.i2c.write_read(kAddr, &reg, 1, raw, 6)) return CheckStatus::kFail;
+  int64_t m2 = 0;
+  for (int i = 0; i < 3; ++i) {
+    int32_t a = static_cast<int16_t>(raw[2 * i] << 8 | raw[2 * i + 1]);
+    m2 += int64_t(a) * a;
+  }
+  int32_t mg = 0;
+  while (int64_t(mg + 1) * (mg + 1) <= m2) ++mg;
+  *value = static_cast<int16_t>(mg);
+  return mg >= 900 && mg <= 1100 ? CheckStatus::kPass : CheckStatus::kFail;
+}
+
+// Burn channel continuity: a 500 us gate pulse, far too short to heat the
+// cutter, with the current sampled at its end; the value is in mA.
+template <class Gate>
+struct BurnCheck {
+  Gate gate;
+  board::BurnCurrentAdc adc;
+  uint32_t on_us;
+};
+
+template <class Gate>
+CheckStatus burn_continuity(void* ctx, uint32_t step, uint32_t now_us, int16_t* value) {
+  auto& c = *static_cast<BurnCheck<Gate>*>(ctx);
+  if (step == 0) {
+    c.gate.set();
+    c.on_us = now_us;
+    return CheckStatus::kRunning;  // keeps the shared sense
+  }
+  if (now_us - c.on_us < 500) return CheckStatus::kRunning;
+  uint32_t ma = uint32_t(c.adc.read()) * 3300 / c.adc.full_scale() * 2;  // 0.5 V/A
+  c.gate.clear();
+  *value = static_cast<int16_t>(ma);
+  return ma >= 300 && ma <= 3000 ? CheckStatus::kPass : CheckStatus::kFail;
+}
+
+struct RadioCheck {
+  board::RadioSpi spi;
+  uint32_t tx_from_us;
+};
+
+uint8_t radio_reg(board::RadioSpi& spi, uint8_t reg) {
+  uint8_t tx[2] = {reg, 0}, rx[2] = {0xFF, 0xFF};
+  spi.transfer(tx, rx, 2);
+  return rx[1];
+}
+
+// Version register, then one test frame; the value is the airtime in ms.
+CheckStatus radio(void* ctx, uint32_t step, uint32_t now_us, int16_t* value) {
+  auto& c = *static_cast<RadioCheck*>(ctx);
+  if (step == 0) {
+    if (radio_reg(c.spi, 0x42) != 0x12) return CheckStatus::kFail;
+    const uint8_t tx_mode[] = {0x81, 0x83};
+    c.spi.transfer(tx_mode, nullptr, 2);
+    c.tx_from_us = now_us;
+    return CheckStatus::kRunning;
+  }
+  if (!(radio_reg(c.spi, 0x12) & 0x08)) return CheckStatus::kRunning;
+  *value = static_cast<int16_t>((now_us - c.tx_from_us) / 1000);
+  return CheckStatus::kPass;
+}
+
+// Battery in mV through a 1:2 divider.
+CheckStatus battery(void*, uint32_t, uint32_t, int16_t* value) {
+  board::BatteryAdc adc;
+  uint32_t mv = uint32_t(adc.read()) * 6600 / adc.full_scale();
+  *value = static_cast<int16_t>(mv);
+  return mv >= 3600 ? CheckStatus::kPass : CheckStatus::kFail;
+}
+
+struct ConfigCheck {
+  board::ConfigFlash flash;
+  uint32_t offset;
+  uint32_t crc;
+};
+
+// CRC of the config block, 256 bytes per step; the value is bytes / 16.
+CheckStatus config_crc(void* ctx, uint32_t step, uint32_t, int16_t* value) {
+  auto& c = *static_cast<ConfigCheck*>(ctx);
+  if (step == 0) {
+    c.offset = 0;
+    c.crc = kCrc32Init;
+  }
+  uint8_t buf[256];
+  uint32_t end = kConfigBytes - 4;
+  uint32_t n = end - c.offset < sizeof(buf) ? end - c.offset : sizeof(buf);
+  if (!c.flash.read(c.offset, buf, n)) return CheckStatus::kFail;
+  c.crc = crc32_update(c.crc, buf, n);
+  c.offset += n;
+  *value = static_cast<int16_t>(c.offset / 16);
+  if (c.offset < end) return CheckStatus::kRunning;
+  uint8_t stored[4];
+  if (!c.flash.read(end, stored, 4)) return CheckStatus::kFail;
+  uint32_t want = stored[0] | stored[1] << 8 | stored[2] << 16 | uint32_t(stored[3]) << 24;
+  return (c.crc ^ 0xFFFFFFFF) == want ? CheckStatus::kPass : CheckStatus::kFail;
+}
+
+// --- Harness ------------------------------------------------------------------
+
+struct Named {
+  const char* name;
+  SelfTestCheck check;
+};
+
+GpsCheck g_gps;
+BaroCheck g_baro_check;
+ImuCheck g_imu_check;
+BurnCheck<board::BurnGateA> g_burn_a;
+BurnCheck<board::BurnGateB> g_burn_b;
+RadioCheck g_radio_check;
+ConfigCheck g_config;
+
+const Named kChecks[] = {
+    {"gps", {gps_lock, &g_gps, 1500, diag::kSelfTestNoBus, 0}},
+    {"baro", {baro, &g_baro_check, 200, kBusSensorI2c, 0}},
+    {"imu", {imu, &g_imu_check, 500, kBusSensorI2c, 0}},
+    {"burn_a", {burn_continuity<board::BurnGateA>, &g_burn_a, 100, kBusBurnSense,
+                diag::kSelfTestPadOnly}},
+    {"burn_b", {burn_continuity<board::BurnGateB>, &g_burn_b, 100, kBusBurnSense,
+                diag::kSelfTestPadOnly}},
+    {"radio", {radio, &g_radio_check, 600, diag::kSelfTestNoBus, 0}},
+    {"battery", {battery, nullptr, 50, diag::kSelfTestNoBus, 0}},
+    {"config", {config_crc, &g_config, 200, diag::kSelfTestNoBus, 0}},
+};
+constexpr size_t kNumChecks = sizeof(kChecks) / sizeof(kChecks[0]);
+static_assert(kNumChecks <= diag::kSelfTestMaxChecks, "checks fit the report");
+
+// Charges the CPU time of each step so that time moves while polling.
+SelfTestCheck g_wrapped[kNumChecks];
+CheckStatus charged_step(void* ctx, uint32_t step, uint32_t now_us, int16_t* value) {
+  const SelfTestCheck& real = *static_cast<const SelfTestCheck*>(ctx);
+  host::clock_advance_us(kStepCpuUs);
+  return real.step(real.ctx, step, now_us, value);
+}
+
+void reset_world(bool faults) {
+  g_world.gps_fix = !faults;
+  g_world.burn_b_open = faults;
+  g_world.radio_present = !faults;
+  host::g_spi_device[0] = g_world.radio_present ? &g_radio : nullptr;
+  host::g_uart[board::kUartGps].rx.clear();
+  // The receiver's once-a-second output lands at a random point of the run.
+  g_world.next_gga_us = host::g_now_us + g_rng() % kGgaPeriodUs;
+}
+
+uint32_t sim_clock() { return host::clock_now_us(); }
+
+struct RunResult {
+  records::SelfTestReport report;
+  uint32_t duration_us;
+  uint32_t max_poll_us;
+  uint32_t polls;
+};
+
+RunResult run(SelfTest& st, SelfTestMode mode) {
+  RunResult r{};
+  st.start(mode, static_cast<uint32_t>(host::g_now_us / 1000));
+  for (;;) {
+    advance_world();
+    uint32_t t0 = sim_clock();
+    bool done = st.poll(mode == SelfTestMode::kFlight ? kFlightSliceUs : 0);
+    uint32_t dt = sim_clock() - t0;
+    if (dt > r.max_poll_us) r.max_poll_us = dt;
+    ++r.polls;
+    if (done) break;
+    host::clock_advance_us(mode == SelfTestMode::kFlight ? kFlightTickUs - dt : kPadLoopUs);
+  }
+  r.report = st.report();
+  r.duration_us = st.duration_us();
+  return r;
+}
+
+void print_report(const char* title, const RunResult& r) {
+  printf("%s: %.1f ms, %u polls, longest poll %u us\n", title, r.duration_us / 1000.0, r.polls,
+         r.max_poll_us);
+  for (size_t i = 0; i < r.report.checks; ++i) {
+    uint8_t bit = static_cast<uint8_t>(1u << i);
+    const char* v = r.report.passed & bit      ? "pass"
+                    : r.report.failed & bit    ? "FAIL"
+                    : r.report.timed_out & bit ? "TIMEOUT"
+                                               : "skipped";
+    printf("  %-8s %-8s %6d\n", kChecks[i].name, v, r.report.value[i]);
+  }
+}
+
+int expect(const char* what, const RunResult& r, uint8_t passed, uint8_t failed,
+           uint8_t timed_out) {
+  if (r.report.passed == passed && r.report.failed == failed &&
+      r.report.timed_out == timed_out) {
+    return 0;
+  }
+  fprintf(stderr, "%s: passed %02x failed %02x timed out %02x, expected %02x %02x %02x\n", what,
+          r.report.passed, r.report.failed, r.report.timed_out, passed, failed, timed_out);
+  return 1;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  g_rng.seed(argc > 1 ? static_cast<uint32_t>(atol(argv[1])) : 1);
+
+  host::g_i2c_devices[0][0x76] = &g_baro;
+  host::g_i2c_devices[0][0x68] = &g_imu;
+  host::pin_observer = on_pin;
+  host::g_adc[board::kAdcBattery] = 2420;  // 3.9 V
+  host::g_adc[board::kAdcBurnCurrent] = 3;
+  {
+    board::ConfigFlash flash;
+    uint8_t cfg[kConfigBytes];
+    for (uint32_t i = 0; i < kConfigBytes - 4; ++i) cfg[i] = static_cast<uint8_t>(g_rng());
+    uint32_t crc = crc32(cfg, kConfigBytes - 4);
+    for (int i = 0; i < 4; ++i) cfg[kConfigBytes - 4 + i] = static_cast<uint8_t>(crc >> (8 * i));
+    flash.program(0, cfg, kConfigBytes);
+  }
+
+  SelfTest all(sim_clock);
+  for (size_t i = 0; i < kNumChecks; ++i) {
+    g_wrapped[i] = kChecks[i].check;
+    SelfTestCheck c = g_wrapped[i];
+    c.step = charged_step;
+    c.ctx = &g_wrapped[i];
+    all.add(c);
+  }
+  const uint8_t kAll = static_cast<uint8_t>((1u << kNumChecks) - 1);
+  int failures = 0;
+
+  // Serial baseline: each check alone, one after another.
+  reset_world(false);
+  uint32_t serial_us = 0;
+  printf("serial:\n");
+  for (size_t i = 0; i < kNumChecks; ++i) {
+    SelfTest one(sim_clock);
+    SelfTestCheck c = g_wrapped[i];
+    c.step = charged_step;
+    c.ctx = &g_wrapped[i];
+    one.add(c);
+    RunResult r = run(one, SelfTestMode::kPad);
+    serial_us += r.duration_us;
+    printf("  %-8s %s %7.1f ms\n", kChecks[i].name, r.report.passed ? "pass" : "FAIL",
+           r.duration_us / 1000.0);
+    failures += r.report.passed != 1;
+  }
+  printf("serial total: %.1f ms\n", serial_us / 1000.0);
+
+  reset_world(false);
+  RunResult pad = run(all, SelfTestMode::kPad);
+  print_report("concurrent (pad)", pad);
+  failures += expect("pad", pad, kAll, 0, 0);
+  if (pad.duration_us > diag::kSelfTestBudgetMs * 1000) {
+    fprintf(stderr, "pad run took %u us, over the %u ms budget\n", pad.duration_us,
+            diag::kSelfTestBudgetMs);
+    ++failures;
+  }
+
+  reset_world(true);
+  RunResult bad = run(all, SelfTestMode::kPad);
+  print_report("concurrent with faults", bad);
+  failures += expect("faults", bad, static_cast<uint8_t>(kAll & ~(1u << 0 | 1u << 4 | 1u << 5)),
+                     1u << 4 | 1u << 5, 1u << 0);
+
+  reset_world(false);
+  RunResult flight = run(all, SelfTestMode::kFlight);
+  print_report("flight (10 ms tick, 300 us slice)", flight);
+  failures += expect("flight", flight, static_cast<uint8_t>(kAll & ~(1u << 3 | 1u << 4)), 0, 0);
+  // A slice may finish the step that straddles its end: allow one I2C burst.
+  if (flight.max_poll_us > kFlightSliceUs + 400) {
+    fprintf(stderr, "flight poll took %u us for a %u us slice\n", flight.max_poll_us,
+            kFlightSliceUs);
+    ++failures;
+  }
+
+  printf("self_test_ms serial=%.1f pad=%.1f flight=%.1f report=%zu B\n", serial_us / 1000.0,
+         pad.duration_us / 1000.0, flight.duration_us / 1000.0,
+         records::SelfTestReport::kEncodedSize);
+  printf("failures %d\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,436 @@
+// Ground telemetry store over years of fleet flights.
+//
+//   telemetry_store_bench [units] [years] [dir]
+//
+// Each unit flies every one to three weeks: a 5 m/s climb to a 25-32 km
+// burst and a 10 m/s descent, drifting with the wind, reporting a
+// records::StateSnapshot every second. About 1% of frames are lost and
+// 0.5% arrive up to 30 s late, out of order; the last unit runs version 1
+// firmware (no battery field). The fleet's frames are ingested in arrival
+// order into ground::TelemetryStore, flushed once a simulated day as the
+// server does, and ingest is timed against kFleetUnits units all in flight.
+//
+// Queries on one unit at zooms from ten minutes to the whole span are
+// checked against a brute force aggregation of its raw samples (with the
+// store's rule for late samples applied) and must read at most
+// kBoundedBytes when the range fits max_points buckets at some level.
+// The store is then reopened with a torn index entry and stray segment
+// bytes appended, and must answer identically. Exits 1 on any failure.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "generated/records.h"
+#include "ground/telemetry/telemetry_store.h"
+
+using namespace skyguard;
+using namespace skyguard::ground;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+constexpr int64_t kEpoch = 1790000000;  // fleet start, UTC
+constexpr uint32_t kChunkS = 3600;      // feed generated an hour at a time
+constexpr uint32_t kFleetUnits = 1000;  // server sizing: all in flight at 1 Hz
+constexpr size_t kMaxPoints = 1000;
+constexpr size_t kBoundedBytes = 32 * 1024;
+constexpr uint32_t kReferenceUnit = 100;
+// Level bucket and segment window widths, as documented in the store.
+constexpr uint32_t kLevelRes[kTelemetryLevels] = {1, 60, 600};
+constexpr uint32_t kLevelWindow[kTelemetryLevels] = {900, 6 * 3600, 2 * 86400};
+
+struct Flight {
+  int64_t start;
+  double burst_m, wind_n, wind_e, shear_e;
+  int32_t lat_e7, lon_e7;
+};
+
+struct Frame {
+  int64_t rx_s;  // arrival, for ordering
+  int64_t t_s;   // sample time
+  uint32_t unit;
+  uint8_t len;
+  uint8_t payload[records::StateSnapshot::kEncodedSize];
+};
+
+// Raw samples of the reference unit, in arrival order.
+struct RawSample {
+  int64_t t_s;
+  float alt_m;
+  bool kept[kTelemetryLevels];
+};
+
+int64_t floor_to(int64_t t, int64_t step) {
+  int64_t q = t / step;
+  if (t % step && t < 0) --q;
+  return q * step;
+}
+
+double flight_len_s(const Flight& f) { return f.burst_m / 5.0 + f.burst_m / 10.0; }
+
+std::vector<Flight> schedule(uint32_t years, std::mt19937* rng) {
+  std::uniform_real_distribution<double> u(0.0, 1.0);
+  std::vector<Flight> out;
+  int64_t end = kEpoch + int64_t(years) * 365 * 86400;
+  int64_t t = kEpoch + static_cast<int64_t>(u(*rng) * 7 * 86400);
+  while (t < end) {
+    Flight f;
+    f.start = t;
+    f.burst_m = 25000 + 7000 * u(*rng);
+    f.wind_n = -5 + 10 * u(*rng);
+    f.wind_e = 5 * u(*rng);
+    f.shear_e = 0.0015 * u(*rng);  // jet-level wind, m/s per m
+    f.lat_e7 = 400000000 + static_cast<int32_t>(u(*rng) * 1e7);
+    f.lon_e7 = -1050000000 + static_cast<int32_t>(u(*rng) * 1e7);
+    out.push_back(f);
+    t += static_cast<int64_t>((7 + 14 * u(*rng)) * 86400);
+  }
+  return out;
+}
+
+records::StateSnapshot sample(const Flight& f, double s, std::mt19937* rng) {
+  std::normal_distribution<double> noise(0.0, 1.0);
+  double climb = f.burst_m / 5.0;
+  double alt = s < climb ? 5.0 * s : f.burst_m - 10.0 * (s - climb);
+  double vz = s < climb ? 5.0 : -10.0;
+  alt = std::max(0.0, alt + 2 * noise(*rng));
+  double ve = f.wind_e + f.shear_e * alt, vn = f.wind_n;
+  records::StateSnapshot r{};
+  r.time_ms = static_cast<uint32_t>(s * 1000);
+  r.lat_e7 = f.lat_e7 + static_cast<int32_t>(vn * s / 0.0111195);
+  r.lon_e7 = f.lon_e7 + static_cast<int32_t>(ve * s / (0.0111195 * 0.766));
+  r.alt_mm = static_cast<int32_t>(alt * 1000);
+  r.vel_cm_s[0] = static_cast<int16_t>(vn * 100 + 20 * noise(*rng));
+  r.vel_cm_s[1] = static_cast<int16_t>(ve * 100 + 20 * noise(*rng));
+  r.vel_cm_s[2] = static_cast<int16_t>(-vz * 100 + 20 * noise(*rng));
+  r.baro_pa_div4 = static_cast<int16_t>(101325 * exp(-alt / 8434) / 4);
+  r.temp_c10 = static_cast<int16_t>(10 * std::max(-56.5, 15 - 0.0065 * alt));
+  r.state = s < climb ? 2 : 3;
+  bool fix = noise(*rng) < 2.9;  // ~0.2% of samples without a fix
+  r.fix = fix ? 3 : 0;
+  r.sats = static_cast<uint8_t>(fix ? 9 + 2 * noise(*rng) : 3);
+  r.battery_mv = static_cast<uint16_t>(4150 - 0.1 * s);
+  return r;
+}
+
+// One hour of the fleet's frames, plus late ones carried into the hour,
+// in arrival order.
+void generate_chunk(int64_t t0, const std::vector<std::vector<Flight>>& flights,
+                    std::vector<size_t>* next_flight, std::vector<std::mt19937>* rngs,
+                    std::vector<Frame>* carry, std::vector<Frame>* out) {
+  out->clear();
+  std::vector<Frame> later;
+  for (const Frame& f : *carry) (f.rx_s < t0 + kChunkS ? out : &later)->push_back(f);
+  for (uint32_t i = 0; i < flights.size(); ++i) {
+    std::mt19937& rng = (*rngs)[i];
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    size_t& k = (*next_flight)[i];
+    while (k < flights[i].size() &&
+           flights[i][k].start + static_cast<int64_t>(flight_len_s(flights[i][k])) < t0) {
+      ++k;
+    }
+    if (k == flights[i].size()) continue;
+    const Flight& fl = flights[i][k];
+    int64_t end = fl.start + static_cast<int64_t>(flight_len_s(fl));
+    for (int64_t t = std::max(t0, fl.start); t < std::min(t0 + kChunkS, end); ++t) {
+      records::StateSnapshot r = sample(fl, static_cast<double>(t - fl.start), &rng);
+      double p = u(rng);
+      if (p < 0.01) continue;  // lost
+      Frame f;
+      f.t_s = t;
+      f.rx_s = t + 1 + (p < 0.015 ? static_cast<int64_t>(2 + 28 * u(rng)) : 0);
+      f.unit = kReferenceUnit + i;
+      bool v1 = i + 1 == flights.size() && flights.size() > 1;
+      f.len = static_cast<uint8_t>(records::StateSnapshot::encoded_size(v1 ? 1 : 2));
+      r.encode(f.payload, sizeof(f.payload));
+      (f.rx_s < t0 + kChunkS ? out : &later)->push_back(f);
+    }
+  }
+  carry->swap(later);
+  std::stable_sort(out->begin(), out->end(),
+                   [](const Frame& a, const Frame& b) { return a.rx_s < b.rx_s; });
+}
+
+void remove_store(const std::string& dir, uint32_t units) {
+  unlink((dir + "/index").c_str());
+  for (uint32_t i = 0; i < units; ++i) {
+    unlink((dir + "/unit_" + std::to_string(kReferenceUnit + i)).c_str());
+  }
+  rmdir(dir.c_str());
+}
+
+double since_s(Clock::time_point t) {
+  return std::chrono::duration<double>(Clock::now() - t).count();
+}
+
+// Brute force over the raw samples: level buckets starting in [t0, t1),
+// merged into bucket_s buckets.
+std::vector<TsPoint> reference(const std::vector<RawSample>& raw, size_t level, uint32_t bucket_s,
+                               int64_t t0, int64_t t1) {
+  std::vector<TsPoint> out;
+  std::vector<double> sums;
+  auto first = std::lower_bound(raw.begin(), raw.end(), t0,
+                                [](const RawSample& r, int64_t at) { return r.t_s < at; });
+  std::vector<const RawSample*> in;
+  for (auto it = first; it != raw.end() && it->t_s < t1 + kLevelRes[level]; ++it) {
+    int64_t b = floor_to(it->t_s, kLevelRes[level]);
+    if (it->kept[level] && b >= t0 && b < t1) in.push_back(&*it);
+  }
+  std::stable_sort(in.begin(), in.end(),
+                   [](const RawSample* a, const RawSample* b) { return a->t_s < b->t_s; });
+  for (const RawSample* r : in) {
+    int64_t b = floor_to(r->t_s, bucket_s);
+    if (out.empty() || out.back().t_s != b) {
+      out.push_back({b, 0, r->alt_m, 0, r->alt_m});
+      sums.push_back(0);
+    }
+    TsPoint& p = out.back();
+    ++p.count;
+    sums.back() += r->alt_m;
+    p.min = std::min(p.min, r->alt_m);
+    p.max = std::max(p.max, r->alt_m);
+  }
+  for (size_t i = 0; i < out.size(); ++i) {
+    out[i].mean = static_cast<float>(sums[i] / out[i].count);
+    if (level == 0) out[i].min = out[i].max = out[i].mean;  // the 1 s level keeps means
+  }
+  return out;
+}
+
+bool matches(const std::vector<TsPoint>& got, const std::vector<TsPoint>& want) {
+  if (got.size() != want.size()) return false;
+  for (size_t i = 0; i < got.size(); ++i) {
+    const TsPoint& g = got[i];
+    const TsPoint& w = want[i];
+    if (g.t_s != w.t_s || g.count != w.count || g.min != w.min || g.max != w.max ||
+        fabs(g.mean - w.mean) > 1e-3 + 1e-5 * fabs(w.mean)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool same(const std::vector<TsPoint>& a, const std::vector<TsPoint>& b) {
+  if (a.size() != b.size()) return false;
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (a[i].t_s != b[i].t_s || a[i].count != b[i].count || a[i].mean != b[i].mean) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  uint32_t n_units = argc > 1 ? static_cast<uint32_t>(atol(argv[1])) : 8;
+  uint32_t years = argc > 2 ? static_cast<uint32_t>(atol(argv[2])) : 3;
+  std::string dir = argc > 3 ? argv[3] : "/tmp/telemetry_store." + std::to_string(getpid());
+  bool own_dir = argc <= 3;
+  if (n_units == 0 || years == 0) {
+    fprintf(stderr, "usage: telemetry_store_bench [units] [years] [dir]\n");
+    return 2;
+  }
+  if (own_dir) remove_store(dir, n_units);
+
+  std::mt19937 rng(11);
+  std::vector<std::vector<Flight>> flights;
+  std::vector<std::mt19937> rngs;
+  for (uint32_t i = 0; i < n_units; ++i) {
+    flights.push_back(schedule(years, &rng));
+    rngs.emplace_back(1000 + i);
+  }
+
+  std::string err;
+  TelemetryStore store;
+  if (!store.open(dir, &err)) {
+    fprintf(stderr, "%s\n", err.c_str());
+    return 2;
+  }
+  std::vector<RawSample> raw;
+  int64_t head[kTelemetryLevels] = {INT64_MIN, INT64_MIN, INT64_MIN};
+  std::vector<size_t> next_flight(n_units, 0);
+  std::vector<Frame> carry, chunk;
+  int64_t end = kEpoch + int64_t(years) * 365 * 86400 + 86400;
+  size_t frames = 0;
+  double gen_s = 0, ingest_s = 0;
+  for (int64_t t0 = kEpoch; t0 < end; t0 += kChunkS) {
+    auto t = Clock::now();
+    generate_chunk(t0, flights, &next_flight, &rngs, &carry, &chunk);
+    gen_s += since_s(t);
+    t = Clock::now();
+    for (const Frame& f : chunk) {
+      if (!store.ingest(f.unit, f.t_s, f.payload, f.len, &err)) {
+        fprintf(stderr, "ingest: %s\n", err.c_str());
+        return 2;
+      }
+    }
+    if ((t0 - kEpoch + kChunkS) % 86400 == 0 && !store.flush(&err)) {
+      fprintf(stderr, "flush: %s\n", err.c_str());
+      return 2;
+    }
+    ingest_s += since_s(t);
+    frames += chunk.size();
+    // The store's rule: a sample before a level's open window is dropped.
+    // A daily flush closes the windows, so later samples open new ones.
+    for (const Frame& f : chunk) {
+      if (f.unit != kReferenceUnit) continue;
+      RawSample r;
+      r.t_s = f.t_s;
+      r.alt_m = static_cast<int32_t>(f.payload[12] | f.payload[13] << 8 | f.payload[14] << 16 |
+                                     uint32_t{f.payload[15]} << 24) /
+                1000.0f;
+      for (size_t l = 0; l < kTelemetryLevels; ++l) {
+        int64_t w = floor_to(f.t_s, kLevelWindow[l]);
+        r.kept[l] = w >= head[l];
+        if (r.kept[l]) head[l] = w;
+      }
+      raw.push_back(r);
+    }
+    if ((t0 - kEpoch + kChunkS) % 86400 == 0) {
+      for (int64_t& h : head) h = INT64_MIN;
+    }
+  }
+  auto t = Clock::now();
+  if (!store.flush(&err)) {
+    fprintf(stderr, "flush: %s\n", err.c_str());
+    return 2;
+  }
+  ingest_s += since_s(t);
+  std::stable_sort(raw.begin(), raw.end(),
+                   [](const RawSample& a, const RawSample& b) { return a.t_s < b.t_s; });
+
+  double rate = frames / ingest_s;
+  printf("%u units x %u years: %zu frames, %llu segments, %.1f MB on disk "
+         "(raw frames %.1f MB)\n",
+         n_units, years, frames, static_cast<unsigned long long>(store.sealed_segments()),
+         store.bytes_written() / 1e6, frames * (12.0 + records::StateSnapshot::kEncodedSize) / 1e6);
+  printf("late samples dropped per level: %llu / %llu / %llu\n",
+         static_cast<unsigned long long>(store.late(0)),
+         static_cast<unsigned long long>(store.late(1)),
+         static_cast<unsigned long long>(store.late(2)));
+  printf("ingest %.2f M frames/s (%.0fx a %u-unit fleet at 1 Hz); generator %.1f s\n",
+         rate / 1e6, rate / kFleetUnits, kFleetUnits, gen_s);
+
+  // Zoom levels on the reference unit, each at random ranges.
+  struct Zoom {
+    const char* name;
+    int64_t span_s;
+  };
+  const Zoom zooms[] = {{"10 min", 600},           {"1 hour", 3600},
+                        {"6 hours", 6 * 3600},     {"1 day", 86400},
+                        {"1 week", 7 * 86400},     {"1 month", 30 * 86400},
+                        {"1 year", 365 * 86400LL}, {"all", int64_t(years) * 365 * 86400}};
+  size_t alt = static_cast<size_t>(telemetry_metric_index("alt_m"));
+  size_t failures = 0;
+  std::uniform_real_distribution<double> u(0.0, 1.0);
+  std::vector<std::vector<TsPoint>> kept;
+  std::vector<std::pair<int64_t, int64_t>> ranges;
+  printf("\n%-8s %5s %7s %9s %10s %9s %11s %10s\n", "zoom", "level", "bucket", "segments",
+         "bytes", "points", "raw bytes", "query us");
+  for (const Zoom& z : zooms) {
+    constexpr int kReps = 40;
+    TsQueryStats worst;
+    size_t points = 0, raw_bytes = 0;
+    double us = 0;
+    for (int rep = 0; rep < kReps; ++rep) {
+      // Anchor on a random sample so most ranges hold data.
+      int64_t mid = raw.empty() ? kEpoch : raw[static_cast<size_t>(u(rng) * raw.size())].t_s;
+      int64_t t0 = mid - static_cast<int64_t>(u(rng) * z.span_s);
+      if (z.span_s >= end - kEpoch) t0 = kEpoch;
+      int64_t t1 = t0 + z.span_s;
+      TsQueryStats st;
+      auto tq = Clock::now();
+      std::vector<TsPoint> got = store.query(kReferenceUnit, alt, t0, t1, kMaxPoints, &st);
+      us += since_s(tq) * 1e6;
+      std::vector<TsPoint> want = reference(raw, st.level, st.bucket_s, t0, t1);
+      if (!matches(got, want)) {
+        printf("  MISMATCH %s [%lld, %lld): %zu points, want %zu\n", z.name,
+               static_cast<long long>(t0), static_cast<long long>(t1), got.size(), want.size());
+        ++failures;
+      }
+      bool fits = (t1 - t0) <= int64_t(kMaxPoints) * kLevelRes[kTelemetryLevels - 1];
+      if (fits && st.bytes > kBoundedBytes) {
+        printf("  UNBOUNDED %s: %zu bytes\n", z.name, st.bytes);
+        ++failures;
+      }
+      if (st.bytes >= worst.bytes) worst = st;
+      points += got.size();
+      auto lo = std::lower_bound(raw.begin(), raw.end(), t0,
+                                 [](const RawSample& r, int64_t at) { return r.t_s < at; });
+      auto hi = std::lower_bound(raw.begin(), raw.end(), t1,
+                                 [](const RawSample& r, int64_t at) { return r.t_s < at; });
+      raw_bytes += static_cast<size_t>(hi - lo) * records::StateSnapshot::kEncodedSize;
+      if (rep < 2) {
+        kept.push_back(got);
+        ranges.push_back({t0, t1});
+      }
+    }
+    printf("%-8s %5zu %6us %9zu %10zu %9zu %11zu %10.1f\n", z.name, worst.level, worst.bucket_s,
+           worst.segments, worst.bytes, points / kReps, raw_bytes / kReps, us / kReps);
+  }
+
+  // Fleet-wide daily altitude over a month.
+  TsQueryStats fst;
+  t = Clock::now();
+  std::vector<TsPoint> fleet = store.fleet(alt, kEpoch, kEpoch + 30 * 86400LL, 30, &fst);
+  double fleet_ms = since_s(t) * 1e3;
+  uint64_t fleet_count = 0;
+  for (const TsPoint& p : fleet) fleet_count += p.count;
+  uint64_t unit_count = 0;
+  for (uint32_t unit : store.units()) {
+    for (const TsPoint& p : store.query(unit, alt, kEpoch, kEpoch + 30 * 86400LL, 30)) {
+      unit_count += p.count;
+    }
+  }
+  if (fleet_count != unit_count) {
+    printf("  fleet count %llu, units sum to %llu\n", static_cast<unsigned long long>(fleet_count),
+           static_cast<unsigned long long>(unit_count));
+    ++failures;
+  }
+  printf("\nfleet month query (%u units, %zu buckets of %u s): %.2f ms, %zu bytes\n", n_units,
+         fleet.size(), fst.bucket_s, fleet_ms, fst.bytes);
+  if (!store.close(&err)) {
+    fprintf(stderr, "close: %s\n", err.c_str());
+    return 2;
+  }
+
+  // Crash mid-seal: stray segment bytes and a torn index entry.
+  if (FILE* f = fopen((dir + "/unit_" + std::to_string(kReferenceUnit)).c_str(), "ab")) {
+    fwrite("SGTS\x00\x0b\x03\x00\x01\x00", 1, 10, f);
+    fclose(f);
+  }
+  if (FILE* f = fopen((dir + "/index").c_str(), "ab")) {
+    fwrite("\x64\x00\x00\x00\x00\x00\x00", 1, 7, f);
+    fclose(f);
+  }
+  TelemetryStore reopened;
+  t = Clock::now();
+  if (!reopened.open(dir, &err)) {
+    fprintf(stderr, "%s\n", err.c_str());
+    return 2;
+  }
+  double open_ms = since_s(t) * 1e3;
+  size_t replay_mismatches = 0;
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    replay_mismatches += !same(kept[i], reopened.query(kReferenceUnit, alt, ranges[i].first,
+                                                       ranges[i].second, kMaxPoints));
+  }
+  printf("reopen after torn seal: %.1f ms, %llu segments, %zu replay mismatches\n", open_ms,
+         static_cast<unsigned long long>(reopened.sealed_segments()), replay_mismatches);
+  failures += replay_mismatches;
+  if (rate < kFleetUnits) {
+    printf("  ingest below the fleet rate\n");
+    ++failures;
+  }
+  reopened.close(&err);
+  if (own_dir) remove_store(dir, n_units);
+  printf("\nfailures %zu\n", failures);
+  return failures ? 1 : 0;
+}
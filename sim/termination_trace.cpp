@@ -0,0 +1,384 @@
+// Decision provenance from the termination engine, end to end.
+//
+//   termination_trace [flights] [seed]
+//
+// Generates synthetic flights at the 10 Hz rule tick (ascent and float
+// with fence drift, failed fence reads, GPS dropouts, link outages, a
+// sagging battery, the odd remote cut) and runs each through a
+// TerminationEngine with a ProvenanceEncoder attached. The ground decoder
+// rebuilds the timeline from the entries, which must give the engine's
+// condition state at every tick, the inputs each entry carried, and the
+// deciding rule. One flight's sink refuses an entry, to check that the
+// decoder picks up again at the next one. Prints the first flight's
+// timeline, the trace size against logging every tick, and the per-tick
+// cost with and without the trace.
+//
+// Then scripted ticks check the engine's handling of an unknown fence
+// margin: a breach reading followed by failed reads must not cut until
+// known readings have held the breach for hold_ms, and an entry carrying
+// an unknown margin must decode as unknown. Others check that
+// kTrafficAwareRules defers a flight timeout while traffic is in the clear
+// cylinder, up to its bound, and cuts at once when the sky is clear or the
+// fence is breached.
+//
+// Exits 1 on a reconstruction mismatch, a failed engine check, or if
+// tracing adds more than kMaxOverheadPct to the engine's tick.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ground/termination/provenance_decode.h"
+#include "termination/termination_engine.h"
+
+using namespace skyguard;
+using namespace skyguard::termination;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t kTickMs = 100;
+constexpr double kMaxOverheadPct = 3.0;
+
+struct Flight {
+  std::vector<RuleInputs> ticks;
+};
+
+/// One flight until 60 s after the cut, or the flight timeout.
+Flight synth_flight(std::mt19937& rng, const TerminationLimits& limits) {
+  std::uniform_real_distribution<double> u(0, 1);
+  std::normal_distribution<double> noise(0, 1);
+  const double ascent_mps = 4 + 2 * u(rng);
+  const double float_m = 27000 + 7000 * u(rng);
+  const double drift_mps = 4 * u(rng);
+  const double fence_m = 15000 + 40000 * u(rng);
+  const double remote_s = u(rng) < 0.2 ? 1800 + 9000 * u(rng) : -1;
+  const double drain_mv_per_h = 60 + 180 * u(rng);
+
+  Flight f;
+  TerminationEngine engine(limits);
+  double gps_out_from = 0, gps_out_until = 0, link_out_until = 0, sag_until = 0, last_heard = 0;
+  double fence_err_until = 0;
+  double cut_at = -1;
+  const double pad_s = 120;
+  for (uint32_t t_ms = 0;; t_ms += kTickMs) {
+    double t = t_ms / 1000.0, flight = t > pad_s ? t - pad_s : 0;
+    RuleInputs in{};
+    in.time_ms = t_ms;
+    in.armed = t >= 60;
+    in.cut_command = remote_s > 0 && flight >= remote_s && flight < remote_s + 2;
+    double alt = std::min(flight * ascent_mps, float_m);
+    if (cut_at >= 0) alt = std::max(0.0, alt - 60 * (t - cut_at));
+    in.alt_m = static_cast<int32_t>(alt + 3 * noise(rng));
+    in.fence_margin_m = static_cast<int32_t>(fence_m - drift_mps * flight + 20 * noise(rng));
+    if (t > fence_err_until && u(rng) < 1.0 / 20000) fence_err_until = t + 0.5 + 5 * u(rng);
+    if (t < fence_err_until) in.fence_margin_m = kFenceMarginUnknown;  // failed fence reads
+    in.flight_s = static_cast<uint32_t>(flight);
+
+    if (t > gps_out_until && u(rng) < 1.0 / 30000) {
+      gps_out_from = t;
+      gps_out_until = t + 5 + 90 * u(rng);
+    }
+    in.fix_age_ms = t < gps_out_until ? static_cast<uint32_t>((t - gps_out_from) * 1000 + 1000)
+                                      : t_ms % 1000;
+    if (t > link_out_until && u(rng) < 1.0 / 50000) link_out_until = t + 120 + 1200 * u(rng);
+    if (t >= link_out_until && t - last_heard >= 30) last_heard = t;
+    in.link_silence_s = static_cast<uint32_t>(t - last_heard);
+
+    if (t > sag_until && u(rng) < 1.0 / 4000) sag_until = t + 0.5 + 4 * u(rng);
+    double mv = 4050 - drain_mv_per_h * flight / 3600 + 8 * noise(rng);
+    if (t < sag_until) mv -= 700;
+    in.battery_mv = static_cast<uint16_t>(mv);
+    in.freefall = cut_at >= 0 && t - cut_at < 20;
+
+    f.ticks.push_back(in);
+    if (engine.evaluate(in) && cut_at < 0) cut_at = t;
+    if ((cut_at >= 0 && t - cut_at >= 60) || flight > limits.max_flight_s + 60) break;
+  }
+  return f;
+}
+
+struct Capture {
+  std::vector<uint8_t> bytes;
+  uint32_t refuse_at = UINT32_MAX;  // index of the entry to refuse
+  uint32_t calls = 0;
+};
+
+bool capture_write(void* ctx, const uint8_t* entry, size_t len) {
+  auto* c = static_cast<Capture*>(ctx);
+  if (c->calls++ == c->refuse_at) return false;
+  c->bytes.insert(c->bytes.end(), entry, entry + len);
+  return true;
+}
+
+double expected_value(Condition c, const RuleInputs& in) {
+  size_t i = static_cast<size_t>(c);
+  const ProvenanceField& f = kProvenanceFields[i];
+  uint32_t raw = provenance_value(c, in);
+  if ((c == Condition::kFenceBreach || c == Condition::kFenceNear) &&
+      in.fence_margin_m == kFenceMarginUnknown) {
+    return NAN;
+  }
+  double v = raw;
+  if (f.is_signed && (raw >> (f.bits - 1) & 1)) v -= static_cast<double>(1ull << f.bits);
+  return v * f.scale;
+}
+
+struct RunResult {
+  size_t ticks = 0;
+  size_t entries = 0;
+  size_t bytes = 0;
+  size_t mismatches = 0;
+  int fired = -1;
+};
+
+/// Runs `f` with tracing and checks the decoded timeline against the
+/// engine tick by tick. Ticks from a refused entry up to the next
+/// accepted one are not compared (the decoder cannot know them).
+RunResult trace_flight(const Flight& f, const TerminationLimits& limits, uint32_t refuse_at,
+                       bool print) {
+  Capture cap;
+  cap.refuse_at = refuse_at;
+  ProvenanceEncoder enc(ProvenanceSink{capture_write, &cap});
+  TerminationEngine engine(limits);
+  engine.attach(&enc);
+
+  std::vector<uint16_t> state;
+  std::vector<int32_t> entry_tick;  // tick of each accepted entry
+  uint32_t gap_from = UINT32_MAX, gap_to = UINT32_MAX;
+  RunResult r;
+  for (size_t k = 0; k < f.ticks.size(); ++k) {
+    uint32_t calls = cap.calls;
+    size_t before = cap.bytes.size();
+    engine.evaluate(f.ticks[k]);
+    state.push_back(engine.conditions());
+    if (cap.calls != calls) {
+      if (cap.bytes.size() != before) {
+        entry_tick.push_back(static_cast<int32_t>(k));
+        if (gap_from != UINT32_MAX && gap_to == UINT32_MAX) gap_to = static_cast<uint32_t>(k);
+      } else {
+        gap_from = static_cast<uint32_t>(k);
+      }
+    }
+  }
+  r.ticks = f.ticks.size();
+  r.fired = engine.fired_rule();
+
+  ground::DecisionTimeline tl;
+  std::string err;
+  if (!ground::decode_provenance(cap.bytes.data(), cap.bytes.size(), &tl, &err)) {
+    fprintf(stderr, "decode: %s\n", err.c_str());
+    ++r.mismatches;
+    return r;
+  }
+  r.entries = tl.steps.size();
+  r.bytes = tl.bytes;
+  if (tl.steps.size() != entry_tick.size() || tl.skipped) {
+    fprintf(stderr, "%zu steps decoded (%zu skipped), %zu entries written\n", tl.steps.size(),
+            tl.skipped, entry_tick.size());
+    ++r.mismatches;
+    return r;
+  }
+  for (size_t k = 0; k < state.size(); ++k) {
+    if (k >= gap_from && k < gap_to) continue;
+    if (ground::conditions_at(tl, f.ticks[k].time_ms) != state[k]) ++r.mismatches;
+  }
+  int decided_steps = 0;
+  for (size_t s = 0; s < tl.steps.size(); ++s) {
+    const ground::DecisionStep& st = tl.steps[s];
+    const RuleInputs& in = f.ticks[static_cast<size_t>(entry_tick[s])];
+    if (st.time_ms != in.time_ms) ++r.mismatches;
+    for (size_t i = 0; i < kConditionCount; ++i) {
+      if (!(st.carried >> i & 1) || !kProvenanceFields[i].bits) continue;
+      double want = expected_value(static_cast<Condition>(i), in);
+      if (isnan(want) ? !isnan(st.values[i]) : st.values[i] != want) ++r.mismatches;
+    }
+    if (st.rule >= 0) {
+      ++decided_steps;
+      if (st.rule != engine.fired_rule() || st.rule_mask != engine.rule_mask(st.rule)) {
+        ++r.mismatches;
+      }
+    }
+    if (print) printf("  %s\n", ground::format_step(st).c_str());
+  }
+  if (decided_steps != (engine.cut() ? 1 : 0)) ++r.mismatches;
+  return r;
+}
+
+/// Best-of ns per tick over all flights.
+double ns_per_tick(const std::vector<Flight>& flights, const TerminationLimits& limits,
+                   bool trace, size_t total_ticks) {
+  Capture cap;
+  cap.bytes.reserve(1 << 20);
+  ProvenanceEncoder enc(ProvenanceSink{capture_write, &cap});
+  volatile uint32_t sink = 0;
+  auto t0 = Clock::now();
+  uint32_t acc = 0;
+  for (const Flight& f : flights) {
+    TerminationEngine engine(limits);
+    if (trace) engine.attach(&enc);
+    for (const RuleInputs& in : f.ticks) acc += engine.evaluate(in);
+  }
+  sink = acc;
+  (void)sink;
+  return std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / total_ticks;
+}
+
+// Runs `margins` (one per kTickMs tick, armed, otherwise quiet) and
+// returns the tick index of the cut, or -1.
+int run_margins(const std::vector<int32_t>& margins) {
+  TerminationEngine engine;
+  for (size_t i = 0; i < margins.size(); ++i) {
+    RuleInputs in{};
+    in.time_ms = static_cast<uint32_t>(i) * kTickMs;
+    in.armed = true;
+    in.fence_margin_m = margins[i];
+    in.battery_mv = 4000;
+    in.traffic_m = UINT32_MAX;
+    if (engine.evaluate(in)) return static_cast<int>(i);
+  }
+  return -1;
+}
+
+// Runs a flight past its timeout under kTrafficAwareRules, with traffic in
+// the clear cylinder on the ticks marked busy. Returns the tick index of the
+// cut or -1.
+int run_traffic(const std::vector<bool>& busy, int32_t margin_m) {
+  TerminationLimits limits;
+  TerminationEngine engine(limits);
+  engine.set_rules(kTrafficAwareRules, kTrafficAwareRuleCount);
+  for (size_t i = 0; i < busy.size(); ++i) {
+    RuleInputs in{};
+    in.time_ms = static_cast<uint32_t>(i) * kTickMs;
+    in.armed = true;
+    in.fence_margin_m = margin_m;
+    in.flight_s = limits.max_flight_s;
+    in.battery_mv = 4000;
+    in.airspace_clear = !busy[i];
+    in.traffic_m = busy[i] ? 1200 : UINT32_MAX;
+    if (engine.evaluate(in)) return static_cast<int>(i);
+  }
+  return -1;
+}
+
+int engine_checks(const TerminationLimits& limits) {
+  const size_t hold = limits.hold_ms / kTickMs;
+  int failures = 0;
+  auto check = [&](const char* what, bool ok) {
+    if (!ok) {
+      fprintf(stderr, "engine check failed: %s\n", what);
+      ++failures;
+    }
+  };
+  // One breach reading, unknown for twice the hold, then clear.
+  std::vector<int32_t> m(1, -50);
+  m.insert(m.end(), 2 * hold, kFenceMarginUnknown);
+  m.insert(m.end(), 2 * hold, 2000);
+  check("breach, unknown, cleared: no cut", run_margins(m) < 0);
+  // The same with the breach read again after the unknown span: the hold
+  // needs hold_ms of known readings, so the cut comes hold_ms after the
+  // first reading, counting known ticks only.
+  m.assign(1, -50);
+  m.insert(m.end(), 2 * hold, kFenceMarginUnknown);
+  m.insert(m.end(), 2 * hold, -50);
+  check("breach, unknown, breach: cut after hold_ms of readings",
+        run_margins(m) == static_cast<int>(2 * hold + hold));
+  // A breach already held stays held through an unknown span.
+  m.assign(hold + 1, -50);
+  m.insert(m.end(), hold, kFenceMarginUnknown);
+  check("held breach: cut before the unknown span", run_margins(m) == static_cast<int>(hold));
+
+  // Traffic-aware timing: a clear sky cuts at once; traffic defers the
+  // timeout until it leaves, or for at most the rule's defer_ms; a breach
+  // does not wait.
+  const size_t defer = kTrafficAwareRules[3].defer_ms / kTickMs;
+  check("timeout, airspace clear: cut at once", run_traffic(std::vector<bool>(10), 2000) == 0);
+  std::vector<bool> busy(200, true);
+  busy.resize(400, false);
+  check("timeout, traffic for 20 s: cut when it clears", run_traffic(busy, 2000) == 200);
+  busy.assign(2 * defer, true);
+  check("timeout, traffic throughout: cut at the defer bound",
+        run_traffic(busy, 2000) == static_cast<int>(defer));
+  check("breach, traffic throughout: cut after hold_ms",
+        run_traffic(busy, -50) == static_cast<int>(hold));
+
+  Capture cap;
+  ProvenanceEncoder enc(ProvenanceSink{capture_write, &cap});
+  RuleInputs in{};
+  in.fence_margin_m = kFenceMarginUnknown;
+  uint16_t breach = condition_bit(Condition::kFenceBreach);
+  enc.record(in, breach, breach, -1, 0);
+  ground::DecisionTimeline tl;
+  std::string err;
+  bool decoded = ground::decode_provenance(cap.bytes.data(), cap.bytes.size(), &tl, &err) &&
+                 tl.steps.size() == 1;
+  check("unknown margin decodes as unknown",
+        decoded && isnan(tl.steps[0].values[static_cast<size_t>(Condition::kFenceBreach)]) &&
+            ground::format_step(tl.steps[0]).find("fence_margin=unknown") != std::string::npos);
+  return failures;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t n_flights = argc > 1 ? static_cast<size_t>(atol(argv[1])) : 40;
+  uint32_t seed = argc > 2 ? static_cast<uint32_t>(atol(argv[2])) : 1;
+  std::mt19937 rng(seed);
+  TerminationLimits limits;
+
+  std::vector<Flight> flights;
+  size_t total_ticks = 0;
+  for (size_t i = 0; i < n_flights; ++i) {
+    flights.push_back(synth_flight(rng, limits));
+    total_ticks += flights.back().ticks.size();
+  }
+
+  size_t mismatches = 0, entries = 0, bytes = 0;
+  int by_rule[kMaxRules + 1] = {};
+  for (size_t i = 0; i < flights.size(); ++i) {
+    if (i == 0) printf("flight 0 timeline:\n");
+    uint32_t refuse = i == 1 ? 3 : UINT32_MAX;
+    RunResult r = trace_flight(flights[i], limits, refuse, i == 0);
+    if (r.mismatches) fprintf(stderr, "flight %zu: %zu mismatches\n", i, r.mismatches);
+    mismatches += r.mismatches;
+    entries += r.entries;
+    bytes += r.bytes;
+    ++by_rule[r.fired + 1];
+  }
+  printf("%zu flights, %zu ticks (%.1f h); cuts by rule:", flights.size(), total_ticks,
+         total_ticks * kTickMs / 3.6e6);
+  for (size_t i = 0; i < kDefaultRuleCount; ++i) printf(" %zu:%d", i, by_rule[i + 1]);
+  printf(", none:%d\n", by_rule[0]);
+  double hours = total_ticks * kTickMs / 3.6e6;
+  printf("trace: %zu entries, %zu bytes (%.1f B/entry, %.0f B/h); every tick verbatim: %zu bytes\n",
+         entries, bytes, entries ? double(bytes) / entries : 0.0, bytes / hours,
+         total_ticks * sizeof(RuleInputs));
+
+  double off = 1e30, on = 1e30;
+  for (int rep = 0; rep < 15; ++rep) {
+    off = std::min(off, ns_per_tick(flights, limits, false, total_ticks));
+    on = std::min(on, ns_per_tick(flights, limits, true, total_ticks));
+  }
+  double overhead = (on - off) / off * 100;
+  printf("tick (host): %.2f ns without trace, %.2f ns with, overhead %.2f%% (limit %.1f%%)\n", off,
+         on, overhead, kMaxOverheadPct);
+
+  int failures = engine_checks(limits);
+  if (mismatches) {
+    fprintf(stderr, "%zu reconstruction mismatches\n", mismatches);
+    ++failures;
+  }
+  if (overhead > kMaxOverheadPct) {
+    fprintf(stderr, "trace overhead %.2f%% over %.1f%%\n", overhead, kMaxOverheadPct);
+    ++failures;
+  }
+  printf("failures %d\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,327 @@
+// Sensor time alignment against last-arrived fusion, on synthetic flights.
+//
+//   time_align_sim [flights] [seed]
+//
+// FlightSynth flights are delivered the way the hardware delivers them:
+// GPS fixes after a solution age of 300-900 ms that the receiver reports,
+// baro conversions one tick late, and IMU samples in FIFO bursts of five
+// read every 500 ms. The same estimator runs twice at the 10 Hz tick. It
+// estimates vertical rate from IMU acceleration corrected towards GPS and
+// baro climb, and wind as GPS horizontal velocity tagged with baro
+// altitude. One copy takes the last sample of each stream to arrive as
+// current; the other reads streams aligned by sensors::AlignedStream at
+// an epoch kFusionDelayMs behind. Each is scored against the truth at the
+// instant it claims to describe, over the whole flight and over the
+// minute after burst or cut.
+//
+// Also checks AlignedStream itself: exact on a linear ramp, bursts
+// stamped at their sample instants, wrap-around, and stale and too-old
+// epochs reported as such.
+//
+// Exits 1 if a check fails or alignment does not reduce every error.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+
+#include "sensors/time_align.h"
+#include "sim/flight_synth.h"
+
+using namespace skyguard;
+using namespace skyguard::sim;
+using sensors::AlignedStream;
+using sensors::AlignStatus;
+
+namespace {
+
+constexpr uint32_t kGpsAgeMinMs = 300;
+constexpr uint32_t kGpsAgeMaxMs = 900;
+constexpr uint32_t kBaroLatencyMs = 100;
+constexpr size_t kImuBurst = 5;
+// Above the oldest GPS solution plus a tick, so every stream brackets it.
+constexpr uint32_t kFusionDelayMs = 1000;
+constexpr uint32_t kGpsMaxGapMs = 2500;
+constexpr uint32_t kSensorMaxGapMs = 1000;
+constexpr size_t kTruthDepth = 64;  // ticks
+constexpr double kDynamicS = 60;
+
+// Estimator gains per 100 ms step.
+constexpr double kGpsGain = 0.05;
+constexpr double kBaroGain = 0.02;
+constexpr size_t kBaroRateSteps = 10;
+
+size_t failures = 0;
+
+void check(bool ok, const char* what) {
+  if (!ok && failures++ < 10) printf("FAIL %s\n", what);
+}
+
+// Standard atmosphere to 20 km; only differences between estimate and
+// truth matter here.
+double pressure_alt_m(double pa) {
+  if (pa > 22632.1) return 44330.8 * (1 - pow(pa / 101325.0, 0.190263));
+  return 11000 + 6341.62 * log(22632.1 / pa);
+}
+
+struct Truth {
+  uint32_t time_ms;
+  double vz, vn, ve;
+  bool dynamic;
+  bool baro_valid;
+  double baro_alt_m;  // what the baro read at this instant
+};
+
+struct Inputs {
+  double accel_up;  // m/s^2 besides gravity
+  bool gps;
+  double vz, vn, ve;
+  bool baro;
+  double baro_alt_m;
+};
+
+class Estimator {
+ public:
+  void step(const Inputs& in, double dt) {
+    vz_ += in.accel_up * dt;
+    if (in.gps) vz_ += kGpsGain * (in.vz - vz_);
+    if (!in.baro) {
+      baro_n_ = 0;  // the rate needs an unbroken second
+    } else {
+      if (baro_n_ >= kBaroRateSteps) {
+        double rate = (in.baro_alt_m - baro_[baro_i_]) / (kBaroRateSteps * dt);
+        vz_ += kBaroGain * (rate - vz_);
+      }
+      baro_[baro_i_] = in.baro_alt_m;
+      baro_i_ = (baro_i_ + 1) % kBaroRateSteps;
+      baro_n_ = std::min(baro_n_ + 1, kBaroRateSteps);
+    }
+  }
+  double vz() const { return vz_; }
+
+ private:
+  double vz_ = 0;
+  double baro_[kBaroRateSteps] = {};
+  size_t baro_i_ = 0, baro_n_ = 0;
+};
+
+struct ErrorStats {
+  double sum2 = 0, max = 0;
+  uint64_t n = 0;
+  void add(double e) {
+    sum2 += e * e;
+    max = std::max(max, fabs(e));
+    ++n;
+  }
+  double rms() const { return n ? sqrt(sum2 / n) : 0; }
+};
+
+struct Scores {
+  ErrorStats climb, climb_dynamic, wind, wind_alt;
+};
+
+// `t` is the truth at the claimed instant; `measured` at the instant the
+// GPS velocity describes, where its altitude tag belongs. The tag is
+// scored against the baro's own reading then, so that only the pairing
+// counts, not the sensor's error.
+void score(const Truth& t, const Truth& measured, const Estimator& e, const Inputs& in,
+           Scores* s) {
+  s->climb.add(e.vz() - t.vz);
+  if (t.dynamic) s->climb_dynamic.add(e.vz() - t.vz);
+  if (!in.gps) return;
+  s->wind.add(hypot(in.vn - t.vn, in.ve - t.ve));
+  if (in.baro && measured.baro_valid) s->wind_alt.add(in.baro_alt_m - measured.baro_alt_m);
+}
+
+struct GpsInFlight {
+  uint32_t arrive_ms;
+  uint32_t age_ms;
+  float v[3];  // up, north, east
+};
+
+void run_flight(const SynthConfig& cfg, uint64_t seed, uint64_t flight, Scores* naive_s,
+                Scores* aligned_s) {
+  FlightSynth synth(cfg, seed, flight);
+  SynthRng rng(seed * 131 + flight);
+  const double dt = cfg.step_ms / 1000.0;
+
+  AlignedStream<1, 16> imu(0, kSensorMaxGapMs);
+  AlignedStream<3, 4> gps(0, kGpsMaxGapMs);  // stamped from the solution age
+  AlignedStream<1, 16> baro(kBaroLatencyMs, kSensorMaxGapMs);
+
+  Truth truth[kTruthDepth];
+  GpsInFlight gps_q[4];
+  size_t gps_n = 0;
+  float imu_fifo[kImuBurst];
+  size_t imu_n = 0;
+  bool baro_pending = false;
+  float baro_pending_alt = 0;
+
+  // Last arrived, as the naive fusion sees it.
+  double last_accel = 0, last_baro_alt = 0;
+  float last_gps[3] = {};
+  uint32_t last_gps_ms = 0, last_baro_ms = 0, last_imu_ms = 0;
+  uint32_t last_gps_valid_ms = 0;
+  bool have_gps = false, have_baro = false;
+
+  Estimator naive, aligned;
+  double descent_start_s = -1;
+  SynthSample s;
+  uint64_t tick = 0;
+  while (synth.next(&s)) {
+    uint32_t now = s.time_ms;
+    double t_s = now / 1000.0;
+    if (s.phase == SynthPhase::kDescent && descent_start_s < 0) descent_start_s = t_s;
+    Truth& tr = truth[tick % kTruthDepth];
+    double baro_alt = pressure_alt_m(s.baro_pa);
+    tr = {now,
+          -s.vel_d_mps,
+          s.vel_n_mps,
+          s.vel_e_mps,
+          descent_start_s >= 0 && t_s - descent_start_s < kDynamicS,
+          s.baro_valid,
+          baro_alt};
+
+    // Deliveries due this tick. The baro conversion started last tick.
+    if (baro_pending) {
+      float v[1] = {baro_pending_alt};
+      baro.push_arrival(now, v);
+      last_baro_alt = baro_pending_alt;
+      last_baro_ms = now;
+      have_baro = true;
+      baro_pending = false;
+    }
+    if (s.baro_valid) {
+      baro_pending = true;
+      baro_pending_alt = static_cast<float>(baro_alt);
+    }
+    imu_fifo[imu_n++] = static_cast<float>((s.accel_mg[2] - 1000) * 9.81e-3);
+    if (imu_n == kImuBurst) {
+      imu.push_block(now, cfg.step_ms * 1000, imu_fifo, imu_n);
+      last_accel = imu_fifo[imu_n - 1];
+      last_imu_ms = now;
+      imu_n = 0;
+    }
+    if (s.gps_new && gps_n < 4) {
+      uint32_t age = static_cast<uint32_t>(rng.uniform(kGpsAgeMinMs, kGpsAgeMaxMs));
+      age -= age % cfg.step_ms;  // arrivals land on ticks
+      gps_q[gps_n++] = {now + age, age,
+                        {s.gps.vel_cm_s[2] * -0.01f, s.gps.vel_cm_s[0] * 0.01f,
+                         s.gps.vel_cm_s[1] * 0.01f}};
+    }
+    for (size_t i = 0; i < gps_n;) {
+      if (static_cast<int32_t>(now - gps_q[i].arrive_ms) < 0) {
+        ++i;
+        continue;
+      }
+      gps.push(gps_q[i].arrive_ms - gps_q[i].age_ms, gps_q[i].v);
+      for (int c = 0; c < 3; ++c) last_gps[c] = gps_q[i].v[c];
+      last_gps_ms = now;
+      last_gps_valid_ms = gps_q[i].arrive_ms - gps_q[i].age_ms;
+      have_gps = true;
+      gps_q[i] = gps_q[--gps_n];
+    }
+
+    // Last arrived, taken as now.
+    Inputs in{};
+    in.accel_up = now - last_imu_ms <= kSensorMaxGapMs ? last_accel : 0;
+    in.gps = have_gps && now - last_gps_ms <= kGpsMaxGapMs;
+    in.vz = last_gps[0];
+    in.vn = last_gps[1];
+    in.ve = last_gps[2];
+    in.baro = have_baro && now - last_baro_ms <= kSensorMaxGapMs;
+    in.baro_alt_m = last_baro_alt;
+    naive.step(in, dt);
+
+    // Aligned, kFusionDelayMs behind.
+    ++tick;
+    if (tick * cfg.step_ms <= kFusionDelayMs) continue;
+    uint32_t epoch = now - kFusionDelayMs;
+    Inputs al{};
+    float v[3] = {};
+    AlignStatus st = imu.at(epoch, v);
+    al.accel_up = st == AlignStatus::kInterpolated || st == AlignStatus::kHeld ? v[0] : 0;
+    st = gps.at(epoch, v);
+    al.gps = st == AlignStatus::kInterpolated || st == AlignStatus::kHeld;
+    al.vz = v[0];
+    al.vn = v[1];
+    al.ve = v[2];
+    st = baro.at(epoch, v);
+    al.baro = st == AlignStatus::kInterpolated || st == AlignStatus::kHeld;
+    al.baro_alt_m = v[0];
+    aligned.step(al, dt);
+
+    const Truth& te = truth[(tick - 1 - kFusionDelayMs / cfg.step_ms) % kTruthDepth];
+    check(te.time_ms == epoch, "truth ring lookup");
+    if (s.phase == SynthPhase::kPad || s.phase == SynthPhase::kLanded) continue;
+    size_t back = (now - last_gps_valid_ms) / cfg.step_ms;
+    const Truth& tg = truth[(tick - 1 - std::min(back, kTruthDepth - 1)) % kTruthDepth];
+    score(tr, tg, naive, in, naive_s);
+    score(te, te, aligned, al, aligned_s);
+  }
+}
+
+void self_test() {
+  AlignedStream<2, 4> s(0, 1500);
+  float out[2];
+  check(s.at(0, out) == AlignStatus::kStale, "empty stream is stale");
+  for (uint32_t t = 0; t < 6; ++t) {
+    float v[2] = {2.0f * t + 1, -static_cast<float>(t)};
+    check(s.push(t * 1000, v), "ramp push");
+  }
+  check(s.size() == 4, "ring keeps Depth samples");
+  check(s.at(3500, out) == AlignStatus::kInterpolated && fabsf(out[0] - 8.0f) < 1e-5f &&
+            fabsf(out[1] + 3.5f) < 1e-5f,
+        "interpolation exact on a ramp");
+  check(s.at(1500, out) == AlignStatus::kTooOld, "epoch before the oldest sample");
+  check(s.at(6000, out) == AlignStatus::kHeld && out[0] == 11.0f, "hold past the newest");
+  check(s.at(6600, out) == AlignStatus::kStale, "stale past max_gap");
+  float late[2] = {0, 0};
+  check(!s.push(5000, late) && s.rejected() == 1, "out-of-order sample rejected");
+  check(s.push(9000, late) && s.at(8000, out) == AlignStatus::kStale,
+        "gap wider than max_gap is not interpolated");
+
+  // Burst stamped back from its arrival; latency applied; times wrap.
+  AlignedStream<1, 8> b(20, 500);
+  const float burst[5] = {0, 1, 2, 3, 4};
+  uint32_t arrival = 0xFFFFFFFFu - 150;  // the burst straddles the wrap
+  check(b.push_block(arrival + 400, 100000, burst, 5) == 5, "burst kept");
+  check(b.newest_ms() == arrival + 380, "burst stamped by latency");
+  check(b.at(arrival + 130, out) == AlignStatus::kInterpolated && fabsf(out[0] - 1.5f) < 1e-5f,
+        "burst interpolation across the wrap");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  uint64_t flights = argc > 1 ? strtoull(argv[1], nullptr, 10) : 100;
+  uint64_t seed = argc > 2 ? strtoull(argv[2], nullptr, 10) : 1;
+  self_test();
+
+  SynthConfig cfg;
+  Scores naive, aligned;
+  for (uint64_t f = 0; f < flights; ++f) run_flight(cfg, seed, f, &naive, &aligned);
+
+  printf("flights %llu, fusion delay %u ms, GPS age %u-%u ms, IMU bursts of %zu\n",
+         static_cast<unsigned long long>(flights), kFusionDelayMs, kGpsAgeMinMs, kGpsAgeMaxMs,
+         kImuBurst);
+  printf("%-26s %10s %10s %10s %10s\n", "estimate", "last_rms", "last_max", "align_rms",
+         "align_max");
+  struct Row {
+    const char* name;
+    ErrorStats Scores::*stat;
+  };
+  const Row rows[] = {{"climb (m/s)", &Scores::climb},
+                      {"climb after burst (m/s)", &Scores::climb_dynamic},
+                      {"wind (m/s)", &Scores::wind},
+                      {"wind altitude tag (m)", &Scores::wind_alt}};
+  for (const Row& r : rows) {
+    const ErrorStats& a = naive.*r.stat;
+    const ErrorStats& b = aligned.*r.stat;
+    printf("%-26s %10.3f %10.2f %10.3f %10.2f\n", r.name, a.rms(), a.max, b.rms(), b.max);
+    check(b.n > 0 && b.rms() < a.rms(), r.name);
+  }
+  printf("failures %zu\n", failures);
+  return failures ? 1 : 0;
+}
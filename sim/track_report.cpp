@@ -0,0 +1,378 @@
+// Significance-based position reporting against fixed-rate reporting, on
+// synthetic flights.
+//
+//   track_report [flights] [seed] [end_to_end_flights]
+//
+// Every FlightSynth flight's GPS fixes go through a TrackCompressor with
+// FlightSystem's tolerance schedule. The fence is a 150 km keep-in circle
+// around the launch site: leaving it cuts the flight (as does a
+// ground-commanded cut on one flight in ten). Freefall and cuts count as
+// events, as in FlightSystem. TrackDecoder rebuilds the track from the
+// reported points, and every fix must be within the tolerance it was fed
+// with (plus kRoundingM). The same fixes sent at fixed periods are
+// rebuilt the same way for comparison: frames, and the share of fixes
+// within tolerance.
+//
+// The first end_to_end_flights flights then run through FlightSystem
+// itself at the 10 Hz tick, with fake radios that hand the downlinked
+// StateSnapshots to TrackDecoder. Every reported point must arrive, and
+// every fix must be within the cruise tolerance of the rebuilt track.
+//
+// Exits 1 if a check fails, or if the compressor sends as many frames as
+// the old fixed 60 s telemetry.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "app/flight_system.h"
+#include "ground/telemetry/track_decode.h"
+#include "sim/flight_synth.h"
+#include "telemetry/track_compressor.h"
+
+using namespace skyguard;
+using namespace skyguard::sim;
+using ground::TrackDecoder;
+using ground::TrackFix;
+using telemetry::TrackCompressor;
+using telemetry::TrackPoint;
+using telemetry::TrackTolerance;
+
+namespace {
+
+constexpr double kFenceRadiusM = 150000;
+constexpr double kRoundingM = 0.05;
+constexpr uint32_t kFreefallMg2 = 300u * 300u;  // as FlightSystem
+constexpr uint8_t kFreefallSamples = 5;
+constexpr uint32_t kFixedPeriodsS[] = {1, 2, 5, 10, 20, 30, 60};
+constexpr size_t kFixedCount = sizeof(kFixedPeriodsS) / sizeof(kFixedPeriodsS[0]);
+constexpr double kFixedShare = 0.99;  // "meets tolerance" for a fixed rate
+
+size_t failures = 0;
+
+void fail(const char* what, uint64_t flight) {
+  if (failures++ < 10) {
+    printf("FAIL flight %llu: %s\n", static_cast<unsigned long long>(flight), what);
+  }
+}
+
+struct Fix {
+  TrackPoint p;
+  TrackTolerance tol;
+};
+
+struct Scheme {
+  uint64_t frames = 0;
+  uint64_t within = 0;
+  double max_h_m = 0, max_v_m = 0;
+};
+
+double distance_m(double lat0, double lon0, double lat1, double lon1) {
+  double dn = (lat1 - lat0) * 111195.0;
+  double de = (lon1 - lon0) * 111195.0 * cos(lat0 * 0.017453292519943295);
+  return sqrt(dn * dn + de * de);
+}
+
+TrackFix to_fix(const TrackPoint& p) { return {p.time_ms, p.lat_e7, p.lon_e7, p.alt_mm}; }
+
+// Error of the rebuilt track at each fix; returns the fixes within their
+// tolerance (plus rounding).
+uint64_t score(const std::vector<Fix>& fixes, const TrackDecoder& dec, Scheme* s) {
+  uint64_t within = 0;
+  for (const Fix& f : fixes) {
+    TrackFix r;
+    if (!dec.at(f.p.time_ms, &r)) continue;
+    double lat_deg = f.p.lat_e7 * 1e-7;
+    double h = distance_m(lat_deg, f.p.lon_e7 * 1e-7, r.lat_e7 * 1e-7, r.lon_e7 * 1e-7);
+    double v = fabs((r.alt_mm - f.p.alt_mm) * 0.001);
+    s->max_h_m = h > s->max_h_m ? h : s->max_h_m;
+    s->max_v_m = v > s->max_v_m ? v : s->max_v_m;
+    within += h <= f.tol.horizontal_m + kRoundingM &&
+              v <= f.tol.vertical_m + kRoundingM;
+  }
+  s->within += within;
+  return within;
+}
+
+// One flight through the compressor as FlightSystem drives it; fills the
+// fixes with the tolerance each was fed with.
+void compress(const SynthConfig& cfg, uint64_t seed, uint64_t flight, std::vector<Fix>* fixes,
+              TrackDecoder* dec) {
+  const telemetry::TrackToleranceSchedule schedule;
+  FlightSynth synth(cfg, seed, flight);
+  const SynthPlan& plan = synth.plan();
+  SynthRng rng(seed * 31 + flight);
+  double remote_s = rng.chance(0.1) ? rng.uniform(1800, 4 * 3600) : -1;
+  TrackCompressor track;
+  SynthSample s;
+  TrackPoint out;
+  uint8_t freefall_run = 0;
+  uint32_t event_until_ms = 0, last_report_ms = 0;
+  bool cut = false, flush = false;
+  auto report = [&](const TrackPoint& p, uint32_t now) {
+    dec->add(to_fix(p));
+    last_report_ms = now;
+  };
+  while (synth.next(&s)) {
+    uint32_t mag2 = 0;
+    for (int16_t a : s.accel_mg) mag2 += static_cast<uint32_t>(a * a);
+    freefall_run = mag2 < kFreefallMg2 ? std::min<uint8_t>(freefall_run + 1, kFreefallSamples)
+                                       : 0;
+    if (freefall_run >= kFreefallSamples) event_until_ms = s.time_ms + app::kTrackEventHoldMs;
+    if (!s.gps_new || s.gps.fix < 2) continue;
+    const app::GpsFix& g = s.gps;
+    int32_t margin = static_cast<int32_t>(kFenceRadiusM - distance_m(plan.launch_lat_deg,
+                                                                     plan.launch_lon_deg,
+                                                                     g.lat_e7 * 1e-7,
+                                                                     g.lon_e7 * 1e-7));
+    double flight_s = s.time_ms / 1000.0 - cfg.pad_s;
+    if (!cut && (margin < 0 || (remote_s > 0 && flight_s >= remote_s))) {
+      cut = flush = true;
+      event_until_ms = s.time_ms + app::kTrackEventHoldMs;
+      synth.terminate();
+    }
+    bool event = static_cast<int32_t>(event_until_ms - s.time_ms) > 0;
+    Fix f{{g.time_ms, g.lat_e7, g.lon_e7, g.alt_mm},
+          telemetry::track_tolerance(schedule, margin, event)};
+    if (track.push(f.p, f.tol, &out)) report(out, s.time_ms);
+    fixes->push_back(f);
+    if ((flush || s.time_ms - last_report_ms >= app::kTrackHeartbeatMs) && track.flush(&out)) {
+      report(out, s.time_ms);
+    }
+    flush = false;
+  }
+  if (track.flush(&out)) dec->add(to_fix(out));
+}
+
+// Every fix at least `period_s` after the previous one sent, and the last.
+void fixed_rate(const std::vector<Fix>& fixes, uint32_t period_s, TrackDecoder* dec) {
+  uint32_t last = 0;
+  for (size_t i = 0; i < fixes.size(); ++i) {
+    const TrackPoint& p = fixes[i].p;
+    if (i == 0 || p.time_ms - last >= period_s * 1000 || i + 1 == fixes.size()) {
+      dec->add(to_fix(p));
+      last = p.time_ms;
+    }
+  }
+}
+
+// ---- End to end, through FlightSystem ----
+
+struct FakeRadio {
+  bool busy = false;
+  uint16_t seq = 0;
+  TrackDecoder* dec = nullptr;
+  uint64_t snapshots = 0;
+};
+
+bool radio_submit(void* ctx, const telemetry::SgFrame& f) {
+  auto* r = static_cast<FakeRadio*>(ctx);
+  if (r->busy) return false;
+  r->busy = true;
+  const uint8_t* hdr = f.segments()[0].data;
+  r->seq = static_cast<uint16_t>(hdr[4] | hdr[5] << 8);
+  if (hdr[2] == records::StateSnapshot::kId) {
+    // Header, one pooled payload segment, CRC.
+    const telemetry::SgSegment& payload = f.segments()[1];
+    r->dec->add(payload.data, payload.len);
+    ++r->snapshots;
+  }
+  return true;
+}
+
+void finish(app::FlightSystem& fs, FakeRadio& r, app::LinkKind kind, uint32_t now) {
+  if (!r.busy) return;
+  r.busy = false;
+  fs.on_link_tx_done(kind, true, now);
+  fs.on_link_ack(kind, r.seq, now);
+}
+
+#if SKYGUARD_HAS_APRS
+struct FakeDma {
+  bool running = false;
+};
+void dma_start(void* ctx, const uint16_t*, size_t) { static_cast<FakeDma*>(ctx)->running = true; }
+void dma_stop(void* ctx) { static_cast<FakeDma*>(ctx)->running = false; }
+#endif
+
+struct EndToEnd {
+  uint64_t frames = 0;
+  uint64_t fixes = 0;
+  uint64_t within = 0;
+  double hours = 0;
+};
+
+void end_to_end(const SynthConfig& cfg, uint64_t seed, uint64_t flight, EndToEnd* e) {
+  TrackDecoder dec;
+  app::FlightPorts ports{};
+#if SKYGUARD_HAS_LORA
+  FakeRadio lora;
+  lora.dec = &dec;
+  ports.lora = {radio_submit, &lora};
+#endif
+#if SKYGUARD_HAS_IRIDIUM
+  FakeRadio iridium;
+  iridium.dec = &dec;
+  ports.iridium = {radio_submit, &iridium};
+#endif
+#if SKYGUARD_HAS_APRS
+  FakeDma dma;
+  ports.afsk = {dma_start, dma_stop, &dma};
+  ports.afsk_sample_rate = 26400;
+  ports.afsk_out_max = 4095;
+  ports.aprs_source = {"N0CALL", 11};
+#endif
+  std::unique_ptr<app::FlightSystem> owned(new app::FlightSystem(ports));
+  app::FlightSystem& fs = *owned;
+
+  FlightSynth synth(cfg, seed, flight);
+  const SynthPlan& plan = synth.plan();
+  std::vector<Fix> fixes;
+  const TrackTolerance cruise = telemetry::TrackToleranceSchedule().cruise;
+  SynthSample s;
+  bool cut = false;
+  while (synth.next(&s)) {
+    uint32_t now = s.time_ms;
+    if (s.gps_new) {
+      fs.on_gps_fix(0, s.gps);
+      const app::GpsFix& g = s.gps;
+      if (g.fix >= 2) fixes.push_back({{g.time_ms, g.lat_e7, g.lon_e7, g.alt_mm}, cruise});
+    }
+#if SKYGUARD_HAS_IMU
+    fs.on_imu_sample({now, {s.accel_mg[0], s.accel_mg[1], s.accel_mg[2]}});
+#endif
+    double margin = kFenceRadiusM - distance_m(plan.launch_lat_deg, plan.launch_lon_deg,
+                                               s.gps.lat_e7 * 1e-7, s.gps.lon_e7 * 1e-7);
+    fs.set_fence_margin(s.gps.fix >= 2 ? static_cast<int32_t>(margin) : INT32_MAX);
+    if (!cut && s.gps.fix >= 2 && margin < 0) {
+      cut = true;
+      fs.note_termination_event(now);
+      synth.terminate();
+    }
+#if SKYGUARD_HAS_LORA
+    finish(fs, lora, app::LinkKind::kLora, now);
+#endif
+#if SKYGUARD_HAS_IRIDIUM
+    finish(fs, iridium, app::LinkKind::kIridium, now);
+#endif
+#if SKYGUARD_HAS_APRS
+    while (dma.running) {
+      fs.afsk_streamer().on_half_transfer();
+      if (dma.running) fs.afsk_streamer().on_transfer_complete();
+    }
+#endif
+    fs.tick(now);
+  }
+  // A minute on the ground for the last reports to drain.
+  for (uint32_t i = 1; i <= 600; ++i) {
+    uint32_t now = s.time_ms + i * cfg.step_ms;
+#if SKYGUARD_HAS_LORA
+    finish(fs, lora, app::LinkKind::kLora, now);
+#endif
+#if SKYGUARD_HAS_IRIDIUM
+    finish(fs, iridium, app::LinkKind::kIridium, now);
+#endif
+#if SKYGUARD_HAS_APRS
+    while (dma.running) {
+      fs.afsk_streamer().on_half_transfer();
+      if (dma.running) fs.afsk_streamer().on_transfer_complete();
+    }
+#endif
+    fs.tick(now);
+  }
+
+  if (fs.track_overflows() != 0) fail("report queue overflowed", flight);
+  if (dec.points().size() != fs.track().reported()) fail("reported point missing", flight);
+  Scheme sc;
+  uint64_t within = score(fixes, dec, &sc);
+  // Fixes after the last report are still held on board.
+  uint64_t covered = 0;
+  for (const Fix& f : fixes) covered += f.p.time_ms <= dec.points().back().time_ms;
+  if (within != covered) fail("end-to-end track outside cruise tolerance", flight);
+  for (const FakeRadio* r : {
+#if SKYGUARD_HAS_LORA
+           &lora,
+#endif
+#if SKYGUARD_HAS_IRIDIUM
+           &iridium,
+#endif
+       }) {
+    e->frames += r->snapshots;
+  }
+  e->fixes += covered;
+  e->within += within;
+  e->hours += s.time_ms / 3.6e6;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  uint64_t flights = argc > 1 ? strtoull(argv[1], nullptr, 10) : 200;
+  uint64_t seed = argc > 2 ? strtoull(argv[2], nullptr, 10) : 1;
+  uint64_t e2e_flights = argc > 3 ? strtoull(argv[3], nullptr, 10) : 5;
+  SynthConfig cfg;
+
+  Scheme door, fixed[kFixedCount];
+  uint64_t fix_count = 0;
+  double hours = 0;
+  std::vector<Fix> fixes;
+  for (uint64_t f = 0; f < flights; ++f) {
+    fixes.clear();
+    TrackDecoder dec;
+    compress(cfg, seed, f, &fixes, &dec);
+    if (fixes.empty()) continue;
+    fix_count += fixes.size();
+    hours += (fixes.back().p.time_ms - fixes.front().p.time_ms) / 3.6e6;
+    door.frames += dec.points().size();
+    if (score(fixes, dec, &door) != fixes.size()) fail("fix outside its tolerance", f);
+    for (size_t k = 0; k < kFixedCount; ++k) {
+      TrackDecoder fdec;
+      fixed_rate(fixes, kFixedPeriodsS[k], &fdec);
+      fixed[k].frames += fdec.points().size();
+      score(fixes, fdec, &fixed[k]);
+    }
+  }
+
+  printf("flights %llu  fixes %llu  flight hours %.1f\n", static_cast<unsigned long long>(flights),
+         static_cast<unsigned long long>(fix_count), hours);
+  printf("%-14s %10s %9s %10s %9s %9s\n", "scheme", "frames", "frames/h", "within_tol",
+         "max_h_m", "max_v_m");
+  auto row = [&](const char* name, const Scheme& s) {
+    printf("%-14s %10llu %9.1f %9.2f%% %9.1f %9.1f\n", name,
+           static_cast<unsigned long long>(s.frames), s.frames / hours,
+           100.0 * s.within / fix_count, s.max_h_m, s.max_v_m);
+  };
+  row("swinging door", door);
+  int meets = -1;
+  for (size_t k = 0; k < kFixedCount; ++k) {
+    char name[32];
+    snprintf(name, sizeof(name), "fixed %u s", kFixedPeriodsS[k]);
+    row(name, fixed[k]);
+    if (fixed[k].within >= kFixedShare * fix_count) meets = static_cast<int>(k);
+  }
+  const Scheme& minute = fixed[kFixedCount - 1];
+  printf("frames vs fixed 60 s: %.2fx fewer\n", static_cast<double>(minute.frames) / door.frames);
+  if (meets >= 0) {
+    printf("frames vs fixed %u s (slowest with %.0f%% of fixes within tolerance): %.1fx fewer\n",
+           kFixedPeriodsS[meets], kFixedShare * 100,
+           static_cast<double>(fixed[meets].frames) / door.frames);
+  }
+  if (door.frames >= minute.frames) fail("no fewer frames than fixed 60 s", 0);
+
+  EndToEnd e;
+  for (uint64_t f = 0; f < e2e_flights && f < flights; ++f) end_to_end(cfg, seed, f, &e);
+  if (e.hours > 0) {
+    printf("end to end: %llu flights, %llu snapshot frames (%.1f/h, all links), "
+           "%.2f%% of fixes within cruise tolerance\n",
+           static_cast<unsigned long long>(std::min(e2e_flights, flights)),
+           static_cast<unsigned long long>(e.frames), e.frames / e.hours,
+           e.fixes ? 100.0 * e.within / e.fixes : 0.0);
+  }
+  printf("failures %zu\n", failures);
+  return failures ? 1 : 0;
+}
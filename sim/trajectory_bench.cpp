@@ -0,0 +1,150 @@
+// Throughput of the batch trajectory checker on predicted balloon tracks.
+//
+//   trajectory_bench [trajectories] [points] [fences] [step_m]
+//
+// Synthetic fences (one in eight without a distance raster) and drifting
+// tracks sampled every 10 s. Reports points per second per core for the
+// scalar and AVX2 kernels and across all cores, checks the two kernels
+// agree exactly, and checks a sample of tracks point by point against the
+// firmware's FenceSet::margin_m(). Exits 1 on any disagreement.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "geofence/fence_set.h"
+#include "ground/fence/fence_sdf.h"
+#include "ground/fence/fence_simplify.h"
+#include "ground/fence/fence_writer.h"
+#include "ground/fence/trajectory_check.h"
+#include "sim/fence_synth.h"
+
+using namespace skyguard;
+using namespace skyguard::ground;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Track {
+  std::vector<float> t;
+  std::vector<int32_t> lat, lon;
+  size_t n() const { return t.size(); }
+};
+
+Track drift(std::mt19937& rng, size_t n) {
+  constexpr double kPi = 3.14159265358979323846;
+  std::uniform_real_distribution<double> u(0.0, 1.0);
+  Track tr;
+  double lat = 37 + 12 * u(rng), lon = -4 + 18 * u(rng);
+  double heading = 2 * kPi * u(rng), speed = 5 + 20 * u(rng);
+  for (size_t i = 0; i < n; ++i) {
+    tr.t.push_back(static_cast<float>(10 * i));
+    tr.lat.push_back(static_cast<int32_t>(lround(lat * 1e7)));
+    tr.lon.push_back(static_cast<int32_t>(lround(lon * 1e7)));
+    heading += 0.05 * (u(rng) - 0.5);
+    speed = std::clamp(speed + (u(rng) - 0.5), 2.0, 40.0);
+    lat += speed * 10 * cos(heading) / 111195.0;
+    lon += speed * 10 * sin(heading) / (111195.0 * cos(lat * kPi / 180));
+  }
+  return tr;
+}
+
+double run(const TrajectoryChecker& checker, const std::vector<TrajectoryView>& views,
+           std::vector<TrajectoryResult>* out, size_t threads, SimdLevel level) {
+  auto t0 = Clock::now();
+  checker.check_all(views, out, threads, level);
+  return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t n_tracks = argc > 1 ? static_cast<size_t>(atol(argv[1])) : 2000;
+  size_t n_points = argc > 2 ? static_cast<size_t>(atol(argv[2])) : 2000;
+  size_t n_fences = argc > 3 ? static_cast<size_t>(atol(argv[3])) : 300;
+  SdfOptions sdf;
+  sdf.step_m = argc > 4 ? atof(argv[4]) : 250;
+
+  std::vector<SourcePolygon> polys;
+  sim::synthesize_fences(n_fences, 9, &polys);
+  std::vector<FenceBlob> blobs(polys.size());
+  std::string err;
+  for (size_t i = 0; i < polys.size(); ++i) {
+    CompiledFence f;
+    f.id = static_cast<uint16_t>(i);
+    if (!compile_ring(polys[i].outer, f.kind, SimplifyOptions{}, &f.ring_e7, &err) ||
+        !build_fence_blob(f, &blobs[i], &err, i % 8 ? &sdf : nullptr)) {
+      fprintf(stderr, "fence %zu: %s\n", i, err.c_str());
+      return 2;
+    }
+  }
+  std::vector<uint8_t> image = assemble_fence_image(blobs);
+  std::vector<uint32_t> words((image.size() + 3) / 4);
+  memcpy(words.data(), image.data(), image.size());
+  geofence::FenceSet set;
+  if (set.bind(reinterpret_cast<const uint8_t*>(words.data()), image.size()) !=
+      geofence::FenceError::kNone) {
+    fprintf(stderr, "image does not bind\n");
+    return 2;
+  }
+
+  std::mt19937 rng(21);
+  std::vector<Track> tracks;
+  std::vector<TrajectoryView> views;
+  for (size_t i = 0; i < n_tracks; ++i) tracks.push_back(drift(rng, n_points));
+  for (const Track& tr : tracks) {
+    views.push_back({tr.t.data(), tr.lat.data(), tr.lon.data(), tr.n()});
+  }
+  double points = double(n_tracks) * double(n_points);
+
+  TrajectoryChecker checker(set);
+  SimdLevel best = best_simd_level();
+  size_t cores = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<TrajectoryResult> scalar, simd, parallel;
+  double s_scalar = run(checker, views, &scalar, 1, SimdLevel::kScalar);
+  double s_simd = run(checker, views, &simd, 1, best);
+  double s_parallel = run(checker, views, &parallel, cores, best);
+
+  size_t breached = 0, mismatched = 0;
+  for (size_t i = 0; i < n_tracks; ++i) {
+    breached += scalar[i].first_breach >= 0;
+    mismatched += scalar[i].first_breach != simd[i].first_breach ||
+                  scalar[i].min_margin_m != simd[i].min_margin_m ||
+                  simd[i].first_breach != parallel[i].first_breach ||
+                  simd[i].min_margin_m != parallel[i].min_margin_m;
+  }
+
+  // Point by point against the firmware on a sample of tracks.
+  size_t firmware_mismatch = 0;
+  for (size_t i = 0; i < std::min<size_t>(n_tracks, 20); ++i) {
+    int64_t first = -1;
+    float min_margin = INFINITY;
+    for (size_t k = 0; k < n_points; ++k) {
+      float m = set.margin_m(tracks[i].lat[k], tracks[i].lon[k]);
+      if (m <= 0 && first < 0) first = static_cast<int64_t>(k);
+      min_margin = std::min(min_margin, m);
+    }
+    // Unreachable fences give the checker a looser lower bound, never more.
+    if (first != simd[i].first_breach || simd[i].min_margin_m > min_margin) ++firmware_mismatch;
+  }
+
+  printf("%zu fences (%zu rasters), %zu tracks x %zu points; %zu tracks breach\n", set.count(),
+         set.count() - (set.count() + 7) / 8, n_tracks, n_points, breached);
+  printf("scalar  1 core:  %6.2f M points/s\n", points / s_scalar / 1e6);
+  printf("%s 1 core:  %6.2f M points/s (%.1fx)\n", best == SimdLevel::kAvx2 ? "avx2  " : "scalar",
+         points / s_simd / 1e6, s_scalar / s_simd);
+  printf("%s %zu cores: %6.2f M points/s, %.2f M points/s per core\n",
+         best == SimdLevel::kAvx2 ? "avx2  " : "scalar", cores, points / s_parallel / 1e6,
+         points / s_parallel / 1e6 / double(cores));
+  printf("kernel mismatches %zu, firmware mismatches %zu\n", mismatched, firmware_mismatch);
+  return mismatched || firmware_mismatch ? 1 : 0;
+}
@@ -0,0 +1,85 @@
+// Minimal 16-bit mono PCM WAV reader/writer for host tools.
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+namespace skyguard::sim {
+
+inline void put_le(std::vector<uint8_t>& v, uint32_t x, int bytes) {
+  for (int i = 0; i < bytes; ++i) v.push_back(static_cast<uint8_t>(x >> (8 * i)));
+}
+
+inline bool write_wav(const std::string& path, uint32_t sample_rate,
+                      const std::vector<int16_t>& samples) {
+  std::vector<uint8_t> h;
+  uint32_t data_bytes = static_cast<uint32_t>(samples.size() * 2);
+  h.insert(h.end(), {'R', 'I', 'F', 'F'});
+  put_le(h, 36 + data_bytes, 4);
+  h.insert(h.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+  put_le(h, 16, 4);
+  put_le(h, 1, 2);  // PCM
+  put_le(h, 1, 2);  // mono
+  put_le(h, sample_rate, 4);
+  put_le(h, sample_rate * 2, 4);
+  put_le(h, 2, 2);
+  put_le(h, 16, 2);
+  h.insert(h.end(), {'d', 'a', 't', 'a'});
+  put_le(h, data_bytes, 4);
+
+  FILE* f = fopen(path.c_str(), "wb");
+  if (!f) return false;
+  bool ok = fwrite(h.data(), 1, h.size(), f) == h.size() &&
+            fwrite(samples.data(), 2, samples.size(), f) == samples.size();
+  return fclose(f) == 0 && ok;
+}
+
+/// Reads a 16-bit mono PCM file. Returns false on any unsupported format.
+inline bool read_wav(const std::string& path, uint32_t* sample_rate,
+                     std::vector<int16_t>* samples) {
+  FILE* f = fopen(path.c_str(), "rb");
+  if (!f) return false;
+  std::vector<uint8_t> d;
+  uint8_t buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) d.insert(d.end(), buf, buf + n);
+  fclose(f);
+
+  auto le = [&](size_t off, int bytes) {
+    uint32_t x = 0;
+    for (int i = 0; i < bytes; ++i) x |= static_cast<uint32_t>(d[off + i]) << (8 * i);
+    return x;
+  };
+  if (d.size() < 12 || std::string(d.begin(), d.begin() + 4) != "RIFF" ||
+      std::string(d.begin() + 8, d.begin() + 12) != "WAVE") {
+    return false;
+  }
+  bool have_fmt = false;
+  for (size_t off = 12; off + 8 <= d.size();) {
+    std::string id(d.begin() + off, d.begin() + off + 4);
+    uint32_t len = le(off + 4, 4);
+    size_t body = off + 8;
+    if (body + len > d.size()) return false;
+    if (id == "fmt ") {
+      if (len < 16 || le(body, 2) != 1 || le(body + 2, 2) != 1 ||
+          le(body + 14, 2) != 16) {
+        return false;
+      }
+      *sample_rate = le(body + 4, 4);
+      have_fmt = true;
+    } else if (id == "data" && have_fmt) {
+      samples->resize(len / 2);
+      for (size_t i = 0; i < samples->size(); ++i) {
+        (*samples)[i] = static_cast<int16_t>(le(body + 2 * i, 2));
+      }
+      return true;
+    }
+    off = body + len + (len & 1);
+  }
+  return false;
+}
+
+}  // namespace skyguard::sim
@@ -0,0 +1,291 @@
+// Ground packer for the forecast wind grid, plus a host benchmark of the
+// on-board reader.
+//
+//   wind_pack pack <forecast.csv> <grid.bin> [unit_ms]
+//   wind_pack synth <grid.bin>
+//   wind_pack bench <grid.bin> [track.csv]
+//
+// `synth` writes a 24 h regional grid with a jet stream. `bench` reads the
+// image through the firmware WindGrid from emulated SPI flash (a paged
+// storage::DataView, the worst case; see data_view_bench) along a
+// balloon track (time_utc_s,lat_deg,lon_deg,alt_m per line; a simulated
+// ascent/float/descent that drifts with the grid's winds when omitted) and
+// reports cost per sample, page cache hit rate and flash bytes read. On the
+// simulated track it also feeds WindBlender with a "true" wind that differs
+// from the forecast and compares blended and forecast-only errors.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "ground/wind/wind_pack.h"
+#include "wind/wind_blend.h"
+#include "wind/wind_grid.h"
+
+using namespace skyguard;
+using namespace skyguard::ground;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+constexpr double kPi = 3.14159265358979323846;
+
+bool read_file(const char* path, std::string* out) {
+  FILE* f = fopen(path, "rb");
+  if (!f) return false;
+  char buf[65536];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) out->append(buf, n);
+  fclose(f);
+  return true;
+}
+
+bool write_file(const char* path, const std::vector<uint8_t>& data) {
+  FILE* f = fopen(path, "wb");
+  if (!f) return false;
+  bool ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+  return fclose(f) == 0 && ok;
+}
+
+// Westerly jet near 11 km drifting north over the day, plus a slowly
+// rotating wave so neighbouring tiles differ.
+void synth_wind(double t_h, double alt_m, double lat, double lon, double* u, double* v) {
+  double jet_lat = 46 + 0.5 * sin(2 * kPi * t_h / 24);
+  double core = exp(-pow((alt_m - 11000) / 3500, 2) - pow((lat - jet_lat) / 3, 2));
+  double wave = sin((lon + 0.3 * t_h) * kPi / 6) * cos(lat * kPi / 9);
+  *u = 5 + 55 * core + 6 * wave + alt_m * 4e-4;
+  *v = 8 * wave * (0.3 + core) + 3 * cos(alt_m / 5000);
+}
+
+// What the balloon actually meets: the forecast with an altitude-dependent
+// error it cannot know in advance.
+void true_wind(double t_h, double alt_m, double lat, double lon, double* u, double* v) {
+  synth_wind(t_h, alt_m, lat, lon, u, v);
+  *u += 4 * sin(alt_m / 3000 + 1);
+  *v += 3 * cos(alt_m / 4500);
+}
+
+WindForecast synth_forecast() {
+  WindForecast f;
+  f.t0_utc_s = 1790000000;
+  f.dt_s = 3 * 3600;
+  f.n_times = 9;
+  f.lat0_e7 = 400000000;
+  f.lon0_e7 = -100000000;
+  f.dlat_e7 = f.dlon_e7 = 2500000;
+  f.n_lat = 49;
+  f.n_lon = 97;
+  for (int alt = 0; alt <= 32000; alt += alt < 16000 ? 1000 : 2000) f.levels_m.push_back(alt);
+  size_t n = f.n_times * f.levels_m.size() * f.n_lat * f.n_lon;
+  f.u_ms.resize(n);
+  f.v_ms.resize(n);
+  for (uint32_t t = 0; t < f.n_times; ++t) {
+    for (uint32_t l = 0; l < f.levels_m.size(); ++l) {
+      for (uint32_t y = 0; y < f.n_lat; ++y) {
+        for (uint32_t x = 0; x < f.n_lon; ++x) {
+          double u, v;
+          synth_wind(t * 3.0, f.levels_m[l], (f.lat0_e7 + y * double(f.dlat_e7)) * 1e-7,
+                     (f.lon0_e7 + x * double(f.dlon_e7)) * 1e-7, &u, &v);
+          size_t i = f.index(t, l, y, x);
+          f.u_ms[i] = static_cast<float>(u);
+          f.v_ms[i] = static_cast<float>(v);
+        }
+      }
+    }
+  }
+  return f;
+}
+
+bool read_image(void* ctx, uint32_t offset, uint8_t* dst, uint32_t len) {
+  const std::vector<uint8_t>& img = *static_cast<const std::vector<uint8_t>*>(ctx);
+  if (offset > img.size() || len > img.size() - offset) return false;
+  memcpy(dst, img.data() + offset, len);
+  return true;
+}
+
+struct Fix {
+  uint32_t t_s;
+  double lat, lon, alt;
+};
+
+// 5 m/s ascent to 28 km, six hours of float, 8 m/s descent, drifting with
+// the true wind.
+std::vector<Fix> simulate_track(uint32_t t0) {
+  std::vector<Fix> track;
+  double lat = 45.5, lon = -6, alt = 0;
+  uint32_t float_end = 0;
+  for (uint32_t t = t0 + 1800;; t += 1) {
+    track.push_back({t, lat, lon, alt});
+    double u, v;
+    true_wind((t - t0) / 3600.0, alt, lat, lon, &u, &v);
+    lat += v / 111195.0;
+    lon += u / (111195.0 * cos(lat * kPi / 180));
+    if (!float_end) {
+      alt += 5;
+      if (alt >= 28000) float_end = t + 6 * 3600;
+    } else if (t >= float_end) {
+      alt -= 8;
+      if (alt <= 0) break;
+    }
+  }
+  return track;
+}
+
+bool parse_track(const std::string& text, std::vector<Fix>* out) {
+  for (size_t pos = 0; pos < text.size();) {
+    size_t end = text.find('\n', pos);
+    if (end == std::string::npos) end = text.size();
+    double t, lat, lon, alt;
+    if (sscanf(text.c_str() + pos, "%lf,%lf,%lf,%lf", &t, &lat, &lon, &alt) == 4) {
+      out->push_back({static_cast<uint32_t>(t), lat, lon, alt});
+    }
+    pos = end + 1;
+  }
+  return !out->empty();
+}
+
+int32_t e7(double deg) { return static_cast<int32_t>(lround(deg * 1e7)); }
+
+int bench(const char* grid_path, const char* track_path) {
+  std::string text;
+  if (!read_file(grid_path, &text)) {
+    fprintf(stderr, "cannot read %s\n", grid_path);
+    return 2;
+  }
+  std::vector<uint8_t> image(text.begin(), text.end());
+  storage::PageCache cache;
+  storage::DataView view = storage::DataView::paged(
+      {&read_image, &image, static_cast<uint32_t>(image.size())}, &cache);
+  wind::WindGrid grid;
+  if (!grid.bind(view)) {
+    fprintf(stderr, "%s: not a valid wind grid\n", grid_path);
+    return 2;
+  }
+  const wind::WindGridHeader& h = grid.header();
+  std::vector<Fix> track;
+  bool simulated = !track_path;
+  if (simulated) {
+    track = simulate_track(h.t0_utc_s);
+  } else if (!read_file(track_path, &text) || !parse_track(text, &track)) {
+    fprintf(stderr, "cannot read track %s\n", track_path);
+    return 2;
+  }
+
+  std::vector<int32_t> lat(track.size()), lon(track.size());
+  for (size_t i = 0; i < track.size(); ++i) {
+    lat[i] = e7(track[i].lat);
+    lon[i] = e7(track[i].lon);
+  }
+  std::vector<wind::WindVector> sampled(track.size());
+  size_t covered = 0;
+  cache.clear();
+  auto t0 = Clock::now();
+  for (size_t i = 0; i < track.size(); ++i) {
+    covered += grid.sample(track[i].t_s, lat[i], lon[i], static_cast<float>(track[i].alt),
+                           &sampled[i]);
+  }
+  double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+  uint32_t lookups = grid.cache_hits() + grid.cache_misses();
+  printf("grid: %u B, %u times x %u levels x %u x %u\n", h.image_size, h.n_times, h.n_levels,
+         h.n_lat, h.n_lon);
+  printf("track: %zu fixes, %zu inside the grid\n", track.size(), covered);
+  printf("sample: %.0f ns, %.1f tile lookups each\n", ns / track.size(),
+         double(lookups) / std::max<size_t>(covered, 1));
+  printf("cache: %.2f%% hits over %u lookups (%zu slots)\n",
+         lookups ? 100.0 * grid.cache_hits() / lookups : 0.0, lookups, wind::kWindCacheSlots);
+  printf("flash: %u B read in %u page reads, %.1f B per fix\n", cache.bytes_fetched(),
+         cache.misses(), double(cache.bytes_fetched()) / track.size());
+  if (!simulated) return 0;
+
+  // Forecast against the analytic field it was packed from, and the
+  // blender against the true wind. Measurements arrive every 10 s during
+  // ascent only; the float and descent then rely on what was learned.
+  wind::WindBlender blender(grid);
+  double quant = 0, err_forecast = 0, err_blend = 0;
+  size_t n_err = 0;
+  uint32_t apex = 0;
+  for (size_t i = 1; i < track.size(); ++i) {
+    if (track[i].alt < track[i - 1].alt && !apex) apex = static_cast<uint32_t>(i);
+  }
+  for (size_t i = 0; i < track.size(); ++i) {
+    const Fix& f = track[i];
+    double t_h = (f.t_s - h.t0_utc_s) / 3600.0, u, v, tu, tv;
+    synth_wind(t_h, f.alt, f.lat, f.lon, &u, &v);
+    true_wind(t_h, f.alt, f.lat, f.lon, &tu, &tv);
+    wind::WindVector s;
+    if (!grid.sample(f.t_s, lat[i], lon[i], static_cast<float>(f.alt), &s)) continue;
+    quant = std::max(quant, hypot(s.u_ms - u, s.v_ms - v));
+    bool ascending = track[i + (i + 1 < track.size())].alt > f.alt;
+    if (ascending && i % 10 == 0) {
+      blender.observe(f.t_s, lat[i], lon[i], static_cast<float>(f.alt),
+                      static_cast<float>(tu), static_cast<float>(tv));
+    }
+    if (!ascending && apex && i >= apex) {
+      wind::WindVector b;
+      blender.wind_at(f.t_s, lat[i], lon[i], static_cast<float>(f.alt), &b);
+      err_forecast += pow(s.u_ms - tu, 2) + pow(s.v_ms - tv, 2);
+      err_blend += pow(b.u_ms - tu, 2) + pow(b.v_ms - tv, 2);
+      ++n_err;
+    }
+  }
+  printf("interpolation: max %.2f m/s from the source field\n", quant);
+  if (n_err) {
+    printf("descent wind rms: forecast %.2f m/s, blended %.2f m/s\n",
+           sqrt(err_forecast / n_err), sqrt(err_blend / n_err));
+  }
+  return 0;
+}
+
+int pack(const WindForecast& f, float unit_ms, const char* out_path) {
+  std::vector<uint8_t> image;
+  WindPackStats stats;
+  std::string err;
+  auto t0 = Clock::now();
+  if (!pack_wind_grid(f, unit_ms, &image, &stats, &err)) {
+    fprintf(stderr, "pack: %s\n", err.c_str());
+    return 1;
+  }
+  double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+  if (!write_file(out_path, image)) {
+    fprintf(stderr, "cannot write %s\n", out_path);
+    return 2;
+  }
+  printf("%s: %u B (%u B as int16, %.2fx), %u blocks, quantisation <= %.3f m/s, %.0f ms\n",
+         out_path, stats.image_bytes, stats.raw_bytes,
+         double(stats.raw_bytes) / stats.image_bytes, stats.blocks, stats.max_quant_error_ms,
+         ms);
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string mode = argc > 1 ? argv[1] : "";
+  if (mode == "pack" && argc >= 4) {
+    std::string text;
+    WindForecast f;
+    std::string err;
+    if (!read_file(argv[2], &text)) {
+      fprintf(stderr, "cannot read %s\n", argv[2]);
+      return 2;
+    }
+    if (!parse_wind_csv(text, &f, &err)) {
+      fprintf(stderr, "%s: %s\n", argv[2], err.c_str());
+      return 1;
+    }
+    return pack(f, argc > 4 ? static_cast<float>(atof(argv[4])) : 0.1f, argv[3]);
+  }
+  if (mode == "synth" && argc >= 3) return pack(synth_forecast(), 0.1f, argv[2]);
+  if (mode == "bench" && argc >= 3) return bench(argv[2], argc > 3 ? argv[3] : nullptr);
+  fprintf(stderr,
+          "usage: wind_pack pack <forecast.csv> <grid.bin> [unit_ms]\n"
+          "       wind_pack synth <grid.bin>\n"
+          "       wind_pack bench <grid.bin> [track.csv]\n");
+  return 2;
+}
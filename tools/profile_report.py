@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+"""Per-profile flash, RAM and tick cost report.
+
+    tools/profile_report.py [--cxx g++] [--size size] [--cflags "..."] [--no-run]
+
+For each profile in firmware/config/profiles/ the flight sources are
+compiled with that profile selected and measured with `size`; the host
+build of sim/profile_tick.cpp is then run for the FlightSystem footprint
+and tick cost. Point --cxx/--size at a cross toolchain (and pass --no-run)
+to get target flash/RAM figures instead of host ones.
+"""
+
+import argparse
+import glob
+import os
+import shlex
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+FLIGHT_DIRS = ["app", "aprs", "telemetry", "termination", "traffic", "util"]
+FLIGHT_FILES = ["diag/latency_histogram.cpp", "diag/latency_trace.cpp", "diag/perf_counters.cpp",
+                "storage/brownout_vault.cpp"]
+
+
+def sources():
+    out = []
+    for d in FLIGHT_DIRS:
+        out += sorted(glob.glob(os.path.join(ROOT, "firmware", d, "*.cpp")))
+    out += [os.path.join(ROOT, "firmware", f) for f in FLIGHT_FILES]
+    return out
+
+
+def profiles():
+    names = []
+    for path in sorted(glob.glob(os.path.join(ROOT, "firmware", "config", "profiles", "*.h"))):
+        names.append(os.path.splitext(os.path.basename(path))[0])
+    return names
+
+
+def run(cmd, **kw):
+    return subprocess.run(cmd, check=True, capture_output=True, text=True, **kw).stdout
+
+
+def measure(profile, args, tmp):
+    define = "-DSKYGUARD_PROFILE_%s" % profile.upper()
+    flags = ["-std=c++17", "-Os", "-I" + os.path.join(ROOT, "firmware"), "-I" + ROOT, define]
+    flags += shlex.split(args.cflags)
+    objs = []
+    for src in sources():
+        obj = os.path.join(tmp, "%s_%s.o" % (profile, os.path.basename(src)))
+        run([args.cxx] + flags + ["-c", src, "-o", obj])
+        objs.append(obj)
+    text = data = bss = 0
+    for line in run([args.size] + objs).splitlines()[1:]:
+        cols = line.split()
+        text, data, bss = text + int(cols[0]), data + int(cols[1]), bss + int(cols[2])
+    row = {"profile": profile, "flash": text + data, "ram": data + bss}
+    if not args.no_run:
+        exe = os.path.join(tmp, "profile_tick_" + profile)
+        run([args.cxx] + flags + ["-O2", os.path.join(ROOT, "sim", "profile_tick.cpp")] +
+            sources() + ["-o", exe])
+        for kv in run([exe]).split():
+            k, v = kv.split("=")
+            row[k] = v
+    return row
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("--cxx", default=os.environ.get("CXX", "g++"))
+    ap.add_argument("--size", default="size")
+    ap.add_argument("--cflags", default="")
+    ap.add_argument("--no-run", action="store_true", help="skip the host tick run")
+    args = ap.parse_args()
+
+    # RAM is static data/bss plus the FlightSystem instance the platform
+    # allocates statically (known only when the host run is done).
+    print("%-14s %10s %10s %10s" % ("profile", "flash_B", "ram_B", "tick_ns"))
+    with tempfile.TemporaryDirectory() as tmp:
+        for p in profiles():
+            try:
+                r = measure(p, args, tmp)
+            except subprocess.CalledProcessError as e:
+                print("%s: build failed\n%s" % (p, e.stderr), file=sys.stderr)
+                return 1
+            ram = r["ram"] + int(r.get("flight_system_bytes", 0))
+            print("%-14s %10d %10d %10s" % (p, r["flash"], ram, r.get("tick_ns", "-")))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
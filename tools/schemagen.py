@@ -0,0 +1,383 @@
+#!/usr/bin/env python3
+"""Generates record encoders and decoders from schema/records.schema.
+
+    tools/schemagen.py            regenerate the checked-in headers and lock
+    tools/schemagen.py --check    exit 1 if they are out of date
+
+Outputs:
+    firmware/generated/records.h      structs + constexpr-layout encoders
+    ground/generated/record_views.h   zero-copy view decoders
+    schema/records.lock               every released record layout
+
+The lock records each field's offset, type and version. Both modes refuse a
+schema that removes, reorders, retypes or resizes a locked field, drops a
+record or lowers its version, or adds a field without a new version.
+Regenerating only ever appends to the lock; a deliberate break has to be
+made by editing it by hand.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SCHEMA = os.path.join(ROOT, "schema", "records.schema")
+FIRMWARE_OUT = os.path.join(ROOT, "firmware", "generated", "records.h")
+GROUND_OUT = os.path.join(ROOT, "ground", "generated", "record_views.h")
+LOCK = os.path.join(ROOT, "schema", "records.lock")
+
+TYPES = {
+    "u8": ("uint8_t", 1), "i8": ("int8_t", 1),
+    "u16": ("uint16_t", 2), "i16": ("int16_t", 2),
+    "u32": ("uint32_t", 4), "i32": ("int32_t", 4),
+    "u64": ("uint64_t", 8), "i64": ("int64_t", 8),
+    "f32": ("float", 4),
+}
+
+BANNER = "// Generated by tools/schemagen.py from schema/records.schema. Do not edit.\n//\n"
+
+
+class SchemaError(Exception):
+    pass
+
+
+class Field:
+    def __init__(self, name, type_, count, since, deprecated, offset):
+        self.name = name
+        self.type = type_
+        self.count = count
+        self.since = since
+        self.deprecated = deprecated
+        self.offset = offset
+        self.ctype, self.elem_size = TYPES[type_]
+
+    @property
+    def size(self):
+        return self.elem_size * self.count
+
+
+class Record:
+    def __init__(self, name, rid, version):
+        self.name = name
+        self.id = rid
+        self.version = version
+        self.fields = []
+
+    @property
+    def size(self):
+        return sum(f.size for f in self.fields)
+
+    def size_for_version(self, v):
+        return sum(f.size for f in self.fields if f.since <= v)
+
+
+def parse(path):
+    records = []
+    cur = None
+    with open(path) as fh:
+        for lineno, raw in enumerate(fh, 1):
+            line = raw.split("#", 1)[0].strip()
+            if not line:
+                continue
+            where = "%s:%d" % (os.path.relpath(path, ROOT), lineno)
+            tok = line.split()
+            if tok[0] == "record":
+                if cur:
+                    raise SchemaError("%s: nested record" % where)
+                m = re.fullmatch(r"record (\w+) id=(\d+) version=(\d+)", " ".join(tok))
+                if not m:
+                    raise SchemaError("%s: expected 'record <Name> id=<n> version=<n>'" % where)
+                cur = Record(m.group(1), int(m.group(2)), int(m.group(3)))
+                if not 1 <= cur.id <= 255:
+                    raise SchemaError("%s: id out of range" % where)
+            elif tok[0] == "end":
+                if not cur:
+                    raise SchemaError("%s: 'end' outside record" % where)
+                records.append(cur)
+                cur = None
+            else:
+                if not cur:
+                    raise SchemaError("%s: field outside record" % where)
+                m = re.fullmatch(r"(\w+)(?:\[(\d+)\])?", tok[0])
+                if not m or m.group(1) not in TYPES or len(tok) < 2:
+                    raise SchemaError("%s: bad field '%s'" % (where, line))
+                since, deprecated = 1, False
+                for opt in tok[2:]:
+                    if opt == "deprecated":
+                        deprecated = True
+                    elif opt.startswith("since="):
+                        since = int(opt[6:])
+                    else:
+                        raise SchemaError("%s: unknown option '%s'" % (where, opt))
+                prev_since = cur.fields[-1].since if cur.fields else 1
+                if since < prev_since:
+                    raise SchemaError("%s: fields must be appended in version order" % where)
+                if since > cur.version:
+                    raise SchemaError("%s: since=%d is newer than the record" % (where, since))
+                count = int(m.group(2) or 1)
+                cur.fields.append(Field(tok[1], m.group(1), count, since, deprecated, cur.size))
+    if cur:
+        raise SchemaError("%s: record %s not closed" % (path, cur.name))
+    ids = [r.id for r in records]
+    if len(ids) != len(set(ids)):
+        raise SchemaError("duplicate record id")
+    return records
+
+
+def read_lock(path):
+    """{id: (name, version, [(offset, type, count, name, since)])}"""
+    locked = {}
+    if not os.path.exists(path):
+        return locked
+    cur = None
+    with open(path) as fh:
+        for lineno, raw in enumerate(fh, 1):
+            line = raw.split("#", 1)[0].strip()
+            if not line:
+                continue
+            where = "%s:%d" % (os.path.relpath(path, ROOT), lineno)
+            tok = line.split()
+            if tok[0] == "record" and len(tok) == 4:
+                cur = (tok[1], int(tok[2][3:]), int(tok[3][8:]), [])
+                locked[cur[1]] = (cur[0], cur[2], cur[3])
+            elif cur and len(tok) == 4:
+                m = re.fullmatch(r"(\w+)(?:\[(\d+)\])?", tok[1])
+                if not m:
+                    raise SchemaError("%s: bad lock entry" % where)
+                cur[3].append((int(tok[0]), m.group(1), int(m.group(2) or 1), tok[2],
+                               int(tok[3][6:])))
+            else:
+                raise SchemaError("%s: bad lock entry" % where)
+    return locked
+
+
+def check_lock(records, locked):
+    """Errors for every way `records` breaks the locked layouts."""
+    errors = []
+    by_id = {r.id: r for r in records}
+    for rid, (name, version, fields) in sorted(locked.items()):
+        r = by_id.get(rid)
+        if r is None:
+            errors.append("record %s id=%d was removed" % (name, rid))
+            continue
+        if r.version < version:
+            errors.append("%s: version went back from %d to %d" % (r.name, version, r.version))
+        for i, (offset, type_, count, fname, since) in enumerate(fields):
+            if i >= len(r.fields):
+                errors.append("%s.%s was removed" % (r.name, fname))
+                continue
+            f = r.fields[i]
+            if f.name != fname:
+                errors.append("%s: field %d is %s, locked as %s (removed, renamed or "
+                              "reordered)" % (r.name, i, f.name, fname))
+            elif (f.type, f.count) != (type_, count):
+                errors.append("%s.%s changed type from %s to %s"
+                              % (r.name, fname, lock_type(type_, count),
+                                 lock_type(f.type, f.count)))
+            elif f.offset != offset or f.since != since:
+                errors.append("%s.%s moved from offset %d since=%d to offset %d since=%d"
+                              % (r.name, fname, offset, since, f.offset, f.since))
+        for f in r.fields[len(fields):]:
+            if f.since <= version:
+                errors.append("%s.%s was added without a new version (locked at %d)"
+                              % (r.name, f.name, version))
+    return errors
+
+
+def lock_type(type_, count):
+    return type_ if count == 1 else "%s[%d]" % (type_, count)
+
+
+def gen_lock(records):
+    o = ["# Generated by tools/schemagen.py: the layout of every released record.",
+         "# Regenerating only appends. Do not edit unless breaking compatibility",
+         "# on purpose.",
+         "#",
+         "#   record <Name> id=<n> version=<n>",
+         "#     <offset> <type> <field> since=<version>",
+         ""]
+    for r in sorted(records, key=lambda r: r.id):
+        o.append("record %s id=%d version=%d" % (r.name, r.id, r.version))
+        for f in r.fields:
+            o.append("  %d %s %s since=%d" % (f.offset, lock_type(f.type, f.count), f.name,
+                                             f.since))
+        o.append("")
+    return "\n".join(o)
+
+
+def le_store(f, index_expr, value_expr, out):
+    """Lines writing one element little endian into `out`."""
+    lines = []
+    if f.type == "f32":
+        lines.append("    uint32_t bits;")
+        lines.append("    memcpy(&bits, &%s, 4);" % value_expr)
+        value_expr = "bits"
+    elif f.type.startswith("i"):
+        value_expr = "static_cast<%s>(%s)" % (TYPES["u" + f.type[1:]][0], value_expr)
+    for b in range(f.elem_size):
+        if index_expr is None:
+            pos = "%d" % (f.offset + b)
+        else:
+            pos = "%d + %d * %s" % (f.offset + b, f.elem_size, index_expr)
+        shifted = "%s >> %d" % (value_expr, 8 * b) if b else value_expr
+        if f.elem_size == 1 and f.type == "u8":
+            lines.append("    %s[%s] = %s;" % (out, pos, shifted))
+        else:
+            lines.append("    %s[%s] = static_cast<uint8_t>(%s);" % (out, pos, shifted))
+    return lines
+
+
+def le_load(f, index_expr):
+    utype = TYPES["u" + f.type[1:]][0] if f.type != "f32" else "uint32_t"
+    parts = []
+    for b in range(f.elem_size):
+        if index_expr is None:
+            pos = "%d" % (f.offset + b)
+        else:
+            pos = "%d + %d * %s" % (f.offset + b, f.elem_size, index_expr)
+        shift = " << %d" % (8 * b) if b else ""
+        parts.append("static_cast<%s>(p_[%s])%s" % (utype, pos, shift))
+    indent = " " * len("    %s v = " % utype)
+    return utype, (" |\n" + indent).join(parts)
+
+
+def gen_firmware(records):
+    o = [BANNER +
+         "// On-board record structs with a fixed, constexpr wire layout. encode()\n"
+         "// writes the current version; the layout constants let log and telemetry\n"
+         "// code reserve space and reference fields without runtime reflection.\n",
+         "#pragma once\n",
+         "#include <stddef.h>\n#include <stdint.h>\n#include <string.h>\n",
+         "namespace skyguard::records {\n"]
+    for r in records:
+        o.append("struct %s {" % r.name)
+        o.append("  static constexpr uint8_t kId = %d;" % r.id)
+        o.append("  static constexpr uint8_t kVersion = %d;" % r.version)
+        o.append("  static constexpr size_t kEncodedSize = %d;" % r.size)
+        for f in r.fields:
+            o.append("  static constexpr size_t kOffset_%s = %d;" % (f.name, f.offset))
+        o.append("")
+        o.append("  /// Encoded size written by a given schema version of this record.")
+        o.append("  static constexpr size_t encoded_size(uint8_t version) {")
+        sizes = sorted({(f.since, r.size_for_version(f.since)) for f in r.fields})
+        for since, size in reversed(sizes):
+            o.append("    if (version >= %d) return %d;" % (since, size))
+        o.append("    return 0;")
+        o.append("  }")
+        o.append("")
+        for f in r.fields:
+            dims = "[%d]" % f.count if f.count > 1 else ""
+            note = "  // deprecated" if f.deprecated else ""
+            o.append("  %s %s%s;%s" % (f.ctype, f.name, dims, note))
+        o.append("")
+        o.append("  /// Writes kEncodedSize bytes; returns 0 if `cap` is too small.")
+        o.append("  size_t encode(uint8_t* out, size_t cap) const {")
+        o.append("    if (cap < kEncodedSize) return 0;")
+        for f in r.fields:
+            if f.deprecated:
+                o.append("    memset(out + %d, 0, %d);" % (f.offset, f.size))
+                continue
+            if f.count > 1:
+                o.append("    for (size_t i = 0; i < %d; ++i) {" % f.count)
+                o.extend("  " + l for l in le_store(f, "i", "%s[i]" % f.name, "out"))
+                o.append("    }")
+            elif f.type == "f32":
+                o.append("    {")
+                o.extend("  " + l for l in le_store(f, None, f.name, "out"))
+                o.append("    }")
+            else:
+                o.extend(le_store(f, None, f.name, "out"))
+        o.append("    return kEncodedSize;")
+        o.append("  }")
+        o.append("};\n")
+        o.append("static_assert(%s::kEncodedSize == %d, \"%s layout\");\n" % (r.name, r.size, r.name))
+    o.append("}  // namespace skyguard::records\n")
+    return "\n".join(o)
+
+
+def gen_ground(records):
+    o = [BANNER +
+         "// Zero-copy views over encoded records. A view borrows the buffer; each\n"
+         "// accessor decodes straight from it, and has_<field>() reports whether\n"
+         "// the writer's schema version included that field.\n",
+         "#pragma once\n",
+         "#include <stddef.h>\n#include <stdint.h>\n#include <string.h>\n",
+         "namespace skyguard::records {\n"]
+    for r in records:
+        v = r.name + "View"
+        min_size = r.size_for_version(1)
+        o.append("class %s {" % v)
+        o.append(" public:")
+        o.append("  static constexpr uint8_t kId = %d;" % r.id)
+        o.append("  static constexpr size_t kMinSize = %d;" % min_size)
+        o.append("")
+        o.append("  /// Returns false if `len` is shorter than the first version.")
+        o.append("  bool bind(const uint8_t* p, size_t len) {")
+        o.append("    p_ = p;")
+        o.append("    len_ = len;")
+        o.append("    return len >= kMinSize;")
+        o.append("  }")
+        o.append("")
+        for f in r.fields:
+            end = f.offset + f.size
+            o.append("  bool has_%s() const { return len_ >= %d; }" % (f.name, end))
+            utype, expr = le_load(f, "i" if f.count > 1 else None)
+            arg = "size_t i" if f.count > 1 else ""
+            guard = "!has_%s()%s" % (f.name, " || i >= %d" % f.count if f.count > 1 else "")
+            o.append("  %s %s(%s) const {" % (f.ctype, f.name, arg))
+            o.append("    if (%s) return %s{};" % (guard, f.ctype))
+            o.append("    %s v = %s;" % (utype, expr))
+            if f.type == "f32":
+                o.append("    float out;")
+                o.append("    memcpy(&out, &v, 4);")
+                o.append("    return out;")
+            else:
+                o.append("    return static_cast<%s>(v);" % f.ctype)
+            o.append("  }")
+        o.append("")
+        o.append(" private:")
+        o.append("  const uint8_t* p_ = nullptr;")
+        o.append("  size_t len_ = 0;")
+        o.append("};\n")
+    o.append("}  // namespace skyguard::records\n")
+    return "\n".join(o)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("--check", action="store_true",
+                    help="verify generated files are up to date")
+    args = ap.parse_args()
+    try:
+        records = parse(SCHEMA)
+        errors = check_lock(records, read_lock(LOCK))
+    except SchemaError as e:
+        print("schemagen: %s" % e, file=sys.stderr)
+        return 1
+    if errors:
+        for e in errors:
+            print("schemagen: %s: %s" % (os.path.relpath(LOCK, ROOT), e), file=sys.stderr)
+        return 1
+
+    stale = []
+    for path, text in ((FIRMWARE_OUT, gen_firmware(records)),
+                       (GROUND_OUT, gen_ground(records)),
+                       (LOCK, gen_lock(records))):
+        old = open(path).read() if os.path.exists(path) else None
+        if old == text:
+            continue
+        if args.check:
+            stale.append(os.path.relpath(path, ROOT))
+        else:
+            os.makedirs(os.path.dirname(path), exist_ok=True)
+            with open(path, "w") as fh:
+                fh.write(text)
+    if stale:
+        print("schemagen: out of date: %s" % ", ".join(stale), file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())